@@ -268,8 +268,10 @@ void Canvas::clearFocusElement()
 void Canvas::enableRendering(bool force)
 {
     _visible = true;
-    if (force)
+    if (force) {
         _render_dirty = true;
+        _damage.setFull();
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -313,6 +315,7 @@ void Canvas::update(double delta_time_sec)
             setStatusFlags(STATUS_OK);
             setStatusFlags(STATUS_DIRTY, false);
             _render_dirty = true;
+            _damage.setFull();
         } else {
             setStatusFlags(CREATE_FAILED);
             return;
@@ -322,6 +325,10 @@ void Canvas::update(double delta_time_sec)
     if (_layout)
         _layout->setGeometry(SGRecti(0, 0, _view_width, _view_height));
 
+    // Update elements first, so that the area they have changed is known
+    // before deciding what to render.
+    _root_group->update(delta_time_sec);
+
     if (_visible || _render_always) {
         for (auto& canvas_weak : _child_canvases) {
             // TODO should we check if the image the child canvas is displayed
@@ -335,9 +342,29 @@ void Canvas::update(double delta_time_sec)
             // Also mark all canvases this canvas is displayed within as dirty
             for (auto& canvas_weak : _parent_canvases) {
                 CanvasPtr canvas = canvas_weak.lock();
-                if (canvas)
+                if (canvas) {
                     canvas->_render_dirty = true;
+                    canvas->_damage.setFull();
+                }
             }
+
+            // Changes which have not been reported by any element (or
+            // disabled partial redraws) require redrawing everything.
+            if (_damage.isEmpty() || !_partial_redraw)
+                _damage.setFull();
+
+            SGRecti region = _damage.toTexture(_view_width, _view_height,
+                                               _size_x, _size_y);
+            _texture.setRenderRegion(_damage.isFull() ? SGRecti(0, 0, 0, 0)
+                                                      : region);
+
+            _render_stats.num_renders += 1;
+            if (_damage.isFull())
+                _render_stats.num_full_renders += 1;
+            _render_stats.pixels_rendered += static_cast<double>(region.width()) * region.height();
+            _render_stats.last_region = region;
+
+            _damage.clear();
         }
 
         _texture.setRender(_render_dirty);
@@ -347,8 +374,6 @@ void Canvas::update(double delta_time_sec)
     } else
         _texture.setRender(false);
 
-    _root_group->update(delta_time_sec);
-
     if (_sampling_dirty) {
         _texture.setSampling(
             _node->getBoolValue("mipmapping"),
@@ -356,12 +381,14 @@ void Canvas::update(double delta_time_sec)
             _node->getIntValue("color-samples"));
         _sampling_dirty = false;
         _render_dirty = true;
+        _damage.setFull();
     }
 
     if (_anisotropy_dirty) {
         _texture.setMaxAnisotropy(_node->getFloatValue("anisotropy"));
         _anisotropy_dirty = false;
         _render_dirty = true;
+        _damage.setFull();
     }
 
     while (!_dirty_placements.empty()) {
@@ -389,6 +416,18 @@ void Canvas::update(double delta_time_sec)
     }
 }
 
+//----------------------------------------------------------------------------
+void Canvas::addDamage(const SGRectf& rect)
+{
+    _damage.add(rect);
+}
+
+//----------------------------------------------------------------------------
+const Canvas::RenderStats& Canvas::getRenderStats() const
+{
+    return _render_stats;
+}
+
 int Canvas::subscribe(CanvasImageReadyListener* subscriber)
 {
     const std::string& canvasname = _node->getStringValue("name");
@@ -579,6 +618,8 @@ void Canvas::childRemoved(SGPropertyNode* parent,
     if (parent != _node)
         return;
 
+    _damage.setFull();
+
     if (child->getNameString() == "placement") {
         const size_t index = child->getIndex();
         if (index < _placements.size()) {
@@ -626,6 +667,9 @@ void Canvas::valueChanged(SGPropertyNode* node)
 
         _dirty_placements.push_back(node->getParent());
     } else if (node->getParent() == _node) {
+        // Properties of the canvas itself affect the whole canvas
+        _damage.setFull();
+
         if (name == "background") {
             vsg::vec4 color;
             if (_texture.getCamera() && parseColor(node->getStringValue(), color)) {
@@ -640,6 +684,8 @@ void Canvas::valueChanged(SGPropertyNode* node)
             _texture.useAdditiveBlend(node->getBoolValue());
         } else if (name == "render-always") {
             _render_always = node->getBoolValue();
+        } else if (name == "partial-redraw") {
+            _partial_redraw = node->getBoolValue();
         } else if (name == "size") {
             if (node->getIndex() == 0)
                 setSizeX(node->getIntValue());
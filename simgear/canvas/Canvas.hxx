@@ -9,6 +9,7 @@
 #pragma once
 
 #include "canvas_fwd.hxx"
+#include "CanvasDamageRegion.hxx"
 #include "ODGauge.hxx"
 
 #include <simgear/canvas/elements/CanvasGroup.hxx>
@@ -77,6 +78,20 @@ namespace simgear::canvas
       };
       typedef vsg::ref_ptr<CullCallback> CullCallbackPtr;
 
+      /**
+       * Statistics about redrawing the canvas texture
+       */
+      struct RenderStats
+      {
+        size_t num_renders = 0,       //!< Number of times the canvas has been
+                                      //   rendered
+               num_full_renders = 0;  //!< ...of which the whole canvas has
+                                      //   been redrawn
+        double pixels_rendered = 0;   //!< Sum of all redrawn areas (pixels)
+        SGRecti last_region;          //!< Area redrawn last time (texture
+                                      //   pixels)
+      };
+
       explicit Canvas(SGPropertyNode* node);
       virtual ~Canvas();
       void onDestroy() override;
@@ -161,6 +176,18 @@ namespace simgear::canvas
 
       void update(double delta_time_sec) override;
 
+      /**
+       * Mark an area to be redrawn with the next rendering pass
+       *
+       * @param rect  Area in canvas coordinates (ignored if empty)
+       */
+      void addDamage(const SGRectf& rect);
+
+      /**
+       * Get statistics about (partial) redraws of this canvas
+       */
+      const RenderStats& getRenderStats() const;
+
       int subscribe(CanvasImageReadyListener * subscriber);
       void unsubscribe(CanvasImageReadyListener * subscriber);
 
@@ -241,6 +268,11 @@ namespace simgear::canvas
       /** Used to disable automatic lazy rendering (culling) */
       bool _render_always {false};
 
+      /** Restrict rendering to the area changed since the last redraw */
+      bool _partial_redraw {true};
+      DamageRegion _damage;
+      RenderStats _render_stats;
+
       std::vector<SGPropertyNode*> _dirty_placements;
       std::vector<Placements> _placements;
       std::set<CanvasWeakPtr> _parent_canvases, //!< Canvases showing this canvas
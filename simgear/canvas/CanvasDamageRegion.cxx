@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Area of a canvas which needs to be redrawn
+ */
+
+#include <simgear_config.h>
+
+#include "CanvasDamageRegion.hxx"
+
+#include <algorithm>
+#include <cmath>
+
+namespace simgear::canvas
+{
+
+  //----------------------------------------------------------------------------
+  void DamageRegion::add(const SGRectf& rect)
+  {
+    if( _full || !isValid(rect) || rect.width() <= 0 || rect.height() <= 0 )
+      return;
+
+    _bounds.expandBy(rect.l(), rect.t());
+    _bounds.expandBy(rect.r(), rect.b());
+  }
+
+  //----------------------------------------------------------------------------
+  void DamageRegion::setFull()
+  {
+    _full = true;
+  }
+
+  //----------------------------------------------------------------------------
+  void DamageRegion::clear()
+  {
+    _full = false;
+    _bounds = SGRectf();
+  }
+
+  //----------------------------------------------------------------------------
+  SGRecti DamageRegion::toTexture( int view_width,
+                                   int view_height,
+                                   int tex_width,
+                                   int tex_height,
+                                   int margin ) const
+  {
+    if( _full || view_width <= 0 || view_height <= 0 )
+      return SGRecti(0, 0, tex_width, tex_height);
+
+    if( !isValid(_bounds) )
+      return SGRecti(0, 0, 0, 0);
+
+    const float scale_x = static_cast<float>(tex_width) / view_width,
+                scale_y = static_cast<float>(tex_height) / view_height;
+
+    int l = static_cast<int>(std::floor(_bounds.l() * scale_x)) - margin,
+        t = static_cast<int>(std::floor(_bounds.t() * scale_y)) - margin,
+        r = static_cast<int>(std::ceil(_bounds.r() * scale_x)) + margin,
+        b = static_cast<int>(std::ceil(_bounds.b() * scale_y)) + margin;
+
+    l = std::clamp(l, 0, tex_width);
+    r = std::clamp(r, 0, tex_width);
+    t = std::clamp(t, 0, tex_height);
+    b = std::clamp(b, 0, tex_height);
+
+    return SGRecti(l, t, r - l, b - t);
+  }
+
+} // namespace simgear::canvas
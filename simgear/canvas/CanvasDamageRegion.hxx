@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Area of a canvas which needs to be redrawn
+ */
+
+#pragma once
+
+#include <simgear/math/SGMath.hxx>
+#include <simgear/math/SGRect.hxx>
+
+namespace simgear::canvas
+{
+
+  /**
+   * Accumulates the areas changed since the last time a canvas has been
+   * rendered.
+   *
+   * Elements report the area they covered before and after a change (in
+   * canvas coordinates), which are merged into a single rectangle. Rendering
+   * is then restricted to this rectangle, leaving the rest of the texture
+   * untouched. Changes which can not be attributed to a specific area mark
+   * the whole canvas as damaged.
+   */
+  class DamageRegion
+  {
+    public:
+
+      /**
+       * Add an area (ignored if empty)
+       */
+      void add(const SGRectf& rect);
+
+      /**
+       * Mark the whole canvas as damaged
+       */
+      void setFull();
+
+      /**
+       * Reset to no damage at all
+       */
+      void clear();
+
+      bool isFull() const { return _full; }
+      bool isEmpty() const { return !_full && !isValid(_bounds); }
+
+      /**
+       * Bounding rectangle of all added areas (in canvas coordinates)
+       */
+      const SGRectf& bounds() const { return _bounds; }
+
+      /**
+       * Get the damaged area in texture pixels, rounded outwards and clipped
+       * to the texture. Returns the whole texture if the region is full.
+       *
+       * @param view_width  Width of the canvas (view) coordinate system
+       * @param view_height Height of the canvas (view) coordinate system
+       * @param tex_width   Width of the texture in pixels
+       * @param tex_height  Height of the texture in pixels
+       * @param margin      Additional pixels around the area, eg. to include
+       *                    antialiased edges
+       */
+      SGRecti toTexture( int view_width,
+                         int view_height,
+                         int tex_width,
+                         int tex_height,
+                         int margin = 1 ) const;
+
+      static bool isValid(const SGRectf& rect)
+      {
+        return rect.l() <= rect.r() && rect.t() <= rect.b();
+      }
+
+    protected:
+      bool    _full = false;
+      SGRectf _bounds;
+  };
+
+} // namespace simgear::canvas
@@ -115,7 +115,8 @@ void ODGauge::setSize(int size_x, int size_y)
         texture->setTextureSize(_size_x, _size_y);
         texture->dirtyTextureObject();
 
-        camera->setViewport(0, 0, _size_x, _size_y);
+        _render_region = SGRecti(0, 0, 0, 0);
+        updateCoordinateFrame();
         camera->dirtyAttachmentMap();
         // We used to recreate the texture and camera when resizing, indirectly
         // enabling rendering. Emulate that behaviour for backwards compatibility.
@@ -198,6 +199,17 @@ void ODGauge::setRender(bool render)
     camera->setNodeMask(render ? 0xffffffff : 0);
 }
 
+//----------------------------------------------------------------------------
+void ODGauge::setRenderRegion(const SGRecti& region)
+{
+    if (region == _render_region)
+        return;
+
+    _render_region = region;
+    if (camera)
+        updateCoordinateFrame();
+}
+
 //----------------------------------------------------------------------------
 bool ODGauge::serviceable() const
 {
@@ -220,7 +232,6 @@ void ODGauge::allocRT(osg::NodeCallback* camera_cull_callback)
     camera->setClearColor(vsg::vec4(0.0f, 0.0f, 0.0f, 0.0f));
     camera->setClearStencil(0);
     camera->setRenderTargetImplementation(vsg::Camera::FRAME_BUFFER_OBJECT);
-    camera->setViewport(0, 0, _size_x, _size_y);
 
     updateCoordinateFrame();
     updateStencil();
@@ -285,13 +296,34 @@ void ODGauge::updateCoordinateFrame()
     if (_view_height < 0)
         _view_height = _size_y;
 
+    // Limit the viewport to the render region (also limits clearing, which
+    // is scissored to the viewport) and only project the matching part of the
+    // view onto it.
+    double l = 0, t = 0, r = _view_width, b = _view_height;
+    if (_render_region.width() > 0 && _render_region.height() > 0 && _size_x > 0 && _size_y > 0) {
+        const double scale_x = static_cast<double>(_view_width) / _size_x,
+                     scale_y = static_cast<double>(_view_height) / _size_y;
+        l = _render_region.l() * scale_x;
+        r = _render_region.r() * scale_x;
+        t = _render_region.t() * scale_y;
+        b = _render_region.b() * scale_y;
+
+        // Viewport origin is the bottom left corner
+        camera->setViewport(_render_region.x(),
+                            _size_y - _render_region.b(),
+                            _render_region.width(),
+                            _render_region.height());
+    } else {
+        camera->setViewport(0, 0, _size_x, _size_y);
+    }
+
     if (_flags & USE_IMAGE_COORDS) {
         camera->setProjectionMatrix(
-            vsg::mat4::ortho2D(0.0, _view_width, _view_height, 0.0));
+            vsg::mat4::ortho2D(l, r, b, t));
     } else {
         camera->setProjectionMatrix(
-            vsg::mat4::ortho2D(-_view_width * 0.5, _view_width * 0.5,
-                               -_view_height * 0.5, _view_height * 0.5));
+            vsg::mat4::ortho2D(l - _view_width * 0.5, r - _view_width * 0.5,
+                               _view_height * 0.5 - b, _view_height * 0.5 - t));
     }
 }
 
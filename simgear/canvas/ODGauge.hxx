@@ -17,6 +17,8 @@
 
 #include "canvas_fwd.hxx"
 
+#include <simgear/math/SGRect.hxx>
+
 #include <osg/NodeCallback>
 
 
@@ -99,6 +101,15 @@ public:
        */
     void setRender(bool render);
 
+    /**
+       * Restrict rendering to the given area of the texture. The remaining
+       * texture keeps the contents of the previous rendering pass.
+       *
+       * @param region  Area in texture pixels (origin at the top left corner).
+       *                An empty region resets to rendering the whole texture.
+       */
+    void setRenderRegion(const SGRecti& region);
+
     /**
        * Say if we can render to a texture.
        * @return true if rtt is available
@@ -132,6 +143,9 @@ protected:
 
     uint32_t _flags;
 
+    /// Area to render (texture pixels, empty if whole texture)
+    SGRecti _render_region{0, 0, 0, 0};
+
     // Multisampling parameters
     int _coverage_samples,
         _color_samples;
@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Benchmark full vs. partial (damage region) redraws of canvases
+ *
+ * Simulates a cockpit with many MFD canvases, where each frame only a few
+ * small elements (eg. numeric readouts) change. Uses the software path
+ * rasterizer, so the numbers show the relative savings, not absolute GPU
+ * timings.
+ */
+
+#include <simgear_config.h>
+
+#include "CanvasDamageRegion.hxx"
+#include "elements/CanvasPathRasterizer.hxx"
+#include "elements/CanvasPathTessellator.hxx"
+
+#include <simgear/misc/test_timing.hxx>
+
+#include <vg/openvg.h>
+
+#include <iostream>
+#include <vector>
+
+namespace sc = simgear::canvas;
+
+static const int num_canvases = 12;
+static const int canvas_size = 512;
+static const int num_elements = 256;  // 16x16 grid per canvas
+static const int num_changes = 2;     // changed elements per canvas and frame
+static const int num_frames = 50;
+
+struct TestElement
+{
+  sc::PathTessellator::Mesh mesh;
+  SGRectf bounds;
+};
+
+struct TestCanvas
+{
+  sc::PathRasterizer raster{canvas_size, canvas_size};
+  std::vector<TestElement> elements;
+  sc::DamageRegion damage;
+};
+
+/** Create a "readout": some boxes roughly resembling digits */
+static void updateElement(TestElement& el, int index, int value)
+{
+  const float cell = static_cast<float>(canvas_size) / 16;
+  const float x = (index % 16) * cell + 2,
+              y = (index / 16) * cell + 2;
+
+  std::vector<uint8_t> cmds;
+  std::vector<float> coords;
+  for(int i = 0; i <= value % 4; ++i)
+  {
+    cmds.insert(cmds.end(), { VG_MOVE_TO_ABS, VG_HLINE_TO_REL,
+                              VG_VLINE_TO_REL, VG_HLINE_TO_REL,
+                              VG_CLOSE_PATH });
+    coords.insert(coords.end(), {x + i * 7, y, 5, 12, -5});
+  }
+
+  sc::PathTessellator tess;
+  tess.setSegments(cmds, coords);
+  sc::PathTessellator::StrokeStyle style;
+  el.mesh = tess.stroke(style);
+  el.mesh.append(tess.fill(sc::PathTessellator::FILL_NON_ZERO));
+  el.bounds = tess.bounds();
+}
+
+static bool intersects(const SGRectf& a, const SGRectf& b)
+{
+  return a.l() < b.r() && b.l() < a.r() && a.t() < b.b() && b.t() < a.b();
+}
+
+int main(int argc, char* argv[])
+{
+  std::vector<TestCanvas> canvases(num_canvases);
+  for(auto& canvas: canvases)
+  {
+    canvas.elements.resize(num_elements);
+    for(int i = 0; i < num_elements; ++i)
+      updateElement(canvas.elements[i], i, i);
+  }
+
+  for(int partial = 0; partial < 2; ++partial)
+  {
+    double pixels = 0;
+    double frame_time = timeRun([&] {
+      for(int f = 0; f < num_frames; ++f)
+      {
+        for(int c = 0; c < num_canvases; ++c)
+        {
+          TestCanvas& canvas = canvases[c];
+
+          // Change some elements, reporting old and new area
+          for(int i = 0; i < num_changes; ++i)
+          {
+            int index = (f * 31 + c * 7 + i * 101) % num_elements;
+            TestElement& el = canvas.elements[index];
+            canvas.damage.add(el.bounds);
+            updateElement(el, index, f + i);
+            canvas.damage.add(el.bounds);
+          }
+
+          if( !partial )
+            canvas.damage.setFull();
+
+          SGRecti region = canvas.damage.toTexture( canvas_size, canvas_size,
+                                                    canvas_size, canvas_size );
+          SGRectf clip(region.x(), region.y(), region.width(), region.height());
+          pixels += static_cast<double>(region.width()) * region.height();
+
+          canvas.raster.setClip(region);
+          canvas.raster.clear(SGVec4f(0, 0, 0, 1));
+          for(const auto& el: canvas.elements)
+            if( intersects(el.bounds, clip) )
+              canvas.raster.draw(el.mesh, SGVec4f(0, 1, 0, 1));
+
+          canvas.damage.clear();
+        }
+      }
+    }).toUSecs() / num_frames;
+
+    std::cout << (partial ? "partial" : "full   ") << " redraw: "
+              << frame_time << " us/frame, "
+              << pixels / num_frames << " pixels/frame" << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/// Unit tests for canvas::DamageRegion
+#define BOOST_TEST_MODULE canvas_damage_region
+#include <BoostTestTargetConfig.h>
+
+#include "CanvasDamageRegion.hxx"
+
+namespace sc = simgear::canvas;
+
+BOOST_AUTO_TEST_CASE( merge_rects )
+{
+  sc::DamageRegion damage;
+  BOOST_CHECK( damage.isEmpty() );
+  BOOST_CHECK( !damage.isFull() );
+
+  // Empty and invalid rects are ignored
+  damage.add(SGRectf());
+  damage.add(SGRectf(10, 10, 0, 5));
+  BOOST_CHECK( damage.isEmpty() );
+
+  damage.add(SGRectf(10, 20, 5, 5));
+  damage.add(SGRectf(30, 5, 10, 10));
+  BOOST_CHECK( !damage.isEmpty() );
+  BOOST_CHECK_EQUAL(damage.bounds(), SGRectf(10, 5, 30, 20));
+
+  damage.setFull();
+  BOOST_CHECK( damage.isFull() );
+  BOOST_CHECK( !damage.isEmpty() );
+
+  damage.clear();
+  BOOST_CHECK( damage.isEmpty() );
+  BOOST_CHECK( !damage.isFull() );
+}
+
+BOOST_AUTO_TEST_CASE( texture_region )
+{
+  sc::DamageRegion damage;
+  BOOST_CHECK_EQUAL(damage.toTexture(100, 100, 200, 200), SGRecti(0, 0, 0, 0));
+
+  // Rounded outwards and scaled from view to texture size
+  damage.add(SGRectf(10.2f, 20.7f, 5, 5));
+  BOOST_CHECK_EQUAL( damage.toTexture(100, 100, 100, 100, 0),
+                     SGRecti(10, 20, 6, 6) );
+  BOOST_CHECK_EQUAL( damage.toTexture(100, 100, 200, 100, 0),
+                     SGRecti(20, 20, 11, 6) );
+  BOOST_CHECK_EQUAL( damage.toTexture(100, 100, 100, 100),
+                     SGRecti(9, 19, 8, 8) );
+
+  // Clipped to texture
+  damage.add(SGRectf(-10, 90, 5, 20));
+  BOOST_CHECK_EQUAL( damage.toTexture(100, 100, 100, 100, 0),
+                     SGRecti(0, 20, 16, 80) );
+
+  // Whole texture
+  damage.setFull();
+  BOOST_CHECK_EQUAL( damage.toTexture(100, 100, 256, 128),
+                     SGRecti(0, 0, 256, 128) );
+}
@@ -207,6 +207,11 @@ namespace simgear::canvas
       parent->removeChild(_scene_group.get());
     }
 
+    // Redraw the area previously covered by this element
+    if( auto canvas = _canvas.lock() )
+      canvas->addDamage(_damage_bounds);
+    _damage_bounds = SGRectf();
+
     // Hide in case someone still holds a reference
     setVisible(false);
     removeListener();
@@ -232,6 +237,8 @@ namespace simgear::canvas
   {
     if( isVisible() )
       updateImpl(dt);
+
+    updateDamage();
   }
 
   //----------------------------------------------------------------------------
@@ -372,6 +379,9 @@ namespace simgear::canvas
   //----------------------------------------------------------------------------
   void Element::setVisible(bool visible)
   {
+    if( visible != isVisible() )
+      markDamaged();
+
     if( _scene_group.valid() )
       // TODO check if we need another nodemask
       _scene_group->setNodeMask(visible ? 0xffffffff : 0);
@@ -535,7 +545,10 @@ namespace simgear::canvas
       const std::string& name = child->getNameString();
       if( strutils::starts_with(name, "data-") )
         return;
-      else if( StyleInfo const* style_info = getStyleInfo(name) )
+
+      markDamaged();
+
+      if( StyleInfo const* style_info = getStyleInfo(name) )
       {
         SGPropertyNode const* style = child;
         if( isStyleEmpty(child) )
@@ -556,6 +569,7 @@ namespace simgear::canvas
             && parent->getNameString() == NAME_TRANSFORM )
     {
       _attributes_dirty |= TRANSFORM;
+      markDamaged();
       return;
     }
 
@@ -720,6 +734,37 @@ namespace simgear::canvas
     return _scene_group->getMatrix();
   }
 
+  //----------------------------------------------------------------------------
+  SGRectf Element::getCanvasBounds() const
+  {
+    if( !_drawable || !isVisible() )
+      return SGRectf();
+
+    const osg::BoundingBox& bb = _drawable->getBoundingBox();
+    if( !bb.valid() )
+      return SGRectf();
+
+    SGRectf bounds;
+    for(int i = 0; i < 4; ++i)
+    {
+      const vsg::vec2 pos = localToCanvas(vsg::vec2(bb.corner(i)[0], bb.corner(i)[1]));
+      bounds.expandBy(pos[0], pos[1]);
+    }
+    return bounds;
+  }
+
+  //----------------------------------------------------------------------------
+  void Element::markDamaged()
+  {
+    _damaged = true;
+  }
+
+  //----------------------------------------------------------------------------
+  const SGRectf& Element::getDamageBounds() const
+  {
+    return _damage_bounds;
+  }
+
   //----------------------------------------------------------------------------
   Element::StyleSetters Element::_style_setters;
 
@@ -942,6 +987,24 @@ namespace simgear::canvas
     _attributes_dirty &= ~TRANSFORM;
   }
 
+  //----------------------------------------------------------------------------
+  void Element::updateDamage()
+  {
+    if( !_damaged )
+      return;
+    _damaged = false;
+
+    // Damage both the previous and the new area, as the content may have
+    // changed even if the bounds stay the same.
+    SGRectf bounds = getCanvasBounds();
+    if( auto canvas = _canvas.lock() )
+    {
+      canvas->addDamage(_damage_bounds);
+      canvas->addDamage(bounds);
+    }
+    _damage_bounds = bounds;
+  }
+
   //----------------------------------------------------------------------------
   void Element::updateImpl(double dt)
   {
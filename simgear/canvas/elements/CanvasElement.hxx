@@ -15,6 +15,7 @@
 
 #include <simgear/canvas/CanvasEvent.hxx>
 #include <simgear/canvas/canvas_fwd.hxx>
+#include <simgear/math/SGRect.hxx>
 #include <simgear/misc/stdint.hxx> // for uint32_t
 #include <simgear/props/PropertyBasedElement.hxx>
 #include <simgear/std/type_traits.hxx>
@@ -213,6 +214,25 @@ public:
        */
     vsg::mat4 getMatrix() const;
 
+    /**
+       * Get the area covered by this element in canvas coordinates (empty if
+       * there is nothing to draw)
+       */
+    virtual SGRectf getCanvasBounds() const;
+
+    /**
+       * Mark the element as changed. With the next update the area covered
+       * before and after the change is added to the damage region of the
+       * canvas, to restrict redrawing to this area.
+       */
+    void markDamaged();
+
+    /**
+       * Get the area (in canvas coordinates) covered by this element when it
+       * has been drawn the last time
+       */
+    const SGRectf& getDamageBounds() const;
+
     /**
        * Create an canvas Element
        *
@@ -252,6 +272,9 @@ protected:
 
     mutable uint32_t _attributes_dirty = 0;
 
+    bool _damaged = true;     //!< Changed since last reported damage
+    SGRectf _damage_bounds;   //!< Area covered when last drawn (canvas coords)
+
     SceneGroupWeakPtr _scene_group;
     std::vector<TransformType> _transform_types;
 
@@ -539,6 +562,11 @@ protected:
 
     virtual void updateImpl(double dt);
 
+    /**
+       * Report area covered before and after the last change to the canvas
+       */
+    virtual void updateDamage();
+
 private:
     vsg::ref_ptr<osg::Drawable> _drawable;
 
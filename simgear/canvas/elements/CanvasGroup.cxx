@@ -14,6 +14,8 @@
 #include "CanvasPath.hxx"
 #include "CanvasText.hxx"
 
+#include <simgear/canvas/Canvas.hxx>
+#include <simgear/canvas/CanvasDamageRegion.hxx>
 #include <simgear/canvas/CanvasEventVisitor.hxx>
 #include <simgear/canvas/events/CanvasKeyBinding.hxx>
 #include <simgear/canvas/events/MouseEvent.hxx>
@@ -235,10 +237,68 @@ namespace simgear::canvas
   //----------------------------------------------------------------------------
   void Group::updateImpl(double dt)
   {
+    // Changing the group (eg. its transform or visibility) moves or
+    // changes all children
+    const bool damaged = _damaged;
+
     Element::updateImpl(dt);
 
     for(size_t i = 0; i < _scene_group->getNumChildren(); ++i)
-      getChildByIndex(i)->update(dt);
+    {
+      ElementPtr child = getChildByIndex(i);
+      if( damaged )
+        child->markDamaged();
+      child->update(dt);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  void Group::updateDamage()
+  {
+    if( isVisible() )
+    {
+      // Children have already reported their damage, just keep track of the
+      // area covered by all of them.
+      _damage_bounds = SGRectf();
+      for(size_t i = 0; i < _scene_group->getNumChildren(); ++i)
+      {
+        const SGRectf& bounds = getChildByIndex(i)->getDamageBounds();
+        if( DamageRegion::isValid(bounds) )
+        {
+          _damage_bounds.expandBy(bounds.l(), bounds.t());
+          _damage_bounds.expandBy(bounds.r(), bounds.b());
+        }
+      }
+    }
+    else if( _damaged )
+    {
+      // Hidden: Children are not updated anymore, so redraw the area covered
+      // by all of them.
+      if( auto canvas = _canvas.lock() )
+        canvas->addDamage(_damage_bounds);
+      _damage_bounds = SGRectf();
+    }
+
+    _damaged = false;
+  }
+
+  //----------------------------------------------------------------------------
+  SGRectf Group::getCanvasBounds() const
+  {
+    SGRectf bounds;
+    if( !isVisible() )
+      return bounds;
+
+    for(size_t i = 0; i < _scene_group->getNumChildren(); ++i)
+    {
+      SGRectf child_bounds = getChildByIndex(i)->getCanvasBounds();
+      if( DamageRegion::isValid(child_bounds) )
+      {
+        bounds.expandBy(child_bounds.l(), child_bounds.t());
+        bounds.expandBy(child_bounds.r(), child_bounds.b());
+      }
+    }
+    return bounds;
   }
 
   //----------------------------------------------------------------------------
@@ -88,6 +88,8 @@ namespace simgear::canvas
       osg::BoundingBox
       getTransformedBounds(const vsg::mat4& m) const override;
 
+      SGRectf getCanvasBounds() const override;
+
 
       FocusScope* getOrCreateFocusScope();
       FocusScope* getFocusScope() const;
@@ -103,6 +105,7 @@ namespace simgear::canvas
       virtual ElementFactory getChildFactory(const std::string& type) const;
 
       void updateImpl(double dt) override;
+      void updateDamage() override;
 
       void childAdded(SGPropertyNode * child) override;
       void childRemoved(SGPropertyNode * child) override;
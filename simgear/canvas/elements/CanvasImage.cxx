@@ -247,6 +247,9 @@ namespace simgear::canvas
     _geom->getOrCreateStateSet()
          ->setTextureAttributeAndModes(0, _texture);
 
+    // Images may be loaded asynchronously without any property change
+    markDamaged();
+
     if( img )
       setupDefaultDimensions();
   }
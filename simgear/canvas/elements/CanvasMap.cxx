@@ -77,20 +77,25 @@ namespace simgear::canvas
   {
     Group::updateImpl(dt);
 
+    _batch.clear();
     for(auto& it: _geo_nodes)
     {
       GeoNodePair* geo_node = it.second.get();
+
+      // Both nodes of a pair share the same GeoNodePair, so only handle it for
+      // the latitude node.
       if(    !geo_node->isComplete()
+          || it.first != geo_node->getNodeLat()
           || (!geo_node->isDirty() && !_projection_dirty) )
         continue;
 
       double latD = -9999.0, lonD = -9999.0;
       if (geo_node->isDirty()) {
-        GeoCoord lat = parseGeoCoord(geo_node->getLat());
+        GeoCoord lat = getGeoCoord(geo_node->getNodeLat());
         if( lat.type != GeoCoord::LATITUDE )
           continue;
 
-        GeoCoord lon = parseGeoCoord(geo_node->getLon());
+        GeoCoord lon = getGeoCoord(geo_node->getNodeLon());
         if( lon.type != GeoCoord::LONGITUDE )
           continue;
 
@@ -103,8 +108,20 @@ namespace simgear::canvas
         std::tie(latD, lonD) = geo_node->getCachedLatLon();
       }
 
-      Projection::ScreenPosition pos = _projection->worldToScreen(latD, lonD);
-      geo_node->setScreenPos(pos.x, pos.y);
+      _batch.nodes.push_back(geo_node);
+      _batch.x.push_back(latD);
+      _batch.y.push_back(lonD);
+    }
+
+    // Project all positions at once (in place)
+    _projection->worldToScreen( _batch.nodes.size(),
+                                _batch.x.data(), _batch.y.data(),
+                                _batch.x.data(), _batch.y.data() );
+
+    for(size_t i = 0; i < _batch.nodes.size(); ++i)
+    {
+      GeoNodePair* geo_node = _batch.nodes[i];
+      geo_node->setScreenPos(_batch.x[i], _batch.y[i]);
 
 //      geo_node->print();
       geo_node->setDirty(false);
@@ -228,7 +245,7 @@ namespace simgear::canvas
       return;
 
     // Detect lat, lon tuples...
-    GeoCoord coord = parseGeoCoord(child->getStringValue());
+    GeoCoord coord = getGeoCoord(child);
     int index_other = -1;
 
     switch( coord.type )
@@ -250,7 +267,7 @@ namespace simgear::canvas
     if( !other )
       return;
 
-    GeoCoord coord_other = parseGeoCoord(other->getStringValue());
+    GeoCoord coord_other = getGeoCoord(other);
     if(    coord_other.type == GeoCoord::INVALID
         || coord_other.type == coord.type )
       return;
@@ -282,6 +299,31 @@ namespace simgear::canvas
     );
   }
 
+  //----------------------------------------------------------------------------
+  Map::GeoCoord Map::getGeoCoord(const SGPropertyNode* node) const
+  {
+    if( !node )
+      return GeoCoord();
+
+    switch( node->getType() )
+    {
+      case props::INT:
+      case props::LONG:
+      case props::FLOAT:
+      case props::DOUBLE:
+      {
+        // Numeric values (degrees) are paired by index: lat[2n], lon[2n + 1]
+        GeoCoord coord;
+        coord.type = (node->getIndex() % 2) ? GeoCoord::LONGITUDE
+                                            : GeoCoord::LATITUDE;
+        coord.value = node->getDoubleValue();
+        return coord;
+      }
+      default:
+        return parseGeoCoord(node->getStringValue());
+    }
+  }
+
   //----------------------------------------------------------------------------
   Map::GeoCoord Map::parseGeoCoord(const std::string& val) const
   {
@@ -13,11 +13,23 @@
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace simgear::canvas
 {
   class GeoNodePair;
   class HorizontalProjection;
+
+  /**
+   * Group transforming geographic positions of its children to screen
+   * coordinates.
+   *
+   * Geographic positions are given by pairs of nodes with the suffix "-geo"
+   * (eg. coord-geo[0] and coord-geo[1] for coord[0] and coord[1]). They are
+   * either given as strings with a hemisphere prefix (eg. "N47.5", "E11.2"),
+   * or - avoiding any string parsing - as numeric values in degrees, with the
+   * latitude stored at the even and the longitude at the following odd index.
+   */
   class Map:
     public Group
   {
@@ -45,10 +57,29 @@ namespace simgear::canvas
         std::unordered_map<SGPropertyNode*, std::shared_ptr<GeoNodePair>>;
       using NodeSet = std::unordered_set<SGPropertyNode*>;
 
+      /**
+       * Positions to be projected during the current update (structure of
+       * arrays, reused between updates to avoid allocations)
+       */
+      struct ProjectionBatch
+      {
+        std::vector<GeoNodePair*> nodes;
+        std::vector<double> x, ///< latitude, screen x after projection
+                            y; ///< longitude, screen y after projection
+
+        void clear()
+        {
+          nodes.clear();
+          x.clear();
+          y.clear();
+        }
+      };
+
       GeoNodes _geo_nodes;
       NodeSet  _hdg_nodes;
       std::shared_ptr<HorizontalProjection> _projection;
       bool _projection_dirty = false;
+      ProjectionBatch _batch;
 
       struct GeoCoord
       {
@@ -65,6 +96,7 @@ namespace simgear::canvas
       void geoNodeChanged(SGPropertyNode* child);
       void hdgNodeChanged(SGPropertyNode* child);
 
+      GeoCoord getGeoCoord(const SGPropertyNode* node) const;
       GeoCoord parseGeoCoord(const std::string& val) const;
   };
 
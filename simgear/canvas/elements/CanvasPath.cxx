@@ -9,6 +9,8 @@
 #include <simgear_config.h>
 
 #include "CanvasPath.hxx"
+#include "CanvasPathRasterizer.hxx"
+#include "CanvasPathTessellator.hxx"
 #include <simgear/scene/util/parse_color.hxx>
 #include <simgear/misc/strutils.hxx>
 
@@ -234,6 +236,7 @@ namespace simgear::canvas
       {
         _cmds = cmds;
         _coords = coords;
+        _tessellator.setSegments(_cmds, _coords);
 
         _attributes_dirty |= (PATH | BOUNDING_BOX);
       }
@@ -549,29 +552,61 @@ namespace simgear::canvas
 
       /**
        * Compute the bounding box
+       *
+       * Uses the CPU tessellator, so no OpenVG context is required.
        */
       osg::BoundingBox computeBoundingBox()
 
       const override
       {
-        if( _path == VG_INVALID_HANDLE || (_attributes_dirty & PATH) )
+        SGRectf bounds = _tessellator.bounds();
+        if( bounds.width() < 0 || bounds.height() < 0 )
           return osg::BoundingBox();
 
-        VGfloat min[2], size[2];
-        vgPathBounds(_path, &min[0], &min[1], &size[0], &size[1]);
-
         _attributes_dirty &= ~BOUNDING_BOX;
 
-        // vgPathBounds doesn't take stroke width into account
+        // The path bounds don't take stroke width into account
         float ext = 0.5 * _stroke_width;
 
         return osg::BoundingBox
         (
-          min[0] - ext,           min[1] - ext,           -0.1,
-          min[0] + size[0] + ext, min[1] + size[1] + ext,  0.1
+          bounds.l() - ext, bounds.t() - ext, -0.1,
+          bounds.r() + ext, bounds.b() + ext,  0.1
         );
       }
 
+      /**
+       * Render fill and stroke of the path (in local coordinates) using the
+       * software rasterizer.
+       *
+       * @return Number of pixels written
+       */
+      size_t rasterize(PathRasterizer& rasterizer) const
+      {
+        size_t num_pixels = 0;
+        if( _mode & VG_FILL_PATH )
+        {
+          auto color = _fill_color;
+          color.a() *= _fill_opacity / 255.f;
+          num_pixels += rasterizer.draw(
+            _tessellator.fill( _fill_rule == VG_NON_ZERO
+                               ? PathTessellator::FILL_NON_ZERO
+                               : PathTessellator::FILL_EVEN_ODD ),
+            SGVec4f(color[0], color[1], color[2], color[3])
+          );
+        }
+        if( _mode & VG_STROKE_PATH )
+        {
+          auto color = _stroke_color;
+          color.a() *= _stroke_opacity / 255.f;
+          num_pixels += rasterizer.draw(
+            _tessellator.stroke(getStrokeStyle()),
+            SGVec4f(color[0], color[1], color[2], color[3])
+          );
+        }
+        return num_pixels;
+      }
+
     private:
 
       enum Attributes
@@ -592,6 +627,8 @@ namespace simgear::canvas
       CmdList   _cmds;
       CoordList _coords;
 
+      mutable PathTessellator _tessellator;
+
       VGbitfield            _mode {0};
       vsg::vec4            _fill_color;
       uint8_t               _fill_opacity {255};
@@ -603,6 +640,29 @@ namespace simgear::canvas
       VGCapStyle            _stroke_linecap {VG_CAP_BUTT};
       VGJoinStyle           _stroke_linejoin {VG_JOIN_MITER};
 
+      PathTessellator::StrokeStyle getStrokeStyle() const
+      {
+        PathTessellator::StrokeStyle style;
+        style.width = _stroke_width;
+        style.dash = _stroke_dash;
+
+        switch( _stroke_linecap )
+        {
+          case VG_CAP_ROUND:  style.cap = PathTessellator::CAP_ROUND; break;
+          case VG_CAP_SQUARE: style.cap = PathTessellator::CAP_SQUARE; break;
+          default:            style.cap = PathTessellator::CAP_BUTT; break;
+        }
+
+        switch( _stroke_linejoin )
+        {
+          case VG_JOIN_ROUND: style.join = PathTessellator::JOIN_ROUND; break;
+          case VG_JOIN_BEVEL: style.join = PathTessellator::JOIN_BEVEL; break;
+          default:            style.join = PathTessellator::JOIN_MITER; break;
+        }
+
+        return style;
+      }
+
       vsg::vec3 transformPoint( const vsg::mat4& m,
                                  vsg::vec2 pos ) const
       {
@@ -619,6 +679,14 @@ namespace simgear::canvas
        */
       void update()
       {
+        if( _attributes_dirty & BOUNDING_BOX )
+        {
+          dirtyBound();
+
+          // Recalculate bounding box now (prevent race condition)
+          getBound();
+        }
+
         if( !vgHasContextSH() )
           return;
 
@@ -643,15 +711,6 @@ namespace simgear::canvas
             vgAppendPathData(_path, _cmds.size(), &_cmds[0], &_coords[0]);
 
           _attributes_dirty &= ~PATH;
-          _attributes_dirty |= BOUNDING_BOX;
-        }
-
-        if( _attributes_dirty & BOUNDING_BOX )
-        {
-          dirtyBound();
-
-          // Recalculate bounding box now (prevent race condition)
-          getBound();
         }
       }
 
@@ -715,6 +774,14 @@ namespace simgear::canvas
     return _path->getTransformedBounds(m);
   }
 
+  //----------------------------------------------------------------------------
+  size_t Path::rasterize(PathRasterizer& rasterizer)
+  {
+    // Ensure pending changes of the property tree are applied
+    update(0);
+    return _path->rasterize(rasterizer);
+  }
+
   //----------------------------------------------------------------------------
   Path& Path::addSegment(uint8_t cmd, std::initializer_list<float> coords)
   {
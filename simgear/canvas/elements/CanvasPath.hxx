@@ -14,6 +14,8 @@
 
 namespace simgear::canvas
 {
+  class PathRasterizer;
+
   class Path:
     public Element
   {
@@ -30,6 +32,14 @@ namespace simgear::canvas
       osg::BoundingBox
       getTransformedBounds(const vsg::mat4& m) const override;
 
+      /**
+       * Render the path (in local coordinates) without a graphics context
+       * using the software rasterizer.
+       *
+       * @return Number of pixels written
+       */
+      size_t rasterize(PathRasterizer& rasterizer);
+
       /** Add a segment with the given command and coordinates */
       Path& addSegment(uint8_t cmd, std::initializer_list<float> coords = {});
 
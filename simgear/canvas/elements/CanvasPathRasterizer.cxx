@@ -0,0 +1,268 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Software rasterizer for tessellated canvas paths
+ */
+
+#include <simgear_config.h>
+
+#include "CanvasPathRasterizer.hxx"
+
+#include <algorithm>
+#include <cmath>
+
+namespace simgear::canvas
+{
+  namespace
+  {
+    // Vertices are snapped to a fixed point grid, which allows evaluating the
+    // edge functions exactly (and shared edges being handled consistently).
+    const int subpixelBits = 8;
+    const int64_t subpixelScale = 1 << subpixelBits;
+
+    struct FixedPoint
+    {
+      int64_t x, y;
+    };
+
+    FixedPoint toFixed(const SGVec2f& p)
+    {
+      return { static_cast<int64_t>(std::lround(p.x() * subpixelScale)),
+               static_cast<int64_t>(std::lround(p.y() * subpixelScale)) };
+    }
+
+    int64_t edge(const FixedPoint& a, const FixedPoint& b, int64_t x, int64_t y)
+    {
+      return (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+    }
+
+    /**
+     * Whether points exactly on the edge a->b are considered inside
+     * (top-left rule for triangles with positive area in y-down coordinates)
+     */
+    bool isTopLeft(const FixedPoint& a, const FixedPoint& b)
+    {
+      int64_t dx = b.x - a.x,
+              dy = b.y - a.y;
+      return (dy == 0 && dx > 0) || dy < 0;
+    }
+
+    uint8_t toByte(float v)
+    {
+      return static_cast<uint8_t>(std::lround(SGMiscf::clip(v, 0.f, 1.f) * 255));
+    }
+  } // anonymous namespace
+
+  //----------------------------------------------------------------------------
+  PathRasterizer::PathRasterizer(int width, int height):
+    _width(std::max(width, 0)),
+    _height(std::max(height, 0)),
+    _data(static_cast<size_t>(_width) * _height * 4, 0)
+  {
+    resetTransform();
+    resetClip();
+  }
+
+  //----------------------------------------------------------------------------
+  void PathRasterizer::clear(const SGVec4f& color)
+  {
+    const uint8_t rgba[4] = { toByte(color[0]), toByte(color[1]),
+                              toByte(color[2]), toByte(color[3]) };
+    for(int y = _clip.t(); y < _clip.b(); ++y)
+    {
+      uint8_t* row = &_data[(static_cast<size_t>(y) * _width) * 4];
+      for(int x = _clip.l(); x < _clip.r(); ++x)
+        std::copy(rgba, rgba + 4, row + x * 4);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  void PathRasterizer::setClip(const SGRecti& clip)
+  {
+    _clip = SGRecti( SGVec2i( std::clamp(clip.l(), 0, _width),
+                              std::clamp(clip.t(), 0, _height) ),
+                     SGVec2i( std::clamp(clip.r(), 0, _width),
+                              std::clamp(clip.b(), 0, _height) ) );
+  }
+
+  //----------------------------------------------------------------------------
+  void PathRasterizer::resetClip()
+  {
+    _clip = SGRecti(0, 0, _width, _height);
+  }
+
+  //----------------------------------------------------------------------------
+  void PathRasterizer::setTransform(const Transform& transform)
+  {
+    _transform = transform;
+  }
+
+  //----------------------------------------------------------------------------
+  void PathRasterizer::resetTransform()
+  {
+    _transform = {1, 0, 0, 1, 0, 0};
+  }
+
+  //----------------------------------------------------------------------------
+  size_t PathRasterizer::draw( const PathTessellator::Mesh& mesh,
+                               const SGVec4f& color )
+  {
+    if( color[3] <= 0 )
+      return 0;
+
+    if( _coverage.size() != _data.size() / 4 )
+      _coverage.assign(_data.size() / 4, 0);
+
+    // Mark the covered pixels first, then blend each of them once
+    SGRecti bounds;
+    for(size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+      coverTriangle( transform(mesh.vertices[mesh.indices[i]]),
+                     transform(mesh.vertices[mesh.indices[i + 1]]),
+                     transform(mesh.vertices[mesh.indices[i + 2]]),
+                     bounds );
+
+    size_t num_pixels = 0;
+    for(int y = bounds.t(); y < bounds.b(); ++y)
+    {
+      const size_t row_start = static_cast<size_t>(y) * _width;
+      uint8_t* row = &_data[row_start * 4];
+      uint8_t* covered = &_coverage[row_start];
+      for(int x = bounds.l(); x < bounds.r(); ++x)
+      {
+        if( !covered[x] )
+          continue;
+
+        covered[x] = 0;
+        blend(row + x * 4, color);
+        ++num_pixels;
+      }
+    }
+    return num_pixels;
+  }
+
+  //----------------------------------------------------------------------------
+  SGVec4f PathRasterizer::getPixel(int x, int y) const
+  {
+    if( x < 0 || y < 0 || x >= _width || y >= _height )
+      return SGVec4f(0, 0, 0, 0);
+
+    const uint8_t* px = &_data[(static_cast<size_t>(y) * _width + x) * 4];
+    return (1 / 255.f) * SGVec4f(px[0], px[1], px[2], px[3]);
+  }
+
+  //----------------------------------------------------------------------------
+  SGVec2f PathRasterizer::transform(const SGVec2f& p) const
+  {
+    const Transform& m = _transform;
+    return SGVec2f( m[0] * p.x() + m[2] * p.y() + m[4],
+                    m[1] * p.x() + m[3] * p.y() + m[5] );
+  }
+
+  //----------------------------------------------------------------------------
+  void PathRasterizer::coverTriangle( SGVec2f pa,
+                                      SGVec2f pb,
+                                      SGVec2f pc,
+                                      SGRecti& bounds )
+  {
+    FixedPoint a = toFixed(pa),
+               b = toFixed(pb),
+               c = toFixed(pc);
+
+    int64_t area = edge(a, b, c.x, c.y);
+    if( area == 0 )
+      return;
+    if( area < 0 )
+      std::swap(b, c);
+
+    // Pixel centers are at (i + 0.5, j + 0.5)
+    auto firstPixel = [](int64_t v)
+    {
+      return static_cast<int>(
+        std::ceil(static_cast<double>(v) / subpixelScale - 0.5)
+      );
+    };
+    auto lastPixel = [](int64_t v)
+    {
+      return static_cast<int>(
+        std::floor(static_cast<double>(v) / subpixelScale - 0.5)
+      );
+    };
+
+    int x_min = std::max(firstPixel(std::min({a.x, b.x, c.x})), _clip.l()),
+        x_max = std::min(lastPixel(std::max({a.x, b.x, c.x})), _clip.r() - 1),
+        y_min = std::max(firstPixel(std::min({a.y, b.y, c.y})), _clip.t()),
+        y_max = std::min(lastPixel(std::max({a.y, b.y, c.y})), _clip.b() - 1);
+
+    if( x_min > x_max || y_min > y_max )
+      return;
+
+    // Bias edge values so that "inside" is always w > 0, with points exactly
+    // on non top-left edges being excluded.
+    const int64_t bias0 = isTopLeft(b, c) ? 0 : -1,
+                  bias1 = isTopLeft(c, a) ? 0 : -1,
+                  bias2 = isTopLeft(a, b) ? 0 : -1;
+
+    // Edge function increments per pixel step
+    const int64_t step_x0 = -(c.y - b.y) * subpixelScale,
+                  step_x1 = -(a.y - c.y) * subpixelScale,
+                  step_x2 = -(b.y - a.y) * subpixelScale;
+
+    const int64_t half = subpixelScale / 2;
+    bool any = false;
+
+    for(int y = y_min; y <= y_max; ++y)
+    {
+      int64_t py = y * subpixelScale + half,
+              px = x_min * subpixelScale + half;
+
+      int64_t w0 = edge(b, c, px, py) + bias0,
+              w1 = edge(c, a, px, py) + bias1,
+              w2 = edge(a, b, px, py) + bias2;
+
+      uint8_t* row = &_coverage[static_cast<size_t>(y) * _width];
+      for(int x = x_min; x <= x_max; ++x)
+      {
+        if( (w0 | w1 | w2) >= 0 )
+        {
+          row[x] = 1;
+          any = true;
+        }
+
+        w0 += step_x0;
+        w1 += step_x1;
+        w2 += step_x2;
+      }
+    }
+
+    if( any )
+    {
+      bounds.expandBy(x_min, y_min);
+      bounds.expandBy(x_max + 1, y_max + 1);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  void PathRasterizer::blend(uint8_t* px, const SGVec4f& color) const
+  {
+    float src_a = SGMiscf::clip(color[3], 0.f, 1.f);
+    if( src_a >= 1 )
+    {
+      for(int i = 0; i < 4; ++i)
+        px[i] = toByte(color[i]);
+      return;
+    }
+
+    float dst_a = px[3] / 255.f,
+          out_a = src_a + dst_a * (1 - src_a);
+    if( out_a <= 0 )
+      return;
+
+    for(int i = 0; i < 3; ++i)
+      px[i] = toByte(
+        (color[i] * src_a + px[i] / 255.f * dst_a * (1 - src_a)) / out_a
+      );
+    px[3] = toByte(out_a);
+  }
+
+} // namespace simgear::canvas
@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Software rasterizer for tessellated canvas paths
+ */
+
+#pragma once
+
+#include "CanvasPathTessellator.hxx"
+
+#include <simgear/math/SGRect.hxx>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace simgear::canvas
+{
+
+  /**
+   * Render triangle meshes created by PathTessellator into an RGBA8 image on
+   * the CPU. Allows rendering (and testing/benchmarking) paths without any
+   * GPU or graphics context.
+   *
+   * Pixels are sampled at their centers using a top-left fill convention, so
+   * pixels on edges shared between adjacent triangles are drawn exactly
+   * once. Colors use straight (non-premultiplied) alpha and are blended with
+   * the "source over" operator.
+   *
+   * The triangles of a mesh are first combined into a coverage mask, so
+   * pixels covered by several of them (like the overlapping joins and caps of
+   * a stroke) are blended only once.
+   */
+  class PathRasterizer
+  {
+    public:
+      /** 2D affine transform (a, b, c, d, e, f) as in SVG's matrix() */
+      using Transform = std::array<float, 6>;
+
+      PathRasterizer(int width, int height);
+
+      int width() const { return _width; }
+      int height() const { return _height; }
+
+      /** Fill the whole image (or clip area) with the given color */
+      void clear(const SGVec4f& color = SGVec4f(0, 0, 0, 0));
+
+      /**
+       * Restrict clearing and drawing to the given area (pixels, clipped to
+       * the image)
+       */
+      void setClip(const SGRecti& clip);
+      void resetClip();
+
+      /** Set transform applied to all following draw calls */
+      void setTransform(const Transform& transform);
+      void resetTransform();
+
+      /**
+       * Draw the area covered by the triangles of the given mesh with a
+       * constant color
+       *
+       * @return Number of pixels written
+       */
+      size_t draw(const PathTessellator::Mesh& mesh, const SGVec4f& color);
+
+      /** Get color of the pixel at the given position (0..1 per channel) */
+      SGVec4f getPixel(int x, int y) const;
+
+      /** Raw RGBA8 image data, rows top to bottom */
+      const std::vector<uint8_t>& data() const { return _data; }
+
+    protected:
+      int                   _width,
+                            _height;
+      std::vector<uint8_t>  _data;
+      Transform             _transform;
+      SGRecti               _clip;
+
+      /** One byte per pixel, set while drawing a mesh */
+      std::vector<uint8_t>  _coverage;
+
+      SGVec2f transform(const SGVec2f& p) const;
+      void coverTriangle( SGVec2f a,
+                          SGVec2f b,
+                          SGVec2f c,
+                          SGRecti& bounds );
+      void blend(uint8_t* px, const SGVec4f& color) const;
+  };
+
+} // namespace simgear::canvas
@@ -0,0 +1,966 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief CPU tessellation of OpenVG paths into triangle meshes
+ */
+
+#include <simgear_config.h>
+
+#include "CanvasPathTessellator.hxx"
+
+#include <simgear/debug/logstream.hxx>
+
+#include <vg/openvg.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <unordered_map>
+
+namespace simgear::canvas
+{
+  namespace
+  {
+    const uint8_t coordsPerCommand[] = {
+      0, /* VG_CLOSE_PATH */
+      2, /* VG_MOVE_TO */
+      2, /* VG_LINE_TO */
+      1, /* VG_HLINE_TO */
+      1, /* VG_VLINE_TO */
+      4, /* VG_QUAD_TO */
+      6, /* VG_CUBIC_TO */
+      2, /* VG_SQUAD_TO */
+      4, /* VG_SCUBIC_TO */
+      5, /* VG_SCCWARC_TO */
+      5, /* VG_SCWARC_TO */
+      5, /* VG_LCCWARC_TO */
+      5  /* VG_LCWARC_TO */
+    };
+    const uint8_t numCommands = sizeof(coordsPerCommand)
+                              / sizeof(coordsPerCommand[0]);
+
+    // Limit for the number of segments a single curve/arc is split into
+    const int maxCurveSegments = 256;
+
+    float cross(const SGVec2f& a, const SGVec2f& b)
+    {
+      return a.x() * b.y() - a.y() * b.x();
+    }
+
+    /** Left hand normal */
+    SGVec2f perp(const SGVec2f& v)
+    {
+      return SGVec2f(-v.y(), v.x());
+    }
+
+    int clampSegments(float n)
+    {
+      if( !(n >= 1) )
+        return 1;
+      return std::min(static_cast<int>(std::ceil(n)), maxCurveSegments);
+    }
+
+    /**
+     * Number of segments required to approximate a circle segment of the
+     * given radius and angle within the tolerance.
+     */
+    int arcSegments(float radius, float angle, float tolerance)
+    {
+      if( radius <= tolerance )
+        return clampSegments(std::fabs(angle) / (SGMiscf::pi() / 2));
+
+      float step = 2 * std::acos(1 - tolerance / radius);
+      return clampSegments(std::fabs(angle) / step);
+    }
+
+    void addTriangle( PathTessellator::Mesh& mesh,
+                      const SGVec2f& a,
+                      const SGVec2f& b,
+                      const SGVec2f& c )
+    {
+      uint32_t base = mesh.vertices.size();
+      mesh.vertices.push_back(a);
+      mesh.vertices.push_back(b);
+      mesh.vertices.push_back(c);
+      mesh.indices.push_back(base);
+      mesh.indices.push_back(base + 1);
+      mesh.indices.push_back(base + 2);
+    }
+
+    /** Add quad a-b-c-d (in order around the outline) */
+    void addQuad( PathTessellator::Mesh& mesh,
+                  const SGVec2f& a,
+                  const SGVec2f& b,
+                  const SGVec2f& c,
+                  const SGVec2f& d )
+    {
+      uint32_t base = mesh.vertices.size();
+      mesh.vertices.push_back(a);
+      mesh.vertices.push_back(b);
+      mesh.vertices.push_back(c);
+      mesh.vertices.push_back(d);
+      for(uint32_t i: {0u, 1u, 2u, 0u, 2u, 3u})
+        mesh.indices.push_back(base + i);
+    }
+
+    /** Add a triangle fan around @a center from angle @a a0 to @a a1 */
+    void addFan( PathTessellator::Mesh& mesh,
+                 const SGVec2f& center,
+                 float radius,
+                 float a0,
+                 float a1,
+                 float tolerance )
+    {
+      int n = arcSegments(radius, a1 - a0, tolerance);
+      SGVec2f prev = center + radius * SGVec2f(std::cos(a0), std::sin(a0));
+      for(int i = 1; i <= n; ++i)
+      {
+        float a = a0 + (a1 - a0) * i / n;
+        SGVec2f cur = center + radius * SGVec2f(std::cos(a), std::sin(a));
+        addTriangle(mesh, center, prev, cur);
+        prev = cur;
+      }
+    }
+
+    /**
+     * Flatten an elliptical arc given in endpoint parameterization.
+     *
+     * @see https://www.w3.org/TR/SVG11/implnote.html#ArcImplementationNotes
+     */
+    void flattenArc( std::vector<SGVec2f>& points,
+                     const SGVec2f& p0,
+                     float rh,
+                     float rv,
+                     float rot_deg,
+                     const SGVec2f& p1,
+                     bool large,
+                     bool ccw,
+                     float tolerance )
+    {
+      float rx = std::fabs(rh),
+            ry = std::fabs(rv);
+      if( rx < 1e-6f || ry < 1e-6f || equivalent(p0, p1) )
+      {
+        points.push_back(p1);
+        return;
+      }
+
+      float phi = SGMiscf::deg2rad(rot_deg),
+            cos_phi = std::cos(phi),
+            sin_phi = std::sin(phi);
+
+      SGVec2f d = 0.5f * (p0 - p1);
+      float x1 =  cos_phi * d.x() + sin_phi * d.y(),
+            y1 = -sin_phi * d.x() + cos_phi * d.y();
+
+      // Scale up radii if they are too small to reach the end point
+      float lambda = (x1 * x1) / (rx * rx) + (y1 * y1) / (ry * ry);
+      if( lambda > 1 )
+      {
+        float s = std::sqrt(lambda);
+        rx *= s;
+        ry *= s;
+      }
+
+      float num = rx * rx * ry * ry - rx * rx * y1 * y1 - ry * ry * x1 * x1,
+            den = rx * rx * y1 * y1 + ry * ry * x1 * x1;
+      float coef = den > 0 ? std::sqrt(std::max(0.f, num / den)) : 0;
+      if( large == ccw )
+        coef = -coef;
+
+      float cx1 =  coef * rx * y1 / ry,
+            cy1 = -coef * ry * x1 / rx;
+
+      SGVec2f mid = 0.5f * (p0 + p1);
+      SGVec2f center( cos_phi * cx1 - sin_phi * cy1 + mid.x(),
+                      sin_phi * cx1 + cos_phi * cy1 + mid.y() );
+
+      float theta1 = std::atan2((y1 - cy1) / ry, (x1 - cx1) / rx),
+            theta2 = std::atan2((-y1 - cy1) / ry, (-x1 - cx1) / rx),
+            dtheta = theta2 - theta1;
+
+      if( ccw && dtheta < 0 )
+        dtheta += 2 * SGMiscf::pi();
+      else if( !ccw && dtheta > 0 )
+        dtheta -= 2 * SGMiscf::pi();
+
+      int n = arcSegments(std::max(rx, ry), dtheta, tolerance);
+      for(int i = 1; i < n; ++i)
+      {
+        float t = theta1 + dtheta * i / n;
+        float ex = rx * std::cos(t),
+              ey = ry * std::sin(t);
+        points.push_back(SGVec2f( cos_phi * ex - sin_phi * ey + center.x(),
+                                  sin_phi * ex + cos_phi * ey + center.y() ));
+      }
+
+      // Use exact end point to prevent accumulating errors
+      points.push_back(p1);
+    }
+
+    void flattenQuad( std::vector<SGVec2f>& points,
+                      const SGVec2f& p0,
+                      const SGVec2f& c,
+                      const SGVec2f& p1,
+                      float tolerance )
+    {
+      float dd = norm(p0 - 2.f * c + p1);
+      int n = clampSegments(std::sqrt(0.25f * dd / tolerance));
+      for(int i = 1; i < n; ++i)
+      {
+        float t = static_cast<float>(i) / n,
+              u = 1 - t;
+        points.push_back(u * u * p0 + 2 * u * t * c + t * t * p1);
+      }
+      points.push_back(p1);
+    }
+
+    void flattenCubic( std::vector<SGVec2f>& points,
+                       const SGVec2f& p0,
+                       const SGVec2f& c0,
+                       const SGVec2f& c1,
+                       const SGVec2f& p1,
+                       float tolerance )
+    {
+      float dd = std::max( norm(p0 - 2.f * c0 + c1),
+                           norm(c0 - 2.f * c1 + p1) );
+      int n = clampSegments(std::sqrt(0.75f * dd / tolerance));
+      for(int i = 1; i < n; ++i)
+      {
+        float t = static_cast<float>(i) / n,
+              u = 1 - t;
+        points.push_back( u * u * u * p0
+                        + 3 * u * u * t * c0
+                        + 3 * u * t * t * c1
+                        + t * t * t * p1 );
+      }
+      points.push_back(p1);
+    }
+
+    /**
+     * Advance the current point (and subpath start point) over a single
+     * command without flattening. Used to split the path into subpaths.
+     */
+    void advance( uint8_t cmd,
+                  bool rel,
+                  const float* c,
+                  SGVec2f& cur,
+                  SGVec2f& sub )
+    {
+      SGVec2f offset = rel ? cur : SGVec2f(0, 0);
+      switch( cmd )
+      {
+        case VG_CLOSE_PATH:
+          cur = sub;
+          break;
+        case VG_MOVE_TO:
+          cur = sub = offset + SGVec2f(c[0], c[1]);
+          break;
+        case VG_LINE_TO:
+        case VG_SQUAD_TO:
+          cur = offset + SGVec2f(c[0], c[1]);
+          break;
+        case VG_HLINE_TO:
+          cur.x() = offset.x() + c[0];
+          break;
+        case VG_VLINE_TO:
+          cur.y() = offset.y() + c[0];
+          break;
+        case VG_QUAD_TO:
+        case VG_SCUBIC_TO:
+          cur = offset + SGVec2f(c[2], c[3]);
+          break;
+        case VG_CUBIC_TO:
+          cur = offset + SGVec2f(c[4], c[5]);
+          break;
+        default: // arcs
+          cur = offset + SGVec2f(c[3], c[4]);
+          break;
+      }
+    }
+
+    struct Edge
+    {
+      float x0, y0, x1, y1;
+      int   dir;
+
+      float xAt(float y) const
+      {
+        if( y1 == y0 )
+          return x0;
+        return x0 + (x1 - x0) * (y - y0) / (y1 - y0);
+      }
+    };
+
+    size_t hashSubpath( const SGVec2f& start,
+                        const uint8_t* cmds,
+                        size_t num_cmds,
+                        const float* coords,
+                        size_t num_coords )
+    {
+      std::hash<float> hf;
+      size_t h = hf(start.x()) ^ (hf(start.y()) << 1);
+      for(size_t i = 0; i < num_cmds; ++i)
+        h = h * 31 + cmds[i];
+      for(size_t i = 0; i < num_coords; ++i)
+        h = h * 31 + hf(coords[i]);
+      return h;
+    }
+  } // anonymous namespace
+
+  //----------------------------------------------------------------------------
+  void PathTessellator::Mesh::clear()
+  {
+    vertices.clear();
+    indices.clear();
+  }
+
+  //----------------------------------------------------------------------------
+  void PathTessellator::Mesh::append(const Mesh& other)
+  {
+    uint32_t base = vertices.size();
+    vertices.insert(vertices.end(), other.vertices.begin(), other.vertices.end());
+    indices.reserve(indices.size() + other.indices.size());
+    for(uint32_t i: other.indices)
+      indices.push_back(base + i);
+  }
+
+  //----------------------------------------------------------------------------
+  double PathTessellator::Mesh::area() const
+  {
+    double a = 0;
+    for(size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+      const SGVec2f& p0 = vertices[indices[i]],
+                     p1 = vertices[indices[i + 1]],
+                     p2 = vertices[indices[i + 2]];
+      a += 0.5 * std::fabs(cross(p1 - p0, p2 - p0));
+    }
+    return a;
+  }
+
+  //----------------------------------------------------------------------------
+  bool
+  PathTessellator::StrokeStyle::operator==(const StrokeStyle& rhs) const
+  {
+    return width == rhs.width
+        && cap == rhs.cap
+        && join == rhs.join
+        && miter_limit == rhs.miter_limit
+        && dash == rhs.dash
+        && dash_offset == rhs.dash_offset;
+  }
+
+  //----------------------------------------------------------------------------
+  void PathTessellator::setSegments( const std::vector<uint8_t>& cmds,
+                                     const std::vector<float>& coords )
+  {
+    // Index existing subpaths by their content to be able to reuse them even
+    // if subpaths have been inserted or removed before them.
+    std::unordered_multimap<size_t, size_t> old_index;
+    for(size_t i = 0; i < _subpaths.size(); ++i)
+    {
+      const Subpath& s = _subpaths[i];
+      old_index.emplace( hashSubpath( s.start,
+                                      s.cmds.data(), s.cmds.size(),
+                                      s.coords.data(), s.coords.size() ),
+                         i );
+    }
+
+    std::vector<Subpath> old_subpaths;
+    old_subpaths.swap(_subpaths);
+    std::vector<bool> old_used(old_subpaths.size(), false);
+    bool changed = false;
+
+    auto finishSubpath = [&]( const SGVec2f& start,
+                              size_t cmd_begin, size_t cmd_end,
+                              size_t coord_begin, size_t coord_end )
+    {
+      if( cmd_begin == cmd_end )
+        return;
+
+      const uint8_t* c = cmds.data() + cmd_begin;
+      const float* v = coords.data() + coord_begin;
+      size_t nc = cmd_end - cmd_begin,
+             nv = coord_end - coord_begin;
+
+      auto range = old_index.equal_range(hashSubpath(start, c, nc, v, nv));
+      for(auto it = range.first; it != range.second; ++it)
+      {
+        Subpath& old = old_subpaths[it->second];
+        if(    !old_used[it->second]
+            && old.start == start
+            && std::equal(c, c + nc, old.cmds.begin(), old.cmds.end())
+            && std::equal(v, v + nv, old.coords.begin(), old.coords.end()) )
+        {
+          old_used[it->second] = true;
+          changed |= it->second != _subpaths.size();
+          _subpaths.push_back(std::move(old));
+          return;
+        }
+      }
+
+      Subpath s;
+      s.start = start;
+      s.cmds.assign(c, c + nc);
+      s.coords.assign(v, v + nv);
+      _subpaths.push_back(std::move(s));
+      changed = true;
+    };
+
+    SGVec2f cur(0, 0),
+            sub(0, 0),
+            start(0, 0);
+    size_t cmd_begin = 0,
+           coord_begin = 0,
+           ci = 0;
+    bool after_close = false;
+
+    size_t i = 0;
+    for(; i < cmds.size(); ++i)
+    {
+      bool rel = cmds[i] & 1;
+      uint8_t cmd = cmds[i] & ~1;
+      uint8_t cmd_index = cmd / 2;
+      if( cmd_index >= numCommands )
+      {
+        SG_LOG(SG_GL, SG_WARN, "Unknown VG command: " << (int)cmd);
+        break;
+      }
+
+      if( ci + coordsPerCommand[cmd_index] > coords.size() )
+      {
+        SG_LOG(SG_GL, SG_WARN, "PathTessellator: missing coordinates");
+        break;
+      }
+
+      // Start a new subpath with every move, and with any other drawing
+      // command directly following a close.
+      if(    (cmd == VG_MOVE_TO || (after_close && cmd != VG_CLOSE_PATH))
+          && i > cmd_begin )
+      {
+        finishSubpath(start, cmd_begin, i, coord_begin, ci);
+        cmd_begin = i;
+        coord_begin = ci;
+      }
+      if( i == cmd_begin )
+        start = cur;
+
+      advance(cmd, rel, coords.data() + ci, cur, sub);
+      after_close = cmd == VG_CLOSE_PATH;
+      ci += coordsPerCommand[cmd_index];
+    }
+    finishSubpath(start, cmd_begin, i, coord_begin, ci);
+
+    if( changed || _subpaths.size() != old_subpaths.size() )
+      invalidate();
+  }
+
+  //----------------------------------------------------------------------------
+  void PathTessellator::setTolerance(float tolerance)
+  {
+    tolerance = std::max(tolerance, 1e-4f);
+    if( tolerance == _tolerance )
+      return;
+
+    _tolerance = tolerance;
+    for(auto& s: _subpaths)
+      s.flattened = s.stroke_valid = false;
+    invalidate();
+  }
+
+  //----------------------------------------------------------------------------
+  const PathTessellator::Mesh& PathTessellator::fill(FillRule rule)
+  {
+    if( _fill_valid && rule == _fill_rule )
+      return _fill;
+
+    _fill_valid = true;
+    _fill_rule = rule;
+    _fill.clear();
+    ++_stats.fills_tessellated;
+
+    // Collect all non-horizontal edges. Every subpath is implicitly closed.
+    std::vector<Edge> edges;
+    for(auto& s: _subpaths)
+    {
+      flatten(s);
+      const auto& pts = s.points;
+      for(size_t i = 0; i < pts.size(); ++i)
+      {
+        const SGVec2f& a = pts[i],
+                       b = pts[(i + 1) % pts.size()];
+        if( a.y() == b.y() )
+          continue;
+        if( a.y() < b.y() )
+          edges.push_back({a.x(), a.y(), b.x(), b.y(), 1});
+        else
+          edges.push_back({b.x(), b.y(), a.x(), a.y(), -1});
+      }
+    }
+
+    if( edges.empty() )
+      return _fill;
+
+    std::sort( edges.begin(), edges.end(),
+               [](const Edge& a, const Edge& b) { return a.y0 < b.y0; } );
+
+    // Split into horizontal bands at every vertex and every edge crossing, so
+    // that the order of the edges does not change within a band.
+    std::vector<float> ys;
+    ys.reserve(edges.size() * 2);
+    for(size_t i = 0; i < edges.size(); ++i)
+    {
+      const Edge& e = edges[i];
+      ys.push_back(e.y0);
+      ys.push_back(e.y1);
+
+      for(size_t j = i + 1; j < edges.size() && edges[j].y0 < e.y1; ++j)
+      {
+        const Edge& f = edges[j];
+        float y_lo = std::max(e.y0, f.y0),
+              y_hi = std::min(e.y1, f.y1);
+        if( y_hi <= y_lo )
+          continue;
+
+        float d_lo = e.xAt(y_lo) - f.xAt(y_lo),
+              d_hi = e.xAt(y_hi) - f.xAt(y_hi);
+        if( (d_lo < 0 && d_hi > 0) || (d_lo > 0 && d_hi < 0) )
+          ys.push_back(y_lo + (y_hi - y_lo) * d_lo / (d_lo - d_hi));
+      }
+    }
+    std::sort(ys.begin(), ys.end());
+    ys.erase(std::unique(ys.begin(), ys.end()), ys.end());
+
+    struct ActiveEdge
+    {
+      float x_top, x_bottom, x_mid;
+      int   dir;
+    };
+    std::vector<const Edge*> active;
+    std::vector<ActiveEdge> band;
+    size_t next_edge = 0;
+
+    for(size_t bi = 0; bi + 1 < ys.size(); ++bi)
+    {
+      float y_top = ys[bi],
+            y_bottom = ys[bi + 1];
+
+      while( next_edge < edges.size() && edges[next_edge].y0 <= y_top )
+        active.push_back(&edges[next_edge++]);
+      active.erase(
+        std::remove_if( active.begin(), active.end(),
+                        [y_top](const Edge* e) { return e->y1 <= y_top; } ),
+        active.end()
+      );
+
+      if( y_bottom - y_top < 1e-6f )
+        continue;
+
+      float y_mid = 0.5f * (y_top + y_bottom);
+      band.clear();
+      for(const Edge* e: active)
+        band.push_back({e->xAt(y_top), e->xAt(y_bottom), e->xAt(y_mid), e->dir});
+      std::sort( band.begin(), band.end(),
+                 [](const ActiveEdge& a, const ActiveEdge& b)
+                 { return a.x_mid < b.x_mid; } );
+
+      int winding = 0;
+      const ActiveEdge* left = nullptr;
+      for(const ActiveEdge& e: band)
+      {
+        bool was_inside = rule == FILL_EVEN_ODD ? (winding & 1) : winding != 0;
+        winding += e.dir;
+        bool inside = rule == FILL_EVEN_ODD ? (winding & 1) : winding != 0;
+
+        if( !was_inside && inside )
+          left = &e;
+        else if( was_inside && !inside && left )
+        {
+          addQuad( _fill,
+                   SGVec2f(left->x_top, y_top),
+                   SGVec2f(e.x_top, y_top),
+                   SGVec2f(e.x_bottom, y_bottom),
+                   SGVec2f(left->x_bottom, y_bottom) );
+          left = nullptr;
+        }
+      }
+    }
+
+    return _fill;
+  }
+
+  //----------------------------------------------------------------------------
+  const PathTessellator::Mesh&
+  PathTessellator::stroke(const StrokeStyle& style)
+  {
+    if( style != _stroke_style )
+    {
+      _stroke_style = style;
+      _stroke_valid = false;
+      for(auto& s: _subpaths)
+        s.stroke_valid = false;
+    }
+
+    if( _stroke_valid )
+      return _stroke;
+
+    _stroke.clear();
+    for(auto& s: _subpaths)
+    {
+      if( !s.stroke_valid )
+      {
+        flatten(s);
+        s.stroke.clear();
+        if( style.width > 0 )
+          strokePolyline(s.points, s.closed, style, s.stroke);
+        s.stroke_valid = true;
+        ++_stats.strokes_tessellated;
+      }
+      _stroke.append(s.stroke);
+    }
+    _stroke_valid = true;
+
+    return _stroke;
+  }
+
+  //----------------------------------------------------------------------------
+  SGRectf PathTessellator::bounds()
+  {
+    SGRectf bb;
+    for(auto& s: _subpaths)
+    {
+      flatten(s);
+      for(const auto& p: s.points)
+        bb.expandBy(p.x(), p.y());
+    }
+    return bb;
+  }
+
+  //----------------------------------------------------------------------------
+  void PathTessellator::flatten(Subpath& s)
+  {
+    if( s.flattened )
+      return;
+
+    s.flattened = true;
+    s.closed = false;
+    s.points.clear();
+    s.points.push_back(s.start);
+    ++_stats.subpaths_flattened;
+
+    SGVec2f cur = s.start,
+            sub = s.start,
+            last_quad_ctrl = s.start,  // for smooth quadratic curves
+            last_cubic_ctrl = s.start; // for smooth cubic curves
+
+    size_t ci = 0;
+    for(uint8_t raw_cmd: s.cmds)
+    {
+      bool rel = raw_cmd & 1;
+      uint8_t cmd = raw_cmd & ~1;
+      const float* c = s.coords.data() + ci;
+      ci += coordsPerCommand[cmd / 2];
+
+      SGVec2f offset = rel ? cur : SGVec2f(0, 0);
+      SGVec2f quad_ctrl = cur,
+              cubic_ctrl = cur;
+
+      switch( cmd )
+      {
+        case VG_CLOSE_PATH:
+          s.closed = true;
+          cur = sub;
+          break;
+        case VG_MOVE_TO:
+          cur = sub = offset + SGVec2f(c[0], c[1]);
+          s.points.back() = cur;
+          quad_ctrl = cubic_ctrl = cur;
+          break;
+        case VG_LINE_TO:
+          cur = offset + SGVec2f(c[0], c[1]);
+          s.points.push_back(cur);
+          break;
+        case VG_HLINE_TO:
+          cur.x() = offset.x() + c[0];
+          s.points.push_back(cur);
+          break;
+        case VG_VLINE_TO:
+          cur.y() = offset.y() + c[0];
+          s.points.push_back(cur);
+          break;
+        case VG_QUAD_TO:
+        case VG_SQUAD_TO:
+        {
+          SGVec2f ctrl;
+          const float* p;
+          if( cmd == VG_QUAD_TO )
+          {
+            ctrl = offset + SGVec2f(c[0], c[1]);
+            p = c + 2;
+          }
+          else
+          {
+            ctrl = 2.f * cur - last_quad_ctrl;
+            p = c;
+          }
+          SGVec2f end = offset + SGVec2f(p[0], p[1]);
+          flattenQuad(s.points, cur, ctrl, end, _tolerance);
+          quad_ctrl = ctrl;
+          cur = end;
+          break;
+        }
+        case VG_CUBIC_TO:
+        case VG_SCUBIC_TO:
+        {
+          SGVec2f ctrl0, ctrl1;
+          const float* p;
+          if( cmd == VG_CUBIC_TO )
+          {
+            ctrl0 = offset + SGVec2f(c[0], c[1]);
+            ctrl1 = offset + SGVec2f(c[2], c[3]);
+            p = c + 4;
+          }
+          else
+          {
+            ctrl0 = 2.f * cur - last_cubic_ctrl;
+            ctrl1 = offset + SGVec2f(c[0], c[1]);
+            p = c + 2;
+          }
+          SGVec2f end = offset + SGVec2f(p[0], p[1]);
+          flattenCubic(s.points, cur, ctrl0, ctrl1, end, _tolerance);
+          cubic_ctrl = ctrl1;
+          cur = end;
+          break;
+        }
+        default: // arcs
+        {
+          SGVec2f end = offset + SGVec2f(c[3], c[4]);
+          flattenArc( s.points, cur, c[0], c[1], c[2], end,
+                      cmd == VG_LCCWARC_TO || cmd == VG_LCWARC_TO,
+                      cmd == VG_SCCWARC_TO || cmd == VG_LCCWARC_TO,
+                      _tolerance );
+          cur = end;
+          break;
+        }
+      }
+
+      if( cmd != VG_QUAD_TO && cmd != VG_SQUAD_TO )
+        quad_ctrl = cur;
+      if( cmd != VG_CUBIC_TO && cmd != VG_SCUBIC_TO )
+        cubic_ctrl = cur;
+      last_quad_ctrl = quad_ctrl;
+      last_cubic_ctrl = cubic_ctrl;
+    }
+
+    // A subpath consisting only of moves draws nothing
+    bool has_drawing = std::any_of( s.cmds.begin(), s.cmds.end(),
+                                    [](uint8_t cmd)
+                                    { return (cmd & ~1) != VG_MOVE_TO; } );
+    if( !has_drawing )
+    {
+      s.points.clear();
+      return;
+    }
+
+    // Remove consecutive duplicates (and a closing point equal to the start).
+    // Only VG_CLOSE_PATH closes a subpath, an open one ending at its start
+    // still gets caps instead of a join.
+    s.points.erase(std::unique(s.points.begin(), s.points.end()), s.points.end());
+    if(    s.closed
+        && s.points.size() > 1
+        && s.points.front() == s.points.back() )
+      s.points.pop_back();
+  }
+
+  //----------------------------------------------------------------------------
+  void PathTessellator::strokePolyline( const std::vector<SGVec2f>& points,
+                                        bool closed,
+                                        const StrokeStyle& style,
+                                        Mesh& mesh ) const
+  {
+    if( points.empty() )
+      return;
+
+    // Split into dashes first, each of which is stroked as an open polyline
+    float dash_total = 0;
+    for(float d: style.dash)
+      dash_total += std::max(d, 0.f);
+
+    if( dash_total > 0 )
+    {
+      std::vector<float> dash = style.dash;
+      if( dash.size() % 2 )
+        // odd number of values -> repeat (like SVG and OpenVG)
+        dash.insert(dash.end(), style.dash.begin(), style.dash.end());
+
+      // Find the dash at the given offset
+      size_t dash_index = 0;
+      float dash_left = 0;
+      float offset = std::fmod(style.dash_offset, dash_total);
+      if( offset < 0 )
+        offset += dash_total;
+      for(;;)
+      {
+        float d = std::max(dash[dash_index], 0.f);
+        if( offset < d )
+        {
+          dash_left = d - offset;
+          break;
+        }
+        offset -= d;
+        dash_index = (dash_index + 1) % dash.size();
+      }
+
+      StrokeStyle solid = style;
+      solid.dash.clear();
+
+      std::vector<SGVec2f> piece;
+      bool on = (dash_index % 2) == 0;
+      if( on )
+        piece.push_back(points.front());
+
+      size_t num_segments = closed ? points.size() : points.size() - 1;
+      for(size_t i = 0; i < num_segments; ++i)
+      {
+        SGVec2f a = points[i];
+        const SGVec2f& b = points[(i + 1) % points.size()];
+        float seg_left = norm(b - a);
+
+        while( seg_left > dash_left )
+        {
+          a += normalize(b - a) * dash_left;
+          seg_left -= dash_left;
+          if( on )
+          {
+            piece.push_back(a);
+            strokePolyline(piece, false, solid, mesh);
+            piece.clear();
+          }
+          else
+            piece.push_back(a);
+
+          on = !on;
+          dash_index = (dash_index + 1) % dash.size();
+          dash_left = std::max(dash[dash_index], 0.f);
+        }
+
+        dash_left -= seg_left;
+        if( on )
+          piece.push_back(b);
+      }
+
+      if( on && piece.size() > 1 )
+        strokePolyline(piece, false, solid, mesh);
+      return;
+    }
+
+    const float hw = 0.5f * style.width;
+
+    if( points.size() == 1 )
+    {
+      // Zero length subpath: only visible with round or square caps
+      const SGVec2f& p = points.front();
+      if( style.cap == CAP_ROUND )
+        addFan(mesh, p, hw, 0, 2 * SGMiscf::pi(), _tolerance);
+      else if( style.cap == CAP_SQUARE )
+        addQuad( mesh,
+                 p + SGVec2f(-hw, -hw), p + SGVec2f(hw, -hw),
+                 p + SGVec2f(hw, hw), p + SGVec2f(-hw, hw) );
+      return;
+    }
+
+    const size_t n = points.size();
+    const size_t num_segments = closed ? n : n - 1;
+
+    // Segments
+    for(size_t i = 0; i < num_segments; ++i)
+    {
+      const SGVec2f& a = points[i],
+                     b = points[(i + 1) % n];
+      SGVec2f off = hw * perp(normalize(b - a));
+      addQuad(mesh, a + off, b + off, b - off, a - off);
+    }
+
+    // Joins
+    auto join = [&](const SGVec2f& prev, const SGVec2f& p, const SGVec2f& next)
+    {
+      SGVec2f d0 = normalize(p - prev),
+              d1 = normalize(next - p);
+      float turn = cross(d0, d1);
+      if( std::fabs(turn) < 1e-6f && dot(d0, d1) > 0 )
+        return; // collinear
+
+      // Join on the outer side of the turn
+      float side = turn > 0 ? -1.f : 1.f;
+      SGVec2f n0 = side * perp(d0),
+              n1 = side * perp(d1),
+              o0 = p + hw * n0,
+              o1 = p + hw * n1;
+
+      if( style.join == JOIN_ROUND )
+      {
+        float a0 = std::atan2(n0.y(), n0.x()),
+              a1 = std::atan2(n1.y(), n1.x()),
+              da = a1 - a0;
+        if( da > SGMiscf::pi() )
+          da -= 2 * SGMiscf::pi();
+        else if( da < -SGMiscf::pi() )
+          da += 2 * SGMiscf::pi();
+        addFan(mesh, p, hw, a0, a0 + da, _tolerance);
+        return;
+      }
+
+      addTriangle(mesh, p, o0, o1);
+
+      if( style.join == JOIN_MITER )
+      {
+        SGVec2f bisector = normalize(n0 + n1);
+        float cos_half = dot(bisector, n0);
+        if( cos_half > 1e-6f && 1 / cos_half <= style.miter_limit )
+        {
+          SGVec2f tip = p + bisector * (hw / cos_half);
+          addTriangle(mesh, o0, tip, o1);
+        }
+      }
+    };
+
+    for(size_t i = 1; i + 1 < n; ++i)
+      join(points[i - 1], points[i], points[i + 1]);
+
+    if( closed )
+    {
+      join(points[n - 2], points[n - 1], points[0]);
+      join(points[n - 1], points[0], points[1]);
+      return;
+    }
+
+    // Caps
+    auto cap = [&](const SGVec2f& p, const SGVec2f& dir)
+    {
+      SGVec2f off = hw * perp(dir);
+      if( style.cap == CAP_SQUARE )
+      {
+        SGVec2f ext = hw * dir;
+        addQuad(mesh, p + off, p + off + ext, p - off + ext, p - off);
+      }
+      else if( style.cap == CAP_ROUND )
+      {
+        float a = std::atan2(off.y(), off.x());
+        addFan(mesh, p, hw, a, a - SGMiscf::pi(), _tolerance);
+      }
+    };
+
+    cap(points.front(), normalize(points[0] - points[1]));
+    cap(points.back(), normalize(points[n - 1] - points[n - 2]));
+  }
+
+  //----------------------------------------------------------------------------
+  void PathTessellator::invalidate()
+  {
+    _fill_valid = false;
+    _stroke_valid = false;
+  }
+
+} // namespace simgear::canvas
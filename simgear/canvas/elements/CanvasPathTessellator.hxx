@@ -0,0 +1,175 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief CPU tessellation of OpenVG paths into triangle meshes
+ */
+
+#pragma once
+
+#include <simgear/math/SGMath.hxx>
+#include <simgear/math/SGRect.hxx>
+
+#include <cstdint>
+#include <vector>
+
+namespace simgear::canvas
+{
+
+  /**
+   * Convert OpenVG path data (commands and coordinates as used by
+   * canvas::Path) to triangle meshes without requiring an OpenVG/OpenGL
+   * context.
+   *
+   * The path is split into subpaths, each of which is flattened and stroked
+   * independently. Flattened points and stroke meshes are cached per subpath,
+   * so replacing the segments only re-tessellates subpaths which actually
+   * changed. The fill mesh depends on all subpaths (due to the fill rule) and
+   * is rebuilt whenever any subpath changes.
+   */
+  class PathTessellator
+  {
+    public:
+      enum FillRule
+      {
+        FILL_NON_ZERO,
+        FILL_EVEN_ODD
+      };
+
+      enum CapStyle
+      {
+        CAP_BUTT,
+        CAP_ROUND,
+        CAP_SQUARE
+      };
+
+      enum JoinStyle
+      {
+        JOIN_MITER,
+        JOIN_ROUND,
+        JOIN_BEVEL
+      };
+
+      /**
+       * Indexed triangle list
+       */
+      struct Mesh
+      {
+        std::vector<SGVec2f>  vertices;
+        std::vector<uint32_t> indices;
+
+        void clear();
+        bool empty() const { return indices.empty(); }
+        size_t numTriangles() const { return indices.size() / 3; }
+
+        /** Append all triangles of @a other */
+        void append(const Mesh& other);
+
+        /** Sum of the (unsigned) area of all triangles */
+        double area() const;
+      };
+
+      struct StrokeStyle
+      {
+        float               width {1};
+        CapStyle            cap {CAP_BUTT};
+        JoinStyle           join {JOIN_MITER};
+        float               miter_limit {4};
+        std::vector<float>  dash;
+        float               dash_offset {0};
+
+        bool operator==(const StrokeStyle& rhs) const;
+        bool operator!=(const StrokeStyle& rhs) const
+        { return !(*this == rhs); }
+      };
+
+      /**
+       * Number of subpaths flattened/tessellated since construction, useful
+       * to check the effectiveness of the caching.
+       */
+      struct Stats
+      {
+        size_t subpaths_flattened {0};
+        size_t strokes_tessellated {0};
+        size_t fills_tessellated {0};
+      };
+
+      /**
+       * Replace the current path segments with the new ones. Subpaths with
+       * unchanged data keep their cached geometry.
+       *
+       * @param cmds    List of OpenVG path commands
+       * @param coords  List of coordinates/parameters used by #cmds
+       */
+      void setSegments( const std::vector<uint8_t>& cmds,
+                        const std::vector<float>& coords );
+
+      /**
+       * Set the maximum distance between curves/arcs and their flattened
+       * approximation (Default 0.25 units).
+       */
+      void setTolerance(float tolerance);
+      float getTolerance() const { return _tolerance; }
+
+      /**
+       * Get the fill mesh for the given fill rule. The mesh consists of
+       * non-overlapping triangles.
+       */
+      const Mesh& fill(FillRule rule);
+
+      /**
+       * Get the stroke mesh for the given style. Triangles of joins and caps
+       * may overlap the segment triangles, so the covered area has to be
+       * drawn once (as PathRasterizer does) rather than every triangle.
+       */
+      const Mesh& stroke(const StrokeStyle& style);
+
+      /**
+       * Bounding box of the flattened path (not including stroke width).
+       * Invalid (width/height < 0) for an empty path.
+       */
+      SGRectf bounds();
+
+      size_t numSubpaths() const { return _subpaths.size(); }
+      const Stats& stats() const { return _stats; }
+
+    private:
+      struct Subpath
+      {
+        // Input data, used to detect changes
+        SGVec2f               start;
+        std::vector<uint8_t>  cmds;
+        std::vector<float>    coords;
+
+        // Flattened geometry
+        bool                  flattened {false};
+        std::vector<SGVec2f>  points;
+        bool                  closed {false};
+
+        // Cached stroke geometry
+        bool                  stroke_valid {false};
+        Mesh                  stroke;
+      };
+
+      std::vector<Subpath>  _subpaths;
+      float                 _tolerance {0.25f};
+
+      bool                  _fill_valid {false};
+      FillRule              _fill_rule {FILL_EVEN_ODD};
+      Mesh                  _fill;
+
+      bool                  _stroke_valid {false};
+      StrokeStyle           _stroke_style;
+      Mesh                  _stroke;
+
+      Stats                 _stats;
+
+      void flatten(Subpath& subpath);
+      void strokePolyline( const std::vector<SGVec2f>& points,
+                           bool closed,
+                           const StrokeStyle& style,
+                           Mesh& mesh ) const;
+      void invalidate();
+  };
+
+} // namespace simgear::canvas
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Benchmark per-symbol vs. batched map projections
+ */
+
+#include <simgear_config.h>
+
+#include "map/projection.hxx"
+
+#include <simgear/misc/test_timing.hxx>
+
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace sc = simgear::canvas;
+
+static const size_t num_symbols = 50000;
+static const int num_frames = 100;
+
+template<class T>
+static void bench(const char* name)
+{
+  std::unique_ptr<sc::HorizontalProjection> proj(new T);
+  proj->setRange(80);
+  proj->setScreenRange(512);
+
+  // Symbols scattered around the reference point
+  std::vector<double> lat(num_symbols), lon(num_symbols),
+                      x(num_symbols), y(num_symbols);
+  for(size_t i = 0; i < num_symbols; ++i)
+  {
+    lat[i] = 46 + (i % 223) * 0.015;
+    lon[i] = 10 + (i / 223) * 0.02;
+  }
+
+  double sum = 0;
+
+  double single = timeRun([&] {
+    for(int f = 0; f < num_frames; ++f)
+    {
+      proj->setWorldPosition(47.5 + f * 1e-3, 11.2 + f * 1e-3);
+      proj->setOrientation(f * 0.5f);
+      for(size_t i = 0; i < num_symbols; ++i)
+      {
+        sc::Projection::ScreenPosition pos = proj->worldToScreen(lat[i], lon[i]);
+        x[i] = pos.x;
+        y[i] = pos.y;
+      }
+      sum += x[f];
+    }
+  }).toUSecs() / num_frames;
+
+  double batched = timeRun([&] {
+    for(int f = 0; f < num_frames; ++f)
+    {
+      proj->setWorldPosition(47.5 + f * 1e-3, 11.2 + f * 1e-3);
+      proj->setOrientation(f * 0.5f);
+      proj->worldToScreen(num_symbols, lat.data(), lon.data(), x.data(), y.data());
+      sum += x[f];
+    }
+  }).toUSecs() / num_frames;
+
+  std::cout << name << ": "
+            << "single " << single << " us/frame, "
+            << "batched " << batched << " us/frame"
+            << " (" << sum << ")" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  std::cout << num_symbols << " symbols, moving reference point" << std::endl;
+  bench<sc::AzimuthalEquidistantProjection>("azimuthal equidistant");
+  bench<sc::WebMercatorProjection>("web mercator");
+  bench<sc::SansonFlamsteedProjection>("sanson flamsteed");
+  return 0;
+}
@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/// Unit tests for the canvas::Map projections
+#define BOOST_TEST_MODULE canvas_map
+#include <BoostTestTargetConfig.h>
+
+#include "map/projection.hxx"
+
+#include <memory>
+#include <vector>
+
+namespace sc = simgear::canvas;
+
+static void checkBatch(sc::HorizontalProjection& proj)
+{
+  // Positions around the reference point (web mercator is only defined for
+  // latitudes less than 90 degrees from the reference point)
+  std::vector<double> lat, lon;
+  for(int i = 0; i < 100; ++i)
+  {
+    lat.push_back(10 + 0.7 * i);
+    lon.push_back(-50 + 1.2 * i);
+  }
+  // Reference point itself
+  lat.push_back(47.5);
+  lon.push_back(11.2);
+
+  std::vector<double> x(lat.size()), y(lat.size());
+  proj.worldToScreen(lat.size(), lat.data(), lon.data(), x.data(), y.data());
+
+  for(size_t i = 0; i < lat.size(); ++i)
+  {
+    sc::Projection::ScreenPosition pos = proj.worldToScreen(lat[i], lon[i]);
+    BOOST_CHECK_SMALL(x[i] - pos.x, 1e-6 * std::max(1.0, std::abs(pos.x)));
+    BOOST_CHECK_SMALL(y[i] - pos.y, 1e-6 * std::max(1.0, std::abs(pos.y)));
+  }
+
+  // In place
+  proj.worldToScreen(lat.size(), lat.data(), lon.data(), lat.data(), lon.data());
+  BOOST_CHECK_EQUAL(lat[10], x[10]);
+  BOOST_CHECK_EQUAL(lon[10], y[10]);
+}
+
+BOOST_AUTO_TEST_CASE( batch_projection )
+{
+  std::vector<std::shared_ptr<sc::HorizontalProjection>> projections = {
+    std::make_shared<sc::AzimuthalEquidistantProjection>(),
+    std::make_shared<sc::SansonFlamsteedProjection>(),
+    std::make_shared<sc::WebMercatorProjection>()
+  };
+
+  for(auto& proj: projections)
+  {
+    proj->setWorldPosition(47.5, 11.2);
+    proj->setOrientation(35);
+    proj->setRange(40);
+    proj->setScreenRange(256);
+    checkBatch(*proj);
+
+  }
+
+  // Poles are handled separately by the azimuthal equidistant projection
+  projections[0]->setWorldPosition(90, 0);
+  checkBatch(*projections[0]);
+}
+
+BOOST_AUTO_TEST_CASE( azimuthal_equidistant )
+{
+  sc::AzimuthalEquidistantProjection proj;
+  proj.setWorldPosition(0, 0);
+  proj.setRange(60);
+  proj.setScreenRange(60);
+
+  // One degree along the equator is (about) 60nm
+  double lat[] = {0, 1, 0},
+         lon[] = {0, 0, 1},
+         x[3], y[3];
+  proj.worldToScreen(3, lat, lon, x, y);
+
+  BOOST_CHECK_SMALL(x[0], 1e-9);
+  BOOST_CHECK_SMALL(y[0], 1e-9);
+  BOOST_CHECK_SMALL(x[1], 1e-9);
+  BOOST_CHECK_CLOSE(y[1], -60, 0.5);
+  BOOST_CHECK_CLOSE(x[2], 60, 0.5);
+  BOOST_CHECK_SMALL(y[2], 1e-9);
+}
@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Benchmark CPU tessellation and software rasterization of paths
+ */
+
+#include <simgear_config.h>
+
+#include "CanvasPathRasterizer.hxx"
+#include "CanvasPathTessellator.hxx"
+
+#include <simgear/misc/test_timing.hxx>
+
+#include <vg/openvg.h>
+
+#include <iostream>
+
+namespace sc = simgear::canvas;
+
+static const int num_subpaths = 2000;
+static const int num_frames = 100;
+
+/**
+ * Create a path resembling a typical moving map/MFD symbol layer: many small
+ * subpaths consisting of lines, curves and arcs.
+ */
+static void createPath( std::vector<uint8_t>& cmds,
+                        std::vector<float>& coords,
+                        float offset )
+{
+  cmds.clear();
+  coords.clear();
+
+  for(int i = 0; i < num_subpaths; ++i)
+  {
+    float x = (i % 50) * 20 + 10,
+          y = (i / 50) * 20 + 10 + (i == 0 ? offset : 0);
+
+    cmds.insert(cmds.end(), { VG_MOVE_TO_ABS, VG_LINE_TO_REL,
+                              VG_QUAD_TO_REL, VG_SCCWARC_TO_REL,
+                              VG_CUBIC_TO_REL, VG_CLOSE_PATH });
+    coords.insert(coords.end(), { x, y,
+                                  8, 0,
+                                  4, 4, 0, 8,
+                                  4, 4, 0, -4, 4,
+                                  -2, 2, -6, -2, -8, -8 });
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  std::vector<uint8_t> cmds;
+  std::vector<float> coords;
+  createPath(cmds, coords, 0);
+
+  sc::PathTessellator::StrokeStyle style;
+  style.width = 1.5;
+  style.join = sc::PathTessellator::JOIN_ROUND;
+
+  // Full tessellation of the path
+  double full = timeRun([&] {
+    for(int i = 0; i < num_frames; ++i)
+    {
+      sc::PathTessellator tess;
+      tess.setSegments(cmds, coords);
+      tess.fill(sc::PathTessellator::FILL_NON_ZERO);
+      tess.stroke(style);
+    }
+  }).toUSecs() / num_frames;
+
+  // Moving a single subpath each frame
+  sc::PathTessellator tess;
+  tess.setSegments(cmds, coords);
+  tess.stroke(style);
+
+  double incremental = timeRun([&] {
+    for(int i = 0; i < num_frames; ++i)
+    {
+      createPath(cmds, coords, (i % 2) ? 1 : 0);
+      tess.setSegments(cmds, coords);
+      tess.stroke(style);
+    }
+  }).toUSecs() / num_frames;
+
+  // Rasterize fill and stroke
+  const auto& fill = tess.fill(sc::PathTessellator::FILL_NON_ZERO);
+  const auto& stroke = tess.stroke(style);
+  sc::PathRasterizer raster(1024, 1024);
+
+  double raster_time = timeRun([&] {
+    for(int i = 0; i < num_frames; ++i)
+    {
+      raster.clear();
+      raster.draw(fill, SGVec4f(0.2, 0.2, 0.2, 1));
+      raster.draw(stroke, SGVec4f(0, 1, 0, 0.8));
+    }
+  }).toUSecs() / num_frames;
+
+  std::cout << num_subpaths << " subpaths, "
+            << fill.numTriangles() << " fill triangles, "
+            << stroke.numTriangles() << " stroke triangles\n"
+            << "full tessellation:        " << full << " us/frame\n"
+            << "incremental (stroke):     " << incremental << " us/frame\n"
+            << "rasterization (1024^2):   " << raster_time << " us/frame"
+            << std::endl;
+
+  return 0;
+}
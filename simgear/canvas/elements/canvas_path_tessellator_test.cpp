@@ -0,0 +1,221 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/// Unit tests for canvas::PathTessellator and canvas::PathRasterizer
+#define BOOST_TEST_MODULE canvas_path
+#include <BoostTestTargetConfig.h>
+
+#include "CanvasPathRasterizer.hxx"
+#include "CanvasPathTessellator.hxx"
+
+#include <vg/openvg.h>
+
+namespace sc = simgear::canvas;
+
+using CmdList = std::vector<uint8_t>;
+using CoordList = std::vector<float>;
+
+static void addRect( CmdList& cmds, CoordList& coords,
+                     float x, float y, float w, float h )
+{
+  cmds.insert(cmds.end(), { VG_MOVE_TO_ABS, VG_HLINE_TO_REL,
+                            VG_VLINE_TO_REL, VG_HLINE_TO_REL,
+                            VG_CLOSE_PATH });
+  coords.insert(coords.end(), {x, y, w, h, -w});
+}
+
+BOOST_AUTO_TEST_CASE( fill_rules )
+{
+  CmdList cmds;
+  CoordList coords;
+
+  // Two overlapping squares with the same orientation (overlap 5x5)
+  addRect(cmds, coords, 0, 0, 10, 10);
+  addRect(cmds, coords, 5, 5, 10, 10);
+
+  sc::PathTessellator tess;
+  tess.setSegments(cmds, coords);
+  BOOST_CHECK_EQUAL(tess.numSubpaths(), 2);
+
+  BOOST_CHECK_CLOSE(tess.fill(sc::PathTessellator::FILL_NON_ZERO).area(), 175, 1e-3);
+  BOOST_CHECK_CLOSE(tess.fill(sc::PathTessellator::FILL_EVEN_ODD).area(), 150, 1e-3);
+
+  SGRectf bb = tess.bounds();
+  BOOST_CHECK_EQUAL(bb.l(), 0);
+  BOOST_CHECK_EQUAL(bb.t(), 0);
+  BOOST_CHECK_EQUAL(bb.r(), 15);
+  BOOST_CHECK_EQUAL(bb.b(), 15);
+}
+
+BOOST_AUTO_TEST_CASE( fill_self_intersecting )
+{
+  // Bow tie: two triangles meeting at (5, 5)
+  CmdList cmds = { VG_MOVE_TO_ABS, VG_LINE_TO_ABS, VG_LINE_TO_ABS,
+                   VG_LINE_TO_ABS, VG_CLOSE_PATH };
+  CoordList coords = {0, 0, 10, 10, 10, 0, 0, 10};
+
+  sc::PathTessellator tess;
+  tess.setSegments(cmds, coords);
+  BOOST_CHECK_CLOSE(tess.fill(sc::PathTessellator::FILL_NON_ZERO).area(), 50, 1e-3);
+  BOOST_CHECK_CLOSE(tess.fill(sc::PathTessellator::FILL_EVEN_ODD).area(), 50, 1e-3);
+}
+
+BOOST_AUTO_TEST_CASE( fill_curves )
+{
+  // Circle made of two arcs
+  CmdList cmds = { VG_MOVE_TO_ABS, VG_SCCWARC_TO_ABS, VG_SCCWARC_TO_ABS,
+                   VG_CLOSE_PATH };
+  CoordList coords = { -10, 0,
+                       10, 10, 0, 10, 0,
+                       10, 10, 0, -10, 0 };
+
+  sc::PathTessellator tess;
+  tess.setTolerance(0.01f);
+  tess.setSegments(cmds, coords);
+  BOOST_CHECK_CLOSE(tess.fill(sc::PathTessellator::FILL_NON_ZERO).area(),
+                    SGMiscd::pi() * 100, 0.5);
+
+  SGRectf bb = tess.bounds();
+  BOOST_CHECK_CLOSE(bb.width(), 20, 0.1);
+  BOOST_CHECK_CLOSE(bb.height(), 20, 0.1);
+}
+
+BOOST_AUTO_TEST_CASE( stroke_styles )
+{
+  // Single horizontal line of length 10
+  CmdList cmds = { VG_MOVE_TO_ABS, VG_HLINE_TO_REL };
+  CoordList coords = {0, 0, 10};
+
+  sc::PathTessellator tess;
+  tess.setTolerance(0.01f);
+  tess.setSegments(cmds, coords);
+
+  sc::PathTessellator::StrokeStyle style;
+  style.width = 2;
+  BOOST_CHECK_CLOSE(tess.stroke(style).area(), 20, 1e-3);
+
+  style.cap = sc::PathTessellator::CAP_SQUARE;
+  BOOST_CHECK_CLOSE(tess.stroke(style).area(), 24, 1e-3);
+
+  style.cap = sc::PathTessellator::CAP_ROUND;
+  BOOST_CHECK_CLOSE(tess.stroke(style).area(), 20 + SGMiscd::pi(), 0.5);
+
+  // 4 dashes of length 1
+  style.cap = sc::PathTessellator::CAP_BUTT;
+  style.dash = {1, 2};
+  BOOST_CHECK_CLOSE(tess.stroke(style).area(), 8, 1e-3);
+}
+
+BOOST_AUTO_TEST_CASE( subpath_caching )
+{
+  CmdList cmds;
+  CoordList coords;
+  addRect(cmds, coords, 0, 0, 10, 10);
+  addRect(cmds, coords, 20, 0, 10, 10);
+  addRect(cmds, coords, 40, 0, 10, 10);
+
+  sc::PathTessellator tess;
+  sc::PathTessellator::StrokeStyle style;
+
+  tess.setSegments(cmds, coords);
+  tess.stroke(style);
+  BOOST_CHECK_EQUAL(tess.stats().subpaths_flattened, 3);
+  BOOST_CHECK_EQUAL(tess.stats().strokes_tessellated, 3);
+
+  // Only modify the last rectangle
+  coords.back() = -5;
+  coords[coords.size() - 3] = 5;
+  tess.setSegments(cmds, coords);
+  tess.stroke(style);
+  BOOST_CHECK_EQUAL(tess.stats().subpaths_flattened, 4);
+  BOOST_CHECK_EQUAL(tess.stats().strokes_tessellated, 4);
+
+  // Unchanged segments do not trigger any work
+  tess.setSegments(cmds, coords);
+  tess.stroke(style);
+  tess.fill(sc::PathTessellator::FILL_EVEN_ODD);
+  tess.fill(sc::PathTessellator::FILL_EVEN_ODD);
+  BOOST_CHECK_EQUAL(tess.stats().subpaths_flattened, 4);
+  BOOST_CHECK_EQUAL(tess.stats().strokes_tessellated, 4);
+  BOOST_CHECK_EQUAL(tess.stats().fills_tessellated, 1);
+}
+
+BOOST_AUTO_TEST_CASE( rasterize )
+{
+  CmdList cmds;
+  CoordList coords;
+  addRect(cmds, coords, 2, 2, 4, 4);
+  addRect(cmds, coords, 4, 4, 4, 4);
+
+  sc::PathTessellator tess;
+  tess.setSegments(cmds, coords);
+
+  sc::PathRasterizer raster(10, 10);
+  raster.clear(SGVec4f(0, 0, 0, 1));
+
+  // Shared edges between triangles must not cause pixels to be drawn twice
+  size_t num_pixels = raster.draw( tess.fill(sc::PathTessellator::FILL_EVEN_ODD),
+                                   SGVec4f(1, 0, 0, 1) );
+  BOOST_CHECK_EQUAL(num_pixels, 16 + 16 - 2 * 4);
+
+  BOOST_CHECK_EQUAL(raster.getPixel(2, 2), SGVec4f(1, 0, 0, 1));
+  BOOST_CHECK_EQUAL(raster.getPixel(4, 4), SGVec4f(0, 0, 0, 1));
+  BOOST_CHECK_EQUAL(raster.getPixel(7, 7), SGVec4f(1, 0, 0, 1));
+  BOOST_CHECK_EQUAL(raster.getPixel(8, 8), SGVec4f(0, 0, 0, 1));
+
+  // Blending
+  raster.clear(SGVec4f(0, 0, 0, 1));
+  raster.draw( tess.fill(sc::PathTessellator::FILL_NON_ZERO),
+               SGVec4f(1, 1, 1, 0.5) );
+  BOOST_CHECK_CLOSE(raster.getPixel(4, 4)[0], 0.5, 1);
+  BOOST_CHECK_EQUAL(raster.getPixel(4, 4)[3], 1);
+
+  // Transform (scale by 0.5)
+  raster.clear();
+  raster.setTransform({0.5, 0, 0, 0.5, 0, 0});
+  num_pixels = raster.draw( tess.fill(sc::PathTessellator::FILL_NON_ZERO),
+                            SGVec4f(1, 1, 1, 1) );
+  BOOST_CHECK_EQUAL(num_pixels, 7);
+}
+
+BOOST_AUTO_TEST_CASE( rasterize_translucent_stroke )
+{
+  // Polyline with a right angle at (10, 10), and a path ending at its start
+  // without being closed
+  CmdList cmds = { VG_MOVE_TO_ABS, VG_LINE_TO_ABS, VG_LINE_TO_ABS };
+  CoordList coords = {2, 10, 10, 10, 10, 18};
+
+  sc::PathTessellator tess;
+  tess.setSegments(cmds, coords);
+
+  sc::PathTessellator::StrokeStyle style;
+  style.width = 4;
+  style.cap = sc::PathTessellator::CAP_SQUARE;
+  style.join = sc::PathTessellator::JOIN_ROUND;
+
+  sc::PathRasterizer raster(20, 20);
+  raster.clear(SGVec4f(0, 0, 0, 1));
+  raster.draw(tess.stroke(style), SGVec4f(1, 1, 1, 0.5));
+
+  // The segments overlap on the inner side of the turn, but every pixel is
+  // blended once
+  const float segment = raster.getPixel(5, 10)[0];
+  BOOST_CHECK_CLOSE(segment, 0.5, 1);
+  BOOST_CHECK_EQUAL(raster.getPixel(9, 11)[0], segment);
+  BOOST_CHECK_EQUAL(raster.getPixel(11, 9)[0], segment);
+  BOOST_CHECK_EQUAL(raster.getPixel(1, 10)[0], segment);
+  BOOST_CHECK_EQUAL(raster.getPixel(10, 5)[0], 0);
+
+  // Only VG_CLOSE_PATH closes a subpath: the open square has butt caps and
+  // no corner at its start, the closed one gets a mitered corner there.
+  cmds = { VG_MOVE_TO_ABS, VG_HLINE_TO_ABS, VG_VLINE_TO_ABS,
+           VG_HLINE_TO_ABS, VG_VLINE_TO_ABS };
+  coords = {4, 4, 16, 16, 4, 4};
+  tess.setSegments(cmds, coords);
+  style.join = sc::PathTessellator::JOIN_MITER;
+  style.cap = sc::PathTessellator::CAP_BUTT;
+  BOOST_CHECK_CLOSE(tess.stroke(style).area(), 4 * 12 * 4 + 3 * 4, 1e-3);
+
+  cmds.push_back(VG_CLOSE_PATH);
+  tess.setSegments(cmds, coords);
+  BOOST_CHECK_CLOSE(tess.stroke(style).area(), 4 * 12 * 4 + 4 * 4, 1e-3);
+}
@@ -76,6 +76,16 @@ namespace simgear::canvas
         }
       }
 
+      SGPropertyNode* getNodeLat() const
+      {
+        return _node_lat;
+      }
+
+      SGPropertyNode* getNodeLon() const
+      {
+        return _node_lon;
+      }
+
       std::string getLat() const
       {
         return _node_lat ? _node_lat->getStringValue() : "";
@@ -89,7 +99,7 @@ namespace simgear::canvas
       void setCachedLatLon(const std::pair<double, double>& latLon)
       { _cachedLatLon = latLon; }
       
-      std::pair<double, double> getCachedLatLon()
+      std::pair<double, double> getCachedLatLon() const
       { return _cachedLatLon; }
       
       void setTargetName(const std::string& name)
@@ -8,7 +8,9 @@
 
 #pragma once
 
-#include <simgear/math/SGMisc.hxx>
+#include <simgear/math/SGMath.hxx>
+
+#include <cstddef>
 
 namespace simgear::canvas
 {
@@ -43,6 +45,31 @@ namespace simgear::canvas
 
       virtual ScreenPosition worldToScreen(double x, double y) = 0;
 
+      /**
+       * Transform multiple world positions at once. Input and output are
+       * stored as separate arrays (structure of arrays) to allow the
+       * projection loops to be vectorized.
+       *
+       * @param count Number of positions
+       * @param x     Input x coordinates
+       * @param y     Input y coordinates
+       * @param out_x Output x coordinates (may alias @a x)
+       * @param out_y Output y coordinates (may alias @a y)
+       */
+      virtual void worldToScreen( size_t count,
+                                  const double* x,
+                                  const double* y,
+                                  double* out_x,
+                                  double* out_y )
+      {
+        for(size_t i = 0; i < count; ++i)
+        {
+          ScreenPosition pos = worldToScreen(x[i], y[i]);
+          out_x[i] = pos.x;
+          out_y[i] = pos.y;
+        }
+      }
+
     protected:
 
       double _screen_range;
@@ -122,6 +149,35 @@ namespace simgear::canvas
         );
       }
 
+      /**
+       * Transform multiple world positions to screen positions
+       *
+       * @param count Number of positions
+       * @param lat   Latitudes in degrees
+       * @param lon   Longitudes in degrees
+       * @param out_x Screen x coordinates (may alias @a lat)
+       * @param out_y Screen y coordinates (may alias @a lon)
+       */
+      void worldToScreen( size_t count,
+                          const double* lat,
+                          const double* lon,
+                          double* out_x,
+                          double* out_y ) override
+      {
+        project(count, lat, lon, out_x, out_y);
+
+        const double scale = _screen_range / _range,
+                     cos_angle = _cos_angle * scale,
+                     sin_angle = _sin_angle * scale;
+        for(size_t i = 0; i < count; ++i)
+        {
+          const double x = out_x[i],
+                       y = out_y[i];
+          out_x[i] =  cos_angle * x - sin_angle * y;
+          out_y[i] = -sin_angle * x - cos_angle * y;
+        }
+      }
+
     protected:
 
       /**
@@ -132,6 +188,32 @@ namespace simgear::canvas
        */
       virtual ScreenPosition project(double lat, double lon) const = 0;
 
+      /**
+       * Project multiple geographic world positions to (unscaled) screen
+       * space. The default implementation projects each position on its own,
+       * projections should override it with a loop free of virtual calls.
+       *
+       * @param count Number of positions
+       * @param lat   Latitudes in degrees
+       * @param lon   Longitudes in degrees
+       * @param out_x Projected x coordinates (may alias @a lat)
+       * @param out_y Projected y coordinates (may alias @a lon)
+       */
+      virtual void project( size_t count,
+                            const double* lat,
+                            const double* lon,
+                            double* out_x,
+                            double* out_y ) const
+      {
+        for(size_t i = 0; i < count; ++i)
+        {
+          ScreenPosition pos = project( SGMiscd::deg2rad(lat[i]),
+                                        SGMiscd::deg2rad(lon[i]) );
+          out_x[i] = pos.x;
+          out_y[i] = pos.y;
+        }
+      }
+
       double  _ref_lat,   ///<! Reference latitude (radian)
               _ref_lon,   ///<! Reference latitude (radian)
               _angle,     ///<! Map rotation angle (degree)
@@ -192,6 +274,38 @@ namespace simgear::canvas
 
         return ScreenPosition(r * x, r * y);
       }
+
+      void project( size_t count,
+                    const double* lat_deg,
+                    const double* lon_deg,
+                    double* out_x,
+                    double* out_y ) const override
+      {
+        // The special cases only depend on the reference point, so keep
+        // them out of the loop.
+        if(    _ref_lat == (90 * SG_DEGREES_TO_RADIANS)
+            || _ref_lat == -(90 * SG_DEGREES_TO_RADIANS) )
+          return HorizontalProjection::project( count, lat_deg, lon_deg,
+                                                out_x, out_y );
+
+        const double sin_ref_lat = sin(_ref_lat),
+                     cos_ref_lat = cos(_ref_lat);
+        for(size_t i = 0; i < count; ++i)
+        {
+          const double lat = SGMiscd::deg2rad(lat_deg[i]),
+                       d_lon = SGMiscd::deg2rad(lon_deg[i]) - _ref_lon;
+          const double sin_lat = sin(lat),
+                       cos_lat = cos(lat),
+                       cos_d_lon = cos(d_lon);
+          const double r = getEarthRadius(lat);
+          const double c = acos(sin_ref_lat * sin_lat + cos_ref_lat * cos_lat * cos_d_lon);
+
+          // c == 0: angular distance from center is 0
+          const double k = c != 0.0 ? r * c / sin(c) : 0.0;
+          out_x[i] = k * cos_lat * sin(d_lon);
+          out_y[i] = k * (cos_ref_lat * sin_lat - sin_ref_lat * cos_lat * cos_d_lon);
+        }
+      }
   };
 
   /**
@@ -215,6 +329,22 @@ namespace simgear::canvas
 
         return pos;
       }
+
+      void project( size_t count,
+                    const double* lat_deg,
+                    const double* lon_deg,
+                    double* out_x,
+                    double* out_y ) const override
+      {
+        for(size_t i = 0; i < count; ++i)
+        {
+          const double lat = SGMiscd::deg2rad(lat_deg[i]),
+                       d_lon = SGMiscd::deg2rad(lon_deg[i]) - _ref_lon;
+          const double r = getEarthRadius(lat);
+          out_x[i] = r * cos(lat) * d_lon;
+          out_y[i] = r * (lat - _ref_lat);
+        }
+      }
   };
 
   /**
@@ -240,6 +370,22 @@ namespace simgear::canvas
         //pos.y = log(tan(lat) + 1.0 / cos(lat));
         return pos;
       }
+
+      void project( size_t count,
+                    const double* lat,
+                    const double* lon,
+                    double* out_x,
+                    double* out_y ) const override
+      {
+        const double r = 6378137.f / 1852;
+        for(size_t i = 0; i < count; ++i)
+        {
+          const double d_lat = SGMiscd::deg2rad(lat[i]) - _ref_lat,
+                       d_lon = SGMiscd::deg2rad(lon[i]) - _ref_lon;
+          out_x[i] = r * d_lon;
+          out_y[i] = r * (log(tan(d_lat) + 1.0 / cos(d_lat)));
+        }
+      }
   };
 
 
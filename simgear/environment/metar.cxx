@@ -20,6 +20,8 @@
 #  include <simgear_config.h>
 #endif
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <iomanip>
 #include <string>
@@ -29,8 +31,8 @@
 #include <sstream>
 
 #include <simgear/debug/logstream.hxx>
-#include <simgear/math/sg_random.hxx>
 #include <simgear/structure/exception.hxx>
+#include <simgear/threads/SGJobPool.hxx>
 
 #include "metar.hxx"
 
@@ -79,54 +81,85 @@ SGMetar::SGMetar(const string& m) :
 	_snow(false),
 	_cavok(false)
 {
-    _data.resize(m.length() + 2); // make room for " \0"
-    strcpy(_data.data(), m.c_str());
-    _url = m;
-
-    normalizeData();
-
-    _m = _data.data();
-    _icao[0] = '\0';
-
-	// NOAA preample
-	if (!scanPreambleDate())
-		useCurrentDate();
-	scanPreambleTime();
-
-	// METAR header
-	scanType();
-	if (!scanId() || !scanDate()) {
-		throw sg_io_exception("metar data bogus ", sg_location(_url));
-	}
-	while (scanModifier()) ;
-
-	// base set
-	scanWind();
-	scanVariability();
-	while (scanVisibility()) { /* empty loop body */}
-	while (scanRwyVisRange()) { /* empty loop body */}
-	while (scanWeather()) { /* empty loop body */}
-	while (scanSkyCondition()) { /* empty loop body */}
-
-    if (!scanTemperature()) {
-        throw sg_io_exception("metar temperature data malformed or missing ", sg_location(_url));
-    }
-    if (!scanPressure()) {
-        throw sg_io_exception("metar pressure data malformed or missing ", sg_location(_url));
+    // reused, so decoding doesn't allocate once its buffer has grown
+    static thread_local SGMetarParser parser;
+    SGMetarReport r;
+    SGMetarParser::Result result = parser.parse(m, r);
+
+    std::string_view data = parser.getNormalized();
+    _data.assign(data.begin(), data.end());
+    _data.push_back('\0');
+    _m = _data.data() + r.unparsed;
+
+    if (result != SGMetarParser::OK) {
+        throw sg_io_exception(SGMetarParser::getResultString(result), sg_location(m));
     }
 
-	while (scanSkyCondition()) { /* empty loop body */}
-	while (scanRunwayReport()) { /* empty loop body */}
-	scanWindShear();
+    strcpy(_icao, r.icao);
+    _year = r.year;
+    _month = r.month;
+    _day = r.day;
+    _hour = r.hour;
+    _minute = r.minute;
+    _report_type = r.report_type;
+    _wind_dir = r.wind_dir;
+    _wind_speed = r.wind_speed;
+    _gust_speed = r.gust_speed;
+    _wind_range_from = r.wind_range_from;
+    _wind_range_to = r.wind_range_to;
+    _temp = r.temp;
+    _dewp = r.dewp;
+    _pressure = r.pressure;
+    _rain = r.rain;
+    _hail = r.hail;
+    _snow = r.snow;
+    _cavok = r.cavok;
+
+    _min_visibility = r.min_visibility;
+    _max_visibility = r.max_visibility;
+    _vert_visibility = r.vert_visibility;
+    for (int i = 0; i < 8; i++)
+        _dir_visibility[i] = r.dir_visibility[i];
+
+    _clouds.assign(r.clouds, r.clouds + r.num_clouds);
+
+    for (int i = 0; i < r.num_runways; i++)
+        _runways[r.runways[i].id] = r.runways[i].runway;
+
+    for (int i = 0; i < r.num_weather; i++) {
+        const SGMetarReport::Weather& w = r.weather[i];
+        if (w.no_significant) {
+            _weather.push_back("no significant weather");
+            continue;
+        }
 
-	// appendix
-	while (scanColorState()) { /* empty loop body */}
-	scanTrendForecast();
-	while (scanRunwayReport()) { /* empty loop body */}
-	scanRemainder();
-	scanRemark();
+        string weather;
+        if (w.intensity == LIGHT)
+            weather = "light ";
+        else if (w.intensity == HEAVY)
+            weather = "heavy ";
+        else if (w.intensity == MODERATE)
+            weather = "moderate ";
+
+        struct Weather w2;
+        w2.intensity = static_cast<Intensity>(w.intensity);
+        w2.vincinity = w.vincinity;
+        for (int j = 0; j < w.num_descriptors; j++) {
+            w2.descriptions.push_back(SGMetarReport::getDescriptorId(w.descriptors[j]));
+            weather += string(SGMetarReport::getDescriptorText(w.descriptors[j])) + " ";
+        }
+        for (int j = 0; j < w.num_phenomena; j++) {
+            w2.phenomena.push_back(SGMetarReport::getPhenomenonId(w.phenomena[j]));
+            weather += string(SGMetarReport::getPhenomenonText(w.phenomena[j])) + " ";
+        }
+        if (w.vincinity)
+            weather += "in the vicinity ";
 
-    _url.clear();
+        weather.erase(weather.length() - 1);
+        _weather.push_back(weather);
+        if (!w2.phenomena.empty())
+            _weather2.push_back(w2);
+    }
 }
 
 
@@ -455,19 +488,6 @@ std::string SGMetar::getDescription(int tabstops) const
         return out.str();
 }
 
-void SGMetar::useCurrentDate()
-{
-	struct tm now;
-	time_t now_sec = time(0);
-#ifdef _WIN32
-	now = *gmtime(&now_sec);
-#else
-	gmtime_r(&now_sec, &now);
-#endif
-	_year = now.tm_year + 1900;
-	_month = now.tm_mon + 1;
-}
-
 std::string SGMetar::getDataString() const
 {
     return std::string{_data.data()};
@@ -480,30 +500,165 @@ std::string SGMetar::getUnparsedData() const
 
     return std::string{_m};
 }
+
 /**
-  * Replace any number of subsequent spaces by just one space, and add
-  * a trailing space. This makes scanning for things like "ALL RWY" easier.
+ * Decode @a metar into @a report; the report is reset first, and on failure
+ * holds what was decoded up to the group which couldn't be.
+ */
+SGMetarParser::Result SGMetarParser::parse(std::string_view metar, SGMetarReport& report)
+{
+	report = SGMetarReport();
+	_r = &report;
+	_prior_coverage = SGMetarCloud::COVERAGE_CLEAR;
+
+	normalizeData(metar);
+	_m = _data.data();
+
+	Result result = scanReport();
+	report.unparsed = _m - _data.data();
+	_r = nullptr;
+	return result;
+}
+
+
+SGMetarParser::Result SGMetarParser::scanReport()
+{
+	// NOAA preample
+	if (!scanPreambleDate())
+		useCurrentDate();
+	scanPreambleTime();
+
+	// METAR header
+	scanType();
+	if (!scanId() || !scanDate())
+		return BAD_HEADER;
+	while (scanModifier()) ;
+
+	// base set
+	scanWind();
+	scanVariability();
+	while (scanVisibility()) { /* empty loop body */}
+	while (scanRwyVisRange()) { /* empty loop body */}
+	while (scanWeather()) { /* empty loop body */}
+	while (scanSkyCondition()) { /* empty loop body */}
+
+	if (!scanTemperature())
+		return BAD_TEMPERATURE;
+	if (!scanPressure())
+		return BAD_PRESSURE;
+
+	while (scanSkyCondition()) { /* empty loop body */}
+	while (scanRunwayReport()) { /* empty loop body */}
+	scanWindShear();
+
+	// appendix
+	while (scanColorState()) { /* empty loop body */}
+	scanTrendForecast();
+	while (scanRunwayReport()) { /* empty loop body */}
+	scanRemainder();
+	scanRemark();
+	return OK;
+}
+
+
+const char *SGMetarParser::getResultString(Result r)
+{
+	switch (r) {
+	case OK:
+		return "ok";
+	case BAD_HEADER:
+		return "metar data bogus ";
+	case BAD_TEMPERATURE:
+		return "metar temperature data malformed or missing ";
+	case BAD_PRESSURE:
+		return "metar pressure data malformed or missing ";
+	}
+	return "";
+}
+
+
+void SGMetarParser::parseAll(const std::vector<std::string_view>& metars,
+		std::vector<SGMetarReport>& reports, std::vector<Result> *results)
+{
+	reports.resize(metars.size());
+	if (results)
+		results->resize(metars.size());
+
+	// blocks of reports, so that each parser's buffer is reused
+	const size_t block_size = 256;
+	const size_t num_blocks = (metars.size() + block_size - 1) / block_size;
+	SGJobPool::shared().parallelFor(num_blocks, [&](size_t block) {
+		SGMetarParser parser;
+		const size_t end = std::min(metars.size(), (block + 1) * block_size);
+		for (size_t i = block * block_size; i < end; i++) {
+			Result r = parser.parse(metars[i], reports[i]);
+			if (results)
+				(*results)[i] = r;
+		}
+	});
+}
+
+
+void SGMetarParser::useCurrentDate()
+{
+	struct tm now;
+	time_t now_sec = time(0);
+#ifdef _WIN32
+	now = *gmtime(&now_sec);
+#else
+	gmtime_r(&now_sec, &now);
+#endif
+	_r->year = now.tm_year + 1900;
+	_r->month = now.tm_mon + 1;
+}
+
+
+/**
+  * Copy the report up to any NUL, replacing any number of subsequent spaces
+  * by just one space, and add a trailing space. This makes scanning for
+  * things like "ALL RWY" easier.
   */
-void SGMetar::normalizeData()
+void SGMetarParser::normalizeData(std::string_view metar)
 {
-    // TODO : use strutils::simplify here
-    char* src = _data.data();
-    char* dest = src;
-    for (; (*dest++ = *src++);) {
-        while (*src == ' ' && src[1] == ' ')
-            src++;
-    }
+	metar = metar.substr(0, metar.find('\0'));
+	_data.resize(metar.size() + 2); // make room for " \0"
+
+	const char *src = metar.data(), *end = src + metar.size();
+	char *dest = _data.data();
+	while (src != end) {
+		if ((*dest++ = *src++) == ' ') {
+			while (src != end && *src == ' ')
+				src++;
+		}
+	}
 
-    for (dest--; isspace(*--dest); )
-        ;
+	while (dest != _data.data() && isspace(dest[-1]))
+		dest--;
 
-    *++dest = ' ';
-    *++dest = '\0';
+	*dest++ = ' ';
+	*dest = '\0';
+	_length = dest - _data.data();
+}
+
+
+SGMetarReport::Runway *SGMetarParser::getRunway(const char *id)
+{
+	for (int i = 0; i < _r->num_runways; i++) {
+		if (!strcmp(_r->runways[i].id, id))
+			return &_r->runways[i];
+	}
+
+	if (_r->num_runways == SGMetarReport::MAX_RUNWAYS)
+		return nullptr;
+
+	SGMetarReport::Runway *rwy = &_r->runways[_r->num_runways++];
+	strncpy(rwy->id, id, sizeof(rwy->id) - 1);
+	return rwy;
 }
 
 
 // \d\d\d\d/\d\d/\d\d
-bool SGMetar::scanPreambleDate()
+bool SGMetarParser::scanPreambleDate()
 {
 	char *m = _m;
 	int year, month, day;
@@ -519,16 +674,16 @@ bool SGMetar::scanPreambleDate()
 		return false;
 	if (!scanBoundary(&m))
 		return false;
-	_year = year;
-	_month = month;
-	_day = day;
+	_r->year = year;
+	_r->month = month;
+	_r->day = day;
 	_m = m;
 	return true;
 }
 
 
 // \d\d:\d\d
-bool SGMetar::scanPreambleTime()
+bool SGMetarParser::scanPreambleTime()
 {
 	char *m = _m;
 	int hour, minute;
@@ -540,15 +695,15 @@ bool SGMetar::scanPreambleTime()
 		return false;
 	if (!scanBoundary(&m))
 		return false;
-	_hour = hour;
-	_minute = minute;
+	_r->hour = hour;
+	_r->minute = minute;
 	_m = m;
 	return true;
 }
 
 
 // (METAR|SPECI)
-bool SGMetar::scanType()
+bool SGMetarParser::scanType()
 {
 	if (strncmp(_m, "METAR ", 6) && strncmp(_m, "SPECI ", 6))
 		return false;
@@ -558,7 +713,7 @@ bool SGMetar::scanType()
 
 
 // [A-Z]{4}
-bool SGMetar::scanId()
+bool SGMetarParser::scanId()
 {
 	char *m = _m;
 	for (int i = 0; i < 4; m++, i++)
@@ -566,15 +721,15 @@ bool SGMetar::scanId()
 			return false;
 	if (!scanBoundary(&m))
 		return false;
-	strncpy(_icao, _m, 4);
-	_icao[4] = '\0';
+	strncpy(_r->icao, _m, 4);
+	_r->icao[4] = '\0';
 	_m = m;
 	return true;
 }
 
 
 // \d{6}Z
-bool SGMetar::scanDate()
+bool SGMetarParser::scanDate()
 {
     char* m = _m;
     int day, hour, minute;
@@ -594,16 +749,16 @@ bool SGMetar::scanDate()
     if (!scanBoundary(&m))
         return false;
 
-    _day = day;
-    _hour = hour;
-    _minute = minute;
+    _r->day = day;
+    _r->hour = hour;
+    _r->minute = minute;
     _m = m;
     return true;
 }
 
 
 // (NIL|AUTO|COR|RTD)
-bool SGMetar::scanModifier()
+bool SGMetarParser::scanModifier()
 {
 	char *m = _m;
 	int type;
@@ -612,25 +767,25 @@ bool SGMetar::scanModifier()
 		return true;
 	}
 	if (!strncmp(m, "AUTO", 4))			// automatically generated
-		m += 4, type = AUTO;
+		m += 4, type = SGMetar::AUTO;
 	else if (!strncmp(m, "COR", 3))			// manually corrected
-		m += 3, type = COR;
+		m += 3, type = SGMetar::COR;
 	else if (!strncmp(m, "CC", 2) && *(m+2) >= 'A' && *(m+2) <= 'B')    // correction
-		m += 3, type = COR;
+		m += 3, type = SGMetar::COR;
 	else if (!strncmp(m, "RTD", 3))			// routine delayed
-		m += 3, type = RTD;
+		m += 3, type = SGMetar::RTD;
 	else
 		return false;
 	if (!scanBoundary(&m))
 		return false;
-	_report_type = type;
+	_r->report_type = type;
 	_m = m;
 	return true;
 }
 
 
 // (\d{3}|VRB)\d{1,3}(G\d{2,3})?(KT|KMH|MPS)
-bool SGMetar::scanWind()
+bool SGMetarParser::scanWind()
 {
 #if TRACE
     std::cout << "metar wind: " << _m << std::endl;
@@ -690,16 +845,16 @@ bool SGMetar::scanWind()
         return false;
 
     _m = m;
-    _wind_dir = dir == -1 ? 0 : dir;
-    _wind_speed = speed < 0.0 ? 0.0 : speed * factor;
+    _r->wind_dir = dir == -1 ? 0 : dir;
+    _r->wind_speed = speed < 0.0 ? 0.0 : speed * factor;
     if (gust != NaN)
-        _gust_speed = gust * factor;
+        _r->gust_speed = gust * factor;
     return true;
 }
 
 
 // \d{3}V\d{3}
-bool SGMetar::scanVariability()
+bool SGMetarParser::scanVariability()
 {
 #if TRACE
     std::cout << "metar variability: " << _m << std::endl;
@@ -725,14 +880,14 @@ bool SGMetar::scanVariability()
         return false;
 
     _m = m;
-    _wind_range_from = from;
-    _wind_range_to = to;
+    _r->wind_range_from = from;
+    _r->wind_range_to = to;
 
     return true;
 }
 
 
-bool SGMetar::scanVisibility()
+bool SGMetarParser::scanVisibility()
 // TODO: if only directed vis are given, do still set min/max
 {
 #if TRACE
@@ -826,11 +981,11 @@ bool SGMetar::scanVisibility()
 
 	SGMetarVisibility *v;
 	if (dir != -1)
-		v = &_dir_visibility[dir / 45];
-	else if (_min_visibility._distance == NaN)
-		v = &_min_visibility;
+		v = &_r->dir_visibility[dir / 45];
+	else if (_r->min_visibility._distance == NaN)
+		v = &_r->min_visibility;
 	else
-		v = &_max_visibility;
+		v = &_r->max_visibility;
 
 	v->_distance = distance;
 	v->_modifier = modifier;
@@ -841,7 +996,7 @@ bool SGMetar::scanVisibility()
 
 
 // R\d\d[LCR]?/([PM]?\d{4}V)?[PM]?\d{4}(FT)?[DNU]?
-bool SGMetar::scanRwyVisRange()
+bool SGMetarParser::scanRwyVisRange()
 {
 #if TRACE
     std::cout << "metar runway range: " << _m << std::endl;
@@ -910,8 +1065,10 @@ bool SGMetar::scanRwyVisRange()
 		return false;
 	_m = m;
 
-	_runways[id]._min_visibility = r._min_visibility;
-	_runways[id]._max_visibility = r._max_visibility;
+	if (SGMetarReport::Runway *rwy = getRunway(id)) {
+		rwy->runway._min_visibility = r._min_visibility;
+		rwy->runway._max_visibility = r._max_visibility;
+	}
 	return true;
 }
 
@@ -967,15 +1124,48 @@ static const struct Token phenomenon[] = {
 };
 
 
+const char *SGMetarReport::getDescriptorId(unsigned char d)
+{
+	return d < sizeof(description) / sizeof(description[0]) - 1 ? description[d].id : 0;
+}
+
+
+const char *SGMetarReport::getDescriptorText(unsigned char d)
+{
+	return d < sizeof(description) / sizeof(description[0]) - 1 ? description[d].text : 0;
+}
+
+
+const char *SGMetarReport::getPhenomenonId(unsigned char p)
+{
+	return p < sizeof(phenomenon) / sizeof(phenomenon[0]) - 1 ? phenomenon[p].id : 0;
+}
+
+
+const char *SGMetarReport::getPhenomenonText(unsigned char p)
+{
+	return p < sizeof(phenomenon) / sizeof(phenomenon[0]) - 1 ? phenomenon[p].text : 0;
+}
+
+
+const SGMetarReport::Runway *SGMetarReport::getRunway(const char *id) const
+{
+	for (int i = 0; i < num_runways; i++) {
+		if (!strcmp(runways[i].id, id))
+			return &runways[i];
+	}
+	return 0;
+}
+
+
 // (+|-|VC)?(NSW|MI|PR|BC|DR|BL|SH|TS|FZ)?((DZ|RA|SN|SG|IC|PE|GR|GS|UP){0,3})(BR|FG|FU|VA|DU|SA|HZ|PY|PO|SQ|FC|SS|DS){0,3}
-bool SGMetar::scanWeather()
+bool SGMetarParser::scanWeather()
 {
 #if TRACE
     std::cout << "metar weather: " << _m << std::endl;
 #endif
 
 	char *m = _m;
-	string weather;
 	const struct Token *a;
 
 	// @see WMO-49 Section 4.4.2.9
@@ -991,58 +1181,52 @@ bool SGMetar::scanWeather()
         return scanBoundary(&_m);
     }
 
+	SGMetarReport::Weather w;
 	if ((a = scanToken(&m, special))) {
 		if (!scanBoundary(&m))
 			return false;
-		_weather.push_back(a->text);
+		w.no_significant = true;
+		if (_r->num_weather < SGMetarReport::MAX_WEATHER)
+			_r->weather[_r->num_weather++] = w;
 		_m = m;
 		return true;
 	}
 
-	string pre, post;
-	struct Weather w;
 	if (*m == '-')
-		m++, pre = "light ", w.intensity = LIGHT;
+		m++, w.intensity = SGMetar::LIGHT;
 	else if (*m == '+')
-		m++, pre = "heavy ", w.intensity = HEAVY;
+		m++, w.intensity = SGMetar::HEAVY;
 	else if (!strncmp(m, "VC", 2))
-        m += 2, post = "in the vicinity ", w.vincinity=true;
+        m += 2, w.vincinity = true;
 	else
-		pre = "moderate ", w.intensity = MODERATE;
+		w.intensity = SGMetar::MODERATE;
 
 	int i;
-	for (i = 0; i < 3; i++) {
+	for (i = 0; i < SGMetarReport::MAX_WEATHER_CODES; i++) {
 		if (!(a = scanToken(&m, description)))
 			break;
-		w.descriptions.push_back(a->id);
-		weather += string(a->text) + " ";
+		w.descriptors[w.num_descriptors++] = a - description;
 	}
 
-	for (i = 0; i < 3; i++) {
+	for (i = 0; i < SGMetarReport::MAX_WEATHER_CODES; i++) {
 		if (!(a = scanToken(&m, phenomenon)))
 			break;
-        w.phenomena.push_back(a->id);
-		weather += string(a->text) + " ";
-		if (!strcmp(a->id, "RA"))
-			_rain = w.intensity;
-		else if (!strcmp(a->id, "DZ"))
-			_rain = LIGHT;
-		else if (!strcmp(a->id, "HA"))
-			_hail = w.intensity;
-		else if (!strcmp(a->id, "SN"))
-			_snow = w.intensity;
+		const int p = a - phenomenon;
+		w.phenomena[w.num_phenomena++] = p;
+		if (p == SGMetarReport::PHENOMENON_RA)
+			_r->rain = w.intensity;
+		else if (p == SGMetarReport::PHENOMENON_DZ)
+			_r->rain = SGMetar::LIGHT;
+		else if (p == SGMetarReport::PHENOMENON_SN)
+			_r->snow = w.intensity;
 	}
-	if (!weather.length())
+	if (!w.num_descriptors && !w.num_phenomena)
 		return false;
 	if (!scanBoundary(&m))
 		return false;
 	_m = m;
-	weather = pre + weather + post;
-	weather.erase(weather.length() - 1);
-	_weather.push_back(weather);
-    if( ! w.phenomena.empty() ) {
-        _weather2.push_back( w );
-    }
+	if (_r->num_weather < SGMetarReport::MAX_WEATHER)
+		_r->weather[_r->num_weather++] = w;
     return true;
 }
 
@@ -1072,7 +1256,7 @@ static const struct Token cloud_types[] = {
 
 #include <iostream>
 // (FEW|SCT|BKN|OVC|SKC|CLR|CAVOK|VV)([0-9]{3}|///)?[:cloud_type:]?
-bool SGMetar::scanSkyCondition()
+bool SGMetarParser::scanSkyCondition()
 {
 #if TRACE
     std::cout << "metar sky condition: " << _m << std::endl;
@@ -1081,7 +1265,6 @@ bool SGMetar::scanSkyCondition()
 	char *m = _m;
 	int i;
 	SGMetarCloud cl;
-    static SGMetarCloud::Coverage priorCoverage;
 
 	if (!strncmp(m, "//////", 6)) {
 		char* m2 = m+6;
@@ -1102,9 +1285,10 @@ bool SGMetar::scanSkyCondition()
 
 		if (i == 3) {
 			cl._coverage = SGMetarCloud::COVERAGE_CLEAR;
-			_clouds.push_back(cl);
+			if (_r->num_clouds < SGMetarReport::MAX_CLOUDS)
+				_r->clouds[_r->num_clouds++] = cl;
 		} else {
-			_cavok = true;
+			_r->cavok = true;
 		}
 		_m = m;
 		return true;
@@ -1115,16 +1299,16 @@ bool SGMetar::scanSkyCondition()
         verticalVisibility = true;
     } else if (!strncmp(m, "FEW", i = 3)) {
         cl._coverage = SGMetarCloud::COVERAGE_FEW;
-        priorCoverage = cl._coverage;
+        _prior_coverage = cl._coverage;
     } else if (!strncmp(m, "SCT", i = 3)) {
         cl._coverage = SGMetarCloud::COVERAGE_SCATTERED;
-        priorCoverage = cl._coverage;
+        _prior_coverage = cl._coverage;
     } else if (!strncmp(m, "BKN", i = 3)) {
         cl._coverage = SGMetarCloud::COVERAGE_BROKEN;
-        priorCoverage = cl._coverage;
+        _prior_coverage = cl._coverage;
     } else if (!strncmp(m, "OVC", i = 3)) {
         cl._coverage = SGMetarCloud::COVERAGE_OVERCAST;
-        priorCoverage = cl._coverage;
+        _prior_coverage = cl._coverage;
     } else if (!strncmp(m, "///", i = 3))
         cl._coverage = SGMetarCloud::COVERAGE_NIL; // should we add 'unknown'?
     else {
@@ -1133,7 +1317,7 @@ bool SGMetar::scanSkyCondition()
             *(m+1) >= '0' && *(m+1) <= '9' &&
             *(m+2) >= '0' && *(m+2) <= '9' &&
             *(m+3) == ' ') {
-            cl._coverage = priorCoverage;
+            cl._coverage = _prior_coverage;
             i = 0;
         } else
             return false;
@@ -1141,10 +1325,9 @@ bool SGMetar::scanSkyCondition()
     m += i;
 
     if (!strncmp(m, "///", 3)) { // vis not measurable (e.g. because of heavy snowing)
-		m += 3, i = -1;
-		sg_srandom_time();
+		m += 3;
 		// randomize the base height to avoid the black sky issue
-		i = 50 + static_cast<int>(sg_random() * 250.0);		// range [5,000, 30,000]
+		i = unmeasuredCloudBase();		// range [5,000, 30,000]
 	} else if (scanBoundary(&m)) {
 		_m = m;
 		return true;				// ignore single OVC/BKN/...
@@ -1155,9 +1338,9 @@ bool SGMetar::scanSkyCondition()
 		 if (!scanBoundary(&m))
 		 	return false;
 		if (i == -1)			// 'VV///'
-			_vert_visibility._modifier = SGMetarVisibility::NOGO;
+			_r->vert_visibility._modifier = SGMetarVisibility::NOGO;
 		else
-			_vert_visibility._distance = i * 100 * SG_FEET_TO_METER;
+			_r->vert_visibility._distance = i * 100 * SG_FEET_TO_METER;
 		_m = m;
 		return true;
 	}
@@ -1179,8 +1362,9 @@ bool SGMetar::scanSkyCondition()
 		return false;
 
 	// require known coverage and base-height
-	if (i != -1 && cl._coverage != SGMetarCloud::COVERAGE_NIL)
-		_clouds.push_back(cl);
+	if (i != -1 && cl._coverage != SGMetarCloud::COVERAGE_NIL
+			&& _r->num_clouds < SGMetarReport::MAX_CLOUDS)
+		_r->clouds[_r->num_clouds++] = cl;
 
 	_m = m;
 	return true;
@@ -1189,7 +1373,7 @@ bool SGMetar::scanSkyCondition()
 
 // M?[0-9]{2}/(M?[0-9]{2})?            (spec)
 // (M?[0-9]{2}|XX)/(M?[0-9]{2}|XX)?    (Namibia)
-bool SGMetar::scanTemperature()
+bool SGMetarParser::scanTemperature()
 {
 #if TRACE
     std::cout << "metar temp: " << _m << std::endl;
@@ -1199,11 +1383,10 @@ bool SGMetar::scanTemperature()
 	int sign = 1, temp, dew;
 
     // sniff test to confirm that this is a temperature element
-    std::string s = "M/0123456789";
     for (int i=0; i<7; ++i) {
         if (*(m+i) == ' ')
             break;
-        if (s.find(*(m+i)) == std::string::npos)
+        if (!*(m+i) || !strchr("M/0123456789", *(m+i)))
             return true;        // nope, bail
     }
 
@@ -1213,8 +1396,8 @@ bool SGMetar::scanTemperature()
 	}
 	if (!strncmp(m, "/////", 5)) {
 		// sensor failure... assume standard temperature
-		_temp = 15.0;
-		_dewp = 3.0;
+		_r->temp = 15.0;
+		_r->dewp = 3.0;
 		_m += 5;
 		return scanBoundary(&_m);
 	}
@@ -1248,9 +1431,9 @@ bool SGMetar::scanTemperature()
 		if (!scanBoundary(&m))
 			return false;
 		if (sign)
-			_dewp = sign * dew;
+			_r->dewp = sign * dew;
 	}
-	_temp = temp;
+	_r->temp = temp;
 	_m = m;
 	return true;
 }
@@ -1268,7 +1451,7 @@ double SGMetar::getRelHumidity() const
 
 // [AQ]\d{4}             (spec)
 // [AQ]\d{2}(\d{2}|//)   (Namibia)
-bool SGMetar::scanPressure()
+bool SGMetarParser::scanPressure()
 {
 #if TRACE
     std::cout << "metar pressure: " << _m << std::endl;
@@ -1281,7 +1464,7 @@ bool SGMetar::scanPressure()
 	int press, i;
 
 	if (*m == '\0') {
-		_pressure = 101300.0;	// pressure not provided... assume standard pressure
+		_r->pressure = 101300.0;	// pressure not provided... assume standard pressure
 		return true;
 	}
 
@@ -1335,7 +1518,7 @@ bool SGMetar::scanPressure()
     if (!unitProvided)
         factor = (press > 2000 ? SG_INHG_TO_PA / 100.0 : 100.0);
 
-    _pressure = press * factor;
+    _r->pressure = press * factor;
 	_m = m;
 	return true;
 }
@@ -1373,7 +1556,7 @@ static const char *runway_friction[] = {
 
 
 // \d\d(CLRD|[\d/]{4})(\d\d|//)
-bool SGMetar::scanRunwayReport()
+bool SGMetarParser::scanRunwayReport()
 {
 	char *m = _m;
 	int i;
@@ -1443,21 +1626,23 @@ bool SGMetar::scanRunwayReport()
 	if (!scanBoundary(&m))
 		return false;
 
-	_runways[id]._deposit = r._deposit;
-	_runways[id]._deposit_string = r._deposit_string;
-	_runways[id]._extent = r._extent;
-	_runways[id]._extent_string = r._extent_string;
-	_runways[id]._depth = r._depth;
-	_runways[id]._friction = r._friction;
-	_runways[id]._friction_string = r._friction_string;
-	_runways[id]._comment = r._comment;
+	if (SGMetarReport::Runway *rwy = getRunway(id)) {
+		rwy->runway._deposit = r._deposit;
+		rwy->runway._deposit_string = r._deposit_string;
+		rwy->runway._extent = r._extent;
+		rwy->runway._extent_string = r._extent_string;
+		rwy->runway._depth = r._depth;
+		rwy->runway._friction = r._friction;
+		rwy->runway._friction_string = r._friction_string;
+		rwy->runway._comment = r._comment;
+	}
 	_m = m;
 	return true;
 }
 
 
 // WS (ALL RWYS?|RWY ?\d\d[LCR]?)?
-bool SGMetar::scanWindShear()
+bool SGMetarParser::scanWindShear()
 {
 	char *m = _m;
 	if (strncmp(m, "WS", 2))
@@ -1477,7 +1662,8 @@ bool SGMetar::scanWindShear()
 			m++;
 		if (!scanBoundary(&m))
 			return false;
-		_runways["ALL"]._wind_shear = true;
+		if (SGMetarReport::Runway *rwy = getRunway("ALL"))
+			rwy->runway._wind_shear = true;
 		_m = m;
 		return true;
 	}
@@ -1498,16 +1684,19 @@ bool SGMetar::scanWindShear()
 		id[i] = '\0';
 		if (!scanBoundary(&m))
 			return false;
-		_runways[id]._wind_shear = true;
+		if (SGMetarReport::Runway *rwy = getRunway(id))
+			rwy->runway._wind_shear = true;
+	}
+	if (!cnt) {
+		if (SGMetarReport::Runway *rwy = getRunway("ALL"))
+			rwy->runway._wind_shear = true;
 	}
-	if (!cnt)
-		_runways["ALL"]._wind_shear = true;
 	_m = m;
 	return true;
 }
 
 
-bool SGMetar::scanTrendForecast()
+bool SGMetarParser::scanTrendForecast()
 {
 	char *m = _m;
 	if (strncmp(m, "NOSIG", 5))
@@ -1533,7 +1722,7 @@ static const struct Token colors[] = {
 };
 
 
-bool SGMetar::scanColorState()
+bool SGMetarParser::scanColorState()
 {
 	char *m = _m;
 	const struct Token *a;
@@ -1547,7 +1736,7 @@ bool SGMetar::scanColorState()
 }
 
 
-bool SGMetar::scanRemark()
+bool SGMetarParser::scanRemark()
 {
 	if (strncmp(_m, "RMK", 3))
 		return false;
@@ -1566,7 +1755,7 @@ bool SGMetar::scanRemark()
 }
 
 
-bool SGMetar::scanRemainder()
+bool SGMetarParser::scanRemainder()
 {
 	char *m = _m;
 	if (!(strncmp(m, "NOSIG", 5))) {
@@ -1582,7 +1771,7 @@ bool SGMetar::scanRemainder()
 }
 
 
-bool SGMetar::scanBoundary(char **s)
+bool SGMetarParser::scanBoundary(char **s)
 {
 	if (**s && !isspace(**s))
 		return false;
@@ -1592,7 +1781,7 @@ bool SGMetar::scanBoundary(char **s)
 }
 
 
-int SGMetar::scanNumber(char **src, int *num, int min, int max)
+int SGMetarParser::scanNumber(char **src, int *num, int min, int max)
 {
 	int i;
 	char *s = *src;
@@ -1610,13 +1799,27 @@ int SGMetar::scanNumber(char **src, int *num, int min, int max)
 }
 
 
+// Pseudo-random in [50, 300), but reproducible: derived from the report up
+// to the current group rather than from a global generator, so reports can
+// be decoded on several threads
+int SGMetarParser::unmeasuredCloudBase() const
+{
+	uint32_t h = 2166136261u;
+	for (const char *c = _data.data(); c != _m; c++)
+		h = (h ^ static_cast<unsigned char>(*c)) * 16777619u;
+	return 50 + static_cast<int>(h % 250);
+}
+
+
 // find longest match of str in list
-const struct Token *SGMetar::scanToken(char **str, const struct Token *list)
+const struct Token *SGMetarParser::scanToken(char **str, const struct Token *list)
 {
 	const struct Token *longest = 0;
 	int maxlen = 0, len;
 	const char *s;
 	for (int i = 0; (s = list[i].id); i++) {
+		if (*s != **str)
+			continue;
 		len = strlen(s);
 		if (!strncmp(s, *str, len) && len > maxlen) {
 			maxlen = len;
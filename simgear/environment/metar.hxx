@@ -11,6 +11,7 @@
 #include <vector>
 #include <map>
 #include <string>
+#include <string_view>
 
 #include <simgear/constants.h>
 
@@ -22,9 +23,11 @@ struct Token {
 const double SGMetarNaN = -1E20;
 
 class SGMetar;
+class SGMetarParser;
 
 class SGMetarVisibility {
 	friend class SGMetar;
+	friend class SGMetarParser;
 public:
 	SGMetarVisibility() :
 		_distance(SGMetarNaN),
@@ -66,6 +69,7 @@ protected:
 // runway condition (surface and visibility)
 class SGMetarRunway {
 	friend class SGMetar;
+	friend class SGMetarParser;
 public:
 	SGMetarRunway() :
 		_deposit(-1),
@@ -108,6 +112,7 @@ protected:
 // cloud layer
 class SGMetarCloud {
 	friend class SGMetar;
+	friend class SGMetarParser;
 public:
 	enum Coverage {
 		COVERAGE_NIL = -1,
@@ -259,6 +264,134 @@ protected:
 	std::vector<SGMetarCloud>		_clouds;
 	std::map<std::string, SGMetarRunway>	_runways;
 	std::vector<std::string>			_weather;
+};
+
+
+/**
+ * Decoded METAR as plain data, as produced by SGMetarParser: groups are
+ * kept in small fixed arrays (further ones are ignored), weather codes are
+ * indices into static tables, and all texts point to static strings.
+ * Units are the ones of SGMetar: m/s, meters, degrees C and Pa.
+ */
+struct SGMetarReport {
+	enum {
+		MAX_CLOUDS = 8,
+		MAX_WEATHER = 8,
+		MAX_WEATHER_CODES = 3,
+		MAX_RUNWAYS = 8
+	};
+
+	enum Descriptor {
+		DESCRIPTOR_SH, DESCRIPTOR_TS, DESCRIPTOR_BC, DESCRIPTOR_BL, DESCRIPTOR_DR,
+		DESCRIPTOR_FZ, DESCRIPTOR_MI, DESCRIPTOR_PR, DESCRIPTOR_RE
+	};
+
+	enum Phenomenon {
+		PHENOMENON_DZ, PHENOMENON_GR, PHENOMENON_GS, PHENOMENON_IC, PHENOMENON_PE,
+		PHENOMENON_PL, PHENOMENON_RA, PHENOMENON_SG, PHENOMENON_SN, PHENOMENON_UP,
+		PHENOMENON_BR, PHENOMENON_DU, PHENOMENON_FG, PHENOMENON_FGBR, PHENOMENON_FU,
+		PHENOMENON_HZ, PHENOMENON_PY, PHENOMENON_SA, PHENOMENON_VA, PHENOMENON_DS,
+		PHENOMENON_FC, PHENOMENON_PO, PHENOMENON_SQ, PHENOMENON_SS
+	};
+
+	struct Weather {
+		unsigned char	intensity = SGMetar::NIL;
+		bool		vincinity = false;
+		bool		no_significant = false;		// NSW
+		unsigned char	num_descriptors = 0;
+		unsigned char	num_phenomena = 0;
+		unsigned char	descriptors[MAX_WEATHER_CODES] = {};	// Descriptor
+		unsigned char	phenomena[MAX_WEATHER_CODES] = {};	// Phenomenon
+	};
+
+	struct Runway {
+		char		id[4] = {};	// "27L", "ALL", ...
+		SGMetarRunway	runway;
+	};
+
+	char	icao[5] = {};
+	int	year = -1;
+	int	month = -1;
+	int	day = -1;
+	int	hour = -1;
+	int	minute = -1;
+	int	report_type = -1;
+	int	wind_dir = -1;
+	double	wind_speed = SGMetarNaN;
+	double	gust_speed = SGMetarNaN;
+	int	wind_range_from = -1;
+	int	wind_range_to = -1;
+	double	temp = SGMetarNaN;
+	double	dewp = SGMetarNaN;
+	double	pressure = SGMetarNaN;
+	int	rain = 0;
+	int	hail = 0;
+	int	snow = 0;
+	bool	cavok = false;
+
+	SGMetarVisibility	min_visibility;
+	SGMetarVisibility	max_visibility;
+	SGMetarVisibility	vert_visibility;
+	SGMetarVisibility	dir_visibility[8];
+
+	unsigned char	num_clouds = 0;
+	unsigned char	num_weather = 0;
+	unsigned char	num_runways = 0;
+	SGMetarCloud	clouds[MAX_CLOUDS];
+	Weather		weather[MAX_WEATHER];
+	Runway		runways[MAX_RUNWAYS];
+
+	// offset of the first group not decoded, in the normalized report
+	unsigned int	unparsed = 0;
+
+	const Runway	*getRunway(const char *id) const;
+
+	static const char	*getDescriptorId(unsigned char d);
+	static const char	*getDescriptorText(unsigned char d);
+	static const char	*getPhenomenonId(unsigned char p);
+	static const char	*getPhenomenonText(unsigned char p);
+};
+
+
+/**
+ * Decodes METARs into SGMetarReports in one pass over each report. It
+ * doesn't throw, and doesn't allocate once its buffer for the normalized
+ * report has grown; a parser can be reused, but not shared between threads.
+ */
+class SGMetarParser {
+public:
+	enum Result {
+		OK,
+		BAD_HEADER,		// no station id or date
+		BAD_TEMPERATURE,
+		BAD_PRESSURE
+	};
+
+	Result	parse(std::string_view metar, SGMetarReport& report);
+
+	// the last report parsed, with runs of spaces collapsed and a trailing space
+	inline std::string_view getNormalized() const { return std::string_view(_data.data(), _length); }
+
+	static const char	*getResultString(Result r);
+
+	/**
+	 * Decode @a metars in parallel into the corresponding elements of
+	 * @a reports and, if given, @a results.
+	 */
+	static void	parseAll(const std::vector<std::string_view>& metars,
+				std::vector<SGMetarReport>& reports,
+				std::vector<Result> *results = nullptr);
+
+private:
+	std::vector<char>	_data;
+	size_t			_length = 0;
+	char			*_m = nullptr;
+	SGMetarReport		*_r = nullptr;
+	SGMetarCloud::Coverage	_prior_coverage = SGMetarCloud::COVERAGE_CLEAR;
+
+	void	normalizeData(std::string_view metar);
+	Result	scanReport();
+	SGMetarReport::Runway	*getRunway(const char *id);
 
 	bool	scanPreambleDate();
 	bool	scanPreambleTime();
@@ -286,5 +419,5 @@ protected:
 	int	scanNumber(char **str, int *num, int min, int max = 0);
 	bool	scanBoundary(char **str);
 	const struct Token *scanToken(char **str, const struct Token *list);
-	void	normalizeData();
+	int	unmeasuredCloudBase() const;
 };
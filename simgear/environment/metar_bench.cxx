@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Benchmark METAR decoding on the test_metar reports, replicated to
+ *        the size of a weather server update cycle
+ */
+
+#include <simgear_config.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <simgear/misc/test_timing.hxx>
+#include <simgear/threads/SGJobPool.hxx>
+
+#include "metar.hxx"
+
+static const int num_reports = 50000;
+static const int num_runs = 3;
+
+static const char* reports[] = {
+    "2011/10/20 11:25 EHAM 201125Z 27012KT 240V300 9999 VCSH FEW025CB SCT048 10/05 Q1025 TEMPO VRB03KT",
+    "XXXX 012345Z 150KT 9999 -SN OVC060CB SCT050TCU M20/M30 Q1005",
+    "2023/05/08 14:46 KSCH 081446Z 28012 G15KT 15SM CLR A2981 RMK TEMP AND DP MISSING; FIRST",
+    "2011/10/20 11:25 EHAM 201125Z 27012KT 9999 DZ FEW025CB 10/05 Q1025",
+    "2011/10/20 11:25 EHAM 201125Z 27012KT 240V300 9999 FEW025CB/// SCT048/// 10/05 Q1025",
+    "2020/10/23 16:55 LIVD 231655Z /////KT 9999 OVC025 10/08 Q1020 RMK OVC VIS MIN 9999 BLU",
+    "2020/11/17 16:00 CYAZ 171600Z 14040G//KT 10SM -RA OVC012 12/11 A2895 RMK NS8 VIA CYXY SLP806 DENSITY ALT 900FT",
+    "2020/10/23 11:58 KLSV 231158Z 05010G14 10SM CLR 16/M04 A2992 RMK SLPNO WND DATA ESTMD ALSTG/SLP ESTMD 10320 20124 5//// $",
+    "EGPF 111420Z AUTO 24013KT 9000 -RA SCT019/// BKN023/// BKN030/// //////TCU 13/11 Q1011 RERA",
+    "2022/09/15 17:00 LFBT 151700Z AUTO 21008KT 9999 -RA FEW060/// SCT076/// OVC088/// ///CB 20/16 Q1014 TEMPO 27015G25KT 4000 -TSRA",
+    "2023/05/08 05:00 MYGF 080500Z AUTO 08008KT //// R06///// // NCD 19/14 A3010",
+    "2023/03/23 01:20 EDMO 230120Z AUTO 21004KT 180V250 //// R22///// // OVC210/// 07/03 Q1012",
+    "2023/03/11 11:51 KSMO 111151Z AUTO 00000KT 4SM HZ OVC003 A3002 RMK AO2 RAE20B35E42 SLPNO P0000 60004 70084 57003 $",
+    "2023/02/23 00:45 KMWC 230045Z 06015G23KT 1 1/4SM SNPL OVC005 M01/M03 A2970 ",
+    "2022/12/14 14:00 HSSJ 141400Z 09006KT 9999 SCT040 32/15 Q 1009",
+    "METAR RPMZ 092300Z 00000KT 9999 FEW017 BKN090 24/23 Q1010 RMK A2983",
+    "2023/05/11 03:43 MMTM 110343Z E06010KT 4SM SCT010TCU BKN070 27/25 A2979 RMK 8/270 VC TS LTGIC OCNLS W NWOPS OCNLS HZ",
+    "2023/05/11 00:00 CYTR 110000Z CCA 25013KT 15SM BKN220 17/02 A3006 RMK CI7 DENSITY ALT 511FT SLP181",
+    "LYBE 131800Z 26008KT 3500 -RA BR OVC003 04/04 Q1019 TEMPO OVC002",
+    "LFMO 031330Z AUTO VRB02KT 9000 -RA SCT015/// OVC024/// ///CB 13/13 Q1012 TEMPO VRB20G30KT 2000 TSRA BKN010 BKN025CB",
+};
+static const int num_distinct = sizeof(reports) / sizeof(reports[0]);
+
+int main(int argc, char* argv[])
+{
+    std::vector<std::string> metars;
+    metars.reserve(num_reports);
+    for (int i = 0; i < num_reports; ++i) {
+        metars.push_back(reports[i % num_distinct]);
+    }
+
+    size_t clouds = 0;
+    const double legacy_ms = bestRun(num_runs, [&] {
+        clouds = 0;
+        for (const auto& m : metars) {
+            SGMetar metar(m);
+            clouds += metar.getClouds().size();
+        }
+    }).toMSecs();
+
+    std::vector<std::string_view> views(metars.begin(), metars.end());
+    size_t parsed = 0;
+    const double parser_ms = bestRun(num_runs, [&] {
+        parsed = 0;
+        SGMetarParser parser;
+        SGMetarReport report;
+        for (const auto& m : views) {
+            parser.parse(m, report);
+            parsed += report.num_clouds;
+        }
+    }).toMSecs();
+
+    std::vector<SGMetarReport> decoded;
+    size_t batched = 0;
+    const double batch_ms = bestRun(num_runs, [&] {
+        SGMetarParser::parseAll(views, decoded);
+        batched = 0;
+        for (const auto& r : decoded) {
+            batched += r.num_clouds;
+        }
+    }).toMSecs();
+
+    std::cout << num_reports << " reports (" << num_distinct << " distinct), "
+              << SGJobPool::defaultNumWorkers() + 1 << " threads\n"
+              << std::fixed << std::setprecision(1)
+              << "SGMetar:              " << std::setw(8) << legacy_ms << " ms\n"
+              << "SGMetarParser:        " << std::setw(8) << parser_ms << " ms ("
+              << legacy_ms / std::max(parser_ms, 0.1) << "x)\n"
+              << "parseAll:             " << std::setw(8) << batch_ms << " ms ("
+              << legacy_ms / std::max(batch_ms, 0.1) << "x)\n";
+
+    if (clouds == 0 || parsed != clouds || batched != clouds) {
+        std::cerr << "results differ" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
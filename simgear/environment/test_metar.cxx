@@ -219,6 +219,96 @@ void bulk_from_tickets()
     { SGMetar m1("LFMO 031330Z AUTO VRB02KT 9000 -RA SCT015/// OVC024/// ///CB 13/13 Q1012 TEMPO VRB20G30KT 2000 TSRA BKN010 BKN025CB"); }
 }
 
+void test_parser()
+{
+    const char* metar = "KJFK 121651Z 31015G25KT 1/2SM R04R/2000V4000FT -TSRA +SHSN VCFG FEW008 BKN020CB "
+                        "M02/M05 A2992 WS RWY 04R RMK AO2";
+    SGMetarParser parser;
+    SGMetarReport r;
+    SG_CHECK_EQUAL(parser.parse(metar, r), SGMetarParser::OK);
+    SG_CHECK_EQUAL(std::string(r.icao), "KJFK");
+    SG_CHECK_EQUAL(r.wind_dir, 310);
+    SG_CHECK_EQUAL_EP2(r.temp, -2.0, TEST_EPSILON);
+
+    SG_CHECK_EQUAL(r.num_weather, 3);
+    SG_CHECK_EQUAL(r.weather[0].intensity, SGMetar::LIGHT);
+    SG_CHECK_EQUAL(r.weather[0].num_descriptors, 1);
+    SG_CHECK_EQUAL(r.weather[0].descriptors[0], SGMetarReport::DESCRIPTOR_TS);
+    SG_CHECK_EQUAL(r.weather[0].phenomena[0], SGMetarReport::PHENOMENON_RA);
+    SG_CHECK_EQUAL(r.weather[1].phenomena[0], SGMetarReport::PHENOMENON_SN);
+    SG_VERIFY(r.weather[2].vincinity);
+    SG_CHECK_EQUAL(std::string(SGMetarReport::getPhenomenonText(r.weather[2].phenomena[0])), "fog");
+    SG_CHECK_EQUAL(r.rain, SGMetar::LIGHT);
+    SG_CHECK_EQUAL(r.snow, SGMetar::HEAVY);
+
+    SG_CHECK_EQUAL(r.num_clouds, 2);
+    SG_CHECK_EQUAL(std::string(r.clouds[1].getTypeString()), "CB");
+
+    // visual range and wind shear end up in the same runway entry
+    SG_CHECK_EQUAL(r.num_runways, 1);
+    const SGMetarReport::Runway* rwy = r.getRunway("04R");
+    SG_VERIFY(rwy);
+    SG_VERIFY(rwy->runway.getWindShear());
+    SG_CHECK_EQUAL_EP2(rwy->runway.getMaxVisibility().getVisibility_m(), 1219, TEST_EPSILON);
+    SG_CHECK_EQUAL(parser.getNormalized().substr(r.unparsed), "");
+
+    // the wrapper reports the same
+    SGMetar m(metar);
+    SG_CHECK_EQUAL(m.getWeather().size(), 3);
+    SG_CHECK_EQUAL(m.getWeather()[0], "light thunderstorm with rain");
+    SG_CHECK_EQUAL(m.getWeather()[2], "fog in the vicinity");
+    SG_CHECK_EQUAL(m.getWeather2().size(), 3);
+    SG_CHECK_EQUAL(m.getWeather2()[1].descriptions.front(), "SH");
+    SG_CHECK_EQUAL(m.getRunways().size(), 1);
+    SG_VERIFY(m.getRunways().at("04R").getWindShear());
+
+    // failures don't throw, and the parser can be reused
+    SG_CHECK_EQUAL(parser.parse("EHAM 27012KT 9999", r), SGMetarParser::BAD_HEADER);
+    SG_CHECK_EQUAL(parser.parse("2023/05/08 14:00 DAAT 081400Z 30013KT CAVOK 35/// Q1020", r), SGMetarParser::OK);
+    SG_VERIFY(r.cavok);
+    SG_CHECK_EQUAL(r.num_weather, 0);
+    SG_CHECK_EQUAL(std::string(parser.getNormalized()), "2023/05/08 14:00 DAAT 081400Z 30013KT CAVOK 35/// Q1020 ");
+
+    // unmeasured cloud bases are made up, but the same each time
+    parser.parse("ENGM 121650Z 01005KT 5000 BKN/// 01/M01 Q1001", r);
+    const double base = r.clouds[0].getAltitude_m();
+    parser.parse("ENGM 121650Z 01005KT 5000 BKN/// 01/M01 Q1001", r);
+    SG_CHECK_EQUAL_EP2(r.clouds[0].getAltitude_m(), base, TEST_EPSILON);
+}
+
+void test_parse_all()
+{
+    const char* metars[] = {
+        "2011/10/20 11:25 EHAM 201125Z 27012KT 240V300 9999 VCSH FEW025CB SCT048 10/05 Q1025 TEMPO VRB03KT",
+        "2023/05/08 14:46 KSCH 081446Z 28012 G15KT 15SM CLR A2981 RMK TEMP AND DP MISSING; FIRST",
+        "EHAM 27012KT 9999",
+        "2023/02/23 00:45 KMWC 230045Z 06015G23KT 1 1/4SM SNPL OVC005 M01/M03 A2970 "};
+
+    std::vector<std::string_view> input;
+    for (int i = 0; i < 1000; ++i) {
+        input.push_back(metars[i % 4]);
+    }
+
+    std::vector<SGMetarReport> reports;
+    std::vector<SGMetarParser::Result> results;
+    SGMetarParser::parseAll(input, reports, &results);
+    SG_CHECK_EQUAL(reports.size(), input.size());
+    SG_CHECK_EQUAL(results.size(), input.size());
+
+    SGMetarParser parser;
+    SGMetarReport r;
+    for (size_t i = 0; i < input.size(); ++i) {
+        SG_CHECK_EQUAL(results[i], parser.parse(input[i], r));
+        SG_CHECK_EQUAL(std::string(reports[i].icao), std::string(r.icao));
+        SG_CHECK_EQUAL(reports[i].num_clouds, r.num_clouds);
+        SG_CHECK_EQUAL(reports[i].num_weather, r.num_weather);
+        SG_CHECK_EQUAL_EP2(reports[i].pressure, r.pressure, TEST_EPSILON);
+        SG_CHECK_EQUAL(reports[i].unparsed, r.unparsed);
+    }
+    SG_CHECK_EQUAL(results[2], SGMetarParser::BAD_HEADER);
+    SG_CHECK_EQUAL_EP2(reports[3].gust_speed * SG_MPS_TO_KT, 23.0, 1e-6);
+}
+
 void bulk_stress()
 {
     // { SGMetar m1("2023/05/11 19:50 KJAU 111950Z AUTO 11.96000012KT 10SM CLR 25/14 A3017 RMK A01"); }                                 valid error, 11.96000012KT
@@ -249,6 +339,8 @@ int main(int argc, char* argv[])
         bulk_from_sentry();
         bulk_from_tickets();
         bulk_stress();
+        test_parser();
+        test_parse_all();
     } catch (sg_exception& e) {
         std::cerr << "Exception: " << e.getMessage() << std::endl;
         return -1;
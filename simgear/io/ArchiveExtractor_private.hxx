@@ -3,23 +3,23 @@
 
 #pragma once
 
+#include <atomic>
 #include <cassert>
+#include <memory>
 
 #include "untar.hxx"
 
-#include <simgear/misc/sg_hash.hxx>
-
 namespace simgear {
 
+class ExtractStage;
+class ExtractWriters;
+
 class ArchiveExtractorPrivate
 {
 public:
-    ArchiveExtractorPrivate(ArchiveExtractor* o) : outer(o)
-    {
-        assert(outer);
-    }
+    ArchiveExtractorPrivate(ArchiveExtractor* o);
 
-    virtual ~ArchiveExtractorPrivate() = default;
+    virtual ~ArchiveExtractorPrivate();
 
     typedef enum {
       INVALID = 0,
@@ -37,11 +37,22 @@ public:
       FILTER_STOPPED
     } State;
 
-    State state = INVALID;
+    std::atomic<State> state{INVALID};
     ArchiveExtractor* outer = nullptr;
-    sha1nfo hashState;
     SGPath mostRecentPath;
 
+    /**
+     * Take archive bytes from the caller: queued for the decompression
+     * thread when extracting in parallel, else passed to extractBytes().
+     */
+    void feed(const uint8_t* bytes, size_t count);
+
+    /// Process everything fed so far, flush() and wait for all files to be written
+    void finish();
+
+    /// Stop the threads, dropping whatever is still queued
+    void shutdown();
+
     virtual void extractBytes(const uint8_t* bytes, size_t count) = 0;
 
     virtual void flush() = 0;
@@ -86,6 +97,28 @@ public:
         // on POSIX could use realpath to sanity check
         return true;
     }
+
+protected:
+    /// Whether extractBytes() decompresses, and so deserves a thread of its own
+    virtual bool isCompressed() const { return false; }
+
+    /// Start the threads of a parallel extraction; called before the first bytes
+    virtual void startStages();
+
+    /**
+     * Wait for the stages after the decompression one, called after
+     * flush(), or stop them without processing what is queued.
+     */
+    virtual void finishStages(bool drain) {}
+
+    bool isParallel() const;
+
+    ExtractWriters& writers() { return *_writers; }
+
+private:
+    std::unique_ptr<ExtractStage> _inflateStage;
+    std::unique_ptr<ExtractWriters> _writers;
+    bool _started = false;
 };
 
 } // namespace simgear
\ No newline at end of file
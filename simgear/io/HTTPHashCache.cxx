@@ -0,0 +1,510 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Per-directory file hash cache of the HTTP TerraSync repository
+ */
+
+#include <simgear_config.h>
+
+#include "HTTPHashCache_private.hxx"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <simgear/debug/logstream.hxx>
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/io/sg_mmap.hxx>
+#include <simgear/misc/strutils.hxx>
+
+namespace simgear {
+
+namespace {
+
+// A comment line for parsers of the text format, and a check of the layout
+const char fileMagic[8] = {'#', 'S', 'G', 'D', 'H', '\n', '\0', '\0'};
+const uint32_t fileVersion = 1; // also catches files from the other endianness
+
+const size_t hashLength = 20; // SHA1
+
+// files from this size on are mapped rather than read
+const size_t mapThreshold = 64 * 1024;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t count;             ///< entries
+    int64_t lastChecked;
+    uint64_t binarySize;        ///< header, entries and pool
+    uint32_t lastModifiedOffset;
+    uint32_t lastModifiedLength;
+};
+
+static_assert(sizeof(FileHeader) == 40, "unexpected .dirhash header layout");
+
+bool decodeHash(std::string_view hex, uint8_t* bytes)
+{
+    if (hex.size() != hashLength * 2) {
+        return false;
+    }
+
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    };
+
+    for (size_t i = 0; i < hashLength; ++i) {
+        const int hi = nibble(hex[i * 2]);
+        const int lo = nibble(hex[i * 2 + 1]);
+        if (hi < 0 || lo < 0) {
+            return false;
+        }
+        bytes[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    return true;
+}
+
+} // of anonymous namespace
+
+struct HTTPHashCache::FileEntry {
+    int64_t modTime;
+    uint64_t lengthBytes;
+    uint32_t nameOffset;        ///< into the pool
+    uint32_t nameLength;
+    uint8_t hash[hashLength];
+    uint8_t padding[4];
+};
+
+HTTPHashCache::HTTPHashCache(const SGPath& dir) : _dir(dir),
+                                                  _file(dir / ".dirhash"),
+                                                  _prefix(dir.utf8Str() + "/")
+{
+}
+
+HTTPHashCache::~HTTPHashCache()
+{
+    release();
+}
+
+std::string HTTPHashCache::keyForPath(const SGPath& path) const
+{
+    std::string ps = path.utf8Str();
+    if (ps.size() > _prefix.size() && std::string_view(ps).starts_with(_prefix)) {
+        ps.erase(0, _prefix.size());
+    }
+    return ps;
+}
+
+bool HTTPHashCache::load()
+{
+    clear();
+    _lastModified.clear();
+    _lastChecked = 0;
+
+    if (!readFile()) {
+        return false;
+    }
+
+    const char* data = _data;
+    const size_t size = _dataSize;
+    if (size < sizeof(fileMagic) || memcmp(data, fileMagic, sizeof(fileMagic)) != 0) {
+        // the text format: read it all, the next write() turns it binary
+        parseText(std::string_view(data, size), true);
+        detach();
+        return true;
+    }
+
+    if (!attach()) {
+        SG_LOG(SG_TERRASYNC, SG_WARN, "invalid hash cache '" << _file << "' (ignoring it)");
+        detach();
+        return false;
+    }
+
+    auto header = reinterpret_cast<const FileHeader*>(data);
+    const size_t binarySize = header->binarySize;
+    _hasBinary = true;
+    _lastChecked = header->lastChecked;
+    _lastModified.assign(_pool + header->lastModifiedOffset, header->lastModifiedLength);
+
+    // lines appended by the archive extractor
+    if (size > binarySize) {
+        parseText(std::string_view(data + binarySize, size - binarySize), false);
+    }
+    return true;
+}
+
+bool HTTPHashCache::readFile() const
+{
+    SGPath file(_file);
+    const size_t size = file.exists() ? file.sizeInBytes() : 0;
+    if (size == 0) {
+        return false;
+    }
+
+    if (size >= mapThreshold) {
+        _mapping.reset(new SGMMapFile(file));
+        if (!_mapping->open(SG_IO_IN)) {
+            _mapping.reset();
+            return false;
+        }
+        _data = _mapping->get();
+        _dataSize = _mapping->get_size();
+        return true;
+    }
+
+    // mapping a page costs more than reading it: read small files, into
+    // 8 byte aligned memory like a mapping's
+    sg_ifstream stream(file, std::ios::in | std::ios::binary);
+    if (!stream.is_open()) {
+        return false;
+    }
+    _buffer.resize((size + 7) / 8);
+    stream.read(reinterpret_cast<char*>(_buffer.data()), size);
+    _data = reinterpret_cast<const char*>(_buffer.data());
+    _dataSize = static_cast<size_t>(stream.gcount());
+    return true;
+}
+
+bool HTTPHashCache::attach() const
+{
+    static_assert(sizeof(FileEntry) == 48, "unexpected .dirhash entry layout");
+
+    if (_entries) {
+        return true;
+    }
+
+    if (!_data && !readFile()) {
+        return false;
+    }
+
+    const char* data = _data;
+    const size_t size = _dataSize;
+    if (size < sizeof(FileHeader)) {
+        return false;
+    }
+
+    auto header = reinterpret_cast<const FileHeader*>(data);
+    if (memcmp(header->magic, fileMagic, sizeof(fileMagic)) != 0 || header->version != fileVersion) {
+        return false;
+    }
+
+    const uint64_t entriesEnd = sizeof(FileHeader) + uint64_t(header->count) * sizeof(FileEntry);
+    if (header->binarySize > size || entriesEnd > header->binarySize) {
+        return false;
+    }
+
+    const char* pool = data + entriesEnd;
+    const size_t poolSize = header->binarySize - entriesEnd;
+    if (uint64_t(header->lastModifiedOffset) + header->lastModifiedLength > poolSize) {
+        return false;
+    }
+
+    auto entries = reinterpret_cast<const FileEntry*>(data + sizeof(FileHeader));
+    for (uint32_t i = 0; i < header->count; ++i) {
+        if (uint64_t(entries[i].nameOffset) + entries[i].nameLength > poolSize) {
+            return false;
+        }
+    }
+
+    _entries = entries;
+    _pool = pool;
+    _count = header->count;
+    return true;
+}
+
+void HTTPHashCache::release()
+{
+    detach();
+}
+
+void HTTPHashCache::detach() const
+{
+    _entries = nullptr;
+    _pool = nullptr;
+    _count = 0;
+    _data = nullptr;
+    _dataSize = 0;
+    if (_mapping) {
+        _mapping->close();
+        _mapping.reset();
+    }
+    std::vector<uint64_t>().swap(_buffer);
+}
+
+std::string_view HTTPHashCache::nameOf(const FileEntry& e) const
+{
+    return std::string_view(_pool + e.nameOffset, e.nameLength);
+}
+
+const HTTPHashCache::FileEntry* HTTPHashCache::findInFile(std::string_view key) const
+{
+    if (!_hasBinary) {
+        return nullptr;
+    }
+
+    if (!attach()) {
+        // replaced behind our back; don't try again for every lookup
+        SG_LOG(SG_TERRASYNC, SG_WARN, "hash cache '" << _file << "' changed or vanished");
+        detach();
+        _hasBinary = false;
+        return nullptr;
+    }
+
+    const FileEntry* end = _entries + _count;
+    const FileEntry* it = std::lower_bound(_entries, end, key,
+                                           [this](const FileEntry& e, std::string_view k) {
+                                               return nameOf(e) < k;
+                                           });
+    if (it == end || nameOf(*it) != key) {
+        return nullptr;
+    }
+    return it;
+}
+
+bool HTTPHashCache::find(std::string_view key, Entry& entry) const
+{
+    if (!_changes.empty()) {
+        auto it = _changes.find(std::string(key));
+        if (it != _changes.end()) {
+            if (!it->second) {
+                return false;
+            }
+            entry = *it->second;
+            return true;
+        }
+    }
+
+    const FileEntry* e = findInFile(key);
+    if (!e) {
+        return false;
+    }
+
+    entry.modTime = static_cast<time_t>(e->modTime);
+    entry.lengthBytes = static_cast<size_t>(e->lengthBytes);
+    entry.hashHex = strutils::encodeHex(e->hash, hashLength);
+    return true;
+}
+
+void HTTPHashCache::set(const std::string& key, const Entry& entry)
+{
+    _changes[key] = entry;
+}
+
+bool HTTPHashCache::erase(const std::string& key)
+{
+    auto it = _changes.find(key);
+    if (it != _changes.end()) {
+        const bool existed = it->second.has_value();
+        if (findInFile(key)) {
+            it->second.reset();
+        } else {
+            _changes.erase(it);
+        }
+        return existed;
+    }
+
+    if (findInFile(key)) {
+        _changes.emplace(key, std::nullopt);
+        return true;
+    }
+    return false;
+}
+
+void HTTPHashCache::clear()
+{
+    release();
+    _changes.clear();
+    _hasBinary = false;
+}
+
+size_t HTTPHashCache::size() const
+{
+    size_t result = (_hasBinary && attach()) ? _count : 0;
+    for (const auto& c : _changes) {
+        const bool inFile = findInFile(c.first) != nullptr;
+        if (inFile && !c.second) {
+            --result;
+        } else if (!inFile && c.second) {
+            ++result;
+        }
+    }
+    return result;
+}
+
+void HTTPHashCache::parseText(std::string_view text, bool withHeader)
+{
+    for (std::string_view rawLine : strutils::split_view(text, "\n")) {
+        const std::string_view line = strutils::strip_view(rawLine);
+
+        // store Last-modified and Las-checked in comments. This allows older
+        // versions of FG to parse the files without lots of warning spam
+        if (withHeader && line.starts_with("#last-modified:")) {
+            _lastModified = line.substr(15);
+            continue;
+        }
+
+        if (withHeader && line.starts_with("#last-checked:")) {
+            long long seconds;
+            if (strutils::parse_number(strutils::strip_view(line.substr(14)), seconds)) {
+                _lastChecked = seconds;
+            } else {
+                SG_LOG(SG_TERRASYNC, SG_WARN, "Failed to parse:" << line.substr(14));
+            }
+            continue;
+        }
+
+        // skip comments and blank lines
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::string_view tokens[4];
+        size_t numTokens = 0;
+        for (std::string_view token : strutils::split_view(line, "*")) {
+            if (numTokens == 4) {
+                break;
+            }
+            tokens[numTokens++] = strutils::strip_view(token);
+        }
+        if (numTokens < 4) {
+            // skip entries which don't fit the pattern. This allows adding different directives
+            // to the file in the future if needed
+            continue;
+        }
+
+        Entry entry;
+        if (tokens[0].empty() || tokens[3].empty() ||
+            !strutils::parse_number(tokens[1], entry.modTime) ||
+            !strutils::parse_number(tokens[2], entry.lengthBytes)) {
+            SG_LOG(SG_TERRASYNC, SG_WARN, "invalid entry in '" << _file << "': '" << line << "' (ignoring line)");
+            continue;
+        }
+
+        // the text format stores full paths
+        std::string key(tokens[0]);
+        if (key.size() > _prefix.size() && std::string_view(key).starts_with(_prefix)) {
+            key.erase(0, _prefix.size());
+        }
+
+        entry.hashHex = tokens[3];
+        _changes[key] = std::move(entry);
+    }
+}
+
+bool HTTPHashCache::write()
+{
+    struct Merged {
+        std::string_view name;
+        int64_t modTime;
+        uint64_t lengthBytes;
+        uint8_t hash[hashLength];
+    };
+
+    // merge the changes into the (sorted) entries of the file
+    std::vector<Merged> merged;
+    merged.reserve(((_hasBinary && attach()) ? _count : 0) + _changes.size());
+
+    std::vector<std::pair<std::string_view, const Entry*>> changes;
+    changes.reserve(_changes.size());
+    for (const auto& c : _changes) {
+        changes.emplace_back(c.first, c.second ? &*c.second : nullptr);
+    }
+    std::sort(changes.begin(), changes.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    auto addChange = [&merged, this](std::string_view name, const Entry* e) {
+        if (!e) {
+            return; // removed
+        }
+
+        Merged m;
+        m.name = name;
+        m.modTime = e->modTime;
+        m.lengthBytes = e->lengthBytes;
+        if (!decodeHash(e->hashHex, m.hash)) {
+            SG_LOG(SG_TERRASYNC, SG_DEBUG, "not caching invalid hash for '" << name
+                   << "' in '" << _file << "'");
+            return;
+        }
+        merged.push_back(m);
+    };
+
+    const FileEntry* fileIt = _entries;
+    const FileEntry* fileEnd = _entries + _count;
+    auto changeIt = changes.begin();
+    while (fileIt != fileEnd || changeIt != changes.end()) {
+        if (changeIt == changes.end() || (fileIt != fileEnd && nameOf(*fileIt) < changeIt->first)) {
+            Merged m;
+            m.name = nameOf(*fileIt);
+            m.modTime = fileIt->modTime;
+            m.lengthBytes = fileIt->lengthBytes;
+            memcpy(m.hash, fileIt->hash, hashLength);
+            merged.push_back(m);
+            ++fileIt;
+        } else {
+            if (fileIt != fileEnd && nameOf(*fileIt) == changeIt->first) {
+                ++fileIt; // replaced
+            }
+            addChange(changeIt->first, changeIt->second);
+            ++changeIt;
+        }
+    }
+
+    // the string pool: Last-Modified, then the names in order
+    std::string pool = _lastModified;
+    std::vector<FileEntry> entries(merged.size());
+    for (size_t i = 0; i < merged.size(); ++i) {
+        FileEntry& e = entries[i];
+        memset(&e, 0, sizeof(FileEntry));
+        e.modTime = merged[i].modTime;
+        e.lengthBytes = merged[i].lengthBytes;
+        e.nameOffset = static_cast<uint32_t>(pool.size());
+        e.nameLength = static_cast<uint32_t>(merged[i].name.size());
+        memcpy(e.hash, merged[i].hash, hashLength);
+        pool.append(merged[i].name);
+    }
+
+    FileHeader header;
+    memset(&header, 0, sizeof(FileHeader));
+    memcpy(header.magic, fileMagic, sizeof(fileMagic));
+    header.version = fileVersion;
+    header.count = static_cast<uint32_t>(entries.size());
+    header.lastChecked = _lastChecked;
+    header.binarySize = sizeof(FileHeader) + entries.size() * sizeof(FileEntry) + pool.size();
+    header.lastModifiedOffset = 0;
+    header.lastModifiedLength = static_cast<uint32_t>(_lastModified.size());
+
+    // write next to the file and rename it over it, so that readers never
+    // see a partial one
+    SGPath tempPath = _dir / ".dirhash.new";
+    {
+        sg_ofstream stream(tempPath, std::ios::out | std::ios::trunc | std::ios::binary);
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+        stream.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(FileEntry));
+        stream.write(pool.data(), pool.size());
+        stream.close();
+        if (stream.fail()) {
+            SG_LOG(SG_TERRASYNC, SG_WARN, "failed to write hash cache '" << tempPath << "'");
+            tempPath.remove();
+            return false;
+        }
+    }
+
+    // names point into the mapping until here; it has to go before the
+    // rename on Windows
+    merged.clear();
+    release();
+
+    if (!tempPath.rename(_file)) {
+        tempPath.remove();
+        return false;
+    }
+
+    _changes.clear();
+    _hasBinary = true;
+    return true;
+}
+
+} // of namespace simgear
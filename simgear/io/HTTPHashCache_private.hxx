@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Per-directory file hash cache of the HTTP TerraSync repository
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <simgear/misc/sg_path.hxx>
+
+class SGMMapFile;
+
+namespace simgear {
+
+/**
+ * The SHA1 hashes, sizes and modification times of the files of one
+ * repository directory, stored in its .dirhash file, so unchanged files
+ * don't need to be hashed again on every check.
+ *
+ * The file holds a header, the entries sorted by name with fixed width
+ * binary hashes, and a pool of the names. It is mapped into memory (or
+ * read in one go, when small) and looked up with a binary search, without
+ * being parsed; changes are kept aside until write() merges them into a
+ * new file, which replaces the old one atomically.
+ *
+ * The old text format ("path*mtime*size*hash" lines) is still read, and
+ * replaced by the binary one on the next write. Text lines appended to a
+ * binary file, as untar does when extracting an archive, are read too.
+ * The binary file starts with a '#' line, so versions which only know the
+ * text format skip it and hash the files again.
+ *
+ * Entries are keyed by their path relative to the directory.
+ */
+class HTTPHashCache
+{
+public:
+    struct Entry {
+        time_t modTime = 0;
+        size_t lengthBytes = 0;
+        std::string hashHex;
+    };
+
+    /// Cache for the .dirhash file in @a dir
+    explicit HTTPHashCache(const SGPath& dir);
+    ~HTTPHashCache();
+
+    HTTPHashCache(const HTTPHashCache&) = delete;
+    HTTPHashCache& operator=(const HTTPHashCache&) = delete;
+
+    /**
+     * Read the .dirhash file, dropping anything held before.
+     * @return false if there is none, or it can't be read
+     */
+    bool load();
+
+    /**
+     * Drop the file's contents. They are read again by the next lookup;
+     * call this once a directory has been dealt with, so that a large
+     * repository doesn't hold them for every directory.
+     */
+    void release();
+
+    /// The key of @a path: relative to the directory if it is below it
+    std::string keyForPath(const SGPath& path) const;
+
+    bool find(std::string_view key, Entry& entry) const;
+    void set(const std::string& key, const Entry& entry);
+    /// @return true if there was an entry
+    bool erase(const std::string& key);
+    void clear();
+
+    size_t size() const;
+
+    /// Whether there are entries which write() hasn't stored yet
+    bool hasChanges() const { return !_changes.empty(); }
+
+    const std::string& lastModified() const { return _lastModified; }
+    void setLastModified(const std::string& lastModified) { _lastModified = lastModified; }
+
+    /// Unix seconds since the epoch
+    int64_t lastChecked() const { return _lastChecked; }
+    void setLastChecked(int64_t seconds) { _lastChecked = seconds; }
+
+    /// Write the binary file, replacing the existing one
+    bool write();
+
+    SGPath file() const { return _file; }
+
+private:
+    struct FileEntry;
+
+    bool readFile() const;
+    bool attach() const;
+    void detach() const;
+    const FileEntry* findInFile(std::string_view key) const;
+    std::string_view nameOf(const FileEntry& e) const;
+    void parseText(std::string_view text, bool withHeader);
+
+    SGPath _dir;
+    SGPath _file;
+    std::string _prefix;    ///< of full paths below the directory, with a trailing '/'
+
+    std::string _lastModified;
+    int64_t _lastChecked = 0;
+
+    mutable bool _hasBinary = false; ///< the file holds binary entries
+
+    /// the file's contents: mapped, or read if it is small
+    mutable std::unique_ptr<SGMMapFile> _mapping;
+    mutable std::vector<uint64_t> _buffer;
+    mutable const char* _data = nullptr;
+    mutable size_t _dataSize = 0;
+
+    mutable const FileEntry* _entries = nullptr;
+    mutable const char* _pool = nullptr;
+    mutable uint32_t _count = 0;
+
+    /// Changes to the file's entries: std::nullopt for removed ones
+    std::unordered_map<std::string, std::optional<Entry>> _changes;
+};
+
+} // of namespace simgear
@@ -14,14 +14,18 @@
 #include "HTTPRepository.hxx"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <condition_variable>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <limits>
 #include <map>
+#include <mutex>
 #include <set>
 #include <sstream>
+#include <thread>
 
 #include <fcntl.h>
 
@@ -41,8 +45,10 @@
 #include <simgear/timing/timestamp.hxx>
 
 #include <simgear/misc/sg_hash.hxx>
+#include <simgear/threads/SGJobPool.hxx>
 #include <string>
 
+#include "HTTPHashCache_private.hxx"
 #include "HTTPRepository_private.hxx"
 
 namespace simgear
@@ -81,15 +87,6 @@ std::string innerResultCodeAsString(HTTPRepository::ResultCode code) {
   return "Unknown response code";
 }
 
-struct HashCacheEntry {
-    std::string filePath;
-    time_t modTime;
-    size_t lengthBytes;
-    std::string hashHex;
-};
-
-using HashCache = std::unordered_map<std::string, HashCacheEntry>;
-
 std::string computeHashForPath(const SGPath& p)
 {
     if (!p.exists())
@@ -120,6 +117,128 @@ std::string computeHashForPath(const SGPath& p)
     return strutils::encodeHex(hashBytes);
 }
 
+/**
+ * Write-behind stage for downloaded file contents: chunks received on the
+ * HTTP thread are queued, and hashed and written to disk on the worker pool,
+ * in order and by at most one worker at a time.
+ */
+class AsyncFileWriter : public std::enable_shared_from_this<AsyncFileWriter>
+{
+public:
+    /// block the producer when this much data is waiting to be written
+    static const size_t MaxQueuedBytes = 8 * 1024 * 1024;
+
+    AsyncFileWriter(SGJobPool& pool, std::unique_ptr<SGBinaryFile> file) :
+        _pool(pool),
+        _file(std::move(file))
+    {
+        sha1_init(&_hashContext);
+    }
+
+    /// queue data for writing. Returns false if a previous write failed.
+    bool write(const char* s, int n)
+    {
+        if (_failed) {
+            return false;
+        }
+
+        std::unique_lock<std::mutex> g(_lock);
+        _cond.wait(g, [this] { return _queuedBytes < MaxQueuedBytes; });
+
+        _chunks.emplace_back(s, n);
+        _queuedBytes += n;
+        if (!_draining) {
+            _draining = true;
+            auto self = shared_from_this();
+            _pool.submit([self] { self->drain(); });
+        }
+
+        return true;
+    }
+
+    /// wait for all queued data to be written, and close the file
+    void finish()
+    {
+        {
+            std::unique_lock<std::mutex> g(_lock);
+            _cond.wait(g, [this] { return !_draining; });
+        }
+
+        if (_file) {
+            _file->close();
+            _file.reset();
+        }
+    }
+
+    bool failed() const
+    {
+        return _failed;
+    }
+
+    /// only valid after finish()
+    std::string hash()
+    {
+        return strutils::encodeHex(sha1_result(&_hashContext), HASH_LENGTH);
+    }
+
+private:
+    void drain()
+    {
+        std::unique_lock<std::mutex> g(_lock);
+
+        // finish() waits for this, so reset it however drain() is left
+        struct DrainingGuard {
+            AsyncFileWriter& writer;
+            std::unique_lock<std::mutex>& lock;
+            ~DrainingGuard()
+            {
+                if (!lock.owns_lock()) {
+                    lock.lock();
+                }
+                writer._draining = false;
+                writer._cond.notify_all();
+            }
+        } guard{*this, g};
+
+        while (!_chunks.empty()) {
+            std::string chunk = std::move(_chunks.front());
+            _chunks.pop_front();
+            g.unlock();
+
+            if (!_failed) {
+                try {
+                    sha1_write(&_hashContext, chunk.data(), chunk.size());
+                    const auto written = _file->write(chunk.data(), chunk.size());
+                    if (written != static_cast<int>(chunk.size())) {
+                        SG_LOG(SG_TERRASYNC, SG_WARN, "Underflow writing to " << _file->get_file_name());
+                        _failed = true;
+                    }
+                } catch (std::exception& e) {
+                    SG_LOG(SG_TERRASYNC, SG_WARN, "Failed writing to " << _file->get_file_name() << ": " << e.what());
+                    _failed = true;
+                }
+            }
+
+            // a failed file still releases its queued bytes, so that
+            // write() doesn't block forever
+            g.lock();
+            _queuedBytes -= chunk.size();
+            _cond.notify_all();
+        }
+    }
+
+    SGJobPool& _pool;
+    std::unique_ptr<SGBinaryFile> _file;
+    simgear::sha1nfo _hashContext;
+
+    std::mutex _lock;
+    std::condition_variable _cond;
+    std::deque<std::string> _chunks;
+    size_t _queuedBytes = 0;
+    bool _draining = false;
+    std::atomic<bool> _failed{false};
+};
+
 } // namespace
 
 class HTTPDirectory
@@ -133,8 +252,10 @@ class HTTPDirectory
         ChildInfo(const ChildInfo& other) = default;
         ChildInfo& operator=(const ChildInfo& other) = default;
 
-      void setSize(const std::string &sizeData) {
-        sizeInBytes = ::strtol(sizeData.c_str(), NULL, 10);
+      void setSize(std::string_view sizeData) {
+        if (!simgear::strutils::parse_number(sizeData, sizeInBytes)) {
+          sizeInBytes = 0;
+        }
         }
 
         bool operator<(const ChildInfo& other) const
@@ -151,7 +272,7 @@ class HTTPDirectory
     typedef std::vector<ChildInfo> ChildInfoList;
     ChildInfoList children;
 
-    mutable HashCache hashes;
+    std::unique_ptr<HTTPHashCache> hashes;
     mutable bool hashCacheDirty = false;
     std::string _lastModified;
 
@@ -166,6 +287,7 @@ public:
       assert(repo);
 
       SGPath p(absolutePath());
+      hashes.reset(new HTTPHashCache(p));
       if (p.exists()) {
           try {
               // already exists on disk
@@ -358,6 +480,8 @@ public:
                                    }),
                     orphans.end());
 
+      computeMissingChildHashes();
+
       for (const auto &c : children) {
         // Check if the file exists
         auto p = std::find_if(fsChildren.begin(), fsChildren.end(),
@@ -513,6 +637,7 @@ public:
     public:
       ArchiveExtractTask(SGPath p, const std::string &relPath)
           : relativePath(relPath), file(p), extractor(p.dir()) {
+        extractor.setNumWriterThreads(ArchiveExtractor::suggestedNumWriterThreads());
         if (!file.open(SG_IO_IN)) {
           SG_LOG(SG_TERRASYNC, SG_ALERT,
                  "Unable to open " << p << " to extract");
@@ -654,23 +779,34 @@ public:
         _repository->failedToUpdateChild(fpath, status, details);
     }
 
-    std::string hashForPath(const SGPath& p) const
+    /// hash of p from the hash cache, or an empty string if there is no
+    /// valid entry. Stale entries are removed.
+    std::string cachedHashForPath(const SGPath& p) const
     {
-        const auto ps = p.utf8Str();
-        auto it = hashes.find(ps);
-        if (it != hashes.end()) {
-            const auto& entry = it->second;
+        const auto key = hashes->keyForPath(p);
+        HTTPHashCache::Entry entry;
+        if (hashes->find(key, entry)) {
             // ensure data on disk hasn't changed.
             // we could also use the file type here if we were paranoid
             if ((p.sizeInBytes() == entry.lengthBytes) && (p.modTime() == entry.modTime)) {
                 return entry.hashHex;
             }
 
-            // entry in the cache, but it's stale so remove and fall through
-            hashes.erase(it);
+            // entry in the cache, but it's stale so remove it
+            hashes->erase(key);
         }
 
-        std::string hash = computeHashForPath(p);
+        return {};
+    }
+
+    std::string hashForPath(const SGPath& p) const
+    {
+        std::string hash = cachedHashForPath(p);
+        if (!hash.empty()) {
+            return hash;
+        }
+
+        hash = computeHashForPath(p);
         updatedFileContents(p, hash);
         return hash;
     }
@@ -682,33 +818,26 @@ public:
 
     void writeHashCache() const
     {
-        if (!hashCacheDirty)
+        if (!hashCacheDirty) {
+            // done with it until the next lookup
+            hashes->release();
             return;
+        }
 
         hashCacheDirty = false;
 
-        // this code has to match the equivalent code in untar.cxx, otherwise pre-populating the
-        // hash cache when extracting a tarball won't work.
-
-        SGPath cachePath = absolutePath() / ".dirhash";
-        sg_ofstream stream(cachePath, std::ios::out | std::ios::trunc | std::ios::binary);
-
-        // store Last-modified and Las-checked in comments. This allows older
-        // versions of FG to parse the files without lots of warning spam
-
-        if (!_lastModified.empty()) {
-            stream << "#last-modified:" << _lastModified << "\n";
-        }
-
+        // the text lines written by untar.cxx when pre-populating the hash
+        // cache while extracting a tarball are picked up by the next load()
+        hashes->setLastModified(_lastModified);
         // Unix seconds since the epoch began
-        stream << "#last-checked:" << _lastChecked.time_since_epoch().count() << "\n";
+        hashes->setLastChecked(_lastChecked.time_since_epoch().count());
+        hashes->write();
+    }
 
-        for (const auto& e : hashes) {
-            const auto& entry = e.second;
-            stream << entry.filePath << "*" << entry.modTime << "*"
-                   << entry.lengthBytes << "*" << entry.hashHex << "\n";
-        }
-        stream.close();
+    /// unmap the hash cache of a directory which needs no further work
+    void releaseHashCache()
+    {
+        hashes->release();
     }
 
 private:
@@ -751,21 +880,28 @@ private:
             throw sg_io_exception("cannot open dirIndex file", p);
         }
 
-        while (!indexStream.eof() ) {
-            std::string line;
-            std::getline( indexStream, line );
-            line = simgear::strutils::strip(line);
+        std::string buffer;
+        while (std::getline(indexStream, buffer)) {
+            const std::string_view line = simgear::strutils::strip_view(buffer);
 
             // skip blank line or comment beginning with '#'
             if( line.empty() || line[0] == '#' )
                 continue;
 
-            string_list tokens = simgear::strutils::split( line, ":" );
+            // only the first four fields are used
+            std::string_view tokens[4];
+            size_t numTokens = 0;
+            for (std::string_view token : simgear::strutils::split_view(line, ":")) {
+                if (numTokens < 4) {
+                    tokens[numTokens] = token;
+                }
+                ++numTokens;
+            }
 
-            std::string typeData = tokens[0];
+            const std::string_view typeData = tokens[0];
 
             if( typeData == "version" ) {
-                if( tokens.size() < 2 ) {
+                if( numTokens < 2 ) {
                     SG_LOG(SG_TERRASYNC, SG_WARN, "malformed .dirindex file: missing version number in line '" << line << "'"
                            << "\n\tparsing:" << p.utf8Str());
                     break;
@@ -782,12 +918,12 @@ private:
                 continue; // ignore path, next line
             }
 
-            if( typeData == "time" && tokens.size() > 1 ) {
+            if( typeData == "time" && numTokens > 1 ) {
                // SG_LOG(SG_TERRASYNC, SG_INFO, ".dirindex at '" << p.str() << "' timestamp: " << tokens[1] );
                 continue;
             }
 
-            if( tokens.size() < 3 ) {
+            if( numTokens < 3 ) {
                 SG_LOG(SG_TERRASYNC, SG_WARN, "malformed .dirindex file: not enough tokens in line '" << line << "' (ignoring line)"
                        << "\n\tparsing:" << p.utf8Str());
                 continue;
@@ -801,22 +937,22 @@ private:
 
             // security: prevent writing outside the repository via ../../.. filenames
             // (valid filenames never contain / - subdirectories have their own .dirindex)
-            if ((tokens[1] == "..") || (tokens[1].find_first_of("/\\") != std::string::npos)) {
+            if ((tokens[1] == "..") || (tokens[1].find_first_of("/\\") != std::string_view::npos)) {
                 SG_LOG(SG_TERRASYNC, SG_WARN, "malformed .dirindex file: invalid filename in line '" << line << "', (ignoring line)"
                        << "\n\tparsing:" << p.utf8Str());
                 continue;
             }
 
-            ChildInfo ci =
-                ChildInfo(HTTPRepository::FileType, tokens[1], tokens[2]);
+            ChildInfo ci = ChildInfo(HTTPRepository::FileType,
+                                     std::string(tokens[1]), std::string(tokens[2]));
             if (typeData == "d")
               ci.type = HTTPRepository::DirectoryType;
             if (typeData == "t")
               ci.type = HTTPRepository::TarballType;
 
             children.emplace_back(ci);
-            children.back().path = absolutePath() / tokens[1];
-            if (tokens.size() > 3) {
+            children.back().path = absolutePath() / children.back().name;
+            if (numTokens > 3) {
                 children.back().setSize(tokens[3]);
             }
         }
@@ -844,85 +980,69 @@ private:
         }
     }
 
-    std::string hashForChild(const ChildInfo& child) const
+    static SGPath hashPathForChild(const ChildInfo& child)
     {
       SGPath p(child.path);
       if (child.type == HTTPRepository::DirectoryType) {
           p.append(".dirindex");
       }
-      return hashForPath(p);
+      return p;
     }
 
-    void parseHashCache()
+    std::string hashForChild(const ChildInfo& child) const
     {
-        hashes.clear();
-        _lastModified.clear();
-        SGPath cachePath = absolutePath() / ".dirhash";
-        if (!cachePath.exists()) {
-            return;
-        }
-
-        sg_ifstream stream(cachePath, std::ios::in);
-
-        while (!stream.eof()) {
-            std::string line;
-            std::getline(stream, line);
-            line = simgear::strutils::strip(line);
-
-            // store Last-modified and Las-checked in comments. This allows older
-            // versions of FG to parse the files without lots of warning spam
-            if (simgear::strutils::starts_with(line, "#last-modified:")) {
-                _lastModified = line.substr(15);
-                continue;
-            }
+      return hashForPath(hashPathForChild(child));
+    }
 
-            if (simgear::strutils::starts_with(line, "#last-checked:")) {
-                try {
-                    const auto seconds = std::stoll(line.substr(14));
-                    _lastChecked = std::chrono::time_point_cast<std::chrono::seconds>(std::chrono::system_clock::time_point() + std::chrono::seconds(seconds));
-                } catch (std::exception& e) {
-                    SG_LOG(SG_TERRASYNC, SG_WARN, "Failed to parse:" << line.substr(14) << ":" << e.what());
-                }
-                continue;
-            }
+    /// compute the hashes of all existing children which are not (or no
+    /// longer) in the hash cache on the hash pool, and add them to the
+    /// cache in one go. Failures are skipped here, so hashForChild() reports
+    /// them as before.
+    void computeMissingChildHashes()
+    {
+      std::vector<SGPath> paths;
+      for (const auto &c : children) {
+        SGPath p = hashPathForChild(c);
+        if (p.exists() && cachedHashForPath(p).empty()) {
+          paths.push_back(p);
+        }
+      }
 
-            // skip comments and blank lines
-            if (line.empty() || line[0] == '#')
-                continue;
+      if (paths.size() < 2) {
+        return; // not worth the thread hand-over
+      }
 
-            string_list tokens = simgear::strutils::split(line, "*");
-            if (tokens.size() < 4) {
-                // skip entries which don't fit the pattern. This allows adding different directives
-                // to the file in the future if needed
-                continue;
-            }
+      std::vector<std::string> results(paths.size());
+      SGJobPool::shared().parallelFor(paths.size(), [&paths, &results](size_t i) {
+        try {
+          results[i] = computeHashForPath(paths[i]);
+        } catch (std::exception &) {
+          // leave empty, will be retried (and reported) serially
+        }
+      });
 
-            const std::string nameData = simgear::strutils::strip(tokens[0]);
-            const std::string timeData = simgear::strutils::strip(tokens[1]);
-            const std::string sizeData = simgear::strutils::strip(tokens[2]);
-            const std::string hashData = simgear::strutils::strip(tokens[3]);
+      for (size_t i = 0; i < paths.size(); ++i) {
+        if (!results[i].empty()) {
+          updatedFileContents(paths[i], results[i]);
+        }
+      }
+    }
 
-            if (nameData.empty() || timeData.empty() || sizeData.empty() || hashData.empty()) {
-                SG_LOG(SG_TERRASYNC, SG_WARN, "invalid entry in '" << cachePath << "': '" << line << "' (ignoring line)");
-                continue;
-            }
+    void parseHashCache()
+    {
+        hashes->load();
+        _lastModified = hashes->lastModified();
+        _lastChecked = SystemSeconds(std::chrono::seconds(hashes->lastChecked()));
 
-            HashCacheEntry entry;
-            entry.filePath = nameData;
-            entry.hashHex = hashData;
-            entry.modTime = strtol(timeData.c_str(), NULL, 10);
-            entry.lengthBytes = strtol(sizeData.c_str(), NULL, 10);
-            hashes.insert(std::make_pair(entry.filePath, entry));
-        }
+        // a text file, or lines appended by untar: write the binary one next time
+        hashCacheDirty = hashes->hasChanges();
     }
 
     void updatedFileContents(const SGPath& p, const std::string& newHash) const
     {
         // remove the existing entry
-        const auto ps = p.utf8Str();
-        auto it = hashes.find(ps);
-        if (it != hashes.end()) {
-            hashes.erase(it);
+        const auto key = hashes->keyForPath(p);
+        if (hashes->erase(key)) {
             hashCacheDirty = true;
         }
 
@@ -935,12 +1055,11 @@ private:
         p2.set_cached(false);
         p2.set_cached(true);
 
-        HashCacheEntry entry;
-        entry.filePath = ps;
+        HTTPHashCache::Entry entry;
         entry.hashHex = newHash;
         entry.modTime = p2.modTime();
         entry.lengthBytes = p2.sizeInBytes();
-        hashes.insert(std::make_pair(ps, entry));
+        hashes->set(key, entry);
 
         hashCacheDirty = true;
     }
@@ -1142,19 +1261,19 @@ void HTTPRepoGetRequest::cancel()
                 return;
             }
 
-            if (!file.get()) {
+            if (!writer) {
                 const bool ok = createOutputFile();
                 if (!ok) {
                     ioFailureOccurred = true;
                     _directory->repository()->http->cancelRequest(
                         this, "Unable to create output file:"s + pathInRepo.utf8Str());
+                    return;
                 }
             }
 
-            sha1_write(&hashContext, s, n);
-            const auto written = file->write(s, n);
-            if (written != n) {
-                SG_LOG(SG_TERRASYNC, SG_WARN, "Underflow writing to " << pathInRepo);
+            // hashing and writing happens on the worker pool; failures of
+            // earlier chunks are picked up here
+            if (!writer->write(s, n)) {
                 ioFailureOccurred = true;
                 _directory->repository()->http->cancelRequest(
                     this, "Unable to write to output file:" + pathInRepo.utf8Str());
@@ -1163,34 +1282,45 @@ void HTTPRepoGetRequest::cancel()
 
         bool createOutputFile()
         {
-            file.reset(new SGBinaryFile(pathInRepo));
+            std::unique_ptr<SGBinaryFile> file(new SGBinaryFile(pathInRepo));
             if (!file->open(SG_IO_OUT)) {
                 SG_LOG(SG_TERRASYNC, SG_WARN,
                        "unable to create file " << pathInRepo);
                 return false;
             }
 
-            sha1_init(&hashContext);
+            writer = std::make_shared<AsyncFileWriter>(
+                _directory->repository()->workerPool(), std::move(file));
             return true;
         }
 
+        /// wait for pending writes, and close the output file
+        void finishOutputFile()
+        {
+            if (writer) {
+                writer->finish();
+            }
+        }
+
         void onDone() override
         {
             const bool is200Response = (responseCode() == 200);
-            if (!file && is200Response) {
+            if (!writer && is200Response) {
                 // if the server defines a zero-byte file, we will never call
                 // gotBodyData, so create the file here
                 // this ensures all the logic below works as expected
                 createOutputFile();
             }
 
-            if (file) {
-                file->close();
-            }
+            finishOutputFile();
 
-            if (is200Response) {
-                std::string hash =
-                    strutils::encodeHex(sha1_result(&hashContext), HASH_LENGTH);
+            if (is200Response && writer && writer->failed()) {
+                pathInRepo.remove();
+                _directory->didFailToUpdateFile(fileName,
+                                                HTTPRepository::REPO_ERROR_IO,
+                                                "Unable to write to output file:"s + pathInRepo.utf8Str());
+            } else if (is200Response) {
+                std::string hash = writer ? writer->hash() : std::string();
                 _directory->didUpdateFile(fileName, hash, contentSize());
             } else if (responseCode() == 404) {
                 _directory->didFailToUpdateFile(
@@ -1220,11 +1350,8 @@ void HTTPRepoGetRequest::cancel()
             }
         }
 
-        if (file) {
-          file->close();
-        }
-
-        file.reset();
+        finishOutputFile();
+        writer.reset();
         if (pathInRepo.exists()) {
           pathInRepo.remove();
         }
@@ -1239,7 +1366,8 @@ void HTTPRepoGetRequest::cancel()
 
       void prepareForRetry() override {
         HTTP::Request::prepareForRetry();
-        file.reset();
+        finishOutputFile();
+        writer.reset();
       }
 
     private:
@@ -1250,8 +1378,7 @@ void HTTPRepoGetRequest::cancel()
 
         std::string fileName; // if empty, we're getting the directory itself
         SGPath pathInRepo;
-        simgear::sha1nfo hashContext;
-        std::unique_ptr<SGBinaryFile> file;
+        std::shared_ptr<AsyncFileWriter> writer;
 
         /// because we cancel() in the case of an IO failure, we need to a way to distinguish
         /// user initiated cancellation and IO-failure cancellation in onFail. This flag lets us do that
@@ -1392,6 +1519,17 @@ void HTTPRepoGetRequest::cancel()
         std::string _targetHash;
     };
 
+    SGJobPool& HTTPRepoPrivate::workerPool()
+    {
+        if (!workers) {
+            // never zero, AsyncFileWriter submits while holding its lock
+            const unsigned int n = std::clamp(std::thread::hardware_concurrency(), 2u, 8u);
+            workers.reset(new SGJobPool(n));
+        }
+
+        return *workers;
+    }
+
     HTTPRepoPrivate::~HTTPRepoPrivate()
     {
         // take a copy since cancelRequest will fail and hence remove
@@ -1419,6 +1557,7 @@ void HTTPRepoGetRequest::cancel()
         if (isRecheckTimeoutEnabled && dir->wasCheckedRecently()) {
             SG_LOG(SG_TERRASYNC, SG_DEBUG, "Directory " << dir->absolutePath() << " was checked recently, skipping server-side check");
             dir->updateChildrenAfterRefresh();
+            dir->releaseHashCache();
             return {};
         }
 
@@ -13,12 +13,15 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <simgear/io/HTTPClient.hxx>
 #include <simgear/misc/sg_path.hxx>
 
 #include "HTTPRepository.hxx"
 
+class SGJobPool;
+
 namespace simgear {
 
 class HTTPDirectory;
@@ -114,6 +117,13 @@ public:
   void addTask(RepoProcessTask task);
 
   std::deque<RepoProcessTask> pendingTasks;
+
+  /// moves file writes off the thread which drives the HTTP client. Created
+  /// on first use, so repositories which are never synced don't spawn any
+  /// threads
+  SGJobPool& workerPool();
+
+  std::unique_ptr<SGJobPool> workers;
 };
 
 } // namespace simgear
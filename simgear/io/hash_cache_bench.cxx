@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Benchmark the hash cache part of a repository check pass over a
+ *        synthetic tree, with text and binary .dirhash files
+ */
+
+#include <simgear_config.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/misc/sg_dir.hxx>
+#include <simgear/misc/strutils.hxx>
+#include <simgear/misc/test_timing.hxx>
+
+#include "HTTPHashCache_private.hxx"
+
+using namespace simgear;
+
+// TerraSync-like: many directories of a few dozen files each
+static const int num_dirs = 1000;
+static const int num_files = 40;
+static const int num_runs = 5;
+
+static const char* hash = "da39a3ee5e6b4b0d3255bfef95601890afd80709";
+
+struct TextEntry {
+    time_t modTime = 0;
+    size_t lengthBytes = 0;
+    std::string hashHex;
+};
+
+// What HTTPDirectory::parseHashCache() did with the text format
+static void parseText(const SGPath& cachePath, std::unordered_map<std::string, TextEntry>& hashes)
+{
+    hashes.clear();
+    sg_ifstream stream(cachePath, std::ios::in);
+    std::string buffer;
+    while (std::getline(stream, buffer)) {
+        const std::string_view line = strutils::strip_view(buffer);
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::string_view tokens[4];
+        size_t numTokens = 0;
+        for (std::string_view token : strutils::split_view(line, "*")) {
+            if (numTokens == 4)
+                break;
+            tokens[numTokens++] = strutils::strip_view(token);
+        }
+        if (numTokens < 4)
+            continue;
+
+        TextEntry entry;
+        if (!strutils::parse_number(tokens[1], entry.modTime) ||
+            !strutils::parse_number(tokens[2], entry.lengthBytes))
+            continue;
+        entry.hashHex = tokens[3];
+        hashes.emplace(std::string(tokens[0]), std::move(entry));
+    }
+}
+
+// Load each directory's cache and look up all its files, checking them
+// against their size and time on disk like HTTPDirectory does if @a validate
+static void checkText(const std::vector<SGPath>& dirs, bool validate, size_t& found)
+{
+    found = 0;
+    std::unordered_map<std::string, TextEntry> hashes;
+    for (const auto& dir : dirs) {
+        parseText(dir / ".dirhash", hashes);
+        for (int f = 0; f < num_files; ++f) {
+            SGPath p = dir / ("file" + std::to_string(f) + ".stg");
+            auto it = hashes.find(p.utf8Str());
+            if (it != hashes.end() && (!validate || (p.sizeInBytes() == it->second.lengthBytes &&
+                                                     p.modTime() == it->second.modTime))) {
+                ++found;
+            }
+        }
+    }
+}
+
+static void checkBinary(const std::vector<SGPath>& dirs, bool validate, size_t& found)
+{
+    found = 0;
+    for (const auto& dir : dirs) {
+        HTTPHashCache hashes(dir);
+        hashes.load();
+        HTTPHashCache::Entry entry;
+        for (int f = 0; f < num_files; ++f) {
+            SGPath p = dir / ("file" + std::to_string(f) + ".stg");
+            if (hashes.find(hashes.keyForPath(p), entry) &&
+                (!validate || (p.sizeInBytes() == entry.lengthBytes && p.modTime() == entry.modTime))) {
+                ++found;
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Dir top = Dir::tempDir("hash_cache_bench");
+    top.setRemoveOnDestroy();
+
+    std::vector<SGPath> dirs;
+    for (int d = 0; d < num_dirs; ++d) {
+        SGPath dir = top.file("e00" + std::to_string(d % 10) + "n50/" + std::to_string(3000000 + d));
+        Dir(dir).create(0755);
+
+        sg_ofstream cache(dir / ".dirhash", std::ios::out | std::ios::trunc | std::ios::binary);
+        cache << "#last-modified:Tue, 01 Apr 2025 10:00:00 GMT\n#last-checked:1743501600\n";
+        for (int f = 0; f < num_files; ++f) {
+            SGPath p = dir / ("file" + std::to_string(f) + ".stg");
+            sg_ofstream(p) << std::string(f * 7, 'x');
+            p.set_cached(false);
+            p.set_cached(true);
+            cache << p.utf8Str() << "*" << p.modTime() << "*" << p.sizeInBytes() << "*" << hash << "\n";
+        }
+        cache.close();
+        dirs.push_back(dir);
+    }
+
+    size_t textFound = 0, binaryFound = 0;
+    BestTime text[2], binary[2];
+    for (int run = 0; run < num_runs; ++run) {
+        text[0].run([&] { checkText(dirs, false, textFound); });
+        text[1].run([&] { checkText(dirs, true, textFound); });
+    }
+
+    // migrate
+    for (const auto& dir : dirs) {
+        HTTPHashCache hashes(dir);
+        hashes.load();
+        hashes.write();
+    }
+
+    for (int run = 0; run < num_runs; ++run) {
+        binary[0].run([&] { checkBinary(dirs, false, binaryFound); });
+        binary[1].run([&] { checkBinary(dirs, true, binaryFound); });
+    }
+
+    const double text_ms[2] = {text[0].toMSecs(), text[1].toMSecs()};
+    const double binary_ms[2] = {binary[0].toMSecs(), binary[1].toMSecs()};
+
+    std::cout << num_dirs << " directories of " << num_files << " files\n"
+              << std::fixed << std::setprecision(1)
+              << "                  lookups only   with stat()\n"
+              << "text .dirhash:   " << std::setw(8) << text_ms[0] << " ms   " << std::setw(8) << text_ms[1] << " ms\n"
+              << "binary .dirhash: " << std::setw(8) << binary_ms[0] << " ms   " << std::setw(8) << binary_ms[1] << " ms\n"
+              << "speedup:         " << std::setw(8) << text_ms[0] / std::max(binary_ms[0], 0.1) << "x    "
+              << std::setw(8) << text_ms[1] / std::max(binary_ms[1], 0.1) << "x\n";
+
+    if (textFound != size_t(num_dirs * num_files) || binaryFound != textFound) {
+        std::cerr << "results differ: " << textFound << ", " << binaryFound << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
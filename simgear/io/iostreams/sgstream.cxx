@@ -17,6 +17,7 @@
 
 #include "sgstream.hxx"
 
+#include <simgear/misc/sg_dir_cache.hxx>
 #include <simgear/misc/sg_path.hxx>
 
 using std::istream;
@@ -185,6 +186,7 @@ sg_gzofstream::open( const SGPath& name, ios_openmode io_mode )
 {
     std::string s = name.utf8Str();
     gzbuf.open( s.c_str(), io_mode );
+    simgear::DirectoryCache::instance()->invalidate(name);
 }
 
 void
@@ -236,6 +238,7 @@ sg_ofstream::sg_ofstream(const SGPath& path, ios_openmode io_mode)
 	std::string ps = path.utf8Str();
 #endif
     std::ofstream::open(ps.c_str(), io_mode);
+    simgear::DirectoryCache::instance()->invalidate(path);
 }
 
 void sg_ofstream::open( const SGPath& name, ios_openmode io_mode )
@@ -246,4 +249,5 @@ void sg_ofstream::open( const SGPath& name, ios_openmode io_mode )
 	std::string ps = name.utf8Str();
 #endif
     std::ofstream::open(ps.c_str(), io_mode);
+    simgear::DirectoryCache::instance()->invalidate(name);
 }
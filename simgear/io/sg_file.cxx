@@ -25,6 +25,7 @@
 # include <unistd.h>
 #endif
 
+#include <simgear/misc/sg_dir_cache.hxx>
 #include <simgear/misc/stdint.hxx>
 #include <simgear/debug/logstream.hxx>
 
@@ -122,6 +123,10 @@ bool SGFile::open( const SGProtocolDir d ) {
         return false;
     }
 
+    if ( get_dir() == SG_IO_OUT ) {
+        simgear::DirectoryCache::instance()->invalidate(file_name);
+    }
+
     eof_flag = false;
     return true;
 }
@@ -209,6 +214,11 @@ bool SGFile::close() {
 	return false;
     }
 
+    // the size and time of the file changed
+    if ( get_dir() == SG_IO_OUT ) {
+        simgear::DirectoryCache::instance()->invalidate(file_name);
+    }
+
     eof_flag = true;
     return true;
 }
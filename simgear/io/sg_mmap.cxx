@@ -15,6 +15,7 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 
+#include <simgear/misc/sg_dir_cache.hxx>
 #include <simgear/misc/sg_path.hxx>
 #include <simgear/misc/stdint.hxx>
 #include <simgear/debug/logstream.hxx>
@@ -128,6 +129,10 @@ bool SGMMapFile::open( const SGProtocolDir dir )
         return false;
     }
 
+    if ( get_dir() == SG_IO_OUT ) {
+        simgear::DirectoryCache::instance()->invalidate(d->file_name);
+    }
+
     // mmap
     struct stat statbuf;
     fstat(d->fp, &statbuf);
@@ -319,6 +324,9 @@ bool SGMMapFile::close()
         }
         d->eof_flag = true;
         d->fp = -1;
+        if ( get_dir() == SG_IO_OUT ) {
+            simgear::DirectoryCache::instance()->invalidate(d->file_name);
+        }
         return true;
     }
 
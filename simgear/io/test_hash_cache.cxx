@@ -0,0 +1,255 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Unit tests for the binary .dirhash cache of HTTPRepository
+ */
+
+#include <simgear_config.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/misc/sg_dir.hxx>
+#include <simgear/misc/sg_path.hxx>
+#include <simgear/misc/test_macros.hxx>
+
+#include "HTTPHashCache_private.hxx"
+
+using std::cout;
+using std::endl;
+
+using namespace simgear;
+
+static const std::string hashA = "da39a3ee5e6b4b0d3255bfef95601890afd80709";
+static const std::string hashB = "0123456789abcdef0123456789abcdef01234567";
+
+static HTTPHashCache::Entry makeEntry(time_t modTime, size_t length, const std::string& hash)
+{
+    HTTPHashCache::Entry e;
+    e.modTime = modTime;
+    e.lengthBytes = length;
+    e.hashHex = hash;
+    return e;
+}
+
+static std::string readFile(const SGPath& path)
+{
+    sg_ifstream f(path, std::ios::in | std::ios::binary);
+    return f.read_all();
+}
+
+void test_round_trip(const Dir& root)
+{
+    cout << "Testing writing and reading the binary format" << endl;
+
+    Dir dir(root.file("roundtrip"));
+    dir.create(0755);
+
+    {
+        HTTPHashCache cache(dir.path());
+        SG_VERIFY(!cache.load());
+        for (int i = 0; i < 100; ++i) {
+            cache.set("file" + std::to_string(i) + ".stg", makeEntry(1700000000 + i, i * 10, (i % 2) ? hashA : hashB));
+        }
+        cache.set("sub/.dirindex", makeEntry(1700000000, 99, hashA));
+        cache.setLastModified("Tue, 01 Apr 2025 10:00:00 GMT");
+        cache.setLastChecked(1743501600);
+        SG_VERIFY(cache.hasChanges());
+        SG_VERIFY(cache.write());
+        SG_VERIFY(!cache.hasChanges());
+        SG_CHECK_EQUAL(cache.size(), 101);
+    }
+
+    // binary, and no temporary left behind
+    SG_VERIFY(readFile(dir.file(".dirhash")).rfind("#SGDH\n", 0) == 0);
+    SG_VERIFY(!dir.file(".dirhash.new").exists());
+
+    HTTPHashCache cache(dir.path());
+    SG_VERIFY(cache.load());
+    SG_VERIFY(!cache.hasChanges());
+    SG_CHECK_EQUAL(cache.size(), 101);
+    SG_CHECK_EQUAL(cache.lastModified(), "Tue, 01 Apr 2025 10:00:00 GMT");
+    SG_CHECK_EQUAL(cache.lastChecked(), 1743501600);
+
+    HTTPHashCache::Entry e;
+    SG_VERIFY(cache.find("file7.stg", e));
+    SG_CHECK_EQUAL(e.modTime, 1700000007);
+    SG_CHECK_EQUAL(e.lengthBytes, 70);
+    SG_CHECK_EQUAL(e.hashHex, hashA);
+    SG_VERIFY(cache.find("file42.stg", e));
+    SG_CHECK_EQUAL(e.hashHex, hashB);
+    SG_VERIFY(cache.find("sub/.dirindex", e));
+    SG_CHECK_EQUAL(e.lengthBytes, 99);
+    SG_VERIFY(!cache.find("file100.stg", e));
+    SG_VERIFY(!cache.find("", e));
+
+    // lookups map the file again after a release
+    cache.release();
+    SG_VERIFY(cache.find("file0.stg", e));
+    SG_CHECK_EQUAL(e.hashHex, hashB);
+
+    SG_CHECK_EQUAL(cache.keyForPath(dir.file("file0.stg")), "file0.stg");
+    SG_CHECK_EQUAL(cache.keyForPath(dir.file("sub/.dirindex")), "sub/.dirindex");
+    SG_CHECK_EQUAL(cache.keyForPath(root.file("other/file0.stg")), root.file("other/file0.stg").utf8Str());
+}
+
+void test_changes(const Dir& root)
+{
+    cout << "Testing changing entries" << endl;
+
+    Dir dir(root.file("changes"));
+    dir.create(0755);
+
+    HTTPHashCache cache(dir.path());
+    cache.set("a", makeEntry(1, 1, hashA));
+    cache.set("b", makeEntry(2, 2, hashA));
+    cache.set("c", makeEntry(3, 3, hashA));
+    SG_VERIFY(cache.write());
+
+    // replace, remove and add, on top of the file
+    cache.set("b", makeEntry(20, 20, hashB));
+    SG_VERIFY(cache.erase("c"));
+    SG_VERIFY(!cache.erase("c"));
+    SG_VERIFY(!cache.erase("nothing"));
+    cache.set("d", makeEntry(4, 4, hashB));
+    cache.set("e", makeEntry(5, 5, hashB));
+    SG_VERIFY(cache.erase("e"));
+    SG_CHECK_EQUAL(cache.size(), 3);
+
+    HTTPHashCache::Entry e;
+    SG_VERIFY(cache.find("b", e));
+    SG_CHECK_EQUAL(e.lengthBytes, 20);
+    SG_VERIFY(!cache.find("c", e));
+    SG_VERIFY(!cache.find("e", e));
+
+    // invalid hashes aren't stored
+    cache.set("f", makeEntry(6, 6, "not-a-hash"));
+    SG_VERIFY(cache.write());
+
+    HTTPHashCache reread(dir.path());
+    SG_VERIFY(reread.load());
+    SG_CHECK_EQUAL(reread.size(), 3);
+    SG_VERIFY(reread.find("a", e));
+    SG_CHECK_EQUAL(e.modTime, 1);
+    SG_VERIFY(reread.find("b", e));
+    SG_CHECK_EQUAL(e.modTime, 20);
+    SG_CHECK_EQUAL(e.hashHex, hashB);
+    SG_VERIFY(!reread.find("c", e));
+    SG_VERIFY(reread.find("d", e));
+    SG_VERIFY(!reread.find("f", e));
+}
+
+void test_text_migration(const Dir& root)
+{
+    cout << "Testing reading the text format" << endl;
+
+    Dir dir(root.file("text"));
+    dir.create(0755);
+    const std::string prefix = dir.path().utf8Str() + "/";
+
+    {
+        sg_ofstream f(dir.file(".dirhash"));
+        f << "#last-modified:Tue, 01 Apr 2025 10:00:00 GMT\n"
+          << "#last-checked:1743501600\n"
+          << prefix << "3105.stg*1700000000*1234*" << hashA << "\n"
+          << prefix << "sub/.dirindex*1700000001*10*" << hashB << "\n"
+          << "/somewhere/else.stg*1700000002*20*" << hashB << "\n"
+          << prefix << "broken.stg*yesterday*20*" << hashB << "\n"
+          << "future-directive\n";
+    }
+
+    HTTPHashCache cache(dir.path());
+    SG_VERIFY(cache.load());
+    SG_VERIFY(cache.hasChanges());
+    SG_CHECK_EQUAL(cache.size(), 3);
+    SG_CHECK_EQUAL(cache.lastModified(), "Tue, 01 Apr 2025 10:00:00 GMT");
+    SG_CHECK_EQUAL(cache.lastChecked(), 1743501600);
+
+    HTTPHashCache::Entry e;
+    SG_VERIFY(cache.find("3105.stg", e));
+    SG_CHECK_EQUAL(e.lengthBytes, 1234);
+    SG_CHECK_EQUAL(e.hashHex, hashA);
+    SG_VERIFY(cache.find("sub/.dirindex", e));
+    SG_VERIFY(cache.find("/somewhere/else.stg", e));
+    SG_VERIFY(!cache.find("broken.stg", e));
+
+    SG_VERIFY(cache.write());
+    SG_VERIFY(readFile(dir.file(".dirhash")).rfind("#SGDH\n", 0) == 0);
+
+    // untar appends text lines to the binary file
+    {
+        sg_ofstream f(dir.file(".dirhash"), std::ios::out | std::ios::app | std::ios::binary);
+        f << prefix << "3106.stg*1700000003*30*" << hashB << "\n"
+          << prefix << "3105.stg*1700000004*40*" << hashB << "\n";
+    }
+
+    HTTPHashCache appended(dir.path());
+    SG_VERIFY(appended.load());
+    SG_VERIFY(appended.hasChanges());
+    SG_CHECK_EQUAL(appended.size(), 4);
+    SG_CHECK_EQUAL(appended.lastChecked(), 1743501600);
+    SG_VERIFY(appended.find("3106.stg", e));
+    SG_CHECK_EQUAL(e.lengthBytes, 30);
+    SG_VERIFY(appended.find("3105.stg", e));
+    SG_CHECK_EQUAL(e.lengthBytes, 40);
+    SG_VERIFY(appended.find("sub/.dirindex", e));
+}
+
+void test_invalid(const Dir& root)
+{
+    cout << "Testing damaged files" << endl;
+
+    Dir dir(root.file("invalid"));
+    dir.create(0755);
+
+    HTTPHashCache cache(dir.path());
+    for (int i = 0; i < 10; ++i) {
+        cache.set("file" + std::to_string(i), makeEntry(i, i, hashA));
+    }
+    SG_VERIFY(cache.write());
+
+    // cut off in the middle of the entries
+    const std::string data = readFile(dir.file(".dirhash"));
+    {
+        sg_ofstream f(dir.file(".dirhash"), std::ios::out | std::ios::trunc | std::ios::binary);
+        f.write(data.data(), 100);
+    }
+
+    HTTPHashCache truncated(dir.path());
+    SG_VERIFY(!truncated.load());
+    HTTPHashCache::Entry e;
+    SG_VERIFY(!truncated.find("file0", e));
+    SG_CHECK_EQUAL(truncated.size(), 0);
+
+    // and it can be written over
+    truncated.set("file0", makeEntry(1, 1, hashB));
+    SG_VERIFY(truncated.write());
+    HTTPHashCache rewritten(dir.path());
+    SG_VERIFY(rewritten.load());
+    SG_CHECK_EQUAL(rewritten.size(), 1);
+
+    // empty file
+    {
+        sg_ofstream f(dir.file(".dirhash"), std::ios::out | std::ios::trunc | std::ios::binary);
+    }
+    HTTPHashCache empty(dir.path());
+    SG_VERIFY(!empty.load());
+    SG_CHECK_EQUAL(empty.size(), 0);
+}
+
+int main(int argc, char* argv[])
+{
+    Dir root = Dir::tempDir("test_hash_cache");
+    root.setRemoveOnDestroy();
+
+    test_round_trip(root);
+    test_changes(root);
+    test_text_migration(root);
+    test_invalid(root);
+
+    cout << "all tests passed" << endl;
+    return EXIT_SUCCESS;
+}
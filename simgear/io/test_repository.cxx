@@ -38,10 +38,13 @@ std::string dataForFile(const std::string& parentName, const std::string& name,
         return {};
     }
 
+    // several body chunks, but still fits the test server's output buffer
+    const int lines = (name == "largeFile") ? 500 : 100;
+
     std::ostringstream os;
     // random content but which definitely depends on our tree location
     // and revision.
-    for (int i=0; i<100; ++i) {
+    for (int i=0; i<lines; ++i) {
         os << i << parentName << "_" << name << "_" << revision;
     }
 
@@ -542,6 +545,82 @@ void testModifyLocalFiles(HTTP::Client* cl)
     std::cout << "Passed test: identify and fix locally modified files" << std::endl;
 }
 
+void testParallelHashVerification(HTTP::Client* cl)
+{
+    const int fileCount = 12;
+    for (int i = 0; i < fileCount; ++i) {
+        global_repo->defineFile("dirE/fileE" + std::to_string(i));
+    }
+    global_repo->defineFile("dirE/largeFile");
+
+    std::unique_ptr<HTTPRepository> repo;
+    SGPath p(simgear::Dir::current().path());
+    p.append("http_repo_parallel_hash");
+    simgear::Dir pd(p);
+    if (pd.exists()) {
+        pd.removeChildren();
+    }
+
+    repo.reset(new HTTPRepository(p, cl));
+    repo->setBaseUrl("http://localhost:2000/repo");
+    repo->setRecheckTimeoutEnabled(false);
+    repo->update();
+
+    waitForUpdateComplete(cl, repo.get());
+    for (int i = 0; i < fileCount; ++i) {
+        verifyFileState(p, "dirE/fileE" + std::to_string(i));
+    }
+    verifyFileState(p, "dirE/largeFile");
+
+    // drop the hash caches, so every file has to be hashed again, and
+    // modify some files locally
+    repo.reset();
+    (p / ".dirhash").remove();
+    (p / "dirE/.dirhash").remove();
+    createFile(p, "dirE/fileE3", 5);
+    createFile(p, "dirE/fileE7", 5);
+    createFile(p, "dirE/largeFile", 5);
+
+    global_repo->clearRequestCounts();
+    repo.reset(new HTTPRepository(p, cl));
+    repo->setBaseUrl("http://localhost:2000/repo");
+    repo->setRecheckTimeoutEnabled(false);
+    repo->update();
+    waitForUpdateComplete(cl, repo.get());
+
+    for (int i = 0; i < fileCount; ++i) {
+        verifyFileState(p, "dirE/fileE" + std::to_string(i));
+    }
+    verifyFileState(p, "dirE/largeFile");
+    verifyRequestCount("dirE", 0);
+    verifyRequestCount("dirE/fileE0", 0);
+    verifyRequestCount("dirE/fileE3", 1);
+    verifyRequestCount("dirE/fileE7", 1);
+    verifyRequestCount("dirE/fileE11", 0);
+    verifyRequestCount("dirE/largeFile", 1);
+
+    // hash cache updates are batched, and flushed at the latest when the
+    // repository is destroyed
+    repo.reset();
+    if (!(p / "dirE/.dirhash").exists()) {
+        throw sg_exception("Hash cache not written");
+    }
+
+    // a further update must be satisfied entirely from the hash cache
+    global_repo->clearRequestCounts();
+    repo.reset(new HTTPRepository(p, cl));
+    repo->setBaseUrl("http://localhost:2000/repo");
+    repo->setRecheckTimeoutEnabled(false);
+    repo->update();
+    waitForUpdateComplete(cl, repo.get());
+    verifyRequestCount("dirE/fileE3", 0);
+    verifyRequestCount("dirE/largeFile", 0);
+
+    global_repo->removeChild("dirE");
+
+    std::cout << "Passed test: parallel hash verification and write-behind" << std::endl;
+}
+
 
 void testMergeExistingFileWithoutDownload(HTTP::Client* cl)
 {
@@ -941,6 +1020,8 @@ int main(int argc, char* argv[])
 
     testModifyLocalFiles(&cl);
 
+    testParallelHashVerification(&cl);
+
     testLossOfLocalFiles(&cl);
 
     testMergeExistingFileWithoutDownload(&cl);
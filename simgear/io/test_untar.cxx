@@ -8,7 +8,11 @@
 #include <simgear_config.h>
 #include <simgear/compiler.h>
 
+#include <algorithm>
 #include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
 
 #include "untar.hxx"
 
@@ -16,6 +20,7 @@
 #include <simgear/misc/sg_path.hxx>
 #include <simgear/misc/sg_dir.hxx>
 #include <simgear/io/sg_file.hxx>
+#include <simgear/io/iostreams/sgstream.hxx>
 
 
 using std::cout;
@@ -205,6 +210,150 @@ void testExtractXZ()
     SG_VERIFY((extractDir / "testDir/foo.txt").exists());
 }
 
+// relative path -> contents of all files below dir
+static void readTree(const SGPath& dir, const std::string& prefix, std::map<std::string, std::string>& result)
+{
+    for (const auto& c : simgear::Dir(dir).children(Dir::TYPE_FILE | Dir::TYPE_DIR | Dir::NO_DOT_OR_DOTDOT | Dir::INCLUDE_HIDDEN)) {
+        if (c.isDir()) {
+            readTree(c, prefix + c.file() + "/", result);
+        } else {
+            sg_ifstream f(c, std::ios::in | std::ios::binary);
+            result[prefix + c.file()] = f.read_all();
+        }
+    }
+}
+
+static bool extract(const std::string& archive, const SGPath& extractDir, unsigned int numWriters,
+                    bool dirHashes = false)
+{
+    SGPath p = SGPath(std::string{SRC_DIR});
+    p.append(archive);
+
+    SGBinaryFile f(p);
+    f.open(SG_IO_IN);
+
+    simgear::Dir pd(extractDir);
+    pd.removeChildren();
+
+    ArchiveExtractor ex(extractDir);
+    ex.setNumWriterThreads(numWriters);
+    ex.setCreateDirHashEntries(dirHashes);
+
+    uint8_t* buf = (uint8_t*)alloca(1000);
+    while (!f.eof()) {
+        size_t bufSize = f.read((char*)buf, 1000);
+        ex.extractBytes(buf, bufSize);
+    }
+
+    ex.flush();
+    return ex.isAtEndOfArchive() && !ex.hasError();
+}
+
+class ThrowingExtractor : public ArchiveExtractor
+{
+public:
+    using ArchiveExtractor::ArchiveExtractor;
+
+protected:
+    PathResult filterPath(std::string& pathToExtract) override
+    {
+        if (pathToExtract.find("foo.txt") != std::string::npos) {
+            throw std::runtime_error("filter failed");
+        }
+        return Accepted;
+    }
+};
+
+void testParallelExtract()
+{
+    cout << "Testing parallel extraction" << endl;
+
+    SG_CHECK_EQUAL(ArchiveExtractor(SGPath()).numWriterThreads(), 0u);
+
+    for (const char* archive : {"test.tar.gz", "test2.tar", "test.tar.xz", "badTar.tgz", "zippy.zip"}) {
+        SGPath serialDir = simgear::Dir::current().path() / "test_extract_serial";
+        SGPath parallelDir = simgear::Dir::current().path() / "test_extract_parallel";
+        SG_VERIFY(extract(archive, serialDir, 0));
+        SG_VERIFY(extract(archive, parallelDir, 3));
+
+        std::map<std::string, std::string> serial, parallel;
+        readTree(serialDir, "", serial);
+        readTree(parallelDir, "", parallel);
+        SG_VERIFY(!serial.empty());
+        SG_CHECK_EQUAL(serial.size(), parallel.size());
+        SG_VERIFY(serial == parallel);
+    }
+
+    // .dirhash entries, written by several threads
+    SGPath hashDir = simgear::Dir::current().path() / "test_extract_dirhash";
+    SG_VERIFY(extract("test.tar.gz", hashDir, 3, true));
+    std::map<std::string, std::string> files;
+    readTree(hashDir / "testDir", "", files);
+    SG_VERIFY(files.count(".dirhash"));
+    const std::string dirHash = files[".dirhash"];
+    files.erase(".dirhash");
+    for (const auto& f : files) {
+        SG_VERIFY(dirHash.find((hashDir / "testDir" / f.first).utf8Str() + "*") != std::string::npos);
+    }
+    SG_CHECK_EQUAL(static_cast<size_t>(std::count(dirHash.begin(), dirHash.end(), '\n')), files.size());
+
+    // a file which can't be created is an error
+    SGPath blockedDir = simgear::Dir::current().path() / "test_extract_blocked";
+    for (unsigned int numWriters : {0u, 3u}) {
+        simgear::Dir(blockedDir).removeChildren();
+        simgear::Dir(blockedDir / "testDir/hello.c").create(0755);
+
+        SGPath p = SGPath(std::string{SRC_DIR});
+        p.append("test.tar.gz");
+        SGBinaryFile f(p);
+        f.open(SG_IO_IN);
+
+        ArchiveExtractor ex(blockedDir);
+        ex.setNumWriterThreads(numWriters);
+        uint8_t* buf = (uint8_t*)alloca(1000);
+        while (!f.eof()) {
+            size_t bufSize = f.read((char*)buf, 1000);
+            ex.extractBytes(buf, bufSize);
+        }
+        ex.flush();
+        SG_VERIFY(ex.hasError());
+        SG_VERIFY((blockedDir / "testDir/foo.txt").exists());
+    }
+
+    // exceptions are thrown by extractBytes(), or by flush() with writers
+    SGPath throwDir = simgear::Dir::current().path() / "test_extract_throw";
+    for (unsigned int numWriters : {0u, 3u}) {
+        simgear::Dir(throwDir).removeChildren();
+
+        SGPath p = SGPath(std::string{SRC_DIR});
+        p.append("test.tar.gz");
+        SGBinaryFile f(p);
+        f.open(SG_IO_IN);
+
+        ThrowingExtractor ex(throwDir);
+        ex.setNumWriterThreads(numWriters);
+        bool thrownByExtract = false, thrownByFlush = false;
+        uint8_t* buf = (uint8_t*)alloca(1000);
+        try {
+            while (!f.eof()) {
+                size_t bufSize = f.read((char*)buf, 1000);
+                ex.extractBytes(buf, bufSize);
+            }
+        } catch (const std::runtime_error&) {
+            thrownByExtract = true;
+        }
+        try {
+            ex.flush();
+        } catch (const std::runtime_error&) {
+            thrownByFlush = true;
+        }
+        SG_CHECK_EQUAL(thrownByExtract, numWriters == 0);
+        SG_CHECK_EQUAL(thrownByFlush, numWriters > 0);
+        SG_VERIFY(ex.hasError());
+        SG_VERIFY(!ex.isAtEndOfArchive());
+    }
+}
+
 int main(int ac, char ** av)
 {
     testTarGz();
@@ -213,6 +362,7 @@ int main(int ac, char ** av)
 	testExtractStreamed();
 	testExtractZip();
     testExtractXZ();
+    testParallelExtract();
 
     // disabled to avoiding checking in large PAX archive
     // testPAXAttributes();
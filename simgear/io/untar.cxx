@@ -6,22 +6,31 @@
 #include "untar.hxx"
 
 #include <algorithm>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdlib>
 #include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
 #include <stdint.h>
+#include <thread>
+#include <vector>
 
 #include <zlib.h>
 
 #include <simgear/sg_inlines.h>
 #include <simgear/io/sg_file.hxx>
 #include <simgear/misc/sg_dir.hxx>
+#include <simgear/misc/sg_hash.hxx>
 #include <simgear/misc/strutils.hxx>
 
 #include <simgear/io/iostreams/sgstream.hxx>
 #include <simgear/debug/logstream.hxx>
 #include <simgear/package/unzip.h>
 #include <simgear/structure/exception.hxx>
+#include <simgear/threads/SGJobPool.hxx>
 
 #include "ArchiveExtractor_private.hxx"
 #include "simgear/debug/debug_types.h"
@@ -82,6 +91,428 @@ typedef struct
 
     /* tar Header Block, from POSIX 1003.1-1990.  */
 
+    ///////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // data handed between the threads of a parallel extraction
+    const size_t EXTRACT_CHUNK_SIZE = 256 * 1024;       ///< coalesce small pieces up to this
+    const size_t EXTRACT_MAX_QUEUED_BYTES = 16 * 1024 * 1024; ///< per stage, before the producer waits
+
+    /**
+     * A thread consuming chunks of bytes in order, fed through a bounded
+     * queue. An exception thrown by the consumer ends the processing; it
+     * is rethrown by finish().
+     */
+    class ExtractStage
+    {
+    public:
+        using Consumer = std::function<void(const char* bytes, size_t count)>;
+
+        explicit ExtractStage(Consumer consumer) : _consumer(std::move(consumer)),
+                                                   _thread(&ExtractStage::run, this)
+        {
+        }
+
+        ~ExtractStage()
+        {
+            stop(false);
+        }
+
+        void push(const char* bytes, size_t count)
+        {
+            std::unique_lock<std::mutex> g(_lock);
+            _space.wait(g, [this] { return (_queuedBytes < EXTRACT_MAX_QUEUED_BYTES) || _stopping; });
+            if (_stopping || _error) {
+                return;
+            }
+
+            if (!_queue.empty() && (_queue.back().size() + count <= EXTRACT_CHUNK_SIZE)) {
+                _queue.back().append(bytes, count);
+            } else {
+                _queue.emplace_back(bytes, count);
+            }
+            _queuedBytes += count;
+            _ready.notify_one();
+        }
+
+        /// Process everything queued and end the thread
+        void finish()
+        {
+            stop(true);
+            if (_error) {
+                auto e = _error;
+                _error = nullptr;
+                std::rethrow_exception(e);
+            }
+        }
+
+    private:
+        void stop(bool drain)
+        {
+            {
+                std::lock_guard<std::mutex> g(_lock);
+                _stopping = true;
+                if (!drain) {
+                    _queue.clear();
+                    _queuedBytes = 0;
+                }
+            }
+            _ready.notify_one();
+            _space.notify_all();
+            if (_thread.joinable()) {
+                _thread.join();
+            }
+        }
+
+        void run()
+        {
+            for (;;) {
+                std::string chunk;
+                bool drop;
+                {
+                    std::unique_lock<std::mutex> g(_lock);
+                    _ready.wait(g, [this] { return !_queue.empty() || _stopping; });
+                    if (_queue.empty()) {
+                        return;
+                    }
+
+                    chunk = std::move(_queue.front());
+                    _queue.pop_front();
+                    _queuedBytes -= chunk.size();
+                    drop = (_error != nullptr);
+                }
+                _space.notify_one();
+                if (drop) {
+                    continue; // after an error, discard the rest
+                }
+
+                try {
+                    _consumer(chunk.data(), chunk.size());
+                } catch (...) {
+                    std::lock_guard<std::mutex> g(_lock);
+                    _error = std::current_exception();
+                }
+            }
+        }
+
+        Consumer _consumer;
+        std::mutex _lock;
+        std::condition_variable _ready, _space;
+        std::deque<std::string> _queue;
+        size_t _queuedBytes = 0;
+        bool _stopping = false;
+        std::exception_ptr _error;
+        std::thread _thread; // last: starts running in the constructor
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+     * Creates and writes the extracted files, one at a time on the calling
+     * thread or on a pool of writer threads. The data of a file always goes
+     * to the same lane, picked by its path, and the jobs of a lane are run
+     * in order by one writer at a time, so files are written in the order
+     * of the archive even if it holds a path twice; directories are created
+     * by the caller beforehand.
+     */
+    class ExtractWriters
+    {
+    public:
+        ExtractWriters(unsigned int numThreads, bool createDirHashes) : _lanes(numThreads),
+                                                                         _createDirHashes(createDirHashes)
+        {
+            if (numThreads > 0) {
+                _pool.reset(new SGJobPool(numThreads));
+            }
+        }
+
+        ~ExtractWriters()
+        {
+            {
+                std::lock_guard<std::mutex> g(_lock);
+                _quit = true;
+                for (auto& lane : _lanes) {
+                    _queuedJobs -= lane.jobs.size();
+                    lane.jobs.clear();
+                }
+                _queuedBytes = 0;
+            }
+            _space.notify_all();
+
+            // runs the drain jobs still queued, which find their lanes empty
+            _pool.reset();
+        }
+
+        void open(const SGPath& path)
+        {
+            if (_current) {
+                close(false);
+            }
+
+            _current = std::make_shared<OutputFile>(path);
+            _pendingOpen = true;
+            _currentLane = _lanes.empty() ? nullptr : &_lanes[std::hash<std::string>()(path.utf8Str()) % _lanes.size()];
+        }
+
+        void write(const char* bytes, size_t count)
+        {
+            if (!_current) {
+                return;
+            }
+
+            _pending.append(bytes, count);
+            if (_pending.size() >= EXTRACT_CHUNK_SIZE) {
+                submit(false, false);
+            }
+        }
+
+        /// @param complete whether the whole file was written, and gets a .dirhash entry
+        void close(bool complete)
+        {
+            if (_current) {
+                submit(true, complete);
+                _current.reset();
+            }
+        }
+
+        bool isWriting() const { return _current != nullptr; }
+
+        /// Wait for all files to be written. @return false if any of them failed
+        bool wait()
+        {
+            std::unique_lock<std::mutex> g(_lock);
+            _idle.wait(g, [this] { return (_queuedJobs == 0) && (_busy == 0); });
+            return !_failed;
+        }
+
+    private:
+        struct OutputFile {
+            explicit OutputFile(const SGPath& p) : path(p), file(p) {}
+
+            SGPath path;
+            SGBinaryFile file;
+            sha1nfo hash;
+            bool ok = true;
+        };
+
+        struct Job {
+            std::shared_ptr<OutputFile> file;
+            std::string data;
+            bool open = false;
+            bool close = false;
+            bool complete = false;
+        };
+
+        struct Lane {
+            std::deque<Job> jobs;
+            bool draining = false;
+        };
+
+        void submit(bool close, bool complete)
+        {
+            Job job;
+            job.file = _current;
+            job.data.swap(_pending);
+            job.open = _pendingOpen;
+            job.close = close;
+            job.complete = complete;
+            _pendingOpen = false;
+
+            if (!_currentLane) {
+                process(job);
+                return;
+            }
+
+            Lane* lane = _currentLane;
+            {
+                std::unique_lock<std::mutex> g(_lock);
+                _space.wait(g, [this] { return (_queuedBytes < EXTRACT_MAX_QUEUED_BYTES) || _quit; });
+                _queuedBytes += job.data.size();
+                ++_queuedJobs;
+                lane->jobs.push_back(std::move(job));
+                if (lane->draining) {
+                    return;
+                }
+                lane->draining = true;
+            }
+            _pool->submit([this, lane] { drain(*lane); });
+        }
+
+        /// runs the queued jobs of a lane, on one writer thread at a time
+        void drain(Lane& lane)
+        {
+            std::unique_lock<std::mutex> g(_lock);
+            while (!lane.jobs.empty()) {
+                Job job = std::move(lane.jobs.front());
+                lane.jobs.pop_front();
+                --_queuedJobs;
+                ++_busy;
+                _queuedBytes -= job.data.size();
+                _space.notify_one();
+
+                g.unlock();
+                process(job);
+                g.lock();
+
+                --_busy;
+            }
+
+            lane.draining = false;
+            if ((_queuedJobs == 0) && (_busy == 0)) {
+                _idle.notify_all();
+            }
+        }
+
+        void process(Job& job)
+        {
+            OutputFile& f = *job.file;
+            if (job.open) {
+                sha1_init(&f.hash);
+                if (!f.file.open(SG_IO_OUT)) {
+                    SG_LOG(SG_IO, SG_WARN, "ArchiveExtractor: failed to create " << f.path);
+                    f.ok = false;
+                }
+            }
+
+            if (f.ok && !job.data.empty()) {
+                if (f.file.write(job.data.data(), job.data.size()) != static_cast<int>(job.data.size())) {
+                    SG_LOG(SG_IO, SG_WARN, "ArchiveExtractor: failed to write " << f.path);
+                    f.ok = false;
+                }
+                sha1_write(&f.hash, job.data.data(), job.data.size());
+            }
+
+            if (job.close) {
+                f.file.close();
+                if (!f.ok) {
+                    std::lock_guard<std::mutex> g(_lock);
+                    _failed = true;
+                } else if (job.complete && _createDirHashes) {
+                    writeDirHashEntry(f);
+                }
+            }
+        }
+
+        void writeDirHashEntry(OutputFile& f)
+        {
+            std::string hashBytes((char*)sha1_result(&f.hash), HASH_LENGTH);
+
+            // a new path, so the time and size come from one stat() of
+            // the file as written
+            const SGPath path = SGPath::fromUtf8(f.path.utf8Str());
+
+            // files of one directory may be written by several threads
+            static std::mutex dirHashLock;
+            std::lock_guard<std::mutex> g(dirHashLock);
+
+            // this code has to match the text format read by HTTPHashCache
+            SGPath cachePath = path.dirPath() / ".dirhash";
+            sg_ofstream stream(cachePath, std::ios::out | std::ios::app | std::ios::binary);
+            stream << path.utf8Str() << "*" << path.modTime() << "*"
+                   << path.sizeInBytes() << "*" << strutils::encodeHex(hashBytes) << "\n";
+        }
+
+        std::vector<Lane> _lanes;
+        const bool _createDirHashes;
+
+        std::mutex _lock;
+        std::condition_variable _space, _idle;
+        size_t _queuedBytes = 0;
+        size_t _queuedJobs = 0;
+        unsigned int _busy = 0;
+        bool _failed = false;
+        bool _quit = false;
+
+        // the file being extracted, on the parsing thread
+        std::shared_ptr<OutputFile> _current;
+        Lane* _currentLane = nullptr;
+        std::string _pending;
+        bool _pendingOpen = false;
+
+        std::unique_ptr<SGJobPool> _pool; // last: its jobs use the members above
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////
+
+    ArchiveExtractorPrivate::ArchiveExtractorPrivate(ArchiveExtractor* o) : outer(o)
+    {
+        assert(outer);
+        _writers.reset(new ExtractWriters(outer->numWriterThreads(), outer->_doCreateDirHashes));
+    }
+
+    ArchiveExtractorPrivate::~ArchiveExtractorPrivate() = default;
+
+    bool ArchiveExtractorPrivate::isParallel() const
+    {
+        return outer->numWriterThreads() > 0;
+    }
+
+    void ArchiveExtractorPrivate::startStages()
+    {
+        if (isParallel() && isCompressed()) {
+            _inflateStage.reset(new ExtractStage([this](const char* bytes, size_t count) {
+                extractBytes(reinterpret_cast<const uint8_t*>(bytes), count);
+            }));
+        }
+    }
+
+    void ArchiveExtractorPrivate::feed(const uint8_t* bytes, size_t count)
+    {
+        if (!_started) {
+            _started = true;
+            startStages();
+        }
+
+        if (_inflateStage) {
+            _inflateStage->push(reinterpret_cast<const char*>(bytes), count);
+            return;
+        }
+
+        try {
+            extractBytes(bytes, count);
+        } catch (...) {
+            if (state < ERROR_STATE) {
+                state = BAD_DATA;
+            }
+            throw;
+        }
+    }
+
+    void ArchiveExtractorPrivate::finish()
+    {
+        std::exception_ptr error;
+        try {
+            if (_inflateStage) {
+                auto stage = std::move(_inflateStage);
+                stage->finish();
+            }
+
+            flush();
+            finishStages(true);
+        } catch (...) {
+            // let the writers finish before passing the error on
+            error = std::current_exception();
+            finishStages(false);
+            if (state < ERROR_STATE) {
+                state = BAD_DATA;
+            }
+        }
+
+        if (!_writers->wait() && (state < ERROR_STATE)) {
+            state = BAD_DATA;
+        }
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    void ArchiveExtractorPrivate::shutdown()
+    {
+        _inflateStage.reset();
+        finishStages(false);
+        _writers.reset();
+    }
+
 
     class TarExtractorPrivate : public ArchiveExtractorPrivate
     {
@@ -92,7 +523,6 @@ typedef struct
         };
 
         size_t bytesRemaining;
-        std::unique_ptr<SGFile> currentFile;
         size_t currentFileSize; ///< if we're in READING_GNU_LONGNAME, this is
                                 ///< the name length
 
@@ -103,6 +533,9 @@ typedef struct
 
         std::string gnuLongName;
 
+        /// header parsing and file creation, when extracting in parallel
+        std::unique_ptr<ExtractStage> parseStage;
+
         TarExtractorPrivate(ArchiveExtractor* o) : ArchiveExtractorPrivate(o)
         {
             setState(TarExtractorPrivate::READING_HEADER);
@@ -110,6 +543,41 @@ typedef struct
 
         ~TarExtractorPrivate() = default;
 
+        void startStages() override
+        {
+            ArchiveExtractorPrivate::startStages();
+            if (isParallel()) {
+                parseStage.reset(new ExtractStage([this](const char* bytes, size_t count) {
+                    try {
+                        processBytes(bytes, count);
+                    } catch (...) {
+                        setState(BAD_DATA);
+                        throw;
+                    }
+                }));
+            }
+        }
+
+        void finishStages(bool drain) override
+        {
+            if (parseStage) {
+                auto stage = std::move(parseStage);
+                if (drain) {
+                    stage->finish();
+                }
+            }
+        }
+
+        /// pass decompressed bytes on to the parsing stage, or parse them here
+        void deliverBytes(const char* bytes, size_t count)
+        {
+            if (parseStage) {
+                parseStage->push(bytes, count);
+            } else {
+                processBytes(bytes, count);
+            }
+        }
+
         void readPaddingIfRequired()
         {
             size_t pad = currentFileSize % TAR_HEADER_BLOCK_SIZE;
@@ -128,11 +596,7 @@ typedef struct
             }
 
             if (state == READING_FILE) {
-                if (currentFile) {
-                    currentFile->close();
-                    writeDirHashEntry();
-                    currentFile.reset();
-                }
+                writers().close(true);
                 readPaddingIfRequired();
             } else if (state == READING_HEADER) {
                 processHeader();
@@ -164,8 +628,7 @@ typedef struct
 
             if (newState >= ERROR_STATE) {
                 SG_LOG(SG_IO, SG_WARN, "ArchiveExtract entered error state");
-                currentFile->close();
-                currentFile.reset();
+                writers().close(false);
             }
 
             state = newState;
@@ -174,7 +637,7 @@ typedef struct
         void extractBytes(const uint8_t* bytes, size_t count) override
         {
             // uncompressed, just pass through directly
-            processBytes((const char*)bytes, count);
+            deliverBytes((const char*)bytes, count);
         }
 
         void flush() override
@@ -182,26 +645,6 @@ typedef struct
             // no-op for tar files, we process everything greedily
         }
 
-        void writeDirHashEntry()
-        {
-            if (!doCreateDirHashes()) {
-                return;
-            }
-
-            std::string hashBytes((char*)sha1_result(&hashState), HASH_LENGTH);
-            SGPath path = currentFile->get_path();
-
-            // force a stat call
-            path.set_cached(false);
-            path.set_cached(true);
-
-            // this code has to match the main version in HTTPRepository.cxx
-            SGPath cachePath = path.dirPath() / ".dirhash";
-            sg_ofstream stream(cachePath, std::ios::out | std::ios::app | std::ios::binary);
-            stream << path.utf8Str() << "*" << path.modTime() << "*"
-                   << path.sizeInBytes() << "*" << strutils::encodeHex(hashBytes) << "\n";
-        }
-
         void processHeader()
         {
             if (headerIsAllZeros()) {
@@ -293,9 +736,7 @@ typedef struct
                 currentFileSize = ::strtol(header.size, NULL, 8);
                 bytesRemaining = currentFileSize;
                 if (!skipCurrentEntry) {
-                    currentFile.reset(new SGBinaryFile(p));
-                    currentFile->open(SG_IO_OUT);
-                    sha1_init(&hashState);
+                    writers().open(p);
                 }
                 setState(READING_FILE);
                 mostRecentPath = p;
@@ -322,35 +763,34 @@ typedef struct
 
         void processBytes(const char* bytes, size_t count)
         {
-            if ((state >= ERROR_STATE) || (state == END_OF_ARCHIVE)) {
-                return;
-            }
+            while (count > 0) {
+                if ((state >= ERROR_STATE) || (state == END_OF_ARCHIVE)) {
+                    return;
+                }
 
-            size_t curBytes = std::min(bytesRemaining, count);
-            if (state == READING_FILE) {
-                if (currentFile) {
-                    currentFile->write(bytes, curBytes);
-                    sha1_write(&hashState, bytes, curBytes);
+                size_t curBytes = std::min(bytesRemaining, count);
+                if (state == READING_FILE) {
+                    writers().write(bytes, curBytes);
+                    bytesRemaining -= curBytes;
+                } else if ((state == READING_HEADER) || (state == PRE_END_OF_ARCHVE) || (state == END_OF_ARCHIVE)) {
+                    memcpy(headerPtr, bytes, curBytes);
+                    bytesRemaining -= curBytes;
+                    headerPtr += curBytes;
+                } else if (state == READING_PADDING) {
+                    bytesRemaining -= curBytes;
+                } else if ((state == READING_PAX_FILE_ATTRIBUTES) || (state == READING_PAX_GLOBAL_ATTRIBUTES)) {
+                    bytesRemaining -= curBytes;
+                    paxAttributes.append(bytes, curBytes);
+                } else if (state == READING_GNU_LONGNAME) {
+                  bytesRemaining -= curBytes;
+                  gnuLongName.append(bytes, curBytes);
                 }
-                bytesRemaining -= curBytes;
-            } else if ((state == READING_HEADER) || (state == PRE_END_OF_ARCHVE) || (state == END_OF_ARCHIVE)) {
-                memcpy(headerPtr, bytes, curBytes);
-                bytesRemaining -= curBytes;
-                headerPtr += curBytes;
-            } else if (state == READING_PADDING) {
-                bytesRemaining -= curBytes;
-            } else if ((state == READING_PAX_FILE_ATTRIBUTES) || (state == READING_PAX_GLOBAL_ATTRIBUTES)) {
-                bytesRemaining -= curBytes;
-                paxAttributes.append(bytes, curBytes);
-            } else if (state == READING_GNU_LONGNAME) {
-              bytesRemaining -= curBytes;
-              gnuLongName.append(bytes, curBytes);
-            }
 
-            checkEndOfState();
-            if (count > curBytes) {
-                // recurse with unprocessed bytes
-                processBytes(bytes + curBytes, count - curBytes);
+                checkEndOfState();
+
+                // continue with unprocessed bytes
+                bytes += curBytes;
+                count -= curBytes;
             }
         }
 
@@ -471,7 +911,7 @@ public:
 
             writtenSize = ZLIB_DECOMPRESS_BUFFER_SIZE - zlibStream.avail_out;
             if (writtenSize > 0) {
-                processBytes((const char*)zlibOutput, writtenSize);
+                deliverBytes((const char*)zlibOutput, writtenSize);
             }
 
             if (result == Z_STREAM_END) {
@@ -480,6 +920,9 @@ public:
         } while ((zlibStream.avail_in > 0) || (writtenSize > 0));
     }
 
+protected:
+    bool isCompressed() const override { return true; }
+
 private:
     z_stream zlibStream;
     uint8_t* zlibOutput;
@@ -528,16 +971,18 @@ public:
 
             writtenSize = ZLIB_DECOMPRESS_BUFFER_SIZE - _xzStream.avail_out;
             if (writtenSize > 0) {
-                processBytes((const char*)_outputBuffer, writtenSize);
+                deliverBytes((const char*)_outputBuffer, writtenSize);
             }
 
+            // only the parsing side may touch the file being written: just
+            // set the state from here
             if (ret == LZMA_GET_CHECK) {
                 //
             } else if (ret == LZMA_STREAM_END) {
-                setState(END_OF_ARCHIVE);
+                _streamEnded = true;
                 break;
             } else if (ret != LZMA_OK) {
-                setState(BAD_ARCHIVE);
+                state = BAD_ARCHIVE;
                 break;
             }
         } while ((_xzStream.avail_in > 0) || (writtenSize > 0));
@@ -547,13 +992,27 @@ public:
     {
         const auto ret = lzma_code(&_xzStream, LZMA_FINISH);
         if (ret != LZMA_STREAM_END) {
-            setState(BAD_ARCHIVE);
+            state = BAD_ARCHIVE;
+        }
+    }
+
+protected:
+    bool isCompressed() const override { return true; }
+
+    void finishStages(bool drain) override
+    {
+        TarExtractorPrivate::finishStages(drain);
+
+        // once everything before it was parsed
+        if (_streamEnded && (state < ERROR_STATE)) {
+            setState(END_OF_ARCHIVE);
         }
     }
 
 private:
     lzma_stream _xzStream;
     uint8_t* _outputBuffer = nullptr;
+    bool _streamEnded = false;
 };
 
 #endif
@@ -674,7 +1133,6 @@ public:
 			throw sg_io_exception("opening current zip file failed", sg_location(name));
 		}
 
-		sg_ofstream outFile;
 		bool eof = false;
 		SGPath path = extractRootPath() / name;
         mostRecentPath = name;
@@ -688,25 +1146,23 @@ public:
             }
 		}
 
-		outFile.open(path, std::ios::binary | std::ios::trunc | std::ios::out);
-		if (outFile.fail()) {
-			throw sg_io_exception("failed to open output file for writing:" + strutils::error_string(errno), path);
-		}
-
+		// inflated here, written by the writer threads if there are any
+		writers().open(path);
 		while (!eof) {
 			int bytes = unzReadCurrentFile(zip, buffer, bufferSize);
 			if (bytes < 0) {
+                writers().close(false);
                 throw sg_io_exception("unzip failure reading current archive", sg_location(name));
             }
 			else if (bytes == 0) {
 				eof = true;
 			}
 			else {
-				outFile.write(buffer, bytes);
+				writers().write(buffer, bytes);
 			}
 		}
 
-		outFile.close();
+		writers().close(true);
 		unzCloseCurrentFile(zip);
 	}
 };
@@ -718,7 +1174,13 @@ ArchiveExtractor::ArchiveExtractor(const SGPath& rootPath) :
 {
 }
 
-ArchiveExtractor::~ArchiveExtractor() = default;
+ArchiveExtractor::~ArchiveExtractor()
+{
+    if (d) {
+        // before the decompression buffers of the derived classes go away
+        d->shutdown();
+    }
+}
 
 void ArchiveExtractor::extractBytes(const uint8_t* bytes, size_t count)
 {
@@ -745,7 +1207,7 @@ void ArchiveExtractor::extractBytes(const uint8_t* bytes, size_t count)
 
         // if hit here, we created the extractor. Feed the prefbuffer
 		// bytes through it
-		d->extractBytes((uint8_t*) _prebuffer.data(), _prebuffer.size());
+		d->feed((uint8_t*) _prebuffer.data(), _prebuffer.size());
 		_prebuffer.clear();
 		return;
 	}
@@ -754,7 +1216,7 @@ void ArchiveExtractor::extractBytes(const uint8_t* bytes, size_t count)
         return;
     }
 
-	d->extractBytes(bytes, count);
+	d->feed(bytes, count);
 }
 
 void ArchiveExtractor::flush()
@@ -762,7 +1224,7 @@ void ArchiveExtractor::flush()
 	if (!d)
 		return;
 
-	d->flush();
+	d->finish();
 }
 
 bool ArchiveExtractor::isAtEndOfArchive() const
@@ -891,6 +1353,19 @@ void ArchiveExtractor::setCreateDirHashEntries(bool doCreate)
     _doCreateDirHashes = doCreate;
 }
 
+void ArchiveExtractor::setNumWriterThreads(unsigned int numWriters)
+{
+    _numWriterThreads = numWriters;
+}
+
+unsigned int ArchiveExtractor::suggestedNumWriterThreads()
+{
+    // a writer thread per CPU beyond the two decompressing and parsing
+    // ones, but at least one of them; nothing to overlap on a single CPU
+    const unsigned int cpus = std::thread::hardware_concurrency();
+    return (cpus > 1) ? std::clamp(cpus - 2, 1u, 4u) : 0;
+}
+
 void ArchiveExtractor::setRemoveTopmostDirectory(bool doRemove)
 {
     _removeTopmostDir = doRemove;
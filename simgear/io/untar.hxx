@@ -67,11 +67,38 @@ public:
 
     void setCreateDirHashEntries(bool doCreate);
 
-    SGPath mostRecentExtractedPath() const;
+    /**
+     * Extract in parallel: one thread decompresses, another parses the
+     * archive, and @a numWriters threads create and write the files, while
+     * extractBytes() only queues the data. flush() waits for all of them.
+     * Must be set before the first call to extractBytes(). The default,
+     * zero, extracts everything on the calling thread.
+     *
+     * When extracting in parallel, errors are reported by flush(): an
+     * exception thrown while processing the data, such as by filterPath(),
+     * is rethrown there rather than by extractBytes(), and the rest of the
+     * archive is skipped.
+     */
+    void setNumWriterThreads(unsigned int numWriters);
+
+    unsigned int numWriterThreads() const
+    {
+        return _numWriterThreads;
+    }
 
-protected:
+    /// Number of writer threads worth using on this machine, zero on a single CPU
+    static unsigned int suggestedNumWriterThreads();
 
+    SGPath mostRecentExtractedPath() const;
 
+protected:
+    /**
+     * Decide whether to extract an entry of the archive, and possibly
+     * rename it. Called for each entry in the order of the archive. With
+     * writer threads, tar archives are parsed on a thread of their own, so
+     * an override may run concurrently with the thread calling
+     * extractBytes() and must lock any state it shares with it.
+     */
     virtual PathResult filterPath(std::string& pathToExtract);
 
 
@@ -86,6 +113,7 @@ private:
 	bool _invalidDataType = false;
     bool _doCreateDirHashes = false;
     bool _removeTopmostDir = false;
+    unsigned int _numWriterThreads = 0;
 };
 
 } // of namespace simgear
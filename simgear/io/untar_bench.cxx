@@ -0,0 +1,164 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Benchmark ArchiveExtractor throughput with and without writer
+ *        threads, on the bundled test archive scaled up to a tile-sized one
+ */
+
+#include <simgear_config.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <zlib.h>
+
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/misc/sg_dir.hxx>
+#include <simgear/misc/test_timing.hxx>
+
+#include "untar.hxx"
+
+using namespace simgear;
+
+// copies of the archive's contents, each in its own directory
+static const int num_copies = 2000;
+static const int num_runs = 3;
+static const size_t chunk_size = 64 * 1024;
+
+static std::string inflateGz(const std::string& data)
+{
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    inflateInit2(&zs, 31);
+    zs.next_in = (Bytef*)data.data();
+    zs.avail_in = data.size();
+
+    std::string result;
+    char buf[16384];
+    int ret;
+    do {
+        zs.next_out = (Bytef*)buf;
+        zs.avail_out = sizeof(buf);
+        ret = inflate(&zs, Z_NO_FLUSH);
+        result.append(buf, sizeof(buf) - zs.avail_out);
+    } while (ret == Z_OK);
+    inflateEnd(&zs);
+    return result;
+}
+
+static std::string deflateGz(const std::string& data)
+{
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 31, 8, Z_DEFAULT_STRATEGY);
+    zs.next_in = (Bytef*)data.data();
+    zs.avail_in = data.size();
+
+    std::string result;
+    char buf[16384];
+    int ret;
+    do {
+        zs.next_out = (Bytef*)buf;
+        zs.avail_out = sizeof(buf);
+        ret = deflate(&zs, Z_FINISH);
+        result.append(buf, sizeof(buf) - zs.avail_out);
+    } while (ret == Z_OK);
+    deflateEnd(&zs);
+    return result;
+}
+
+// Repeat the entries of @a tar below copyN/ directories
+static std::string scaleTar(const std::string& tar)
+{
+    std::string result;
+    for (int c = 0; c < num_copies; ++c) {
+        const std::string prefix = "copy" + std::to_string(c) + "/";
+        size_t pos = 0;
+        while (pos + 512 <= tar.size() && tar[pos] != 0) {
+            char header[512];
+            memcpy(header, tar.data() + pos, 512);
+            const size_t size = strtoul(std::string(header + 124, 12).c_str(), nullptr, 8);
+
+            const std::string name = prefix + std::string(header, strnlen(header, 100));
+            memset(header, 0, 100);
+            memcpy(header, name.data(), std::min<size_t>(name.size(), 99));
+
+            memset(header + 148, ' ', 8);
+            unsigned int checksum = 0;
+            for (int i = 0; i < 512; ++i) {
+                checksum += static_cast<unsigned char>(header[i]);
+            }
+            snprintf(header + 148, 8, "%06o", checksum);
+
+            result.append(header, 512);
+            const size_t dataSize = (size + 511) & ~size_t(511);
+            result.append(tar, pos + 512, dataSize);
+            pos += 512 + dataSize;
+        }
+    }
+    result.append(1024, '\0');
+    return result;
+}
+
+static double extract(const std::string& archive, const SGPath& dir, unsigned int numWriters, bool& ok)
+{
+    BestTime best;
+    for (int run = 0; run < num_runs; ++run) {
+        Dir(dir).removeChildren();
+
+        best.run([&] {
+            ArchiveExtractor ex(dir);
+            ex.setNumWriterThreads(numWriters);
+            for (size_t pos = 0; pos < archive.size(); pos += chunk_size) {
+                const size_t len = std::min(chunk_size, archive.size() - pos);
+                ex.extractBytes(reinterpret_cast<const uint8_t*>(archive.data()) + pos, len);
+            }
+            ex.flush();
+            ok = ok && ex.isAtEndOfArchive() && !ex.hasError();
+        });
+    }
+    return best.toMSecs();
+}
+
+int main(int argc, char* argv[])
+{
+    sg_ifstream f(SGPath::fromUtf8(SRC_DIR) / "test.tar.gz", std::ios::in | std::ios::binary);
+    const std::string tar = scaleTar(inflateGz(f.read_all()));
+    const std::string tgz = deflateGz(tar);
+
+    Dir dir = Dir::tempDir("untar_bench");
+    dir.setRemoveOnDestroy();
+
+    std::cout << num_copies << " copies of test.tar.gz, " << tar.size() / 1024 << " KiB ("
+              << tgz.size() / 1024 << " KiB compressed), " << std::thread::hardware_concurrency()
+              << " CPUs\n"
+              << std::fixed << std::setprecision(1)
+              << "writers        .tar      .tar.gz\n";
+
+    bool ok = true;
+    double base[2] = {0, 0};
+    for (unsigned int numWriters : {0u, 1u, 2u, 4u}) {
+        const double tar_ms = extract(tar, dir.path(), numWriters, ok);
+        const double tgz_ms = extract(tgz, dir.path(), numWriters, ok);
+        if (numWriters == 0) {
+            base[0] = tar_ms;
+            base[1] = tgz_ms;
+        }
+        std::cout << std::setw(7) << numWriters << std::setw(10) << tar_ms << " ms"
+                  << std::setw(10) << tgz_ms << " ms   ("
+                  << base[0] / std::max(tar_ms, 0.1) << "x, " << base[1] / std::max(tgz_ms, 0.1) << "x)\n";
+    }
+
+    if (!ok || !(dir.path() / ("copy" + std::to_string(num_copies - 1) + "/testDir/foo.txt")).exists()) {
+        std::cerr << "extraction failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -13,6 +13,7 @@
 #include <simgear_config.h>
 
 #include <simgear/misc/ResourceManager.hxx>
+#include <simgear/misc/sg_dir_cache.hxx>
 #include <simgear/debug/logstream.hxx>
 
 namespace simgear
@@ -65,6 +66,17 @@ void ResourceManager::reset()
     }
 }
 
+// Resolving probes every base path, which is answered from the directory
+// listings of the DirectoryCache where possible. Other SGPath queries
+// always stat().
+static bool resourceExists(const SGPath& path)
+{
+    DirectoryCache::Entry entry;
+    if (DirectoryCache::instance()->lookup(path, entry))
+        return entry.exists;
+    return path.exists();
+}
+
 /**
  * trivial provider using a fixed base path
  */
@@ -81,7 +93,7 @@ public:
     virtual SGPath resolve(const std::string& aResource, SGPath&) const
     {
         SGPath p(_base, aResource);
-        return p.exists() ? p : SGPath();
+        return resourceExists(p) ? p : SGPath();
     }
 private:
     SGPath _base;  
@@ -89,6 +101,8 @@ private:
 
 void ResourceManager::addBasePath(const SGPath& aPath, Priority aPriority)
 {
+    // see resourceExists()
+    DirectoryCache::instance()->addRoot(aPath);
     addProvider(new BasePathProvider(aPath, aPriority));
 }
 
@@ -124,14 +138,14 @@ SGPath ResourceManager::findPath(const std::string& aResource, SGPath aContext)
 {
     const SGPath completePath(aContext, aResource);
 
-    if (!aContext.isNull() && completePath.exists()) {
+    if (!aContext.isNull() && resourceExists(completePath)) {
         return completePath;
     }
 
     // Absolute, existing path and SGPath::validate() grants read access -> OK
     if (completePath.isAbsolute()) {
         const auto authorizedPath = completePath.validate(false);
-        if (!authorizedPath.isNull() && authorizedPath.exists()) {
+        if (!authorizedPath.isNull() && resourceExists(authorizedPath)) {
             return authorizedPath;
         }
     }
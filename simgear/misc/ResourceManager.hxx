@@ -39,7 +39,8 @@ public:
     static void reset();
 
     /**
-     * add a simple fixed resource location, to resolve against
+     * add a simple fixed resource location, to resolve against.
+     * Resource lookups below it are answered from the shared DirectoryCache.
      */
     void addBasePath(const SGPath& aPath, Priority aPriority = PRIORITY_DEFAULT);
 
@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Benchmark resolving resources against several base paths,
+ *        with and without the shared directory cache
+ */
+
+#include <simgear_config.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/misc/ResourceManager.hxx>
+#include <simgear/misc/sg_dir.hxx>
+#include <simgear/misc/sg_dir_cache.hxx>
+#include <simgear/misc/test_timing.hxx>
+
+using namespace simgear;
+
+// Four search roots (aircraft, two scenery paths, FG_ROOT) of 20 model
+// directories holding 25 files each, most resources found in the last one
+static const int num_roots = 4;
+static const int num_dirs = 20;
+static const int num_files = 25;
+static const int num_lookups = 100000;
+
+static double resolve(const std::vector<std::string>& resources, int& found)
+{
+    ResourceManager* rm = ResourceManager::instance();
+    found = 0;
+    return timeRun([&] {
+        for (const auto& r : resources) {
+            if (!rm->findPath(r).isNull())
+                ++found;
+        }
+    }).toMSecs();
+}
+
+int main(int argc, char* argv[])
+{
+    Dir top = Dir::tempDir("resource_bench");
+    top.setRemoveOnDestroy();
+
+    for (int r = 0; r < num_roots; ++r) {
+        SGPath root = top.file("root" + std::to_string(r));
+        for (int d = 0; d < num_dirs; ++d) {
+            // the later roots hold more of the models
+            if (d % num_roots > r)
+                continue;
+            SGPath dir = root / ("Models/Dir" + std::to_string(d));
+            Dir(dir).create(0755);
+            for (int f = 0; f < num_files; ++f)
+                sg_ofstream(dir / ("model" + std::to_string(f) + ".xml")) << "<PropertyList/>";
+        }
+        ResourceManager::instance()->addBasePath(root, ResourceManager::PRIORITY_NORMAL);
+    }
+
+    // a quarter of the lookups is for files which don't exist anywhere
+    std::vector<std::string> resources;
+    resources.reserve(num_lookups);
+    for (int i = 0; i < num_lookups; ++i) {
+        const int d = (i * 7) % (num_dirs + num_dirs / 3);
+        const int f = (i * 13) % num_files;
+        resources.push_back("Models/Dir" + std::to_string(d) + "/model" + std::to_string(f) + ".xml");
+    }
+
+    DirectoryCache* cache = DirectoryCache::instance();
+    cache->setEnabled(false);
+    int found_stat = 0;
+    const double stat_ms = resolve(resources, found_stat);
+
+    cache->setEnabled(true);
+    int found_cold = 0;
+    const double cold_ms = resolve(resources, found_cold);
+    int found_warm = 0;
+    const double warm_ms = resolve(resources, found_warm);
+
+    const auto stats = cache->getStats();
+    std::cout << num_lookups << " lookups over " << num_roots << " roots, "
+              << found_stat << " found\n"
+              << std::fixed << std::setprecision(1)
+              << "stat():         " << std::setw(8) << stat_ms << " ms\n"
+              << "cache, cold:    " << std::setw(8) << cold_ms << " ms\n"
+              << "cache, warm:    " << std::setw(8) << warm_ms << " ms ("
+              << stat_ms / std::max(warm_ms, 0.1) << "x)\n"
+              << stats.listings << " directories listed, " << stats.names << " names\n";
+
+    if (found_cold != found_stat || found_warm != found_stat) {
+        std::cerr << "cache results differ: " << found_cold << ", " << found_warm << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -7,6 +7,7 @@
 #include <simgear_config.h>
 
 #include <simgear/misc/sg_dir.hxx>
+#include <simgear/misc/sg_dir_cache.hxx>
 #include <simgear/structure/exception.hxx>
 #include <math.h>
 #include <stdlib.h>
@@ -334,6 +335,8 @@ bool Dir::create(mode_t mode)
         SG_LOG(SG_IO, SG_WARN,
                "directory creation failed for '" << _path.utf8Str() << "': " <<
                simgear::strutils::error_string(errno));
+    } else {
+        DirectoryCache::instance()->invalidate(_path);
     }
 
     return (err == 0);
@@ -389,6 +392,8 @@ bool Dir::remove(bool recursive)
         SG_LOG(SG_IO, SG_WARN,
                "rmdir failed for '" << _path.utf8Str() << "': " <<
                simgear::strutils::error_string(errno));
+    } else {
+        DirectoryCache::instance()->invalidate(_path);
     }
     return (err == 0);
 }
@@ -0,0 +1,540 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Process-wide cache of directory listings, for cheap file lookups
+ */
+
+#include <simgear_config.h>
+
+#include "sg_dir_cache.hxx"
+
+#include <algorithm>
+#include <cerrno>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#if defined(SG_WINDOWS)
+#  include <windows.h>
+#else
+#  include <dirent.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#  include <poll.h>
+#  include <sys/inotify.h>
+#  define SG_DIR_CACHE_INOTIFY 1
+#endif
+
+#include <simgear/debug/logstream.hxx>
+#include <simgear/misc/strutils.hxx>
+
+namespace simgear
+{
+
+#if defined(SG_DIR_CACHE_INOTIFY)
+static const uint32_t WATCH_MASK = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                                   IN_ATTRIB | IN_MODIFY | IN_CLOSE_WRITE |
+                                   IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+#endif
+
+// Path as the cache keys it: UTF-8, no trailing separator
+static std::string cacheKey(const SGPath& path)
+{
+    std::string p = path.utf8Str();
+    while (p.size() > 1 && p.back() == '/')
+        p.pop_back();
+    return p;
+}
+
+static std::string parentOf(const std::string& path)
+{
+    const size_t slash = path.rfind('/');
+    return (slash == 0) ? std::string("/") : path.substr(0, slash);
+}
+
+static std::string childOf(const std::string& dir, const std::string& name)
+{
+    return (dir.back() == '/') ? dir + name : dir + '/' + name;
+}
+
+static bool statEntry(const std::string& path, DirectoryCache::Entry& entry)
+{
+#if defined(SG_WINDOWS)
+    struct _stat buf;
+    if (_wstat(strutils::convertUtf8ToWString(path).c_str(), &buf) < 0)
+        return false;
+    entry.isFile = (buf.st_mode & _S_IFREG) != 0;
+    entry.isDir = (buf.st_mode & _S_IFDIR) != 0;
+#else
+    struct stat buf;
+    if (::stat(path.c_str(), &buf) < 0)
+        return false;
+    entry.isFile = S_ISREG(buf.st_mode);
+    entry.isDir = S_ISDIR(buf.st_mode);
+#endif
+    entry.exists = true;
+    entry.hasStat = true;
+    entry.size = buf.st_size;
+    entry.modTime = buf.st_mtime;
+    return true;
+}
+
+DirectoryCache* DirectoryCache::instance()
+{
+    // never destroyed, SGPath may be used by static destructors
+    static DirectoryCache* cache = new DirectoryCache;
+    return cache;
+}
+
+DirectoryCache::DirectoryCache()
+{
+}
+
+DirectoryCache::~DirectoryCache()
+{
+#if defined(SG_DIR_CACHE_INOTIFY)
+    if (_watcher.joinable()) {
+        const char c = 0;
+        [[maybe_unused]] ssize_t n = ::write(_wakeFd[1], &c, 1);
+        _watcher.join();
+    }
+    for (int fd : {_notifyFd, _wakeFd[0], _wakeFd[1]}) {
+        if (fd >= 0)
+            ::close(fd);
+    }
+#endif
+}
+
+void DirectoryCache::addRoot(const SGPath& root)
+{
+    if (!root.isAbsolute())
+        return;
+
+    std::string r = cacheKey(root);
+    if (r.back() != '/')
+        r += '/';
+
+    std::lock_guard<std::mutex> g(_mutex);
+    if (std::find(_roots.begin(), _roots.end(), r) != _roots.end())
+        return;
+
+    _roots.push_back(r);
+    _hasRoots = true;
+    startWatching();
+}
+
+void DirectoryCache::removeRoot(const SGPath& root)
+{
+    std::string r = cacheKey(root);
+    if (r.back() != '/')
+        r += '/';
+
+    std::lock_guard<std::mutex> g(_mutex);
+    auto it = std::find(_roots.begin(), _roots.end(), r);
+    if (it == _roots.end())
+        return;
+
+    _roots.erase(it);
+    _hasRoots = !_roots.empty();
+    dropAll();
+}
+
+bool DirectoryCache::lookup(const SGPath& path, Entry& entry, bool withStat)
+{
+    if (!_hasRoots || !_enabled)
+        return false;
+
+    const std::string p = cacheKey(path);
+    std::lock_guard<std::mutex> g(_mutex);
+    if (!isCacheable(p))
+        return false;
+
+    const size_t slash = p.rfind('/');
+    Listing* listing = getListing(parentOf(p));
+    if (!listing)
+        return false;
+
+    ++_stats.lookups;
+    if (!listing->exists) {
+        entry = Entry();
+        return true;
+    }
+
+    auto it = listing->entries.find(p.substr(slash + 1));
+    if (it == listing->entries.end()) {
+        entry = Entry();
+        return true;
+    }
+
+    if (withStat && !it->second.hasStat) {
+        ++_stats.stats;
+        if (!statEntry(p, it->second)) {
+            // gone, and the change not seen yet
+            listing->entries.erase(it);
+            --_stats.names;
+            entry = Entry();
+            return true;
+        }
+    }
+
+    entry = it->second;
+    return true;
+}
+
+void DirectoryCache::invalidate(const SGPath& path)
+{
+    if (!_hasRoots)
+        return;
+
+    std::string p = cacheKey(path);
+    std::lock_guard<std::mutex> g(_mutex);
+    if (!isCacheable(p)) {
+        // a root, or above one
+        if (path.isAbsolute())
+            dropListings(p);
+        return;
+    }
+
+    // Find the deepest listing of an existing directory above the path:
+    // what changed is the entry for the next component below it.
+    while (true) {
+        const size_t slash = p.rfind('/');
+        const std::string dir = parentOf(p);
+        auto it = _listings.find(dir);
+        if (it != _listings.end() && it->second.exists) {
+            Listing& listing = it->second;
+            const std::string name = p.substr(slash + 1);
+            Entry entry;
+            const bool existed = listing.entries.erase(name) > 0;
+            if (statEntry(p, entry)) {
+                listing.entries[name] = entry;
+                _stats.names += existed ? 0 : 1;
+            } else {
+                _stats.names -= existed ? 1 : 0;
+            }
+            break;
+        }
+        if (!isCacheable(dir))
+            break;
+        p = dir;
+    }
+
+    dropListings(p);
+}
+
+void DirectoryCache::clear()
+{
+    std::lock_guard<std::mutex> g(_mutex);
+    dropAll();
+}
+
+void DirectoryCache::setEnabled(bool enabled)
+{
+    std::lock_guard<std::mutex> g(_mutex);
+    _enabled = enabled;
+    if (!enabled)
+        dropAll();
+}
+
+void DirectoryCache::setMaxNames(size_t maxNames)
+{
+    std::lock_guard<std::mutex> g(_mutex);
+    _maxNames = maxNames;
+    if (_stats.names > _maxNames)
+        dropAll();
+}
+
+DirectoryCache::Stats DirectoryCache::getStats() const
+{
+    std::lock_guard<std::mutex> g(_mutex);
+    Stats stats = _stats;
+    stats.directories = _listings.size();
+    return stats;
+}
+
+// Strictly below a root, and without '.' or '..' components
+bool DirectoryCache::isCacheable(const std::string& path) const
+{
+    if (path.find("//") != std::string::npos ||
+        path.find("/./") != std::string::npos ||
+        path.find("/../") != std::string::npos ||
+        strutils::ends_with(path, "/.") || strutils::ends_with(path, "/..")) {
+        return false;
+    }
+
+    for (const auto& root : _roots) {
+        if (path.size() > root.size() && strutils::starts_with(path, root))
+            return true;
+    }
+    return false;
+}
+
+// Called with the lock held
+DirectoryCache::Listing* DirectoryCache::getListing(const std::string& dir)
+{
+    auto it = _listings.find(dir);
+    if (it != _listings.end())
+        return &it->second;
+
+    // Below a root, whether the directory exists is known from the listing
+    // of its parent, which also notices when it is created.
+    if (isCacheable(dir)) {
+        const size_t slash = dir.rfind('/');
+        Listing* parent = getListing(parentOf(dir));
+        if (!parent)
+            return nullptr;
+
+        bool isDir = false;
+        if (parent->exists) {
+            auto entry = parent->entries.find(dir.substr(slash + 1));
+            isDir = (entry != parent->entries.end()) && entry->second.isDir;
+        }
+        if (!isDir)
+            return &_listings[dir];
+    }
+
+    Listing listing;
+    if (!readListing(dir, listing))
+        return nullptr;
+
+    if (_stats.names + listing.entries.size() > _maxNames) {
+        SG_LOG(SG_IO, SG_DEBUG, "DirectoryCache: more than " << _maxNames << " names, dropping all");
+        dropAll();
+    }
+
+    ++_stats.listings;
+    _stats.names += listing.entries.size();
+    if (listing.watch >= 0)
+        _watches.emplace(listing.watch, dir);
+    return &_listings.emplace(dir, std::move(listing)).first->second;
+}
+
+// Called with the lock held, so the watch is in place before the directory is
+// read, and changes seen by the watcher are applied after the listing is stored.
+bool DirectoryCache::readListing(const std::string& dir, Listing& listing)
+{
+#if defined(SG_DIR_CACHE_INOTIFY)
+    if (_notifyFd >= 0) {
+        listing.watch = inotify_add_watch(_notifyFd, dir.c_str(), WATCH_MASK);
+        if (listing.watch < 0 && errno != ENOENT && errno != ENOTDIR) {
+            // most likely out of watches: don't cache what can't be watched
+            SG_LOG(SG_IO, SG_DEBUG, "DirectoryCache: can't watch " << dir << ": "
+                                                                   << strutils::error_string(errno));
+            return false;
+        }
+    }
+#endif
+
+#if defined(SG_WINDOWS)
+    std::wstring search = strutils::convertUtf8ToWString(dir + "/*");
+    WIN32_FIND_DATAW fData;
+    HANDLE find = FindFirstFileW(search.c_str(), &fData);
+    if (find == INVALID_HANDLE_VALUE) {
+        const DWORD err = GetLastError();
+        if (err != ERROR_FILE_NOT_FOUND && err != ERROR_PATH_NOT_FOUND)
+            return false;
+        listing.exists = false;
+        return true;
+    }
+
+    listing.exists = true;
+    do {
+        std::string name = strutils::convertWStringToUtf8(fData.cFileName);
+        if (name == "." || name == "..")
+            continue;
+        Entry& entry = listing.entries[name];
+        entry.exists = true;
+        entry.isDir = (fData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+        entry.isFile = !entry.isDir;
+    } while (FindNextFileW(find, &fData));
+    FindClose(find);
+#else
+    DIR* dp = opendir(dir.c_str());
+    if (!dp) {
+        if (errno != ENOENT && errno != ENOTDIR)
+            return false;
+#  if defined(SG_DIR_CACHE_INOTIFY)
+        if (listing.watch >= 0)
+            inotify_rm_watch(_notifyFd, listing.watch);
+        listing.watch = -1;
+#  endif
+        listing.exists = false;
+        return true;
+    }
+
+    listing.exists = true;
+    while (struct dirent* ent = readdir(dp)) {
+        const std::string name = ent->d_name;
+        if (name == "." || name == "..")
+            continue;
+
+        Entry entry;
+        entry.exists = true;
+#  if defined(_DIRENT_HAVE_D_TYPE) || defined(DT_DIR)
+        if (ent->d_type == DT_DIR) {
+            entry.isDir = true;
+        } else if (ent->d_type == DT_REG) {
+            entry.isFile = true;
+        } else
+#  endif
+        {
+            // symbolic links, or the file system doesn't tell
+            ++_stats.stats;
+            if (!statEntry(childOf(dir, name), entry))
+                continue;   // dangling link
+        }
+        listing.entries.emplace(name, entry);
+    }
+    closedir(dp);
+#endif
+    return true;
+}
+
+// Drop the listing of @a dir and everything below it. Called with the lock held
+void DirectoryCache::dropListings(const std::string& dir)
+{
+    auto it = _listings.find(dir);
+    if (it != _listings.end())
+        dropListing(it);
+
+    const std::string prefix = childOf(dir, "");
+    it = _listings.lower_bound(prefix);
+    while (it != _listings.end() && strutils::starts_with(it->first, prefix)) {
+        auto next = std::next(it);
+        dropListing(it);
+        it = next;
+    }
+}
+
+void DirectoryCache::dropListing(ListingMap::iterator it)
+{
+#if defined(SG_DIR_CACHE_INOTIFY)
+    const int watch = it->second.watch;
+    if (watch >= 0) {
+        // symbolic links can make several listings share a watch
+        auto range = _watches.equal_range(watch);
+        for (auto w = range.first; w != range.second; ++w) {
+            if (w->second == it->first) {
+                _watches.erase(w);
+                break;
+            }
+        }
+        if (_watches.count(watch) == 0)
+            inotify_rm_watch(_notifyFd, watch);
+    }
+#endif
+
+    ++_stats.invalidations;
+    _stats.names -= it->second.entries.size();
+    _listings.erase(it);
+}
+
+void DirectoryCache::dropAll()
+{
+#if defined(SG_DIR_CACHE_INOTIFY)
+    for (const auto& w : _watches)
+        inotify_rm_watch(_notifyFd, w.first);
+#endif
+    _stats.invalidations += _listings.size();
+    _stats.names = 0;
+    _watches.clear();
+    _listings.clear();
+}
+
+// Called with the lock held
+void DirectoryCache::startWatching()
+{
+#if defined(SG_DIR_CACHE_INOTIFY)
+    if (_watcher.joinable())
+        return;
+
+    _notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (_notifyFd < 0) {
+        SG_LOG(SG_IO, SG_WARN, "DirectoryCache: inotify unavailable, only explicit invalidation: "
+                                   << strutils::error_string(errno));
+        return;
+    }
+    if (pipe2(_wakeFd, O_CLOEXEC) < 0) {
+        ::close(_notifyFd);
+        _notifyFd = -1;
+        return;
+    }
+
+    _watcher = std::thread(&DirectoryCache::watchMain, this);
+#endif
+}
+
+void DirectoryCache::watchMain()
+{
+#if defined(SG_DIR_CACHE_INOTIFY)
+    alignas(struct inotify_event) char buf[16 * 1024];
+    while (true) {
+        struct pollfd fds[2] = {{_notifyFd, POLLIN, 0}, {_wakeFd[0], POLLIN, 0}};
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        if (fds[1].revents)
+            return;
+
+        const ssize_t len = ::read(_notifyFd, buf, sizeof(buf));
+        if (len <= 0)
+            continue;
+
+        std::lock_guard<std::mutex> g(_mutex);
+        for (ssize_t i = 0; i < len;) {
+            const auto* ev = reinterpret_cast<const struct inotify_event*>(buf + i);
+            i += sizeof(struct inotify_event) + ev->len;
+
+            if (ev->mask & IN_Q_OVERFLOW) {
+                dropAll();
+                continue;
+            }
+
+            std::vector<std::string> dirs;
+            auto range = _watches.equal_range(ev->wd);
+            for (auto w = range.first; w != range.second; ++w)
+                dirs.push_back(w->second);
+
+            for (const auto& dir : dirs) {
+                auto it = _listings.find(dir);
+                if (it == _listings.end())
+                    continue;
+
+                if (ev->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+                    dropListings(dir);
+                    continue;
+                }
+                if (ev->len == 0)
+                    continue;
+
+                const std::string name = ev->name;
+                const std::string path = childOf(dir, name);
+                Listing& listing = it->second;
+                if (ev->mask & (IN_CREATE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM)) {
+                    const bool existed = listing.entries.erase(name) > 0;
+                    Entry entry;
+                    if ((ev->mask & (IN_CREATE | IN_MOVED_TO)) && statEntry(path, entry)) {
+                        listing.entries[name] = entry;
+                        _stats.names += existed ? 0 : 1;
+                    } else {
+                        _stats.names -= existed ? 1 : 0;
+                    }
+                    dropListings(path);
+                } else {
+                    auto entry = listing.entries.find(name);
+                    if (entry != listing.entries.end())
+                        entry->second.hasStat = false;
+                }
+            }
+        }
+    }
+#endif
+}
+
+} // of namespace simgear
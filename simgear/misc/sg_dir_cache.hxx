@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Process-wide cache of directory listings, for cheap file lookups
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <simgear/misc/sg_path.hxx>
+
+namespace simgear
+{
+
+/**
+ * Answers exists / isFile / isDir / size / modification time queries for
+ * files below a set of root directories (data, aircraft and scenery
+ * paths) from cached directory listings, instead of a stat() per query.
+ *
+ * The cache is opt-in: ResourceManager uses it to resolve resources
+ * against its base paths, while SGPath queries always stat().
+ *
+ * A directory is listed once, the first time a file in it is looked up;
+ * sizes and times are only read for files which are asked about. Looking
+ * up a file in a missing directory is answered from the listing of its
+ * parent, so probing many search paths for the same name stays cheap.
+ *
+ * On Linux, listings are watched with inotify and dropped when the
+ * directory changes. Elsewhere, and for changes which must be visible
+ * immediately, invalidate() drops them; SGPath, Dir, sg_ofstream, SGFile
+ * and SGMMapFile do so for the changes they make themselves.
+ *
+ * Paths which are relative, outside the roots or contain '.' or '..'
+ * components are not answered, and callers fall back to stat().
+ * All methods are thread safe.
+ */
+class DirectoryCache final
+{
+public:
+    struct Entry {
+        bool exists = false;
+        bool isFile = false;
+        bool isDir = false;
+        bool hasStat = false;   ///< size and modTime are set
+        size_t size = 0;
+        time_t modTime = 0;
+    };
+
+    struct Stats {
+        uint64_t lookups = 0;       ///< answered from the cache
+        uint64_t listings = 0;      ///< directories read
+        uint64_t stats = 0;         ///< files stat()ed for size and time
+        uint64_t invalidations = 0; ///< listings dropped
+        size_t directories = 0;     ///< listings held
+        size_t names = 0;           ///< names in them
+    };
+
+    /// Limit on the number of names held, beyond which all listings are dropped
+    static const size_t DefaultMaxNames = 1000000;
+
+    static DirectoryCache* instance();
+
+    ~DirectoryCache();   // non-virtual intentional
+
+    DirectoryCache(const DirectoryCache&) = delete;
+    DirectoryCache& operator=(const DirectoryCache&) = delete;
+
+    /**
+     * Cache lookups below the (absolute) directory @a root. Nested roots
+     * are fine.
+     */
+    void addRoot(const SGPath& root);
+
+    void removeRoot(const SGPath& root);
+
+    /// Whether any roots were added
+    bool hasRoots() const { return _hasRoots; }
+
+    /**
+     * Look @a path up in the cache.
+     * @param withStat also fill in size and modification time
+     * @return false if the cache can't answer for @a path
+     */
+    bool lookup(const SGPath& path, Entry& entry, bool withStat = false);
+
+    /**
+     * Forget what is known about @a path: the listing of its parent
+     * directory, and its own listing and those below it if it is a
+     * directory. Call after changing files behind the cache's back.
+     */
+    void invalidate(const SGPath& path);
+
+    /// Forget all listings, keeping the roots
+    void clear();
+
+    /// Turn the cache off (and on) without removing the roots
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return _enabled; }
+
+    void setMaxNames(size_t maxNames);
+
+    Stats getStats() const;
+
+private:
+    DirectoryCache();
+
+    struct Listing {
+        bool exists = false;
+        int watch = -1;         ///< inotify watch descriptor
+        std::unordered_map<std::string, Entry> entries;
+    };
+
+    using ListingMap = std::map<std::string, Listing>;
+
+    bool isCacheable(const std::string& path) const;
+    Listing* getListing(const std::string& dir);
+    bool readListing(const std::string& dir, Listing& listing);
+    void dropListings(const std::string& dir);
+    void dropListing(ListingMap::iterator it);
+    void dropAll();
+
+    void startWatching();
+    void watchMain();
+
+    mutable std::mutex _mutex;
+    std::vector<std::string> _roots;    ///< with a trailing '/'
+    ListingMap _listings;
+    std::unordered_multimap<int, std::string> _watches;  ///< watch -> listed directories
+    Stats _stats;
+    size_t _maxNames = DefaultMaxNames;
+
+    std::atomic<bool> _hasRoots{false};
+    std::atomic<bool> _enabled{true};
+
+    int _notifyFd = -1;
+    int _wakeFd[2] = {-1, -1};
+    std::thread _watcher;
+};
+
+} // of namespace simgear
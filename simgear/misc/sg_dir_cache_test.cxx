@@ -0,0 +1,251 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Unit tests for the shared directory listing cache
+ */
+
+#include <simgear_config.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/io/sg_file.hxx>
+#include <simgear/misc/sg_dir.hxx>
+#include <simgear/misc/sg_path.hxx>
+#include <simgear/misc/test_macros.hxx>
+
+#include "sg_dir_cache.hxx"
+
+using std::cout;
+using std::endl;
+using simgear::Dir;
+using simgear::DirectoryCache;
+
+static void writeFile(const SGPath& path, const std::string& contents)
+{
+    sg_ofstream f(path);
+    f << contents;
+}
+
+// Change a file without telling the cache
+static void writeFileBehindTheBack(const SGPath& path, const std::string& contents)
+{
+    FILE* f = std::fopen(path.utf8Str().c_str(), "wb");
+    SG_VERIFY(f != nullptr);
+    std::fwrite(contents.data(), 1, contents.size(), f);
+    std::fclose(f);
+}
+
+static DirectoryCache::Entry cached(const SGPath& path, bool withStat = false)
+{
+    DirectoryCache::Entry entry;
+    SG_VERIFY(DirectoryCache::instance()->lookup(path, entry, withStat));
+    return entry;
+}
+
+static bool cachedExists(const SGPath& path)
+{
+    return cached(path).exists;
+}
+
+void test_lookup(const Dir& root)
+{
+    cout << "Testing lookups" << endl;
+
+    auto cache = DirectoryCache::instance();
+    Dir(root.file("Models/Airport")).create(0755);
+    writeFile(root.file("Models/Airport/windsock.xml"), "<PropertyList/>");
+    writeFile(root.file("Models/Airport/windsock.ac"), std::string(1000, 'x'));
+
+    cache->clear();
+    const auto before = cache->getStats();
+
+    // same answers as stat()
+    for (const char* name : {"Models", "Models/Airport", "Models/Airport/windsock.xml",
+                             "Models/Airport/windsock.ac", "Models/nothing", "nothing/at/all"}) {
+        const DirectoryCache::Entry entry = cached(root.file(name), true);
+        const SGPath p = root.file(name);
+        SG_CHECK_EQUAL(entry.exists, p.exists());
+        SG_CHECK_EQUAL(entry.exists && entry.isFile, p.isFile());
+        SG_CHECK_EQUAL(entry.exists && entry.isDir, p.isDir());
+        if (p.isFile()) {
+            SG_CHECK_EQUAL(entry.size, p.sizeInBytes());
+            SG_CHECK_EQUAL(entry.modTime, p.modTime());
+        }
+    }
+    SG_CHECK_EQUAL(cached(root.file("Models/Airport/windsock.ac"), true).size, 1000);
+
+    // each directory is read once; missing ones aren't read at all
+    auto stats = cache->getStats();
+    SG_CHECK_EQUAL(stats.listings - before.listings, 3);
+    SG_VERIFY(stats.lookups > before.lookups);
+    SG_CHECK_EQUAL(stats.names, 4);
+
+    for (int i = 0; i < 100; ++i) {
+        SG_VERIFY(!cachedExists(root.file("nothing/at/all/" + std::to_string(i))));
+        SG_VERIFY(cachedExists(root.file("Models/Airport/windsock.xml")));
+    }
+    SG_CHECK_EQUAL(cache->getStats().listings, stats.listings);
+
+    // not answered
+    DirectoryCache::Entry entry;
+    SG_VERIFY(!cache->lookup(SGPath::fromUtf8("Models/Airport/windsock.xml"), entry));
+    SG_VERIFY(!cache->lookup(root.file("Models/../Models/Airport"), entry));
+    SG_VERIFY(!cache->lookup(root.path(), entry));
+    SG_VERIFY(!cache->lookup(root.path().dirPath(), entry));
+
+    // SGPath queries don't use the cache
+    const auto lookups = cache->getStats().lookups;
+    SG_VERIFY(root.file("Models").isDir());
+    SG_VERIFY(root.file("Models/Airport/windsock.xml").exists());
+    SG_CHECK_EQUAL(cache->getStats().lookups, lookups);
+}
+
+void test_own_changes(const Dir& root)
+{
+    cout << "Testing changes made through SimGear" << endl;
+
+    auto cache = DirectoryCache::instance();
+    cache->clear();
+
+    SG_VERIFY(!cachedExists(root.file("Textures")));
+    SG_VERIFY(!cachedExists(root.file("Textures/Runway/asphalt.png")));
+
+    // seen immediately, on every platform
+    Dir(root.file("Textures/Runway")).create(0755);
+    SG_VERIFY(cached(root.file("Textures")).isDir);
+    SG_VERIFY(cached(root.file("Textures/Runway")).isDir);
+
+    writeFile(root.file("Textures/Runway/asphalt.png"), "png");
+    SG_VERIFY(cached(root.file("Textures/Runway/asphalt.png")).isFile);
+    SG_CHECK_EQUAL(cached(root.file("Textures/Runway/asphalt.png"), true).size, 3);
+
+    SGPath from = root.file("Textures/Runway/asphalt.png");
+    SG_VERIFY(from.rename(root.file("Textures/Runway/concrete.png")));
+    SG_VERIFY(!cachedExists(root.file("Textures/Runway/asphalt.png")));
+    SG_VERIFY(cachedExists(root.file("Textures/Runway/concrete.png")));
+
+    SGPath concrete = root.file("Textures/Runway/concrete.png");
+    SG_VERIFY(concrete.remove());
+    SG_VERIFY(!cachedExists(root.file("Textures/Runway/concrete.png")));
+
+    Dir(root.file("Textures/Runway")).remove();
+    SG_VERIFY(!cachedExists(root.file("Textures/Runway")));
+    SG_VERIFY(!cachedExists(root.file("Textures/Runway/concrete.png")));
+    SG_VERIFY(cached(root.file("Textures")).isDir);
+
+    SGPath created = root.file("Textures/Terrain/grass.png");
+    SG_CHECK_EQUAL(created.create_dir(0755), 0);
+    SG_VERIFY(cached(root.file("Textures/Terrain")).isDir);
+
+    // files written with SGBinaryFile, and their size once known
+    const SGPath binary = root.file("Textures/Terrain/grass.dds");
+    writeFile(binary, "dds");
+    SG_CHECK_EQUAL(cached(binary, true).size, 3);
+    {
+        SGBinaryFile f(binary);
+        SG_VERIFY(f.open(SG_IO_OUT));
+        SG_CHECK_EQUAL(f.write("binary", 6), 6);
+        SG_VERIFY(f.close());
+    }
+    SG_CHECK_EQUAL(cached(binary, true).size, 6);
+    SG_VERIFY(binary.exists());
+    SG_CHECK_EQUAL(SGPath(binary).sizeInBytes(), 6);
+
+    const SGPath snow = root.file("Textures/Terrain/snow.dds");
+    SG_VERIFY(!cachedExists(snow));
+    {
+        SGBinaryFile f(snow);
+        SG_VERIFY(f.open(SG_IO_OUT));
+        SG_CHECK_EQUAL(f.write("snow", 4), 4);
+        SG_VERIFY(f.close());
+    }
+    SG_VERIFY(cachedExists(snow));
+    SG_VERIFY(snow.exists());
+    SG_CHECK_EQUAL(snow.sizeInBytes(), 4);
+}
+
+void test_external_changes(const Dir& root)
+{
+    cout << "Testing changes made behind the cache's back" << endl;
+
+    auto cache = DirectoryCache::instance();
+    cache->clear();
+
+    const SGPath file = root.file("Effects/model-default.eff");
+    SG_VERIFY(!cachedExists(file));
+    Dir(root.file("Effects")).create(0755);
+    SG_VERIFY(!cachedExists(file));
+
+    writeFileBehindTheBack(file, "effect");
+
+#if defined(__linux__)
+    // noticed by the inotify watch on Effects
+    for (int i = 0; i < 200 && !cachedExists(file); ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+#else
+    cache->invalidate(file);
+#endif
+    SG_VERIFY(cachedExists(file));
+    SG_CHECK_EQUAL(cached(file, true).size, 6);
+
+    writeFileBehindTheBack(file, "longer effect");
+#if defined(__linux__)
+    for (int i = 0; i < 200 && cached(file, true).size != 13; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+#else
+    cache->invalidate(file);
+#endif
+    SG_CHECK_EQUAL(cached(file, true).size, 13);
+}
+
+void test_threads(const Dir& root)
+{
+    cout << "Testing concurrent lookups" << endl;
+
+    auto cache = DirectoryCache::instance();
+    cache->clear();
+    Dir(root.file("Aircraft/c172p/Models")).create(0755);
+    for (int i = 0; i < 20; ++i)
+        writeFile(root.file("Aircraft/c172p/Models/part" + std::to_string(i) + ".ac"), "ac");
+
+    std::vector<std::thread> threads;
+    std::vector<int> found(4, 0);
+    for (size_t t = 0; t < found.size(); ++t) {
+        threads.emplace_back([&, t] {
+            for (int n = 0; n < 1000; ++n) {
+                const int i = (n * 7 + t) % 40;
+                if (cachedExists(root.file("Aircraft/c172p/Models/part" + std::to_string(i) + ".ac")))
+                    ++found[t];
+                if (n % 100 == 0)
+                    cache->clear();
+            }
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+
+    for (int f : found)
+        SG_CHECK_EQUAL(f, 500);
+}
+
+int main(int argc, char* argv[])
+{
+    Dir root = Dir::tempDir("sg_dir_cache");
+    root.setRemoveOnDestroy();
+    DirectoryCache::instance()->addRoot(root.path());
+
+    test_lookup(root);
+    test_own_changes(root);
+    test_external_changes(root);
+    test_threads(root);
+
+    DirectoryCache::instance()->removeRoot(root.path());
+    return EXIT_SUCCESS;
+}
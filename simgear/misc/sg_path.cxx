@@ -32,6 +32,7 @@
 #include <simgear/debug/logstream.hxx>
 #include <simgear/io/iostreams/sgstream.hxx>
 #include <simgear/misc/sg_dir.hxx>
+#include <simgear/misc/sg_dir_cache.hxx>
 #include <simgear/misc/strutils.hxx>
 
 #include "sg_path.hxx"
@@ -732,6 +733,7 @@ int SGPath::create_dir(mode_t mode)
     dir.append(path_elements[i++]);
   }
 
+  simgear::DirectoryCache::instance()->invalidate(dirP);
   _cached = false; // re-stat on next query
   return 0;
 }
@@ -849,6 +851,8 @@ bool SGPath::remove()
     SG_LOG( SG_IO, SG_WARN, "file remove failed: (" << *this << ") "
                                                " reason: " << strerror(errno) );
     // TODO check if failed unlink can really change any of the cached values
+  } else {
+    simgear::DirectoryCache::instance()->invalidate(*this);
   }
 
   _cached = false; // stat again if required
@@ -927,6 +931,8 @@ bool SGPath::rename(const SGPath& newName)
     return false;
   }
 
+  simgear::DirectoryCache::instance()->invalidate(*this);
+  simgear::DirectoryCache::instance()->invalidate(newName);
   path = newName.path;
 
   // Do not remove permission checker (could happen for example if just using
@@ -1219,6 +1225,7 @@ bool SGPath::touch()
 #endif
 
     // reset the cache flag so we re-stat() on next request
+    simgear::DirectoryCache::instance()->invalidate(*this);
     _cached = false;
     return true;
 }
@@ -1231,6 +1238,7 @@ bool SGPath::makeLink(const std::string& destination)
     if (symlink(destination.c_str(), c_str())) {
         return false;
     }
+    simgear::DirectoryCache::instance()->invalidate(*this);
     return true;
     #endif
 }
@@ -75,50 +75,80 @@ namespace simgear::strutils {
 		return s_latin1;
 	}
 
+	static inline bool is_space(char c)
+	{
+	    return isspace(static_cast<unsigned char>(c)) != 0;
+	}
+
 	/**
-	 *
+	 * split() and split_view() share the word scanning in here.
 	 */
-	static vector<string>
-	split_whitespace( const string& str, int maxsplit )
+	SplitView::iterator SplitView::begin() const
 	{
-	    vector<string> result;
-	    string::size_type len = str.length();
-	    string::size_type i = 0;
-	    string::size_type j;
-	    int countsplit = 0;
-
-	    while (i < len)
-	    {
-		while (i < len && isspace((unsigned char)str[i]))
-		{
-		    ++i;
-		}
-
-		j = i;
+	    iterator it;
+	    if (!_whitespace && _sep.empty())
+		return it; // Error: empty separator string
+
+	    it._s = _s;
+	    it._sep = _sep;
+	    it._maxsplit = _maxsplit;
+	    it._whitespace = _whitespace;
+	    it._done = false;
+	    it.next();
+	    return it;
+	}
 
-		while (i < len && !isspace((unsigned char)str[i]))
-		{
-		    ++i;
-		}
+	void SplitView::iterator::next()
+	{
+	    if (_last) {
+		_done = true;
+		return;
+	    }
 
-		if (j < i)
-		{
-		    result.push_back( str.substr(j, i-j) );
-		    ++countsplit;
-		    while (i < len && isspace((unsigned char)str[i]))
-		    {
-			++i;
-		    }
+	    if (_rest) {
+		_word = _s.substr(_pos);
+		_last = true;
+		return;
+	    }
 
-		    if (maxsplit && (countsplit >= maxsplit) && i < len)
-		    {
-			result.push_back( str.substr( i, len-i ) );
-			i = len;
+	    if (!_whitespace) {
+		if (!_maxsplit || _count < _maxsplit) {
+		    const size_t i = _s.find(_sep, _pos);
+		    if (i != std::string_view::npos) {
+			_word = _s.substr(_pos, i - _pos);
+			_pos = i + _sep.size();
+			++_count;
+			return;
 		    }
 		}
+
+		_word = _s.substr(_pos);
+		_last = true;
+		return;
 	    }
 
-	    return result;
+	    const size_t len = _s.size();
+	    size_t i = _pos;
+	    while (i < len && is_space(_s[i]))
+		++i;
+
+	    if (i >= len) {
+		_done = true;
+		return;
+	    }
+
+	    const size_t j = i;
+	    while (i < len && !is_space(_s[i]))
+		++i;
+
+	    _word = _s.substr(j, i - j);
+	    ++_count;
+	    while (i < len && is_space(_s[i]))
+		++i;
+
+	    _pos = i;
+	    if (_maxsplit && (_count >= _maxsplit) && i < len)
+		_rest = true;
 	}
 
 	/**
@@ -127,39 +157,9 @@ namespace simgear::strutils {
 	vector<string>
 	split( const string& str, const char* sep, int maxsplit )
 	{
-	    if (sep == 0)
-		return split_whitespace( str, maxsplit );
-
 	    vector<string> result;
-	    int n = std::strlen( sep );
-	    if (n == 0)
-	    {
-		// Error: empty separator string
-		return result;
-	    }
-	    const char* s = str.c_str();
-	    string::size_type len = str.length();
-	    string::size_type i = 0;
-	    string::size_type j = 0;
-	    int splitcount = 0;
-
-	    while (i+n <= len)
-	    {
-		if (s[i] == sep[0] && (n == 1 || std::memcmp(s+i, sep, n) == 0))
-		{
-		    result.push_back( str.substr(j,i-j) );
-		    i = j = i + n;
-		    ++splitcount;
-		    if (maxsplit && (splitcount >= maxsplit))
-			break;
-		}
-		else
-		{
-		    ++i;
-		}
-	    }
-
-	    result.push_back( str.substr(j,len-j) );
+	    for (std::string_view word : split_view(str, sep, maxsplit))
+		result.emplace_back(word);
 	    return result;
 	}
 
@@ -188,67 +188,55 @@ namespace simgear::strutils {
         return result;
     }
 
-    /**
-	 * The lstrip(), rstrip() and strip() functions are implemented
-	 * in do_strip() which uses an additional parameter to indicate what
-	 * type of strip should occur.
-	 */
-	const int LEFTSTRIP = 0;
-	const int RIGHTSTRIP = 1;
-	const int BOTHSTRIP = 2;
+	std::string_view
+	lstrip_view( std::string_view s )
+	{
+	    size_t i = 0;
+	    while (i < s.size() && is_space(s[i]))
+		++i;
+	    return s.substr(i);
+	}
 
-	static string
-	do_strip( const string& s, int striptype )
+	std::string_view
+	rstrip_view( std::string_view s )
 	{
-	    string::size_type len = s.length();
-	    if( len == 0 ) // empty string is trivial
-		return s;
-	    string::size_type i = 0;
-	    if (striptype != RIGHTSTRIP)
-	    {
-		while (i < len && isspace(s[i]))
-		{
-		    ++i;
-		}
-	    }
+	    size_t j = s.size();
+	    while (j > 0 && is_space(s[j - 1]))
+		--j;
+	    return s.substr(0, j);
+	}
 
-	    string::size_type j = len;
-	    if (striptype != LEFTSTRIP)
-	    {
-		do
-		{
-		    --j;
-		}
-		while (j >= 1 && isspace(s[j]));
-		++j;
-	    }
+	std::string_view
+	strip_view( std::string_view s )
+	{
+	    return rstrip_view(lstrip_view(s));
+	}
 
-	    if (i == 0 && j == len)
-	    {
-		return s;
-	    }
-	    else
-	    {
-		return s.substr( i, j - i );
-	    }
+	void
+	strip_inplace( std::string& s )
+	{
+	    const std::string_view stripped = strip_view(s);
+	    const size_t begin = stripped.data() - s.data();
+	    s.erase(begin + stripped.size());
+	    s.erase(0, begin);
 	}
 
 	string
 	lstrip( const string& s )
 	{
-	    return do_strip( s, LEFTSTRIP );
+	    return string(lstrip_view(s));
 	}
 
 	string
 	rstrip( const string& s )
 	{
-	    return do_strip( s, RIGHTSTRIP );
+	    return string(rstrip_view(s));
 	}
 
 	string
 	strip( const string& s )
 	{
-	    return do_strip( s, BOTHSTRIP );
+	    return string(strip_view(s));
 	}
 
     std::string::size_type
@@ -1244,24 +1232,33 @@ std::string error_string(int errnum)
 #endif  // !defined(_GNU_SOURCE)
 }
 
+std::optional<bool> parse_bool(std::string_view s)
+{
+    auto is = [s](std::string_view word) {
+        return s.size() == word.size() &&
+               std::equal(s.begin(), s.end(), word.begin(), [](char a, char b) {
+                   return tolower(static_cast<unsigned char>(a)) == b;
+               });
+    };
+
+    if (is("yes") || is("true") || s == "1") return true;
+    if (is("no") || is("false") || s == "0") return false;
+    return std::nullopt;
+}
+
 bool to_bool(const std::string& s)
 {
-    if (!strcasecmp(s.c_str(), "yes")) return true;
-    if (!strcasecmp(s.c_str(), "no")) return false;
-    if (!strcasecmp(s.c_str(), "true")) return true;
-    if (!strcasecmp(s.c_str(), "false")) return false;
-    if (s == "1") return true;
-    if (s == "0") return false;
-
-    SG_LOG(SG_GENERAL, SG_WARN, "Unable to parse string as boolean:" << s);
-    return false;
+    const auto value = parse_bool(s);
+    if (!value) {
+        SG_LOG(SG_GENERAL, SG_WARN, "Unable to parse string as boolean:" << s);
+        return false;
+    }
+    return *value;
 }
 
 bool is_bool(const std::string& s)
 {
-    const string_list strings = {"yes", "no", "true", "false", "1", "0"};
-    auto it = std::find(strings.begin(), strings.end(), strutils::lowercase(s));
-    return it != strings.end();
+    return parse_bool(s).has_value();
 }
 
 enum PropMatchState
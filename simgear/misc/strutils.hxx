@@ -11,10 +11,15 @@
 #include <simgear/compiler.h>
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <type_traits>
+#include <charconv>
+#include <cstddef>
 #include <cstdlib>
 #include <cstdint>
+#include <iterator>
+#include <optional>
 
 typedef std::vector < std::string > string_list;
 
@@ -114,6 +119,160 @@ split(const std::string& s,
          */
 string_list split_on_any_of(const std::string&, const char* separators);
 
+/**
+      * @name Allocation-free variants
+      * These work on std::string_view and return views into their argument,
+      * which must outlive the result. Prefer them in parsers which handle
+      * many lines.
+      * @{
+      */
+
+/**
+      * Strip leading and/or trailing whitespace, like strip().
+      */
+std::string_view lstrip_view(std::string_view s);
+std::string_view rstrip_view(std::string_view s);
+std::string_view strip_view(std::string_view s);
+
+/**
+      * Strip leading and trailing whitespace from s, in place.
+      */
+void strip_inplace(std::string& s);
+
+/**
+      * Lazy version of split(), producing the same words as views, one
+      * at a time:
+      *
+      *   for (std::string_view field : strutils::split_view(line, ":")) ...
+      *
+      * The string and the separator must outlive the iteration.
+      */
+class SplitView
+{
+public:
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = const std::string_view&;
+
+        iterator() = default;
+
+        reference operator*() const { return _word; }
+        pointer operator->() const { return &_word; }
+
+        iterator& operator++()
+        {
+            next();
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            iterator it = *this;
+            next();
+            return it;
+        }
+
+        bool operator==(const iterator& other) const
+        {
+            if (_done || other._done)
+                return _done == other._done;
+            return _word.data() == other._word.data() && _word.size() == other._word.size();
+        }
+
+        bool operator!=(const iterator& other) const { return !(*this == other); }
+
+    private:
+        friend class SplitView;
+        void next();
+
+        std::string_view _s, _sep;
+        std::string_view _word;
+        size_t _pos = 0;        ///< where the next word starts looking
+        int _maxsplit = 0;
+        int _count = 0;         ///< splits done
+        bool _whitespace = false;
+        bool _rest = false;     ///< the next word is the remainder
+        bool _last = false;     ///< the current word is the last one
+        bool _done = true;
+    };
+
+    SplitView(std::string_view s, const char* sep, int maxsplit) :
+        _s(s), _sep(sep ? sep : ""), _whitespace(sep == nullptr), _maxsplit(maxsplit)
+    {
+    }
+
+    iterator begin() const;
+    iterator end() const { return iterator(); }
+
+private:
+    std::string_view _s, _sep;
+    bool _whitespace;
+    int _maxsplit;
+};
+
+/**
+      * Split like split(), see SplitView.
+      */
+inline SplitView split_view(std::string_view s, const char* sep = nullptr, int maxsplit = 0)
+{
+    return SplitView(s, sep, maxsplit);
+}
+
+/**
+      * Parse all of s as a number with std::from_chars(): no whitespace,
+      * no leading '+', no trailing characters. Integers are range checked.
+      *
+      * @param s     The text to parse
+      * @param value Set to the number on success, untouched otherwise
+      * @param base  Numeration base, for integral types only
+      * @return True if s is a valid number of type T
+      */
+template <class T>
+bool parse_number(std::string_view s, T& value, int base = 10)
+{
+    static_assert(std::is_arithmetic<T>::value, "parse_number() needs an arithmetic type");
+    if (s.empty())
+        return false;
+
+    T result;
+    std::from_chars_result r;
+    if constexpr (std::is_integral<T>::value) {
+        r = std::from_chars(s.data(), s.data() + s.size(), result, base);
+    } else {
+        (void)base;
+#if defined(__cpp_lib_to_chars)
+        r = std::from_chars(s.data(), s.data() + s.size(), result);
+#else
+        // no floating point from_chars() in this standard library
+        if (s[0] == '+' || s[0] == ' ' || (s[0] >= '\t' && s[0] <= '\r'))
+            return false;
+        const std::string copy(s);
+        char* end = nullptr;
+        result = static_cast<T>(std::strtod(copy.c_str(), &end));
+        r.ec = std::errc();
+        r.ptr = s.data() + (end - copy.c_str());
+#endif
+    }
+    if (r.ec != std::errc() || r.ptr != s.data() + s.size())
+        return false;
+
+    value = result;
+    return true;
+}
+
+/**
+      * Parse s as a boolean, accepting the values to_bool() does.
+      * @return The value, or nothing if s isn't a boolean
+      */
+std::optional<bool> parse_bool(std::string_view s);
+
+/** @} */
+
 /**
          * create a single string by joining the elements of a list with
          * another string.
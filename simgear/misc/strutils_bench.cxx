@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Benchmark parsing a large .dirhash file with the copying strutils
+ *        helpers against their string_view variants
+ */
+
+#include <simgear_config.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <simgear/misc/strutils.hxx>
+#include <simgear/misc/test_timing.hxx>
+
+namespace strutils = simgear::strutils;
+
+static const int num_lines = 1000000;
+static const int num_runs = 3;
+
+struct Totals {
+    size_t entries = 0;
+    size_t nameBytes = 0;
+    long long sum = 0;
+};
+
+// What HTTPDirectory::parseHashCache() did before the string_view helpers
+static Totals parseCopying(const std::string& data)
+{
+    Totals t;
+    std::istringstream stream(data);
+    while (!stream.eof()) {
+        std::string line;
+        std::getline(stream, line);
+        line = strutils::strip(line);
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        string_list tokens = strutils::split(line, "*");
+        if (tokens.size() < 4)
+            continue;
+
+        const std::string nameData = strutils::strip(tokens[0]);
+        const std::string timeData = strutils::strip(tokens[1]);
+        const std::string sizeData = strutils::strip(tokens[2]);
+        const std::string hashData = strutils::strip(tokens[3]);
+        if (nameData.empty() || timeData.empty() || sizeData.empty() || hashData.empty())
+            continue;
+
+        ++t.entries;
+        t.nameBytes += nameData.size() + hashData.size();
+        t.sum += strtol(timeData.c_str(), NULL, 10) + strtol(sizeData.c_str(), NULL, 10);
+    }
+    return t;
+}
+
+// ... and what it does now
+static Totals parseViews(const std::string& data)
+{
+    Totals t;
+    std::istringstream stream(data);
+    std::string buffer;
+    while (std::getline(stream, buffer)) {
+        const std::string_view line = strutils::strip_view(buffer);
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::string_view tokens[4];
+        size_t numTokens = 0;
+        for (std::string_view token : strutils::split_view(line, "*")) {
+            if (numTokens == 4)
+                break;
+            tokens[numTokens++] = strutils::strip_view(token);
+        }
+        if (numTokens < 4)
+            continue;
+
+        long modTime;
+        size_t size;
+        if (tokens[0].empty() || tokens[3].empty() ||
+            !strutils::parse_number(tokens[1], modTime) ||
+            !strutils::parse_number(tokens[2], size)) {
+            continue;
+        }
+
+        ++t.entries;
+        t.nameBytes += tokens[0].size() + tokens[3].size();
+        t.sum += modTime + size;
+    }
+    return t;
+}
+
+int main(int argc, char* argv[])
+{
+    std::string data = "#last-modified: Tue, 01 Apr 2025 10:00:00 GMT\n#last-checked:1743501600\n";
+    data.reserve(num_lines * 96);
+    for (int i = 0; i < num_lines; ++i) {
+        data += "/home/user/TerraSync/Objects/e000n50/e007n50/3105" + std::to_string(i) +
+                ".stg*" + std::to_string(1700000000 + i) + "*" + std::to_string(i * 37 % 100000) +
+                "*da39a3ee5e6b4b0d3255bfef95601890afd80709\n";
+    }
+
+    Totals copying, views;
+    const double copying_ms = bestRun(num_runs, [&] { copying = parseCopying(data); }).toMSecs();
+    const double views_ms = bestRun(num_runs, [&] { views = parseViews(data); }).toMSecs();
+
+    std::cout << num_lines << " .dirhash lines\n" << std::fixed << std::setprecision(1)
+              << "split / strip:           " << std::setw(8) << copying_ms << " ms\n"
+              << "split_view / strip_view: " << std::setw(8) << views_ms << " ms ("
+              << copying_ms / std::max(views_ms, 0.1) << "x)\n";
+
+    if (copying.entries != views.entries || copying.nameBytes != views.nameBytes ||
+        copying.sum != views.sum) {
+        std::cerr << "results differ" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
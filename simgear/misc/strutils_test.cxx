@@ -767,6 +767,118 @@ void test_to_bool()
     SG_CHECK_EQUAL(strutils::to_bool("0"), false);
 }
 
+// The string_view variants must give the same results as the originals
+static const char* viewTestCases[] = {
+    "", " ", "  \t\r\n ", "a", " a ", "\ta b\n", "alpha:beta:gamma:delta",
+    ":leading", "trailing:", "::", "a::b", "  alpha  bravo \t charlie ",
+    "name * 1234 * 567 * 0123456789abcdef", "f:foo.btg.gz:abcdef:1234",
+    "a**b**c", "***", "\xc3\xa9t\xc3\xa9 ", "x  y  z  "};
+
+void test_strip_view()
+{
+    for (const char* c : viewTestCases) {
+        const string s(c);
+        // rstrip() used to keep the first character of a blank string
+        if (!strutils::strip(s).empty()) {
+            SG_CHECK_EQUAL(strutils::rstrip_view(s), strutils::rstrip(s));
+        }
+        SG_CHECK_EQUAL(strutils::lstrip_view(s), strutils::lstrip(s));
+        SG_CHECK_EQUAL(strutils::strip_view(s), strutils::strip(s));
+
+        string inplace = s;
+        strutils::strip_inplace(inplace);
+        SG_CHECK_EQUAL(inplace, strutils::strip(s));
+
+        // views into the argument, not copies
+        const std::string_view v = strutils::strip_view(s);
+        SG_VERIFY(v.data() >= s.data() && v.data() + v.size() <= s.data() + s.size());
+    }
+
+    SG_CHECK_EQUAL(strutils::rstrip_view("  "), "");
+    SG_CHECK_EQUAL(strutils::rstrip("  "), "");
+}
+
+void test_split_view()
+{
+    const char* separators[] = {nullptr, ":", "*", "**", " ", "::"};
+    for (const char* c : viewTestCases) {
+        for (const char* sep : separators) {
+            for (int maxsplit : {0, 1, 2, 5}) {
+                const string_list words = strutils::split(c, sep, maxsplit);
+                vector<std::string_view> views;
+                for (std::string_view w : strutils::split_view(c, sep, maxsplit))
+                    views.push_back(w);
+
+                SG_CHECK_EQUAL(views.size(), words.size());
+                for (size_t i = 0; i < words.size(); ++i)
+                    SG_CHECK_EQUAL(views[i], words[i]);
+            }
+        }
+    }
+
+    // lazy: stop half way without looking at the rest
+    const string line = "d:Airports:0123:" + string(1000, 'x');
+    auto it = strutils::split_view(line, ":").begin();
+    SG_CHECK_EQUAL(*it, "d");
+    SG_CHECK_EQUAL(*++it, "Airports");
+    SG_VERIFY(it != strutils::split_view(line, ":").end());
+
+    // empty separators give nothing, like split()
+    SG_VERIFY(strutils::split_view("a", "").begin() == strutils::split_view("a", "").end());
+    SG_CHECK_EQUAL(strutils::split("a", "").size(), 0);
+}
+
+void test_parse_number()
+{
+    for (const char* c : {"0", "1", "-1", "42", "2147483647", "-2147483648", "007"}) {
+        int value = 12345;
+        SG_VERIFY(strutils::parse_number(c, value));
+        SG_CHECK_EQUAL(value, (int)strtol(c, nullptr, 10));
+    }
+
+    // the whole string must be a number, which fits
+    for (const char* c : {"", " 1", "1 ", "+1", "1x", "0x10", "2147483648", "1.5", "-"}) {
+        int value = 12345;
+        SG_VERIFY(!strutils::parse_number(c, value));
+        SG_CHECK_EQUAL(value, 12345);
+    }
+
+    unsigned int u = 0;
+    SG_VERIFY(!strutils::parse_number("-1", u));
+    SG_VERIFY(strutils::parse_number("ff", u, 16));
+    SG_CHECK_EQUAL(u, 255);
+
+    long long big = 0;
+    SG_VERIFY(strutils::parse_number("1712345678901", big));
+    SG_CHECK_EQUAL(big, 1712345678901LL);
+
+    size_t size = 0;
+    SG_VERIFY(strutils::parse_number("123456789", size));
+    SG_CHECK_EQUAL(size, 123456789);
+
+    for (const char* c : {"0", "1.5", "-2.25", "1e3", "3.14159265358979", ".5"}) {
+        double d = 0.0;
+        SG_VERIFY(strutils::parse_number(c, d));
+        SG_CHECK_EQUAL(d, strtod(c, nullptr));
+    }
+    double d = 7.0;
+    SG_VERIFY(!strutils::parse_number("1.5m", d));
+    SG_VERIFY(!strutils::parse_number(" 1.5", d));
+    SG_CHECK_EQUAL(d, 7.0);
+}
+
+void test_parse_bool()
+{
+    for (const char* c : {"yes", "YES", "no", "No", "true", "TrUe", "false", "1", "0",
+                          "", "y", "2", "truex", " true", "nope"}) {
+        const auto value = strutils::parse_bool(c);
+        SG_CHECK_EQUAL(value.has_value(), strutils::is_bool(c));
+        if (value) {
+            SG_CHECK_EQUAL(*value, strutils::to_bool(c));
+        }
+    }
+}
+
 void test_case_convert()
 {
     SG_CHECK_EQUAL(strutils::lowercase("ABcdEf09"), "abcdef09");
@@ -800,6 +912,10 @@ int main(int argc, char* argv[])
     test_makeStringSafeForPropertyName();
     test_case_convert();
     test_to_bool();
+    test_strip_view();
+    test_split_view();
+    test_parse_number();
+    test_parse_bool();
 
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Timing helpers for the SimGear benchmarks
+ */
+
+#pragma once
+
+#include <simgear/timing/timestamp.hxx>
+
+/// Wall-clock time of one call of @a f
+template<class F>
+SGTimeStamp timeRun(F&& f)
+{
+    const SGTimeStamp start = SGTimeStamp::now();
+    f();
+    return SGTimeStamp::now() - start;
+}
+
+/// Shortest of the times of one benchmark section over several runs, as the
+/// machine may be busy with other things. For runs that time more than one
+/// section, or that prepare something before the timed part.
+class BestTime
+{
+public:
+    /// Time one call of @a f, keep it if it is the shortest so far
+    template<class F>
+    void run(F&& f)
+    {
+        const SGTimeStamp t = timeRun(f);
+        if (!_runs++ || t < _best)
+            _best = t;
+    }
+
+    double toUSecs() const { return _best.toUSecs(); }
+    double toMSecs() const { return _best.toMSecs(); }
+
+private:
+    SGTimeStamp _best;
+    int _runs = 0;
+};
+
+/// Shortest time of @a runs calls of @a f
+template<class F>
+SGTimeStamp bestRun(int runs, F&& f)
+{
+    SGTimeStamp best = timeRun(f);
+    for (int run = 1; run < runs; ++run) {
+        const SGTimeStamp t = timeRun(f);
+        if (t < best)
+            best = t;
+    }
+    return best;
+}
@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include <functional>
 #include <map>
 #include <memory>
+#include <string_view>
 
 #include <boost/call_traits.hpp>
 #include <boost/mpl/has_xxx.hpp>
@@ -215,6 +217,7 @@ public:
     using getter_t = std::function<naRef(raw_type&, naContext)>;
     using setter_t = std::function<void(raw_type&, naContext, naRef)>;
     using method_t = std::function<naRef(raw_type&, const CallContext&)>;
+    using method_thunk_t = naRef (*)(raw_type&, const CallContext&);
     using fallback_getter_t =
         std::function<bool(raw_type&, naContext, const std::string&, naRef&)>;
     using fallback_setter_t =
@@ -230,11 +233,20 @@ public:
         {
         }
 
+        /**
+         * Hold a compile-time generated thunk, which is called directly
+         * instead of going through std::function.
+         */
+        explicit MethodHolder(method_thunk_t thunk) : _thunk(thunk)
+        {
+        }
+
     protected:
         using SharedPtr = SGSharedPtr<MethodHolder>;
         using WeakPtr = SGWeakPtr<MethodHolder>;
 
         method_t _method;
+        method_thunk_t _thunk = nullptr;
 
         virtual naRef createNasalObject(naContext c)
         {
@@ -280,9 +292,11 @@ public:
                         _ghost_type_strong.name);
                 }
 
-                return holder->_method(
-                    *get_pointer(ref),
-                    CallContext(c, me, argc, args));
+                const CallContext ctx(c, me, argc, args);
+                if (holder->_thunk)
+                    return holder->_thunk(*get_pointer(ref), ctx);
+
+                return holder->_method(*get_pointer(ref), ctx);
             } catch (const std::exception& ex) {
                 naRuntimeError(c, "Fatal error in method call: %s", ex.what());
             } catch (...) {
@@ -319,7 +333,9 @@ public:
         MethodHolderPtr func;
     };
 
-    using MemberMap = std::map<std::string, member_t>;
+    // Transparent comparator allows looking up members by the raw Nasal
+    // string data, without creating a temporary std::string for every access.
+    using MemberMap = std::map<std::string, member_t, std::less<>>;
 
     /**
        * Register a new ghost type.
@@ -739,12 +755,12 @@ public:
                   const method_variadic_t<Ret, Args...>& func,
                   std::index_sequence<Indices...>)
     {
-        return method<Ret>(name,
-                           typename std::function<Ret(raw_type&, const CallContext&)>(std::bind(func,
-                                                                                                std::placeholders::_1,
-                                                                                                std::bind(&Ghost::arg_from_nasal<Args>,
-                                                                                                          std::placeholders::_2,
-                                                                                                          Indices)...)));
+        return method<Ret>(
+            name,
+            std::function<Ret(raw_type&, const CallContext&)>(
+                [func](raw_type& obj, const CallContext& ctx) -> Ret {
+                    return func(obj, arg_from_nasal<Args>(ctx, Indices)...);
+                }));
     }
 
     template <class Ret, class... Args>
@@ -789,6 +805,27 @@ public:
         return method(name, method_variadic_t<Ret, Args...>(fn));
     }
 
+    /**
+       * Bind a member function (or free function accepting an instance of
+       * raw_type as first argument) known at compile time as method.
+       *
+       * In contrast to the other overloads of method() no std::function is
+       * involved. Instead a thunk calling @a fn directly is generated, and
+       * arguments and return values of arithmetic type are converted inline.
+       * Use this for methods called frequently from Nasal.
+       *
+       * @code{cpp}
+       * Ghost<MyClassPtr>::init("Test")
+       *   .method<&MyClass::setX>("setX");
+       * @endcode
+       */
+    template <auto fn>
+    Ghost& method(const std::string& name)
+    {
+        _members[name].func = new MethodHolder(&Ghost::method_thunk<fn>);
+        return *this;
+    }
+
     /**
        * Create a shared pointer on the heap to handle the reference counting
        * for the passed shared pointer while it is used in Nasal space.
@@ -1136,6 +1173,93 @@ private:
         return ctx;
     };
 
+    /**
+       * Convert argument for a compile-time generated method thunk. Numbers
+       * are converted inline, everything else uses the generic conversion.
+       */
+    template <class Arg>
+    static typename from_nasal_ptr<Arg>::return_type
+    thunk_arg(const CallContext& ctx, size_t index)
+    {
+        using arg_type = std::remove_cvref_t<Arg>;
+        if constexpr (std::is_arithmetic<arg_type>::value && !std::is_same<arg_type, bool>::value) {
+            if (index < ctx.argc && naIsNum(ctx.args[index]))
+                return static_cast<arg_type>(ctx.args[index].num);
+        }
+
+        return arg_from_nasal<Arg>(ctx, index);
+    }
+
+    template <auto fn, class Ret, class... Args, std::size_t... Indices>
+    static naRef thunk_invoke(raw_type& obj,
+                              const CallContext& ctx,
+                              std::index_sequence<Indices...>)
+    {
+        using ret_type = std::remove_cvref_t<Ret>;
+        if constexpr (std::is_void<Ret>::value) {
+            std::invoke(fn, obj, thunk_arg<Args>(ctx, Indices)...);
+            return naNil();
+        } else if constexpr (std::is_arithmetic<ret_type>::value && !std::is_same<ret_type, bool>::value) {
+            return naNum(static_cast<double>(
+                std::invoke(fn, obj, thunk_arg<Args>(ctx, Indices)...)));
+        } else {
+            return (*to_nasal_ptr<Ret>::get())(
+                ctx.c_ctx(),
+                std::invoke(fn, obj, thunk_arg<Args>(ctx, Indices)...));
+        }
+    }
+
+    template <auto fn, class Ret, class Class, class... Args>
+    static naRef thunk_dispatch(raw_type& obj,
+                                const CallContext& ctx,
+                                Ret (Class::*)(Args...))
+    {
+        static_assert(std::is_base_of<Class, raw_type>::value, "Not a method of this class!");
+        return thunk_invoke<fn, Ret, Args...>(obj, ctx, std::index_sequence_for<Args...>{});
+    }
+
+    template <auto fn, class Ret, class Class, class... Args>
+    static naRef thunk_dispatch(raw_type& obj,
+                                const CallContext& ctx,
+                                Ret (Class::*)(Args...) const)
+    {
+        static_assert(std::is_base_of<Class, raw_type>::value, "Not a method of this class!");
+        return thunk_invoke<fn, Ret, Args...>(obj, ctx, std::index_sequence_for<Args...>{});
+    }
+
+    template <auto fn, class Ret, class Type, class... Args>
+    static naRef thunk_dispatch(raw_type& obj,
+                                const CallContext& ctx,
+                                Ret (*)(Type, Args...))
+    {
+        static_assert(
+            std::is_convertible<raw_type&, Type>::value,
+            "First parameter can not be converted from the Ghost raw_type!");
+        return thunk_invoke<fn, Ret, Args...>(obj, ctx, std::index_sequence_for<Args...>{});
+    }
+
+    /**
+       * Method thunk generated for a function known at compile time.
+       */
+    template <auto fn>
+    static naRef method_thunk(raw_type& obj, const CallContext& ctx)
+    {
+        return thunk_dispatch<fn>(obj, ctx, fn);
+    }
+
+    /**
+       * Find a member by its Nasal name. String keys are looked up without
+       * copying, other keys are converted to a string first.
+       */
+    static typename MemberMap::const_iterator
+    findMember(naContext c, const MemberMap& members, naRef key)
+    {
+        if (naIsString(key))
+            return members.find(std::string_view(naStr_data(key), naStr_len(key)));
+
+        return members.find(nasal::from_nasal<std::string>(c, key));
+    }
+
     using GhostPtr = std::unique_ptr<Ghost>;
     MemberMap _members;
     fallback_getter_t _fallback_getter;
@@ -1233,7 +1357,6 @@ private:
                                      naRef key,
                                      naRef* out)
     {
-        const std::string key_str = nasal::from_nasal<std::string>(c, key);
         // TODO merge instance parents with static class parents
         //        if( key_str == "parents" )
         //        {
@@ -1244,10 +1367,12 @@ private:
         //          return "";
         //        }
 
-        auto member = getSingletonPtr()->_members.find(key_str);
-        if (member == getSingletonPtr()->_members.end()) {
-            fallback_getter_t fallback_get = getSingletonPtr()->_fallback_getter;
-            if (!fallback_get || !fallback_get(obj, c, key_str, *out))
+        const MemberMap& members = getSingletonPtr()->_members;
+
+        auto member = findMember(c, members, key);
+        if (member == members.end()) {
+            const fallback_getter_t& fallback_get = getSingletonPtr()->_fallback_getter;
+            if (!fallback_get || !fallback_get(obj, c, nasal::from_nasal<std::string>(c, key), *out))
                 return 0;
         } else if (member->second.func)
             *out = member->second.func->get_naRef(c);
@@ -1288,20 +1413,20 @@ private:
                               naRef field,
                               naRef val)
     {
-        const std::string key = nasal::from_nasal<std::string>(c, field);
         const MemberMap& members = getSingletonPtr()->_members;
 
-        auto member = members.find(key);
+        auto member = findMember(c, members, field);
         if (member == members.end()) {
-            fallback_setter_t fallback_set = getSingletonPtr()->_fallback_setter;
+            const std::string key = nasal::from_nasal<std::string>(c, field);
+            const fallback_setter_t& fallback_set = getSingletonPtr()->_fallback_setter;
             if (!fallback_set)
                 naRuntimeError(c, "ghost: No such member: %s", key.c_str());
             else if (!fallback_set(obj, c, key, val))
                 naRuntimeError(c, "ghost: Failed to write (_set: %s)", key.c_str());
         } else if (!member->second.setter)
-            naRuntimeError(c, "ghost: Write protected member: %s", key.c_str());
+            naRuntimeError(c, "ghost: Write protected member: %s", member->first.c_str());
         else if (member->second.func)
-            naRuntimeError(c, "ghost: Write to function: %s", key.c_str());
+            naRuntimeError(c, "ghost: Write to function: %s", member->first.c_str());
         else
             member->second.setter(obj, c, val);
     }
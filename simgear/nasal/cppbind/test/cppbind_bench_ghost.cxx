@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Benchmark the overhead of calling Ghost methods and members from Nasal
+ *
+ * Compares methods bound through std::function with compile-time generated
+ * method thunks, and measures member lookup.
+ */
+
+#include <iostream>
+
+#include "TestContext.hxx"
+
+#include <simgear/misc/test_timing.hxx>
+#include <simgear/nasal/cppbind/Ghost.hxx>
+
+struct BenchClass {
+    double value = 0;
+
+    void setValue(double v) { value = v; }
+    double getValue() const { return value; }
+    double add(double a, int b) { return value += a + b; }
+};
+using BenchClassPtr = std::shared_ptr<BenchClass>;
+
+static const int num_calls = 1000000;
+
+static void run(TestContext& ctx,
+                const BenchClassPtr& obj,
+                const std::string& label,
+                const std::string& call)
+{
+    const std::string code =
+        "for (var i = 0; i < " + std::to_string(num_calls) + "; i += 1) " + call + ";";
+
+    double usecs = timeRun([&] { ctx.exec(code, ctx.to_me(obj)); }).toUSecs();
+
+    std::cout << label << ": " << (usecs * 1000.0 / num_calls) << " ns/call"
+              << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    nasal::Ghost<BenchClassPtr>::init("BenchClass")
+        .member("value", &BenchClass::getValue, &BenchClass::setValue)
+        .method("addFunction", &BenchClass::add)
+        .method("setFunction", &BenchClass::setValue)
+        .method<&BenchClass::add>("addThunk")
+        .method<&BenchClass::setValue>("setThunk");
+
+    TestContext ctx;
+    auto obj = std::make_shared<BenchClass>();
+
+    // Baseline: empty loop
+    run(ctx, obj, "empty loop         ", "nil");
+
+    run(ctx, obj, "member get         ", "me.value");
+    run(ctx, obj, "member set         ", "me.value = i");
+    run(ctx, obj, "std::function (1)  ", "me.setFunction(i)");
+    run(ctx, obj, "thunk (1)          ", "me.setThunk(i)");
+    run(ctx, obj, "std::function (2)  ", "me.addFunction(0.5, 1)");
+    run(ctx, obj, "thunk (2)          ", "me.addThunk(0.5, 1)");
+
+    return 0;
+}
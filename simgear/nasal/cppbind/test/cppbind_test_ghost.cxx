@@ -232,4 +232,42 @@ BOOST_AUTO_TEST_CASE( bind_methods )
   BOOST_CHECK_EQUAL(test->arg3, "s2");
   BOOST_CHECK_EQUAL(test->arg4, 1);
 }
+
+BOOST_AUTO_TEST_CASE( bind_method_thunks )
+{
+  struct TestClass
+  {
+    int value = 0;
+    std::string name;
+
+    void setValue(int v) { value = v; }
+    double scaled(double f) const { return value * f; }
+    std::string getName() const { return name; }
+    void setName(const std::string& n) { name = n; }
+  };
+  using TestClassPtr = std::shared_ptr<TestClass>;
+  nasal::Ghost<TestClassPtr>::init("TestClassThunk")
+    .method<&TestClass::setValue>("setValue")
+    .method<&TestClass::scaled>("scaled")
+    .method<&TestClass::getName>("getName")
+    .method<&TestClass::setName>("setName");
+
+  TestContext ctx;
+  auto test = std::make_shared<TestClass>();
+
+  ctx.exec("me.setValue(3);", ctx.to_me(test));
+  BOOST_CHECK_EQUAL(test->value, 3);
+
+  // Numeric strings still go through the generic conversion
+  ctx.exec("me.setValue(\"7\");", ctx.to_me(test));
+  BOOST_CHECK_EQUAL(test->value, 7);
+
+  BOOST_CHECK_CLOSE(ctx.exec<double>("return me.scaled(0.5);", ctx.to_me(test)),
+                    3.5, 1e-5);
+
+  ctx.exec("me.setName(\"thunk\");", ctx.to_me(test));
+  BOOST_CHECK_EQUAL(test->name, "thunk");
+  BOOST_CHECK_EQUAL(ctx.exec<std::string>("return me.getName();", ctx.to_me(test)),
+                    "thunk");
+}
 #endif
@@ -377,6 +377,7 @@ void Catalog::parseProps(const SGPropertyNode* aProps)
     m_props = new SGPropertyNode;
 
     m_variantDict.clear(); // will rebuild during parse
+    ++m_revision;
     std::set<PackageRef> orphans;
     orphans.insert(m_packages.begin(), m_packages.end());
 
@@ -723,30 +724,4 @@ int Catalog::markPackagesForInstallation(const string_list &packageIds) {
 
 CatalogRef Catalog::migratedFrom() const { return m_migratedFrom; }
 
-PackageList Catalog::packagesProviding(const Type inferredType, const std::string& directory, const std::string& subpath) const
-{
-    PackageList p;
-    copy_if(m_packages.begin(), m_packages.end(), std::back_inserter(p),
-            [inferredType, &directory, &subpath](const PackageRef& pkg) {
-                // if we detected a package type, it needs to match, so the resulting
-                // path matches as well
-                if (inferredType != AnyPackageType) {
-                    if (inferredType != pkg->type()) {
-                        return false;
-                    }
-                }
-
-                if (directory != pkg->dirName())
-                    return false;
-
-                if (subpath.empty()) {
-                    return true; // we're done, success
-                }
-
-                return pkg->doesProvidePath(subpath);
-            });
-    return p;
-}
-
-
 } // of namespace simgear::pkg
@@ -155,6 +155,7 @@ public:
     class Downloader;
     friend class Downloader;
     friend class Root;
+    friend class PackageIndex;
     
     void parseProps(const SGPropertyNode* aProps);
 
@@ -180,8 +181,6 @@ public:
 
     void processAlternate(SGPropertyNode_ptr alt);
 
-    PackageList packagesProviding(const Type inferredType, const std::string& path, const std::string& subpath) const;
-
     Root* m_root;
     SGPropertyNode_ptr m_props;
     SGPath m_installRoot;
@@ -191,6 +190,8 @@ public:
     bool m_userEnabled = true;
     
     PackageList m_packages;
+    /// bumped whenever the packages are (re-)parsed, so indexes can tell
+    unsigned int m_revision = 0;
     time_t m_retrievedTime = 0;
 
     typedef std::map<std::string, Package*> PackageWeakMap;
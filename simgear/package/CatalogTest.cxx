@@ -1326,6 +1326,197 @@ void testProvides(HTTP::Client* cl)
     SG_CHECK_EQUAL(packages.front()->qualifiedId(), "org.flightgear.test.catalog1.movies");
 }
 
+void testSearch(HTTP::Client* cl)
+{
+    SGPath rootPath(simgear::Dir::current().path());
+    rootPath.append("pkg_search");
+    simgear::Dir pd(rootPath);
+    pd.removeChildren();
+    global_catalogVersion = 0;
+
+    pkg::RootRef root(new pkg::Root(rootPath, "8.1.2"));
+    root->setHTTPClient(cl);
+
+    pkg::CatalogRef c = pkg::Catalog::createFromUrl(root.ptr(), "http://localhost:2000/catalogTest1/catalog.xml");
+    waitForUpdateComplete(cl, root);
+
+    auto boeings = root->search("boeing");
+    SG_CHECK_EQUAL(boeings.size(), 3);
+    SG_VERIFY(contains(boeings, root->getPackageById("b737-ng-ai")));
+    SG_CHECK_EQUAL(root->search("Boeing", pkg::AircraftPackage).size(), 2);
+    SG_CHECK_EQUAL(root->search("boeing", pkg::AnyPackageType, 1).size(), 1);
+
+    // every word has to match
+    auto b747 = root->search("747 boeing");
+    SG_CHECK_EQUAL(b747.size(), 1);
+    SG_CHECK_EQUAL(b747.front()->id(), "b747-400");
+
+    // prefixes, variant IDs, descriptions, provided paths and tags
+    SG_CHECK_EQUAL(root->search("cess").front()->id(), "c172p");
+    SG_CHECK_EQUAL(root->search("c172r").front()->id(), "c172p");
+    SG_CHECK_EQUAL(root->search("jupiter").front()->id(), "c172p");
+    SG_CHECK_EQUAL(root->search("intro.mov").front()->id(), "movies");
+    SG_CHECK_EQUAL(root->search("piston IFR").front()->id(), "c172p");
+
+    // misspellings
+    SG_CHECK_EQUAL(root->search("bowing").size(), 3);
+    SG_CHECK_EQUAL(root->search("jupyter").front()->id(), "c172p");
+
+    // names rank above descriptions
+    auto popular = root->search("popular jet");
+    SG_CHECK_EQUAL(popular.size(), 2);
+    auto floats = root->search("floats");
+    SG_CHECK_EQUAL(floats.size(), 1);
+
+    SG_VERIFY(root->search("").empty());
+    SG_VERIFY(root->search("zzzz").empty());
+    SG_VERIFY(root->search("boeing zzzz").empty());
+
+    // localized descriptions
+    SG_VERIFY(root->search("german").empty());
+    root->setLocale("de");
+    SG_CHECK_EQUAL(root->search("german").size(), 2);
+    SG_CHECK_EQUAL(root->search("german xyz").front()->id(), "b737-NG");
+
+    // refreshing the catalog updates the index
+    global_catalogVersion = 2;
+    root->refresh(true);
+    waitForUpdateComplete(cl, root);
+
+    SG_CHECK_EQUAL(root->search("dc").front()->id(), "dc3");
+    SG_VERIFY(root->search("747").empty());
+    SG_CHECK_EQUAL(root->packagesProviding("Aircraft/dc3", false).size(), 1);
+    SG_VERIFY(root->packagesProviding("Aircraft/b744", false).empty());
+
+    root->removeCatalogById("org.flightgear.test.catalog1");
+    SG_VERIFY(root->search("dc3").empty());
+    SG_VERIFY(!root->getPackageById("dc3"));
+    global_catalogVersion = 0;
+}
+
+class StartOrderDelegate : public pkg::Delegate
+{
+public:
+    void catalogRefreshed(pkg::CatalogRef, StatusCode) override {}
+    void startInstall(pkg::InstallRef aInstall) override
+    {
+        started.push_back(aInstall->package()->id());
+    }
+    void installProgress(pkg::InstallRef, unsigned int, unsigned int) override {}
+    void finishInstall(pkg::InstallRef, StatusCode) override {}
+
+    string_list started;
+};
+
+void testConcurrentInstalls(HTTP::Client*)
+{
+    SGPath rootPath(simgear::Dir::current().path());
+    rootPath.append("pkg_concurrent_installs");
+    simgear::Dir pd(rootPath);
+    pd.removeChildren();
+    global_catalogVersion = 0;
+
+    HTTP::Client cl;
+    cl.setMaxConnections(4);
+
+    pkg::RootRef root(new pkg::Root(rootPath, "8.1.2"));
+    root->setHTTPClient(&cl);
+    SG_CHECK_EQUAL(root->maxConcurrentInstalls(), 1);
+
+    StartOrderDelegate delegate;
+    root->addDelegate(&delegate);
+
+    pkg::CatalogRef c = pkg::Catalog::createFromUrl(root.ptr(), "http://localhost:2000/catalogTest1/catalog.xml");
+    waitForUpdateComplete(&cl, root);
+
+    root->setMaxConcurrentInstalls(2);
+    pkg::PackageRef b737 = root->getPackageById("b737-NG");
+    pkg::PackageRef c172 = root->getPackageById("c172p");
+    pkg::PackageRef alpha = root->getPackageById("alpha");
+    pkg::InstallRef b737Ins = b737->install();
+    pkg::InstallRef c172Ins = c172->install(); // queues common-sounds first
+    pkg::InstallRef alphaIns = alpha->install();
+
+    auto active = root->activeInstalls();
+    SG_CHECK_EQUAL(active.size(), 2);
+    SG_VERIFY(contains(active, b737Ins));
+    SG_VERIFY(contains(active, root->getPackageById("common-sounds")->existingInstall()));
+    SG_VERIFY(!contains(active, c172Ins));
+    SG_VERIFY(root->isInstallQueued(c172Ins));
+    SG_VERIFY(root->isInstallQueued(alphaIns));
+
+    size_t maxActive = 0;
+    SGTimeStamp start(SGTimeStamp::now());
+    while (cl.hasActiveRequests() && (start.elapsedMSec() < 10000)) {
+        cl.update();
+        testServer.poll();
+        maxActive = std::max(maxActive, root->activeInstalls().size());
+        SGTimeStamp::sleepForMSec(15);
+    }
+
+    SG_CHECK_EQUAL(maxActive, 2);
+    SG_VERIFY(root->activeInstalls().empty());
+    SG_CHECK_EQUAL(root->installBytesPerSec(), 0);
+
+    // the smaller of the queued packages went first
+    SG_CHECK_EQUAL(delegate.started.size(), 4);
+    SG_CHECK_EQUAL(delegate.started.at(2), "alpha");
+    SG_CHECK_EQUAL(delegate.started.at(3), "c172p");
+
+    for (auto p : {b737, c172, alpha}) {
+        SG_VERIFY(p->isInstalled());
+        const auto stats = p->existingInstall()->statistics();
+        SG_VERIFY(stats.downloadedBytes > 0);
+        SG_CHECK_EQUAL(stats.downloadedBytes, stats.totalBytes);
+    }
+    SG_CHECK_EQUAL(alphaIns->statistics().downloadedBytes, alpha->fileSizeBytes());
+
+    SGPath p(rootPath / "org.flightgear.test.catalog1" / "Aircraft" / "b737NG" / "b737-900-set.xml");
+    SG_VERIFY(p.exists());
+    root->removeDelegate(&delegate);
+}
+
+void testInstallBandwidthLimit(HTTP::Client*)
+{
+    SGPath rootPath(simgear::Dir::current().path());
+    rootPath.append("pkg_install_bandwidth_limit");
+    simgear::Dir pd(rootPath);
+    pd.removeChildren();
+    global_catalogVersion = 0;
+
+    HTTP::Client cl;
+    cl.setMaxConnections(4);
+
+    pkg::RootRef root(new pkg::Root(rootPath, "8.1.2"));
+    root->setHTTPClient(&cl);
+    SG_CHECK_EQUAL(root->maxInstallBytesPerSec(), 0);
+
+    pkg::CatalogRef c = pkg::Catalog::createFromUrl(root.ptr(), "http://localhost:2000/catalogTest1/catalog.xml");
+    waitForUpdateComplete(&cl, root);
+
+    // any measured rate uses up the limit, so installs run one at a time
+    root->setMaxConcurrentInstalls(2);
+    root->setMaxInstallBytesPerSec(1);
+    pkg::PackageRef b737 = root->getPackageById("b737-NG");
+    pkg::PackageRef alpha = root->getPackageById("alpha");
+    b737->install();
+    alpha->install();
+    SG_CHECK_EQUAL(root->activeInstalls().size(), 1);
+
+    size_t maxActive = 0;
+    SGTimeStamp start(SGTimeStamp::now());
+    while (cl.hasActiveRequests() && (start.elapsedMSec() < 10000)) {
+        cl.update();
+        testServer.poll();
+        maxActive = std::max(maxActive, root->activeInstalls().size());
+        SGTimeStamp::sleepForMSec(15);
+    }
+
+    SG_CHECK_EQUAL(maxActive, 1);
+    SG_VERIFY(b737->isInstalled());
+    SG_VERIFY(alpha->isInstalled());
+}
+
 int main(int argc, char* argv[])
 {
     sglog().setLogLevels( SG_ALL, SG_WARN );
@@ -1377,6 +1568,12 @@ int main(int argc, char* argv[])
 
     testProvides(&cl);
 
+    testSearch(&cl);
+
+    testConcurrentInstalls(&cl);
+
+    testInstallBandwidthLimit(&cl);
+
     cerr << "Successfully passed all tests!" << endl;
     return EXIT_SUCCESS;
 }
@@ -96,6 +96,7 @@ protected:
         }
 
 		m_extractor.reset(new ArchiveExtractor(m_extractPath));
+        m_extractor->setNumWriterThreads(ArchiveExtractor::suggestedNumWriterThreads());
         memset(&m_md5, 0, sizeof(SG_MD5_CTX));
         SG_MD5Init(&m_md5);
 
@@ -134,6 +135,9 @@ protected:
             return;
         }
 
+        m_owner->downloadComplete();
+        const SGTimeStamp finishStarted = SGTimeStamp::now();
+
         unsigned char digest[MD5_DIGEST_LENGTH];
         SG_MD5Final(digest, &m_md5);
         std::string const hex_md5 =
@@ -190,6 +194,7 @@ protected:
 
         m_owner->m_revision = m_owner->package()->revision();
         m_owner->writeRevisionFile();
+        m_owner->m_statistics.finishMSec = finishStarted.elapsedMSec();
         m_owner->m_download.reset(); // so isDownloading reports false
 
         m_owner->installResult(Delegate::STATUS_SUCCESS);
@@ -428,6 +433,8 @@ void Install::installResult(Delegate::StatusCode aReason)
 //------------------------------------------------------------------------------
 void Install::installProgress(unsigned int aBytes, unsigned int aTotal)
 {
+  m_statistics.downloadedBytes = aBytes;
+  m_statistics.totalBytes = aTotal;
   m_package->catalog()->root()->installProgress(this, aBytes, aTotal);
   _cb_progress(this, aBytes, aTotal);
 }
@@ -435,6 +442,26 @@ void Install::installProgress(unsigned int aBytes, unsigned int aTotal)
 void Install::startDownload()
 {
     m_status = Delegate::STATUS_IN_PROGRESS;
+    // restarts with each mirror tried
+    m_statistics = Statistics();
+    m_downloadStarted.stamp();
+    m_downloadComplete = false;
+}
+
+void Install::downloadComplete()
+{
+    m_statistics.downloadMSec = m_downloadStarted.elapsedMSec();
+    m_downloadComplete = true;
+}
+
+Install::Statistics Install::statistics() const
+{
+    Statistics r = m_statistics;
+    if (m_download.valid() && !m_downloadComplete && m_downloadStarted.get_seconds() > 0) {
+        r.downloadMSec = m_downloadStarted.elapsedMSec();
+    }
+
+    return r;
 }
 
 Delegate::StatusCode Install::status() const
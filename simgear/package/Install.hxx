@@ -14,6 +14,7 @@
 #include <simgear/structure/SGReferenced.hxx>
 #include <simgear/structure/SGSharedPtr.hxx>
 #include <simgear/io/HTTPRequest.hxx>
+#include <simgear/timing/timestamp.hxx>
 
 namespace simgear::pkg
 {
@@ -59,6 +60,24 @@ public:
 
     Delegate::StatusCode status() const;
 
+    /**
+     * progress and throughput of the current or most recent download
+     */
+    struct Statistics
+    {
+        size_t downloadedBytes = 0;
+        size_t totalBytes = 0;         ///< 0 until the server reports it
+        unsigned int downloadMSec = 0; ///< so far, or in total once complete
+        unsigned int finishMSec = 0;   ///< completing extraction and moving into place
+
+        unsigned int bytesPerSec() const
+        {
+            return downloadMSec ? static_cast<unsigned int>(downloadedBytes * 1000 / downloadMSec) : 0;
+        }
+    };
+
+    Statistics statistics() const;
+
     /**
      * full path to the primary -set.xml file for this install
      */
@@ -147,6 +166,7 @@ private:
     void installResult(Delegate::StatusCode aReason);
     void installProgress(unsigned int aBytes, unsigned int aTotal);
     void startDownload();
+    void downloadComplete();
 
     PackageRef m_package;
     unsigned int m_revision; ///< revision on disk
@@ -156,6 +176,10 @@ private:
 
     Delegate::StatusCode m_status;
 
+    Statistics m_statistics;
+    SGTimeStamp m_downloadStarted;
+    bool m_downloadComplete = false;
+
     function_list<Callback>         _cb_done,
                                     _cb_fail,
                                     _cb_always;
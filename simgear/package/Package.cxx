@@ -76,6 +76,7 @@ void Package::updateFromProps(const SGPropertyNode* aProps)
 {
     m_tags.clear();
     m_variants.clear();
+    m_provides.clear();
     initWithProps(aProps);
 }
 
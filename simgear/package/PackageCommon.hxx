@@ -34,5 +34,6 @@ typedef SGSharedPtr<Install> InstallRef;
 
 typedef std::vector<PackageRef> PackageList;
 typedef std::vector<CatalogRef> CatalogList;
+typedef std::vector<InstallRef> InstallList;
 
 } // namespace simgear::pkg
@@ -0,0 +1,456 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief In-memory search index over the packages of a pkg::Root
+ */
+
+#include <simgear_config.h>
+
+#include <simgear/package/PackageIndex.hxx>
+
+#include <algorithm>
+#include <cassert>
+
+#include <simgear/package/Catalog.hxx>
+#include <simgear/package/Package.hxx>
+
+namespace simgear::pkg {
+
+namespace {
+
+// how much a match in each field counts
+const float ID_WEIGHT = 8.0f;
+const float NAME_WEIGHT = 6.0f;
+const float TAG_WEIGHT = 4.0f;
+const float PATH_WEIGHT = 3.0f;
+const float DESCRIPTION_WEIGHT = 1.0f;
+
+// ... and how well it matches: a whole word counts fully, the start of
+// a word by how much of it is given, a misspelling least
+const float PREFIX_QUALITY = 0.5f;
+const float PREFIX_LENGTH_QUALITY = 0.3f;
+const float FUZZY_QUALITY = 0.4f;
+
+const size_t MIN_FUZZY_LENGTH = 4;
+const size_t TWO_EDITS_LENGTH = 8;
+
+/**
+ * Edit distance between @a a and @a b, counting insertions, deletions,
+ * substitutions and transpositions of adjacent characters; anything
+ * above @a maxEdits is reported as maxEdits + 1. @a rows is scratch
+ * space, kept by the caller across calls.
+ */
+size_t editDistance(const std::string& a, const std::string& b, size_t maxEdits,
+                    std::vector<size_t>& rows)
+{
+    const size_t n = a.size(), m = b.size();
+    if (((n > m) ? n - m : m - n) > maxEdits) {
+        return maxEdits + 1;
+    }
+
+    rows.resize(3 * (m + 1));
+    size_t* prev2 = rows.data();
+    size_t* prev = prev2 + m + 1;
+    size_t* row = prev + m + 1;
+    for (size_t j = 0; j <= m; ++j) {
+        prev[j] = j;
+    }
+
+    for (size_t i = 1; i <= n; ++i) {
+        row[0] = i;
+        size_t rowMin = row[0];
+        for (size_t j = 1; j <= m; ++j) {
+            const size_t cost = (a[i - 1] == b[j - 1]) ? 0 : 1;
+            row[j] = std::min({prev[j] + 1, row[j - 1] + 1, prev[j - 1] + cost});
+            if ((i > 1) && (j > 1) && (a[i - 1] == b[j - 2]) && (a[i - 2] == b[j - 1])) {
+                row[j] = std::min(row[j], prev2[j - 2] + 1);
+            }
+            rowMin = std::min(rowMin, row[j]);
+        }
+
+        if (rowMin > maxEdits) {
+            return maxEdits + 1;
+        }
+
+        std::swap(prev2, prev);
+        std::swap(prev, row);
+    }
+
+    return std::min(prev[m], maxEdits + 1);
+}
+
+} // of anonymous namespace
+
+string_list PackageIndex::tokenize(const std::string& text)
+{
+    string_list result;
+    std::string word;
+    for (char c : text) {
+        const auto u = static_cast<unsigned char>(c);
+        if ((u >= 'a' && u <= 'z') || (u >= '0' && u <= '9') || (u >= 0x80)) {
+            // bytes of UTF-8 sequences are kept as they are
+            word.push_back(c);
+        } else if (u >= 'A' && u <= 'Z') {
+            word.push_back(static_cast<char>(u - 'A' + 'a'));
+        } else if (!word.empty()) {
+            result.push_back(word);
+            word.clear();
+        }
+    }
+
+    if (!word.empty()) {
+        result.push_back(word);
+    }
+    return result;
+}
+
+void PackageIndex::sync(const CatalogList& catalogs, const std::string& locale)
+{
+    if (locale != m_locale) {
+        // localised names and descriptions are indexed too
+        clear();
+        m_locale = locale;
+    }
+
+    for (auto it = m_catalogs.begin(); it != m_catalogs.end();) {
+        if (std::find(catalogs.begin(), catalogs.end(), it->second.catalog) == catalogs.end()) {
+            removeSlots(it->second.slots);
+            it = m_catalogs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (const auto& cat : catalogs) {
+        auto it = m_catalogs.find(cat.ptr());
+        if (it != m_catalogs.end()) {
+            if (it->second.revision == cat->m_revision) {
+                continue; // unchanged
+            }
+
+            removeSlots(it->second.slots);
+            m_catalogs.erase(it);
+        }
+
+        addCatalog(cat, locale);
+    }
+}
+
+void PackageIndex::removeCatalog(Catalog* catalog)
+{
+    auto it = m_catalogs.find(catalog);
+    if (it == m_catalogs.end()) {
+        return;
+    }
+
+    removeSlots(it->second.slots);
+    m_catalogs.erase(it);
+}
+
+void PackageIndex::clear()
+{
+    m_packages.clear();
+    m_freeSlots.clear();
+    m_catalogs.clear();
+    m_terms.clear();
+    m_ids.clear();
+    m_dirs.clear();
+}
+
+void PackageIndex::addCatalog(const CatalogRef& catalog, const std::string& locale)
+{
+    IndexedCatalog& ic = m_catalogs[catalog.ptr()];
+    ic.catalog = catalog;
+    ic.revision = catalog->m_revision;
+
+    unsigned int ordinal = 0;
+    for (const auto& p : catalog->m_packages) {
+        ic.slots.push_back(addPackage(p, ordinal++, locale));
+    }
+}
+
+uint32_t PackageIndex::addPackage(const PackageRef& package, unsigned int ordinal, const std::string& locale)
+{
+    uint32_t slot;
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(m_packages.size());
+        m_packages.emplace_back();
+    }
+
+    Entry& e = m_packages[slot];
+    e.package = package;
+    e.catalogId = package->catalog()->id();
+    e.ordinal = ordinal;
+    e.sortKey = strutils::lowercase(package->name());
+
+    std::map<std::string, float> terms;
+    auto addText = [&terms](const std::string& text, float weight, size_t minLength = 1) {
+        for (auto& t : tokenize(text)) {
+            if (t.size() < minLength) {
+                continue;
+            }
+            float& w = terms[t];
+            w = std::max(w, weight);
+        }
+    };
+
+    const SGPropertyNode* props = package->properties();
+    const string_list variants = package->variants();
+    for (unsigned int v = 0; v < variants.size(); ++v) {
+        e.ids.push_back(variants[v]);
+        addText(variants[v], ID_WEIGHT);
+
+        const SGPropertyNode* vp = (v == 0) ? props : props->getChild("variant", v - 1);
+        if (!vp) {
+            continue;
+        }
+
+        addText(vp->getStringValue("name"), NAME_WEIGHT);
+        addText(vp->getStringValue("description"), DESCRIPTION_WEIGHT, 2);
+        if (!locale.empty()) {
+            addText(package->nameForVariant(v), NAME_WEIGHT);
+            addText(package->getLocalisedProp("description", v), DESCRIPTION_WEIGHT, 2);
+        }
+    }
+
+    for (const auto& tag : package->tags()) {
+        addText(tag, TAG_WEIGHT);
+    }
+
+    e.dir = props->getStringValue("dir");
+    addText(e.dir, PATH_WEIGHT);
+    for (const auto& path : package->providesPaths()) {
+        addText(path, PATH_WEIGHT);
+    }
+
+    for (const auto& t : terms) {
+        m_terms[t.first].push_back({slot, t.second});
+        e.terms.push_back(t.first);
+    }
+
+    for (const auto& id : e.ids) {
+        m_ids[id].push_back(slot);
+    }
+    if (!e.dir.empty()) {
+        m_dirs[e.dir].push_back(slot);
+    }
+
+    return slot;
+}
+
+void PackageIndex::removeSlots(const std::vector<uint32_t>& slots)
+{
+    if (slots.empty()) {
+        return;
+    }
+
+    // collect the affected keys first, so each posting list is only
+    // filtered once, however many of its packages go
+    std::vector<bool> removed(m_packages.size(), false);
+    string_list terms, ids, dirs;
+    for (auto slot : slots) {
+        removed[slot] = true;
+        const Entry& e = m_packages[slot];
+        terms.insert(terms.end(), e.terms.begin(), e.terms.end());
+        ids.insert(ids.end(), e.ids.begin(), e.ids.end());
+        if (!e.dir.empty()) {
+            dirs.push_back(e.dir);
+        }
+    }
+
+    auto unique = [](string_list& keys) {
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    };
+    unique(terms);
+    unique(ids);
+    unique(dirs);
+
+    for (const auto& t : terms) {
+        auto it = m_terms.find(t);
+        assert(it != m_terms.end());
+        auto& postings = it->second;
+        postings.erase(std::remove_if(postings.begin(), postings.end(),
+                                      [&removed](const Posting& p) { return removed[p.slot]; }),
+                       postings.end());
+        if (postings.empty()) {
+            m_terms.erase(it);
+        }
+    }
+
+    auto removeFrom = [&removed](std::unordered_map<std::string, std::vector<uint32_t>>& map,
+                                 const string_list& keys) {
+        for (const auto& k : keys) {
+            auto it = map.find(k);
+            assert(it != map.end());
+            auto& v = it->second;
+            v.erase(std::remove_if(v.begin(), v.end(), [&removed](uint32_t s) { return removed[s]; }),
+                    v.end());
+            if (v.empty()) {
+                map.erase(it);
+            }
+        }
+    };
+    removeFrom(m_ids, ids);
+    removeFrom(m_dirs, dirs);
+
+    for (auto slot : slots) {
+        m_packages[slot] = Entry();
+        m_freeSlots.push_back(slot);
+    }
+}
+
+bool PackageIndex::inCatalogOrder(uint32_t a, uint32_t b) const
+{
+    const Entry& ea = m_packages[a];
+    const Entry& eb = m_packages[b];
+    if (ea.catalogId != eb.catalogId) {
+        return ea.catalogId < eb.catalogId;
+    }
+    return ea.ordinal < eb.ordinal;
+}
+
+PackageRef PackageIndex::packageById(const std::string& id) const
+{
+    auto it = m_ids.find(id);
+    if (it == m_ids.end()) {
+        return {};
+    }
+
+    const auto best = *std::min_element(it->second.begin(), it->second.end(),
+                                        [this](uint32_t a, uint32_t b) { return inCatalogOrder(a, b); });
+
+    // let the catalog resolve the ID, in case a variant ID is used twice in it
+    return m_packages[best].package->catalog()->getPackageById(id);
+}
+
+PackageList PackageIndex::packagesInDirectory(const std::string& dir) const
+{
+    auto it = m_dirs.find(dir);
+    if (it == m_dirs.end()) {
+        return {};
+    }
+
+    std::vector<uint32_t> slots = it->second;
+    std::sort(slots.begin(), slots.end(),
+              [this](uint32_t a, uint32_t b) { return inCatalogOrder(a, b); });
+
+    PackageList result;
+    result.reserve(slots.size());
+    for (auto s : slots) {
+        result.push_back(m_packages[s].package);
+    }
+    return result;
+}
+
+void PackageIndex::matchTerm(const std::string& term, std::vector<float>& scores) const
+{
+    auto addPostings = [&scores](const std::vector<Posting>& postings, float quality) {
+        for (const auto& p : postings) {
+            float& s = scores[p.slot];
+            s = std::max(s, p.weight * quality);
+        }
+    };
+
+    bool found = false;
+    for (auto it = m_terms.lower_bound(term);
+         (it != m_terms.end()) && strutils::starts_with(it->first, term); ++it) {
+        float quality = 1.0f;
+        if (it->first.size() > term.size()) {
+            quality = PREFIX_QUALITY + PREFIX_LENGTH_QUALITY * term.size() / it->first.size();
+        }
+
+        addPostings(it->second, quality);
+        found = true;
+    }
+
+    if (found || (term.size() < MIN_FUZZY_LENGTH)) {
+        return;
+    }
+
+    const size_t maxEdits = (term.size() >= TWO_EDITS_LENGTH) ? 2 : 1;
+    std::vector<size_t> rows;
+    for (const auto& t : m_terms) {
+        const size_t d = editDistance(term, t.first, maxEdits, rows);
+        if (d <= maxEdits) {
+            addPostings(t.second, FUZZY_QUALITY / d);
+        }
+    }
+}
+
+PackageIndex::ResultList PackageIndex::search(const std::string& query, Type ty, size_t maxResults) const
+{
+    const string_list words = tokenize(query);
+    if (words.empty()) {
+        return {};
+    }
+
+    // scores by slot, zero for packages which don't match; every word
+    // has to match
+    std::vector<float> scores, wordScores;
+    std::vector<uint32_t> candidates;
+    for (size_t i = 0; i < words.size(); ++i) {
+        wordScores.assign(m_packages.size(), 0.0f);
+        matchTerm(words[i], wordScores);
+        if (i == 0) {
+            for (uint32_t slot = 0; slot < wordScores.size(); ++slot) {
+                if (wordScores[slot] > 0.0f) {
+                    candidates.push_back(slot);
+                }
+            }
+            scores.swap(wordScores);
+        } else {
+            candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                            [&wordScores](uint32_t s) { return wordScores[s] == 0.0f; }),
+                             candidates.end());
+            for (auto slot : candidates) {
+                scores[slot] += wordScores[slot];
+            }
+        }
+
+        if (candidates.empty()) {
+            return {};
+        }
+    }
+
+    std::vector<std::pair<uint32_t, float>> ranked;
+    ranked.reserve(candidates.size());
+    for (auto slot : candidates) {
+        if ((ty == AnyPackageType) || (m_packages[slot].package->type() == ty)) {
+            ranked.emplace_back(slot, scores[slot]);
+        }
+    }
+
+    auto better = [this](const std::pair<uint32_t, float>& a, const std::pair<uint32_t, float>& b) {
+        if (a.second != b.second) {
+            return a.second > b.second;
+        }
+
+        const Entry& ea = m_packages[a.first];
+        const Entry& eb = m_packages[b.first];
+        if (ea.sortKey != eb.sortKey) {
+            return ea.sortKey < eb.sortKey;
+        }
+        return inCatalogOrder(a.first, b.first);
+    };
+
+    if ((maxResults > 0) && (maxResults < ranked.size())) {
+        std::partial_sort(ranked.begin(), ranked.begin() + maxResults, ranked.end(), better);
+        ranked.resize(maxResults);
+    } else {
+        std::sort(ranked.begin(), ranked.end(), better);
+    }
+
+    ResultList result;
+    result.reserve(ranked.size());
+    for (const auto& r : ranked) {
+        result.push_back({m_packages[r.first].package, r.second});
+    }
+    return result;
+}
+
+} // of namespace simgear::pkg
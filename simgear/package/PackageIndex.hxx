@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief In-memory search index over the packages of a pkg::Root
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <simgear/misc/strutils.hxx>
+#include <simgear/package/PackageCommon.hxx>
+
+namespace simgear::pkg
+{
+
+/**
+ * Inverted index over the package IDs, names, tags, provided paths and
+ * descriptions of a set of catalogs, used by Root for lookups and search
+ * instead of walking every package of every catalog.
+ *
+ * The index is brought up to date by sync(), which only re-indexes
+ * catalogs whose contents changed (Catalog::parseProps() bumps their
+ * revision) and drops catalogs which are no longer passed in.
+ */
+class PackageIndex
+{
+public:
+    struct Result {
+        PackageRef package;
+        double score = 0.0;
+    };
+
+    typedef std::vector<Result> ResultList;
+
+    /**
+     * Index @a catalogs, which must be ordered by ID; texts are indexed
+     * in @a locale as well as unlocalized.
+     */
+    void sync(const CatalogList& catalogs, const std::string& locale);
+
+    void removeCatalog(Catalog* catalog);
+    void clear();
+
+    /// The package or variant @a id, from the first catalog which has it
+    PackageRef packageById(const std::string& id) const;
+
+    /// Packages installed into directory @a dir, in catalog order
+    PackageList packagesInDirectory(const std::string& dir) const;
+
+    /**
+     * Packages matching every word of @a query, best first. A word
+     * matches a whole indexed word, or the start of one; words which
+     * match neither are looked up as misspellings, allowing one edit
+     * (two for longer words).
+     * @param maxResults limit on the number of results, 0 for all of them
+     */
+    ResultList search(const std::string& query, Type ty = AnyPackageType,
+                      size_t maxResults = 0) const;
+
+    size_t numPackages() const { return m_packages.size() - m_freeSlots.size(); }
+    size_t numTerms() const { return m_terms.size(); }
+
+    /// Lower-cased words of @a text: runs of letters and digits
+    static string_list tokenize(const std::string& text);
+
+private:
+    struct Posting {
+        uint32_t slot;
+        float weight;
+    };
+
+    struct Entry {
+        PackageRef package;
+        std::string catalogId;
+        unsigned int ordinal = 0; ///< within its catalog
+        std::string sortKey;      ///< lower-cased name
+        string_list terms;        ///< the terms it is indexed under
+        string_list ids;
+        std::string dir;
+    };
+
+    struct IndexedCatalog {
+        CatalogRef catalog;
+        unsigned int revision = 0;
+        std::vector<uint32_t> slots;
+    };
+
+    void addCatalog(const CatalogRef& catalog, const std::string& locale);
+    void removeSlots(const std::vector<uint32_t>& slots);
+    uint32_t addPackage(const PackageRef& package, unsigned int ordinal, const std::string& locale);
+    /// set the scores (by slot) of the packages matching @a term
+    void matchTerm(const std::string& term, std::vector<float>& scores) const;
+    bool inCatalogOrder(uint32_t a, uint32_t b) const;
+
+    std::vector<Entry> m_packages;
+    std::vector<uint32_t> m_freeSlots;
+    std::map<Catalog*, IndexedCatalog> m_catalogs;
+    std::string m_locale;
+
+    /// ordered, for prefix searches
+    std::map<std::string, std::vector<Posting>> m_terms;
+    std::unordered_map<std::string, std::vector<uint32_t>> m_ids;
+    std::unordered_map<std::string, std::vector<uint32_t>> m_dirs;
+};
+
+} // of namespace simgear::pkg
@@ -24,6 +24,7 @@
 #include <simgear/package/Package.hxx>
 #include <simgear/package/Install.hxx>
 #include <simgear/package/Catalog.hxx>
+#include <simgear/package/PackageIndex.hxx>
 
 const int SECONDS_PER_DAY = 24 * 60 * 60;
 
@@ -302,6 +303,71 @@ public:
       } // of lines iteration
     }
 
+    /**
+     * bring the index up to date with the enabled catalogs, re-indexing
+     * those which were refreshed since
+     */
+    const PackageIndex& syncedIndex()
+    {
+        CatalogList cats;
+        cats.reserve(catalogs.size());
+        for (const auto& c : catalogs) {
+            cats.push_back(c.second);
+        }
+
+        index.sync(cats, locale);
+        return index;
+    }
+
+    bool isActiveInstall(const InstallRef& ins) const
+    {
+        return std::find(activeInstalls.begin(), activeInstalls.end(), ins) != activeInstalls.end();
+    }
+
+    InstallRef nextInstallToStart() const
+    {
+        if (updateDeque.empty()) {
+            return {};
+        }
+
+        // the longest-queued install first, so everything makes progress
+        if (!isActiveInstall(updateDeque.front())) {
+            return updateDeque.front();
+        }
+
+        // then the smallest, so they don't wait behind large downloads
+        InstallRef smallest;
+        for (const auto& ins : updateDeque) {
+            if (isActiveInstall(ins)) {
+                continue;
+            }
+
+            if (!smallest || (ins->package()->fileSizeBytes() < smallest->package()->fileSizeBytes())) {
+                smallest = ins;
+            }
+        }
+
+        return smallest;
+    }
+
+    bool hasSpareInstallBandwidth() const
+    {
+        if (maxInstallBytesPerSec == 0) {
+            return true;
+        }
+
+        unsigned int total = 0;
+        for (const auto& ins : activeInstalls) {
+            const unsigned int rate = ins->statistics().bytesPerSec();
+            if (rate == 0) {
+                return false; // not measured yet, wait for it
+            }
+            total += rate;
+        }
+
+        return total < maxInstallBytesPerSec;
+    }
+
     void flushPendingRequests()
     {
         for (auto req : httpPendingRequests) {
@@ -318,13 +384,17 @@ public:
     HTTP::Client* http;
     CatalogDict catalogs;
     CatalogList disabledCatalogs;
+    PackageIndex index;
     unsigned int maxAgeSeconds;
     std::string version;
     bool isOnline = true;
 
     std::set<CatalogRef> refreshing;
     typedef std::deque<InstallRef> UpdateDeque;
-    UpdateDeque updateDeque;
+    UpdateDeque updateDeque; ///< queued installs, including the active ones
+    InstallList activeInstalls;
+    unsigned int maxConcurrentInstalls = 1;
+    unsigned int maxInstallBytesPerSec = 0;
     std::deque<HTTP::Request_ptr> httpPendingRequests;
 
     HTTP::Request_ptr thumbnailDownloadRequest;
@@ -505,18 +575,9 @@ PackageRef Root::getPackageById(const std::string& aName) const
 {
     size_t lastDot = aName.rfind('.');
 
-    PackageRef pkg = NULL;
     if (lastDot == std::string::npos) {
-        // naked package ID
-        CatalogDict::const_iterator it = d->catalogs.begin();
-        for (; it != d->catalogs.end(); ++it) {
-            pkg = it->second->getPackageById(aName);
-            if (pkg) {
-                return pkg;
-            }
-        }
-
-        return NULL;
+        // naked package ID: from the first catalog which has it
+        return d->syncedIndex().packageById(aName);
     }
 
     std::string catalogId = aName.substr(0, lastDot);
@@ -529,6 +590,16 @@ PackageRef Root::getPackageById(const std::string& aName) const
     return catalog->getPackageById(id);
 }
 
+PackageList Root::search(const std::string& aQuery, Type ty, size_t aMaxResults) const
+{
+    PackageList r;
+    for (const auto& result : d->syncedIndex().search(aQuery, ty, aMaxResults)) {
+        r.push_back(result.package);
+    }
+
+    return r;
+}
+
 CatalogList Root::catalogs() const
 {
     CatalogList r;
@@ -659,13 +730,10 @@ void Root::scheduleToUpdate(InstallRef aInstall)
         dep->install();
     }
 
-    bool wasEmpty = d->updateDeque.empty();
     d->updateDeque.push_back(aInstall);
 
     d->fireStatusChange(aInstall, Delegate::STATUS_IN_PROGRESS);
-    if (wasEmpty) {
-        aInstall->startUpdate();
-    }
+    startQueuedInstalls();
 }
 
 void Root::scheduleAllUpdates() {
@@ -689,19 +757,84 @@ void Root::startInstall(InstallRef aInstall)
 void Root::installProgress(InstallRef aInstall, unsigned int aBytes, unsigned int aTotal)
 {
     d->fireInstallProgress(aInstall, aBytes, aTotal);
+
+    // the measured rates changed, maybe there is room for another install
+    if (d->maxInstallBytesPerSec > 0) {
+        startQueuedInstalls();
+    }
+}
+
+void Root::setMaxConcurrentInstalls(unsigned int count)
+{
+    d->maxConcurrentInstalls = std::max(count, 1U);
+    startQueuedInstalls();
+}
+
+unsigned int Root::maxConcurrentInstalls() const
+{
+    return d->maxConcurrentInstalls;
+}
+
+InstallList Root::activeInstalls() const
+{
+    return d->activeInstalls;
+}
+
+unsigned int Root::installBytesPerSec() const
+{
+    unsigned int r = 0;
+    for (const auto& ins : d->activeInstalls) {
+        r += ins->statistics().bytesPerSec();
+    }
+
+    return r;
+}
+
+void Root::setMaxInstallBytesPerSec(unsigned int bytesPerSec)
+{
+    d->maxInstallBytesPerSec = bytesPerSec;
+    startQueuedInstalls();
+}
+
+unsigned int Root::maxInstallBytesPerSec() const
+{
+    return d->maxInstallBytesPerSec;
+}
+
+void Root::startQueuedInstalls()
+{
+    while (d->activeInstalls.size() < d->maxConcurrentInstalls) {
+        if (!d->activeInstalls.empty() && !d->hasSpareInstallBandwidth()) {
+            break;
+        }
+
+        InstallRef next = d->nextInstallToStart();
+        if (!next) {
+            break;
+        }
+
+        // mark it active first: starting can finish it already, and
+        // re-enter here from finishInstall
+        d->activeInstalls.push_back(next);
+        next->startUpdate();
+    }
 }
 
 void Root::startNext(InstallRef aCurrent)
 {
-	if (d->updateDeque.empty() || (d->updateDeque.front() != aCurrent)) {
-        SG_LOG(SG_GENERAL, SG_ALERT, "current install of package not head of the deque");
+    auto it = std::find(d->updateDeque.begin(), d->updateDeque.end(), aCurrent);
+    if (it == d->updateDeque.end()) {
+        SG_LOG(SG_GENERAL, SG_ALERT, "finished install of package which was not queued");
     } else {
-        d->updateDeque.pop_front();
+        d->updateDeque.erase(it);
     }
 
-    if (!d->updateDeque.empty()) {
-        d->updateDeque.front()->startUpdate();
+    auto a = std::find(d->activeInstalls.begin(), d->activeInstalls.end(), aCurrent);
+    if (a != d->activeInstalls.end()) {
+        d->activeInstalls.erase(a);
     }
+
+    startQueuedInstalls();
 }
 
 void Root::finishInstall(InstallRef aInstall, Delegate::StatusCode aReason)
@@ -721,15 +854,14 @@ void Root::cancelDownload(InstallRef aInstall)
 {
     auto it = std::find(d->updateDeque.begin(), d->updateDeque.end(), aInstall);
     if (it != d->updateDeque.end()) {
-        bool startNext = (aInstall == d->updateDeque.front());
         d->updateDeque.erase(it);
-        d->fireStatusChange(aInstall, Delegate::USER_CANCELLED);
+        auto a = std::find(d->activeInstalls.begin(), d->activeInstalls.end(), aInstall);
+        if (a != d->activeInstalls.end()) {
+            d->activeInstalls.erase(a);
+        }
 
-        if (startNext) {
-            if (!d->updateDeque.empty()) {
-                d->updateDeque.front()->startUpdate();
-            }
-        } // of install was front item
+        d->fireStatusChange(aInstall, Delegate::USER_CANCELLED);
+        startQueuedInstalls();
     } // of found install in queue
 }
 
@@ -801,6 +933,7 @@ bool Root::removeCatalog(CatalogRef cat)
     if (!cat->removeDirectory()) {
         SG_LOG(SG_GENERAL, SG_WARN, "removeCatalog: failed to remove directory " << cat->installRoot());
     }
+    d->index.removeCatalog(cat);
     auto it = std::find(d->disabledCatalogs.begin(),
                        d->disabledCatalogs.end(),
                        cat);
@@ -836,6 +969,8 @@ bool Root::removeCatalogById(const std::string& aId)
         d->catalogs.erase(catIt);
     }
 
+    d->index.removeCatalog(cat);
+
     bool ok = cat->removeDirectory();
     if (!ok) {
         SG_LOG(SG_GENERAL, SG_WARN, "removeCatalogById: catalog :" << aId
@@ -940,11 +1075,17 @@ PackageList Root::packagesProviding(const std::string& path, bool onlyInstalled)
         modPath.resize(firstSeperatorPos);
     }
 
-    PackageList r;
-    for (auto cat : d->catalogs) {
-        const auto p = cat.second->packagesProviding(inferredType, modPath, subPath);
-        r.insert(r.end(), p.begin(), p.end());
-    } // catalog iteratrion
+    PackageList r = d->syncedIndex().packagesInDirectory(modPath);
+    auto notProviding = [inferredType, &subPath](const PackageRef& pkg) {
+        // if we detected a package type, it needs to match, so the resulting
+        // path matches as well
+        if ((inferredType != AnyPackageType) && (inferredType != pkg->type())) {
+            return true;
+        }
+
+        return !subPath.empty() && !pkg->doesProvidePath(subPath);
+    };
+    r.erase(std::remove_if(r.begin(), r.end(), notProviding), r.end());
 
     if (onlyInstalled) {
         auto it = std::remove_if(r.begin(), r.end(), [](const PackageRef& p) {
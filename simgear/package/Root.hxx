@@ -113,6 +113,21 @@ public:
 
     PackageRef getPackageById(const std::string& aId) const;
 
+    /**
+     * Search the packages of all enabled catalogs for the words in
+     * @a aQuery, matched against package and variant IDs, names, tags,
+     * directory and provided paths and descriptions. Every word has to
+     * match a whole word, or the start of one; a word which matches
+     * neither is looked up as a misspelling instead.
+     *
+     * @return the matching packages, with the best matches (IDs and names
+     * over tags, paths and descriptions; whole words over partial ones)
+     * first
+     * @param aMaxResults limit on the number of results, 0 for all of them
+     */
+    PackageList search(const std::string& aQuery, Type ty = AnyPackageType,
+                       size_t aMaxResults = 0) const;
+
     CatalogRef getCatalogById(const std::string& aId) const;
 
     CatalogRef getCatalogByUrl(const std::string& aUrl) const;
@@ -139,6 +154,36 @@ public:
 
     bool isInstallQueued(InstallRef aInstall) const;
 
+    /**
+     * Set how many queued installs may download and extract at once; with
+     * the default of 1 they run one after another. The longest-queued
+     * install always gets a slot, further ones go to the smallest queued
+     * packages, so small updates don't wait behind large downloads, as
+     * long as there is bandwidth left: see setMaxInstallBytesPerSec().
+     */
+    void setMaxConcurrentInstalls(unsigned int count);
+    unsigned int maxConcurrentInstalls() const;
+
+    /**
+     * queued installs which are currently downloading / extracting
+     */
+    InstallList activeInstalls() const;
+
+    /**
+     * combined download rate of the active installs, in bytes per second
+     */
+    unsigned int installBytesPerSec() const;
+
+    /**
+     * Combined download rate above which no further installs are started,
+     * in bytes per second; 0, the default, means no limit. With a limit,
+     * an install beyond the first only starts once every active install
+     * has measured its rate and installBytesPerSec() is below the limit,
+     * so downloads don't split a link which is already saturated.
+     */
+    void setMaxInstallBytesPerSec(unsigned int bytesPerSec);
+    unsigned int maxInstallBytesPerSec() const;
+
     /**
      * Mark all 'to be updated' packages for update now
      */
@@ -178,6 +223,7 @@ private:
     void catalogRefreshStatus(CatalogRef aCat, Delegate::StatusCode aReason);
 
     void startNext(InstallRef aCurrent);
+    void startQueuedInstalls();
 
     void startInstall(InstallRef aInstall);
     void installProgress(InstallRef aInstall, unsigned int aBytes, unsigned int aTotal);
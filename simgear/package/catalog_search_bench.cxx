@@ -0,0 +1,194 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Benchmark package lookups and search on generated catalogs of
+ *        20000 packages, in the format of catalogTest1
+ */
+
+#include <simgear_config.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <simgear/debug/logstream.hxx>
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/misc/sg_dir.hxx>
+#include <simgear/misc/test_timing.hxx>
+#include <simgear/package/Catalog.hxx>
+#include <simgear/package/Package.hxx>
+#include <simgear/package/Root.hxx>
+#include <simgear/props/props.hxx>
+
+using namespace simgear;
+
+static const int num_catalogs = 4;
+static const int num_packages = 20000;
+static const int num_lookups = 2000;
+static const int num_queries = 200;
+
+static const char* words[] = {
+    "alpine", "boeing", "cessna", "douglas", "electric", "fokker", "glider", "heavy",
+    "islander", "jet", "kitfox", "liner", "mooney", "navy", "osprey", "piper",
+    "quest", "rotor", "seaplane", "trainer", "ultralight", "vintage", "warbird", "zeppelin"};
+static const int num_words = sizeof(words) / sizeof(words[0]);
+
+static std::string word(int i)
+{
+    return words[i % num_words];
+}
+
+static void writeCatalog(const SGPath& dir, int c)
+{
+    Dir(dir).create(0755);
+    sg_ofstream xml(dir / "catalog.xml", std::ios::out | std::ios::trunc);
+    xml << "<?xml version=\"1.0\"?>\n<PropertyList>\n"
+        << "<id>org.flightgear.bench.catalog" << c << "</id>\n"
+        << "<url>http://localhost:2000/bench" << c << "/catalog.xml</url>\n"
+        << "<catalog-version>4</catalog-version>\n<version>8.1.*</version>\n";
+
+    for (int p = c; p < num_packages; p += num_catalogs) {
+        xml << "<package>\n"
+            << "  <id>pkg" << p << "</id>\n"
+            << "  <name>" << word(p) << " " << word(p / 7) << " " << p << "</name>\n"
+            << "  <dir>dir" << p << "</dir>\n"
+            << "  <description>A " << word(p / 3) << " model of the " << word(p / 11) << " "
+            << word(p / 13) << " with a detailed cockpit</description>\n"
+            << "  <revision type=\"int\">" << p % 17 << "</revision>\n"
+            << "  <file-size-bytes type=\"int\">1000</file-size-bytes>\n"
+            << "  <md5>a469c4b837f0521db48616cfe65ac1ea</md5>\n"
+            << "  <url>http://localhost:2000/pkg" << p << ".zip</url>\n"
+            << "  <tag>" << word(p / 5) << "</tag>\n  <tag>" << word(p / 17) << "</tag>\n"
+            << "  <provides>Models/" << word(p) << p << ".xml</provides>\n"
+            << "  <variant>\n    <id>pkg" << p << "-v</id>\n    <name>" << word(p)
+            << " variant</name>\n  </variant>\n"
+            << "</package>\n";
+    }
+    xml << "</PropertyList>\n";
+}
+
+// What the Root queries did before the index: walk every catalog's packages
+static pkg::PackageRef walkById(pkg::Root* root, const std::string& id)
+{
+    for (const auto& cat : root->catalogs()) {
+        auto p = cat->getPackageById(id);
+        if (p) {
+            return p;
+        }
+    }
+    return {};
+}
+
+static size_t walkProviding(pkg::Root* root, const std::string& dir, const std::string& subPath)
+{
+    size_t count = 0;
+    for (const auto& cat : root->catalogs()) {
+        for (const auto& p : cat->packages(pkg::AnyPackageType)) {
+            if ((p->dirName() == dir) && p->doesProvidePath(subPath)) {
+                ++count;
+            }
+        }
+    }
+    return count;
+}
+
+static size_t walkSearch(pkg::Root* root, const std::string& text)
+{
+    SGPropertyNode_ptr filter(new SGPropertyNode);
+    filter->setStringValue("text", text);
+    return root->packagesMatching(filter).size();
+}
+
+int main(int argc, char* argv[])
+{
+    sglog().setLogLevels(SG_ALL, SG_WARN);
+
+    Dir top = Dir::tempDir("catalog_search_bench");
+    top.setRemoveOnDestroy();
+    for (int c = 0; c < num_catalogs; ++c) {
+        writeCatalog(top.file("org.flightgear.bench.catalog" + std::to_string(c)), c);
+    }
+
+    pkg::RootRef root(new pkg::Root(top.path(), "8.1.2"));
+    if (root->allPackages(pkg::AnyPackageType).size() != size_t(num_packages)) {
+        std::cerr << "failed to load the catalogs" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const double build_ms = timeRun([&] { root->getPackageById("pkg0"); }).toMSecs();
+
+    size_t walked = 0, indexed = 0;
+    const double walkId_ms = timeRun([&] {
+        for (int i = 0; i < num_lookups; ++i) {
+            walked += walkById(root, "pkg" + std::to_string((i * 7919) % num_packages) + "-v").valid();
+        }
+    }).toMSecs();
+    const double indexId_ms = timeRun([&] {
+        for (int i = 0; i < num_lookups; ++i) {
+            indexed += root->getPackageById("pkg" + std::to_string((i * 7919) % num_packages) + "-v").valid();
+        }
+    }).toMSecs();
+    bool ok = (walked == indexed) && (walked == size_t(num_lookups));
+
+    walked = indexed = 0;
+    const double walkProvides_ms = timeRun([&] {
+        for (int i = 0; i < num_lookups; ++i) {
+            const int p = (i * 7919) % num_packages;
+            walked += walkProviding(root, "dir" + std::to_string(p), "Models/" + word(p) + std::to_string(p) + ".xml");
+        }
+    }).toMSecs();
+    const double indexProvides_ms = timeRun([&] {
+        for (int i = 0; i < num_lookups; ++i) {
+            const int p = (i * 7919) % num_packages;
+            indexed += root->packagesProviding("dir" + std::to_string(p) + "/Models/" + word(p) +
+                                                   std::to_string(p) + ".xml",
+                                               false)
+                           .size();
+        }
+    }).toMSecs();
+    ok = ok && (walked == indexed) && (walked == size_t(num_lookups));
+
+    walked = indexed = 0;
+    const double walkSearch_ms = timeRun([&] {
+        for (int i = 0; i < num_queries; ++i) {
+            walked += walkSearch(root, word(i));
+        }
+    }).toMSecs();
+    const double indexSearch_ms = timeRun([&] {
+        for (int i = 0; i < num_queries; ++i) {
+            indexed += root->search(word(i)).size();
+        }
+    }).toMSecs();
+    ok = ok && (indexed > 0);
+
+    size_t fuzzy = 0;
+    const double fuzzySearch_ms = timeRun([&] {
+        for (int i = 0; i < num_queries; ++i) {
+            std::string w = word(i);
+            std::swap(w[1], w[2]); // a typo
+            fuzzy += root->search(w + " detail", pkg::AnyPackageType, 20).size();
+        }
+    }).toMSecs();
+    ok = ok && (fuzzy > 0);
+
+    std::cout << num_packages << " packages in " << num_catalogs << " catalogs, index built in "
+              << std::fixed << std::setprecision(1) << build_ms << " ms\n"
+              << "                                  walk       index\n"
+              << num_lookups << " getPackageById:     " << std::setw(8) << walkId_ms << " ms "
+              << std::setw(8) << indexId_ms << " ms\n"
+              << num_lookups << " packagesProviding:  " << std::setw(8) << walkProvides_ms << " ms "
+              << std::setw(8) << indexProvides_ms << " ms\n"
+              << num_queries << " text searches:       " << std::setw(8) << walkSearch_ms << " ms "
+              << std::setw(8) << indexSearch_ms << " ms (" << walked << " / " << indexed << " results)\n"
+              << num_queries << " misspelled searches: " << std::setw(8) << "" << "    "
+              << std::setw(8) << fuzzySearch_ms << " ms\n";
+
+    if (!ok) {
+        std::cerr << "results differ" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
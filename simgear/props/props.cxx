@@ -45,6 +45,7 @@ using std::cerr;
 # include <simgear/compiler.h>
 # include <simgear/debug/logstream.hxx>
 # include <simgear/sg_inlines.h>
+# include <simgear/structure/intern.hxx>
 
 # include "PropertyInterpolationMgr.hxx"
 # include "vectorPropTemplates.hxx"
@@ -821,13 +822,14 @@ find_child(SGPropertyLock& lock, Itr begin, Itr end, int index, const PropertyLi
       return i;
   }
 #else
-  boost::iterator_range<Itr> name(begin, end);
+  // names are interned: a name nobody interned can't match any node, and
+  // matching names are compared by address
+  const std::string* name = simgear::findInterned(std::string_view(begin, end - begin));
+  if (!name)
+    return -1;
   for (size_t i = 0; i < nNodes; i++) {
     SGPropertyNode * node = nodes[i];
-
-    // searching for a matching index is a lot less time consuming than
-    // comparing two strings so do that first.
-    if (node->getIndex() == index && boost::equals(node->getNameString(), name))
+    if (node->getIndex() == index && &node->getNameString() == name)
       return static_cast<int>(i);
   }
 #endif
@@ -842,10 +844,13 @@ find_last_child (SGPropertyLockExclusive& exclusive, const char * name, const Pr
 {
   size_t nNodes = nodes.size();
   int index = -1;
+  const std::string* interned = simgear::findInterned(name);
+  if (!interned)
+    return index;
 
   for (size_t i = 0; i < nNodes; i++) {
     SGPropertyNode * node = nodes[i];
-    if (node->getNameString() == name) {
+    if (&node->getNameString() == interned) {
         int idx = node->getIndex();
         if (idx > index) index = idx;
     }
@@ -1999,10 +2004,13 @@ struct SGPropertyNodeImpl
     getChildren(SGPropertyLock& lock, const SGPropertyNode& node, const std::string& name)
     {
         PropertyList children;
+        const std::string* interned = simgear::findInterned(name);
+        if (!interned)
+            return children;
         size_t max = node._children.size();
 
         for (size_t i = 0; i < max; i++)
-            if (node._children[i]->getNameString() == name)
+            if (&node._children[i]->getNameString() == interned)
                 children.push_back(node._children[i]);
 
         sort(children.begin(), children.end(), CompareIndices());
@@ -2182,11 +2190,23 @@ typedef std::map<const SGPropertyNode*, SGSourceLocation> NodeOriginMap;
  */
 static NodeOriginMap* nodeOrigins;
 
+/**
+ * Validate a node name and return the shared copy of it, so that nodes of
+ * the same name can be matched by address.
+ */
+static const std::string& intern_name(const std::string& name)
+{
+  if (!validateName(name))
+      throw std::invalid_argument(std::string{"plain name expected instead of '"} + name + '\'');
+  return *simgear::intern(name);
+}
+
 /**
  * Default constructor: always creates a root node.
  */
 SGPropertyNode::SGPropertyNode()
     : _index(0),
+      _name(*simgear::intern("")),
       _parent(nullptr),
       _attr(READ | WRITE)
 {
@@ -2282,14 +2302,12 @@ SGPropertyNode::SGPropertyNode(Itr begin, Itr end,
                                int index,
                                SGPropertyNode* parent)
     : _index(index),
-      _name(begin, end),
+      _name(intern_name(std::string(begin, end))),
       _parent(parent),
       _attr(READ | WRITE)
 {
   _local_val.string_val = 0;
   _value.val = 0;
-  if (!validateName(_name))
-      throw std::invalid_argument(std::string{"plain name expected instead of '"} + _name + '\'');
   if (0) std::cerr << __FILE__ << ":" << __LINE__ << ":"
         << " SGPropertyNode()"
         << " this=" << this
@@ -2303,14 +2321,12 @@ SGPropertyNode::SGPropertyNode(const std::string& name,
                                int index,
                                SGPropertyNode* parent)
     : _index(index),
-      _name(name),
+      _name(intern_name(name)),
       _parent(parent),
       _attr(READ | WRITE)
 {
   _local_val.string_val = 0;
   _value.val = 0;
-  if (!validateName(name))
-      throw std::invalid_argument(std::string{"plain name expected instead of '"} + _name + '\'');
 }
 
 /**
@@ -2773,9 +2789,10 @@ SGPropertyNode::removeChildren(const std::string& name)
   PropertyList children;
   {
     SGPropertyLockShared shared(*this);
+    const std::string* interned = simgear::findInterned(name);
 
-    for (int pos = static_cast<int>(_children.size() - 1); pos >= 0; pos--) {
-      if (_children[pos]->getNameString() == name) {
+    for (int pos = static_cast<int>(_children.size() - 1); pos >= 0 && interned; pos--) {
+      if (&_children[pos]->getNameString() == interned) {
         children.push_back(_children[pos]);
       }
     }
@@ -4139,7 +4156,7 @@ bool SGPropertyNode::compare(const SGPropertyNode& lhs,
         // I'm guessing that the nodes will usually be in the same
         // order.
         if (lchild->getIndex() != rchild->getIndex()
-                || lchild->getNameString() != rchild->getNameString()
+                || &lchild->getNameString() != &rchild->getNameString()
                 )
         {
             /* Search for matching child in rhs. */
@@ -4149,7 +4166,7 @@ bool SGPropertyNode::compare(const SGPropertyNode& lhs,
                     ++itr)
             {
                 if (lchild->getIndex() == (*itr)->getIndex()
-                        && lchild->getNameString() == (*itr)->getNameString()
+                        && &lchild->getNameString() == &(*itr)->getNameString()
                         )
                 {
                     rchild = *itr;
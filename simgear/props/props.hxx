@@ -917,7 +917,10 @@ public:
     /** Test whether this node contains a primitive leaf value. */
     bool hasValue() const;
 
-    /** Get the node's simple name as a string. Return value is not thread-safe. */
+    /**
+     * Get the node's simple name as a string. Names are interned, so nodes
+     * of the same name return the same string.
+     */
     const std::string& getNameString() const;
 
     /** Get the node's pretty display name, with subscript when needed. */
@@ -1399,7 +1402,7 @@ private:
     // Core data.
     //
     const int _index;
-    const std::string _name;
+    const std::string& _name; ///< interned, equal names share one string
     SGPropertyNode* _parent;
     simgear::PropertyList _children;
     simgear::props::Type _type = simgear::props::NONE;
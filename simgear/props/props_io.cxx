@@ -20,7 +20,9 @@
 #include <simgear/misc/sg_path.hxx>
 #include <simgear/misc/strutils.hxx>
 #include <simgear/sg_inlines.h>
+#include <simgear/threads/SGJobPool.hxx>
 #include <simgear/xml/easyxml.hxx>
+#include <simgear/xml/XMLDom.hxx>
 
 #include "props.hxx"
 #include "props_io.hxx"
@@ -30,6 +32,7 @@
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <regex>
 #include <string>
 #include <utility>
@@ -53,6 +56,16 @@ namespace strutils = simgear::strutils;
 const std::string ATTR = "_attr_";
 
 
+class PropsRecording;
+
+/// Recorded property list files, by path
+typedef map<string, std::unique_ptr<PropsRecording> > PropsRecordings;
+
+static void readPropertiesFile (const SGPath &file, SGPropertyNode * start_node,
+                                int default_mode, bool extended,
+                                const PropsRecordings * recordings);
+
+
 ////////////////////////////////////////////////////////////////////////
 // Property list visitor, for XML parsing.
 ////////////////////////////////////////////////////////////////////////
@@ -62,9 +75,9 @@ class PropsVisitor : public XMLVisitor
 public:
 
   PropsVisitor (SGPropertyNode * root, const string &base, int default_mode = 0,
-                bool extended = false)
+                bool extended = false, const PropsRecordings * recordings = 0)
     : _default_mode(default_mode), _root(root), _level(0), _base(base),
-      _hasException(false), _extended(extended)
+      _hasException(false), _extended(extended), _recordings(recordings)
   {}
 
   virtual ~PropsVisitor () {}
@@ -134,6 +147,7 @@ private:
   sg_io_exception _exception;
   bool _hasException;
   bool _extended;
+  const PropsRecordings * _recordings;
 };
 
 void
@@ -198,7 +212,7 @@ PropsVisitor::startElement (const char * name, const XMLAttributes &atts)
               message += attval;
               throw sg_io_exception(message, location, SG_ORIGIN, false);
           }
-          readProperties(path, _root, 0, _extended);
+          readPropertiesFile(path, _root, 0, _extended, _recordings);
       } catch (sg_io_exception &e) {
           setException(e);
       }
@@ -289,7 +303,7 @@ PropsVisitor::startElement (const char * name, const XMLAttributes &atts)
             message += val;
             throw sg_io_exception(message, location, SG_ORIGIN, false);
           }
-          readProperties(path, node, 0, _extended);
+          readPropertiesFile(path, node, 0, _extended, _recordings);
         }
         catch (sg_io_exception &e)
         {
@@ -428,7 +442,7 @@ void
 PropsVisitor::data (const char * s, int length)
 {
   if( !state().hasChildren() )
-    _data.append(string(s, length));
+    _data.append(s, length);
 }
 
 void
@@ -439,6 +453,91 @@ PropsVisitor::warning (const char * message, int line, int column)
 }
 
 
+////////////////////////////////////////////////////////////////////////
+// Parsed property list files, for loading them in parallel.
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * A property list file parsed into an XMLDom on a worker thread, for
+ * replaying into a PropsVisitor on the thread which owns the tree.
+ */
+class PropsRecording
+{
+public:
+
+  /**
+   * Parse a file. Returns null for anything but a regular file, or if
+   * parsing fails other than by throwing sg_io_exception, leaving the
+   * file to be read by readXML().
+   */
+  static std::unique_ptr<PropsRecording> record (const SGPath &file);
+
+  /**
+   * Pass the parsed document to a visitor, then throw the error which
+   * ended the parse, if there was one.
+   */
+  void replay (XMLVisitor &visitor) const;
+
+  /// Values of the include attributes, in document order
+  vector<string> includes () const;
+
+private:
+
+  simgear::XMLDom _dom;
+  bool _failed = false;
+  sg_io_exception _exception;
+};
+
+std::unique_ptr<PropsRecording>
+PropsRecording::record (const SGPath &file)
+{
+  std::unique_ptr<PropsRecording> recording;
+  if (!file.isFile())
+    return recording;
+
+  try {
+    recording.reset(new PropsRecording);
+    try {
+      recording->_dom.read(file);
+    } catch (sg_io_exception &e) {
+      recording->_failed = true;
+      recording->_exception = e;
+    }
+  } catch (...) {
+    recording.reset();
+  }
+  return recording;
+}
+
+void
+PropsRecording::replay (XMLVisitor &visitor) const
+{
+  _dom.visit(visitor);
+  if (_failed)
+    throw _exception;
+}
+
+static void
+findIncludes (const simgear::XMLDom::Node * node, vector<string> &includes)
+{
+  for (; node; node = node->next) {
+    if (!node->isElement())
+      continue;
+    const char * include = node->getAttribute("include");
+    if (include)
+      includes.push_back(include);
+    findIncludes(node->firstChild, includes);
+  }
+}
+
+vector<string>
+PropsRecording::includes () const
+{
+  vector<string> result;
+  findIncludes(_dom.root(), result);
+  return result;
+}
+
 ////////////////////////////////////////////////////////////////////////
 // Property list reader.
 ////////////////////////////////////////////////////////////////////////
@@ -474,13 +573,82 @@ void
 readProperties (const SGPath &file, SGPropertyNode * start_node,
                 int default_mode, bool extended)
 {
-  PropsVisitor visitor(start_node, file.utf8Str(), default_mode, extended);
-  readXML(file, visitor);
+  readPropertiesFile(file, start_node, default_mode, extended, 0);
+}
+
+
+/**
+ * Read properties from a file, replaying its recording if there is one.
+ */
+static void
+readPropertiesFile (const SGPath &file, SGPropertyNode * start_node,
+                    int default_mode, bool extended,
+                    const PropsRecordings * recordings)
+{
+  const PropsRecording * recording = 0;
+  if (recordings) {
+    PropsRecordings::const_iterator it = recordings->find(file.utf8Str());
+    if (it != recordings->end())
+      recording = it->second.get();
+  }
+
+  PropsVisitor visitor(start_node, file.utf8Str(), default_mode, extended,
+                       recordings);
+  if (recording)
+    recording->replay(visitor);
+  else
+    readXML(file, visitor);
   if (visitor.hasException())
     throw visitor.getException();
 }
 
 
+/**
+ * Read properties from a file and the files it includes, which are parsed
+ * in parallel.
+ *
+ * The files are recorded one level of includes at a time: the includes
+ * are resolved on this thread, then the newly found files are mapped and
+ * parsed by the job pool. Replaying the recordings builds the tree exactly
+ * as readProperties() would.
+ *
+ * @param file A string containing the file path.
+ * @param start_node The root node for reading properties.
+ */
+void
+readPropertiesParallel (const SGPath &file, SGPropertyNode * start_node,
+                        int default_mode, bool extended)
+{
+  PropsRecordings recordings;
+  recordings[file.utf8Str()];
+
+  vector<SGPath> level(1, file);
+  while (!level.empty()) {
+    vector<std::unique_ptr<PropsRecording> > recorded(level.size());
+    SGJobPool::shared().parallelFor(level.size(), [&](size_t i) {
+      recorded[i] = PropsRecording::record(level[i]);
+    });
+
+    vector<SGPath> next;
+    for (size_t i = 0; i < level.size(); ++i) {
+      if (!recorded[i])
+        continue;
+
+      const SGPath dir = level[i].dir();
+      for (const string &include : recorded[i]->includes()) {
+        SGPath path = simgear::ResourceManager::instance()->findPath(include, dir);
+        if (!path.isNull() && recordings.emplace(path.utf8Str(), nullptr).second)
+          next.push_back(path);
+      }
+      recordings[level[i].utf8Str()] = std::move(recorded[i]);
+    }
+    level.swap(next);
+  }
+
+  readPropertiesFile(file, start_node, default_mode, extended, &recordings);
+}
+
+
 /**
  * Read properties from an in-memory buffer.
  *
@@ -32,6 +32,15 @@ void readProperties (const SGPath &file, SGPropertyNode * start_node,
                      int default_mode = 0, bool extended = false);
 
 
+/**
+ * Read properties from an XML file, parsing the files it includes in
+ * parallel. The tree is only modified on the calling thread, and the
+ * result is the same as that of readProperties().
+ */
+void readPropertiesParallel (const SGPath &file, SGPropertyNode * start_node,
+                             int default_mode = 0, bool extended = false);
+
+
 /**
  * Read properties from an in-memory buffer.
  */
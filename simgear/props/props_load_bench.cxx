@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Benchmark loading a generated aircraft of 500 property list
+ *        files, serially and with the includes parsed in parallel
+ */
+
+#include <simgear_config.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <simgear/debug/logstream.hxx>
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/misc/sg_dir.hxx>
+#include <simgear/misc/test_timing.hxx>
+#include <simgear/threads/SGJobPool.hxx>
+
+#include "props.hxx"
+#include "props_io.hxx"
+
+using namespace simgear;
+
+static const int num_files = 500;
+static const int fanout = 24;  ///< files included by each file
+static const int num_runs = 3;
+
+static std::string fileName(int f)
+{
+    return f == 0 ? "bench-set.xml" : "Systems/part" + std::to_string(f) + ".xml";
+}
+
+// File f includes files f * fanout + 1 ... f * fanout + fanout, as the
+// -set.xml of an aircraft includes its systems, which include their parts
+static void writeFile(const SGPath& dir, int f)
+{
+    sg_ofstream xml(dir / fileName(f), std::ios::out | std::ios::trunc);
+    xml << "<?xml version=\"1.0\"?>\n<PropertyList>\n"
+        << "  <description>Generated part " << f << " of the benchmark aircraft</description>\n";
+    for (int i = 0; i < 40; ++i) {
+        xml << "  <channel n=\"" << i << "\">\n"
+            << "    <name>channel " << f << "." << i << "</name>\n"
+            << "    <gain type=\"double\">" << (f + i) * 0.125 << "</gain>\n"
+            << "    <enabled type=\"bool\">" << (i % 3 ? "true" : "false") << "</enabled>\n"
+            << "    <input>/systems/part" << f << "/channel[" << i << "]/output</input>\n"
+            << "  </channel>\n";
+    }
+    for (int c = f * fanout + 1; c <= f * fanout + fanout && c < num_files; ++c) {
+        xml << "  <part" << c << " include=\"" << (f == 0 ? fileName(c) : "part" + std::to_string(c) + ".xml")
+            << "\"" << (c % 4 ? "" : " omit-node=\"y\"") << "/>\n";
+    }
+    xml << "</PropertyList>\n";
+}
+
+int main(int argc, char* argv[])
+{
+    sglog().setLogLevels(SG_ALL, SG_WARN);
+
+    Dir top = Dir::tempDir("props_load_bench");
+    top.setRemoveOnDestroy();
+    Dir(top.file("Systems")).create(0755);
+    for (int f = 0; f < num_files; ++f) {
+        writeFile(top.path(), f);
+    }
+    const SGPath setFile = top.file(fileName(0));
+
+    std::string serial;
+    const double serial_ms = bestRun(num_runs, [&] {
+        SGPropertyNode_ptr root(new SGPropertyNode);
+        readProperties(setFile, root);
+        std::ostringstream out;
+        writeProperties(out, root, true);
+        serial = out.str();
+    }).toMSecs();
+
+    std::string parallel;
+    const double parallel_ms = bestRun(num_runs, [&] {
+        SGPropertyNode_ptr root(new SGPropertyNode);
+        readPropertiesParallel(setFile, root);
+        std::ostringstream out;
+        writeProperties(out, root, true);
+        parallel = out.str();
+    }).toMSecs();
+
+    std::cout << num_files << " files (" << serial.size() / 1024 << " KiB written), "
+              << SGJobPool::defaultNumWorkers() + 1 << " threads\n"
+              << std::fixed << std::setprecision(1)
+              << "readProperties:         " << std::setw(8) << serial_ms << " ms\n"
+              << "readPropertiesParallel: " << std::setw(8) << parallel_ms << " ms ("
+              << serial_ms / std::max(parallel_ms, 0.1) << "x)\n";
+
+    if (serial.empty() || serial != parallel) {
+        std::cerr << "results differ" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Benchmark the memory and lookup cost of property names on a tree
+ *        of multiplayer models, as under /ai/models
+ */
+
+#include <simgear_config.h>
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include <simgear/misc/test_timing.hxx>
+
+#include "props.hxx"
+
+static const int num_models = 2000;
+static const int num_runs = 3;
+
+// the properties of each model, as multiplayer messages create them
+static const char* properties[] = {
+    "callsign", "sim/model/path", "sim/model/fallback-model-index", "sim/multiplay/protocol-version",
+    "position/latitude-deg", "position/longitude-deg", "position/altitude-ft", "position/altitude-agl-ft",
+    "orientation/true-heading-deg", "orientation/pitch-deg", "orientation/roll-deg",
+    "velocities/true-airspeed-kt", "velocities/vertical-speed-fps", "velocities/uBody-fps",
+    "velocities/vBody-fps", "velocities/wBody-fps", "surface-positions/left-aileron-pos-norm",
+    "surface-positions/right-aileron-pos-norm", "surface-positions/elevator-pos-norm",
+    "surface-positions/rudder-pos-norm", "surface-positions/flap-pos-norm",
+    "surface-positions/speedbrake-pos-norm", "gear/gear[0]/position-norm", "gear/gear[1]/position-norm",
+    "gear/gear[2]/position-norm", "gear/gear[0]/rollspeed-ms", "engines/engine[0]/n1",
+    "engines/engine[0]/n2", "engines/engine[0]/rpm", "engines/engine[1]/n1", "engines/engine[1]/n2",
+    "engines/engine[1]/rpm", "controls/lighting/nav-lights", "controls/lighting/beacon",
+    "controls/lighting/strobe", "controls/lighting/landing-lights", "rotors/main/rpm",
+    "instrumentation/transponder/transmitted-id", "instrumentation/transponder/altitude",
+    "sim/multiplay/chat", "sim/multiplay/generic/int[0]", "sim/multiplay/generic/int[1]",
+    "sim/multiplay/generic/float[0]", "sim/multiplay/generic/float[1]",
+    "sim/multiplay/generic/string[0]", "radar/in-range", "radar/range-nm", "radar/bearing-deg",
+    "radar/elevation-deg", "valid", "id"};
+static const int num_properties = sizeof(properties) / sizeof(properties[0]);
+
+static size_t heapInUse()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+static void countNames(const SGPropertyNode* node, size_t& nodes, std::set<const std::string*>& names)
+{
+    ++nodes;
+    names.insert(&node->getNameString());
+    for (int i = 0; i < node->nChildren(); ++i) {
+        countNames(node->getChild(i), nodes, names);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t heapBefore = heapInUse();
+    SGPropertyNode_ptr root(new SGPropertyNode);
+    SGPropertyNode* models = root->getNode("ai/models", true);
+    const double build_ms = timeRun([&] {
+        for (int m = 0; m < num_models; ++m) {
+            SGPropertyNode* model = models->getChild("multiplayer", m, true);
+            for (int p = 0; p < num_properties; ++p) {
+                model->setDoubleValue(properties[p], m + p);
+            }
+        }
+    }).toMSecs();
+    const size_t heapAfter = heapInUse();
+
+    size_t nodes = 0;
+    std::set<const std::string*> names;
+    countNames(root, nodes, names);
+
+    // lookups by relative path from the root, and of children among the
+    // thousands of models
+    double sum = 0.0;
+    const double path_ms = bestRun(num_runs, [&] {
+        sum = 0.0;
+        for (int m = 0; m < num_models; ++m) {
+            const std::string prefix = "ai/models/multiplayer[" + std::to_string(m) + "]/";
+            sum += root->getDoubleValue(prefix + "position/altitude-ft");
+            sum += root->getDoubleValue(prefix + "engines/engine[1]/rpm");
+            sum += root->getDoubleValue(prefix + "valid");
+        }
+    }).toMSecs();
+
+    size_t found = 0;
+    const double child_ms = bestRun(num_runs, [&] {
+        found = 0;
+        for (int m = 0; m < num_models; ++m) {
+            SGPropertyNode* model = models->getChild("multiplayer", m);
+            for (int p = 0; p < num_properties; p += 5) {
+                found += model->getNode(properties[p]) != nullptr;
+            }
+            found += models->getChild("tanker", m) == nullptr;
+        }
+    }).toMSecs();
+
+    std::cout << num_models << " models, " << nodes << " nodes, " << names.size()
+              << " name strings, sizeof(SGPropertyNode) " << sizeof(SGPropertyNode) << "\n"
+              << std::fixed << std::setprecision(1);
+    if (heapAfter > heapBefore) {
+        std::cout << "heap for the tree:     " << std::setw(8) << (heapAfter - heapBefore) / 1024.0
+                  << " KiB (" << double(heapAfter - heapBefore) / nodes << " bytes per node)\n";
+    }
+    std::cout << "build:                 " << std::setw(8) << build_ms << " ms\n"
+              << 3 * num_models << " path lookups:    " << std::setw(8) << path_ms << " ms\n"
+              << (num_properties / 5 + 2) * num_models << " child lookups:  " << std::setw(8)
+              << child_ms << " ms\n";
+
+    const size_t expected = size_t(num_models) * ((num_properties + 4) / 5 + 1);
+    if (found != expected || sum <= 0.0) {
+        std::cerr << "unexpected results" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -14,13 +14,17 @@
 #include <iostream>
 #include <map>
 #include <exception>
+#include <sstream>
 
 #include "props.hxx"
 #include "props_io.hxx"
 
 #include <simgear/misc/test_macros.hxx>
+#include <simgear/misc/sg_dir.hxx>
 #include <simgear/misc/sg_path.hxx>
 #include <simgear/misc/test_macros.hxx>
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/structure/exception.hxx>
 
 using std::cout;
 using std::cerr;
@@ -972,6 +976,123 @@ void testDeleterListener()
     }
 }
 
+static void writeFile(const SGPath& path, const char* contents)
+{
+    sg_ofstream f(path, std::ios::out | std::ios::trunc);
+    f << contents;
+}
+
+// Load a file both ways into trees holding the same properties, returning
+// the written trees and any exception messages
+static std::string loadBothWays(const SGPath& file, std::string& parallel)
+{
+    std::ostringstream serialOut, parallelOut;
+    SGPropertyNode_ptr serialRoot(new SGPropertyNode), parallelRoot(new SGPropertyNode);
+    for (auto root : {serialRoot, parallelRoot}) {
+        root->setIntValue("sim/existing", 1);
+        root->setIntValue("sim/model[1]/existing", 2);
+    }
+
+    try {
+        readProperties(file, serialRoot);
+    } catch (sg_exception& e) {
+        serialOut << "exception: " << e.getFormattedMessage() << "\n";
+    }
+    try {
+        readPropertiesParallel(file, parallelRoot);
+    } catch (sg_exception& e) {
+        parallelOut << "exception: " << e.getFormattedMessage() << "\n";
+    }
+
+    writeProperties(serialOut, serialRoot, true);
+    writeProperties(parallelOut, parallelRoot, true);
+    parallel = parallelOut.str();
+    return serialOut.str();
+}
+
+void testParallelIncludes()
+{
+    simgear::Dir dir = simgear::Dir::tempDir("props_test");
+    dir.setRemoveOnDestroy();
+    const SGPath d = dir.path();
+    simgear::Dir(d / "Systems").create(0755);
+
+    writeFile(d / "base.xml",
+              "<?xml version=\"1.0\"?>\n<PropertyList>\n"
+              "  <sim><description>Base</description><flaps n=\"2\">30</flaps></sim>\n"
+              "</PropertyList>\n");
+    writeFile(d / "Systems" / "engine.xml",
+              "<PropertyList>\n"
+              "  <rpm type=\"double\">2400.5</rpm>\n"
+              "  <magnetos include=\"magnetos.xml\"/>\n"
+              "  <note>\n    multi &amp; line\n  </note>\n"
+              "</PropertyList>\n");
+    writeFile(d / "Systems" / "magnetos.xml",
+              "<PropertyList><left type=\"bool\">true</left><right>1</right></PropertyList>");
+    writeFile(d / "Systems" / "merge.xml",
+              "<PropertyList><a>1</a><b>2</b><a>3</a></PropertyList>");
+    writeFile(d / "aircraft.xml",
+              "<?xml version=\"1.0\"?>\n"
+              "<PropertyList include=\"base.xml\">\n"
+              "  <sim>\n"
+              "    <description>Override</description>\n"
+              "    <model include=\"Systems/engine.xml\" archive=\"y\"/>\n"
+              "    <model><path>Models/a.ac</path></model>\n"
+              "    <model include=\"Systems/engine.xml\"><rpm>700</rpm></model>\n"
+              "    <systems omit-node=\"y\" include=\"Systems/merge.xml\"/>\n"
+              "    <a>0</a>\n"
+              "    <alias alias=\"/sim/description\"/>\n"
+              "  </sim>\n"
+              "</PropertyList>\n");
+
+    std::string parallel;
+    std::string serial = loadBothWays(d / "aircraft.xml", parallel);
+    SG_CHECK_EQUAL(serial, parallel);
+    SG_VERIFY(serial.find("Override") != std::string::npos);
+    SG_VERIFY(serial.find("exception") == std::string::npos);
+
+    // missing and malformed includes stop at the same point
+    writeFile(d / "broken.xml",
+              "<PropertyList><x>1</x><y include=\"Systems/bad.xml\"/>"
+              "<z include=\"missing.xml\"/></PropertyList>");
+    writeFile(d / "Systems" / "bad.xml",
+              "<PropertyList><p>1</p><q>2</r></PropertyList>");
+    serial = loadBothWays(d / "broken.xml", parallel);
+    SG_CHECK_EQUAL(serial, parallel);
+    SG_VERIFY(serial.find("exception") != std::string::npos);
+
+    writeFile(d / "truncated.xml", "<PropertyList include=\"base.xml\"><x>1</x>");
+    serial = loadBothWays(d / "truncated.xml", parallel);
+    SG_CHECK_EQUAL(serial, parallel);
+    SG_VERIFY(serial.find("exception") != std::string::npos);
+
+    writeFile(d / "empty.xml", "");
+    serial = loadBothWays(d / "empty.xml", parallel);
+    SG_CHECK_EQUAL(serial, parallel);
+}
+
+void testSharedNames()
+{
+    SGPropertyNode_ptr a(new SGPropertyNode), b(new SGPropertyNode);
+    SGPropertyNode* alt0 = a->getNode("ai/models/multiplayer[0]/position/altitude-ft", true);
+    SGPropertyNode* alt1 = b->getNode("ai/models/multiplayer[7]/position/altitude-ft", true);
+    SG_CHECK_EQUAL(alt0->getNameString(), "altitude-ft");
+    SG_CHECK_EQUAL(&alt0->getNameString(), &alt1->getNameString());
+
+    // names built at run time find the same nodes
+    const std::string name = std::string("multi") + "player";
+    SG_CHECK_EQUAL(a->getNode("ai/models")->getChild(name, 0), alt0->getParent()->getParent());
+    SG_CHECK_EQUAL(b->getNode("ai/models")->getChildren(name).size(), 1);
+    SG_VERIFY(a->getNode("ai/models")->getChild("props_test-unused-name", 0) == nullptr);
+    SG_VERIFY(a->getNode("ai/models")->getChildren("props_test-unused-name").empty());
+    SG_VERIFY(a->getNode("ai/models")->removeChildren("props_test-unused-name").empty());
+    SG_CHECK_EQUAL(b->getNode("ai/models")->removeChildren(name).size(), 1);
+    SG_VERIFY(b->getNode("ai/models/multiplayer[7]") == nullptr);
+
+    SGPropertyNode_ptr copy(new SGPropertyNode(*alt0));
+    SG_CHECK_EQUAL(&copy->getNameString(), &alt0->getNameString());
+}
+
 int main (int ac, char ** av)
 {
   test_value();
@@ -996,6 +1117,8 @@ int main (int ac, char ** av)
     tiedPropertiesListeners();
     testDeleterListener();
     testAliasedListeners();
+    testParallelIncludes();
+    testSharedNames();
 
     return 0;
 }
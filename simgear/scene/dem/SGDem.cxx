@@ -21,6 +21,8 @@
 // $Id$
 #include <fstream>
 #include <limits>
+#include <utility>
+#include <vector>
 
 #include <cpl_conv.h> // for CPLMalloc()
 #include "ogr_spatialref.h"
@@ -31,6 +33,7 @@
 
 #include <simgear/scene/dem/SGDem.hxx>
 #include <simgear/scene/dem/SGDemSession.hxx>
+#include <simgear/threads/SGJobPool.hxx>
 
 using namespace simgear;
 
@@ -203,11 +206,23 @@ SGDemSession SGDem::openSession( unsigned wo, unsigned so, unsigned eo, unsigned
 
             SG_LOG( SG_TERRAIN, SG_INFO, "SGDem::OpenSession - from pre level rounding offsets " << min_lon << ", " << min_lat << " to offsets " << max_lon << ", " << max_lat );
 
+            std::vector<std::pair<unsigned, unsigned> > origins;
             for (unsigned lon = min_lon; lon < max_lon; lon += w) {
                 for (unsigned lat = min_lat; lat < max_lat; lat += h) {
-                    s.addTile( demRoot->getOrCreateTile( lon, lat, w, h, x, y, o, level, cache ) );
+                    origins.push_back( std::make_pair( lon, lat ) );
                 }
             }
+
+            // read the tiles missing from the cache in parallel, GDAL can
+            // read different datasets from several threads at once
+            std::vector<SGDemTileRef> tiles( origins.size() );
+            SGJobPool::shared().parallelFor( origins.size(), [&]( size_t i ) {
+                tiles[i] = demRoot->getOrCreateTile( origins[i].first, origins[i].second, w, h, x, y, o, level, cache );
+            });
+
+            for ( const SGDemTileRef& tile : tiles ) {
+                s.addTile( tile );
+            }
         } else {
 	    SG_LOG( SG_TERRAIN, SG_INFO, "SGDem::OpenSession - could not find DEM for " << wo << ", " << so << " - " << eo << ", " << no << " level " << level );
         }
@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+/**
+ * @file
+ * @brief Bounded cache of decoded DEM tiles, shared between sessions
+ */
+
+#include <simgear_config.h>
+
+#include <simgear/scene/dem/SGDemCache.hxx>
+
+SGDemCache::SGDemCache(size_t maxTiles) :
+    // the cache holds the only reference to tiles no session uses
+    _tiles(maxTiles, nullptr,
+           [](const SGDemTileRef& tile) { return tile.getNumRefs() > 1; })
+{
+}
+
+SGDemTileRef SGDemCache::get(unsigned long key)
+{
+    return _tiles.find(key);
+}
+
+SGDemTileRef SGDemCache::getOrLoad(unsigned long key, const Loader& load)
+{
+    return _tiles.get(key, load);
+}
+
+void SGDemCache::trim()
+{
+    _tiles.trim();
+}
+
+void SGDemCache::flush()
+{
+    _tiles.flush();
+}
+
+void SGDemCache::setMaxTiles(size_t maxTiles)
+{
+    _tiles.setBudget(maxTiles);
+}
+
+size_t SGDemCache::getMaxTiles() const
+{
+    return _tiles.getBudget();
+}
+
+size_t SGDemCache::size() const
+{
+    return _tiles.size();
+}
+
+SGDemCache::Stats SGDemCache::getStats() const
+{
+    return _tiles.getStats();
+}
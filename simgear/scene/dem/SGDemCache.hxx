@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+/**
+ * @file
+ * @brief Bounded cache of decoded DEM tiles, shared between sessions
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+#include <simgear/scene/dem/SGDemTile.hxx>
+#include <simgear/structure/SGLoadingCache.hxx>
+
+/**
+ * Decoded tiles of one DEM level, keyed by SGDemRoot::getTileKey().
+ *
+ * Tiles stay cached after their sessions are closed, so overlapping
+ * sessions don't decode the same raster again. Tiles still referenced by a
+ * session are never dropped. Of the others, the least recently used ones
+ * are dropped once there are more than the maximum number of them.
+ *
+ * All methods may be called from several threads. A tile requested by
+ * several threads at the same time is only loaded once.
+ */
+class SGDemCache final
+{
+public:
+    using Loader = std::function<SGDemTileRef()>;
+    using Stats = simgear::SGLoadingCache<unsigned long, SGDemTileRef>::Stats;
+
+    /// About 3 MB each for a 1x1 degree tile of 1201x1201 samples
+    static const size_t DefaultMaxTiles = 64;
+
+    explicit SGDemCache(size_t maxTiles = DefaultMaxTiles);
+
+    SGDemCache(const SGDemCache&) = delete;
+    SGDemCache& operator=(const SGDemCache&) = delete;
+
+    /// The tile for @a key if it is decoded already, or null
+    SGDemTileRef get(unsigned long key);
+
+    /// The tile for @a key, calling @a load if it is neither cached nor
+    /// being loaded by another thread
+    SGDemTileRef getOrLoad(unsigned long key, const Loader& load);
+
+    /// Drop unreferenced tiles until no more than the maximum of them are left
+    void trim();
+
+    /// Drop all tiles not referenced by a session
+    void flush();
+
+    void setMaxTiles(size_t maxTiles);
+    size_t getMaxTiles() const;
+
+    /// Number of decoded tiles
+    size_t size() const;
+
+    Stats getStats() const;
+
+private:
+    simgear::SGLoadingCache<unsigned long, SGDemTileRef> _tiles;
+};
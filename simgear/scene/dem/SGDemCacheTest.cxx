@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+/**
+ * @file
+ * @brief Unit tests for SGDemCache
+ */
+
+#include <simgear_config.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <simgear/misc/sg_path.hxx>
+#include <simgear/misc/test_macros.hxx>
+#include <simgear/scene/dem/SGDemCache.hxx>
+
+using std::cout;
+using std::endl;
+
+// A tile without raster data, so nothing is read from disk
+static SGDemCache::Loader loader(unsigned long key, std::atomic<int>& loads)
+{
+    return [key, &loads] {
+        ++loads;
+        return SGDemTileRef(new SGDemTile(SGPath::fromUtf8("dem"), key >> 16, key & 0xffff,
+                                          1, 1, 1201, 1201, 0, false));
+    };
+}
+
+void test_hitsAndMisses()
+{
+    cout << "Testing hits and misses of the DEM cache" << endl;
+
+    SGDemCache cache;
+    std::atomic<int> loads{0};
+
+    SG_VERIFY(!cache.get(1).valid());
+    SGDemTileRef tile = cache.getOrLoad(1, loader(1, loads));
+    SG_VERIFY(tile.valid());
+    SG_VERIFY(cache.get(1) == tile);
+    SG_VERIFY(cache.getOrLoad(1, loader(1, loads)) == tile);
+    SG_CHECK_EQUAL(loads.load(), 1);
+
+    SGDemCache::Stats stats = cache.getStats();
+    SG_CHECK_EQUAL(stats.hits, 2u);
+    SG_CHECK_EQUAL(stats.misses, 2u);
+}
+
+void test_singleFlight()
+{
+    cout << "Testing concurrent requests for the same DEM tile" << endl;
+
+    SGDemCache cache;
+    std::atomic<int> loads{0};
+    auto slowLoader = [&loads] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        return loader(7, loads)();
+    };
+
+    std::vector<SGDemTileRef> tiles(4);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < tiles.size(); ++i)
+        threads.emplace_back([&, i] { tiles[i] = cache.getOrLoad(7, slowLoader); });
+    for (auto& t : threads)
+        t.join();
+
+    SG_CHECK_EQUAL(loads.load(), 1);
+    for (const auto& t : tiles)
+        SG_VERIFY(t.valid() && t == tiles[0]);
+    SG_CHECK_EQUAL(cache.getStats().misses, 1u);
+    SG_CHECK_EQUAL(cache.getStats().hits, 3u);
+}
+
+void test_failedLoad()
+{
+    cout << "Testing failed loads of DEM tiles" << endl;
+
+    SGDemCache cache;
+    std::atomic<int> loads{0};
+
+    bool thrown = false;
+    try {
+        cache.getOrLoad(3, []() -> SGDemTileRef { throw std::runtime_error("test"); });
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    SG_VERIFY(thrown);
+    SG_VERIFY(!cache.getOrLoad(4, [] { return SGDemTileRef(); }).valid());
+    SG_CHECK_EQUAL(cache.size(), 0u);
+
+    // the next request tries again
+    SG_VERIFY(cache.getOrLoad(3, loader(3, loads)).valid());
+    SG_VERIFY(cache.getOrLoad(4, loader(4, loads)).valid());
+    SG_CHECK_EQUAL(loads.load(), 2);
+    SG_CHECK_EQUAL(cache.size(), 2u);
+}
+
+void test_eviction()
+{
+    cout << "Testing eviction of DEM tiles" << endl;
+
+    SGDemCache cache(2);
+    std::atomic<int> loads{0};
+
+    // tiles referenced by a session are kept, and don't count
+    SGDemTileRef used = cache.getOrLoad(1, loader(1, loads));
+    cache.getOrLoad(2, loader(2, loads));
+    cache.getOrLoad(3, loader(3, loads));
+    cache.getOrLoad(2, loader(2, loads));
+    cache.getOrLoad(4, loader(4, loads));
+    cache.trim();
+    SG_CHECK_EQUAL(cache.size(), 3u);
+    SG_CHECK_EQUAL(cache.getStats().evictions, 1u);
+
+    // tile 3 was the least recently used unused one
+    SG_VERIFY(!cache.get(3).valid());
+    SG_VERIFY(cache.get(2).valid());
+    SG_VERIFY(cache.get(4).valid());
+    SG_CHECK_EQUAL(loads.load(), 4);
+
+    cache.flush();
+    SG_CHECK_EQUAL(cache.size(), 1u);
+    SG_VERIFY(cache.get(1) == used);
+
+    used.reset();
+    cache.setMaxTiles(0);
+    SG_CHECK_EQUAL(cache.size(), 0u);
+    SG_CHECK_EQUAL(cache.getMaxTiles(), 0u);
+}
+
+int main(int argc, char* argv[])
+{
+    test_hitsAndMisses();
+    test_singleFlight();
+    test_failedLoad();
+    test_eviction();
+
+    return EXIT_SUCCESS;
+}
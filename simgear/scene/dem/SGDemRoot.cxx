@@ -47,7 +47,7 @@ int SGDemRoot::createLevel( int w, int h, int x, int y, int overlap, const std::
             demInfo << w << " " << h << " " << x << " " << y << " " << overlap << " " << ext << std::endl;
 
             levels.push_back( SGDemLevel( lvlidx, lvlPath, w, h, x, y, overlap, ext, false ) );
-            caches.push_back( SGDemCache() );
+            caches.push_back( std::make_shared<SGDemCache>() );
         } else {
             SG_LOG( SG_TERRAIN, SG_INFO, "SGDem::createLevel: can't create level directory at " << lvlPath.c_str() << " error " << res );
         }
@@ -92,27 +92,19 @@ SGDemTileRef SGDemRoot::createTile( int lvl, int lon, int lat, int overlap, SGDe
 
 void SGDemRoot::flushCaches( int lvl )
 {
-    // traverse the map - delete any tiles with ref count == 1 ( us )
-    //fprintf( stderr, "flush caches in lvl %d - num tiles is %lu\n", lvl, caches[lvl].size() );
-    SGDemCache::iterator it = caches[lvl].begin();
-    while ( it != caches[lvl].end() ) {
-        if ( it->second.getNumRefs() == 1 ) {
-            caches[lvl].erase(it++);
-        } else {
-            //fprintf( stderr, "can't flush tile - numrefs is %u\n", it->second.getNumRefs() );
-            ++it;
-        }
-    }
+    // tiles still referenced by a session stay, and unused ones are kept
+    // for the next session up to the cache size
+    caches[lvl]->trim();
 }
 
-SGDemTileRef SGDemRoot::getTile( int lvlIndex, unsigned long key )
+void SGDemRoot::setCacheSize( size_t maxTiles )
 {
-    SGDemTileRef tile = NULL;
-
-    SGDemCache::const_iterator it = caches[lvlIndex].find(key);
-    if ( it != caches[lvlIndex].end() ) {
-        tile = it->second;
+    for ( auto& cache : caches ) {
+        cache->setMaxTiles( maxTiles );
     }
+}
 
-    return tile;
+SGDemTileRef SGDemRoot::getTile( int lvlIndex, unsigned long key )
+{
+    return caches[lvlIndex]->get( key );
 }
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <memory>
+
+#include <simgear/scene/dem/SGDemCache.hxx>
 #include <simgear/scene/dem/SGDemLevel.hxx>
 #include <simgear/scene/dem/SGDemTile.hxx>
 
@@ -12,7 +15,7 @@ public:
 
     void addLevel( const SGDemLevel& level ) {
         levels.push_back( level );
-        caches.push_back( SGDemCache() );
+        caches.push_back( std::make_shared<SGDemCache>() );
     }
 
     // create a new level
@@ -24,10 +27,23 @@ public:
         return levels.size();
     }
 
+    static unsigned long getTileKey( unsigned wo, unsigned so ) {
+        return (unsigned long)wo << 16 | so;
+    }
+
+    // decoded tile, if it is in the cache of the level
     SGDemTileRef getTile( int lvlIndex, unsigned long key );
 
+    // drop unused tiles beyond the cache size of the level
     void flushCaches( int lvl );
 
+    // max number of decoded tiles kept per level, in use or not
+    void setCacheSize( size_t maxTiles );
+
+    SGDemCache* getCache( int lvl ) {
+        return (unsigned int)lvl < caches.size() ? caches[lvl].get() : NULL;
+    }
+
     bool isValid( int lvl, unsigned wo, unsigned so, unsigned eo, unsigned no ) const;
 
     unsigned int getWidth( unsigned int level ) {
@@ -70,30 +86,28 @@ public:
         }
     }
 
-    SGDemTile* getOrCreateTile( unsigned wo, unsigned so,
-                                unsigned w, unsigned h, unsigned x, unsigned y,
-                                unsigned o, int level, bool cache )
+    // decoded tile from the cache, read now if missing. Safe to call from
+    // several threads, a tile is only read once.
+    SGDemTileRef getOrCreateTile( unsigned wo, unsigned so,
+                                  unsigned w, unsigned h, unsigned x, unsigned y,
+                                  unsigned o, int level, bool cache )
     {
-        unsigned long key = wo << 16 | so;
-
-        // is this tile already loaded?
-        SGDemCache::const_iterator it = caches[level].find(key);
-        if ( it != caches[level].end() ) {
-            // yes - add the reference to this session
-            //printf( "********************** adding ref to tile at %d,%d with key %lx\n", lon, lat, key );
-            return it->second;
-        } else {
-            // no load the tile, now
-            SGDemTile* pTile = new SGDemTile( levels[level].getLevelDir(),
-                                              wo, so, w, h,
-                                              x, y, o, cache );
-            caches[level][key] = pTile;
-            return pTile;
-        }
+        const SGPath& levelDir = levels[level].getLevelDir();
+        return caches[level]->getOrLoad( getTileKey(wo, so), [&]() {
+            return SGDemTileRef( new SGDemTile( levelDir, wo, so, w, h, x, y, o, cache ) );
+        });
+    }
+
+    // as above, with the tile dimensions of the level
+    SGDemTileRef getOrCreateTile( unsigned wo, unsigned so, int level ) {
+        return getOrCreateTile( wo, so, getWidth( level ), getHeight( level ),
+                                getResX( level ), getResY( level ), getOverlap( level ),
+                                level, true );
     }
 
 private:
     SGPath                  demRoot;
     std::vector<SGDemLevel> levels;
-    std::vector<SGDemCache> caches;
+    // shared, so roots can be copied
+    std::vector<std::shared_ptr<SGDemCache>> caches;
 };
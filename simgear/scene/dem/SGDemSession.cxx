@@ -1,5 +1,8 @@
+#include <algorithm>
+
 #include <simgear/scene/dem/SGDem.hxx>
 #include <simgear/scene/dem/SGDemSession.hxx>
+#include <simgear/threads/SGJobPool.hxx>
 
 SGDemSession::SGDemSession(int mnLon, int mnLat, int mxLon, int mxLat, int idx, int lvlW, int lvlH, SGDemRoot* root)
 {
@@ -35,7 +38,7 @@ void SGDemSession::close(void)
     }
 }
 
-void SGDemSession::getGeods(unsigned wo, unsigned so, unsigned eo, unsigned no, int resx, int resy, int incx, int incy, ::std::vector<SGGeod>& geods, bool Debug1, bool Debug2)
+unsigned SGDemSession::getSpan(void) const
 {
     // todo - store this info in deminfo
     unsigned span; // smallest tile width/height in level ( in offsets )
@@ -53,34 +56,103 @@ void SGDemSession::getGeods(unsigned wo, unsigned so, unsigned eo, unsigned no,
         fprintf(stderr, "invalid lvlIndex %d\n", lvlIndex);
         exit(0);
     }
+    return span;
+}
 
-    if (lvlIndex >= 0) {
-        unsigned tileLon, tileLat;
-        unsigned meshLon, meshLat;
-        int subx, suby;
+SGDemTileRef SGDemSession::fetchTile(unsigned long key) const
+{
+    // get the tile from the tile cache, or read it if the session doesn't
+    // cover it. One lookup, so the cache counts a single hit or miss.
+    return pDemRoot->getOrCreateTile(key >> 16, key & 0xffff, lvlIndex);
+}
 
-        meshLon = wo;
-        tileLon = SGDem::roundDown(meshLon, lvlWidth);
-        subx = (meshLon - tileLon) / span;
-        // fprintf(stderr, "getGeods: lon is %lf : meshLon is %u, tileLon is %u, subx is %d\n", SGDem::offsetToLongitudeDeg(wo), meshLon, tileLon, subx );
+void SGDemSession::fillGrids(size_t count, const GridRequest* requests, SGDemGeodArrays* grids, bool Debug1, bool Debug2)
+{
+    if (lvlIndex < 0) {
+        return;
+    }
 
-        meshLat = so;
-        tileLat = SGDem::roundDown(meshLat, lvlHeight);
-        suby = (meshLat - tileLat) / span;
-        // fprintf(stderr, "getGeods: lat is %lf : meshLat is %u, tileLat is %u, suby is %d\n", SGDem::offsetToLatitudeDeg(so), meshLat, tileLat, suby );
+    const unsigned span = getSpan();
+    const int columnsPerJob = 16;
 
-        // get the tle from the tile cache
-        unsigned long key = tileLon << 16 | tileLat;
-        SGDemTileRef tile = pDemRoot->getTile(lvlIndex, key);
-        if (tile) {
-            tile->getGeods(wo, so, eo, no, resx, resy, subx, suby, incx, incy, geods, Debug1, Debug2);
-        } else {
-            fprintf(stderr, " *** ERROR: tile %u,%u not in session @ (%lf,%lf) - (%lf,%lf)\n",
-                tileLon, tileLat,
+    struct Job {
+        size_t request;
+        int firstCol, endCol;
+    };
+    ::std::vector<Job> jobs;
+    ::std::vector<unsigned long> requestKeys(count);
+    ::std::vector<int> subx(count), suby(count);
+
+    for (size_t i = 0; i < count; i++) {
+        const GridRequest& r = requests[i];
+        unsigned tileLon = SGDem::roundDown(r.wo, lvlWidth);
+        unsigned tileLat = SGDem::roundDown(r.so, lvlHeight);
+        subx[i] = (r.wo - tileLon) / span;
+        suby[i] = (r.so - tileLat) / span;
+        requestKeys[i] = SGDemRoot::getTileKey(tileLon, tileLat);
+
+        grids[i].resize((size_t)r.resx * r.resy);
+        for (int col = 0; col < r.resx; col += columnsPerJob) {
+            jobs.push_back({i, col, ::std::min(col + columnsPerJob, r.resx)});
+        }
+    }
+
+    // fetch ( and decode, if needed ) each tile once
+    ::std::vector<unsigned long> keys(requestKeys);
+    ::std::sort(keys.begin(), keys.end());
+    keys.erase(::std::unique(keys.begin(), keys.end()), keys.end());
+
+    SGJobPool& pool = SGJobPool::shared();
+    ::std::vector<SGDemTileRef> tiles(keys.size());
+    pool.parallelFor(keys.size(), [&](size_t k) {
+        tiles[k] = fetchTile(keys[k]);
+    });
+
+    ::std::vector<SGDemTile*> requestTiles(count);
+    for (size_t i = 0; i < count; i++) {
+        size_t k = ::std::lower_bound(keys.begin(), keys.end(), requestKeys[i]) - keys.begin();
+        requestTiles[i] = tiles[k].get();
+        if (!requestTiles[i]) {
+            fprintf(stderr, " *** ERROR: tile %lu,%lu not found @ (%lf,%lf) - (%lf,%lf)\n",
+                requestKeys[i] >> 16, requestKeys[i] & 0xffff,
                 SGDem::offsetToLongitudeDeg(west_off),
                 SGDem::offsetToLatitudeDeg(south_off),
                 SGDem::offsetToLongitudeDeg(east_off),
                 SGDem::offsetToLatitudeDeg(north_off));
         }
     }
+
+    // jobs write disjoint columns of the preallocated arrays
+    pool.parallelFor(jobs.size(), [&](size_t j) {
+        const Job& job = jobs[j];
+        const GridRequest& r = requests[job.request];
+        SGDemTile* tile = requestTiles[job.request];
+        if (tile) {
+            tile->getGeods(r.wo, r.so, r.eo, r.no, r.resx, r.resy,
+                subx[job.request], suby[job.request], r.incx, r.incy,
+                grids[job.request], Debug1, Debug2, job.firstCol, job.endCol);
+        }
+    });
+}
+
+void SGDemSession::getGeods(unsigned wo, unsigned so, unsigned eo, unsigned no, int resx, int resy, int incx, int incy, SGDemGeodArrays& geods, bool Debug1, bool Debug2)
+{
+    GridRequest request = {wo, so, eo, no, resx, resy, incx, incy};
+    fillGrids(1, &request, &geods, Debug1, Debug2);
+}
+
+void SGDemSession::getGeods(const ::std::vector<GridRequest>& requests, ::std::vector<SGDemGeodArrays>& grids)
+{
+    grids.resize(requests.size());
+    fillGrids(requests.size(), requests.data(), grids.data(), false, false);
+}
+
+void SGDemSession::getGeods(unsigned wo, unsigned so, unsigned eo, unsigned no, int resx, int resy, int incx, int incy, ::std::vector<SGGeod>& geods, bool Debug1, bool Debug2)
+{
+    SGDemGeodArrays arrays;
+    getGeods(wo, so, eo, no, resx, resy, incx, incy, arrays, Debug1, Debug2);
+
+    for (size_t i = 0; i < arrays.size() && i < geods.size(); i++) {
+        geods[i] = arrays.getGeod(i);
+    }
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include <simgear/scene/dem/SGDemRoot.hxx>
 
 class SGDemSession final {
@@ -74,6 +76,25 @@ public:
         ::std::vector<SGGeod>& geods,
         bool Debug1, bool Debug2);
 
+    // as above, into arrays resized to resx*resy
+    void getGeods(unsigned wo, unsigned so, unsigned eo, unsigned no,
+        int resx, int resy, int incx, int incy,
+        SGDemGeodArrays& geods,
+        bool Debug1, bool Debug2);
+
+    // area and grid of one mesh, as passed to getGeods
+    struct GridRequest {
+        unsigned wo, so, eo, no;
+        int resx, resy, incx, incy;
+    };
+
+    // grids of several meshes at once: grids[i] is resized to hold the grid
+    // of requests[i]. The tiles are fetched concurrently through the level
+    // cache ( read now if not in the session ), then the grids are filled in
+    // parallel, a few columns per job.
+    void getGeods(const ::std::vector<GridRequest>& requests,
+        ::std::vector<SGDemGeodArrays>& grids);
+
     void close(void);
 
     int getLvlIndex(void) const
@@ -82,6 +103,11 @@ public:
     };
 
 private:
+    unsigned getSpan( void ) const;
+    SGDemTileRef fetchTile( unsigned long key ) const;
+    void fillGrids( size_t count, const GridRequest* requests, SGDemGeodArrays* grids,
+        bool Debug1, bool Debug2 );
+
     void setOffsets( unsigned wo, unsigned so, unsigned eo, unsigned no ) {
         west_off  = wo;
         south_off = so;
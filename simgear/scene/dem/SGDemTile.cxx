@@ -280,16 +280,33 @@ unsigned short SGDemTile::getAlt( const SGGeod& loc ) const
     }
 }
 
-void SGDemTile::getGeods( unsigned wo, unsigned so, unsigned eo, unsigned no, int grid_width, int grid_height, unsigned subx, unsigned suby, int incw, int inch, ::std::vector<SGGeod>& geods, bool Debug1, bool Debug2 )
+void SGDemTile::getGeods( unsigned wo, unsigned so, unsigned eo, unsigned no, int grid_width, int grid_height, unsigned subx, unsigned suby, int incw, int inch, ::std::vector<SGGeod>& geods, bool Debug1, bool Debug2 ) const
+{
+    if ( !raster ) {
+        return;
+    }
+
+    SGDemGeodArrays arrays;
+    arrays.resize( grid_width*grid_height );
+    getGeods( wo, so, eo, no, grid_width, grid_height, subx, suby, incw, inch, arrays, Debug1, Debug2 );
+
+    for ( size_t i = 0; i < arrays.size(); i++ ) {
+        geods[i] = arrays.getGeod( i );
+    }
+}
+
+void SGDemTile::getGeods( unsigned wo, unsigned so, unsigned eo, unsigned no, int grid_width, int grid_height, unsigned subx, unsigned suby, int incw, int inch, SGDemGeodArrays& geods, bool Debug1, bool Debug2, int first_col, int end_col ) const
 {
     // grid width and height include the skirt
     // sw and ne do not
     // we need to find the starting and ending l and p;
-    int startl;//, endl;
-    int startp;//, endp;
     double startlat, startlon;
     double endlat,   endlon;
 
+    if ( end_col < 0 || end_col > grid_width ) {
+        end_col = grid_width;
+    }
+
     startlon = SGDem::offsetToLongitudeDeg(wo) - incw*pixResX;
     startlat = SGDem::offsetToLatitudeDeg(so)  - inch*pixResY;
 
@@ -297,44 +314,50 @@ void SGDemTile::getGeods( unsigned wo, unsigned so, unsigned eo, unsigned no, in
     endlat   = SGDem::offsetToLatitudeDeg(no)  + inch*pixResY;
 
     // todo : how to calculate 15- from given data
-    if ( Debug1 ) {
+    if ( Debug1 && first_col == 0 ) {
         printf("resx is %d resy is %d incw is %d incy is %d\n", resx, resy, incw, inch  );
     }
     if ( raster ) {
-        int    di, dj;
-        int    p, l;
-        double lonPos, latPos;
-        double maxlon = startlon;
-        double maxlat = startlat;
-
-        startl = (resy-1) + overlap - ( suby * (153-3) ) + inch;
-        startp = 0 + overlap + ( subx * (153-3) ) - incw;
-
-        for ( di = 0, p = startp, lonPos = startlon; di < grid_width; di++, p+=incw, lonPos += incw*pixResX ) {
-            maxlon = lonPos;
-
-            for ( dj = 0, l = startl, latPos = startlat; dj < grid_height; dj++, l-=inch, latPos += inch*pixResY ) {
-                maxlat = latPos;
-
-                SGGeod pos = SGGeod::fromDeg( SGMiscd::normalizePeriodic( -180.0, 180.0, lonPos ), 
-                                            SGMiscd::normalizePeriodic( -180.0, 180.0, latPos ) );
-
-                if ( raster ) {
-                    pos.setElevationM( raster[l*(resx+(2*overlap))+p] );
-                }
+        const int startl = (resy-1) + overlap - ( suby * (153-3) ) + inch;
+        const int startp = 0 + overlap + ( subx * (153-3) ) - incw;
+        const long stride = resx + (2*overlap);
+
+        // every column has the same latitudes
+        ::std::vector<double> lats( grid_height );
+        for ( int dj = 0; dj < grid_height; dj++ ) {
+            lats[dj] = SGMiscd::normalizePeriodic( -180.0, 180.0, startlat + dj*inch*pixResY );
+        }
 
-                geods[di*grid_height+dj] = pos;
+        // the column of raster samples runs north to south, the grid column south to north
+        const long rowStep = -(long)inch * stride;
+        for ( int di = first_col; di < end_col; di++ ) {
+            const double lon = SGMiscd::normalizePeriodic( -180.0, 180.0, startlon + di*incw*pixResX );
+            const unsigned short* src = raster + startl*stride + startp + (long)di*incw;
+            const size_t base = (size_t)di*grid_height;
+
+            double* lonOut  = &geods.lon[base];
+            double* latOut  = &geods.lat[base];
+            float*  elevOut = &geods.elev[base];
+            for ( int dj = 0; dj < grid_height; dj++ ) {
+                lonOut[dj]  = lon;
+                latOut[dj]  = lats[dj];
+                elevOut[dj] = src[dj*rowStep];
             }
         }
 
-        if ( fabs( endlon - maxlon ) > 0.0001 ) {
-            printf(" tile overlap error %lf : lon is %lf, startlon is %lf, endlon is %lf, maxlon is %lf. grid_width is %d, incw is %d, pixResX is %lf, (grid_width-1)*incw*pixResX is %lf\n",
-                endlon-maxlon, SGDem::offsetToLongitudeDeg(wo), startlon, endlon, maxlon, grid_width, incw, pixResX, (grid_width-1)*incw*pixResX );
-        }
+        if ( end_col == grid_width ) {
+            double maxlon = startlon + (grid_width-1)*incw*pixResX;
+            double maxlat = startlat + (grid_height-1)*inch*pixResY;
 
-        if ( fabs( endlat - maxlat ) > 0.0001 ) {
-            printf(" tile overlap error %lf : lat is %lf, startlat is %lf, endlat is %lf, maxlat is %lf. grid_height is %d, inch is %d, pixResY is %lf, (grid_height-1)*inch*pixResY is %lf\n",
-                endlat-maxlat, SGDem::offsetToLatitudeDeg(so), startlat, endlat, maxlat, grid_height, inch, pixResY, (grid_height-1)*inch*pixResY );
+            if ( fabs( endlon - maxlon ) > 0.0001 ) {
+                printf(" tile overlap error %lf : lon is %lf, startlon is %lf, endlon is %lf, maxlon is %lf. grid_width is %d, incw is %d, pixResX is %lf, (grid_width-1)*incw*pixResX is %lf\n",
+                    endlon-maxlon, SGDem::offsetToLongitudeDeg(wo), startlon, endlon, maxlon, grid_width, incw, pixResX, (grid_width-1)*incw*pixResX );
+            }
+
+            if ( fabs( endlat - maxlat ) > 0.0001 ) {
+                printf(" tile overlap error %lf : lat is %lf, startlat is %lf, endlat is %lf, maxlat is %lf. grid_height is %d, inch is %d, pixResY is %lf, (grid_height-1)*inch*pixResY is %lf\n",
+                    endlat-maxlat, SGDem::offsetToLatitudeDeg(so), startlat, endlat, maxlat, grid_height, inch, pixResY, (grid_height-1)*inch*pixResY );
+            }
         }
     }
 }
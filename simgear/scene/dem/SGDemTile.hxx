@@ -3,13 +3,37 @@
 #include <gdal.h>
 #include <gdal_priv.h>
 
-#include <map>
+#include <vector>
 
 #include <simgear/structure/SGSharedPtr.hxx>
 #include <simgear/math/SGGeod.hxx>
+#include <simgear/misc/sg_path.hxx>
 
 class SGDemSession;
 
+// grid of positions as separate arrays, indexed di*grid_height+dj as the
+// geods of SGDemTile::getGeods
+struct SGDemGeodArrays
+{
+    std::vector<double> lon;    // degrees
+    std::vector<double> lat;    // degrees
+    std::vector<float>  elev;   // meters
+
+    void resize( size_t n ) {
+        lon.resize( n );
+        lat.resize( n );
+        elev.resize( n );
+    }
+
+    size_t size( void ) const {
+        return lon.size();
+    }
+
+    SGGeod getGeod( size_t i ) const {
+        return SGGeod::fromDegM( lon[i], lat[i], elev[i] );
+    }
+};
+
 class SGDemTile : public SGReferenced
 {
 public:
@@ -30,7 +54,12 @@ public:
 
     SGPath getPath( void ) const { return path; }
     unsigned short getAlt(const SGGeod& loc) const;
-    void getGeods(unsigned wo, unsigned so, unsigned eo, unsigned no, int grid_width, int grid_height, unsigned subx, unsigned suby, int incw, int inch, ::std::vector<SGGeod>& geods, bool Debug1, bool Debug2);
+    void getGeods(unsigned wo, unsigned so, unsigned eo, unsigned no, int grid_width, int grid_height, unsigned subx, unsigned suby, int incw, int inch, ::std::vector<SGGeod>& geods, bool Debug1, bool Debug2) const;
+
+    // as above, into arrays sized grid_width*grid_height. Only columns
+    // [first_col, end_col) are filled, so disjoint column ranges can be
+    // filled from different threads ( end_col < 0 means all columns ).
+    void getGeods(unsigned wo, unsigned so, unsigned eo, unsigned no, int grid_width, int grid_height, unsigned subx, unsigned suby, int incw, int inch, SGDemGeodArrays& geods, bool Debug1, bool Debug2, int first_col = 0, int end_col = -1) const;
 
 private:
     std::string     getTileName( int lon, int lat );
@@ -59,4 +88,3 @@ private:
 };
 
 typedef SGSharedPtr<SGDemTile> SGDemTileRef;
-typedef std::map<unsigned long, SGDemTileRef> SGDemCache;
@@ -123,9 +123,9 @@ SGMesh::SGMesh( const SGDemPtr dem,
     normals   = NULL;
     texCoords = new osg::Vec2Array( grid_width*grid_height );
 
-    ::std::vector<SGGeod> geodes(grid_width*grid_height);
+    SGDemGeodArrays geodes;
 
-    // session can't be parallel yet - save alts in geode array
+    // tiles are read and the grid filled in parallel by the session
     fprintf( stderr, "SGMesh::SGMesh - create session - num dem roots is %d\n", dem->getNumRoots() );
     SGDemSession s = dem->openSession( wo, so, eo, no, lvl, true );
     s.getGeods( wo, so, eo, no, grid_width, grid_height, skipx, skipy, geodes, Debug1, Debug2 );
@@ -137,25 +137,25 @@ SGMesh::SGMesh( const SGDemPtr dem,
 
     // save west skirt
     for ( edge_idx = 0, src_idx = 0; edge_idx < grid_height; edge_idx++, src_idx++ ) {
-        skirt_geods.push_back( geodes[src_idx] );
+        skirt_geods.push_back( geodes.getGeod( src_idx ) );
         index.push_back( src_idx );
     }
 
     // save the north skirt vertices
     for ( edge_idx = 1, src_idx = (grid_height*2)-1; edge_idx < grid_width; edge_idx++, src_idx += grid_height ) {
-        skirt_geods.push_back( geodes[src_idx] );
+        skirt_geods.push_back( geodes.getGeod( src_idx ) );
         index.push_back( src_idx );
     }
 
     // save the east skirt vertices
     for ( edge_idx = 0, src_idx = grid_height*(grid_width-1); edge_idx < grid_height-1; edge_idx++, src_idx++ ) {
-        skirt_geods.push_back( geodes[src_idx] );
+        skirt_geods.push_back( geodes.getGeod( src_idx ) );
         index.push_back( src_idx );
     }
 
     // save the south skirt vertices
     for ( edge_idx = 1, src_idx = grid_height; edge_idx < grid_width-1; src_idx += grid_height, edge_idx++ ) {
-        skirt_geods.push_back( geodes[src_idx] );
+        skirt_geods.push_back( geodes.getGeod( src_idx ) );
         index.push_back( src_idx );
     }
 
@@ -163,7 +163,7 @@ SGMesh::SGMesh( const SGDemPtr dem,
     long nv = geodes.size();
 #pragma omp parallel for
     for (long i = 0; i < nv; i++) {
-        (*vertices)[i].set( toOsg( SGVec3f::fromGeod( geodes[i] ) ) );
+        (*vertices)[i].set( toOsg( SGVec3f::fromGeod( geodes.getGeod( i ) ) ) );
     }
 
     need_faces();
@@ -23,6 +23,7 @@
 #  include <simgear_config.h>
 #endif
 #include <algorithm>
+#include <atomic>
 #include "ReaderWriterSTG.hxx"
 
 #include <osg/LOD>
@@ -44,7 +45,6 @@
 #include <simgear/math/SGGeometry.hxx>
 #include <simgear/math/sg_random.hxx>
 
-#include <simgear/io/iostreams/sgstream.hxx>
 #include <simgear/scene/material/matlib.hxx>
 #include <simgear/scene/model/ModelRegistry.hxx>
 #include <simgear/scene/tgdb/LightBin.hxx>
@@ -117,6 +117,41 @@ using TokenCallbackMap = std::map<std::string,ReaderWriterSTG::STGObjectCallback
 static TokenCallbackMap globalStgObjectCallbacks = {};
 static OpenThreads::Mutex globalStgObjectCallbackLock;
 
+/**
+ * Queue for loading objects on worker threads, and the shared models loaded
+ * through it. Both are shared by all pager threads.
+ */
+static STGLoadQueue& globalLoadQueue()
+{
+    static STGLoadQueue queue(STGLoadQueue::defaultNumWorkers());
+    return queue;
+}
+static STGModelCache<vsg::ref_ptr<vsg::Node>>& globalSharedModelCache()
+{
+    static STGModelCache<vsg::ref_ptr<vsg::Node>> cache(256);
+    return cache;
+}
+static std::atomic<bool> globalViewerPositionSet{false};
+
+static STGLoadQueue* getLoadQueue(const osgDB::Options* options)
+{
+    const auto sgOpts = dynamic_cast<const SGReaderWriterOptions*>(options);
+    SGPropertyNode* propertyNode = sgOpts ? sgOpts->getPropertyNode().get() : nullptr;
+    if (!propertyNode || !propertyNode->getBoolValue("/sim/rendering/async-stg-load", false))
+        return nullptr;
+
+    STGLoadQueue& queue = globalLoadQueue();
+    SGPropertyNode* position = propertyNode->getNode("/position");
+    if (!globalViewerPositionSet && position &&
+        position->hasValue("longitude-deg") && position->hasValue("latitude-deg")) {
+        queue.setViewerPosition(SGVec3d::fromGeod(SGGeod::fromDegFt(
+            position->getDoubleValue("longitude-deg"),
+            position->getDoubleValue("latitude-deg"),
+            position->getDoubleValue("altitude-ft"))));
+    }
+    return &queue;
+}
+
 struct ReaderWriterSTG::_ModelBin {
     struct _Object {
         SGPath _errorLocation;
@@ -135,6 +170,8 @@ struct ReaderWriterSTG::_ModelBin {
         double _hdg, _pitch, _roll;
         double _range, _radius;
         vsg::ref_ptr<SGReaderWriterOptions> _options;
+        /// Shared model loaded in advance on the load queue
+        vsg::ref_ptr<vsg::Node> _node;
     };
     struct _Sign {
         _Sign() : _agl(false), _lon(0), _lat(0), _elev(0), _hdg(0), _size(-1) { }
@@ -222,13 +259,9 @@ struct ReaderWriterSTG::_ModelBin {
                 proxy->setCenterMode(osg::ProxyNode::UNION_OF_BOUNDING_SPHERE_AND_USER_DEFINED);
                 node = proxy;
             } else {
-                ErrorReportContext ec("terrain-stg", o._errorLocation.utf8Str());
-                node = osgDB::readRefNodeFile(o._name, o._options.get());
-                if (!node.valid()) {
-                    SG_LOG(SG_TERRAIN, SG_ALERT, o._errorLocation << ": Failed to load "
-                           << o._token << " '" << o._name << "'");
+                node = o._node.valid() ? o._node : loadModel(o);
+                if (!node.valid())
                     return;
-                }
             }
             if (SGPath(o._name).lower_extension() == "ac")
                 node->setNodeMask(~simgear::MODELLIGHT_BIT);
@@ -261,12 +294,65 @@ struct ReaderWriterSTG::_ModelBin {
       };
       typedef QuadTreeBuilder<osg::LOD*, _ObjectStatic, MakeQuadLeaf, AddModelLOD,
                               GetModelLODCoord>  STGObjectsQuadtree;
+
+      static vsg::ref_ptr<vsg::Node> loadModel(const _ObjectStatic& o)
+      {
+          ErrorReportContext ec("terrain-stg", o._errorLocation.utf8Str());
+          vsg::ref_ptr<vsg::Node> node = osgDB::readRefNodeFile(o._name, o._options.get());
+          if (!node.valid()) {
+              SG_LOG(SG_TERRAIN, SG_ALERT, o._errorLocation << ": Failed to load "
+                     << o._token << " '" << o._name << "'");
+          }
+          return node;
+      }
+
+      // Shared models are the same for every instance with the same search
+      // path, so each one is only loaded once.
+      static std::string sharedModelKey(const _ObjectStatic& o)
+      {
+          std::string key = o._name;
+          for (const auto& path : o._options->getDatabasePathList())
+              key += "\n" + path;
+          key += o._options->getInstantiateEffects() ? "\n1" : "\n0";
+          return key;
+      }
+
+      // Load the shared models on the load queue, closest to the viewer
+      // first. Returns false if the bucket has been cancelled or got out of
+      // range, so the pager requests it again once it is needed.
+      bool loadSharedModels(STGLoadQueue& queue)
+      {
+          double maxRange = 0;
+          for (const auto& o : _objectStaticList)
+              maxRange = std::max(maxRange, o._range);
+
+          // Objects are displayed up to twice their range from the bucket center
+          auto batch = queue.createBatch(_bucket.gen_index(), 2 * maxRange + SG_TILE_RADIUS);
+          for (auto& o : _objectStaticList) {
+              if (o._proxy)
+                  continue;
+
+              _ObjectStatic* object = &o;
+              queue.submit(batch, SGVec3d::fromGeod(SGGeod::fromDegM(o._lon, o._lat, o._elev)),
+                           [object] {
+                  object->_node = globalSharedModelCache().get(sharedModelKey(*object),
+                                                               [object] { return loadModel(*object); });
+              });
+          }
+          return queue.wait(batch);
+      }
     public:
         virtual osgDB::ReaderWriter::ReadResult
         readNode(const std::string&, const osgDB::Options*)
         {
             ErrorReportContext ec("terrain-bucket", _bucket.gen_index_str());
 
+            STGLoadQueue* queue = getLoadQueue(_options.get());
+            if (queue && !loadSharedModels(*queue)) {
+                SG_LOG(SG_TERRAIN, SG_DEBUG, "Loading objects of " << _bucket.gen_index_str() << " cancelled");
+                return ReadResult::ERROR_IN_READING_FILE;
+            }
+
             STGObjectsQuadtree quadtree((GetModelLODCoord()), (AddModelLOD()));
             quadtree.buildQuadTree(_objectStaticList.begin(), _objectStaticList.end());
             vsg::ref_ptr<vsg::Group> group = quadtree.getRoot();
@@ -530,8 +616,8 @@ struct ReaderWriterSTG::_ModelBin {
             return false;
         }
 
-        sg_gzifstream stream(absoluteFileName);
-        if (!stream.is_open()) {
+        std::vector<STGObjectDescriptor> objects;
+        if (!readSTGFile(absoluteFileName, objects)) {
             return false;
         }
 
@@ -560,29 +646,13 @@ struct ReaderWriterSTG::_ModelBin {
         // do only load terrain btg files
         bool onlyTerrain = options->getPluginStringData("SimGear::FG_ONLY_TERRAIN") == "ON";
 
-        while (!stream.eof()) {
-            // read a line
-            std::string line;
-            std::getline(stream, line);
-
-            // strip comments
-            std::string::size_type hash_pos = line.find('#');
-            if (hash_pos != std::string::npos)
-                line.resize(hash_pos);
-
-            // and process further
-            std::stringstream in(line);
+        // Objects with tokens handled by registered callbacks
+        std::vector<const STGObjectDescriptor*> callbackObjects;
 
-            std::string token;
-            in >> token;
-
-            // No comment
-            if (token.empty())
-                continue;
-
-            // Then there is always a name
-            std::string name;
-            in >> name;
+        for (const STGObjectDescriptor& object : objects) {
+            const std::string& token = object.token;
+            const std::string& name = object.name;
+            std::istringstream in(object.arguments);
 
             SGPath path = filePath;
             path.append(name);
@@ -769,28 +839,32 @@ struct ReaderWriterSTG::_ModelBin {
 
                     _instancedObjectList.push_back(instancedObject);
                 } else {
-                    // Check registered callback for token. Keep lock until callback completed to make sure it will not be
-                    // executed after a thread successfully executed removeSTGObjectHandler()
-                    {
-                        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(globalStgObjectCallbackLock);
-                        STGObjectCallback callback = globalStgObjectCallbacks[token];
-
-                        if (callback != nullptr) {
-                            _ObjectStatic obj;
-                            // pitch and roll are not common, so passed in "restofline" only
-                            in >> obj._lon >> obj._lat >> obj._elev >> obj._hdg;
-                            string_list restofline;
-                            std::string buf;
-                            while (in >> buf) {
-                                restofline.push_back(buf);
-                            }
-                            callback(token,name, SGGeod::fromDegM(obj._lon, obj._lat, obj._elev), obj._hdg,restofline);
-                        } else {
-                            // SG_LOG( SG_TERRAIN, SG_ALERT, absoluteFileName << ": Unknown token '" << token << "'" );
-                            simgear::reportFailure(simgear::LoadFailure::Misconfigured, simgear::ErrorCode::BTGLoad,
-                                                   "Unknown STG token:" + token, absoluteFileName);
-                        }
+                    callbackObjects.push_back(&object);
+                }
+            }
+        }
+
+        if (!callbackObjects.empty()) {
+            // Check registered callback for token. Keep lock until callbacks completed to make sure they will not be
+            // executed after a thread successfully executed removeSTGObjectHandler()
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(globalStgObjectCallbackLock);
+            for (const STGObjectDescriptor* object : callbackObjects) {
+                auto callback = globalStgObjectCallbacks.find(object->token);
+                if (callback != globalStgObjectCallbacks.end() && callback->second != nullptr) {
+                    double lon = 0, lat = 0, elev = 0, hdg = 0;
+                    // pitch and roll are not common, so passed in "restofline" only
+                    std::istringstream in(object->arguments);
+                    in >> lon >> lat >> elev >> hdg;
+                    string_list restofline;
+                    std::string buf;
+                    while (in >> buf) {
+                        restofline.push_back(buf);
                     }
+                    callback->second(object->token, object->name, SGGeod::fromDegM(lon, lat, elev), hdg, restofline);
+                } else {
+                    // SG_LOG( SG_TERRAIN, SG_ALERT, absoluteFileName << ": Unknown token '" << object->token << "'" );
+                    simgear::reportFailure(simgear::LoadFailure::Misconfigured, simgear::ErrorCode::BTGLoad,
+                                           "Unknown STG token:" + object->token, absoluteFileName);
                 }
             }
         }
@@ -798,6 +872,40 @@ struct ReaderWriterSTG::_ModelBin {
         return true;
     }
 
+    static vsg::ref_ptr<vsg::Node> loadObject(const _Object& stgObject)
+    {
+        simgear::ErrorReportContext ec("terrain-stg", stgObject._errorLocation.utf8Str());
+        vsg::ref_ptr<vsg::Node> node = osgDB::readRefNodeFile(stgObject._name, stgObject._options.get());
+        if (!node.valid()) {
+            SG_LOG(SG_TERRAIN, SG_ALERT, stgObject._errorLocation << ": Failed to load "
+                << stgObject._token << " '" << stgObject._name << "'");
+        }
+        return node;
+    }
+
+    // Load the OBJECT and OBJECT_BASE files, in parallel if there is a load
+    // queue. The nodes are in the order of the STG files.
+    bool loadObjects(const SGBucket& bucket, STGLoadQueue* queue,
+                     std::vector<vsg::ref_ptr<vsg::Node>>& nodes)
+    {
+        nodes.resize(_objectList.size());
+        size_t i = 0;
+        if (!queue) {
+            for (const auto& stgObject : _objectList)
+                nodes[i++] = loadObject(stgObject);
+            return true;
+        }
+
+        auto batch = queue->createBatch(bucket.gen_index());
+        const SGVec3d center = SGVec3d::fromGeod(bucket.get_center());
+        for (const auto& stgObject : _objectList) {
+            vsg::ref_ptr<vsg::Node>* node = &nodes[i++];
+            const _Object* object = &stgObject;
+            queue->submit(batch, center, [node, object] { *node = loadObject(*object); });
+        }
+        return queue->wait(batch);
+    }
+
     vsg::Node* load(const SGBucket& bucket, const osgDB::Options* opt)
     {
         vsg::ref_ptr<SGReaderWriterOptions> options;
@@ -811,6 +919,9 @@ struct ReaderWriterSTG::_ModelBin {
 
         simgear::ErrorReportContext ec{"terrain-bucket", bucket.gen_index_str()};
 
+        STGLoadQueue* queue = getLoadQueue(options.get());
+        std::vector<vsg::ref_ptr<vsg::Node>> objectNodes;
+
         bool vpb_active = SGSceneFeatures::instance()->getVPBActive();
         if (vpb_active) {
 
@@ -829,15 +940,12 @@ struct ReaderWriterSTG::_ModelBin {
             }
 
             // OBJECTs include airports
-            for (auto stgObject : _objectList) {
-                vsg::ref_ptr<vsg::Node> node;
-                node = osgDB::readRefNodeFile(stgObject._name, stgObject._options.get());
+            if (!loadObjects(bucket, queue, objectNodes))
+                return nullptr;
 
-                if (!node.valid()) {
-                    SG_LOG(SG_TERRAIN, SG_ALERT, stgObject._errorLocation << ": Failed to load "
-                        << stgObject._token << " '" << stgObject._name << "'");
+            for (const auto& node : objectNodes) {
+                if (!node.valid())
                     continue;
-                }
 
                 // Add the OBJECT to the elevation constraints of the terrain so the terrain
                 // doesn't poke through the airport
@@ -846,17 +954,12 @@ struct ReaderWriterSTG::_ModelBin {
                 terrainGroup->addChild(node.get());
             }
         } else if (_foundBase) {
-            for (auto stgObject : _objectList) {
-                vsg::ref_ptr<vsg::Node> node;
-                simgear::ErrorReportContext ec("terrain-stg", stgObject._errorLocation.utf8Str());
-                node = osgDB::readRefNodeFile(stgObject._name, stgObject._options.get());
-
-                if (!node.valid()) {
-                    SG_LOG(SG_TERRAIN, SG_ALERT, stgObject._errorLocation << ": Failed to load "
-                        << stgObject._token << " '" << stgObject._name << "'");
-                    continue;
-                }
-                terrainGroup->addChild(node.get());
+            if (!loadObjects(bucket, queue, objectNodes))
+                return nullptr;
+
+            for (const auto& node : objectNodes) {
+                if (node.valid())
+                    terrainGroup->addChild(node.get());
             }
         } else {
             SG_LOG(SG_TERRAIN, SG_INFO, "  Generating ocean tile: " << bucket.gen_base_path() << "/" << bucket.gen_index_str());
@@ -1030,7 +1133,12 @@ ReaderWriterSTG::readNode(const std::string& fileName, const osgDB::Options* opt
         }
     }
 
-    return modelBin.load(bucket, options);
+    vsg::Node* node = modelBin.load(bucket, options);
+    if (!node) {
+        SG_LOG(SG_TERRAIN, SG_DEBUG, "Loading tile " << fileName << " cancelled");
+        return ReadResult::ERROR_IN_READING_FILE;
+    }
+    return node;
 }
 
 
@@ -1046,6 +1154,17 @@ void ReaderWriterSTG::removeSTGObjectHandler(const std::string &token, STGObject
     globalStgObjectCallbacks.erase(token);
 }
 
+void ReaderWriterSTG::setViewerPosition(const SGVec3d& position)
+{
+    globalViewerPositionSet = true;
+    globalLoadQueue().setViewerPosition(position);
+}
+
+STGLoadQueue::Stats ReaderWriterSTG::getLoadQueueStats()
+{
+    return globalLoadQueue().getStats();
+}
+
 // Register the ModelRegistry callback
 namespace {
 ModelRegistryCallbackProxy<LoadOnlyCallback> g_stgCallbackProxy("stg");
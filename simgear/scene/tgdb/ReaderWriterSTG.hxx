@@ -25,6 +25,7 @@
 
 #include <osgDB/ReaderWriter>
 #include <simgear/math/sg_types.hxx>
+#include <simgear/scene/tgdb/STGLoadQueue.hxx>
 
 class SGGeod;
 class SGBucket;
@@ -46,6 +47,13 @@ public:
     //add/remove a callback that is invoked for unknown STG token
     static void setSTGObjectHandler(const std::string &token, STGObjectCallback callback);
     static void removeSTGObjectHandler(const std::string &token, STGObjectCallback callback);
+
+    // Objects are loaded on worker threads, closest to the viewer first, if
+    // /sim/rendering/async-stg-load is set. Without a viewer position given
+    // here, the one in /position is used. Objects further from the viewer
+    // than their range are not loaded, the pager requests the bucket again.
+    static void setViewerPosition(const SGVec3d& position);
+    static STGLoadQueue::Stats getLoadQueueStats();
 private:
     struct _ModelBin;
 };
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "SGSurfaceScatter.hxx"
+#include "SGTexturedTriangleBin.hxx"  // for getObjectMaskPlane
+
 // future API - just run through once to convert from OSG to SG
 // then we can use these triangle lists for random 
 // trees/lights/buildings/objects
@@ -221,71 +224,14 @@ public:
                                 osg::Texture2D* object_mask,
                                 std::vector<SGVec3f>& points)
     {
-        if ( !geometries.empty() ) {
-            const vsg::vec3Array* vertices  = dynamic_cast<vsg::vec3Array*>(geometries[0]->getVertexArray());
-            const osg::Vec2Array* texcoords = dynamic_cast<osg::Vec2Array*>(geometries[0]->getTexCoordArray(0));
-            
-            int numPrimitiveSets = geometries[0]->getNumPrimitiveSets();
-            if ( numPrimitiveSets > 0 ) {
-                const osg::PrimitiveSet* ps = geometries[0]->getPrimitiveSet(0);
-                unsigned int numIndices = ps->getNumIndices();
-                
-                for ( unsigned int i=2; i<numIndices; i+= 3 ) {                    
-                    SGVec3f v0 = toSG(vertices->operator[](ps->index(i-2)));
-                    SGVec3f v1 = toSG(vertices->operator[](ps->index(i-1)));
-                    SGVec3f v2 = toSG(vertices->operator[](ps->index(i-0)));
-                    
-                    SGVec2f t0 = toSG(texcoords->operator[](ps->index(i-2)));
-                    SGVec2f t1 = toSG(texcoords->operator[](ps->index(i-1)));
-                    SGVec2f t2 = toSG(texcoords->operator[](ps->index(i-0)));
-                    
-                    SGVec3f normal = cross(v1 - v0, v2 - v0);
-            
-                    // Compute the area
-                    float area = 0.5f*length(normal);
-                    if (area <= SGLimitsf::min())
-                        continue;
-            
-                    // For partial units of area, use a zombie door method to
-                    // create the proper random chance of a light being created
-                    // for this triangle
-                    float unit = area + mt_rand(&seed)*coverage;
-            
-                    SGVec3f offsetVector = offset*normalize(normal);
-                    // generate a light point for each unit of area
-            
-                    while ( coverage < unit ) {
-                        float a = mt_rand(&seed);
-                        float b = mt_rand(&seed);
-                
-                        if ( a + b > 1 ) {
-                            a = 1 - a;
-                            b = 1 - b;
-                        }
-                        float c = 1 - a - b;
-                        SGVec3f randomPoint = offsetVector + a*v0 + b*v1 + c*v2;
-                
-                        if (object_mask != NULL) {
-                            SGVec2f texCoord = a*t0 + b*t1 + c*t2;
-                    
-                            // Check this random point against the object mask
-                            // blue channel.
-                            vsg::Image* img = object_mask->getImage();            
-                            const uint32_t x = static_cast<uint32_t>(img->s() * texCoord.x()) % img->s();
-                            const uint32_t y = static_cast<uint32_t>(img->t() * texCoord.y()) % img->t();
-                    
-                            if (mt_rand(&seed) < img->getColor(x, y).b()) {
-                                points.push_back(randomPoint);        
-                            }                    
-                        } else {      
-                            // No object mask, so simply place the object  
-                            points.push_back(randomPoint);        
-                        }
-                        unit -= coverage;        
-                    }
-                }
-            }
-        }
+        SGSurfaceScatter scatter;
+        fillScatter(scatter);
+        scatter.prepareArea();
+
+        // Check the random points against the object mask blue channel.
+        std::vector<unsigned char> maskStorage;
+        scatter.scatter(1.0 / coverage, SurfacePointsSeed, offset,
+                        getObjectMaskPlane(object_mask, 2, maskStorage), points);
     }
 
     void addRandomTreePoints(float wood_coverage, 
@@ -299,9 +245,23 @@ public:
         using std::max;
         using std::min;
 
+        if (!is_plantation) {
+            // The number of trees takes into account vegetation density
+            // (which is linear) and the slope density factor. Points are
+            // checked against the object mask green (for trees) channel.
+            SGSurfaceScatter scatter;
+            fillScatter(scatter);
+            scatter.prepareSlope(cos_max_density_angle, cos_zero_density_angle);
+
+            std::vector<unsigned char> maskStorage;
+            scatter.scatter(vegetation_density * vegetation_density / wood_coverage,
+                            TreePointsSeed, 0.0f,
+                            getObjectMaskPlane(object_mask, 1, maskStorage), points);
+            return;
+        }
+
         if ( !geometries.empty() ) {
             const vsg::vec3Array* vertices  = dynamic_cast<vsg::vec3Array*>(geometries[0]->getVertexArray());
-            const osg::Vec2Array* texcoords = dynamic_cast<osg::Vec2Array*>(geometries[0]->getTexCoordArray(0));
 
             int numPrimitiveSets = geometries[0]->getNumPrimitiveSets();
             if ( numPrimitiveSets > 0 ) {
@@ -313,10 +273,6 @@ public:
                     SGVec3f v1 = toSG(vertices->operator[](ps->index(i-1)));
                     SGVec3f v2 = toSG(vertices->operator[](ps->index(i-0)));
 
-                    SGVec2f t0 = toSG(texcoords->operator[](ps->index(i-2)));
-                    SGVec2f t1 = toSG(texcoords->operator[](ps->index(i-1)));
-                    SGVec2f t2 = toSG(texcoords->operator[](ps->index(i-0)));
-
                     SGVec3f normal = cross(v1 - v0, v2 - v0);
 
                     // Ensure the slope isn't too steep by checking the
@@ -324,99 +280,53 @@ public:
                     // vertical (conveniently the z-component of the normalized
                     // normal) and values passed in.                   
                     float alpha = normalize(normal).z();
-                    float slope_density = 1.0;
-
                     if (alpha < cos_zero_density_angle) 
                         continue; // Too steep for any vegetation      
 
-                    if (alpha < cos_max_density_angle) {
-                        slope_density = 
-                        (alpha - cos_zero_density_angle) / (cos_max_density_angle - cos_zero_density_angle);
-                    }
-
                     // Compute the area
                     float area = 0.5f*length(normal);
                     if (area <= SGLimitsf::min())
                         continue;
 
-                    if (is_plantation)  {  // regularly-spaced vegetation
-                        // separate vegetation in integral 1m units
-                        int separation = (int) ceil(sqrt(wood_coverage));
-                        float max_x = ceil(max(max(v1.x(),v2.x()),v0.x()));
-                        float min_x = floor(min(min(v1.x(),v2.x()),v0.x()));
-                        float max_y = ceil(max(max(v1.y(),v2.y()),v0.y()));
-                        float min_y = floor(min(min(v1.y(),v2.y()),v0.y()));
-
-                        /* equation of the plane ax+by+cz+d=0, need d */
-
-                        float d = -1*(normal.x()*v0.x() + normal.y()*v0.y()+normal.z()*v0.z());
-                        /* Now loop over a grid, skipping points not in the triangle */
-                        int x_steps = (int) (max_x - min_x)/separation;
-                        int y_steps = (int) (max_y - min_y)/separation;
-                        SGVec2f v02d = SGVec2f(v0.x(),v0.y());
-                        SGVec2f v12d = SGVec2f(v1.x(),v1.y());
-                        SGVec2f v22d = SGVec2f(v2.x(),v2.y());
-
-                        for (int jx = 0; jx < x_steps; jx++) {
-                            float ptx = min_x + jx * separation;
-
-                            for (int jy = 0; jy < y_steps; jy++) {
-                                float pty = min_y + jy * separation;
-                                SGVec2f newpt = SGVec2f(ptx,pty);
-                                if (!point_in_triangle(newpt,v02d,v12d,v22d))
-                                    continue;
-
-                                // z = (-ax-by-d)/c; c is not zero as
-                                // that would be alpha of 1.0
-
-                                float ptz = (-normal.x()*ptx - normal.y()*pty-d)/normal.z();
-                                SGVec3f randomPoint = SGVec3f(ptx,pty,ptz);
-
-                                if (object_mask != NULL) {
-                                    // Check this point against the object mask
-                                    // green (for trees) channel.
-                                    vsg::Image* img = object_mask->getImage();
-                                    unsigned int x = (int) (img->s() * newpt.x()) % img->s();
-                                    unsigned int y = (int) (img->t() * newpt.y()) % img->t();
-
-                                    if (mt_rand(&seed) < img->getColor(x, y).g()) {
-                                        // The red channel contains the rotation for this object
-                                        points.push_back(randomPoint);
-                                    }
-                                } else {
-                                    points.push_back(randomPoint);
-                                }
-                            }
-                        }
-                    }  else  {
-                        // Determine the number of trees, taking into account vegetation
-                        // density (which is linear) and the slope density factor.
-                        // Use a zombie door method to create the proper random chance 
-                        // of a tree being created for partial values.
-                        int woodcount = (int) (vegetation_density * vegetation_density * 
-                                               slope_density *
-                                               area / wood_coverage + mt_rand(&seed));
-                        for (int j = 0; j < woodcount; j++) {
-                            // Use barycentric coordinates
-                            float a = mt_rand(&seed);
-                            float b = mt_rand(&seed);
-
-                            if ( a + b > 1.0f ) {
-                                a = 1.0f - a;
-                                b = 1.0f - b;
-                            }
+                    // regularly-spaced vegetation
+                    // separate vegetation in integral 1m units
+                    int separation = (int) ceil(sqrt(wood_coverage));
+                    float max_x = ceil(max(max(v1.x(),v2.x()),v0.x()));
+                    float min_x = floor(min(min(v1.x(),v2.x()),v0.x()));
+                    float max_y = ceil(max(max(v1.y(),v2.y()),v0.y()));
+                    float min_y = floor(min(min(v1.y(),v2.y()),v0.y()));
 
-                            float c = 1.0f - a - b;
+                    /* equation of the plane ax+by+cz+d=0, need d */
 
-                            SGVec3f randomPoint = a*v0 + b*v1 + c*v2;
-                            if (object_mask != NULL) {
-                                SGVec2f texCoord = a*t0 + b*t1 + c*t2;
+                    float d = -1*(normal.x()*v0.x() + normal.y()*v0.y()+normal.z()*v0.z());
+                    /* Now loop over a grid, skipping points not in the triangle */
+                    int x_steps = (int) (max_x - min_x)/separation;
+                    int y_steps = (int) (max_y - min_y)/separation;
+                    SGVec2f v02d = SGVec2f(v0.x(),v0.y());
+                    SGVec2f v12d = SGVec2f(v1.x(),v1.y());
+                    SGVec2f v22d = SGVec2f(v2.x(),v2.y());
+
+                    for (int jx = 0; jx < x_steps; jx++) {
+                        float ptx = min_x + jx * separation;
+
+                        for (int jy = 0; jy < y_steps; jy++) {
+                            float pty = min_y + jy * separation;
+                            SGVec2f newpt = SGVec2f(ptx,pty);
+                            if (!point_in_triangle(newpt,v02d,v12d,v22d))
+                                continue;
+
+                            // z = (-ax-by-d)/c; c is not zero as
+                            // that would be alpha of 1.0
 
-                                // Check this random point against the object mask
+                            float ptz = (-normal.x()*ptx - normal.y()*pty-d)/normal.z();
+                            SGVec3f randomPoint = SGVec3f(ptx,pty,ptz);
+
+                            if (object_mask != NULL) {
+                                // Check this point against the object mask
                                 // green (for trees) channel.
-                                vsg::Image* img = object_mask->getImage();       
-                                const uint32_t x = static_cast<uint32_t>(img->s() * texCoord.x()) % img->s();
-                                const uint32_t y = static_cast<uint32_t>(img->t() * texCoord.y()) % img->t();
+                                vsg::Image* img = object_mask->getImage();
+                                unsigned int x = (int) (img->s() * newpt.x()) % img->s();
+                                unsigned int y = (int) (img->t() * newpt.y()) % img->t();
 
                                 if (mt_rand(&seed) < img->getColor(x, y).g()) {
                                     // The red channel contains the rotation for this object
@@ -491,6 +401,30 @@ public:
 #endif    
     
 private:
+    // Seeds of the random surface and tree points, see SGTexturedTriangleBin
+    enum { SurfacePointsSeed = 123, TreePointsSeed = 586 };
+
+    void fillScatter( SGSurfaceScatter& scatter ) const
+    {
+        if ( geometries.empty() || geometries[0]->getNumPrimitiveSets() == 0 )
+            return;
+
+        const vsg::vec3Array* vertices  = dynamic_cast<vsg::vec3Array*>(geometries[0]->getVertexArray());
+        const osg::Vec2Array* texcoords = dynamic_cast<osg::Vec2Array*>(geometries[0]->getTexCoordArray(0));
+        const osg::PrimitiveSet* ps = geometries[0]->getPrimitiveSet(0);
+        unsigned int numIndices = ps->getNumIndices();
+
+        scatter.reserve(numIndices / 3);
+        for ( unsigned int i=2; i<numIndices; i+= 3 ) {
+            scatter.addTriangle(toSG(vertices->operator[](ps->index(i-2))),
+                                toSG(vertices->operator[](ps->index(i-1))),
+                                toSG(vertices->operator[](ps->index(i-0))),
+                                toSG(texcoords->operator[](ps->index(i-2))),
+                                toSG(texcoords->operator[](ps->index(i-1))),
+                                toSG(texcoords->operator[](ps->index(i-0))));
+        }
+    }
+
     mt seed;
     SGMaterial* mat;
     SGVec3d gbs_center;
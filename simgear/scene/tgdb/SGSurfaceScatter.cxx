@@ -0,0 +1,257 @@
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+/**
+ * @file
+ * @brief Random scattering of points (lights, trees) over a triangle set
+ */
+
+#include <simgear_config.h>
+
+#include "SGSurfaceScatter.hxx"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/// Number of points generated per batch
+const size_t BatchSize = 256;
+
+/// Random sequences used by scatter()
+enum Stream {
+    COUNT_STREAM = 1,
+    STRATUM_STREAM,
+    A_STREAM,
+    B_STREAM,
+    MASK_STREAM
+};
+
+/// Integer hash with good avalanche behaviour (C. Wellons, "triple32")
+inline uint32_t hash32(uint32_t x)
+{
+    x ^= x >> 17;
+    x *= 0xed5ad4bbU;
+    x ^= x >> 11;
+    x *= 0xac4c1b51U;
+    x ^= x >> 15;
+    x *= 0x31848babU;
+    x ^= x >> 14;
+    return x;
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+
+float
+SGSurfaceScatter::random(uint32_t key, uint32_t counter)
+{
+    // 24 bits fit exactly into a float in [0, 1). Converting from a signed
+    // integer allows the compiler to vectorize loops using this.
+    return float(int32_t(hash32(key + counter) >> 8)) * (1.0f / 16777216.0f);
+}
+
+uint32_t
+SGSurfaceScatter::randomKey(uint32_t seed, uint32_t stream)
+{
+    return hash32(hash32(seed) ^ (stream * 0x9e3779b9U));
+}
+
+//------------------------------------------------------------------------------
+
+void
+SGSurfaceScatter::clear()
+{
+    for (int i = 0; i < 3; ++i) {
+        _x[i].clear();
+        _y[i].clear();
+        _z[i].clear();
+        _s[i].clear();
+        _t[i].clear();
+    }
+    _nx.clear();
+    _ny.clear();
+    _nz.clear();
+    _cdf.clear();
+}
+
+void
+SGSurfaceScatter::reserve(size_t numTriangles)
+{
+    for (int i = 0; i < 3; ++i) {
+        _x[i].reserve(numTriangles);
+        _y[i].reserve(numTriangles);
+        _z[i].reserve(numTriangles);
+        _s[i].reserve(numTriangles);
+        _t[i].reserve(numTriangles);
+    }
+}
+
+void
+SGSurfaceScatter::addTriangle(const SGVec3f& v0, const SGVec3f& v1, const SGVec3f& v2,
+                              const SGVec2f& t0, const SGVec2f& t1, const SGVec2f& t2)
+{
+    const SGVec3f* v[3] = {&v0, &v1, &v2};
+    const SGVec2f* t[3] = {&t0, &t1, &t2};
+    for (int i = 0; i < 3; ++i) {
+        _x[i].push_back(v[i]->x());
+        _y[i].push_back(v[i]->y());
+        _z[i].push_back(v[i]->z());
+        _s[i].push_back(t[i]->x());
+        _t[i].push_back(t[i]->y());
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void
+SGSurfaceScatter::prepareArea()
+{
+    prepare(false, 0.0f, 0.0f);
+}
+
+void
+SGSurfaceScatter::prepareSlope(float cos_max_density_angle, float cos_zero_density_angle)
+{
+    prepare(true, cos_max_density_angle, cos_zero_density_angle);
+}
+
+void
+SGSurfaceScatter::prepare(bool slope, float cos_max_density_angle, float cos_zero_density_angle)
+{
+    const size_t num = getNumTriangles();
+    _nx.resize(num);
+    _ny.resize(num);
+    _nz.resize(num);
+
+    std::vector<float> weight(num);
+    const float min_area = SGLimitsf::min();
+    const float slope_scale = 1.0f / (cos_max_density_angle - cos_zero_density_angle);
+
+    for (size_t i = 0; i < num; ++i) {
+        const float e1x = _x[1][i] - _x[0][i], e1y = _y[1][i] - _y[0][i], e1z = _z[1][i] - _z[0][i];
+        const float e2x = _x[2][i] - _x[0][i], e2y = _y[2][i] - _y[0][i], e2z = _z[2][i] - _z[0][i];
+        const float nx = e1y * e2z - e1z * e2y;
+        const float ny = e1z * e2x - e1x * e2z;
+        const float nz = e1x * e2y - e1y * e2x;
+        const float len = std::sqrt(nx * nx + ny * ny + nz * nz);
+        const float area = 0.5f * len;
+        const float inv = len > 0.0f ? 1.0f / len : 0.0f;
+
+        _nx[i] = nx * inv;
+        _ny[i] = ny * inv;
+        _nz[i] = nz * inv;
+        weight[i] = area > min_area ? area : 0.0f;
+    }
+
+    if (slope) {
+        for (size_t i = 0; i < num; ++i) {
+            const float alpha = _nz[i];
+            float factor = 1.0f;
+            if (alpha < cos_zero_density_angle)
+                factor = 0.0f; // Too steep for any vegetation
+            else if (alpha < cos_max_density_angle)
+                factor = (alpha - cos_zero_density_angle) * slope_scale;
+            weight[i] *= factor;
+        }
+    }
+
+    _cdf.resize(num + 1);
+    _cdf[0] = 0.0;
+    for (size_t i = 0; i < num; ++i)
+        _cdf[i + 1] = _cdf[i] + weight[i];
+}
+
+//------------------------------------------------------------------------------
+
+void
+SGSurfaceScatter::scatter(double density, uint32_t seed, float offset,
+                          const MaskPlane& mask, std::vector<SGVec3f>& points) const
+{
+    const size_t numTriangles = getNumTriangles();
+    const double total = getTotalWeight();
+    if (numTriangles == 0 || !(total > 0.0) || !(density > 0.0))
+        return;
+
+    // For the fractional part of a point, use a zombie door method to
+    // create the proper random chance of it being placed
+    const size_t count = size_t(total * density + random(randomKey(seed, COUNT_STREAM), 0));
+    if (count == 0)
+        return;
+
+    const uint32_t stratumKey = randomKey(seed, STRATUM_STREAM);
+    const uint32_t aKey = randomKey(seed, A_STREAM);
+    const uint32_t bKey = randomKey(seed, B_STREAM);
+    const uint32_t maskKey = randomKey(seed, MASK_STREAM);
+    const double step = total / count;
+
+    uint32_t index[BatchSize];
+    float stratum[BatchSize], a[BatchSize], b[BatchSize], c[BatchSize];
+    float px[BatchSize], py[BatchSize], pz[BatchSize];
+    unsigned char keep[BatchSize];
+
+    const bool useMask = mask.valid();
+    points.reserve(points.size() + (useMask ? count / 2 : count));
+
+    size_t triangle = 0;
+    for (size_t first = 0; first < count; first += BatchSize) {
+        const size_t n = std::min(BatchSize, count - first);
+        const uint32_t k0 = uint32_t(first);
+
+        for (size_t j = 0; j < n; ++j) {
+            const uint32_t k = k0 + uint32_t(j);
+            stratum[j] = random(stratumKey, k);
+            a[j] = random(aKey, k);
+            b[j] = random(bKey, k);
+        }
+
+        // Triangle of each point: the strata are increasing, so the prefix
+        // sum is only walked forward once for all points
+        for (size_t j = 0; j < n; ++j) {
+            const double target = (double(first + j) + stratum[j]) * step;
+            while (triangle + 1 < numTriangles && _cdf[triangle + 1] <= target)
+                ++triangle;
+            index[j] = uint32_t(triangle);
+        }
+
+        // Fold into uniformly distributed barycentric coordinates
+        for (size_t j = 0; j < n; ++j) {
+            // flip is 0 or 1; u and v have 24 bits, so this is exactly
+            // 1 - u and 1 - v for flipped points
+            const float u = a[j], v = b[j];
+            const float flip = float(u + v > 1.0f);
+            a[j] = u + flip * (1.0f - 2.0f * u);
+            b[j] = v + flip * (1.0f - 2.0f * v);
+            c[j] = 1.0f - a[j] - b[j];
+        }
+
+        for (size_t j = 0; j < n; ++j) {
+            const uint32_t t = index[j];
+            px[j] = a[j] * _x[0][t] + b[j] * _x[1][t] + c[j] * _x[2][t] + offset * _nx[t];
+            py[j] = a[j] * _y[0][t] + b[j] * _y[1][t] + c[j] * _y[2][t] + offset * _ny[t];
+            pz[j] = a[j] * _z[0][t] + b[j] * _z[1][t] + c[j] * _z[2][t] + offset * _nz[t];
+        }
+
+        if (useMask) {
+            const float width = float(mask.width), height = float(mask.height);
+            for (size_t j = 0; j < n; ++j) {
+                const uint32_t t = index[j];
+                float s = a[j] * _s[0][t] + b[j] * _s[1][t] + c[j] * _s[2][t];
+                float r = a[j] * _t[0][t] + b[j] * _t[1][t] + c[j] * _t[2][t];
+                s -= std::floor(s);
+                r -= std::floor(r);
+                const unsigned x = std::min(unsigned(s * width), mask.width - 1);
+                const unsigned y = std::min(unsigned(r * height), mask.height - 1);
+                const unsigned char value = mask.data[y * mask.rowStride + x * mask.pixelStride];
+                keep[j] = random(maskKey, k0 + j) * 255.0f < float(value);
+            }
+        } else {
+            std::fill(keep, keep + n, 1);
+        }
+
+        for (size_t j = 0; j < n; ++j) {
+            if (keep[j])
+                points.push_back(SGVec3f(px[j], py[j], pz[j]));
+        }
+    }
+}
@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+/**
+ * @file
+ * @brief Random scattering of points (lights, trees) over a triangle set
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <simgear/math/SGMath.hxx>
+
+/**
+ * Scatters random points over a set of triangles, with a density
+ * proportional to the area of each triangle times an optional slope factor.
+ *
+ * The triangle weights are accumulated into a prefix sum once, and the
+ * points are then placed by stratified sampling of that distribution: point
+ * k is put at (k + u) / n along the prefix sum, so the expected number of
+ * points on each triangle is its weighted area times the density, and
+ * triangles are visited in order without any per-point search. Points are
+ * generated in batches using a counter based random number generator, so
+ * each stage of a batch is a straight loop over plain arrays.
+ *
+ * The result only depends on the triangles (and their order), the
+ * parameters and the seed. The same seed gives the same points on every
+ * call, independent of what has been scattered before.
+ */
+class SGSurfaceScatter
+{
+public:
+    /**
+     * Plane of 8 bit values, e.g. one channel of an RGBA object mask image.
+     * Points are kept with a probability of value / 255 at their (wrapped)
+     * texture coordinate.
+     */
+    struct MaskPlane {
+        const unsigned char* data = nullptr;
+        unsigned width = 0;
+        unsigned height = 0;
+        size_t pixelStride = 1;
+        size_t rowStride = 0;
+
+        bool valid() const { return data && width && height; }
+    };
+
+    void clear();
+    void reserve(size_t numTriangles);
+
+    void addTriangle(const SGVec3f& v0, const SGVec3f& v1, const SGVec3f& v2,
+                     const SGVec2f& t0, const SGVec2f& t1, const SGVec2f& t2);
+
+    size_t getNumTriangles() const { return _x[0].size(); }
+
+    /// Weight the triangles by their area only
+    void prepareArea();
+
+    /**
+     * Weight the triangles by their area times a slope factor, which is one
+     * up to the slope with a normal z of @a cos_max_density_angle and
+     * falls linearly to zero at @a cos_zero_density_angle.
+     */
+    void prepareSlope(float cos_max_density_angle, float cos_zero_density_angle);
+
+    /// Sum of all triangle weights, available after prepareArea/prepareSlope
+    double getTotalWeight() const { return _cdf.empty() ? 0.0 : _cdf.back(); }
+
+    /**
+     * Append the random points to @a points.
+     *
+     * @param density  Points per unit of weight (area)
+     * @param seed     Seed for this set of points
+     * @param offset   Distance the points are moved along the triangle normal
+     * @param mask     Optional mask plane
+     */
+    void scatter(double density, uint32_t seed, float offset,
+                 const MaskPlane& mask, std::vector<SGVec3f>& points) const;
+
+    /// Uniform random number in [0, 1) for a position in a random sequence
+    static float random(uint32_t key, uint32_t counter);
+    /// Key of the random sequence @a stream for @a seed
+    static uint32_t randomKey(uint32_t seed, uint32_t stream);
+
+private:
+    void prepare(bool slope, float cos_max_density_angle, float cos_zero_density_angle);
+
+    // Vertices, texture coordinates, and unit normal as structure of arrays
+    std::vector<float> _x[3], _y[3], _z[3];
+    std::vector<float> _s[3], _t[3];
+    std::vector<float> _nx, _ny, _nz;
+
+    /// _cdf[i] is the sum of the weights of all triangles before i
+    std::vector<double> _cdf;
+};
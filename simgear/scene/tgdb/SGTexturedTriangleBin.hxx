@@ -36,72 +36,45 @@
 #include <simgear/math/sg_random.hxx>
 #include <simgear/scene/util/OsgMath.hxx>
 
+#include "SGSurfaceScatter.hxx"
 #include "SGTriangleBin.hxx"
-
-
-struct SGVertNormTex {
-  SGVertNormTex() { 
-      tc_mask = 0;
-  }
-
-  struct less
-  {
-    inline bool tc_is_less ( const SGVertNormTex& l,
-                             const SGVertNormTex& r,
-                             int   idx ) const
-    {
-        if ( r.tc_mask & 1<<idx ) {
-            if ( l.tc_mask & 1<<idx ) {
-                if (l.texCoord[idx] < r.texCoord[idx]) {
-                    return true;
-                }
-            }
-        } 
-        
-        return false;
-    };
-    
-    inline bool operator() (const SGVertNormTex& l,
-                            const SGVertNormTex& r) const
-    {
-      if (l.vertex < r.vertex) return true;
-      else if (r.vertex < l.vertex) return false;
-      else if (l.normal < r.normal) return true;
-      else if (r.normal < l.normal) return false;
-      else if ( tc_is_less( l, r, 0 ) ) return true;
-      else if ( tc_is_less( r, l, 0 ) ) return false;
-      else if ( tc_is_less( l, r, 1 ) ) return true;
-      else if ( tc_is_less( r, l, 1 ) ) return false;
-      else if ( tc_is_less( l, r, 2 ) ) return true;
-      else if ( tc_is_less( r, l, 2 ) ) return false;
-      else if ( tc_is_less( l, r, 3 ) ) return true;
-      else return false;
+#include "SGVertNormTex.hxx"
+
+// One channel (0 red, 1 green, 2 blue) of an object mask as a plane for
+// SGSurfaceScatter. 8 bit RGB(A) images are used in place, other formats
+// are converted into storage.
+inline SGSurfaceScatter::MaskPlane
+getObjectMaskPlane(osg::Texture2D* object_mask, unsigned channel,
+                   std::vector<unsigned char>& storage)
+{
+  SGSurfaceScatter::MaskPlane plane;
+  vsg::Image* img = object_mask ? object_mask->getImage() : NULL;
+  if (!img || img->s() <= 0 || img->t() <= 0)
+    return plane;
+
+  plane.width = img->s();
+  plane.height = img->t();
+  if (img->getDataType() == GL_UNSIGNED_BYTE &&
+      (img->getPixelFormat() == GL_RGB || img->getPixelFormat() == GL_RGBA)) {
+    plane.data = img->data() + channel;
+    plane.pixelStride = img->getPixelFormat() == GL_RGBA ? 4 : 3;
+    plane.rowStride = img->getRowStepInBytes();
+  } else {
+    storage.resize(size_t(plane.width) * plane.height);
+    for (unsigned y = 0; y < plane.height; ++y) {
+      for (unsigned x = 0; x < plane.width; ++x) {
+        float value = img->getColor(x, y)[channel];
+        storage[size_t(y) * plane.width + x] =
+          (unsigned char)(SGMiscf::clip(value, 0, 1) * 255.0f + 0.5f);
+      }
     }
-  };
-
-  void SetVertex( const SGVec3f& v )          { vertex = v; }
-  const SGVec3f& GetVertex( void ) const      { return vertex; }
-  
-  void SetNormal( const SGVec3f& n )          { normal = n; }
-  const SGVec3f& GetNormal( void ) const      { return normal; }
-  
-  void SetTexCoord( unsigned idx, const SGVec2f& tc ) { 
-      texCoord[idx] = tc; 
-      tc_mask |= 1 << idx; 
+    plane.data = storage.data();
+    plane.pixelStride = 1;
+    plane.rowStride = plane.width;
   }
-  const SGVec2f& GetTexCoord( unsigned idx ) const { return texCoord[idx]; }
+  return plane;
+}
 
-  void SetOverlayCoord( const SGVec2f& ovc )  { overlayCoord = ovc; }
-  const SGVec2f& GetOverlayCoord() const { return overlayCoord; }
-
-private:  
-  SGVec3f vertex;
-  SGVec3f normal;
-  SGVec2f texCoord[4];
-  SGVec2f overlayCoord;
-  
-  unsigned tc_mask;
-};
 
 // Use a DrawElementsUShort if there are few enough vertices,
 // otherwise fallback to DrawElementsUInt. Hide the differences
@@ -158,61 +131,14 @@ public:
                               osg::Texture2D* object_mask,
                               std::vector<SGVec3f>& points)
   {
-    unsigned num = getNumTriangles();
-    for (unsigned i = 0; i < num; ++i) {
-      triangle_ref triangleRef = getTriangleRef(i);
-      SGVec3f v0 = getVertex(triangleRef[0]).GetVertex();
-      SGVec3f v1 = getVertex(triangleRef[1]).GetVertex();
-      SGVec3f v2 = getVertex(triangleRef[2]).GetVertex();
-      SGVec2f t0 = getVertex(triangleRef[0]).GetTexCoord(0);
-      SGVec2f t1 = getVertex(triangleRef[1]).GetTexCoord(0);
-      SGVec2f t2 = getVertex(triangleRef[2]).GetTexCoord(0);
-      SGVec3f normal = cross(v1 - v0, v2 - v0);
-      
-      // Compute the area
-      float area = 0.5f*length(normal);
-      if (area <= SGLimitsf::min())
-        continue;
-      
-      // For partial units of area, use a zombie door method to
-      // create the proper random chance of a light being created
-      // for this triangle
-      float unit = area + mt_rand(&seed)*coverage;
-      
-      SGVec3f offsetVector = offset*normalize(normal);
-      // generate a light point for each unit of area
-
-      while ( coverage < unit ) {
-
-        float a = mt_rand(&seed);
-        float b = mt_rand(&seed);
-
-        if ( a + b > 1 ) {
-          a = 1 - a;
-          b = 1 - b;
-        }
-        float c = 1 - a - b;
-        SGVec3f randomPoint = offsetVector + a*v0 + b*v1 + c*v2;
-        
-        if (object_mask != NULL) {
-          SGVec2f texCoord = a*t0 + b*t1 + c*t2;
-          
-          // Check this random point against the object mask
-          // blue channel.
-          vsg::Image* img = object_mask->getImage();            
-          unsigned int x = (int) (img->s() * texCoord.x()) % img->s();
-          unsigned int y = (int) (img->t() * texCoord.y()) % img->t();
-          
-          if (mt_rand(&seed) < img->getColor(x, y).b()) {
-            points.push_back(randomPoint);        
-          }                    
-        } else {      
-          // No object mask, so simply place the object  
-          points.push_back(randomPoint);        
-        }
-        unit -= coverage;        
-      }
-    }
+    SGSurfaceScatter scatter;
+    fillScatter(scatter);
+    scatter.prepareArea();
+
+    // Check the random points against the object mask blue channel.
+    std::vector<unsigned char> maskStorage;
+    scatter.scatter(1.0 / coverage, SurfacePointsSeed, offset,
+                    getObjectMaskPlane(object_mask, 2, maskStorage), points);
   }
 
   // Computes and adds random surface points to the points list for tree
@@ -228,15 +154,27 @@ public:
       using std::max;
       using std::min;
 
+      if (!is_plantation) {
+          // The number of trees takes into account vegetation density
+          // (which is linear) and the slope density factor. Points are
+          // checked against the object mask green (for trees) channel.
+          SGSurfaceScatter scatter;
+          fillScatter(scatter);
+          scatter.prepareSlope(cos_max_density_angle, cos_zero_density_angle);
+
+          std::vector<unsigned char> maskStorage;
+          scatter.scatter(vegetation_density * vegetation_density / wood_coverage,
+                          TreePointsSeed, 0.0f,
+                          getObjectMaskPlane(object_mask, 1, maskStorage), points);
+          return;
+      }
+
       unsigned num = getNumTriangles();
       for (unsigned i = 0; i < num; ++i) {
           triangle_ref triangleRef = getTriangleRef(i);
           SGVec3f v0 = getVertex(triangleRef[0]).GetVertex();
           SGVec3f v1 = getVertex(triangleRef[1]).GetVertex();
           SGVec3f v2 = getVertex(triangleRef[2]).GetVertex();
-          SGVec2f t0 = getVertex(triangleRef[0]).GetTexCoord(0);
-          SGVec2f t1 = getVertex(triangleRef[1]).GetTexCoord(0);
-          SGVec2f t2 = getVertex(triangleRef[2]).GetTexCoord(0);
           SGVec3f normal = cross(v1 - v0, v2 - v0);
 
           // Ensure the slope isn't too steep by checking the
@@ -244,102 +182,54 @@ public:
           // vertical (conveniently the z-component of the normalized
           // normal) and values passed in.
           float alpha = normalize(normal).z();
-          float slope_density = 1.0;
-
           if (alpha < cos_zero_density_angle)
               continue; // Too steep for any vegetation
 
-          if (alpha < cos_max_density_angle) {
-              slope_density =
-                  (alpha - cos_zero_density_angle) / (cos_max_density_angle - cos_zero_density_angle);
-          }
-
           // Compute the area
           float area = 0.5f * length(normal);
           if (area <= SGLimitsf::min())
               continue;
-          if (is_plantation) { // regularly-spaced vegetation
-
-              int separation = (int)ceil(sqrt(wood_coverage));
-              float max_x = ceil(max(max(v1.x(), v2.x()), v0.x()));
-              float min_x = floor(min(min(v1.x(), v2.x()), v0.x()));
-              float max_y = ceil(max(max(v1.y(), v2.y()), v0.y()));
-              float min_y = floor(min(min(v1.y(), v2.y()), v0.y()));
 
-              // equation of the plane ax+by+cz+d=0, need d
+          // regularly-spaced vegetation
+          int separation = (int)ceil(sqrt(wood_coverage));
+          float max_x = ceil(max(max(v1.x(), v2.x()), v0.x()));
+          float min_x = floor(min(min(v1.x(), v2.x()), v0.x()));
+          float max_y = ceil(max(max(v1.y(), v2.y()), v0.y()));
+          float min_y = floor(min(min(v1.y(), v2.y()), v0.y()));
 
-              float d = -1 * (normal.x() * v0.x() + normal.y() * v0.y() + normal.z() * v0.z());
+          // equation of the plane ax+by+cz+d=0, need d
 
-              // Now loop over a grid, skipping points not in the triangle
+          float d = -1 * (normal.x() * v0.x() + normal.y() * v0.y() + normal.z() * v0.z());
 
-              int x_steps = (int)(max_x - min_x) / separation;
-              int y_steps = (int)(max_y - min_y) / separation;
-              SGVec2f v02d = SGVec2f(v0.x(), v0.y());
-              SGVec2f v12d = SGVec2f(v1.x(), v1.y());
-              SGVec2f v22d = SGVec2f(v2.x(), v2.y());
+          // Now loop over a grid, skipping points not in the triangle
 
-              for (int jx = 0; jx < x_steps; jx++) {
-                  float ptx = min_x + jx * separation;
+          int x_steps = (int)(max_x - min_x) / separation;
+          int y_steps = (int)(max_y - min_y) / separation;
+          SGVec2f v02d = SGVec2f(v0.x(), v0.y());
+          SGVec2f v12d = SGVec2f(v1.x(), v1.y());
+          SGVec2f v22d = SGVec2f(v2.x(), v2.y());
 
-                  for (int jy = 0; jy < y_steps; jy++) {
-                      float pty = min_y + jy * separation;
-                      SGVec2f newpt = SGVec2f(ptx, pty);
-                      if (!point_in_triangle(newpt, v02d, v12d, v22d))
-                          continue;
+          for (int jx = 0; jx < x_steps; jx++) {
+              float ptx = min_x + jx * separation;
 
-                      // z = (-ax-by-d)/c; c is not zero as
-                      // that would be alpha of 1.0
+              for (int jy = 0; jy < y_steps; jy++) {
+                  float pty = min_y + jy * separation;
+                  SGVec2f newpt = SGVec2f(ptx, pty);
+                  if (!point_in_triangle(newpt, v02d, v12d, v22d))
+                      continue;
 
-                      float ptz = (-normal.x() * ptx - normal.y() * pty - d) / normal.z();
-                      SGVec3f randomPoint = SGVec3f(ptx, pty, ptz);
+                  // z = (-ax-by-d)/c; c is not zero as
+                  // that would be alpha of 1.0
 
-                      if (object_mask != NULL) {
-                          // Check this point against the object mask
-                          // green (for trees) channel.
-                          vsg::Image* img = object_mask->getImage();
-                          unsigned int x = (int)(img->s() * newpt.x()) % img->s();
-                          unsigned int y = (int)(img->t() * newpt.y()) % img->t();
-
-                          if (mt_rand(&seed) < img->getColor(x, y).g()) {
-                              // The red channel contains the rotation for this object
-                              points.push_back(randomPoint);
-                          }
-                      } else {
-                          points.push_back(randomPoint);
-                      }
-                  }
-              }
-          } else {
-              // Determine the number of trees, taking into account vegetation
-              // density (which is linear) and the slope density factor.
-              // Use a zombie door method to create the proper random chance
-              // of a tree being created for partial values.
-              int woodcount = (int)(vegetation_density * vegetation_density *
-                                        slope_density *
-                                        area / wood_coverage +
-                                    mt_rand(&seed));
-
-              for (int j = 0; j < woodcount; j++) {
-                  float a = mt_rand(&seed);
-                  float b = mt_rand(&seed);
-
-                  if (a + b > 1.0f) {
-                      a = 1.0f - a;
-                      b = 1.0f - b;
-                  }
-
-                  float c = 1.0f - a - b;
-
-                  SGVec3f randomPoint = a * v0 + b * v1 + c * v2;
+                  float ptz = (-normal.x() * ptx - normal.y() * pty - d) / normal.z();
+                  SGVec3f randomPoint = SGVec3f(ptx, pty, ptz);
 
                   if (object_mask != NULL) {
-                      SGVec2f texCoord = a * t0 + b * t1 + c * t2;
-
-                      // Check this random point against the object mask
+                      // Check this point against the object mask
                       // green (for trees) channel.
                       vsg::Image* img = object_mask->getImage();
-                      unsigned int x = (int)(img->s() * texCoord.x()) % img->s();
-                      unsigned int y = (int)(img->t() * texCoord.y()) % img->t();
+                      unsigned int x = (int)(img->s() * newpt.x()) % img->s();
+                      unsigned int y = (int)(img->t() * newpt.y()) % img->t();
 
                       if (mt_rand(&seed) < img->getColor(x, y).g()) {
                           // The red channel contains the rotation for this object
@@ -526,8 +416,27 @@ public:
   }
   
   void hasSecondaryTexCoord( bool sec_tc ) { has_sec_tcs = sec_tc; }
+  bool hasSecondaryTexCoord() const { return has_sec_tcs; }
 
 private:
+  // Seeds of the random surface and tree points. They do not depend on any
+  // state of the bin, so every call places the same points.
+  enum { SurfacePointsSeed = 123, TreePointsSeed = 586 };
+
+  void fillScatter(SGSurfaceScatter& scatter) const
+  {
+    unsigned num = getNumTriangles();
+    scatter.reserve(num);
+    for (unsigned i = 0; i < num; ++i) {
+      triangle_ref triangleRef = getTriangleRef(i);
+      const SGVertNormTex& v0 = getVertex(triangleRef[0]);
+      const SGVertNormTex& v1 = getVertex(triangleRef[1]);
+      const SGVertNormTex& v2 = getVertex(triangleRef[2]);
+      scatter.addTriangle(v0.GetVertex(), v1.GetVertex(), v2.GetVertex(),
+                          v0.GetTexCoord(0), v1.GetTexCoord(0), v2.GetTexCoord(0));
+    }
+  }
+
   // Random seed for the triangle.
   mt seed;
   
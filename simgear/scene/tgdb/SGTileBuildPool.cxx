@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+/**
+ * @file
+ * @brief Shared job pool for building tile geometry in parallel
+ */
+
+#include <simgear_config.h>
+
+#include "SGTileBuildPool.hxx"
+
+#include <memory>
+#include <mutex>
+
+#include <simgear/props/props.hxx>
+#include <simgear/scene/util/SGReaderWriterOptions.hxx>
+#include <simgear/threads/SGJobPool.hxx>
+
+#include "SGTileCache.hxx"
+
+namespace simgear {
+
+SGJobPool* getTileBuildPool(const SGReaderWriterOptions* options)
+{
+    if (!options)
+        return nullptr;
+
+    SGPropertyNode* propertyNode = options->getPropertyNode().get();
+    if (!propertyNode
+        || !propertyNode->getBoolValue("/sim/rendering/parallel-tile-build", false))
+        return nullptr;
+
+    // Shared with the other subsystems. Loops of several pager threads are
+    // serialised by the pool, which is fine as each one already keeps every
+    // core busy.
+    SGJobPool& pool = SGJobPool::shared();
+    return pool.concurrency() > 1 ? &pool : nullptr;
+}
+
+SGTileCache* getTileCache(const SGReaderWriterOptions* options)
+{
+    static std::mutex lock;
+    static std::unique_ptr<SGTileCache> cache;
+    static bool initialized = false;
+
+    std::lock_guard<std::mutex> g(lock);
+    if (initialized)
+        return cache.get();
+
+    SGPropertyNode* propertyNode = options ? options->getPropertyNode().get() : nullptr;
+    if (!propertyNode)
+        return nullptr;
+
+    initialized = true;
+    const std::string path = propertyNode->getStringValue("/sim/rendering/tile-cache/path", "");
+    if (path.empty())
+        return nullptr;
+
+    const uint64_t maxSize =
+        propertyNode->getLongValue("/sim/rendering/tile-cache/max-size-mb", 1024);
+    cache.reset(new SGTileCache(SGPath::fromUtf8(path), maxSize * 1024 * 1024));
+    return cache.get();
+}
+
+} // namespace simgear
@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+/**
+ * @file
+ * @brief Shared job pool for building tile geometry in parallel
+ */
+
+#pragma once
+
+class SGJobPool;
+class SGTileCache;
+
+namespace simgear {
+
+class SGReaderWriterOptions;
+
+/**
+ * Job pool shared by all tile loader threads, if parallel tile building is
+ * enabled with /sim/rendering/parallel-tile-build.
+ *
+ * Work is split per material and every material keeps its own random seed,
+ * so the generated geometry is identical to building the tile serially.
+ *
+ * @return nullptr if tiles should be built on the loading thread only
+ */
+SGJobPool* getTileBuildPool(const SGReaderWriterOptions* options);
+
+/**
+ * On-disk cache of processed tile geometry shared by all tile loader
+ * threads, if /sim/rendering/tile-cache/path is set. Its size is limited to
+ * /sim/rendering/tile-cache/max-size-mb. Both are read on first use.
+ *
+ * @return nullptr if tile geometry should not be cached
+ */
+SGTileCache* getTileCache(const SGReaderWriterOptions* options);
+
+} // namespace simgear
@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+/**
+ * @file
+ * @brief Unit test comparing serial and parallel tile geometry builds
+ */
+
+#include <simgear_config.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <simgear/constants.h>
+#include <simgear/io/sg_binobj.hxx>
+#include <simgear/misc/test_macros.hxx>
+#include <simgear/threads/SGJobPool.hxx>
+
+#include "SGTileGeometryBin.hxx"
+
+using std::cout;
+using std::endl;
+
+static const int grid_size = 24;
+static const float grid_spacing = 50.0f;
+
+/// Terrain mesh with the groups of four materials interleaved, as in BTG
+/// files where a material is used by several groups
+static SGBinObject createTile()
+{
+  std::vector<SGVec3d> nodes;
+  std::vector<SGVec3f> normals;
+  std::vector<SGVec2f> texCoords;
+  for (int y = 0; y <= grid_size; ++y) {
+    for (int x = 0; x <= grid_size; ++x) {
+      const double h = 20 * std::sin(0.3 * x) * std::cos(0.2 * y);
+      nodes.push_back(SGVec3d(x * grid_spacing, y * grid_spacing, h));
+      normals.push_back(normalize(SGVec3f(-std::cos(0.3f * x), std::sin(0.2f * y), 5)));
+      texCoords.push_back(SGVec2f(x / 4.0f, y / 4.0f));
+    }
+  }
+
+  SGBinObject obj;
+  obj.set_wgs84_nodes(nodes);
+  obj.set_normals(normals);
+  obj.set_texcoords(texCoords);
+  obj.set_overlaycoords(texCoords);
+
+  const char* materials[] = { "Grass", "Road", "Water", "DeciduousForest" };
+  auto node = [](int x, int y) { return y * (grid_size + 1) + x; };
+  for (int y = 0; y < grid_size; ++y) {
+    for (int x0 = 0; x0 < grid_size; x0 += 3) {
+      SGBinObjectTriangle tri;
+      tri.material = materials[(y / 2 + x0 / 3) % 4];
+      for (int x = x0; x < x0 + 3 && x < grid_size; ++x) {
+        for (int i : { node(x, y), node(x + 1, y), node(x + 1, y + 1),
+                       node(x, y), node(x + 1, y + 1), node(x, y + 1) }) {
+          tri.v_list.push_back(i);
+          tri.n_list.push_back(i);
+          tri.tc_list[0].push_back(i);
+        }
+      }
+      obj.add_triangle(tri);
+    }
+  }
+  return obj;
+}
+
+static void checkSameBins(const SGTileGeometryBin& serial, const SGTileGeometryBin& parallel)
+{
+  SG_CHECK_EQUAL(serial.materialTriangleMap.size(), 4u);
+  SG_CHECK_EQUAL(serial.materialTriangleMap.size(), parallel.materialTriangleMap.size());
+
+  auto s = serial.materialTriangleMap.begin();
+  auto p = parallel.materialTriangleMap.begin();
+  for (; s != serial.materialTriangleMap.end(); ++s, ++p) {
+    SG_CHECK_EQUAL(s->first, p->first);
+
+    const SGTexturedTriangleBin& a = s->second;
+    const SGTexturedTriangleBin& b = p->second;
+    SG_VERIFY(a.getNumTriangles() > 0);
+    SG_CHECK_EQUAL(a.getNumVertices(), b.getNumVertices());
+    SG_VERIFY(std::memcmp(a.getValues().data(), b.getValues().data(),
+                          a.getNumVertices() * sizeof(SGVertNormTex)) == 0);
+    SG_VERIFY(a.getTriangles() == b.getTriangles());
+  }
+}
+
+static void checkSamePoints(const std::vector<std::vector<SGVec3f>>& serial,
+                            const std::vector<std::vector<SGVec3f>>& parallel)
+{
+  SG_CHECK_EQUAL(serial.size(), parallel.size());
+  size_t total = 0;
+  for (size_t m = 0; m < serial.size(); ++m) {
+    SG_CHECK_EQUAL(serial[m].size(), parallel[m].size());
+    SG_VERIFY(std::memcmp(serial[m].data(), parallel[m].data(),
+                          serial[m].size() * sizeof(SGVec3f)) == 0);
+    total += serial[m].size();
+  }
+  SG_VERIFY(total > 0);
+}
+
+void test_serialMatchesParallel()
+{
+  cout << "Testing that parallel tile builds match serial ones exactly" << endl;
+
+  const SGBinObject tile = createTile();
+  SGJobPool pool(3);
+
+  SGTileGeometryBin serial, parallel;
+  SG_VERIFY(serial.insertSurfaceGeometry(tile, nullptr));
+  SG_VERIFY(parallel.insertSurfaceGeometry(tile, nullptr, &pool));
+  checkSameBins(serial, parallel);
+
+  // Random lights and trees, as generated for each material by
+  // SGTileDetailsCallback
+  std::vector<SGTexturedTriangleBin*> serialBins, parallelBins;
+  for (auto& i : serial.materialTriangleMap)
+    serialBins.push_back(&i.second);
+  for (auto& i : parallel.materialTriangleMap)
+    parallelBins.push_back(&i.second);
+
+  const size_t numMaterials = serialBins.size();
+  std::vector<std::vector<SGVec3f>> serialLights(numMaterials), parallelLights(numMaterials);
+  std::vector<std::vector<SGVec3f>> serialTrees(numMaterials), parallelTrees(numMaterials);
+  const float cosMax = std::cos(30 * SGD_DEGREES_TO_RADIANS),
+              cosZero = std::cos(45 * SGD_DEGREES_TO_RADIANS);
+
+  for (size_t m = 0; m < numMaterials; ++m) {
+    serialBins[m]->addRandomSurfacePoints(400.0f, 3, nullptr, serialLights[m]);
+    serialBins[m]->addRandomTreePoints(900.0f, nullptr, 1.0f, cosMax, cosZero,
+                                       m == 3, serialTrees[m]);
+  }
+  pool.parallelFor(numMaterials, [&](size_t m) {
+    parallelBins[m]->addRandomSurfacePoints(400.0f, 3, nullptr, parallelLights[m]);
+    parallelBins[m]->addRandomTreePoints(900.0f, nullptr, 1.0f, cosMax, cosZero,
+                                         m == 3, parallelTrees[m]);
+  });
+
+  checkSamePoints(serialLights, parallelLights);
+  checkSamePoints(serialTrees, parallelTrees);
+}
+
+int main(int argc, char* argv[])
+{
+  test_serialMatchesParallel();
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,329 @@
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+/**
+ * @file
+ * @brief Persistent on-disk cache of processed tile data
+ */
+
+#include <simgear_config.h>
+
+#include "SGTileCache.hxx"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <sstream>
+
+#if defined(SG_WINDOWS)
+#  include <process.h>
+#else
+#  include <unistd.h>
+#endif
+
+#include <simgear/debug/logstream.hxx>
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/io/sg_mmap.hxx>
+#include <simgear/misc/sg_dir.hxx>
+#include <simgear/misc/sg_hash.hxx>
+#include <simgear/misc/strutils.hxx>
+
+using namespace simgear;
+
+namespace {
+
+const char* const EntryExtension = "sgtc";
+
+const uint32_t Magic = 0x43544753;      // "SGTC" in little endian
+const uint32_t ByteOrderMark = 0x01020304;
+const uint32_t FormatVersion = 1;
+const size_t Alignment = 16;
+
+struct FileHeader {
+    uint32_t magic;
+    uint32_t byteOrder;
+    uint32_t version;
+    uint32_t numSections;
+};
+
+struct SectionHeader {
+    uint64_t offset;
+    uint64_t size;
+    uint32_t nameOffset;
+    uint32_t nameLength;
+};
+
+size_t align(size_t offset)
+{
+    return (offset + Alignment - 1) & ~(Alignment - 1);
+}
+
+std::string sha1Hex(sha1nfo& info)
+{
+    std::string hashBytes(reinterpret_cast<char*>(sha1_result(&info)), HASH_LENGTH);
+    return strutils::encodeHex(hashBytes);
+}
+
+/// Suffix of a temporary file which no other writer uses at the same time,
+/// in this or in another process sharing the cache directory
+std::string tempSuffix()
+{
+    static std::atomic<unsigned int> counter{0};
+#if defined(SG_WINDOWS)
+    const int pid = _getpid();
+#else
+    const int pid = getpid();
+#endif
+    std::ostringstream suffix;
+    suffix << "." << pid << "." << counter++ << ".tmp";
+    return suffix.str();
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+
+void
+SGTileCache::Writer::addSection(const std::string& name, const void* data, size_t size)
+{
+    _sections.push_back({name, data, size});
+}
+
+SGTileCache::Entry::Entry() = default;
+SGTileCache::Entry::~Entry() = default;
+
+const void*
+SGTileCache::Entry::getSection(const std::string& name, size_t& size) const
+{
+    auto it = _sections.find(name);
+    if (it == _sections.end())
+        return nullptr;
+
+    size = it->second.size;
+    return _file->get() + it->second.offset;
+}
+
+//------------------------------------------------------------------------------
+
+SGTileCache::SGTileCache(const SGPath& directory, uint64_t maxSize) :
+    _directory(directory),
+    _maxSize(maxSize)
+{
+    simgear::Dir dir(_directory);
+    if (!dir.exists() && !dir.create(0755)) {
+        SG_LOG(SG_TERRAIN, SG_WARN, "Can't create tile cache directory " << _directory);
+        return;
+    }
+
+    // Rebuild the LRU order from the modification times
+    struct File {
+        std::string key;
+        uint64_t size;
+        time_t modTime;
+    };
+    std::vector<File> files;
+    for (const SGPath& p : dir.children(simgear::Dir::TYPE_FILE,
+                                        std::string(".") + EntryExtension)) {
+        files.push_back({p.file_base(), p.sizeInBytes(), p.modTime()});
+    }
+    std::sort(files.begin(), files.end(), [](const File& a, const File& b) {
+        return a.modTime > b.modTime;
+    });
+
+    std::lock_guard<std::mutex> g(_lock);
+    for (const File& f : files) {
+        _items.push_back({f.key, f.size});
+        _index[f.key] = std::prev(_items.end());
+        _size += f.size;
+    }
+    evict();
+}
+
+SGTileCache::~SGTileCache() = default;
+
+//------------------------------------------------------------------------------
+
+std::string
+SGTileCache::makeKey(const SGPath& file, const std::string& config)
+{
+    // A fresh SGPath, so the file is stat()ed again
+    const SGPath p(file.realpath());
+    if (!p.isFile())
+        return {};
+
+    std::ostringstream id;
+    id << p.utf8Str() << "\n" << p.sizeInBytes() << "\n" << p.modTime() << "\n" << config;
+    const std::string s = id.str();
+
+    sha1nfo info;
+    sha1_init(&info);
+    sha1_write(&info, s.data(), s.size());
+    return sha1Hex(info);
+}
+
+//------------------------------------------------------------------------------
+
+SGPath
+SGTileCache::entryPath(const std::string& key) const
+{
+    return _directory / (key + "." + EntryExtension);
+}
+
+std::unique_ptr<SGTileCache::Entry>
+SGTileCache::find(const std::string& key)
+{
+    {
+        std::lock_guard<std::mutex> g(_lock);
+        auto it = _index.find(key);
+        if (it == _index.end())
+            return {};
+        touch(it->second);
+    }
+
+    std::unique_ptr<Entry> entry(new Entry);
+    entry->_file.reset(new SGMMapFile(entryPath(key)));
+    if (!entry->_file->open(SG_IO_IN))
+        return {};
+
+    const char* data = entry->_file->get();
+    const size_t size = entry->_file->get_size();
+
+    FileHeader header;
+    if (size < sizeof(header))
+        return {};
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != Magic || header.byteOrder != ByteOrderMark ||
+        header.version != FormatVersion ||
+        size < sizeof(header) + header.numSections * sizeof(SectionHeader)) {
+        SG_LOG(SG_TERRAIN, SG_DEBUG, "Ignoring invalid tile cache entry " << key);
+        return {};
+    }
+
+    for (uint32_t i = 0; i < header.numSections; ++i) {
+        SectionHeader section;
+        memcpy(&section, data + sizeof(header) + i * sizeof(section), sizeof(section));
+        if (section.offset > size || section.size > size - section.offset ||
+            section.nameOffset > size || section.nameLength > size - section.nameOffset)
+            return {};
+
+        entry->_sections[std::string(data + section.nameOffset, section.nameLength)] =
+            {static_cast<size_t>(section.offset), static_cast<size_t>(section.size)};
+    }
+    return entry;
+}
+
+bool
+SGTileCache::store(const std::string& key, const Writer& writer)
+{
+    // Lay out header, section table, names and (aligned) contents
+    std::vector<SectionHeader> sections(writer._sections.size());
+    size_t offset = sizeof(FileHeader) + sections.size() * sizeof(SectionHeader);
+    for (size_t i = 0; i < sections.size(); ++i) {
+        sections[i].nameOffset = static_cast<uint32_t>(offset);
+        sections[i].nameLength = static_cast<uint32_t>(writer._sections[i].name.size());
+        offset += writer._sections[i].name.size();
+    }
+    for (size_t i = 0; i < sections.size(); ++i) {
+        offset = align(offset);
+        sections[i].offset = offset;
+        sections[i].size = writer._sections[i].size;
+        offset += writer._sections[i].size;
+    }
+    const uint64_t size = offset;
+
+    // Write to a temporary file first, so readers never see partial entries
+    const SGPath path = entryPath(key);
+    SGPath tmpPath = path;
+    tmpPath.concat(tempSuffix());
+    {
+        sg_ofstream out(tmpPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+            return false;
+
+        const FileHeader header = {Magic, ByteOrderMark, FormatVersion,
+                                   static_cast<uint32_t>(sections.size())};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(sections.data()),
+                  sections.size() * sizeof(SectionHeader));
+        size_t pos = sizeof(header) + sections.size() * sizeof(SectionHeader);
+        for (const auto& section : writer._sections) {
+            out.write(section.name.data(), section.name.size());
+            pos += section.name.size();
+        }
+
+        const char padding[Alignment] = {};
+        for (size_t i = 0; i < sections.size(); ++i) {
+            out.write(padding, sections[i].offset - pos);
+            out.write(static_cast<const char*>(writer._sections[i].data),
+                      writer._sections[i].size);
+            pos = sections[i].offset + sections[i].size;
+        }
+
+        if (!out.good()) {
+            out.close();
+            tmpPath.remove();
+            SG_LOG(SG_TERRAIN, SG_WARN, "Failed to write tile cache entry " << path);
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> g(_lock);
+    auto it = _index.find(key);
+    if (it != _index.end())
+        remove(it->second);
+
+    if (!tmpPath.rename(path)) {
+        tmpPath.remove();
+        return false;
+    }
+
+    _items.push_front({key, size});
+    _index[key] = _items.begin();
+    _size += size;
+    evict();
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+uint64_t
+SGTileCache::getSize() const
+{
+    std::lock_guard<std::mutex> g(_lock);
+    return _size;
+}
+
+size_t
+SGTileCache::getNumEntries() const
+{
+    std::lock_guard<std::mutex> g(_lock);
+    return _items.size();
+}
+
+void
+SGTileCache::touch(ItemList::iterator item)
+{
+    _items.splice(_items.begin(), _items, item);
+
+    SGPath p = entryPath(item->key);
+    p.touch();
+}
+
+void
+SGTileCache::remove(ItemList::iterator item)
+{
+    // Entries which are still mapped are removed once unmapped on POSIX
+    // systems, and stay behind until the next eviction on Windows.
+    SGPath p = entryPath(item->key);
+    p.remove();
+
+    _size -= item->size;
+    _index.erase(item->key);
+    _items.erase(item);
+}
+
+void
+SGTileCache::evict()
+{
+    while (_size > _maxSize && !_items.empty())
+        remove(std::prev(_items.end()));
+}
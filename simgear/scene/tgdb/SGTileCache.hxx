@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+/**
+ * @file
+ * @brief Persistent on-disk cache of processed tile data
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <simgear/misc/sg_path.hxx>
+
+class SGMMapFile;
+
+/**
+ * Directory of cache entries, each holding the processed data of one tile
+ * (e.g. deduplicated vertex and index arrays per material) as named binary
+ * sections.
+ *
+ * An entry is a single file: a header and section table followed by the
+ * section contents, each aligned to 16 bytes. Entries are memory mapped
+ * when read, so arrays can be used in place without parsing. The format is
+ * native to the machine which wrote it; entries written with a different
+ * byte order or format version are ignored.
+ *
+ * Arrays are copied bytewise, so their elements must not hold pointers.
+ * This can't be checked with std::is_trivially_copyable, as the SGMath
+ * vector types declare their own copy constructors; only the layout is
+ * checked.
+ *
+ * Entries are evicted least recently used first once the total size of the
+ * directory exceeds the maximum size. The time of last use is kept as the
+ * file modification time, so it persists between sessions.
+ *
+ * All methods are thread safe.
+ */
+class SGTileCache
+{
+public:
+    /// Sections of an entry to be written, see store()
+    class Writer
+    {
+    public:
+        /// @a data has to stay valid until the entry has been stored
+        void addSection(const std::string& name, const void* data, size_t size);
+
+        template<typename T>
+        void addArray(const std::string& name, const std::vector<T>& values)
+        {
+            static_assert(std::is_standard_layout<T>::value,
+                          "cache sections are copied bytewise");
+            addSection(name, values.data(), values.size() * sizeof(T));
+        }
+
+        /// As above, but the writer keeps @a values until it is destroyed
+        template<typename T>
+        void addArray(const std::string& name, std::vector<T>&& values)
+        {
+            auto owned = std::make_shared<std::vector<T>>(std::move(values));
+            addArray(name, *owned);
+            _owned.push_back(owned);
+        }
+
+    private:
+        friend class SGTileCache;
+
+        struct Section {
+            std::string name;
+            const void* data;
+            size_t size;
+        };
+        std::vector<Section> _sections;
+        std::vector<std::shared_ptr<const void>> _owned;
+    };
+
+    /// A mapped cache entry
+    class Entry
+    {
+    public:
+        ~Entry();
+
+        /// @return nullptr if there is no section called @a name
+        const void* getSection(const std::string& name, size_t& size) const;
+
+        template<typename T>
+        const T* getArray(const std::string& name, size_t& count) const
+        {
+            static_assert(std::is_standard_layout<T>::value,
+                          "cache sections are copied bytewise");
+            size_t size = 0;
+            const void* data = getSection(name, size);
+            if (!data || size % sizeof(T))
+                return nullptr;
+            count = size / sizeof(T);
+            return static_cast<const T*>(data);
+        }
+
+    private:
+        friend class SGTileCache;
+        Entry();
+
+        std::unique_ptr<SGMMapFile> _file;
+        struct Location {
+            size_t offset;
+            size_t size;
+        };
+        std::map<std::string, Location> _sections;
+    };
+
+    SGTileCache(const SGPath& directory, uint64_t maxSize);
+    ~SGTileCache();
+
+    /**
+     * Key for the data derived from @a file: a hash of its path, size and
+     * modification time, so the file isn't read, combined with @a config,
+     * which should describe everything else the cached data depends on
+     * (settings, data layout). Data which may change between loads of the
+     * same file, such as material definitions, should rather be stored in
+     * the entry and checked after find().
+     *
+     * @return empty string if the file doesn't exist
+     */
+    static std::string makeKey(const SGPath& file, const std::string& config);
+
+    /// @return nullptr if there is no valid entry for @a key
+    std::unique_ptr<Entry> find(const std::string& key);
+
+    /// Write the entry for @a key, replacing any previous one
+    bool store(const std::string& key, const Writer& writer);
+
+    /// Total size of all entries in bytes
+    uint64_t getSize() const;
+    size_t getNumEntries() const;
+
+    const SGPath& getDirectory() const { return _directory; }
+
+private:
+    struct Item {
+        std::string key;
+        uint64_t size;
+    };
+    typedef std::list<Item> ItemList;
+
+    SGPath entryPath(const std::string& key) const;
+    void touch(ItemList::iterator item);
+    void remove(ItemList::iterator item);
+    void evict();
+
+    SGPath _directory;
+    uint64_t _maxSize;
+
+    mutable std::mutex _lock;
+    uint64_t _size = 0;
+    ItemList _items; ///< most recently used first
+    std::map<std::string, ItemList::iterator> _index;
+};
@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+/**
+ * @file
+ * @brief Unit tests for SGTileCache
+ */
+
+#include <simgear_config.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/math/SGMath.hxx>
+#include <simgear/misc/sg_dir.hxx>
+#include <simgear/misc/test_macros.hxx>
+
+#include "SGTileCache.hxx"
+
+using std::cout;
+using std::endl;
+
+static void writeFile(const SGPath& path, const std::string& contents)
+{
+    sg_ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    out << contents;
+}
+
+static bool storeValues(SGTileCache& cache, const std::string& key,
+                        const std::vector<uint32_t>& values)
+{
+    SGTileCache::Writer writer;
+    writer.addArray("values", values);
+    writer.addArray("name", std::vector<char>(key.begin(), key.end()));
+    return cache.store(key, writer);
+}
+
+static std::vector<uint32_t> findValues(SGTileCache& cache, const std::string& key)
+{
+    auto entry = cache.find(key);
+    if (!entry)
+        return {};
+
+    size_t count = 0;
+    const uint32_t* values = entry->getArray<uint32_t>("values", count);
+    if (!values)
+        return {};
+    return std::vector<uint32_t>(values, values + count);
+}
+
+void test_hitAndMiss()
+{
+    cout << "Testing hits and misses of the tile cache" << endl;
+
+    simgear::Dir dir = simgear::Dir::tempDir("tile_cache_test");
+    dir.setRemoveOnDestroy();
+    const std::vector<uint32_t> values = {1, 2, 3, 0xdeadbeef};
+
+    {
+        SGTileCache cache(dir.file("cache"), 1024 * 1024);
+        SG_VERIFY(!cache.find("a"));
+        SG_VERIFY(storeValues(cache, "a", values));
+        SG_VERIFY(findValues(cache, "a") == values);
+        SG_VERIFY(!cache.find("b"));
+        SG_CHECK_EQUAL(cache.getNumEntries(), 1u);
+
+        // Sections are aligned, and missing ones are reported as such
+        auto entry = cache.find("a");
+        size_t size = 0;
+        const void* data = entry->getSection("values", size);
+        SG_CHECK_EQUAL(size, values.size() * sizeof(uint32_t));
+        SG_CHECK_EQUAL(reinterpret_cast<uintptr_t>(data) % 16, 0u);
+        SG_VERIFY(!entry->getSection("missing", size));
+        SG_VERIFY(!entry->getArray<SGVec3d>("values", size));
+    }
+
+    // Entries persist between sessions
+    SGTileCache cache(dir.file("cache"), 1024 * 1024);
+    SG_CHECK_EQUAL(cache.getNumEntries(), 1u);
+    SG_VERIFY(findValues(cache, "a") == values);
+
+    // Entries which are not valid are ignored
+    writeFile(dir.file("cache") / "b.sgtc", "not a cache entry");
+    SGTileCache reopened(dir.file("cache"), 1024 * 1024);
+    SG_CHECK_EQUAL(reopened.getNumEntries(), 2u);
+    SG_VERIFY(!reopened.find("b"));
+    SG_VERIFY(findValues(reopened, "a") == values);
+}
+
+void test_key()
+{
+    cout << "Testing invalidation of tile cache keys" << endl;
+
+    simgear::Dir dir = simgear::Dir::tempDir("tile_cache_test");
+    dir.setRemoveOnDestroy();
+    const SGPath file = dir.file("tile.btg.gz");
+
+    SG_VERIFY(SGTileCache::makeKey(file, "config").empty());
+    writeFile(file, "tile contents");
+    const std::string key = SGTileCache::makeKey(file, "config");
+    SG_VERIFY(!key.empty());
+    SG_CHECK_EQUAL(SGTileCache::makeKey(file, "config"), key);
+    SG_VERIFY(SGTileCache::makeKey(file, "other config") != key);
+    SG_VERIFY(SGTileCache::makeKey(dir.file("other.btg.gz"), "config").empty());
+
+    // The file is changed in size, or only in its modification time
+    writeFile(file, "new tile contents");
+    const std::string resized = SGTileCache::makeKey(file, "config");
+    SG_VERIFY(!resized.empty() && resized != key);
+
+    namespace fs = std::filesystem;
+    const fs::path native = file.toStdPath();
+    fs::last_write_time(native, fs::last_write_time(native) + std::chrono::seconds(10));
+    const std::string touched = SGTileCache::makeKey(file, "config");
+    SG_VERIFY(!touched.empty() && touched != resized && touched != key);
+
+    // A cached entry of the old file is not found any more
+    SGTileCache cache(dir.file("cache"), 1024 * 1024);
+    SG_VERIFY(storeValues(cache, resized, {1, 2, 3}));
+    SG_VERIFY(!cache.find(touched));
+    SG_VERIFY(cache.find(resized));
+}
+
+void test_eviction()
+{
+    cout << "Testing eviction of tile cache entries" << endl;
+
+    simgear::Dir dir = simgear::Dir::tempDir("tile_cache_test");
+    dir.setRemoveOnDestroy();
+    const std::vector<uint32_t> values(1000, 42);
+
+    SGTileCache cache(dir.file("cache"), 10000);
+    SG_VERIFY(storeValues(cache, "a", values));
+    const uint64_t entrySize = cache.getSize();
+    SG_VERIFY(entrySize > values.size() * sizeof(uint32_t));
+
+    SG_VERIFY(storeValues(cache, "b", values));
+    SG_VERIFY(cache.find("a"));
+    SG_CHECK_EQUAL(cache.getNumEntries(), 2u);
+
+    // "b" is the least recently used one
+    SG_VERIFY(storeValues(cache, "c", values));
+    SG_CHECK_EQUAL(cache.getNumEntries(), 2u);
+    SG_VERIFY(cache.getSize() <= 10000u);
+    SG_VERIFY(!cache.find("b"));
+    SG_VERIFY(findValues(cache, "a") == values);
+    SG_VERIFY(findValues(cache, "c") == values);
+
+    // Replacing an entry doesn't count twice
+    SG_VERIFY(storeValues(cache, "c", values));
+    SG_CHECK_EQUAL(cache.getSize(), 2 * entrySize);
+
+    // Reopening with a smaller limit evicts entries
+    SGTileCache smaller(dir.file("cache"), entrySize);
+    SG_CHECK_EQUAL(smaller.getNumEntries(), 1u);
+}
+
+int main(int argc, char* argv[])
+{
+    test_hitAndMiss();
+    test_key();
+    test_eviction();
+
+    return EXIT_SUCCESS;
+}
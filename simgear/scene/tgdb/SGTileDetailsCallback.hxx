@@ -34,8 +34,10 @@
 #include <simgear/scene/util/OptionsReadFileCallback.hxx>
 #include <simgear/scene/util/SGNodeMasks.hxx>
 #include <simgear/debug/ErrorReportingCallback.hxx>
+#include <simgear/threads/SGJobPool.hxx>
 
 #include "SGNodeTriangles.hxx"
+#include "SGTileBuildPool.hxx"
 #include "SGLightBin.hxx"
 #include "SGDirectionalLightBin.hxx"
 #include "SGModelBin.hxx"
@@ -629,6 +631,23 @@ public:
         }
     }
     
+    // Run func for each material, on the tile build pool if there is one
+    template<typename Func>
+    void forEachMaterial(size_t count, const Func& func)
+    {
+        SGJobPool* pool = getTileBuildPool(_options.get());
+        if (pool) {
+            pool->parallelFor(count, func);
+        } else {
+            for (size_t i = 0; i < count; ++i)
+                func(i);
+        }
+    }
+
+    // Random tree points are generated for each material as a separate task
+    // if parallel tile building is enabled. Every SGTriangleInfo has its own
+    // seed, and the points are added to the tree bins in material order, so
+    // the forest is the same either way.
     void computeRandomForest(std::vector<SGTriangleInfo>& matTris, float vegetation_density, SGTreeBinList& randomForest)
     {        
         unsigned int i;
@@ -637,6 +656,8 @@ public:
         mt seed;
         mt_init(&seed, unsigned(586));
         
+        std::vector<SGMaterial*> mats(matTris.size(), nullptr);
+        std::vector<osg::Texture2D*> objectMasks(matTris.size(), nullptr);
         for ( i=0; i<matTris.size(); i++ ) {
             SGMaterial *mat = matTris[i].getMaterial();
             if (!mat)
@@ -645,6 +666,30 @@ public:
             float wood_coverage = mat->get_wood_coverage();
             if ((wood_coverage <= 0) || (vegetation_density <= 0))
                 continue;
+
+            mats[i] = mat;
+            objectMasks[i] = mat->get_one_object_mask(matTris[i].getTextureIndex());
+        }
+
+        std::vector<std::vector<SGVec3f> > randomPoints(matTris.size());
+        forEachMaterial(matTris.size(), [&](size_t m) {
+            SGMaterial *mat = mats[m];
+            if (!mat)
+                return;
+
+            matTris[m].addRandomTreePoints(mat->get_wood_coverage(),
+                                           objectMasks[m],
+                                           vegetation_density,
+                                           mat->get_cos_tree_max_density_slope_angle(),
+                                           mat->get_cos_tree_zero_density_slope_angle(),
+                                           mat->get_is_plantation(),
+                                           randomPoints[m]);
+        });
+
+        for ( i=0; i<matTris.size(); i++ ) {
+            SGMaterial *mat = mats[i];
+            if (!mat)
+                continue;
             
             // Attributes that don't vary by tree but do vary by material
             bool found = false;
@@ -677,17 +722,8 @@ public:
                 randomForest.push_back(bin);
             }
             
-            std::vector<SGVec3f> randomPoints;
-            matTris[i].addRandomTreePoints(wood_coverage,
-                                           mat->get_one_object_mask(matTris[i].getTextureIndex()),
-                                           vegetation_density,
-                                           mat->get_cos_tree_max_density_slope_angle(),
-                                           mat->get_cos_tree_zero_density_slope_angle(),
-                                           mat->get_is_plantation(),
-                                           randomPoints);
-
             std::vector<SGVec3f>::iterator k;
-            for (k = randomPoints.begin(); k != randomPoints.end(); ++k) {
+            for (k = randomPoints[i].begin(); k != randomPoints[i].end(); ++k) {
                 bin->insert(*k);
             }
         }
@@ -710,21 +746,32 @@ public:
         mt seed;
         mt_init(&seed, unsigned(123));
 
+        std::vector<float> coverages(matTris.size(), 0.0f);
+        std::vector<osg::Texture2D*> objectMasks(matTris.size(), nullptr);
         for ( i=0; i<matTris.size(); i++ ) {
             SGMaterial *mat = matTris[i].getMaterial();
             if (!mat)
                 continue;
             
-            float coverage = mat->get_light_coverage();
-            if (coverage <= 0)
+            coverages[i] = mat->get_light_coverage();
+            if (coverages[i] <= 0)
                 continue;
                         
             int texIndex = matTris[i].getTextureIndex();
-            
-            std::vector<SGVec3f> randomPoints;
-            matTris[i].addRandomSurfacePoints(coverage, 3, mat->get_one_object_mask(texIndex), randomPoints);
+            objectMasks[i] = mat->get_one_object_mask(texIndex);
+        }
+
+        // The points of each material only depend on its own seed, the
+        // colours are drawn from the tile seed below in material order.
+        std::vector<std::vector<SGVec3f> > randomPoints(matTris.size());
+        forEachMaterial(matTris.size(), [&](size_t m) {
+            if (coverages[m] > 0)
+                matTris[m].addRandomSurfacePoints(coverages[m], 3, objectMasks[m], randomPoints[m]);
+        });
+
+        for ( i=0; i<matTris.size(); i++ ) {
             std::vector<SGVec3f>::iterator j;
-            for (j = randomPoints.begin(); j != randomPoints.end(); ++j) {
+            for (j = randomPoints[i].begin(); j != randomPoints[i].end(); ++j) {
                 float zombie = mt_rand(&seed);
                 // factor = sg_random() ^ 2, range = 0 .. 1 concentrated towards 0
                 float factor = mt_rand(&seed);
@@ -1,13 +1,23 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <set>
+#include <sstream>
+
 #include "obj.hxx"
 
+#include <simgear/io/sg_binobj.hxx>
 #include <simgear/scene/material/EffectGeode.hxx>
 #include <simgear/scene/material/matlib.hxx>
 #include <simgear/scene/material/mat.hxx>
+#include <simgear/threads/SGJobPool.hxx>
 
 #include "SGTexturedTriangleBin.hxx"
+#include "SGTileCache.hxx"
 
 using namespace simgear;
 
@@ -36,7 +46,7 @@ public:
       return mult(texCoords[tc[i]], tcScale);
   }
 
-  SGVec2f getTexCoordScale(const std::string& name, SGMaterialCache* matcache)
+  static SGVec2f getTexCoordScale(const std::string& name, SGMaterialCache* matcache)
   {
     if (!matcache)
       return SGVec2f(1, 1);
@@ -224,9 +234,16 @@ public:
     }
   }
 
+  // If a job pool is given, the groups of each material are added to its
+  // triangle bin as a separate task. Within a material the groups are still
+  // added in file order, so the bins are identical to the serial result.
   bool
-  insertSurfaceGeometry(const SGBinObject& obj, SGMaterialCache* matcache)
+  insertSurfaceGeometry(const SGBinObject& obj, SGMaterialCache* matcache,
+                        SGJobPool* pool = nullptr)
   {
+    if (pool)
+      return insertSurfaceGeometryParallel(obj, matcache, *pool);
+
     if (obj.get_tris_n().size() < obj.get_tris_v().size() ||
         obj.get_tris_tcs().size() < obj.get_tris_v().size()) {
       SG_LOG(SG_TERRAIN, SG_ALERT,
@@ -272,6 +289,238 @@ public:
     return true;
   }
 
+  bool
+  insertSurfaceGeometryParallel(const SGBinObject& obj, SGMaterialCache* matcache,
+                                SGJobPool& pool)
+  {
+    if (obj.get_tris_n().size() < obj.get_tris_v().size() ||
+        obj.get_tris_tcs().size() < obj.get_tris_v().size()) {
+      SG_LOG(SG_TERRAIN, SG_ALERT,
+             "Group list sizes for triangles do not match!");
+      return false;
+    }
+    if (obj.get_strips_n().size() < obj.get_strips_v().size() ||
+        obj.get_strips_tcs().size() < obj.get_strips_v().size()) {
+      SG_LOG(SG_TERRAIN, SG_ALERT,
+             "Group list sizes for strips do not match!");
+      return false;
+    }
+    if (obj.get_fans_n().size() < obj.get_fans_v().size() ||
+        obj.get_fans_tcs().size() < obj.get_fans_v().size()) {
+      SG_LOG(SG_TERRAIN, SG_ALERT,
+             "Group list sizes for fans do not match!");
+      return false;
+    }
+
+    typedef void (*AddGeometry)(SGTexturedTriangleBin&, const SGBinObject&,
+                                unsigned, const SGVec2f&, const SGVec2f&);
+
+    // All groups using one material, in the order of the serial path
+    struct MaterialGroups {
+      SGTexturedTriangleBin* triangles;
+      SGVec2f tc0Scale;
+      std::vector<std::pair<AddGeometry, unsigned> > groups;
+    };
+
+    // The map and the material cache are only accessed from this thread.
+    std::vector<MaterialGroups> materials;
+    std::map<std::string, size_t> materialIndex;
+    auto addGroups = [&](const string_list& names, size_t numGroups, AddGeometry add) {
+      for (unsigned grp = 0; grp < numGroups; ++grp) {
+        const std::string& materialName = names[grp];
+        auto i = materialIndex.find(materialName);
+        if (i == materialIndex.end()) {
+          i = materialIndex.emplace(materialName, materials.size()).first;
+          materials.push_back({&materialTriangleMap[materialName],
+                               getTexCoordScale(materialName, matcache), {}});
+        }
+        materials[i->second].groups.emplace_back(add, grp);
+      }
+    };
+    addGroups(obj.get_tri_materials(), obj.get_tris_v().size(), &addTriangleGeometry);
+    addGroups(obj.get_strip_materials(), obj.get_strips_v().size(), &addStripGeometry);
+    addGroups(obj.get_fan_materials(), obj.get_fans_v().size(), &addFanGeometry);
+
+    pool.parallelFor(materials.size(), [&](size_t m) {
+      const MaterialGroups& material = materials[m];
+      for (const auto& group : material.groups) {
+        group.first(*material.triangles, obj, group.second,
+                    material.tc0Scale, SGVec2f(1.0, 1.0));
+      }
+    });
+    return true;
+  }
+
+  // Layout of the cached arrays, for the key of the cache entries
+  static std::string getCacheLayout()
+  {
+    std::ostringstream layout;
+    layout << "SGVertNormTex " << sizeof(SGVertNormTex) << "\n"
+           << "SGVec3d " << sizeof(SGVec3d) << "\n"
+           << "SGVec3f " << sizeof(SGVec3f) << "\n";
+    return layout.str();
+  }
+
+  // Everything apart from the BTG file the surface geometry depends on: the
+  // texture coordinate scale of each material, which comes from the
+  // (regional) material definitions.
+  static std::string
+  getCacheConfig(const std::set<std::string>& names, SGMaterialCache* matcache)
+  {
+    std::ostringstream config;
+    config << std::setprecision(std::numeric_limits<float>::max_digits10);
+    for (const std::string& name : names) {
+      SGVec2f scale = getTexCoordScale(name, matcache);
+      config << name << " " << scale.x() << " " << scale.y() << "\n";
+    }
+    return config.str();
+  }
+
+  // Add everything SGLoadBTG needs from the tile to a cache entry: the
+  // deduplicated vertices and triangles of all materials, the center, the
+  // light points and the material configuration the triangles were built
+  // with. The vertex arrays are referenced, so this bin has to outlive the
+  // writer.
+  //
+  // Random lights, vegetation and buildings are not cached. They are
+  // generated from the restored bins once the tile details are paged in.
+  void writeCache(SGTileCache::Writer& writer, const SGBinObject& obj,
+                  SGMaterialCache* matcache) const
+  {
+    std::set<std::string> materials;
+    std::string names;
+    unsigned m = 0;
+    for (const auto& i : materialTriangleMap) {
+      const SGTexturedTriangleBin& triangles = i.second;
+      materials.insert(i.first);
+      names += i.first;
+      names += '\0';
+
+      std::vector<uint32_t> indices;
+      indices.reserve(3 * triangles.getNumTriangles());
+      for (const auto& t : triangles.getTriangles()) {
+        indices.push_back(uint32_t(t[0]));
+        indices.push_back(uint32_t(t[1]));
+        indices.push_back(uint32_t(t[2]));
+      }
+
+      const std::string prefix = "material" + std::to_string(m++) + ".";
+      writer.addArray(prefix + "vertices", triangles.getValues());
+      writer.addArray(prefix + "triangles", std::move(indices));
+      writer.addArray(prefix + "flags",
+                      std::vector<uint32_t>(1, triangles.hasSecondaryTexCoord()));
+    }
+    writer.addArray("materials", std::vector<char>(names.begin(), names.end()));
+
+    const std::string config = getCacheConfig(materials, matcache);
+    writer.addArray("config", std::vector<char>(config.begin(), config.end()));
+    writer.addArray("center", std::vector<SGVec3d>(1, obj.get_gbs_center()));
+
+    // The points with their own copy of the vertices and normals they use
+    std::string pointNames;
+    std::vector<uint32_t> counts;
+    std::vector<SGVec3d> vertices;
+    std::vector<SGVec3f> normals;
+    const bool validPoints = obj.get_pts_v().size() == obj.get_pts_n().size();
+    for (unsigned grp = 0; validPoints && grp < obj.get_pts_v().size(); ++grp) {
+      pointNames += obj.get_pt_materials()[grp];
+      pointNames += '\0';
+      const std::vector<int>& pts_v = obj.get_pts_v()[grp];
+      const std::vector<int>& pts_n = obj.get_pts_n()[grp];
+      counts.push_back(uint32_t(pts_v.size()));
+      counts.push_back(uint32_t(pts_n.size()));
+      for (int i : pts_v)
+        vertices.push_back(obj.get_wgs84_nodes()[i]);
+      for (int i : pts_n)
+        normals.push_back(obj.get_normals()[i]);
+    }
+    writer.addArray("points.materials",
+                    std::vector<char>(pointNames.begin(), pointNames.end()));
+    writer.addArray("points.counts", std::move(counts));
+    writer.addArray("points.vertices", std::move(vertices));
+    writer.addArray("points.normals", std::move(normals));
+  }
+
+  // Restore the center and the light points written by writeCache() into
+  // the otherwise empty @a obj, so the BTG file needn't be read.
+  static bool readCachedPoints(const SGTileCache::Entry& entry, SGBinObject& obj)
+  {
+    size_t numCenters = 0, size = 0, numCounts = 0, numVertices = 0, numNormals = 0;
+    const SGVec3d* center = entry.getArray<SGVec3d>("center", numCenters);
+    const char* names = entry.getArray<char>("points.materials", size);
+    const uint32_t* counts = entry.getArray<uint32_t>("points.counts", numCounts);
+    const SGVec3d* vertices = entry.getArray<SGVec3d>("points.vertices", numVertices);
+    const SGVec3f* normals = entry.getArray<SGVec3f>("points.normals", numNormals);
+    if (!center || numCenters != 1 || !names || !counts || !vertices || !normals)
+      return false;
+
+    obj.set_gbs_center(center[0]);
+    obj.set_wgs84_nodes(std::vector<SGVec3d>(vertices, vertices + numVertices));
+    obj.set_normals(std::vector<SGVec3f>(normals, normals + numNormals));
+
+    size_t v = 0, n = 0, c = 0;
+    for (const char* name = names; name < names + size; name += strlen(name) + 1) {
+      if (!memchr(name, '\0', names + size - name) || c + 2 > numCounts ||
+          counts[c] > numVertices - v || counts[c + 1] > numNormals - n)
+        return false;
+
+      SGBinObjectPoint point;
+      point.material = name;
+      for (uint32_t i = 0; i < counts[c]; ++i)
+        point.v_list.push_back(int(v++));
+      for (uint32_t i = 0; i < counts[c + 1]; ++i)
+        point.n_list.push_back(int(n++));
+      c += 2;
+      obj.add_point(point);
+    }
+    return c == numCounts;
+  }
+
+  // Restore the bins written by writeCache(), if the materials are still
+  // configured the same way. Returns false, leaving this bin empty,
+  // otherwise or if the entry is incomplete.
+  bool readCache(const SGTileCache::Entry& entry, SGMaterialCache* matcache)
+  {
+    materialTriangleMap.clear();
+
+    size_t size = 0, configSize = 0;
+    const char* names = entry.getArray<char>("materials", size);
+    const char* config = entry.getArray<char>("config", configSize);
+    if (!names || !config)
+      return false;
+
+    std::set<std::string> materials;
+    unsigned m = 0;
+    for (const char* name = names; name < names + size; name += strlen(name) + 1) {
+      if (!memchr(name, '\0', names + size - name))
+        break;
+
+      const std::string prefix = "material" + std::to_string(m++) + ".";
+      size_t numVertices = 0, numIndices = 0, numFlags = 0;
+      const SGVertNormTex* vertices =
+        entry.getArray<SGVertNormTex>(prefix + "vertices", numVertices);
+      const uint32_t* indices = entry.getArray<uint32_t>(prefix + "triangles", numIndices);
+      const uint32_t* flags = entry.getArray<uint32_t>(prefix + "flags", numFlags);
+      if (!vertices || !indices || !flags || numFlags != 1 || numIndices % 3 ||
+          std::any_of(indices, indices + numIndices,
+                      [&](uint32_t i) { return i >= numVertices; })) {
+        materialTriangleMap.clear();
+        return false;
+      }
+
+      materials.insert(name);
+      SGTexturedTriangleBin& triangles = materialTriangleMap[name];
+      triangles.assign(vertices, numVertices, indices, numIndices / 3);
+      triangles.hasSecondaryTexCoord(flags[0] != 0);
+    }
+
+    if (getCacheConfig(materials, matcache) != std::string(config, configSize)) {
+      materialTriangleMap.clear();
+      return false;
+    }
+    return true;
+  }
+
   vsg::ref_ptr<vsg::Node> getSurfaceGeometry(SGMaterialCache* matcache) const
   {
     if (materialTriangleMap.empty())
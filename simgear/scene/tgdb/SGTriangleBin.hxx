@@ -21,34 +21,30 @@
 
 #pragma once
 
+#include <cstdint>
+#include <list>
 #include <vector>
-#include <map>
+
+#include <simgear/math/SGMath.hxx>
+
 #include "SGVertexArrayBin.hxx"
 
 template<typename T>
 class SGTriangleBin : public SGVertexArrayBin<T> {
 public:
-#define BUILD_EDGE_MAP
   typedef typename SGVertexArrayBin<T>::value_type value_type;
   typedef typename SGVertexArrayBin<T>::index_type index_type;
   typedef SGVec2<index_type> edge_ref;
   typedef SGVec3<index_type> triangle_ref;
   typedef std::vector<triangle_ref> TriangleVector;
   typedef std::vector<index_type> TriangleList;
-  typedef std::map<edge_ref,TriangleList> EdgeMap;
 
   void insert(const value_type& v0, const value_type& v1, const value_type& v2)
   {
     index_type i0 = SGVertexArrayBin<T>::insert(v0);
     index_type i1 = SGVertexArrayBin<T>::insert(v1);
     index_type i2 = SGVertexArrayBin<T>::insert(v2);
-    index_type triangleIndex = _triangleVector.size();
     _triangleVector.push_back(triangle_ref(i0, i1, i2));
-#ifdef BUILD_EDGE_MAP
-    _edgeMap[edge_ref(i0, i1)].push_back(triangleIndex);
-    _edgeMap[edge_ref(i1, i2)].push_back(triangleIndex);
-    _edgeMap[edge_ref(i2, i0)].push_back(triangleIndex);
-#endif
   }
 
   unsigned getNumTriangles() const
@@ -58,10 +54,21 @@ public:
   const TriangleVector& getTriangles() const
   { return _triangleVector; }
 
-#ifdef BUILD_EDGE_MAP
+  /// Replace the contents by unique vertices and @a numTriangles index
+  /// triples into them, as previously built by insert().
+  void assign(const value_type* vertices, index_type numVertices,
+              const uint32_t* indices, index_type numTriangles)
+  {
+    SGVertexArrayBin<T>::assign(vertices, numVertices);
+    _triangleVector.resize(numTriangles);
+    for (index_type i = 0; i < numTriangles; ++i)
+      _triangleVector[i] = triangle_ref(indices[3*i], indices[3*i + 1], indices[3*i + 2]);
+  }
+
 // protected: //FIXME
   void getConnectedSets(std::list<TriangleVector>& connectSets) const
   {
+    EdgeAdjacency edges(*this);
     std::vector<bool> processedTriangles(getNumTriangles(), false);
     for (index_type i = 0; i < getNumTriangles(); ++i) {
       if (processedTriangles[i])
@@ -82,18 +89,16 @@ public:
       while (!edgeStack.empty()) {
         edge_ref edge = edgeStack.back();
         edgeStack.pop_back();
-        
-        typename EdgeMap::const_iterator emiList[2] = {
-          _edgeMap.find(edge),
-          _edgeMap.find(edge_ref(edge[1], edge[0]))
-        };
+
+        const edge_ref edgeList[2] = { edge, edge_ref(edge[1], edge[0]) };
         for (unsigned ei = 0; ei < 2; ++ei) {
-          typename EdgeMap::const_iterator emi = emiList[ei];
-          if (emi == _edgeMap.end())
-            continue;
+          const index_type from = edgeList[ei][0];
+          const index_type to = edgeList[ei][1];
+          for (index_type e = edges.begin(from); e != edges.end(from); ++e) {
+            if (edges.to[e] != to)
+              continue;
 
-          for (unsigned ti = 0; ti < emi->second.size(); ++ti) {
-            index_type triangleIndex = emi->second[ti];
+            index_type triangleIndex = edges.triangle[e];
             if (processedTriangles[triangleIndex])
               continue;
 
@@ -110,11 +115,49 @@ public:
       connectSets.push_back(currentSet);
     }
   }
-#endif
 
 private:
+  /**
+   * Directed edges of all triangles in compressed sparse row layout: the
+   * edges starting at vertex v are stored at [offset[v], offset[v + 1]),
+   * ordered by triangle index.
+   */
+  struct EdgeAdjacency {
+    std::vector<index_type> offset;
+    std::vector<index_type> to;
+    std::vector<index_type> triangle;
+
+    explicit EdgeAdjacency(const SGTriangleBin& bin)
+    {
+      const index_type numVertices = bin.getNumVertices();
+      const index_type numEdges = 3 * bin._triangleVector.size();
+
+      // Count the edges per start vertex, and turn that into offsets
+      offset.assign(numVertices + 1, 0);
+      for (const triangle_ref& t : bin._triangleVector) {
+        ++offset[t[0] + 1];
+        ++offset[t[1] + 1];
+        ++offset[t[2] + 1];
+      }
+      for (index_type v = 0; v < numVertices; ++v)
+        offset[v + 1] += offset[v];
+
+      to.resize(numEdges);
+      triangle.resize(numEdges);
+      std::vector<index_type> fill(offset.begin(), offset.end() - 1);
+      for (index_type i = 0; i < bin._triangleVector.size(); ++i) {
+        const triangle_ref& t = bin._triangleVector[i];
+        for (unsigned k = 0; k < 3; ++k) {
+          index_type e = fill[t[k]]++;
+          to[e] = t[(k + 1) % 3];
+          triangle[e] = i;
+        }
+      }
+    }
+
+    index_type begin(index_type v) const { return offset[v]; }
+    index_type end(index_type v) const { return offset[v + 1]; }
+  };
+
   TriangleVector _triangleVector;
-#ifdef BUILD_EDGE_MAP
-  EdgeMap _edgeMap;
-#endif
 };
@@ -0,0 +1,289 @@
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+/**
+ * @file
+ * @brief Unit tests for SGVertNormTex ordering and the hash/CSR based
+ *        SGVertexArrayBin and SGTriangleBin
+ */
+
+#include <simgear_config.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <map>
+#include <vector>
+
+#include <simgear/misc/test_macros.hxx>
+
+#include "SGTriangleBin.hxx"
+#include "SGVertNormTex.hxx"
+
+using std::cout;
+using std::endl;
+
+/**
+ * Reference with std::map based vertex deduplication and edge map, as
+ * SGVertexArrayBin and SGTriangleBin were implemented before.
+ */
+class MapTriangleBin {
+public:
+  typedef size_t index_type;
+  typedef SGVec2<index_type> edge_ref;
+  typedef SGVec3<index_type> triangle_ref;
+  typedef std::vector<triangle_ref> TriangleVector;
+
+  index_type insertVertex(const SGVertNormTex& t)
+  {
+    auto i = _valueMap.find(t);
+    if (i != _valueMap.end())
+      return i->second;
+
+    index_type index = _values.size();
+    _valueMap[t] = index;
+    _values.push_back(t);
+    return index;
+  }
+
+  void insert(const SGVertNormTex& v0, const SGVertNormTex& v1, const SGVertNormTex& v2)
+  {
+    index_type i0 = insertVertex(v0);
+    index_type i1 = insertVertex(v1);
+    index_type i2 = insertVertex(v2);
+    index_type triangleIndex = _triangleVector.size();
+    _triangleVector.push_back(triangle_ref(i0, i1, i2));
+    _edgeMap[edge_ref(i0, i1)].push_back(triangleIndex);
+    _edgeMap[edge_ref(i1, i2)].push_back(triangleIndex);
+    _edgeMap[edge_ref(i2, i0)].push_back(triangleIndex);
+  }
+
+  void getConnectedSets(std::list<TriangleVector>& connectSets) const
+  {
+    std::vector<bool> processedTriangles(_triangleVector.size(), false);
+    for (index_type i = 0; i < _triangleVector.size(); ++i) {
+      if (processedTriangles[i])
+        continue;
+
+      TriangleVector currentSet;
+      std::vector<edge_ref> edgeStack;
+      triangle_ref triangleRef = _triangleVector[i];
+      edgeStack.push_back(edge_ref(triangleRef[0], triangleRef[1]));
+      edgeStack.push_back(edge_ref(triangleRef[1], triangleRef[2]));
+      edgeStack.push_back(edge_ref(triangleRef[2], triangleRef[0]));
+      currentSet.push_back(triangleRef);
+      processedTriangles[i] = true;
+
+      while (!edgeStack.empty()) {
+        edge_ref edge = edgeStack.back();
+        edgeStack.pop_back();
+
+        auto emiList = { _edgeMap.find(edge),
+                         _edgeMap.find(edge_ref(edge[1], edge[0])) };
+        for (auto emi : emiList) {
+          if (emi == _edgeMap.end())
+            continue;
+
+          for (index_type triangleIndex : emi->second) {
+            if (processedTriangles[triangleIndex])
+              continue;
+
+            triangle_ref t = _triangleVector[triangleIndex];
+            edgeStack.push_back(edge_ref(t[0], t[1]));
+            edgeStack.push_back(edge_ref(t[1], t[2]));
+            edgeStack.push_back(edge_ref(t[2], t[0]));
+            currentSet.push_back(t);
+            processedTriangles[triangleIndex] = true;
+          }
+        }
+      }
+
+      connectSets.push_back(currentSet);
+    }
+  }
+
+  const std::vector<SGVertNormTex>& getValues() const { return _values; }
+  const TriangleVector& getTriangles() const { return _triangleVector; }
+
+private:
+  std::vector<SGVertNormTex> _values;
+  std::map<SGVertNormTex, index_type, SGVertNormTex::less> _valueMap;
+  TriangleVector _triangleVector;
+  std::map<edge_ref, std::vector<index_type>> _edgeMap;
+};
+
+static SGVertNormTex vertex(float x, float y, float z, unsigned mask = 0,
+                            float s = 0, float t = 0)
+{
+  SGVertNormTex v;
+  v.SetVertex(SGVec3f(x, y, z));
+  v.SetNormal(SGVec3f(0, 0, 1));
+  for (unsigned i = 0; i < 4; ++i) {
+    if (mask & (1 << i))
+      v.SetTexCoord(i, SGVec2f(s + i, t));
+  }
+  return v;
+}
+
+static bool equivalent(const SGVertNormTex& l, const SGVertNormTex& r)
+{
+  SGVertNormTex::less less;
+  return !less(l, r) && !less(r, l);
+}
+
+void test_ordering()
+{
+  cout << "Testing SGVertNormTex::less is a strict weak ordering" << endl;
+
+  // Same position and normal, differing in the texture coordinates present
+  std::vector<SGVertNormTex> values = {
+    vertex(1, 2, 3),
+    vertex(1, 2, 3, 1, 0.5f, 0.25f),
+    vertex(1, 2, 3, 1, 0.75f, 0.25f),
+    vertex(1, 2, 3, 3, 0.5f, 0.25f),
+    vertex(1, 2, 3, 2, 0.5f, 0.25f),
+    vertex(1, 2, 3, 15, 0.5f, 0.25f),
+    vertex(1, 2, 3, 15, 0.5f, 0.5f),
+    vertex(1, 2, 3, 1, 0.5f, 0.25f),
+    vertex(1, 2, 4, 1, 0.5f, 0.25f),
+    vertex(-0.0f, 2, 3),
+    vertex(0.0f, 2, 3),
+  };
+
+  SGVertNormTex::less less;
+  SGVertNormTex::hash hash;
+  for (const auto& a : values) {
+    SG_VERIFY(!less(a, a));
+    for (const auto& b : values) {
+      SG_VERIFY(!(less(a, b) && less(b, a)));
+      if (equivalent(a, b)) {
+        SG_CHECK_EQUAL(hash(a), hash(b));
+      }
+      for (const auto& c : values) {
+        if (less(a, b) && less(b, c)) {
+          SG_VERIFY(less(a, c));
+        }
+        if (equivalent(a, b) && equivalent(b, c)) {
+          SG_VERIFY(equivalent(a, c));
+        }
+      }
+    }
+  }
+
+  // A vertex with a texture coordinate is not merged into one without
+  SG_VERIFY(!equivalent(values[0], values[1]));
+  SG_VERIFY(!equivalent(values[1], values[3]));
+  SG_VERIFY(!equivalent(values[5], values[6]));
+  SG_VERIFY(equivalent(values[1], values[7]));
+  SG_VERIFY(equivalent(values[9], values[10]));
+}
+
+/// Patches of terrain mesh with texture seams, duplicate and reversed
+/// triangles and isolated triangles
+static std::vector<SGVertNormTex> createTriangles()
+{
+  std::vector<SGVertNormTex> triangles;
+  auto add = [&](const SGVertNormTex& a, const SGVertNormTex& b, const SGVertNormTex& c) {
+    triangles.push_back(a);
+    triangles.push_back(b);
+    triangles.push_back(c);
+  };
+
+  for (int p = 0; p < 3; ++p) {
+    auto v = [p](int x, int y) {
+      // texture coordinates wrap every 4 cells, giving seams where the
+      // same position has two texture coordinates
+      return vertex(p * 1000.0f + x, float(y), float((x * y) % 3),
+                    1, float(x % 4), float(y));
+    };
+    for (int y = 0; y < 6; ++y) {
+      for (int x = 0; x < 6; ++x) {
+        add(v(x, y), v(x + 1, y), v(x + 1, y + 1));
+        add(v(x, y), v(x + 1, y + 1), v(x, y + 1));
+      }
+    }
+    add(v(0, 0), v(1, 1), v(1, 0));
+    add(v(2, 2), v(3, 2), v(3, 3));
+  }
+
+  for (int i = 0; i < 4; ++i) {
+    add(vertex(-10.0f * i, 0, 0), vertex(-10.0f * i, 1, 0), vertex(-10.0f * i - 1, 0, 0));
+  }
+  add(vertex(-0.0f, -5, 0), vertex(1, -5, 0), vertex(0.0f, -6, 0));
+  return triangles;
+}
+
+void test_matchesMapBin()
+{
+  cout << "Testing SGTriangleBin against the std::map based bins" << endl;
+
+  const std::vector<SGVertNormTex> triangles = createTriangles();
+
+  MapTriangleBin mapBin;
+  SGTriangleBin<SGVertNormTex> bin;
+  for (size_t i = 0; i + 2 < triangles.size(); i += 3) {
+    mapBin.insert(triangles[i], triangles[i + 1], triangles[i + 2]);
+    bin.insert(triangles[i], triangles[i + 1], triangles[i + 2]);
+  }
+
+  SG_CHECK_EQUAL(bin.getNumVertices(), mapBin.getValues().size());
+  SG_VERIFY(bin.getTriangles() == mapBin.getTriangles());
+  for (size_t i = 0; i < mapBin.getValues().size(); ++i) {
+    SG_VERIFY(equivalent(bin.getVertex(i), mapBin.getValues()[i]));
+  }
+
+  std::list<MapTriangleBin::TriangleVector> mapSets;
+  mapBin.getConnectedSets(mapSets);
+  std::list<SGTriangleBin<SGVertNormTex>::TriangleVector> sets;
+  bin.getConnectedSets(sets);
+  SG_CHECK_EQUAL(sets.size(), mapSets.size());
+  SG_VERIFY(sets == mapSets);
+  // three patches, four isolated triangles and the one with -0
+  SG_CHECK_EQUAL(sets.size(), 8u);
+}
+
+void test_assign()
+{
+  cout << "Testing inserting into an assigned SGTriangleBin" << endl;
+
+  const std::vector<SGVertNormTex> triangles = createTriangles();
+  const size_t half = triangles.size() / 6 * 3;
+
+  SGTriangleBin<SGVertNormTex> first;
+  for (size_t i = 0; i + 2 < half; i += 3)
+    first.insert(triangles[i], triangles[i + 1], triangles[i + 2]);
+
+  std::vector<uint32_t> indices;
+  for (const auto& t : first.getTriangles()) {
+    for (int j = 0; j < 3; ++j)
+      indices.push_back(t[j]);
+  }
+
+  SGTriangleBin<SGVertNormTex> bin;
+  bin.assign(first.getValues().data(), first.getNumVertices(),
+             indices.data(), first.getNumTriangles());
+  MapTriangleBin mapBin;
+  for (size_t i = 0; i + 2 < triangles.size(); i += 3) {
+    mapBin.insert(triangles[i], triangles[i + 1], triangles[i + 2]);
+    if (i >= half)
+      bin.insert(triangles[i], triangles[i + 1], triangles[i + 2]);
+  }
+
+  SG_CHECK_EQUAL(bin.getNumVertices(), mapBin.getValues().size());
+  SG_VERIFY(bin.getTriangles() == mapBin.getTriangles());
+
+  std::list<MapTriangleBin::TriangleVector> mapSets;
+  mapBin.getConnectedSets(mapSets);
+  std::list<SGTriangleBin<SGVertNormTex>::TriangleVector> sets;
+  bin.getConnectedSets(sets);
+  SG_VERIFY(sets == mapSets);
+}
+
+int main(int argc, char* argv[])
+{
+  test_ordering();
+  test_matchesMapBin();
+  test_assign();
+
+  return EXIT_SUCCESS;
+}
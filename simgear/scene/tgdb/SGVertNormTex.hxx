@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+// SPDX-FileCopyrightText: 2006-2007 Mathias Froehlich
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include <simgear/math/SGMath.hxx>
+
+struct SGVertNormTex {
+  SGVertNormTex() { 
+      tc_mask = 0;
+  }
+
+  // Strict weak ordering: vertex, normal, the set of texture coordinates
+  // present and then each present texture coordinate, compared exactly.
+  struct less
+  {
+    inline bool operator() (const SGVertNormTex& l,
+                            const SGVertNormTex& r) const
+    {
+      if (l.vertex < r.vertex) return true;
+      else if (r.vertex < l.vertex) return false;
+      else if (l.normal < r.normal) return true;
+      else if (r.normal < l.normal) return false;
+      else if (l.tc_mask != r.tc_mask) return l.tc_mask < r.tc_mask;
+
+      for (int idx = 0; idx < 4; ++idx) {
+        if (!(l.tc_mask & 1<<idx))
+          continue;
+        if (l.texCoord[idx] < r.texCoord[idx]) return true;
+        else if (r.texCoord[idx] < l.texCoord[idx]) return false;
+      }
+      return false;
+    }
+  };
+
+  // Consistent with less: vertices that compare equal share vertex and normal
+  struct hash
+  {
+    static size_t mix(size_t h, float f)
+    {
+      // -0 and +0 compare equal, so they have to hash equally
+      f += 0.0f;
+      uint32_t bits;
+      std::memcpy(&bits, &f, sizeof(bits));
+      h ^= bits + 0x9e3779b9u + (h << 6) + (h >> 2);
+      return h;
+    }
+
+    inline size_t operator() (const SGVertNormTex& v) const
+    {
+      size_t h = 0;
+      for (int i = 0; i < 3; ++i)
+        h = mix(h, v.vertex[i]);
+      for (int i = 0; i < 3; ++i)
+        h = mix(h, v.normal[i]);
+      return h;
+    }
+  };
+
+  void SetVertex( const SGVec3f& v )          { vertex = v; }
+  const SGVec3f& GetVertex( void ) const      { return vertex; }
+  
+  void SetNormal( const SGVec3f& n )          { normal = n; }
+  const SGVec3f& GetNormal( void ) const      { return normal; }
+  
+  void SetTexCoord( unsigned idx, const SGVec2f& tc ) { 
+      texCoord[idx] = tc; 
+      tc_mask |= 1 << idx; 
+  }
+  const SGVec2f& GetTexCoord( unsigned idx ) const { return texCoord[idx]; }
+
+  void SetOverlayCoord( const SGVec2f& ovc )  { overlayCoord = ovc; }
+  const SGVec2f& GetOverlayCoord() const { return overlayCoord; }
+
+private:  
+  SGVec3f vertex;
+  SGVec3f normal;
+  SGVec2f texCoord[4];
+  SGVec2f overlayCoord;
+  
+  unsigned tc_mask;
+};
@@ -21,28 +21,50 @@
 
 #pragma once
 
+#include <cstddef>
 #include <vector>
-#include <map>
 
+/**
+ * Array of unique vertices.
+ *
+ * Vertices are deduplicated through an open addressing hash table
+ * (linear probing) holding the vertex indices, so inserting a vertex does
+ * not allocate anything apart from the occasional growth of the arrays.
+ * Two vertices are considered equal if neither is less than the other
+ * according to value_type::less, and value_type::hash has to be consistent
+ * with that.
+ */
 template<typename T>
 class SGVertexArrayBin {
 public:
   typedef T value_type;
   typedef typename value_type::less less;
+  typedef typename value_type::hash hash;
   typedef std::vector<value_type> ValueVector;
   typedef typename ValueVector::size_type index_type;
-  typedef std::map<value_type, index_type, less> ValueMap;
 
   index_type insert(const value_type& t)
   {
-    typename ValueMap::iterator i = _valueMap.find(t);
-    if (i != _valueMap.end())
-      return i->second;
-
-    index_type index = _values.size();
-    _valueMap[t] = index;
-    _values.push_back(t);
-    return index;
+    if (_numHashed != _values.size())
+      rehashValues();
+    if (2 * (_values.size() + 1) > _slots.size())
+      rehash(2 * _slots.size());
+
+    const size_t h = hash()(t);
+    const size_t mask = _slots.size() - 1;
+    for (size_t i = h & mask;; i = (i + 1) & mask) {
+      Slot& slot = _slots[i];
+      if (slot.index == emptySlot) {
+        slot.hash = h;
+        slot.index = _values.size();
+        _values.push_back(t);
+        ++_numHashed;
+        return slot.index;
+      }
+
+      if (slot.hash == h && equal(_values[slot.index], t))
+        return slot.index;
+    }
   }
 
   const value_type& getVertex(index_type index) const
@@ -54,7 +76,67 @@ public:
   bool empty() const
   { return _values.empty(); }
 
+  const ValueVector& getValues() const
+  { return _values; }
+
+  /// Replace the contents by @a count vertices which are already unique.
+  /// The hash table is only rebuilt once another vertex is inserted.
+  void assign(const value_type* values, index_type count)
+  {
+    _values.assign(values, values + count);
+    _slots.clear();
+    _numHashed = 0;
+  }
+
 private:
+  static const index_type emptySlot = ~index_type(0);
+
+  struct Slot {
+    size_t hash = 0;
+    index_type index = emptySlot;
+  };
+
+  static bool equal(const value_type& l, const value_type& r)
+  { return !less()(l, r) && !less()(r, l); }
+
+  void rehash(size_t minSize)
+  {
+    size_t size = 16;
+    while (size < minSize)
+      size *= 2;
+
+    std::vector<Slot> slots(size);
+    const size_t mask = size - 1;
+    for (const Slot& slot : _slots) {
+      if (slot.index == emptySlot)
+        continue;
+
+      size_t i = slot.hash & mask;
+      while (slots[i].index != emptySlot)
+        i = (i + 1) & mask;
+      slots[i] = slot;
+    }
+    _slots.swap(slots);
+  }
+
+  void rehashValues()
+  {
+    _slots.clear();
+    rehash(2 * (_values.size() + 1));
+    const size_t mask = _slots.size() - 1;
+    for (index_type index = 0; index < _values.size(); ++index) {
+      const size_t h = hash()(_values[index]);
+      size_t i = h & mask;
+      while (_slots[i].index != emptySlot)
+        i = (i + 1) & mask;
+      _slots[i].hash = h;
+      _slots[i].index = index;
+    }
+    _numHashed = _values.size();
+  }
+
   ValueVector _values;
-  ValueMap _valueMap;
+  std::vector<Slot> _slots;
+  /// Number of values in _slots, less than the number of values after assign()
+  index_type _numHashed = 0;
 };
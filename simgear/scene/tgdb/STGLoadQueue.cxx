@@ -0,0 +1,307 @@
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+/**
+ * @file
+ * @brief Prioritised queue for loading the objects of STG files
+ */
+
+#include <simgear_config.h>
+
+#include "STGLoadQueue.hxx"
+
+#include <algorithm>
+#include <exception>
+#include <sstream>
+
+#include <simgear/debug/logstream.hxx>
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/misc/sg_path.hxx>
+
+namespace simgear {
+
+bool readSTGFile(const SGPath& path, std::vector<STGObjectDescriptor>& objects)
+{
+    if (!path.exists())
+        return false;
+
+    sg_gzifstream stream(path);
+    if (!stream.is_open())
+        return false;
+
+    std::string line;
+    unsigned lineNumber = 0;
+    while (std::getline(stream, line)) {
+        ++lineNumber;
+
+        // strip comments
+        std::string::size_type hash_pos = line.find('#');
+        if (hash_pos != std::string::npos)
+            line.resize(hash_pos);
+
+        std::istringstream in(line);
+        STGObjectDescriptor object;
+        in >> object.token;
+        if (object.token.empty())
+            continue;
+
+        // Then there is always a name
+        in >> object.name;
+        std::getline(in, object.arguments);
+        object.line = lineNumber;
+        objects.push_back(std::move(object));
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+class STGLoadQueue::Batch
+{
+public:
+    Batch(long bucketIndex, double maxRange, uint64_t created) :
+        _bucketIndex(bucketIndex),
+        _maxRange(maxRange),
+        _created(created)
+    {}
+
+    const long _bucketIndex;
+    const double _maxRange;
+    const uint64_t _created;
+
+    // Protected by the lock of the queue
+    size_t _pending = 0;
+    bool _cancelled = false;
+    bool _dropped = false;
+    std::vector<Item> _queue;   ///< heap of the jobs not taken yet
+};
+
+bool STGLoadQueue::BatchLess::operator()(const BatchPtr& a, const BatchPtr& b) const
+{
+    // Sequence numbers are unique, so batches never compare equal
+    return ItemLess()(b->_queue.front(), a->_queue.front());
+}
+
+STGLoadQueue::STGLoadQueue(unsigned int numWorkers)
+{
+    for (unsigned int i = 0; i < numWorkers; ++i)
+        _workers.emplace_back(&STGLoadQueue::workerMain, this);
+}
+
+STGLoadQueue::~STGLoadQueue()
+{
+    {
+        std::lock_guard<std::mutex> g(_lock);
+        _quit = true;
+    }
+    _wakeup.notify_all();
+    for (std::thread& worker : _workers)
+        worker.join();
+
+    // Nobody can wait for these anymore
+    std::vector<BatchPtr> batches(_ready.begin(), _ready.end());
+    _ready.clear();
+    for (const BatchPtr& batch : batches)
+        dropQueued(*batch);
+}
+
+unsigned int STGLoadQueue::defaultNumWorkers()
+{
+    // Loading is mostly waiting for files, and the pager threads wait for
+    // their own batches and help with them.
+    return std::max(2u, std::thread::hardware_concurrency() / 2);
+}
+
+//------------------------------------------------------------------------------
+
+STGLoadQueue::BatchPtr STGLoadQueue::createBatch(long bucketIndex, double maxRange)
+{
+    std::lock_guard<std::mutex> g(_lock);
+    return std::make_shared<Batch>(bucketIndex, maxRange, _sequence++);
+}
+
+void STGLoadQueue::submit(const BatchPtr& batch, const SGVec3d& position, Job job)
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    ++_stats.submitted;
+    Item item{priority(position), _sequence++, position, std::move(job), Clock::now()};
+    ++batch->_pending;
+    if (cancelled(*batch)) {
+        drop(*batch);
+        return;
+    }
+
+    push(batch, std::move(item));
+    lock.unlock();
+    _wakeup.notify_one();
+}
+
+bool STGLoadQueue::wait(const BatchPtr& batch)
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    while (batch->_pending > 0) {
+        // Take the most important job of this batch, if there is any left
+        if (batch->_queue.empty()) {
+            _done.wait(lock);
+            continue;
+        }
+
+        Item item = pop(batch);
+        run(lock, *batch, item);
+    }
+    return !batch->_dropped;
+}
+
+void STGLoadQueue::cancel(long bucketIndex)
+{
+    std::lock_guard<std::mutex> g(_lock);
+    _cancelledBuckets[bucketIndex] = _sequence++;
+    for (auto i = _ready.begin(); i != _ready.end();) {
+        if (!cancelled(**i)) {
+            ++i;
+            continue;
+        }
+
+        BatchPtr batch = *i;
+        i = _ready.erase(i);
+        dropQueued(*batch);
+    }
+}
+
+void STGLoadQueue::setViewerPosition(const SGVec3d& position)
+{
+    std::lock_guard<std::mutex> g(_lock);
+    if (_haveViewer && distSqr(position, _viewer) < 1)
+        return;
+
+    _haveViewer = true;
+    _viewer = position;
+
+    // Every batch may move, so sort them again from scratch
+    std::vector<BatchPtr> batches(_ready.begin(), _ready.end());
+    _ready.clear();
+    for (const BatchPtr& batch : batches) {
+        for (Item& item : batch->_queue)
+            item.priority = priority(item.position);
+        std::make_heap(batch->_queue.begin(), batch->_queue.end(), ItemLess());
+        _ready.insert(batch);
+    }
+}
+
+STGLoadQueue::Stats STGLoadQueue::getStats() const
+{
+    std::lock_guard<std::mutex> g(_lock);
+    return _stats;
+}
+
+//------------------------------------------------------------------------------
+
+double STGLoadQueue::priority(const SGVec3d& position) const
+{
+    // Without a viewer, jobs run in order of submission
+    return _haveViewer ? distSqr(position, _viewer) : 0.0;
+}
+
+bool STGLoadQueue::cancelled(Batch& batch) const
+{
+    if (!batch._cancelled) {
+        auto it = _cancelledBuckets.find(batch._bucketIndex);
+        batch._cancelled = it != _cancelledBuckets.end() && it->second > batch._created;
+    }
+    return batch._cancelled;
+}
+
+bool STGLoadQueue::outOfRange(const Batch& batch, const Item& item) const
+{
+    const double range = batch._maxRange;
+    return _haveViewer && range > 0 && distSqr(item.position, _viewer) > range * range;
+}
+
+void STGLoadQueue::push(const BatchPtr& batch, Item item)
+{
+    // The place of a batch in _ready depends on its first job
+    if (!batch->_queue.empty())
+        _ready.erase(batch);
+    batch->_queue.push_back(std::move(item));
+    std::push_heap(batch->_queue.begin(), batch->_queue.end(), ItemLess());
+    _ready.insert(batch);
+    ++_stats.queued;
+}
+
+STGLoadQueue::Item STGLoadQueue::pop(const BatchPtr& batch)
+{
+    _ready.erase(batch);
+    std::pop_heap(batch->_queue.begin(), batch->_queue.end(), ItemLess());
+    Item item = std::move(batch->_queue.back());
+    batch->_queue.pop_back();
+    if (!batch->_queue.empty())
+        _ready.insert(batch);
+    --_stats.queued;
+    return item;
+}
+
+void STGLoadQueue::run(std::unique_lock<std::mutex>& lock, Batch& batch, Item& item)
+{
+    if (cancelled(batch) || outOfRange(batch, item)) {
+        drop(batch);
+        return;
+    }
+
+    ++_stats.running;
+    lock.unlock();
+    try {
+        item.job();
+    } catch (const std::exception& e) {
+        SG_LOG(SG_TERRAIN, SG_ALERT, "STG object load failed: " << e.what());
+    } catch (...) {
+        SG_LOG(SG_TERRAIN, SG_ALERT, "STG object load failed");
+    }
+    item.job = nullptr;
+    const double latency = std::chrono::duration<double>(Clock::now() - item.submitted).count();
+    lock.lock();
+
+    --_stats.running;
+    ++_stats.completed;
+    _totalLatency += latency;
+    _stats.meanLatency = _totalLatency / _stats.completed;
+    _stats.maxLatency = std::max(_stats.maxLatency, latency);
+    finish(batch);
+}
+
+void STGLoadQueue::drop(Batch& batch)
+{
+    ++_stats.cancelled;
+    batch._dropped = true;
+    finish(batch);
+}
+
+void STGLoadQueue::dropQueued(Batch& batch)
+{
+    // The batch must not be in _ready anymore
+    for (size_t i = 0; i < batch._queue.size(); ++i)
+        drop(batch);
+    _stats.queued -= batch._queue.size();
+    batch._queue.clear();
+}
+
+void STGLoadQueue::finish(Batch& batch)
+{
+    if (--batch._pending == 0)
+        _done.notify_all();
+}
+
+void STGLoadQueue::workerMain()
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    for (;;) {
+        _wakeup.wait(lock, [this] { return _quit || !_ready.empty(); });
+        if (_quit)
+            return;
+
+        // The batch with the most important job of all
+        BatchPtr batch = *_ready.begin();
+        Item item = pop(batch);
+        run(lock, *batch, item);
+    }
+}
+
+} // namespace simgear
@@ -0,0 +1,181 @@
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+/**
+ * @file
+ * @brief Prioritised queue for loading the objects of STG files
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <simgear/math/SGMath.hxx>
+#include <simgear/structure/SGLoadingCache.hxx>
+
+class SGPath;
+
+namespace simgear {
+
+/**
+ * One line of an STG file: the token, the (model) name, and the remaining
+ * arguments, which depend on the token.
+ */
+struct STGObjectDescriptor {
+    std::string token;
+    std::string name;
+    std::string arguments;
+    unsigned line = 0;
+};
+
+/**
+ * Parse an (optionally gzipped) STG file into object descriptors, stripping
+ * comments and empty lines.
+ *
+ * @return false if the file can't be read
+ */
+bool readSTGFile(const SGPath& path, std::vector<STGObjectDescriptor>& objects);
+
+/**
+ * Worker threads loading the objects of scenery buckets, most important
+ * first.
+ *
+ * Jobs are submitted in batches, usually all objects of one bucket, and are
+ * run in the order of their distance to the viewer. The priorities are
+ * updated whenever the viewer position changes. Jobs of a bucket which has
+ * been cancelled, or which have fallen out of the range of their batch,
+ * are dropped without running.
+ *
+ * The thread waiting for a batch runs jobs of that batch itself, so batches
+ * complete even with all workers busy, or without any workers.
+ */
+class STGLoadQueue final
+{
+public:
+    using Job = std::function<void()>;
+
+    struct Stats {
+        size_t queued = 0;          ///< jobs waiting for a thread
+        size_t running = 0;
+        uint64_t submitted = 0;
+        uint64_t completed = 0;
+        uint64_t cancelled = 0;
+        double meanLatency = 0;     ///< seconds from submission to completion
+        double maxLatency = 0;
+    };
+
+    class Batch;
+    using BatchPtr = std::shared_ptr<Batch>;
+
+    explicit STGLoadQueue(unsigned int numWorkers);
+    ~STGLoadQueue();
+
+    STGLoadQueue(const STGLoadQueue&) = delete;
+    STGLoadQueue& operator=(const STGLoadQueue&) = delete;
+
+    /**
+     * Create a batch for the jobs of bucket @a bucketIndex. Jobs further
+     * than @a maxRange from the viewer are cancelled; zero disables this.
+     */
+    BatchPtr createBatch(long bucketIndex, double maxRange = 0);
+
+    /// Queue @a job for an object at the cartesian @a position
+    void submit(const BatchPtr& batch, const SGVec3d& position, Job job);
+
+    /**
+     * Block until all jobs of @a batch completed or were cancelled.
+     *
+     * @return false if any job was cancelled
+     */
+    bool wait(const BatchPtr& batch);
+
+    /**
+     * Drop all queued jobs of the batches created for the bucket so far,
+     * including jobs submitted to them later on. Batches created afterwards,
+     * when the bucket is loaded again, are not affected.
+     */
+    void cancel(long bucketIndex);
+
+    /// Cartesian position of the viewer the jobs are prioritised by
+    void setViewerPosition(const SGVec3d& position);
+
+    Stats getStats() const;
+
+    static unsigned int defaultNumWorkers();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Item {
+        double priority;
+        uint64_t sequence;
+        SGVec3d position;
+        Job job;
+        Clock::time_point submitted;
+    };
+    /// std heap ordering: the item with the lowest priority value first
+    struct ItemLess {
+        bool operator()(const Item& a, const Item& b) const
+        {
+            if (a.priority != b.priority)
+                return a.priority > b.priority;
+            return a.sequence > b.sequence;
+        }
+    };
+
+    /// Batches ordered by their most important queued job
+    struct BatchLess {
+        bool operator()(const BatchPtr& a, const BatchPtr& b) const;
+    };
+
+    double priority(const SGVec3d& position) const;
+    bool cancelled(Batch& batch) const;
+    bool outOfRange(const Batch& batch, const Item& item) const;
+    void push(const BatchPtr& batch, Item item);
+    Item pop(const BatchPtr& batch);
+    void run(std::unique_lock<std::mutex>& lock, Batch& batch, Item& item);
+    void drop(Batch& batch);
+    void dropQueued(Batch& batch);
+    void finish(Batch& batch);
+    void workerMain();
+
+    std::vector<std::thread> _workers;
+
+    mutable std::mutex _lock;
+    std::condition_variable _wakeup;
+    std::condition_variable _done;
+    std::set<BatchPtr, BatchLess> _ready;   ///< batches with queued jobs
+    uint64_t _sequence = 0;
+    bool _quit = false;
+
+    /// Sequence number at the last cancellation of each bucket, batches
+    /// created before it are cancelled
+    std::map<long, uint64_t> _cancelledBuckets;
+
+    bool _haveViewer = false;
+    SGVec3d _viewer;
+
+    Stats _stats;
+    double _totalLatency = 0;
+};
+
+/**
+ * Cache of loaded shared models, so every model is loaded only once even
+ * if several threads request it at the same time. The most recently used
+ * models are kept after loading, as many as given to the constructor.
+ * Failed loads, returning a null model, are not cached.
+ */
+template<typename Value>
+using STGModelCache = SGLoadingCache<std::string, Value>;
+
+} // namespace simgear
@@ -0,0 +1,343 @@
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+/**
+ * @file
+ * @brief Unit tests for STGLoadQueue, STGModelCache and readSTGFile
+ */
+
+#include <simgear_config.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <simgear/bucket/newbucket.hxx>
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/misc/sg_dir.hxx>
+#include <simgear/misc/test_macros.hxx>
+
+#include "STGLoadQueue.hxx"
+
+using std::cout;
+using std::endl;
+using namespace simgear;
+
+// Shared models are referred to by pointer, a null one is a failed load
+using Model = std::shared_ptr<const std::string>;
+
+void test_readSTGFile()
+{
+  cout << "Testing parsing of STG files" << endl;
+
+  Dir dir = Dir::tempDir("stg_test");
+  dir.setRemoveOnDestroy();
+
+  const SGPath plain = dir.file("3040874.stg");
+  {
+    sg_ofstream out(plain);
+    out << "# comment only\n"
+        << "OBJECT 3040874.btg\n"
+        << "\n"
+        << "OBJECT_SHARED Models/tower.xml -122.36 37.61 3.5 90 # trailing comment\n"
+        << "   \n"
+        << "OBJECT_SIGN {@size=2,l,-,r} -122.37 37.62 3.0 45 2";
+  }
+
+  std::vector<STGObjectDescriptor> objects;
+  SG_VERIFY(readSTGFile(plain, objects));
+  SG_CHECK_EQUAL(objects.size(), 3u);
+  SG_CHECK_EQUAL(objects[0].token, "OBJECT");
+  SG_CHECK_EQUAL(objects[0].name, "3040874.btg");
+  SG_CHECK_EQUAL(objects[0].line, 2u);
+  SG_CHECK_EQUAL(objects[1].token, "OBJECT_SHARED");
+  SG_CHECK_EQUAL(objects[1].name, "Models/tower.xml");
+  SG_CHECK_EQUAL(objects[1].line, 4u);
+  SG_CHECK_EQUAL(objects[2].name, "{@size=2,l,-,r}");
+
+  double lon, lat, elev, hdg;
+  std::istringstream in(objects[1].arguments);
+  in >> lon >> lat >> elev >> hdg;
+  SG_VERIFY(!in.fail());
+  SG_CHECK_EQUAL(hdg, 90.0);
+
+  const SGPath gz = dir.file("3040875.stg.gz");
+  {
+    sg_gzofstream out(gz);
+    out << "OBJECT_STATIC house.ac -122.3 37.6 2 0\n";
+  }
+  objects.clear();
+  SG_VERIFY(readSTGFile(gz, objects));
+  SG_CHECK_EQUAL(objects.size(), 1u);
+  SG_CHECK_EQUAL(objects[0].name, "house.ac");
+
+  SG_VERIFY(!readSTGFile(dir.file("missing.stg"), objects));
+}
+
+void test_priorityOrder()
+{
+  cout << "Testing jobs run closest to the viewer first" << endl;
+
+  STGLoadQueue queue(0);
+  queue.setViewerPosition(SGVec3d(0, 0, 0));
+
+  std::vector<int> order;
+  auto batch = queue.createBatch(1);
+  for (int d : {50, 10, 40, 20, 30})
+    queue.submit(batch, SGVec3d(d, 0, 0), [&order, d] { order.push_back(d); });
+
+  // The viewer moves to the other end before the jobs run
+  queue.setViewerPosition(SGVec3d(60, 0, 0));
+  SG_VERIFY(queue.wait(batch));
+  SG_CHECK_EQUAL(order.size(), 5u);
+  for (size_t i = 0; i < order.size(); ++i)
+    SG_CHECK_EQUAL(order[i], 50 - 10 * int(i));
+
+  STGLoadQueue::Stats stats = queue.getStats();
+  SG_CHECK_EQUAL(stats.submitted, 5u);
+  SG_CHECK_EQUAL(stats.completed, 5u);
+  SG_CHECK_EQUAL(stats.cancelled, 0u);
+  SG_CHECK_EQUAL(stats.queued, 0u);
+}
+
+void test_cancel()
+{
+  cout << "Testing cancellation of buckets" << endl;
+
+  STGLoadQueue queue(0);
+  std::atomic<int> runs{0};
+  auto a = queue.createBatch(1);
+  auto b = queue.createBatch(2);
+  auto empty = queue.createBatch(1);
+  for (int i = 0; i < 4; ++i) {
+    queue.submit(a, SGVec3d(i, 0, 0), [&runs] { ++runs; });
+    queue.submit(b, SGVec3d(i, 0, 0), [&runs] { ++runs; });
+  }
+
+  queue.cancel(1);
+  SG_CHECK_EQUAL(queue.getStats().queued, 4u);
+
+  // Jobs submitted after cancelling are dropped as well, also to batches
+  // which had no jobs queued yet
+  queue.submit(a, SGVec3d(0, 0, 0), [&runs] { ++runs; });
+  queue.submit(empty, SGVec3d(0, 0, 0), [&runs] { ++runs; });
+  SG_VERIFY(!queue.wait(a));
+  SG_VERIFY(!queue.wait(empty));
+  SG_VERIFY(queue.wait(b));
+  SG_CHECK_EQUAL(runs.load(), 4);
+
+  // The bucket is loaded again later on
+  auto again = queue.createBatch(1);
+  queue.submit(again, SGVec3d(0, 0, 0), [&runs] { ++runs; });
+  SG_VERIFY(queue.wait(again));
+  SG_CHECK_EQUAL(runs.load(), 5);
+
+  STGLoadQueue::Stats stats = queue.getStats();
+  SG_CHECK_EQUAL(stats.cancelled, 6u);
+  SG_CHECK_EQUAL(stats.completed, 5u);
+}
+
+void test_range()
+{
+  cout << "Testing cancellation of jobs out of range" << endl;
+
+  STGLoadQueue queue(0);
+  queue.setViewerPosition(SGVec3d(0, 0, 0));
+
+  std::vector<int> order;
+  auto batch = queue.createBatch(1, 100);
+  for (int d : {50, 150, 99})
+    queue.submit(batch, SGVec3d(0, d, 0), [&order, d] { order.push_back(d); });
+
+  SG_VERIFY(!queue.wait(batch));
+  SG_CHECK_EQUAL(order.size(), 2u);
+  SG_CHECK_EQUAL(order[0], 50);
+  SG_CHECK_EQUAL(order[1], 99);
+  SG_CHECK_EQUAL(queue.getStats().cancelled, 1u);
+}
+
+void test_workers()
+{
+  cout << "Testing batches of several threads on the workers" << endl;
+
+  STGLoadQueue queue(3);
+  std::atomic<int> runs{0};
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&queue, &runs, t] {
+      for (int n = 0; n < 10; ++n) {
+        auto batch = queue.createBatch(t * 100 + n);
+        for (int i = 0; i < 20; ++i)
+          queue.submit(batch, SGVec3d(i, t, n), [&runs] { ++runs; });
+        SG_VERIFY(queue.wait(batch));
+      }
+    });
+  }
+  for (std::thread& t : threads)
+    t.join();
+
+  SG_CHECK_EQUAL(runs.load(), 800);
+  STGLoadQueue::Stats stats = queue.getStats();
+  SG_CHECK_EQUAL(stats.submitted, 800u);
+  SG_CHECK_EQUAL(stats.completed, 800u);
+  SG_CHECK_EQUAL(stats.queued, 0u);
+  SG_CHECK_EQUAL(stats.running, 0u);
+  SG_VERIFY(stats.maxLatency >= stats.meanLatency);
+
+  // Exceptions are logged, the batch still completes
+  auto batch = queue.createBatch(1);
+  queue.submit(batch, SGVec3d(0, 0, 0), [] { throw std::runtime_error("test"); });
+  SG_VERIFY(queue.wait(batch));
+}
+
+void test_modelCache()
+{
+  cout << "Testing deduplication of shared models" << endl;
+
+  STGModelCache<Model> cache(2);
+  std::atomic<int> loads{0};
+  auto loader = [&loads](const std::string& name) {
+    return [&loads, name] {
+      ++loads;
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      return std::make_shared<const std::string>("model " + name);
+    };
+  };
+
+  // Concurrent requests for the same model load it once
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&cache, &loader] {
+      SG_CHECK_EQUAL(*cache.get("a", loader("a")), "model a");
+    });
+  }
+  for (std::thread& t : threads)
+    t.join();
+  SG_CHECK_EQUAL(loads.load(), 1);
+  SG_CHECK_EQUAL(cache.getStats().misses, 1u);
+  SG_CHECK_EQUAL(cache.getStats().hits, 3u);
+
+  // Least recently used models are evicted
+  cache.get("b", loader("b"));
+  cache.get("a", loader("a"));
+  cache.get("c", loader("c"));
+  SG_CHECK_EQUAL(loads.load(), 3);
+  cache.get("a", loader("a"));
+  SG_CHECK_EQUAL(loads.load(), 3);
+  cache.get("b", loader("b"));
+  SG_CHECK_EQUAL(loads.load(), 4);
+
+  // Failed loads are not cached
+  bool thrown = false;
+  try {
+    cache.get("d", []() -> Model { throw std::runtime_error("test"); });
+  } catch (const std::runtime_error&) {
+    thrown = true;
+  }
+  SG_VERIFY(thrown);
+  SG_CHECK_EQUAL(*cache.get("d", loader("d")), "model d");
+
+  // Nor are models which failed to load, so they are tried again
+  SG_VERIFY(!cache.get("e", [] { return Model(); }));
+  SG_CHECK_EQUAL(*cache.get("e", loader("e")), "model e");
+  SG_CHECK_EQUAL(loads.load(), 6);
+}
+
+/**
+ * Synthetic scenery: a row of buckets, each with an STG file referencing a
+ * few of a small set of shared models. The viewer moves along the row, and
+ * buckets falling behind are cancelled, as the tile manager would do.
+ */
+void test_harness()
+{
+  cout << "Testing loading synthetic STG files" << endl;
+
+  Dir dir = Dir::tempDir("stg_test");
+  dir.setRemoveOnDestroy();
+
+  const int numBuckets = 12;
+  const int objectsPerBucket = 30;
+  const char* models[] = {"tower.xml", "hangar.ac", "windsock.xml", "beacon.xml"};
+
+  std::vector<SGBucket> buckets;
+  for (int i = 0; i < numBuckets; ++i) {
+    SGBucket bucket(SGGeod::fromDeg(-122.0 + i * 0.125, 37.6));
+    buckets.push_back(bucket);
+
+    sg_ofstream out(dir.file(bucket.gen_index_str() + ".stg"));
+    out << "OBJECT " << bucket.gen_index_str() << ".btg\n";
+    for (int k = 0; k < objectsPerBucket; ++k) {
+      const SGGeod pos = SGGeod::fromDeg(bucket.get_center_lon() + 0.001 * k,
+                                         bucket.get_center_lat());
+      out << "OBJECT_SHARED Models/" << models[k % 4] << " "
+          << pos.getLongitudeDeg() << " " << pos.getLatitudeDeg() << " 10 0\n";
+    }
+  }
+
+  STGLoadQueue queue(2);
+  STGModelCache<Model> cache(16);
+  std::mutex loadedLock;
+  std::map<std::string, int> modelLoads;
+  std::atomic<int> instances{0};
+
+  const double range = 30000;
+  for (int i = 0; i < numBuckets; ++i) {
+    const SGBucket& bucket = buckets[i];
+    queue.setViewerPosition(SGVec3d::fromGeod(bucket.get_center()));
+    if (i >= 2)
+      queue.cancel(buckets[i - 2].gen_index());
+
+    std::vector<STGObjectDescriptor> objects;
+    SG_VERIFY(readSTGFile(dir.file(bucket.gen_index_str() + ".stg"), objects));
+    SG_CHECK_EQUAL(objects.size(), size_t(objectsPerBucket + 1));
+
+    auto batch = queue.createBatch(bucket.gen_index(), range);
+    for (const STGObjectDescriptor& object : objects) {
+      if (object.token != "OBJECT_SHARED")
+        continue;
+
+      double lon, lat;
+      std::istringstream(object.arguments) >> lon >> lat;
+      const std::string name = object.name;
+      queue.submit(batch, SGVec3d::fromGeod(SGGeod::fromDeg(lon, lat)), [&, name] {
+        cache.get(name, [&, name] {
+          std::lock_guard<std::mutex> g(loadedLock);
+          ++modelLoads[name];
+          return std::make_shared<const std::string>(name);
+        });
+        ++instances;
+      });
+    }
+    SG_VERIFY(queue.wait(batch));
+  }
+
+  SG_CHECK_EQUAL(instances.load(), numBuckets * objectsPerBucket);
+  SG_CHECK_EQUAL(modelLoads.size(), 4u);
+  for (const auto& m : modelLoads)
+    SG_CHECK_EQUAL(m.second, 1);
+
+  STGLoadQueue::Stats stats = queue.getStats();
+  SG_CHECK_EQUAL(stats.completed, uint64_t(numBuckets * objectsPerBucket));
+  SG_CHECK_EQUAL(stats.cancelled, 0u);
+  SG_CHECK_EQUAL(stats.queued, 0u);
+}
+
+int main(int argc, char* argv[])
+{
+  test_readSTGFile();
+  test_priorityOrder();
+  test_cancel();
+  test_range();
+  test_workers();
+  test_modelCache();
+  test_harness();
+
+  return EXIT_SUCCESS;
+}
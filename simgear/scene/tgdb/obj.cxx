@@ -40,6 +40,7 @@
 #include <simgear/bucket/newbucket.hxx>
 #include <simgear/scene/util/OrthophotoManager.hxx>
 
+#include "SGTileBuildPool.hxx"
 #include "SGTileGeometryBin.hxx"        // for original tile loading
 #include "SGTileDetailsCallback.hxx"    // for tile details ( random objects, and lighting )
 
@@ -49,10 +50,6 @@ using namespace simgear;
 vsg::Node*
 SGLoadBTG(const std::string& path, const simgear::SGReaderWriterOptions* options)
 {
-    SGBinObject tile;
-    if (!tile.read_bin(path))
-      return NULL;
-
     SGMaterialLibPtr matlib;
     vsg::ref_ptr<SGMaterialCache> matcache;
     double object_range = SG_OBJECT_RANGE_ROUGH;
@@ -68,56 +65,94 @@ SGLoadBTG(const std::string& path, const simgear::SGReaderWriterOptions* options
       usePhotoscenery = propertyNode->getBoolValue("/sim/rendering/photoscenery/enabled", usePhotoscenery);
     }
 
-    SGVec3d center = tile.get_gbs_center();
-    SGGeod geodPos = SGGeod::fromCart(center);
-    SGQuatd hlOr = SGQuatd::fromLonLat(geodPos)*SGQuatd::fromEulerDeg(0, 0, 180);
-    if (matlib)
-    	matcache = matlib->generateMatCache(geodPos, options);
+    // The processed geometry is cached unless it may have tile specific
+    // overlay coordinates. A cache entry holds everything needed from the
+    // BTG file, so the file is only read on a miss.
+    SGTileCache* tileCache = usePhotoscenery ? nullptr : getTileCache(options);
+    std::string cacheKey;
+    std::unique_ptr<SGTileCache::Entry> cacheEntry;
+    if (tileCache) {
+      cacheKey = SGTileCache::makeKey(SGPath::fromUtf8(path),
+                                      SGTileGeometryBin::getCacheLayout());
+      if (!cacheKey.empty())
+        cacheEntry = tileCache->find(cacheKey);
+    }
 
-    std::vector<SGVec3d> nodes = tile.get_wgs84_nodes();
+    SGBinObject tile;
+    vsg::ref_ptr<SGTileGeometryBin> tileGeometryBin = new SGTileGeometryBin();
+    bool cached = false;
+    if (cacheEntry && SGTileGeometryBin::readCachedPoints(*cacheEntry, tile)) {
+      if (matlib)
+        matcache = matlib->generateMatCache(SGGeod::fromCart(tile.get_gbs_center()), options);
+      cached = tileGeometryBin->readCache(*cacheEntry, matcache);
+    }
+    cacheEntry.reset();
 
-    std::vector<SGVec2f> satellite_overlay_coords;
+    SGVec3d center;
+    SGQuatd hlOr;
     vsg::ref_ptr<Orthophoto> orthophoto = nullptr;
 
-    if (usePhotoscenery) {
-      try {
-        const long index = lexical_cast<long>(osgDB::getSimpleFileName(osgDB::getNameLessExtension(path)));
-        orthophoto = OrthophotoManager::instance()->getOrthophoto(index);
-      } catch (bad_lexical_cast&) {
-        orthophoto = OrthophotoManager::instance()->getOrthophoto(nodes, center);
+    if (cached) {
+      center = tile.get_gbs_center();
+      hlOr = SGQuatd::fromLonLat(SGGeod::fromCart(center))*SGQuatd::fromEulerDeg(0, 0, 180);
+    } else {
+      tile = SGBinObject();
+      if (!tile.read_bin(path))
+        return NULL;
+
+      center = tile.get_gbs_center();
+      SGGeod geodPos = SGGeod::fromCart(center);
+      hlOr = SGQuatd::fromLonLat(geodPos)*SGQuatd::fromEulerDeg(0, 0, 180);
+      if (matlib)
+        matcache = matlib->generateMatCache(geodPos, options);
+
+      std::vector<SGVec3d> nodes = tile.get_wgs84_nodes();
+
+      std::vector<SGVec2f> satellite_overlay_coords;
+
+      if (usePhotoscenery) {
+        try {
+          const long index = lexical_cast<long>(osgDB::getSimpleFileName(osgDB::getNameLessExtension(path)));
+          orthophoto = OrthophotoManager::instance()->getOrthophoto(index);
+        } catch (bad_lexical_cast&) {
+          orthophoto = OrthophotoManager::instance()->getOrthophoto(nodes, center);
+        }
       }
-    }
-    
 
-    // rotate the tiles so that the bounding boxes get nearly axis aligned.
-    // this will help the collision tree's bounding boxes a bit ...
-    for (unsigned i = 0; i < nodes.size(); ++i) {
-      if (orthophoto) {
-        // Generate TexCoords for Overlay
-        const SGGeod node_geod = SGGeod::fromCart(nodes[i] + center);
-        const OrthophotoBounds actual_bbox = orthophoto->getBbox();
-        const SGVec2f coords = actual_bbox.getTexCoord(node_geod);
-        satellite_overlay_coords.push_back(coords);
-      } else {
-        satellite_overlay_coords.push_back(SGVec2f(0.0, 0.0));
+      // rotate the tiles so that the bounding boxes get nearly axis aligned.
+      // this will help the collision tree's bounding boxes a bit ...
+      for (unsigned i = 0; i < nodes.size(); ++i) {
+        if (orthophoto) {
+          // Generate TexCoords for Overlay
+          const SGGeod node_geod = SGGeod::fromCart(nodes[i] + center);
+          const OrthophotoBounds actual_bbox = orthophoto->getBbox();
+          const SGVec2f coords = actual_bbox.getTexCoord(node_geod);
+          satellite_overlay_coords.push_back(coords);
+        } else {
+          satellite_overlay_coords.push_back(SGVec2f(0.0, 0.0));
+        }
+
+        nodes[i] = hlOr.transform(nodes[i]);
+      }
+      tile.set_wgs84_nodes(nodes);
+      tile.set_overlaycoords(satellite_overlay_coords);
+
+      SGQuatf hlOrf(hlOr[0], hlOr[1], hlOr[2], hlOr[3]);
+      std::vector<SGVec3f> normals = tile.get_normals();
+      for (unsigned i = 0; i < normals.size(); ++i)
+        normals[i] = hlOrf.transform(normals[i]);
+      tile.set_normals(normals);
+
+      // tile surface
+      if (!tileGeometryBin->insertSurfaceGeometry(tile, matcache, getTileBuildPool(options)))
+        return NULL;
+
+      if (!cacheKey.empty()) {
+        SGTileCache::Writer writer;
+        tileGeometryBin->writeCache(writer, tile, matcache);
+        tileCache->store(cacheKey, writer);
       }
-
-      nodes[i] = hlOr.transform(nodes[i]);
     }
-    tile.set_wgs84_nodes(nodes);
-    tile.set_overlaycoords(satellite_overlay_coords);
-
-    SGQuatf hlOrf(hlOr[0], hlOr[1], hlOr[2], hlOr[3]);
-    std::vector<SGVec3f> normals = tile.get_normals();
-    for (unsigned i = 0; i < normals.size(); ++i)
-      normals[i] = hlOrf.transform(normals[i]);
-    tile.set_normals(normals);
-
-    // tile surface    
-    vsg::ref_ptr<SGTileGeometryBin> tileGeometryBin = new SGTileGeometryBin();
-
-    if (!tileGeometryBin->insertSurfaceGeometry(tile, matcache))
-      return NULL;
 
     vsg::ref_ptr<vsg::Node> node = tileGeometryBin->getSurfaceGeometry(matcache);
 
@@ -0,0 +1,209 @@
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+/**
+ * @file
+ * @brief Benchmark scattering random lights/trees over a synthetic triangle bin
+ */
+
+#include <simgear_config.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <simgear/math/SGMath.hxx>
+#include <simgear/math/sg_random.hxx>
+#include <simgear/misc/test_timing.hxx>
+
+#include "SGSurfaceScatter.hxx"
+
+// Regular terrain mesh of grid_size x grid_size quads with 30m spacing
+static const int grid_size = 300;
+static const float spacing = 30.0f;
+static const double num_points = 1000000;
+static const unsigned mask_size = 512;
+static const int num_runs = 5;
+
+struct Triangle {
+    SGVec3f v[3];
+    SGVec2f t[3];
+};
+
+static std::vector<Triangle> createTriangles()
+{
+    auto vertex = [](int x, int y) {
+        float h = 40 * std::sin(0.05f * x) * std::cos(0.07f * y);
+        return SGVec3f(x * spacing, y * spacing, h);
+    };
+    auto texCoord = [](int x, int y) { return SGVec2f(x / 16.0f, y / 16.0f); };
+
+    std::vector<Triangle> triangles;
+    for (int y = 0; y < grid_size; ++y) {
+        for (int x = 0; x < grid_size; ++x) {
+            triangles.push_back({{vertex(x, y), vertex(x + 1, y), vertex(x + 1, y + 1)},
+                                 {texCoord(x, y), texCoord(x + 1, y), texCoord(x + 1, y + 1)}});
+            triangles.push_back({{vertex(x, y), vertex(x + 1, y + 1), vertex(x, y + 1)},
+                                 {texCoord(x, y), texCoord(x + 1, y + 1), texCoord(x, y + 1)}});
+        }
+    }
+    return triangles;
+}
+
+/// RGBA object mask with the blue channel varying smoothly over the image
+static std::vector<unsigned char> createMask()
+{
+    std::vector<unsigned char> rgba(4 * mask_size * mask_size);
+    for (unsigned y = 0; y < mask_size; ++y) {
+        for (unsigned x = 0; x < mask_size; ++x) {
+            unsigned char* p = &rgba[4 * (y * mask_size + x)];
+            p[0] = (unsigned char)(x & 0xff);
+            p[1] = (unsigned char)(y & 0xff);
+            p[2] = (unsigned char)(127.5 + 127.5 * std::sin(0.05 * x) * std::cos(0.03 * y));
+            p[3] = 255;
+        }
+    }
+    return rgba;
+}
+
+/// As vsg::Image::getColor() for an RGBA unsigned byte image
+static SGVec4f getColor(const std::vector<unsigned char>& rgba, unsigned x, unsigned y)
+{
+    const unsigned char* p = &rgba[4 * (y * mask_size + x)];
+    return SGVec4f(p[0] / 255.0f, p[1] / 255.0f, p[2] / 255.0f, p[3] / 255.0f);
+}
+
+/**
+ * Reference implementation as previously used by
+ * SGTexturedTriangleBin::addRandomSurfacePoints
+ */
+static void addRandomSurfacePoints(const std::vector<Triangle>& triangles,
+                                   float coverage, float offset,
+                                   const std::vector<unsigned char>* mask,
+                                   std::vector<SGVec3f>& points)
+{
+    mt seed;
+    mt_init(&seed, 123);
+
+    for (const Triangle& tri : triangles) {
+        const SGVec3f &v0 = tri.v[0], &v1 = tri.v[1], &v2 = tri.v[2];
+        const SGVec2f &t0 = tri.t[0], &t1 = tri.t[1], &t2 = tri.t[2];
+        SGVec3f normal = cross(v1 - v0, v2 - v0);
+
+        float area = 0.5f * length(normal);
+        if (area <= SGLimitsf::min())
+            continue;
+
+        float unit = area + mt_rand(&seed) * coverage;
+        SGVec3f offsetVector = offset * normalize(normal);
+
+        while (coverage < unit) {
+            float a = mt_rand(&seed);
+            float b = mt_rand(&seed);
+            if (a + b > 1) {
+                a = 1 - a;
+                b = 1 - b;
+            }
+            float c = 1 - a - b;
+            SGVec3f randomPoint = offsetVector + a * v0 + b * v1 + c * v2;
+
+            if (mask) {
+                SGVec2f texCoord = a * t0 + b * t1 + c * t2;
+                unsigned int x = (int)(mask_size * texCoord.x()) % mask_size;
+                unsigned int y = (int)(mask_size * texCoord.y()) % mask_size;
+                if (mt_rand(&seed) < getColor(*mask, x, y)[2])
+                    points.push_back(randomPoint);
+            } else {
+                points.push_back(randomPoint);
+            }
+            unit -= coverage;
+        }
+    }
+}
+
+/// Check that every point lies on (offset above) one of the grid triangles
+static bool onSurface(const std::vector<SGVec3f>& points, float offset)
+{
+    for (const SGVec3f& p : points) {
+        float x = p.x() / spacing, y = p.y() / spacing;
+        if (x < -0.01f || y < -0.01f || x > grid_size + 0.01f || y > grid_size + 0.01f)
+            return false;
+        // The mesh is smooth, so the height differs only slightly from the
+        // analytic surface, plus the offset along the (mostly up) normal
+        float h = 40 * std::sin(0.05f * x) * std::cos(0.07f * y);
+        if (std::fabs(p.z() - h) > offset + 2.0f)
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    const std::vector<Triangle> triangles = createTriangles();
+    const std::vector<unsigned char> rgba = createMask();
+
+    SGSurfaceScatter::MaskPlane mask;
+    mask.data = rgba.data() + 2; // blue channel
+    mask.width = mask.height = mask_size;
+    mask.pixelStride = 4;
+    mask.rowStride = 4 * mask_size;
+
+    double area = 0;
+    for (const Triangle& tri : triangles)
+        area += 0.5 * length(cross(tri.v[1] - tri.v[0], tri.v[2] - tri.v[0]));
+    const float coverage = float(area / num_points);
+
+    // Best of all runs, as the machine may be busy with other things
+    BestTime ref_time, ref_mask_time, scatter_time, scatter_mask_time;
+    size_t ref_count = 0, ref_mask_count = 0;
+    std::vector<SGVec3f> points, mask_points, previous;
+    bool deterministic = true;
+
+    for (int run = 0; run < num_runs; ++run) {
+        std::vector<SGVec3f> ref;
+        ref_time.run([&] { addRandomSurfacePoints(triangles, coverage, 3, nullptr, ref); });
+        ref_count = ref.size();
+
+        ref.clear();
+        ref_mask_time.run([&] { addRandomSurfacePoints(triangles, coverage, 3, &rgba, ref); });
+        ref_mask_count = ref.size();
+
+        // Includes filling the bin and building the prefix sum
+        points.clear();
+        SGSurfaceScatter scatter;
+        scatter_time.run([&] {
+            scatter.reserve(triangles.size());
+            for (const Triangle& tri : triangles)
+                scatter.addTriangle(tri.v[0], tri.v[1], tri.v[2], tri.t[0], tri.t[1], tri.t[2]);
+            scatter.prepareArea();
+            scatter.scatter(1.0 / coverage, 123, 3, SGSurfaceScatter::MaskPlane(), points);
+        });
+
+        mask_points.clear();
+        scatter_mask_time.run([&] { scatter.scatter(1.0 / coverage, 123, 3, mask, mask_points); });
+
+        deterministic = deterministic && (run == 0 || previous == points);
+        previous = points;
+    }
+
+    // Stratified sampling gives the expected count up to the fractional point
+    const bool count_ok = std::fabs(double(points.size()) - num_points) <= 1.0;
+    // Roughly half of the mask is set, the counts should agree within 1%
+    const bool mask_ok = std::fabs(double(mask_points.size()) - double(ref_mask_count))
+        < 0.01 * ref_mask_count;
+    const bool surface_ok = onSurface(points, 3) && onSurface(mask_points, 3);
+    const bool ok = count_ok && mask_ok && surface_ok && deterministic;
+
+    std::cout << triangles.size() << " triangles\n"
+              << "mt_rand per triangle:      " << ref_time.toMSecs() << " ms, "
+              << ref_count << " points\n"
+              << "  with object mask:        " << ref_mask_time.toMSecs() << " ms, "
+              << ref_mask_count << " points\n"
+              << "prefix sum + batches:      " << scatter_time.toMSecs() << " ms, "
+              << points.size() << " points\n"
+              << "  with object mask:        " << scatter_mask_time.toMSecs() << " ms, "
+              << mask_points.size() << " points\n"
+              << "results " << (ok ? "valid" : "INVALID") << std::endl;
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,243 @@
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+/**
+ * @file
+ * @brief Benchmark loading tiles with a cold and a warm on-disk tile cache
+ */
+
+#include <simgear_config.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <simgear/io/sg_binobj.hxx>
+#include <simgear/misc/sg_dir.hxx>
+#include <simgear/misc/test_timing.hxx>
+
+#include "SGTileCache.hxx"
+#include "SGTriangleBin.hxx"
+#include "SGVertNormTex.hxx"
+
+static_assert(std::is_standard_layout<SGVertNormTex>::value,
+              "vertices are stored in the tile cache bytewise");
+
+// Tiles of several materials, each a regular terrain mesh
+static const int num_tiles = 8;
+static const int num_materials = 4;
+static const int patch_size = 120;
+static const int num_runs = 5;
+
+typedef SGTriangleBin<SGVertNormTex> TriangleBin;
+
+static SGVec3d position(int tile, int x, int y)
+{
+    return SGVec3d(x * 30.0, y * 30.0, 40 * std::sin(0.05 * x + tile) * std::cos(0.07 * y));
+}
+
+static SGVertNormTex vertex(int tile, int x, int y)
+{
+    SGVertNormTex v;
+    v.SetVertex(toVec3f(position(tile, x, y)));
+    v.SetNormal(normalize(SGVec3f(0.1f * std::cos(0.05f * x), 0.1f * std::sin(0.07f * y), 1)));
+    v.SetTexCoord(0, SGVec2f(x / 16.0f, y / 16.0f));
+    v.SetOverlayCoord(SGVec2f(0, 0));
+    return v;
+}
+
+/// A BTG file with a regular terrain mesh for each material
+static bool writeTile(int tile, const SGPath& path)
+{
+    const int width = num_materials * patch_size + 1;
+    std::vector<SGVec3d> nodes;
+    std::vector<SGVec3f> normals;
+    std::vector<SGVec2f> texCoords;
+    for (int y = 0; y <= patch_size; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const SGVertNormTex v = vertex(tile, x, y);
+            nodes.push_back(position(tile, x, y));
+            normals.push_back(v.GetNormal());
+            texCoords.push_back(v.GetTexCoord(0));
+        }
+    }
+
+    SGBinObject obj;
+    obj.set_wgs84_nodes(nodes);
+    obj.set_normals(normals);
+    obj.set_texcoords(texCoords);
+    auto node = [width](int x, int y) { return y * width + x; };
+    for (int m = 0; m < num_materials; ++m) {
+        SGBinObjectTriangle tri;
+        tri.material = "material" + std::to_string(m);
+        const int x0 = m * patch_size;
+        for (int y = 0; y < patch_size; ++y) {
+            for (int x = x0; x < x0 + patch_size; ++x) {
+                for (int i : { node(x, y), node(x + 1, y), node(x + 1, y + 1),
+                               node(x, y), node(x + 1, y + 1), node(x, y + 1) }) {
+                    tri.v_list.push_back(i);
+                    tri.n_list.push_back(i);
+                    tri.tc_list[0].push_back(i);
+                }
+            }
+        }
+        obj.add_triangle(tri);
+    }
+    return obj.write_bin_file(path);
+}
+
+/// As SGTileGeometryBin::insertSurfaceGeometry, one bin per material
+static std::vector<TriangleBin> buildTile(const SGBinObject& obj)
+{
+    std::vector<TriangleBin> bins(obj.get_tris_v().size());
+    auto vertex = [&obj](int i) {
+        SGVertNormTex v;
+        v.SetVertex(toVec3f(obj.get_wgs84_nodes()[i]));
+        v.SetNormal(obj.get_normals()[i]);
+        v.SetTexCoord(0, obj.get_texcoords()[i]);
+        v.SetOverlayCoord(SGVec2f(0, 0));
+        return v;
+    };
+    for (size_t m = 0; m < bins.size(); ++m) {
+        const std::vector<int>& v = obj.get_tris_v()[m];
+        for (size_t i = 0; i + 2 < v.size(); i += 3)
+            bins[m].insert(vertex(v[i]), vertex(v[i + 1]), vertex(v[i + 2]));
+    }
+    return bins;
+}
+
+/// As SGTileGeometryBin::writeCache
+static void writeCache(const std::vector<TriangleBin>& bins, SGTileCache::Writer& writer)
+{
+    for (size_t m = 0; m < bins.size(); ++m) {
+        std::vector<uint32_t> indices;
+        for (const auto& t : bins[m].getTriangles()) {
+            indices.push_back(uint32_t(t[0]));
+            indices.push_back(uint32_t(t[1]));
+            indices.push_back(uint32_t(t[2]));
+        }
+        const std::string prefix = "material" + std::to_string(m) + ".";
+        writer.addArray(prefix + "vertices", bins[m].getValues());
+        writer.addArray(prefix + "triangles", std::move(indices));
+    }
+}
+
+/// As SGTileGeometryBin::readCache
+static bool readCache(const SGTileCache::Entry& entry, std::vector<TriangleBin>& bins)
+{
+    bins.assign(num_materials, TriangleBin());
+    for (size_t m = 0; m < bins.size(); ++m) {
+        const std::string prefix = "material" + std::to_string(m) + ".";
+        size_t numVertices = 0, numIndices = 0;
+        const SGVertNormTex* vertices =
+            entry.getArray<SGVertNormTex>(prefix + "vertices", numVertices);
+        const uint32_t* indices = entry.getArray<uint32_t>(prefix + "triangles", numIndices);
+        if (!vertices || !indices)
+            return false;
+        bins[m].assign(vertices, numVertices, indices, numIndices / 3);
+    }
+    return true;
+}
+
+static bool sameBins(const std::vector<TriangleBin>& a, const std::vector<TriangleBin>& b)
+{
+    if (a.size() != b.size())
+        return false;
+    SGVertNormTex::less less;
+    for (size_t m = 0; m < a.size(); ++m) {
+        if (a[m].getNumVertices() != b[m].getNumVertices() ||
+            a[m].getTriangles() != b[m].getTriangles())
+            return false;
+        for (size_t i = 0; i < a[m].getNumVertices(); ++i) {
+            if (less(a[m].getVertex(i), b[m].getVertex(i)) ||
+                less(b[m].getVertex(i), a[m].getVertex(i)))
+                return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    simgear::Dir dir = simgear::Dir::tempDir("tile_cache_bench");
+    dir.setRemoveOnDestroy();
+
+    std::vector<SGPath> files;
+    for (int tile = 0; tile < num_tiles; ++tile) {
+        files.push_back(dir.file("tile" + std::to_string(tile) + ".btg.gz"));
+        if (!writeTile(tile, files.back())) {
+            std::cerr << "Failed to write " << files.back() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    const SGPath cacheDir = dir.file("cache");
+
+    BestTime cold_time, warm_time;
+    bool ok = true;
+    uint64_t cache_size = 0;
+
+    for (int run = 0; run < num_runs; ++run) {
+        simgear::Dir(cacheDir).removeChildren();
+        SGTileCache cache(cacheDir, uint64_t(1) << 32);
+        std::vector<std::vector<TriangleBin>> built(num_tiles), loaded(num_tiles);
+
+        // Cold: parse the BTG file, deduplicate the vertices and store the result
+        cold_time.run([&] {
+            for (int tile = 0; tile < num_tiles; ++tile) {
+                const std::string key = SGTileCache::makeKey(files[tile], "bench");
+                if (key.empty() || cache.find(key))
+                    ok = false;
+
+                SGBinObject obj;
+                ok = obj.read_bin(files[tile]) && ok;
+                built[tile] = buildTile(obj);
+                SGTileCache::Writer writer;
+                writeCache(built[tile], writer);
+                ok = cache.store(key, writer) && ok;
+            }
+        });
+        cache_size = cache.getSize();
+
+        // Warm: map the entries and copy the arrays into the bins, without
+        // reading the BTG files
+        warm_time.run([&] {
+            for (int tile = 0; tile < num_tiles; ++tile) {
+                auto entry = cache.find(SGTileCache::makeKey(files[tile], "bench"));
+                ok = entry && readCache(*entry, loaded[tile]) && ok;
+            }
+        });
+
+        for (int tile = 0; tile < num_tiles; ++tile)
+            ok = ok && sameBins(built[tile], loaded[tile]);
+
+        // Inserting into a restored bin has to deduplicate against its vertices
+        TriangleBin& bin = loaded[0][0];
+        const size_t numVertices = bin.getNumVertices();
+        const auto t = bin.getTriangles().front();
+        const SGVertNormTex v0 = bin.getVertex(t[0]), v1 = bin.getVertex(t[1]),
+                            v2 = bin.getVertex(t[2]);
+        bin.insert(v0, v2, v1);
+        ok = ok && bin.getNumVertices() == numVertices;
+    }
+
+    // Reopening with a smaller limit evicts entries, the remaining ones are intact
+    {
+        SGTileCache cache(cacheDir, cache_size / 2);
+        ok = ok && cache.getSize() <= cache_size / 2 && cache.getNumEntries() > 0;
+        std::vector<TriangleBin> bins;
+        for (int tile = 0; tile < num_tiles; ++tile) {
+            auto entry = cache.find(SGTileCache::makeKey(files[tile], "bench"));
+            ok = ok && (!entry || readCache(*entry, bins));
+        }
+    }
+
+    std::cout << num_tiles << " tiles of " << num_materials << " materials, "
+              << cache_size / 1024 << " KiB cached\n"
+              << "cold (parse + build + store): " << cold_time.toMSecs() << " ms\n"
+              << "warm (key + map + assign):    " << warm_time.toMSecs() << " ms\n"
+              << "results " << (ok ? "valid" : "INVALID") << std::endl;
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,185 @@
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+/**
+ * @file
+ * @brief Benchmark building triangle bins from synthetic BTG-like data
+ */
+
+#include <simgear_config.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <map>
+#include <vector>
+
+#include <simgear/misc/test_timing.hxx>
+
+#include "SGTriangleBin.hxx"
+#include "SGVertNormTex.hxx"
+
+// A tile consisting of several separate patches of regular terrain mesh
+static const int num_patches = 8;
+static const int patch_size = 120;
+static const int num_runs = 5;
+
+/**
+ * Reference implementation with std::map based vertex deduplication and
+ * edge map, as previously used by SGVertexArrayBin and SGTriangleBin.
+ */
+class MapTriangleBin {
+public:
+  typedef size_t index_type;
+  typedef SGVec2<index_type> edge_ref;
+  typedef SGVec3<index_type> triangle_ref;
+  typedef std::vector<triangle_ref> TriangleVector;
+
+  index_type insertVertex(const SGVertNormTex& t)
+  {
+    auto i = _valueMap.find(t);
+    if (i != _valueMap.end())
+      return i->second;
+
+    index_type index = _values.size();
+    _valueMap[t] = index;
+    _values.push_back(t);
+    return index;
+  }
+
+  void insert(const SGVertNormTex& v0, const SGVertNormTex& v1, const SGVertNormTex& v2)
+  {
+    index_type i0 = insertVertex(v0);
+    index_type i1 = insertVertex(v1);
+    index_type i2 = insertVertex(v2);
+    index_type triangleIndex = _triangleVector.size();
+    _triangleVector.push_back(triangle_ref(i0, i1, i2));
+    _edgeMap[edge_ref(i0, i1)].push_back(triangleIndex);
+    _edgeMap[edge_ref(i1, i2)].push_back(triangleIndex);
+    _edgeMap[edge_ref(i2, i0)].push_back(triangleIndex);
+  }
+
+  void getConnectedSets(std::list<TriangleVector>& connectSets) const
+  {
+    std::vector<bool> processedTriangles(_triangleVector.size(), false);
+    for (index_type i = 0; i < _triangleVector.size(); ++i) {
+      if (processedTriangles[i])
+        continue;
+
+      TriangleVector currentSet;
+      std::vector<edge_ref> edgeStack;
+      triangle_ref triangleRef = _triangleVector[i];
+      edgeStack.push_back(edge_ref(triangleRef[0], triangleRef[1]));
+      edgeStack.push_back(edge_ref(triangleRef[1], triangleRef[2]));
+      edgeStack.push_back(edge_ref(triangleRef[2], triangleRef[0]));
+      currentSet.push_back(triangleRef);
+      processedTriangles[i] = true;
+
+      while (!edgeStack.empty()) {
+        edge_ref edge = edgeStack.back();
+        edgeStack.pop_back();
+
+        auto emiList = { _edgeMap.find(edge),
+                         _edgeMap.find(edge_ref(edge[1], edge[0])) };
+        for (auto emi : emiList) {
+          if (emi == _edgeMap.end())
+            continue;
+
+          for (index_type triangleIndex : emi->second) {
+            if (processedTriangles[triangleIndex])
+              continue;
+
+            triangle_ref t = _triangleVector[triangleIndex];
+            edgeStack.push_back(edge_ref(t[0], t[1]));
+            edgeStack.push_back(edge_ref(t[1], t[2]));
+            edgeStack.push_back(edge_ref(t[2], t[0]));
+            currentSet.push_back(t);
+            processedTriangles[triangleIndex] = true;
+          }
+        }
+      }
+
+      connectSets.push_back(currentSet);
+    }
+  }
+
+  const TriangleVector& getTriangles() const { return _triangleVector; }
+
+private:
+  std::vector<SGVertNormTex> _values;
+  std::map<SGVertNormTex, index_type, SGVertNormTex::less> _valueMap;
+  TriangleVector _triangleVector;
+  std::map<edge_ref, std::vector<index_type>> _edgeMap;
+};
+
+/// Triangle list as found in a BTG file: three full vertices per triangle
+static std::vector<SGVertNormTex> createTriangles()
+{
+  std::vector<SGVertNormTex> triangles;
+  for (int p = 0; p < num_patches; ++p) {
+    auto vertex = [p](int x, int y) {
+      SGVertNormTex v;
+      float h = 10 * std::sin(0.1f * x) * std::cos(0.13f * y);
+      v.SetVertex(SGVec3f(p * 10000.0f + x * 30.0f, y * 30.0f, h));
+      v.SetNormal(normalize(SGVec3f(-std::cos(0.1f * x), std::sin(0.13f * y), 10)));
+      v.SetTexCoord(0, SGVec2f(x / 8.0f, y / 8.0f));
+      return v;
+    };
+
+    for (int y = 0; y < patch_size; ++y) {
+      for (int x = 0; x < patch_size; ++x) {
+        triangles.push_back(vertex(x, y));
+        triangles.push_back(vertex(x + 1, y));
+        triangles.push_back(vertex(x + 1, y + 1));
+        triangles.push_back(vertex(x, y));
+        triangles.push_back(vertex(x + 1, y + 1));
+        triangles.push_back(vertex(x, y + 1));
+      }
+    }
+  }
+  return triangles;
+}
+
+template<typename Bin>
+static double build(const std::vector<SGVertNormTex>& triangles,
+                    Bin& bin, std::list<typename Bin::TriangleVector>& sets)
+{
+  return timeRun([&] {
+    for (size_t i = 0; i + 2 < triangles.size(); i += 3)
+      bin.insert(triangles[i], triangles[i + 1], triangles[i + 2]);
+    bin.getConnectedSets(sets);
+  }).toUSecs();
+}
+
+int main(int argc, char* argv[])
+{
+  const std::vector<SGVertNormTex> triangles = createTriangles();
+
+  double map_time = 0, hash_time = 0;
+  bool match = true;
+  size_t num_vertices = 0, num_sets = 0;
+
+  for (int run = 0; run < num_runs; ++run) {
+    MapTriangleBin map_bin;
+    std::list<MapTriangleBin::TriangleVector> map_sets;
+    map_time += build(triangles, map_bin, map_sets);
+
+    SGTriangleBin<SGVertNormTex> hash_bin;
+    std::list<SGTriangleBin<SGVertNormTex>::TriangleVector> hash_sets;
+    hash_time += build(triangles, hash_bin, hash_sets);
+
+    num_vertices = hash_bin.getNumVertices();
+    num_sets = hash_sets.size();
+    match = match && map_bin.getTriangles() == hash_bin.getTriangles()
+                  && map_sets == hash_sets;
+  }
+
+  std::cout << triangles.size() / 3 << " triangles, "
+            << num_vertices << " unique vertices, "
+            << num_sets << " connected sets\n"
+            << "std::map bins:  " << map_time / num_runs / 1000 << " ms/tile\n"
+            << "hash/CSR bins:  " << hash_time / num_runs / 1000 << " ms/tile\n"
+            << "results " << (match ? "match" : "DIFFER") << std::endl;
+
+  return match ? EXIT_SUCCESS : EXIT_FAILURE;
+}
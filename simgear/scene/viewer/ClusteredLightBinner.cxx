@@ -0,0 +1,256 @@
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+/**
+ * @file
+ * @brief Assignment of lights to the clusters used by clustered shading
+ */
+
+#include <simgear_config.h>
+
+#include "ClusteredLightBinner.hxx"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include <simgear/structure/exception.hxx>
+#include <simgear/threads/SGJobPool.hxx>
+
+namespace simgear::compositor {
+
+namespace {
+
+/**
+ * Test all spheres against two planes. A sphere passes if it is not
+ * completely behind either of them.
+ */
+void testSpheres(const ClusteredLightBinner::SphereList& spheres,
+                 const SGVec4f& a,
+                 const SGVec4f& b,
+                 std::vector<unsigned char>& mask)
+{
+    const size_t n = spheres.size();
+    mask.resize(n);
+
+    const float* x = spheres.x.data();
+    const float* y = spheres.y.data();
+    const float* z = spheres.z.data();
+    const float* r = spheres.radius.data();
+    unsigned char* m = mask.data();
+
+    const float ax = a[0], ay = a[1], az = a[2], aw = a[3];
+    const float bx = b[0], by = b[1], bz = b[2], bw = b[3];
+
+    for (size_t i = 0; i < n; ++i) {
+        const float da = ax * x[i] + ay * y[i] + az * z[i] + aw + r[i];
+        const float db = bx * x[i] + by * y[i] + bz * z[i] + bw + r[i];
+        m[i] = (da > 0.0f) & (db > 0.0f);
+    }
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+
+void
+ClusteredLightBinner::SphereList::clear()
+{
+    x.clear();
+    y.clear();
+    z.clear();
+    radius.clear();
+}
+
+void
+ClusteredLightBinner::SphereList::reserve(size_t n)
+{
+    x.reserve(n);
+    y.reserve(n);
+    z.reserve(n);
+    radius.reserve(n);
+}
+
+void
+ClusteredLightBinner::SphereList::add(float cx, float cy, float cz, float r)
+{
+    x.push_back(cx);
+    y.push_back(cy);
+    z.push_back(cz);
+    radius.push_back(r);
+}
+
+void
+ClusteredLightBinner::Candidates::clear()
+{
+    spheres.clear();
+    index.clear();
+}
+
+//------------------------------------------------------------------------------
+
+void
+ClusteredLightBinner::setGrid(int n_htiles, int n_vtiles, int depth_slices)
+{
+    _n_htiles = n_htiles;
+    _n_vtiles = n_vtiles;
+    _depth_slices = depth_slices;
+
+    _column_planes.resize(2 * n_htiles);
+    _row_planes.resize(2 * n_vtiles);
+    _slices.resize(depth_slices);
+}
+
+void
+ClusteredLightBinner::setColumnPlanes(int x, const SGVec4f& left, const SGVec4f& right)
+{
+    _column_planes[2 * x + 0] = left;
+    _column_planes[2 * x + 1] = right;
+}
+
+void
+ClusteredLightBinner::setRowPlanes(int y, const SGVec4f& bottom, const SGVec4f& top)
+{
+    _row_planes[2 * y + 0] = bottom;
+    _row_planes[2 * y + 1] = top;
+}
+
+void
+ClusteredLightBinner::setDepthRange(float z_near, float z_far)
+{
+    _z_near = z_near;
+    _z_far = z_far;
+}
+
+float
+ClusteredLightBinner::getDepthForSlice(int slice) const
+{
+    return _z_near * std::pow(_z_far / _z_near, float(slice) / _depth_slices);
+}
+
+//------------------------------------------------------------------------------
+
+size_t
+ClusteredLightBinner::assign(float* clusters, float* indices, SGJobPool* pool)
+{
+    auto forEachSlice = [this, pool](const auto& func) {
+        if (pool) {
+            pool->parallelFor(_depth_slices, [&func](size_t slice) {
+                func(static_cast<int>(slice));
+            });
+        } else {
+            for (int slice = 0; slice < _depth_slices; ++slice)
+                func(slice);
+        }
+    };
+
+    forEachSlice([this](int slice) { binSlice(slice); });
+
+    // Slices have been binned into separate buffers, so they can be placed
+    // one after another without any synchronisation during binning.
+    size_t total = 0;
+    for (auto& slice : _slices) {
+        slice.base = total;
+        total += slice.indices.size();
+    }
+
+    if (total >= _max_indices) {
+        throw sg_range_exception(
+            "Clustered shading light index count is over the hardcoded limit ("
+            + std::to_string(_max_indices) + ")");
+    }
+
+    forEachSlice([this, clusters, indices](int slice) {
+        copySlice(slice, clusters, indices);
+    });
+
+    return total;
+}
+
+void
+ClusteredLightBinner::binSlice(int slice)
+{
+    Slice& s = _slices[slice];
+
+    const float near = getDepthForSlice(slice);
+    const float far  = getDepthForSlice(slice + 1);
+    const SGVec4f near_plane(0.0f, 0.0f, -1.0f, -near);
+    const SGVec4f far_plane (0.0f, 0.0f,  1.0f,  far);
+
+    cull(_points, nullptr, near_plane, far_plane, s.mask, s.slice_points);
+    cull(_spots, nullptr, near_plane, far_plane, s.mask, s.slice_spots);
+
+    s.clusters.resize(3 * _n_htiles * _n_vtiles);
+    s.indices.clear();
+
+    for (int y = 0; y < _n_vtiles; ++y) {
+        const SGVec4f& bottom = _row_planes[2 * y + 0];
+        const SGVec4f& top    = _row_planes[2 * y + 1];
+        cull(s.slice_points.spheres, &s.slice_points.index, bottom, top,
+             s.mask, s.row_points);
+        cull(s.slice_spots.spheres, &s.slice_spots.index, bottom, top,
+             s.mask, s.row_spots);
+
+        for (int x = 0; x < _n_htiles; ++x) {
+            const SGVec4f& left  = _column_planes[2 * x + 0];
+            const SGVec4f& right = _column_planes[2 * x + 1];
+            const size_t start = s.indices.size();
+
+            testSpheres(s.row_points.spheres, left, right, s.mask);
+            for (size_t i = 0; i < s.mask.size(); ++i) {
+                if (s.mask[i])
+                    s.indices.push_back(s.row_points.index[i]);
+            }
+            const size_t num_points = s.indices.size() - start;
+
+            testSpheres(s.row_spots.spheres, left, right, s.mask);
+            for (size_t i = 0; i < s.mask.size(); ++i) {
+                if (s.mask[i])
+                    s.indices.push_back(s.row_spots.index[i]);
+            }
+            const size_t num_spots = s.indices.size() - start - num_points;
+
+            float* cluster = &s.clusters[3 * (y * _n_htiles + x)];
+            cluster[0] = float(start); // relative to the slice for now
+            cluster[1] = float(num_points);
+            cluster[2] = float(num_spots);
+        }
+    }
+}
+
+void
+ClusteredLightBinner::copySlice(int slice, float* clusters, float* indices) const
+{
+    const Slice& s = _slices[slice];
+    const size_t num_tiles = _n_htiles * _n_vtiles;
+
+    float* out = clusters + 3 * num_tiles * slice;
+    for (size_t i = 0; i < num_tiles; ++i) {
+        out[3 * i + 0] = s.clusters[3 * i + 0] + float(s.base);
+        out[3 * i + 1] = s.clusters[3 * i + 1];
+        out[3 * i + 2] = s.clusters[3 * i + 2];
+    }
+
+    std::copy(s.indices.begin(), s.indices.end(), indices + s.base);
+}
+
+void
+ClusteredLightBinner::cull(const SphereList& in,
+                           const std::vector<float>* in_index,
+                           const SGVec4f& a,
+                           const SGVec4f& b,
+                           std::vector<unsigned char>& mask,
+                           Candidates& out)
+{
+    testSpheres(in, a, b, mask);
+
+    out.clear();
+    for (size_t i = 0; i < mask.size(); ++i) {
+        if (!mask[i])
+            continue;
+
+        out.spheres.add(in.x[i], in.y[i], in.z[i], in.radius[i]);
+        out.index.push_back(in_index ? (*in_index)[i] : float(i));
+    }
+}
+
+} // namespace simgear::compositor
@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+/**
+ * @file
+ * @brief Assignment of lights to the clusters used by clustered shading
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <simgear/math/SGMath.hxx>
+
+class SGJobPool;
+
+namespace simgear::compositor {
+
+/**
+ * CPU part of clustered shading: find the lights whose bounding spheres
+ * intersect each cluster (tile x depth slice) of the view frustum.
+ *
+ * The side planes of a cluster only depend on its tile column (left/right)
+ * and row (bottom/top), and the near/far planes only on its depth slice.
+ * Lights are therefore culled hierarchically, first against the depth slice,
+ * then against the tile row, and finally against the tile column. Each step
+ * works on a compacted structure of arrays, so the sphere-plane tests are
+ * straight loops the compiler can vectorize.
+ *
+ * Depth slices are independent of each other and are binned as separate
+ * tasks if a SGJobPool is given.
+ */
+class ClusteredLightBinner
+{
+public:
+    /// Bounding spheres in view space as a structure of arrays
+    struct SphereList {
+        std::vector<float> x, y, z, radius;
+
+        void clear();
+        void reserve(size_t n);
+        void add(float cx, float cy, float cz, float r);
+        size_t size() const { return x.size(); }
+    };
+
+    void setGrid(int n_htiles, int n_vtiles, int depth_slices);
+    int numClusters() const { return _n_htiles * _n_vtiles * _depth_slices; }
+
+    /// Left and right plane of all tiles in column @a x (view space)
+    void setColumnPlanes(int x, const SGVec4f& left, const SGVec4f& right);
+    /// Bottom and top plane of all tiles in row @a y (view space)
+    void setRowPlanes(int y, const SGVec4f& bottom, const SGVec4f& top);
+
+    void setDepthRange(float z_near, float z_far);
+    float getDepthForSlice(int slice) const;
+
+    /// Maximum number of light indices which fit into the output buffer
+    void setMaxIndices(size_t max_indices) { _max_indices = max_indices; }
+
+    SphereList& pointLights() { return _points; }
+    SphereList& spotLights() { return _spots; }
+
+    /**
+     * Assign all lights to the clusters.
+     *
+     * @param clusters  Three floats per cluster, with clusters ordered by
+     *                  column, row and slice (x varying fastest): offset
+     *                  into @a indices, number of point lights and number of
+     *                  spot lights.
+     * @param indices   Light indices, for each cluster the point lights
+     *                  followed by the spot lights
+     * @param pool      Optional pool to bin depth slices in parallel
+     *
+     * @return Number of indices written
+     * @throw sg_range_exception if the maximum number of indices or more
+     *        would be required
+     */
+    size_t assign(float* clusters, float* indices, SGJobPool* pool = nullptr);
+
+private:
+    /// Spheres remaining after a culling step, with their original index
+    struct Candidates {
+        SphereList spheres;
+        std::vector<float> index;
+
+        void clear();
+    };
+
+    /// Per slice working memory and results, reused between frames
+    struct Slice {
+        Candidates slice_points, slice_spots,
+                   row_points, row_spots;
+        std::vector<unsigned char> mask;
+        std::vector<float> clusters;
+        std::vector<float> indices;
+        size_t base = 0;
+    };
+
+    void binSlice(int slice);
+    void copySlice(int slice, float* clusters, float* indices) const;
+
+    static void cull(const SphereList& in,
+                     const std::vector<float>* in_index,
+                     const SGVec4f& a,
+                     const SGVec4f& b,
+                     std::vector<unsigned char>& mask,
+                     Candidates& out);
+
+    int _n_htiles = 0;
+    int _n_vtiles = 0;
+    int _depth_slices = 0;
+    float _z_near = 0.0f;
+    float _z_far = 0.0f;
+    size_t _max_indices = 0;
+
+    std::vector<SGVec4f> _column_planes; ///< left, right per column
+    std::vector<SGVec4f> _row_planes;    ///< bottom, top per row
+
+    SphereList _points;
+    SphereList _spots;
+
+    std::vector<Slice> _slices;
+};
+
+} // namespace simgear::compositor
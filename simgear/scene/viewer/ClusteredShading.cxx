@@ -41,13 +41,16 @@ ClusteredShading::ClusteredShading(vsg::Camera *camera,
             _depth_slices = _num_threads;
     }
 
-    _slices_per_thread = _depth_slices / _num_threads;
-    if (_slices_per_thread == 0) {
+    if (_num_threads > _depth_slices) {
         SG_LOG(SG_INPUT, SG_INFO, "ClusteredShading::ClusteredShading(): "
                "More threads than depth slices");
         _num_threads = _depth_slices;
     }
-    _slices_remainder = _depth_slices % _num_threads;
+    // The thread calling update() takes part in the work
+    if (_num_threads > 1)
+        _jobs = std::make_unique<SGJobPool>(_num_threads - 1);
+
+    _binner.setMaxIndices(size_t(_max_light_indices) * _max_light_indices);
 
     _slice_scale = new osg::Uniform("fg_ClusteredSliceScale", 0.0f);
     _slice_bias = new osg::Uniform("fg_ClusteredSliceBias", 0.0f);
@@ -204,24 +207,14 @@ ClusteredShading::update(const SGLightList &light_list)
     recreateSubfrustaIfNeeded();
     updateUniforms();
     updateSubfrusta();
+    updateLightSpheres();
 
-    _global_light_count = 0;
-
-    if (_depth_slices == 1) {
-        // Just run the light assignment on the main thread to avoid the
-        // unnecessary threading overhead.
-        assignLightsToSlice(0);
-    } else if (_num_threads == 1) {
-        // Again, avoid the unnecessary threading overhead
-        threadFunc(0);
-    } else {
-        std::vector<std::thread> threads;
-        threads.reserve(_num_threads);
-        for (int i = 0; i < _num_threads; ++i)
-            threads.emplace_back(&ClusteredShading::threadFunc, this, i);
-
-        for (auto &t : threads) t.join();
-    }
+    // Depth slices are binned as separate tasks on the persistent job pool.
+    // Without a pool (single thread or single slice) everything runs on the
+    // calling thread, avoiding any threading overhead.
+    _binner.assign(reinterpret_cast<GLfloat *>(_clusters->data()),
+                   reinterpret_cast<GLfloat *>(_indices->data()),
+                   _jobs.get());
 
     // Force upload of the image data
     _clusters->dirty();
@@ -322,7 +315,7 @@ ClusteredShading::recreateSubfrustaIfNeeded()
 
         _clusters->allocateImage(_n_htiles, _n_vtiles, _depth_slices,
                                  GL_RGB, GL_FLOAT);
-        _subfrusta.reset(new Subfrustum[_n_htiles * _n_vtiles]);
+        _binner.setGrid(_n_htiles, _n_vtiles, _depth_slices);
     }
 }
 
@@ -331,6 +324,7 @@ ClusteredShading::updateUniforms()
 {
     float l = 0.f, r = 0.f, b = 0.f, t = 0.f;
     _camera->getProjectionMatrix().getFrustum(l, r, b, t, _zNear, _zFar);
+    _binner.setDepthRange(_zNear, _zFar);
 
     _slice_scale->set(_depth_slices / std::log2(_zFar / _zNear));
     _slice_bias->set(-_depth_slices * std::log2(_zNear) / std::log2(_zFar / _zNear));
@@ -342,126 +336,54 @@ ClusteredShading::updateUniforms()
 void
 ClusteredShading::updateSubfrusta()
 {
+    // The side planes of a tile subfrustum only depend on its column
+    // (left/right) or row (bottom/top). The near and far planes are handled
+    // by the binner as they change from slice to slice.
+    auto toViewSpace = [this](vsg::vec4 p) {
+        // Transform from clip space to view space
+        p = _camera->getProjectionMatrix() * p;
+        float inv_length = 1.0f / sqrtf(p._v[0]*p._v[0] +
+                                        p._v[1]*p._v[1] +
+                                        p._v[2]*p._v[2]);
+        p *= inv_length;
+        return SGVec4f(p._v[0], p._v[1], p._v[2], p._v[3]);
+    };
+
+    for (int x = 0; x < _n_htiles; ++x) {
+        float xmin = -1.0f + _x_step * float(x);
+        float xmax = xmin  + _x_step;
+        _binner.setColumnPlanes(x,
+            toViewSpace(vsg::vec4(1.0f,0.0f,0.0f,-xmin)),  // left plane.
+            toViewSpace(vsg::vec4(-1.0f,0.0f,0.0f,xmax))); // right plane.
+    }
+
     for (int y = 0; y < _n_vtiles; ++y) {
         float ymin = -1.0f + _y_step * float(y);
         float ymax = ymin  + _y_step;
-        for (int x = 0; x < _n_htiles; ++x) {
-            float xmin = -1.0f + _x_step * float(x);
-            float xmax = xmin  + _x_step;
-
-            // Create the subfrustum in clip space
-            // The near and far planes will be filled later as they change from
-            // slice to slice
-            Subfrustum &subfrustum = _subfrusta[y*_n_htiles + x];
-            subfrustum.plane[0].set(1.0f,0.0f,0.0f,-xmin); // left plane.
-            subfrustum.plane[1].set(-1.0f,0.0f,0.0f,xmax); // right plane.
-            subfrustum.plane[2].set(0.0f,1.0f,0.0f,-ymin); // bottom plane.
-            subfrustum.plane[3].set(0.0f,-1.0f,0.0f,ymax); // top plane.
-
-            // Transform it to view space
-            for (int i = 0; i < 4; ++i) {
-                vsg::vec4 &p = subfrustum.plane[i];
-                p = _camera->getProjectionMatrix() * p;
-                float inv_length = 1.0f / sqrtf(p._v[0]*p._v[0] +
-                                                p._v[1]*p._v[1] +
-                                                p._v[2]*p._v[2]);
-                p *= inv_length;
-            }
-        }
+        _binner.setRowPlanes(y,
+            toViewSpace(vsg::vec4(0.0f,1.0f,0.0f,-ymin)),  // bottom plane.
+            toViewSpace(vsg::vec4(0.0f,-1.0f,0.0f,ymax))); // top plane.
     }
 }
 
 void
-ClusteredShading::threadFunc(int thread_id)
+ClusteredShading::updateLightSpheres()
 {
-    for (int i = 0; i < _slices_per_thread; ++i)
-        assignLightsToSlice(thread_id * _slices_per_thread + i);
-
-    if (_slices_remainder > thread_id)
-        assignLightsToSlice(_slices_per_thread * _num_threads + thread_id);
-}
-
-void
-ClusteredShading::assignLightsToSlice(int slice)
-{
-    size_t z_offset = slice * _n_htiles * _n_vtiles;
-
-    float near = getDepthForSlice(slice);
-    float far  = getDepthForSlice(slice + 1);
-
-    vsg::vec4 near_plane(0.0f, 0.0f, -1.0f, -near);
-    vsg::vec4 far_plane (0.0f, 0.0f,  1.0f,  far);
-
-    GLfloat *clusters = reinterpret_cast<GLfloat *>(_clusters->data());
-    GLfloat *indices  = reinterpret_cast<GLfloat *>(_indices->data());
-
-    for (int i = 0; i < (_n_htiles * _n_vtiles); ++i) {
-        Subfrustum subfrustum = _subfrusta[i];
-        subfrustum.plane[4] = near_plane;
-        subfrustum.plane[5] = far_plane;
-
-        GLint start_offset = _global_light_count;
-        GLint local_point_count = 0;
-        GLint local_spot_count = 0;
-
-        // Test point lights
-        for (GLushort point_iterator = 0;
-             point_iterator < _point_bounds.size();
-             ++point_iterator) {
-            PointlightBound point = _point_bounds[point_iterator];
-
-            // Perform frustum-sphere collision tests
-            float distance = 0.0f;
-            for (int n = 0; n < 6; ++n) {
-                distance = subfrustum.plane[n] * point.position + point.range;
-                if (distance <= 0.0f)
-                    break;
-            }
-
-            if (distance > 0.0f) {
-                indices[_global_light_count] = GLfloat(point_iterator);
-                ++local_point_count;
-                ++_global_light_count; // Atomic increment
-            }
-
-            if (_global_light_count >= (_max_light_indices * _max_light_indices)) {
-                throw sg_range_exception(
-                    "Clustered shading light index count is over the hardcoded limit ("
-                    + std::to_string(_max_light_indices * _max_light_indices) + ")");
-            }
-        }
-
-        // Test spot lights
-        for (GLushort spot_iterator = 0;
-             spot_iterator < _spot_bounds.size();
-             ++spot_iterator) {
-            SpotlightBound spot = _spot_bounds[spot_iterator];
-
-            // Perform frustum-sphere collision tests
-            float distance = 0.0f;
-            for (int n = 0; n < 6; ++n) {
-                distance = subfrustum.plane[n] * spot.bounding_sphere.center
-                    + spot.bounding_sphere.radius;
-                if (distance <= 0.0f)
-                    break;
-            }
-
-            if (distance > 0.0f) {
-                indices[_global_light_count] = GLfloat(spot_iterator);
-                ++local_spot_count;
-                ++_global_light_count; // Atomic increment
-            }
-
-            if (_global_light_count >= (_max_light_indices * _max_light_indices)) {
-                throw sg_range_exception(
-                    "Clustered shading light index count is over the hardcoded limit ("
-                    + std::to_string(_max_light_indices * _max_light_indices) + ")");
-            }
-        }
+    auto &points = _binner.pointLights();
+    points.clear();
+    points.reserve(_point_bounds.size());
+    for (const auto &point : _point_bounds) {
+        points.add(point.position.x(), point.position.y(), point.position.z(),
+                   point.range);
+    }
 
-        clusters[(z_offset + i) * 3 + 0] = GLfloat(start_offset);
-        clusters[(z_offset + i) * 3 + 1] = GLfloat(local_point_count);
-        clusters[(z_offset + i) * 3 + 2] = GLfloat(local_spot_count);
+    auto &spots = _binner.spotLights();
+    spots.clear();
+    spots.reserve(_spot_bounds.size());
+    for (const auto &spot : _spot_bounds) {
+        const auto &sphere = spot.bounding_sphere;
+        spots.add(sphere.center.x(), sphere.center.y(), sphere.center.z(),
+                  sphere.radius);
     }
 }
 
@@ -607,12 +529,4 @@ ClusteredShading::writeSpotlightDataPBR()
     _spotlights->dirty();
 }
 
-//------------------------------------------------------------------------------
-
-float
-ClusteredShading::getDepthForSlice(int slice) const
-{
-    return _zNear * pow(_zFar / _zNear, float(slice) / _depth_slices);
-}
-
 } // namespace simgear::compositor
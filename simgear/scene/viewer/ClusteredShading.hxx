@@ -3,7 +3,7 @@
 
 #pragma once
 
-#include <atomic>
+#include <memory>
 
 #include <vsg/all.h>
 
@@ -12,6 +12,9 @@
 #include <osg/Uniform>
 
 #include <simgear/scene/model/SGLight.hxx>
+#include <simgear/threads/SGJobPool.hxx>
+
+#include "ClusteredLightBinner.hxx"
 
 
 namespace simgear::compositor {
@@ -30,13 +33,6 @@ public:
     void update(const SGLightList& light_list);
 
 protected:
-    // We could make use of osg::Polytope, but it does a lot of std::vector
-    // push_back() calls, so we make our own frustum structure for huge
-    // performance gains.
-    struct Subfrustum {
-        vsg::vec4 plane[6];
-    };
-
     struct PointlightBound {
         SGLight* light = nullptr;
         vsg::vec4 position;
@@ -58,13 +54,11 @@ protected:
     void recreateSubfrustaIfNeeded();
     void updateUniforms();
     void updateSubfrusta();
-    void threadFunc(int thread_id);
-    void assignLightsToSlice(int slice);
+    void updateLightSpheres();
     void writePointlightData();
     void writeSpotlightData();
     void writePointlightDataPBR();
     void writeSpotlightDataPBR();
-    float getDepthForSlice(int slice) const;
 
     osg::observer_ptr<vsg::Camera> _camera;
 
@@ -81,8 +75,6 @@ protected:
     int _tile_size = 0;
     int _depth_slices = 0;
     int _num_threads = 0;
-    int _slices_per_thread = 0;
-    int _slices_remainder = 0;
 
     float _zNear = 0.0f;
     float _zFar = 0.0f;
@@ -106,12 +98,13 @@ protected:
     vsg::ref_ptr<osg::Texture2D> _pointlights_tex;
     vsg::ref_ptr<osg::Texture2D> _spotlights_tex;
 
-    std::unique_ptr<Subfrustum[]> _subfrusta;
-
     std::vector<PointlightBound> _point_bounds;
     std::vector<SpotlightBound> _spot_bounds;
 
-    std::atomic<int> _global_light_count;
+    ClusteredLightBinner _binner;
+    // Persistent worker threads for binning depth slices in parallel, only
+    // created if more than one thread has been requested.
+    std::unique_ptr<SGJobPool> _jobs;
 };
 
 } // namespace simgear::compositor
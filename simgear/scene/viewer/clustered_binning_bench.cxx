@@ -0,0 +1,185 @@
+// SPDX-License-Identifier: LGPL-2.0-or-later
+
+/**
+ * @file
+ * @brief Benchmark assigning lights to the clusters used by clustered shading
+ */
+
+#include <simgear_config.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <simgear/misc/test_timing.hxx>
+#include <simgear/threads/SGJobPool.hxx>
+
+#include "ClusteredLightBinner.hxx"
+
+using simgear::compositor::ClusteredLightBinner;
+
+static const int num_point_lights = 8000;
+static const int num_spot_lights = 2000;
+static const int num_frames = 20;
+
+// 1920x1080 viewport with 128 pixel tiles
+static const int width = 1920;
+static const int height = 1080;
+static const int tile_size = 128;
+static const int depth_slices = 16;
+
+static const float z_near = 0.1f;
+static const float z_far = 5000.0f;
+
+static SGVec4f normalized(const SGVec4f& p)
+{
+    return (1.0f / std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2])) * p;
+}
+
+/**
+ * Straightforward binning as previously done by ClusteredShading: test every
+ * light against all six planes of every cluster.
+ */
+static size_t bruteForce(ClusteredLightBinner& binner,
+                         const std::vector<SGVec4f>& columns,
+                         const std::vector<SGVec4f>& rows,
+                         int n_htiles, int n_vtiles,
+                         std::vector<float>& clusters,
+                         std::vector<float>& indices)
+{
+    size_t count = 0;
+    for (int slice = 0; slice < depth_slices; ++slice) {
+        SGVec4f planes[6];
+        planes[4] = SGVec4f(0, 0, -1, -binner.getDepthForSlice(slice));
+        planes[5] = SGVec4f(0, 0, 1, binner.getDepthForSlice(slice + 1));
+
+        for (int y = 0; y < n_vtiles; ++y) {
+            planes[2] = rows[2 * y];
+            planes[3] = rows[2 * y + 1];
+            for (int x = 0; x < n_htiles; ++x) {
+                planes[0] = columns[2 * x];
+                planes[1] = columns[2 * x + 1];
+
+                float* cluster = &clusters[3 * ((slice * n_vtiles + y) * n_htiles + x)];
+                cluster[0] = float(count);
+
+                int counts[2] = {0, 0};
+                ClusteredLightBinner::SphereList* lists[2] = {
+                    &binner.pointLights(), &binner.spotLights()};
+                for (int l = 0; l < 2; ++l) {
+                    const auto& s = *lists[l];
+                    for (size_t i = 0; i < s.size(); ++i) {
+                        float distance = 0.0f;
+                        for (int n = 0; n < 6; ++n) {
+                            distance = planes[n][0] * s.x[i] + planes[n][1] * s.y[i]
+                                + planes[n][2] * s.z[i] + planes[n][3] + s.radius[i];
+                            if (distance <= 0.0f)
+                                break;
+                        }
+                        if (distance > 0.0f) {
+                            indices[count++] = float(i);
+                            ++counts[l];
+                        }
+                    }
+                }
+                cluster[1] = float(counts[0]);
+                cluster[2] = float(counts[1]);
+            }
+        }
+    }
+    return count;
+}
+
+int main(int argc, char* argv[])
+{
+    const int n_htiles = (width + tile_size - 1) / tile_size;
+    const int n_vtiles = (height + tile_size - 1) / tile_size;
+    const float x_step = (tile_size / float(width)) * 2.0f;
+    const float y_step = (tile_size / float(height)) * 2.0f;
+
+    // Symmetric perspective projection, 60 degrees vertical field of view
+    const float f = 1.0f / std::tan(SGMiscf::deg2rad(30.0f));
+    const float aspect = float(width) / height;
+
+    std::vector<SGVec4f> columns, rows;
+    ClusteredLightBinner binner;
+    binner.setGrid(n_htiles, n_vtiles, depth_slices);
+    binner.setDepthRange(z_near, z_far);
+    binner.setMaxIndices(size_t(1) << 26);
+
+    for (int x = 0; x < n_htiles; ++x) {
+        float xmin = -1.0f + x_step * x, xmax = xmin + x_step;
+        columns.push_back(normalized(SGVec4f(f / aspect, 0, xmin, 0)));
+        columns.push_back(normalized(SGVec4f(-f / aspect, 0, -xmax, 0)));
+        binner.setColumnPlanes(x, columns[2 * x], columns[2 * x + 1]);
+    }
+    for (int y = 0; y < n_vtiles; ++y) {
+        float ymin = -1.0f + y_step * y, ymax = ymin + y_step;
+        rows.push_back(normalized(SGVec4f(0, f, ymin, 0)));
+        rows.push_back(normalized(SGVec4f(0, -f, -ymax, 0)));
+        binner.setRowPlanes(y, rows[2 * y], rows[2 * y + 1]);
+    }
+
+    // Lights spread over the visible area, denser close to the viewer
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> log_depth(std::log(1.0f), std::log(3000.0f));
+    std::uniform_real_distribution<float> range(1.0f, 20.0f);
+
+    auto addLights = [&](ClusteredLightBinner::SphereList& list, int count) {
+        for (int i = 0; i < count; ++i) {
+            float depth = std::exp(log_depth(rng));
+            list.add(unit(rng) * depth * aspect / f,
+                     unit(rng) * depth / f,
+                     -depth,
+                     range(rng));
+        }
+    };
+    addLights(binner.pointLights(), num_point_lights);
+    addLights(binner.spotLights(), num_spot_lights);
+
+    std::vector<float> clusters(3 * binner.numClusters());
+    std::vector<float> indices(size_t(1) << 26);
+    std::vector<float> ref_clusters(clusters.size());
+    std::vector<float> ref_indices(indices.size());
+
+    size_t ref_count = 0;
+    double brute_force = timeRun([&] {
+        for (int i = 0; i < num_frames; ++i)
+            ref_count = bruteForce(binner, columns, rows, n_htiles, n_vtiles,
+                                   ref_clusters, ref_indices);
+    }).toUSecs() / num_frames;
+
+    // first run allocates the per slice buffers
+    size_t count = binner.assign(clusters.data(), indices.data());
+
+    double serial = timeRun([&] {
+        for (int i = 0; i < num_frames; ++i)
+            count = binner.assign(clusters.data(), indices.data());
+    }).toUSecs() / num_frames;
+
+    SGJobPool pool(SGJobPool::defaultNumWorkers());
+    double parallel = timeRun([&] {
+        for (int i = 0; i < num_frames; ++i)
+            count = binner.assign(clusters.data(), indices.data(), &pool);
+    }).toUSecs() / num_frames;
+
+    const bool match = count == ref_count
+        && std::equal(clusters.begin(), clusters.end(), ref_clusters.begin())
+        && std::equal(indices.begin(), indices.begin() + count, ref_indices.begin());
+
+    std::cout << num_point_lights << " point lights, "
+              << num_spot_lights << " spot lights, "
+              << n_htiles << "x" << n_vtiles << "x" << depth_slices
+              << " clusters, " << count << " indices\n"
+              << "brute force (1 thread):   " << brute_force << " us/frame\n"
+              << "binner (1 thread):        " << serial << " us/frame\n"
+              << "binner (" << pool.concurrency() << " threads):       "
+              << parallel << " us/frame\n"
+              << "results " << (match ? "match" : "DIFFER") << std::endl;
+
+    return match ? EXIT_SUCCESS : EXIT_FAILURE;
+}
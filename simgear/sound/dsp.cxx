@@ -0,0 +1,352 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Block based audio DSP kernels
+ */
+
+#include <simgear_config.h>
+
+#include "dsp.hxx"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define SG_DSP_SSE2 1
+# include <emmintrin.h>
+#endif
+#if defined(__AVX__)
+# define SG_DSP_AVX 1
+# include <immintrin.h>
+#endif
+#if defined(__AVX2__)
+# define SG_DSP_AVX2 1
+#endif
+
+namespace simgear {
+namespace dsp {
+
+namespace {
+
+const float Int16Scale = 32768.0f;
+const float Int16InvScale = 1.0f / 32768.0f;
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+// Scalar reference versions
+
+namespace scalar {
+
+void int16ToFloat(const int16_t* in, float* out, size_t num)
+{
+    for (size_t i = 0; i < num; ++i)
+        out[i] = static_cast<float>(in[i]) * Int16InvScale;
+}
+
+void floatToInt16(const float* in, int16_t* out, size_t num)
+{
+    for (size_t i = 0; i < num; ++i) {
+        float smp = in[i] * Int16Scale;
+        smp = smp < -32768.0f ? -32768.0f : smp;
+        smp = smp > 32767.0f ? 32767.0f : smp;
+        out[i] = static_cast<int16_t>(lrintf(smp));
+    }
+}
+
+void biquad(float* data, size_t num, const float* coeff, float* hist,
+            unsigned int stages, float gain)
+{
+    float k = gain;
+    for (unsigned int stage = 0; stage < stages; ++stage) {
+        const float* c = coeff + 4 * stage;
+        float h0 = hist[2 * stage + 0];
+        float h1 = hist[2 * stage + 1];
+        for (size_t i = 0; i < num; ++i) {
+            float nsmp, smp = data[i] * k;
+            smp  = smp  + h0 * c[0];
+            nsmp = smp  + h1 * c[1];
+            smp  = nsmp + h0 * c[2];
+            smp  = smp  + h1 * c[3];
+
+            h1 = h0;
+            h0 = nsmp;
+            data[i] = smp;
+        }
+        hist[2 * stage + 0] = h0;
+        hist[2 * stage + 1] = h1;
+        k = 1.0f;
+    }
+}
+
+void bitCrush(float* data, size_t num, float step)
+{
+    const float inv = 1.0f / step;
+    for (size_t i = 0; i < num; ++i)
+        data[i] = truncf(data[i] * inv) * step;
+}
+
+void mix(float* dst, const float* src, size_t num, float gain)
+{
+    for (size_t i = 0; i < num; ++i)
+        dst[i] = dst[i] + src[i] * gain;
+}
+
+void byteSwap16(uint16_t* data, size_t num)
+{
+    for (size_t i = 0; i < num; ++i)
+        data[i] = static_cast<uint16_t>((data[i] << 8) | (data[i] >> 8));
+}
+
+} // namespace scalar
+
+//------------------------------------------------------------------------------
+// Vectorised versions, the tails of the blocks are left to the scalar ones
+
+void int16ToFloat(const int16_t* in, float* out, size_t num)
+{
+    size_t i = 0;
+#if defined(SG_DSP_AVX2)
+    const __m256 scale = _mm256_set1_ps(Int16InvScale);
+    for (; i + 8 <= num; i += 8) {
+        __m128i smp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        __m256 f = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(smp));
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(f, scale));
+    }
+#elif defined(SG_DSP_SSE2)
+    const __m128 scale = _mm_set1_ps(Int16InvScale);
+    for (; i + 8 <= num; i += 8) {
+        __m128i smp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        // sign extend by unpacking into the upper halves and shifting down
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(smp, smp), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(smp, smp), 16);
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+#endif
+    scalar::int16ToFloat(in + i, out + i, num - i);
+}
+
+void floatToInt16(const float* in, int16_t* out, size_t num)
+{
+    size_t i = 0;
+#if defined(SG_DSP_SSE2)
+    const __m128 scale = _mm_set1_ps(Int16Scale);
+    const __m128 lower = _mm_set1_ps(-32768.0f);
+    const __m128 upper = _mm_set1_ps(32767.0f);
+    for (; i + 8 <= num; i += 8) {
+        __m128 a = _mm_mul_ps(_mm_loadu_ps(in + i), scale);
+        __m128 b = _mm_mul_ps(_mm_loadu_ps(in + i + 4), scale);
+        a = _mm_min_ps(_mm_max_ps(a, lower), upper);
+        b = _mm_min_ps(_mm_max_ps(b, lower), upper);
+        // converts with the current (round to nearest) rounding mode, as lrintf
+        __m128i smp = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), smp);
+    }
+#endif
+    scalar::floatToInt16(in + i, out + i, num - i);
+}
+
+#if defined(SG_DSP_SSE2)
+namespace {
+
+/**
+ * Biquad cascade with one stage per SSE lane. The stages form a pipeline:
+ * in every step lane s processes sample j - s, the output of lane s in one
+ * step becomes the input of lane s + 1 in the next. Unused lanes have zero
+ * coefficients, and pass their input through unchanged.
+ */
+class BiquadPipeline
+{
+public:
+    BiquadPipeline(const float* coeff, const float* hist, unsigned int stages, float gain)
+    {
+        float c[4][4] = {}, h[2][4] = {};
+        for (unsigned int s = 0; s < stages; ++s) {
+            for (int k = 0; k < 4; ++k)
+                c[k][s] = coeff[4 * s + k];
+            h[0][s] = hist[2 * s + 0];
+            h[1][s] = hist[2 * s + 1];
+        }
+        for (int k = 0; k < 4; ++k)
+            _c[k] = _mm_loadu_ps(c[k]);
+        _h0 = _mm_loadu_ps(h[0]);
+        _h1 = _mm_loadu_ps(h[1]);
+        _k = _mm_setr_ps(gain, 1.0f, 1.0f, 1.0f);
+        _out = _mm_setzero_ps();
+    }
+
+    /// Feed the next input sample into the first stage
+    void step(float x)
+    {
+        const __m128 nsmp = compute(input(x));
+        _h1 = _h0;
+        _h0 = nsmp;
+    }
+
+    /// As step(), updating only the lanes set in @a active
+    void step(float x, __m128 active)
+    {
+        const __m128 nsmp = compute(input(x));
+        _h1 = select(active, _h0, _h1);
+        _h0 = select(active, nsmp, _h0);
+    }
+
+    /// Output of the last stage
+    float output() const
+    {
+        return _mm_cvtss_f32(_mm_shuffle_ps(_out, _out, _MM_SHUFFLE(3, 3, 3, 3)));
+    }
+
+    void store(float* hist, unsigned int stages) const
+    {
+        float h[2][4];
+        _mm_storeu_ps(h[0], _h0);
+        _mm_storeu_ps(h[1], _h1);
+        for (unsigned int s = 0; s < stages; ++s) {
+            hist[2 * s + 0] = h[0][s];
+            hist[2 * s + 1] = h[1][s];
+        }
+    }
+
+private:
+    __m128 input(float x) const
+    {
+        // shift the outputs up by one stage, and x into the first one
+        __m128 shifted = _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(_out), 4));
+        return _mm_move_ss(shifted, _mm_set_ss(x));
+    }
+
+    __m128 compute(__m128 x)
+    {
+        // same operations as scalar::biquad()
+        __m128 smp = _mm_mul_ps(x, _k);
+        smp = _mm_add_ps(smp, _mm_mul_ps(_h0, _c[0]));
+        const __m128 nsmp = _mm_add_ps(smp, _mm_mul_ps(_h1, _c[1]));
+        smp = _mm_add_ps(nsmp, _mm_mul_ps(_h0, _c[2]));
+        _out = _mm_add_ps(smp, _mm_mul_ps(_h1, _c[3]));
+        return nsmp;
+    }
+
+    static __m128 select(__m128 mask, __m128 a, __m128 b)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    __m128 _c[4];
+    __m128 _h0, _h1, _k, _out;
+};
+
+/// Lanes processing a sample inside [0, num) in step j
+__m128 activeLanes(size_t j, size_t num)
+{
+    int lanes[4];
+    for (size_t s = 0; s < 4; ++s)
+        lanes[s] = (j >= s && j - s < num) ? -1 : 0;
+    return _mm_castsi128_ps(_mm_setr_epi32(lanes[0], lanes[1], lanes[2], lanes[3]));
+}
+
+} // anonymous namespace
+#endif
+
+void biquad(float* data, size_t num, const float* coeff, float* hist,
+            unsigned int stages, float gain)
+{
+#if defined(SG_DSP_SSE2)
+    if (stages >= 2 && stages <= MaxBiquadStages) {
+        BiquadPipeline pipeline(coeff, hist, stages, gain);
+        const size_t latency = MaxBiquadStages - 1;
+
+        // Fill the pipeline, run it full, then drain it. Sample j - latency
+        // leaves the last stage in step j, so it can be written back in place.
+        size_t j = 0;
+        for (; j < latency; ++j)
+            pipeline.step(j < num ? data[j] : 0.0f, activeLanes(j, num));
+        for (; j < num; ++j) {
+            pipeline.step(data[j]);
+            data[j - latency] = pipeline.output();
+        }
+        for (; j < num + latency; ++j) {
+            pipeline.step(j < num ? data[j] : 0.0f, activeLanes(j, num));
+            data[j - latency] = pipeline.output();
+        }
+
+        pipeline.store(hist, stages);
+        return;
+    }
+#endif
+    scalar::biquad(data, num, coeff, hist, stages, gain);
+}
+
+void bitCrush(float* data, size_t num, float step)
+{
+    size_t i = 0;
+    const float inv = 1.0f / step;
+#if defined(SG_DSP_AVX)
+    const __m256 vinv = _mm256_set1_ps(inv);
+    const __m256 vstep = _mm256_set1_ps(step);
+    for (; i + 8 <= num; i += 8) {
+        __m256 smp = _mm256_mul_ps(_mm256_loadu_ps(data + i), vinv);
+        smp = _mm256_round_ps(smp, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+        _mm256_storeu_ps(data + i, _mm256_mul_ps(smp, vstep));
+    }
+#elif defined(SG_DSP_SSE2)
+    const __m128 vinv = _mm_set1_ps(inv);
+    const __m128 vstep = _mm_set1_ps(step);
+    for (; i + 4 <= num; i += 4) {
+        __m128 smp = _mm_mul_ps(_mm_loadu_ps(data + i), vinv);
+        smp = _mm_cvtepi32_ps(_mm_cvttps_epi32(smp));
+        _mm_storeu_ps(data + i, _mm_mul_ps(smp, vstep));
+    }
+#endif
+    for (; i < num; ++i)
+        data[i] = truncf(data[i] * inv) * step;
+}
+
+void mix(float* dst, const float* src, size_t num, float gain)
+{
+    size_t i = 0;
+#if defined(SG_DSP_AVX)
+    const __m256 vgain = _mm256_set1_ps(gain);
+    for (; i + 8 <= num; i += 8) {
+        __m256 smp = _mm256_mul_ps(_mm256_loadu_ps(src + i), vgain);
+        _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), smp));
+    }
+#elif defined(SG_DSP_SSE2)
+    const __m128 vgain = _mm_set1_ps(gain);
+    for (; i + 4 <= num; i += 4) {
+        __m128 smp = _mm_mul_ps(_mm_loadu_ps(src + i), vgain);
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), smp));
+    }
+#endif
+    scalar::mix(dst + i, src + i, num - i, gain);
+}
+
+void byteSwap16(uint16_t* data, size_t num)
+{
+    size_t i = 0;
+#if defined(SG_DSP_SSE2)
+    for (; i + 8 <= num; i += 8) {
+        __m128i smp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        smp = _mm_or_si128(_mm_slli_epi16(smp, 8), _mm_srli_epi16(smp, 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), smp);
+    }
+#endif
+    scalar::byteSwap16(data + i, num - i);
+}
+
+const char* instructionSet()
+{
+#if defined(SG_DSP_AVX2)
+    return "AVX2";
+#elif defined(SG_DSP_AVX)
+    return "AVX";
+#elif defined(SG_DSP_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace dsp
+} // namespace simgear
@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Block based audio DSP kernels
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace simgear {
+namespace dsp {
+
+/**
+ * Kernels working on blocks of samples, vectorised with SSE2 or AVX(2) when
+ * the compiler targets them (see ENABLE_SIMD), and plain C++ otherwise.
+ *
+ * Float samples are normalised to [-1, 1). The vectorised kernels perform
+ * the same floating point operations as the scalar reference versions in
+ * dsp::scalar, in the same order, so they give the same results.
+ */
+
+/// Maximum number of 2nd order sections of a biquad cascade
+const unsigned int MaxBiquadStages = 4;
+
+/// Convert 16 bit samples to float
+void int16ToFloat(const int16_t* in, float* out, size_t num);
+
+/// Convert float samples to 16 bit, rounding to nearest and saturating
+void floatToInt16(const float* in, int16_t* out, size_t num);
+
+/**
+ * Run @a data through a cascade of up to MaxBiquadStages biquad sections
+ * in direct form II, the input scaled by @a gain.
+ *
+ * @param coeff  four coefficients per stage: the negated feedback
+ *               coefficients b1, b2 and the feed forward coefficients
+ *               a1, a2, all normalised to b0 = a0 = 1
+ * @param hist   two history values per stage, updated for the next block
+ */
+void biquad(float* data, size_t num, const float* coeff, float* hist,
+            unsigned int stages, float gain);
+
+/// Truncate samples towards zero to multiples of @a step
+void bitCrush(float* data, size_t num, float step);
+
+/// Add @a src scaled by @a gain to @a dst
+void mix(float* dst, const float* src, size_t num, float gain);
+
+/// Swap the byte order of 16 bit samples
+void byteSwap16(uint16_t* data, size_t num);
+
+/// Instruction set used by the kernels: "AVX2", "AVX", "SSE2" or "scalar"
+const char* instructionSet();
+
+/// Reference versions of the kernels, processing one sample at a time
+namespace scalar {
+
+void int16ToFloat(const int16_t* in, float* out, size_t num);
+void floatToInt16(const float* in, int16_t* out, size_t num);
+void biquad(float* data, size_t num, const float* coeff, float* hist,
+            unsigned int stages, float gain);
+void bitCrush(float* data, size_t num, float step);
+void mix(float* dst, const float* src, size_t num, float gain);
+void byteSwap16(uint16_t* data, size_t num);
+
+} // namespace scalar
+
+} // namespace dsp
+} // namespace simgear
@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Benchmark the vectorised audio DSP kernels against the scalar ones
+ */
+
+#include <simgear_config.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <simgear/misc/test_timing.hxx>
+
+#include "dsp.hxx"
+
+using namespace simgear;
+
+// A few hundred sources of one 20 ms block each at 48 kHz
+static const size_t num_sources = 256;
+static const size_t block_size = 960;
+static const int num_runs = 7;
+
+/// Best throughput of @a kernel over all sources, in million samples per second
+static double throughput(const std::function<void(size_t source)>& kernel)
+{
+    const double best = bestRun(num_runs, [&] {
+        for (size_t s = 0; s < num_sources; ++s)
+            kernel(s);
+    }).toUSecs();
+    return num_sources * block_size / std::max(best, 1.0);
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<int16_t> pcm(num_sources * block_size);
+    for (size_t i = 0; i < pcm.size(); ++i)
+        pcm[i] = static_cast<int16_t>(12000 * std::sin(0.01 * i) + (i * 7919) % 2000 - 1000);
+
+    std::vector<float> samples(pcm.size()), mixed(block_size, 0.0f);
+    std::vector<int16_t> out(pcm.size());
+    std::vector<float> hist(num_sources * 2 * dsp::MaxBiquadStages, 0.0f);
+    float coeff[4 * dsp::MaxBiquadStages];
+    for (unsigned int s = 0; s < dsp::MaxBiquadStages; ++s) {
+        const float r = 0.9f - 0.05f * s;
+        coeff[4 * s + 0] = 2.0f * r * std::cos(0.3f * (s + 1));
+        coeff[4 * s + 1] = -r * r;
+        coeff[4 * s + 2] = 2.0f;
+        coeff[4 * s + 3] = 1.0f;
+    }
+
+    auto block = [&](std::vector<float>& v, size_t s) { return v.data() + s * block_size; };
+
+    struct Result {
+        const char* name;
+        double simd, scalar;
+    };
+    std::vector<Result> results;
+
+    results.push_back({"int16 -> float",
+        throughput([&](size_t s) { dsp::int16ToFloat(&pcm[s * block_size], block(samples, s), block_size); }),
+        throughput([&](size_t s) { dsp::scalar::int16ToFloat(&pcm[s * block_size], block(samples, s), block_size); })});
+
+    results.push_back({"biquad x4",
+        throughput([&](size_t s) { dsp::biquad(block(samples, s), block_size, coeff, &hist[s * 8], 4, 0.1f); }),
+        throughput([&](size_t s) { dsp::scalar::biquad(block(samples, s), block_size, coeff, &hist[s * 8], 4, 0.1f); })});
+
+    results.push_back({"bit crush",
+        throughput([&](size_t s) { dsp::bitCrush(block(samples, s), block_size, 1.0f / 1024); }),
+        throughput([&](size_t s) { dsp::scalar::bitCrush(block(samples, s), block_size, 1.0f / 1024); })});
+
+    results.push_back({"mix",
+        throughput([&](size_t s) { dsp::mix(mixed.data(), block(samples, s), block_size, 0.01f); }),
+        throughput([&](size_t s) { dsp::scalar::mix(mixed.data(), block(samples, s), block_size, 0.01f); })});
+
+    results.push_back({"float -> int16",
+        throughput([&](size_t s) { dsp::floatToInt16(block(samples, s), &out[s * block_size], block_size); }),
+        throughput([&](size_t s) { dsp::scalar::floatToInt16(block(samples, s), &out[s * block_size], block_size); })});
+
+    std::cout << num_sources << " sources of " << block_size << " samples, "
+              << dsp::instructionSet() << " vs scalar, Msamples/s\n";
+    for (const Result& r : results) {
+        std::cout << std::left << std::setw(16) << r.name << std::right << std::fixed
+                  << std::setprecision(0) << std::setw(8) << r.simd << std::setw(8) << r.scalar
+                  << std::setprecision(1) << std::setw(7) << r.simd / r.scalar << "x\n";
+    }
+    return EXIT_SUCCESS;
+}
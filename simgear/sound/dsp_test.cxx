@@ -0,0 +1,262 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Unit tests for the audio DSP kernels and filters
+ */
+
+#include <simgear_config.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <simgear/constants.h>
+#include <simgear/misc/test_macros.hxx>
+
+#include "dsp.hxx"
+#include "filters.hxx"
+
+using std::cout;
+using std::endl;
+using namespace simgear;
+
+static std::mt19937 rng(42);
+
+static std::vector<float> randomSamples(size_t num, float range = 1.0f)
+{
+    std::uniform_real_distribution<float> dist(-range, range);
+    std::vector<float> samples(num);
+    for (float& s : samples)
+        s = dist(rng);
+    return samples;
+}
+
+static bool close(float a, float b)
+{
+    return std::fabs(a - b) <= 1e-6f * std::max(1.0f, std::fabs(a));
+}
+
+// block lengths around the vector widths, to cover the scalar tails
+static const size_t lengths[] = {0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 100, 1027};
+
+void test_conversion()
+{
+    cout << "Testing int16 <-> float conversion" << endl;
+
+    std::vector<int16_t> all(65536);
+    for (int i = 0; i < 65536; ++i)
+        all[i] = static_cast<int16_t>(i - 32768);
+
+    std::vector<float> f(all.size()), ref(all.size());
+    dsp::int16ToFloat(all.data(), f.data(), all.size());
+    dsp::scalar::int16ToFloat(all.data(), ref.data(), all.size());
+    SG_VERIFY(f == ref);
+    SG_CHECK_EQUAL(f[0], -1.0f);
+    SG_CHECK_EQUAL(f[32768], 0.0f);
+
+    // every 16 bit value survives the round trip
+    std::vector<int16_t> back(all.size());
+    dsp::floatToInt16(f.data(), back.data(), f.size());
+    SG_VERIFY(back == all);
+
+    // out of range values saturate, the same way in both versions
+    for (size_t num : lengths) {
+        std::vector<float> in = randomSamples(num, 1.5f);
+        std::vector<int16_t> out(num), outRef(num);
+        dsp::floatToInt16(in.data(), out.data(), num);
+        dsp::scalar::floatToInt16(in.data(), outRef.data(), num);
+        SG_VERIFY(out == outRef);
+    }
+
+    float extremes[] = {-2.0f, -1.0f, 0.99999f, 1.0f, 2.0f, 0.5f / 32768, -0.5f / 32768, 1.5f / 32768};
+    int16_t out[8];
+    dsp::floatToInt16(extremes, out, 8);
+    SG_CHECK_EQUAL(out[0], -32768);
+    SG_CHECK_EQUAL(out[1], -32768);
+    SG_CHECK_EQUAL(out[2], 32767);
+    SG_CHECK_EQUAL(out[3], 32767);
+    SG_CHECK_EQUAL(out[4], 32767);
+    SG_CHECK_EQUAL(out[5], 0);          // rounds half to even
+    SG_CHECK_EQUAL(out[6], 0);
+    SG_CHECK_EQUAL(out[7], 2);
+}
+
+/// A stable lowpass section with its poles at radius r and angle theta
+static void section(float* coeff, float r, float theta)
+{
+    coeff[0] = 2.0f * r * std::cos(theta);
+    coeff[1] = -r * r;
+    coeff[2] = 2.0f;
+    coeff[3] = 1.0f;
+}
+
+void test_biquad()
+{
+    cout << "Testing biquad cascades" << endl;
+
+    float coeff[4 * dsp::MaxBiquadStages];
+    section(coeff + 0, 0.95f, 0.2f);
+    section(coeff + 4, 0.9f, 0.4f);
+    section(coeff + 8, 0.8f, 0.7f);
+    section(coeff + 12, 0.7f, 1.1f);
+
+    for (unsigned int stages = 1; stages <= dsp::MaxBiquadStages; ++stages) {
+        for (size_t num : lengths) {
+            std::vector<float> data = randomSamples(num), ref = data;
+            float hist[2 * dsp::MaxBiquadStages] = {0.1f, -0.2f, 0.3f, 0.0f, -0.1f, 0.05f, 0.2f, 0.1f};
+            float histRef[2 * dsp::MaxBiquadStages];
+            std::copy(hist, hist + 2 * dsp::MaxBiquadStages, histRef);
+
+            dsp::biquad(data.data(), num, coeff, hist, stages, 0.25f);
+            dsp::scalar::biquad(ref.data(), num, coeff, histRef, stages, 0.25f);
+            for (size_t i = 0; i < num; ++i)
+                SG_VERIFY(close(data[i], ref[i]));
+            for (unsigned int i = 0; i < 2 * dsp::MaxBiquadStages; ++i)
+                SG_VERIFY(close(hist[i], histRef[i]));
+        }
+
+        // processing in blocks gives the same result as all at once
+        std::vector<float> data = randomSamples(4000), ref = data;
+        float hist[2 * dsp::MaxBiquadStages] = {}, histRef[2 * dsp::MaxBiquadStages] = {};
+        std::uniform_int_distribution<size_t> blockSize(0, 70);
+        for (size_t pos = 0; pos < data.size();) {
+            size_t n = std::min(blockSize(rng), data.size() - pos);
+            dsp::biquad(data.data() + pos, n, coeff, hist, stages, 0.25f);
+            pos += n;
+        }
+        dsp::scalar::biquad(ref.data(), ref.size(), coeff, histRef, stages, 0.25f);
+        for (size_t i = 0; i < data.size(); ++i)
+            SG_VERIFY(close(data[i], ref[i]));
+    }
+}
+
+void test_bitCrush()
+{
+    cout << "Testing bit crushing" << endl;
+
+    const float step = 181.0f / 32768;
+    for (size_t num : lengths) {
+        std::vector<float> data = randomSamples(num), ref = data;
+        dsp::bitCrush(data.data(), num, step);
+        dsp::scalar::bitCrush(ref.data(), num, step);
+        SG_VERIFY(data == ref);
+        for (float s : data)
+            SG_VERIFY(std::fabs(std::remainder(s / step, 1.0f)) < 1e-3f);
+    }
+}
+
+void test_mix()
+{
+    cout << "Testing mixing" << endl;
+
+    for (size_t num : lengths) {
+        std::vector<float> src = randomSamples(num);
+        std::vector<float> dst = randomSamples(num), ref = dst;
+        dsp::mix(dst.data(), src.data(), num, 0.7f);
+        dsp::scalar::mix(ref.data(), src.data(), num, 0.7f);
+        for (size_t i = 0; i < num; ++i)
+            SG_VERIFY(close(dst[i], ref[i]));
+    }
+}
+
+void test_byteSwap()
+{
+    cout << "Testing byte swapping" << endl;
+
+    for (size_t num : lengths) {
+        std::vector<uint16_t> data(num);
+        for (size_t i = 0; i < num; ++i)
+            data[i] = static_cast<uint16_t>(i * 0x0123 + 0x4567);
+        std::vector<uint16_t> ref = data;
+        dsp::byteSwap16(data.data(), num);
+        dsp::scalar::byteSwap16(ref.data(), num);
+        SG_VERIFY(data == ref);
+        for (size_t i = 0; i < num; ++i)
+            SG_CHECK_EQUAL(data[i], static_cast<uint16_t>(((i * 0x0123 + 0x4567) & 0xff) << 8 |
+                                                          ((i * 0x0123 + 0x4567) >> 8 & 0xff)));
+    }
+}
+
+static double rms(const std::vector<int16_t>& data, size_t from)
+{
+    double sum = 0;
+    for (size_t i = from; i < data.size(); ++i)
+        sum += double(data[i]) * data[i];
+    return std::sqrt(sum / (data.size() - from));
+}
+
+static std::vector<int16_t> sine(float freq, float fs, size_t num)
+{
+    std::vector<int16_t> data(num);
+    for (size_t i = 0; i < num; ++i)
+        data[i] = static_cast<int16_t>(16000 * std::sin(2 * SG_PI * freq * i / fs));
+    return data;
+}
+
+void test_filters()
+{
+    cout << "Testing FreqFilter and BitCrusher" << endl;
+
+    // an 8th order lowpass at 1 kHz passes 100 Hz, and removes 10 kHz
+    const float fs = 44100;
+    std::vector<int16_t> low = sine(100, fs, 8820), high = sine(10000, fs, 8820);
+    const double lowIn = rms(low, 4410), highIn = rms(high, 4410);
+    FreqFilter lowFilter(8, fs, 1000), highFilter(8, fs, 1000);
+    lowFilter.update(low.data(), low.size());
+    highFilter.update(high.data(), high.size());
+    SG_VERIFY(std::fabs(rms(low, 4410) / lowIn - 1.0) < 0.05);
+    SG_VERIFY(rms(high, 4410) / highIn < 0.001);
+
+    // the first sample is filtered as well
+    std::vector<int16_t> impulse(16, 0);
+    impulse[0] = 10000;
+    FreqFilter impulseFilter(2, fs, 5000);
+    impulseFilter.update(impulse.data(), impulse.size());
+    SG_VERIFY(impulse[0] != 0 && impulse[0] < 10000);
+
+    // 16 bit and float samples are filtered alike
+    std::vector<int16_t> noise(1000);
+    std::vector<float> noiseFloat(noise.size());
+    for (size_t i = 0; i < noise.size(); ++i)
+        noise[i] = static_cast<int16_t>(std::uniform_int_distribution<int>(-8000, 8000)(rng));
+    dsp::int16ToFloat(noise.data(), noiseFloat.data(), noise.size());
+    FreqFilter a(4, fs, 3000), b(4, fs, 3000);
+    a.update(noise.data(), noise.size());
+    b.update(noiseFloat.data(), noiseFloat.size());
+    for (size_t i = 0; i < noise.size(); ++i)
+        SG_VERIFY(std::fabs(noise[i] - noiseFloat[i] * 32768) <= 0.5f);
+
+    // a level of one leaves samples unchanged, zero mutes them
+    std::vector<int16_t> data = sine(440, fs, 1000), ref = data;
+    BitCrusher(1.0f).update(data.data(), data.size());
+    SG_VERIFY(data == ref);
+    BitCrusher(0.0f).update(data.data(), data.size());
+    for (int16_t s : data)
+        SG_CHECK_EQUAL(s, 0);
+
+    // half way, 7.5 bits are removed: multiples of 2^7.5 = 181.02 remain
+    data = ref;
+    BitCrusher(0.5f).update(data.data(), data.size());
+    std::set<int16_t> values(data.begin(), data.end());
+    SG_VERIFY(values.size() <= 2 * 16000 / 181 + 1);
+    for (int16_t s : values)
+        SG_VERIFY(std::fabs(std::remainder(s / 181.02f, 1.0f)) < 0.01f);
+}
+
+int main(int argc, char* argv[])
+{
+    cout << "DSP kernels use " << dsp::instructionSet() << endl;
+
+    test_conversion();
+    test_biquad();
+    test_bitCrush();
+    test_mix();
+    test_byteSwap();
+    test_filters();
+
+    return EXIT_SUCCESS;
+}
@@ -12,6 +12,7 @@
 
 #include <simgear/constants.h>
 #include "filters.hxx"
+#include "dsp.hxx"
 
 namespace simgear {
 
@@ -20,6 +21,9 @@ FreqFilter::FreqFilter(int order, float sample_freq, float cutoff_freq, float Qf
     Q = Qfactor;
     fs = sample_freq;
     no_stages = order / 2;
+    if (no_stages > SG_FREQFILTER_MAX_STAGES) {
+        no_stages = SG_FREQFILTER_MAX_STAGES;
+    }
     gain = order;
 
     butterworth_compute(cutoff_freq);
@@ -34,33 +38,23 @@ FreqFilter::~FreqFilter() {
 
 void FreqFilter::update( int16_t *data, unsigned int num) {
 
-    if (num) {
-        float k = gain;
-        for (unsigned int stage = 0; stage < no_stages; ++stage) {
-
-            float h0 = hist[2*stage + 0];
-            float h1 = hist[2*stage + 1];
-            unsigned int i = num;
-            do {
-                float nsmp, smp = data[i] * k;
-                smp  = smp  + h0 * coeff[4*stage + 0];
-                nsmp = smp  + h1 * coeff[4*stage + 1];
-                smp  = nsmp + h0 * coeff[4*stage + 2];
-                smp  = smp  + h1 * coeff[4*stage + 3];
-
-                h1 = h0;
-                h0 = nsmp;
-                data[i] = smp;
-            }
-            while (--i);
-
-            hist[2*stage + 0] = h0;
-            hist[2*stage + 1] = h1;
-            k = 1.0f;
-        }
+    // filter in float, converting a block at a time
+    float buf[SG_DSP_BLOCK_SIZE];
+    while (num) {
+        unsigned int n = (num < SG_DSP_BLOCK_SIZE) ? num : SG_DSP_BLOCK_SIZE;
+        dsp::int16ToFloat(data, buf, n);
+        update(buf, n);
+        dsp::floatToInt16(buf, data, n);
+        data += n;
+        num -= n;
     }
 }
 
+void FreqFilter::update( float *data, unsigned int num) {
+
+    dsp::biquad(data, num, coeff, hist, no_stages, gain);
+}
+
 inline void FreqFilter::bilinear(float a0, float a1, float a2,
                                  float b0, float b1, float b2,
                                  float *k, int stage) {
@@ -131,7 +125,8 @@ void FreqFilter::butterworth_compute(float fc) {
 
 BitCrusher::BitCrusher(float level) {
 
-    float bits = level * 15.0f;
+    // the number of bits removed
+    float bits = (1.0f - level) * 15.0f;
     factor = powf(2.0f, bits);
     devider = 1.0f/factor;
 }
@@ -141,16 +136,25 @@ BitCrusher::~BitCrusher() {
 
 void BitCrusher::update( int16_t *data, unsigned int num ) {
 
-    if (num && factor < 1.0f) {
-        unsigned int i = num;
-        do {
-            float integral;
+    if (factor > 1.0f) {
+        float buf[SG_DSP_BLOCK_SIZE];
+        while (num) {
+            unsigned int n = (num < SG_DSP_BLOCK_SIZE) ? num : SG_DSP_BLOCK_SIZE;
+            dsp::int16ToFloat(data, buf, n);
+            update(buf, n);
+            dsp::floatToInt16(buf, data, n);
+            data += n;
+            num -= n;
+        }
+    }
+}
 
-            modff(data[i]*devider, &integral);
-            data[i] = integral*factor;
-        } while (--i);
+void BitCrusher::update( float *data, unsigned int num ) {
+
+    if (factor > 1.0f) {
+        // factor is in 16 bit sample units
+        dsp::bitCrush(data, num, factor/32768.0f);
     }
 }
 
 }; // namespace simgear
-
@@ -17,6 +17,9 @@ namespace simgear {
 // Four stages therefore equals to an 8th order filter with a 48dB/oct slope.
 #define SG_FREQFILTER_MAX_STAGES	4
 
+// Number of samples converted to float at a time by the 16 bit update()s
+#define SG_DSP_BLOCK_SIZE	256
+
 class FreqFilter final {
     
 private:
@@ -40,6 +43,9 @@ public:
     ~FreqFilter();      // non-virtual intentional
     
     void update( int16_t *data, unsigned int num );
+
+    // samples normalized to [-1.0f, 1.0f)
+    void update( float *data, unsigned int num );
 };
 
 
@@ -56,6 +62,9 @@ public:
     ~BitCrusher();      // non-virtual intentional
 
     void update( int16_t *data, unsigned int num );
+
+    // samples normalized to [-1.0f, 1.0f)
+    void update( float *data, unsigned int num );
 };
 
 }; // namespace simgear
@@ -11,8 +11,9 @@
 
 #include "readwav.hxx"
 
-#include <cassert>
+#include <algorithm>
 #include <cstdlib>
+#include <vector>
 
 #include <stdio.h> // snprintf
 #include <zlib.h> // for gzXXX functions
@@ -23,29 +24,11 @@
 #include <simgear/structure/exception.hxx>
 #include <simgear/debug/ErrorReportingCallback.hxx>
 
+#include "dsp.hxx"
 #include "sample.hxx"
 
 namespace 
 {
-  class Buffer {
-  public:
-    ALvoid* data;
-    unsigned int format;
-    unsigned int block_align;
-    ALsizei length;
-    ALfloat frequency;
-    SGPath path;
-      
-    Buffer() : data(nullptr), format(AL_NONE), length(0), frequency(0.0f) {}
-    
-    ~Buffer()
-    {
-      if (data) {
-        free(data);
-      }
-    }
-  };
-  
   unsigned int formatConstruct(ALint numChannels, ALint bitsPerSample, bool compressed, const SGPath& path)
   {
     unsigned int rv = 0;
@@ -71,22 +54,9 @@ namespace
     return rv;
   }
   
-// function prototype for decoding audio data
-  typedef void Codec(Buffer* buf);
-  
-  void codecLinear(Buffer* /*buf*/)
-  {
-  }
-  
-  void codecPCM16BE (Buffer* buf)
-  {
-    uint16_t *d = (uint16_t *) buf->data;
-    size_t i, l = buf->length / 2;
-    for (i = 0; i < l; i++) {
-      *d = sg_bswap_16(*d); ++d;
-    }
-  }
-  
+// how the audio data is decoded
+  enum class Codec { Linear, PCM16BE, ULaw, IMA4 };
+
  /*
   * From: http://www.multimedia.cx/simpleaudio.html#tth_sEc6.1
   */
@@ -104,21 +74,16 @@ namespace
     return sign ? -sample : sample;
   }
 
-  void codecULaw (Buffer* b)
+  const int16_t* ulawTable()
   {
-    uint8_t *d = (uint8_t *) b->data;
-    size_t newLength = b->length * 2;
-    int16_t *buf = (int16_t *) malloc(newLength);
-    if (buf == nullptr)
-      throw sg_exception("malloc failed decoing ULaw WAV file");
-   
-    for (ALsizei i = 0; i < b->length; i++) {
-      buf[i] = mulaw2linear(d[i]);
-    }
-    
-    free(b->data);
-    b->data = buf;
-    b->length = newLength;
+    // decode through a table of all 256 codes
+    static const struct ULawTable {
+      int16_t value[256];
+      ULawTable() {
+        for (int i = 0; i < 256; i++) value[i] = mulaw2linear(i);
+      }
+    } table;
+    return table.value;
   }
 
   int16_t ima2linear (uint8_t nibble, int16_t *val, uint8_t *idx)
@@ -176,41 +141,25 @@ namespace
     return *val;
   }
 
-  void codecIMA4 (Buffer* b)
+  // A mono block holds the first sample and the step index in a four byte
+  // header, followed by two samples in every further byte.
+  size_t ima4BlockSamples(unsigned int block_align)
   {
-    uint8_t *d = (uint8_t *) b->data;
-    unsigned int block_align = b->block_align;
-    size_t blocks = b->length/block_align;
-    size_t newLength = block_align * blocks * 4;
-    int16_t *buf = (int16_t *) malloc ( newLength );
-    if (buf == nullptr)
-      throw sg_exception("malloc failed decoing IMA4 WAV file");
-
-    int16_t *ptr = buf;
-    for (size_t i = 0; i < blocks; i++)
-    {
-      int16_t predictor;
-      uint8_t index;
+    return (block_align > 4) ? 1 + 2 * (block_align - 4) : 0;
+  }
 
-      predictor = *d++;
-      predictor |= *d++ << 8;
-      index = *d++;
-      d++;
+  void decodeIMA4Block(const uint8_t* d, unsigned int block_align, int16_t* ptr)
+  {
+    int16_t predictor = d[0] | (d[1] << 8);
+    uint8_t index = d[2];
+    *ptr++ = predictor;
 
-      for (size_t j = 0; j < block_align; j += 4)
-      {
-        for (unsigned int q=0; q<4; q++)
-        {
-          uint8_t nibble = *d++;
-          *ptr++ = ima2linear(nibble & 0xF, &predictor, &index);
-          *ptr++ = ima2linear(nibble >> 4, &predictor, &index);
-        }
-      }
+    for (unsigned int j = 4; j < block_align; j++)
+    {
+      uint8_t nibble = d[j];
+      *ptr++ = ima2linear(nibble & 0xF, &predictor, &index);
+      *ptr++ = ima2linear(nibble >> 4, &predictor, &index);
     }
-
-    free(b->data);
-    b->data = buf;
-    b->length = newLength;
   }
 
   bool gzSkip(gzFile fd, int skipCount)
@@ -248,10 +197,17 @@ namespace
     return true;
   }
   
-  void loadWavFile(gzFile fd, Buffer* b)
+  struct WavHeader {
+    unsigned int format = AL_NONE;
+    unsigned int block_align = 0;
+    ALfloat frequency = 0.0f;
+    uint32_t length = 0;    // of the (encoded) audio data in the file
+    Codec codec = Codec::Linear;
+  };
+
+  // Parse the chunks up to the start of the audio data
+  void readWavHeader(gzFile fd, const SGPath& path, WavHeader* h)
   {
-    assert(b->data == nullptr);
-    
     bool found_header = false;
     bool compressed = false;
     uint16_t bitsPerSample = 8;
@@ -262,32 +218,31 @@ namespace
     uint32_t samplesPerSecond;
     uint32_t byteRate;
     uint16_t blockAlign;
-    Codec *codec = codecLinear;
 
     if (!wavReadBE(fd, magic))
-        throw sg_io_exception("corrupt or truncated WAV data", b->path, {}, false);
+        throw sg_io_exception("corrupt or truncated WAV data", path, {}, false);
     
     if (magic != WAV_RIFF_4CC) {
-      throw sg_io_exception("not a .wav file", b->path, {}, false);
+      throw sg_io_exception("not a .wav file", path, {}, false);
     }
 
     if (!wavReadLE(fd, chunkLength) || !wavReadBE(fd, magic))
-      throw sg_io_exception("corrupt or truncated WAV data", b->path, {}, false);
+      throw sg_io_exception("corrupt or truncated WAV data", path, {}, false);
 
     if (magic != WAV_WAVE_4CC)      /* "WAVE" */
     {
-        throw sg_io_exception("unrecognized WAV magic", b->path, {}, false);
+        throw sg_io_exception("unrecognized WAV magic", path, {}, false);
     }
 
     while (1) {
         if (!wavReadBE(fd, magic) || !wavReadLE(fd, chunkLength))
-            throw sg_io_exception("corrupt or truncated WAV data", b->path, {}, false);
+            throw sg_io_exception("corrupt or truncated WAV data", path, {}, false);
 
         if (magic == WAV_FORMAT_4CC)  /* "fmt " */
         {
             found_header = true;
             if (chunkLength < 16) {
-              throw sg_io_exception("corrupt or truncated WAV data", b->path, {}, false);
+              throw sg_io_exception("corrupt or truncated WAV data", path, {}, false);
             }
 
             if (!wavReadLE (fd, audioFormat) ||
@@ -297,24 +252,24 @@ namespace
                 !wavReadLE (fd, blockAlign) ||
                 !wavReadLE (fd, bitsPerSample))
             {
-                throw sg_io_exception("corrupt or truncated WAV data", b->path, {}, false);
+                throw sg_io_exception("corrupt or truncated WAV data", path, {}, false);
             }
 
             if (!gzSkip(fd, chunkLength - 16))
-                throw sg_io_exception("corrupt or truncated WAV data", b->path, {}, false);
+                throw sg_io_exception("corrupt or truncated WAV data", path, {}, false);
 
             switch (audioFormat)
               {
               case 1:            /* PCM */
-                codec = (bitsPerSample == 8 || sgIsLittleEndian()) ? codecLinear : codecPCM16BE;
+                h->codec = (bitsPerSample == 8 || sgIsLittleEndian()) ? Codec::Linear : Codec::PCM16BE;
                 break;
               case 7:            /* uLaw */
                 if (alIsExtensionPresent((ALchar *)"AL_EXT_mulaw")) {
                   compressed = true;
-                  codec = codecLinear;
+                  h->codec = Codec::Linear;
                 } else {
                   bitsPerSample *= 2; /* uLaw is 16-bit packed into 8 bits */
-                  codec = codecULaw;
+                  h->codec = Codec::ULaw;
                }
                 break;
               case 17:		/* IMA4 ADPCM */
@@ -322,90 +277,265 @@ namespace
                     (alIsExtensionPresent((ALchar *)"AL_SOFT_block_alignment")
                      || blockAlign == 65)) {
                   compressed = true;
-                  codec = codecLinear;
+                  h->codec = Codec::Linear;
                 } else {
                   bitsPerSample *= 4; /* adpcm is 16-bit packed into 4 bits */
-                  codec = codecIMA4;
-                  
+                  h->codec = Codec::IMA4;
+                  if (numChannels != 1 || blockAlign <= 4)
+                    throw sg_io_exception("unsupported IMA4 block layout", path, {}, false);
                 }
                 break;
               default:
-                throw sg_io_exception("unsupported WAV encoding:" + std::to_string(audioFormat), b->path, {}, false);
+                throw sg_io_exception("unsupported WAV encoding:" + std::to_string(audioFormat), path, {}, false);
               }
               
-              b->block_align = blockAlign;
-              b->frequency = samplesPerSecond;
-              b->format = formatConstruct(numChannels, bitsPerSample, compressed, b->path);
+              h->block_align = blockAlign;
+              h->frequency = samplesPerSecond;
+              h->format = formatConstruct(numChannels, bitsPerSample, compressed, path);
         } else if (magic == WAV_DATA_4CC) {
             if (!found_header) {
                 /* ToDo: A bit wrong to check here, fmt chunk could come later... */
-                throw sg_io_exception("corrupt or truncated WAV data", b->path, {}, false);
-            }
-            
-            b->data = malloc(chunkLength);
-            b->length = chunkLength;
-            size_t read = gzread(fd, b->data, chunkLength);
-            if (read != chunkLength) {
-                throw sg_io_exception("insufficent data reading WAV file", b->path, {}, false);
+                throw sg_io_exception("corrupt or truncated WAV data", path, {}, false);
             }
             
-            break;
+            h->length = chunkLength;
+            return;
         } else {
             if (!gzSkip(fd, chunkLength))
-              throw sg_io_exception("corrupt or truncated WAV data", b->path, {}, false);
+              throw sg_io_exception("corrupt or truncated WAV data", path, {}, false);
         }
 
         if ((chunkLength & 1) && !gzeof(fd) && !gzSkip(fd, 1))
-          throw sg_io_exception("corrupt or truncated WAV data", b->path, {}, false);
+          throw sg_io_exception("corrupt or truncated WAV data", path, {}, false);
       } // of file chunk parser loop
-      
-      codec(b); // might throw if something really bad occurs
-  } // of loadWav function
+  } // of readWavHeader function
+
+  // largest amount of encoded data decoded by one WavStream::read() call
+  const size_t MAX_READ_CHUNK = 64 * 1024;
   
 } // of anonymous namespace
 
 namespace simgear
 {
 
-ALvoid* loadWAVFromFile(const SGPath& path, unsigned int& format, ALsizei& size, ALfloat& freqf, unsigned int& block_align)
+class WavStream::WavStreamPrivate
+{
+public:
+  gzFile fd = nullptr;
+  SGPath path;
+  WavHeader header;
+  z_off_t data_start = 0;
+  uint32_t remaining = 0;   // encoded bytes left to read
+  std::vector<uint8_t> encoded;
+
+  // encoded and decoded size of the smallest unit that can be decoded
+  size_t inUnit() const
+  {
+    switch (header.codec) {
+    case Codec::ULaw:
+      return 1;
+    case Codec::IMA4:
+      return header.block_align;
+    default:
+      return (header.block_align > 0) ? header.block_align : 1;
+    }
+  }
+
+  size_t outUnit() const
+  {
+    switch (header.codec) {
+    case Codec::ULaw:
+      return 2;
+    case Codec::IMA4:
+      return 2 * ima4BlockSamples(header.block_align);
+    default:
+      return inUnit();
+    }
+  }
+};
+
+WavStream::WavStream() :
+  d(new WavStreamPrivate)
 {
+}
+
+WavStream::~WavStream()
+{
+  close();
+}
+
+bool WavStream::open(const SGPath& path)
+{
+  close();
   if (!path.exists()) {
       simgear::reportFailure(simgear::LoadFailure::NotFound, simgear::ErrorCode::AudioFX, "loadWAVFromFile: not found", path);
-    return nullptr;
+    return false;
   }
 
-  Buffer b;
-  b.path = path;
-
-  gzFile fd;
 #if defined(SG_WINDOWS)
-	std::wstring ws = path.wstr();
-	fd = gzopen_w(ws.c_str(), "rb");
+  std::wstring ws = path.wstr();
+  d->fd = gzopen_w(ws.c_str(), "rb");
 #else
   std::string ps = path.utf8Str();
-  fd = gzopen(ps.c_str(), "rb");
+  d->fd = gzopen(ps.c_str(), "rb");
 #endif
-  if (!fd) {
+  if (!d->fd) {
       simgear::reportFailure(simgear::LoadFailure::IOError, simgear::ErrorCode::AudioFX, "loadWAVFromFile: unable to open file", path);
-    return nullptr;
+    return false;
   }
 
+  d->path = path;
+  d->header = WavHeader();
   try {
-      loadWavFile(fd, &b);
+      readWavHeader(d->fd, path, &d->header);
   } catch (sg_exception& e) {
       simgear::reportFailure(simgear::LoadFailure::IOError, simgear::ErrorCode::AudioFX, "loadWAVFromFile: unable to read file:"
                              + e.getFormattedMessage(), e.getLocation());
-      return nullptr;
+      close();
+      return false;
   }
 
-  ALvoid* data = b.data;
-  b.data = nullptr; // don't free when Buffer does out of scope
-  format = b.format;
-  block_align = b.block_align;
-  size = b.length;
-  freqf = b.frequency;
-  
-  gzclose(fd);
+  d->data_start = gztell(d->fd);
+  d->remaining = d->header.length;
+  return true;
+}
+
+void WavStream::close()
+{
+  if (d->fd) {
+    gzclose(d->fd);
+    d->fd = nullptr;
+  }
+  d->remaining = 0;
+  d->encoded.clear();
+  d->encoded.shrink_to_fit();
+}
+
+bool WavStream::is_open() const
+{
+  return d->fd != nullptr;
+}
+
+unsigned int WavStream::get_format() const
+{
+  return d->header.format;
+}
+
+ALfloat WavStream::get_frequency() const
+{
+  return d->header.frequency;
+}
+
+unsigned int WavStream::get_block_align() const
+{
+  return d->header.block_align;
+}
+
+size_t WavStream::get_decoded_size() const
+{
+  // a partial unit at the end of the data is dropped
+  return (d->header.length / d->inUnit()) * d->outUnit();
+}
+
+size_t WavStream::get_chunk_align() const
+{
+  return d->outUnit();
+}
+
+size_t WavStream::read(void* buf, size_t max)
+{
+  if (!d->fd) {
+    return 0;
+  }
+
+  const size_t inUnit = d->inUnit(), outUnit = d->outUnit();
+  size_t units = std::min<size_t>(d->remaining / inUnit, max / outUnit);
+  units = std::min(units, std::max<size_t>(MAX_READ_CHUNK / inUnit, 1));
+  if (units == 0) {
+    return 0;
+  }
+
+  // linear data is read straight into the output buffer
+  const size_t inBytes = units * inUnit;
+  uint8_t* in = (uint8_t*) buf;
+  if (d->header.codec == Codec::ULaw || d->header.codec == Codec::IMA4) {
+    d->encoded.resize(inBytes);
+    in = d->encoded.data();
+  }
+
+  int got = gzread(d->fd, in, inBytes);
+  if (got != (int) inBytes) {
+    SG_LOG(SG_SOUND, SG_WARN, "insufficent data reading WAV file " << d->path);
+    d->remaining = 0;
+    units = (got > 0) ? got / inUnit : 0;
+  } else {
+    d->remaining -= inBytes;
+  }
+
+  switch (d->header.codec) {
+  case Codec::Linear:
+    break;
+  case Codec::PCM16BE:
+    simgear::dsp::byteSwap16((uint16_t*) buf, units * outUnit / 2);
+    break;
+  case Codec::ULaw: {
+    const int16_t* table = ulawTable();
+    int16_t* out = (int16_t*) buf;
+    for (size_t i = 0; i < units; i++) {
+      out[i] = table[in[i]];
+    }
+    break;
+  }
+  case Codec::IMA4: {
+    const unsigned int block_align = d->header.block_align;
+    for (size_t i = 0; i < units; i++) {
+      decodeIMA4Block(in + i * block_align, block_align,
+                      (int16_t*) buf + i * outUnit / 2);
+    }
+    break;
+  }
+  }
+
+  return units * outUnit;
+}
+
+bool WavStream::rewind()
+{
+  if (!d->fd || gzseek(d->fd, d->data_start, SEEK_SET) < 0) {
+    return false;
+  }
+  d->remaining = d->header.length;
+  return true;
+}
+
+ALvoid* loadWAVFromFile(const SGPath& path, unsigned int& format, ALsizei& size, ALfloat& freqf, unsigned int& block_align)
+{
+  WavStream stream;
+  if (!stream.open(path)) {
+    return nullptr;
+  }
+
+  const size_t length = stream.get_decoded_size();
+  uint8_t* data = (uint8_t*) malloc(std::max<size_t>(length, 1));
+  if (data == nullptr) {
+      simgear::reportFailure(simgear::LoadFailure::OutOfMemory, simgear::ErrorCode::AudioFX, "loadWAVFromFile: malloc failed", path);
+    return nullptr;
+  }
+
+  size_t got = 0, n;
+  while (got < length && (n = stream.read(data + got, length - got)) > 0) {
+    got += n;
+  }
+  if (got != length) {
+      free(data);
+      simgear::reportFailure(simgear::LoadFailure::IOError, simgear::ErrorCode::AudioFX, "loadWAVFromFile: insufficent data reading WAV file", path);
+    return nullptr;
+  }
+
+  format = stream.get_format();
+  block_align = stream.get_block_align();
+  size = length;
+  freqf = stream.get_frequency();
   return data;
 }
 
@@ -9,6 +9,9 @@
 
 #pragma once
 
+#include <cstddef>
+#include <memory>
+
 #if defined( __APPLE__ ) && !defined(SG_SOUND_USES_OPENALSOFT)
 # include <OpenAL/al.h>
 #elif defined(OPENALSDK)
@@ -26,4 +29,48 @@ class SGPath;
 namespace simgear
 {
   ALvoid* loadWAVFromFile(const SGPath& path, unsigned int& format, ALsizei& size, ALfloat& freqf, unsigned int& block_align);
+
+  /**
+   * Decode a WAV file a chunk at a time, for samples too long to keep
+   * in memory as a whole.
+   */
+  class WavStream
+  {
+  public:
+    WavStream();
+    ~WavStream();
+
+    /**
+     * Open a file and parse its header, leaving it positioned at the
+     * start of the audio data.
+     * @return false, after reporting the failure, if the file is unusable
+     */
+    bool open(const SGPath& path);
+    void close();
+    bool is_open() const;
+
+    /// Format of the decoded data, one of the SG_SAMPLE_* values
+    unsigned int get_format() const;
+    ALfloat get_frequency() const;
+    unsigned int get_block_align() const;
+
+    /// Total number of bytes read() returns from the start of the data
+    size_t get_decoded_size() const;
+
+    /// read() returns multiples of this many bytes, and nothing if asked for less
+    size_t get_chunk_align() const;
+
+    /**
+     * Decode the next part of the data into @a buf.
+     * @return the number of bytes written, at most @a max, or 0 at the end
+     */
+    size_t read(void* buf, size_t max);
+
+    /// Go back to the start of the data, e.g. to loop a sample
+    bool rewind();
+
+  private:
+    class WavStreamPrivate;
+    std::unique_ptr<WavStreamPrivate> d;
+  };
 }
@@ -584,6 +584,23 @@ public:
         _max_dist = dist; _static_changed = true;
     }
 
+    /**
+     * Set the priority of this sound for getting a voice when more samples
+     * are playing than the sound manager has voices. The estimated gain
+     * at the listener is multiplied by it.
+     * @param priority Priority, 1.0 by default
+     */
+    inline void set_priority( float priority ) { _priority = priority; }
+    inline float get_priority() const { return _priority; }
+
+    /**
+     * Test if this sample is playing without a voice: it is inaudible, or
+     * outranked by more audible samples. Looped samples start again once
+     * they get a voice, samples playing once are stopped.
+     */
+    inline bool is_culled() const { return _culled; }
+    inline void set_culled( bool culled = true ) { _culled = culled; }
+
     inline virtual bool is_queue() const { return false; }
 
     void update_pos_and_orientation();
@@ -602,4 +619,7 @@ private:
     // Buffers hold sound data.
     bool _valid_buffer = false;
     unsigned int _buffer = SGSoundMgr::NO_BUFFER;
+
+    float _priority = 1.0f;
+    bool _culled = false;
 };
@@ -0,0 +1,156 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Shared cache of decoded sample files, with background loading
+ */
+
+#include <simgear_config.h>
+
+#include "sample_cache.hxx"
+
+#include <simgear/debug/logstream.hxx>
+#include <simgear/structure/exception.hxx>
+#include <simgear/threads/SGJobPool.hxx>
+
+SGDecodedSample::SGDecodedSample(void* data, size_t size, int format, int frequency, int block_align) :
+    _data(data, free),
+    _size(size),
+    _format(format),
+    _frequency(frequency),
+    _block_align(block_align)
+{
+}
+
+SGSampleCache::SGSampleCache(Decoder decoder, size_t max_unused_bytes) :
+    _decoder(std::move(decoder)),
+    _cache(max_unused_bytes,
+           [](const SGDecodedSampleRef& sample) { return sample->get_size(); },
+           // referenced by a sample, and not just by the cache
+           [](const SGDecodedSampleRef& sample) { return sample.getNumRefs() > 1; })
+{
+}
+
+SGSampleCache::~SGSampleCache()
+{
+    {
+        std::lock_guard<std::mutex> g(_lock);
+        _stopping = true;
+    }
+
+    // the loads still queued return right away
+    _loader.reset();
+}
+
+SGDecodedSampleRef SGSampleCache::get(const std::string& path)
+{
+    return _cache.get(path, [this, &path] { return decode(path); });
+}
+
+SGDecodedSampleRef SGSampleCache::find(const std::string& path)
+{
+    return _cache.find(path);
+}
+
+void SGSampleCache::load_async(const std::string& path, ReadyCallback ready)
+{
+    SGDecodedSampleRef sample = _cache.find(path);
+
+    std::lock_guard<std::mutex> g(_lock);
+    if (sample) {
+        if (ready)
+            _ready.push_back([ready, path, sample] { ready(path, sample); });
+        return;
+    }
+
+    auto it = _waiting.find(path);
+    if (it == _waiting.end()) {
+        it = _waiting.emplace(path, std::vector<ReadyCallback>()).first;
+        if (!_loader)
+            _loader.reset(new SGJobPool(1));
+        _loader->submit([this, path] { load_queued(path); });
+    }
+    if (ready)
+        it->second.push_back(std::move(ready));
+}
+
+size_t SGSampleCache::process_ready()
+{
+    std::vector<std::function<void()>> ready;
+    {
+        std::lock_guard<std::mutex> g(_lock);
+        ready.swap(_ready);
+    }
+
+    for (auto& callback : ready)
+        callback();
+    return ready.size();
+}
+
+void SGSampleCache::trim()
+{
+    _cache.trim();
+}
+
+void SGSampleCache::flush()
+{
+    _cache.flush();
+}
+
+void SGSampleCache::set_max_unused_bytes(size_t bytes)
+{
+    _cache.setBudget(bytes);
+}
+
+size_t SGSampleCache::get_max_unused_bytes() const
+{
+    return _cache.getBudget();
+}
+
+size_t SGSampleCache::size() const
+{
+    return _cache.size();
+}
+
+SGSampleCache::Stats SGSampleCache::get_stats() const
+{
+    const auto cacheStats = _cache.getStats();
+    Stats stats;
+    stats.hits = cacheStats.hits;
+    stats.misses = cacheStats.misses;
+    stats.evictions = cacheStats.evictions;
+    stats.bytes = cacheStats.cost;
+    stats.unused_bytes = _cache.unusedCost();
+    return stats;
+}
+
+SGDecodedSampleRef SGSampleCache::decode(const std::string& path)
+{
+    return _decoder ? _decoder(path) : SGDecodedSampleRef();
+}
+
+void SGSampleCache::load_queued(const std::string& path)
+{
+    {
+        std::lock_guard<std::mutex> g(_lock);
+        if (_stopping)
+            return;
+    }
+
+    // already counted as a miss by load_async()
+    SGDecodedSampleRef sample;
+    try {
+        sample = _cache.load(path, [this, &path] { return decode(path); });
+    } catch (sg_exception& e) {
+        SG_LOG(SG_SOUND, SG_ALERT, "failed to load sound sample " << path << ":\n"
+                                   << e.getFormattedMessage());
+    } catch (std::exception& e) {
+        SG_LOG(SG_SOUND, SG_ALERT, "failed to load sound sample " << path << ": " << e.what());
+    }
+
+    std::lock_guard<std::mutex> g(_lock);
+    auto it = _waiting.find(path);
+    for (auto& ready : it->second)
+        _ready.push_back([ready, path, sample] { ready(path, sample); });
+    _waiting.erase(it);
+}
@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Shared cache of decoded sample files, with background loading
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <simgear/structure/SGLoadingCache.hxx>
+#include <simgear/structure/SGReferenced.hxx>
+#include <simgear/structure/SGSharedPtr.hxx>
+
+class SGJobPool;
+
+/**
+ * The decoded data of a sample file, shared by every sample playing it.
+ */
+class SGDecodedSample : public SGReferenced
+{
+public:
+    /// Takes ownership of @a data, which must be allocated with malloc()
+    SGDecodedSample(void* data, size_t size, int format, int frequency, int block_align);
+
+    SGDecodedSample(const SGDecodedSample&) = delete;
+    SGDecodedSample& operator=(const SGDecodedSample&) = delete;
+
+    inline const void* get_data() const { return _data.get(); }
+    inline size_t get_size() const { return _size; }
+
+    /// SimGear format-id, one of the SG_SAMPLE_* values
+    inline int get_format() const { return _format; }
+    inline int get_frequency() const { return _frequency; }
+    inline int get_block_align() const { return _block_align; }
+
+private:
+    std::unique_ptr<void, decltype(free)*> _data;
+    size_t _size;
+    int _format;
+    int _frequency;
+    int _block_align;
+};
+
+using SGDecodedSampleRef = SGSharedPtr<SGDecodedSample>;
+
+/**
+ * Decoded sample files keyed by path.
+ *
+ * Samples which are no longer referenced outside the cache are kept, least
+ * recently used first out, as long as they fit in the memory budget, so a
+ * sample played again or by another sample group isn't decoded again.
+ *
+ * get() and load_async() may be called from any thread, and a file
+ * requested several times while it is decoded is only decoded once.
+ * Asynchronous loads run on a single background thread, started on first
+ * use; their callbacks run on the thread calling process_ready().
+ */
+class SGSampleCache final
+{
+public:
+    /// Decode a file, returning null (or throwing) on failure
+    using Decoder = std::function<SGDecodedSampleRef(const std::string& path)>;
+
+    /// Called with the decoded sample, or null if decoding failed
+    using ReadyCallback = std::function<void(const std::string& path, SGDecodedSampleRef sample)>;
+
+    struct Stats {
+        uint64_t hits = 0;      ///< found decoded, or waited for another thread
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t bytes = 0;       ///< decoded data held by the cache
+        size_t unused_bytes = 0; ///< of which not referenced outside it
+    };
+
+    static const size_t DefaultMaxUnusedBytes = 32 * 1024 * 1024;
+
+    explicit SGSampleCache(Decoder decoder, size_t max_unused_bytes = DefaultMaxUnusedBytes);
+
+    /// Waits for the file being decoded in the background, if any
+    ~SGSampleCache();
+
+    SGSampleCache(const SGSampleCache&) = delete;
+    SGSampleCache& operator=(const SGSampleCache&) = delete;
+
+    /**
+     * The decoded sample for @a path, decoding it on the calling thread if
+     * it is neither cached nor being decoded by another thread.
+     * Exceptions thrown by the decoder are passed on.
+     */
+    SGDecodedSampleRef get(const std::string& path);
+
+    /// The decoded sample for @a path if it is cached, or null
+    SGDecodedSampleRef find(const std::string& path);
+
+    /**
+     * Decode @a path in the background, unless it is cached already.
+     * @a ready is called by the next process_ready() after it is done.
+     */
+    void load_async(const std::string& path, ReadyCallback ready = ReadyCallback());
+
+    /// Run the callbacks of finished asynchronous loads, returning how many ran
+    size_t process_ready();
+
+    /// Drop unused samples until they fit in the memory budget again
+    void trim();
+
+    /// Drop all unused samples
+    void flush();
+
+    void set_max_unused_bytes(size_t bytes);
+    size_t get_max_unused_bytes() const;
+
+    /// Number of decoded samples
+    size_t size() const;
+
+    Stats get_stats() const;
+
+private:
+    SGDecodedSampleRef decode(const std::string& path);
+    void load_queued(const std::string& path);
+
+    Decoder _decoder;
+    simgear::SGLoadingCache<std::string, SGDecodedSampleRef> _cache;
+
+    mutable std::mutex _lock;
+    std::unique_ptr<SGJobPool> _loader; ///< one thread, created on first use
+    bool _stopping = false;
+
+    /// callbacks of asynchronous loads, by the path being loaded
+    std::map<std::string, std::vector<ReadyCallback>> _waiting;
+
+    /// callbacks of finished asynchronous loads
+    std::vector<std::function<void()>> _ready;
+};
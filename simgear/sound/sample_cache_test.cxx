@@ -0,0 +1,245 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Unit tests for chunked WAV decoding and the decoded sample cache
+ */
+
+#include <simgear_config.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <simgear/misc/sg_path.hxx>
+#include <simgear/misc/test_macros.hxx>
+
+#include "readwav.hxx"
+#include "sample.hxx"
+#include "sample_cache.hxx"
+
+using std::cout;
+using std::endl;
+
+static std::string jet(const char* name)
+{
+    return (SGPath::fromUtf8(SRC_DIR) / name).utf8Str();
+}
+
+static std::atomic<int> decodes(0);
+
+static SGDecodedSampleRef decodeWAV(const std::string& path)
+{
+    ++decodes;
+    unsigned int format, block_align;
+    ALsizei size;
+    ALfloat freq;
+    void* data = simgear::loadWAVFromFile(SGPath::fromUtf8(path), format, size, freq, block_align);
+    if (!data)
+        return {};
+    return new SGDecodedSample(data, size, format, (int)freq, block_align);
+}
+
+// decoded sizes of the bundled samples, without OpenAL decoding extensions
+static const size_t jet_size = 34846;               // 8 bit linear
+static const size_t jet_ulaw_size = 2 * 34846;      // 16 bit
+static const size_t jet_ima4_size = 2 * 70 * 505;   // 70 blocks of 505 samples
+
+void test_stream()
+{
+    cout << "Testing chunked WAV decoding" << endl;
+
+    struct { const char* name; size_t size; unsigned int format; } files[] = {
+        {"jet.wav", jet_size, SG_SAMPLE_MONO8},
+        {"jet_ulaw.wav", jet_ulaw_size, SG_SAMPLE_MONO16},
+        {"jet_ima4.wav", jet_ima4_size, SG_SAMPLE_MONO16}};
+
+    std::vector<std::vector<int16_t>> decoded;
+    for (const auto& file : files) {
+        unsigned int format, block_align;
+        ALsizei size;
+        ALfloat freq;
+        void* data = simgear::loadWAVFromFile(SGPath::fromUtf8(jet(file.name)), format, size, freq, block_align);
+        SG_VERIFY(data != nullptr);
+        SG_CHECK_EQUAL((size_t)size, file.size);
+        SG_CHECK_EQUAL(format, file.format);
+        SG_CHECK_EQUAL(freq, 11025.0f);
+
+        // odd sized chunks give the same data as decoding at once
+        simgear::WavStream stream;
+        SG_VERIFY(stream.open(SGPath::fromUtf8(jet(file.name))));
+        SG_CHECK_EQUAL(stream.get_decoded_size(), file.size);
+        SG_CHECK_EQUAL(stream.get_format(), file.format);
+
+        std::vector<unsigned char> chunked, chunk(1111);
+        size_t n;
+        while ((n = stream.read(chunk.data(), chunk.size())) > 0) {
+            SG_CHECK_EQUAL(n % stream.get_chunk_align(), 0);
+            chunked.insert(chunked.end(), chunk.begin(), chunk.begin() + n);
+        }
+        SG_CHECK_EQUAL(chunked.size(), file.size);
+        SG_VERIFY(memcmp(chunked.data(), data, file.size) == 0);
+
+        // nothing is returned for a buffer smaller than one unit
+        SG_VERIFY(stream.rewind());
+        SG_CHECK_EQUAL(stream.read(chunk.data(), stream.get_chunk_align() - 1), 0);
+        SG_CHECK_EQUAL(stream.read(chunk.data(), chunk.size()), chunk.size() - chunk.size() % stream.get_chunk_align());
+        SG_VERIFY(memcmp(chunk.data(), data, 1000) == 0);
+
+        if (file.format == SG_SAMPLE_MONO16) {
+            const int16_t* pcm = (const int16_t*)data;
+            decoded.emplace_back(pcm, pcm + jet_size);
+        }
+        free(data);
+    }
+
+    // both compressed versions decode to about the same signal
+    double diff = 0, power = 0;
+    for (size_t i = 0; i < jet_size; ++i) {
+        diff += std::pow(decoded[0][i] - decoded[1][i], 2.0);
+        power += std::pow(decoded[0][i], 2.0);
+    }
+    SG_VERIFY(diff < 0.05 * power);
+
+    simgear::WavStream missing;
+    SG_VERIFY(!missing.open(SGPath::fromUtf8(jet("no_such.wav"))));
+    SG_VERIFY(!missing.is_open());
+}
+
+void test_sharing()
+{
+    cout << "Testing sharing of decoded samples" << endl;
+
+    decodes = 0;
+    SGSampleCache cache(decodeWAV);
+    SGDecodedSampleRef a = cache.get(jet("jet.wav"));
+    SGDecodedSampleRef b = cache.get(jet("jet.wav"));
+    SG_VERIFY(a.valid());
+    SG_VERIFY(a == b);
+    SG_CHECK_EQUAL(decodes, 1);
+    SG_CHECK_EQUAL(a->get_size(), jet_size);
+    SG_CHECK_EQUAL(a->get_format(), SG_SAMPLE_MONO8);
+    SG_CHECK_EQUAL(a->get_frequency(), 11025);
+
+    SGSampleCache::Stats stats = cache.get_stats();
+    SG_CHECK_EQUAL(stats.hits, 1);
+    SG_CHECK_EQUAL(stats.misses, 1);
+    SG_CHECK_EQUAL(stats.bytes, jet_size);
+    SG_CHECK_EQUAL(stats.unused_bytes, 0);
+
+    // several threads asking for the same file share one decode
+    std::vector<SGDecodedSampleRef> results(4);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < results.size(); ++i)
+        threads.emplace_back([&, i] { results[i] = cache.get(jet("jet_ima4.wav")); });
+    for (auto& t : threads)
+        t.join();
+    SG_CHECK_EQUAL(decodes, 2);
+    for (const auto& r : results)
+        SG_VERIFY(r.valid() && r == results[0]);
+
+    // failures are not cached
+    SG_VERIFY(!cache.get(jet("no_such.wav")).valid());
+    SG_VERIFY(!cache.get(jet("no_such.wav")).valid());
+    SG_CHECK_EQUAL(decodes, 4);
+    SG_CHECK_EQUAL(cache.size(), 2);
+}
+
+void test_memory()
+{
+    cout << "Testing memory use of the sample cache" << endl;
+
+    SGSampleCache cache(decodeWAV, jet_ulaw_size + jet_ima4_size);
+    SGDecodedSampleRef plain = cache.get(jet("jet.wav"));
+    SGDecodedSampleRef ulaw = cache.get(jet("jet_ulaw.wav"));
+    SGDecodedSampleRef ima4 = cache.get(jet("jet_ima4.wav"));
+
+    const size_t all = jet_size + jet_ulaw_size + jet_ima4_size;
+    SGSampleCache::Stats stats = cache.get_stats();
+    SG_CHECK_EQUAL(stats.bytes, all);
+    SG_CHECK_EQUAL(stats.unused_bytes, 0);
+
+    // samples in use are never dropped
+    cache.flush();
+    SG_CHECK_EQUAL(cache.size(), 3);
+
+    // unused ones are, least recently used first, beyond the budget
+    plain.reset();
+    ulaw.reset();
+    ima4.reset();
+    SG_CHECK_EQUAL(cache.get_stats().unused_bytes, all);
+    cache.trim();
+    stats = cache.get_stats();
+    SG_CHECK_EQUAL(cache.size(), 2);
+    SG_CHECK_EQUAL(stats.bytes, jet_ulaw_size + jet_ima4_size);
+    SG_CHECK_EQUAL(stats.evictions, 1);
+    SG_VERIFY(!cache.find(jet("jet.wav")).valid());
+    SG_VERIFY(cache.find(jet("jet_ulaw.wav")).valid());
+
+    // jet_ulaw.wav is now the most recently used one
+    cache.set_max_unused_bytes(jet_ulaw_size);
+    SG_CHECK_EQUAL(cache.size(), 1);
+    SG_VERIFY(cache.find(jet("jet_ulaw.wav")).valid());
+
+    cache.flush();
+    SG_CHECK_EQUAL(cache.size(), 0);
+    SG_CHECK_EQUAL(cache.get_stats().bytes, 0);
+}
+
+void test_async()
+{
+    cout << "Testing background loading" << endl;
+
+    decodes = 0;
+    SGSampleCache cache(decodeWAV);
+    const std::thread::id main_thread = std::this_thread::get_id();
+    int ready = 0, failed = 0;
+    auto callback = [&](const std::string& path, SGDecodedSampleRef sample) {
+        SG_VERIFY(std::this_thread::get_id() == main_thread);
+        if (sample.valid())
+            ++ready;
+        else
+            ++failed;
+    };
+
+    cache.load_async(jet("jet.wav"), callback);
+    cache.load_async(jet("jet_ulaw.wav"), callback);
+    cache.load_async(jet("jet_ima4.wav"), callback);
+    cache.load_async(jet("jet.wav"), callback);
+    cache.load_async(jet("no_such.wav"), callback);
+
+    for (int i = 0; i < 1000 && ready + failed < 5; ++i) {
+        cache.process_ready();
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    SG_CHECK_EQUAL(ready, 4);
+    SG_CHECK_EQUAL(failed, 1);
+    SG_CHECK_EQUAL(decodes, 4);
+    SG_CHECK_EQUAL(cache.size(), 3);
+
+    // already decoded: the callback still runs from process_ready()
+    cache.load_async(jet("jet.wav"), callback);
+    SG_CHECK_EQUAL(ready, 4);
+    SG_CHECK_EQUAL(cache.process_ready(), 1);
+    SG_CHECK_EQUAL(ready, 5);
+    SG_CHECK_EQUAL(decodes, 4);
+
+    SGDecodedSampleRef sample = cache.get(jet("jet_ima4.wav"));
+    SG_CHECK_EQUAL(sample->get_size(), jet_ima4_size);
+    SG_CHECK_EQUAL(decodes, 4);
+}
+
+int main(int argc, char* argv[])
+{
+    test_stream();
+    test_sharing();
+    test_memory();
+    test_async();
+
+    return EXIT_SUCCESS;
+}
@@ -14,6 +14,8 @@
 #  include <simgear_config.h>
 #endif
 
+#include <algorithm>
+
 #include <simgear/compiler.h>
 #include <simgear/sg_inlines.h>
 #include <simgear/debug/logstream.hxx>
@@ -21,6 +23,16 @@
 #include "soundmgr.hxx"
 #include "sample_group.hxx"
 
+// Rolloff factor the sound manager sets on its sources
+static const float ROLLOFF_FACTOR = 0.3f;
+
+// Samples quieter than -60 dB at the listener don't get a voice
+static const float MIN_AUDIBILITY = 0.001f;
+
+// Samples keep their voice until outranked by about 2 dB, so samples of
+// about the same audibility don't take turns every frame
+static const float VOICE_HYSTERESIS = 1.25f;
+
 SGSampleGroup::SGSampleGroup ()
 {
 }
@@ -101,6 +113,109 @@ void SGSampleGroup::check_playing_sample(SGSoundSample *sample)
     }
 }
 
+void SGSampleGroup::release_voice(SGSoundSample *sample)
+{
+    unsigned int source = sample->get_source();
+    sample->no_valid_source();
+    _smgr->release_source( source );
+
+    if ( !sample->is_looping() ) {
+        // no point in playing it from the start once it gets a voice again
+        sample->stop();
+        _smgr->release_buffer( sample );
+    }
+}
+
+// Gain of the inverse distance clamped model the sound manager uses,
+// ignoring the audio cone
+float SGSampleGroup::get_audibility(SGSoundSample *sample, const SGVec3d& listener)
+{
+    if ( _tied_to_listener ) {
+        return sample->get_volume();
+    }
+
+    float dist = length( sample->get_position() - listener );
+    if ( dist > sample->get_max_dist() ) {
+        return 0.0f;
+    }
+
+    float ref = sample->get_reference_dist();
+    if ( ref <= 0.0f ) {
+        return sample->get_volume();
+    }
+    dist = std::max( dist, ref );
+    return sample->get_volume() * ref / ( ref + ROLLOFF_FACTOR * (dist - ref) );
+}
+
+void SGSampleGroup::collect_voices( std::vector<SGSoundVoice>& voices )
+{
+    if ( !_active || _pause ) return;
+
+    _voices_collected = true;
+    const SGVec3d& listener = _smgr->get_position();
+
+    if ( !_tied_to_listener ) {
+        SGVec3d base_position = SGVec3d::fromGeod(_base_pos);
+        bool culled = distSqr( base_position, listener ) > _audible_radius * _audible_radius;
+        if ( culled && !_culled ) {
+            for (auto current : _samples) {
+                if ( current.second->is_valid_source() ) {
+                    release_voice( current.second );
+                }
+            }
+        } else if ( !culled && _culled ) {
+            _changed = true;
+        }
+
+        _culled = culled;
+        if ( _culled ) return;
+    }
+
+    // Update the position and orientation information for all samples.
+    if ( _changed || _smgr->has_changed() ) {
+        update_pos_and_orientation();
+        _changed = false;
+    }
+
+    for (auto current : _samples) {
+        SGSoundSample *sample = current.second;
+        if ( !sample->is_playing() ) continue;
+
+        float audibility = get_audibility( sample, listener );
+        if ( audibility < MIN_AUDIBILITY ) {
+            sample->set_culled( true );
+            if ( sample->is_valid_source() ) {
+                release_voice( sample );
+            }
+            continue;
+        }
+
+        if ( sample->is_valid_source() ) {
+            audibility *= VOICE_HYSTERESIS;
+        }
+        voices.push_back( { this, sample, audibility * sample->get_priority() } );
+    }
+}
+
+void SGSampleGroup::assign_voices( std::vector<SGSoundVoice>& voices,
+                                   size_t max_voices )
+{
+    if ( voices.size() > max_voices ) {
+        std::nth_element( voices.begin(), voices.begin() + max_voices, voices.end(),
+                          []( const SGSoundVoice& a, const SGSoundVoice& b ) {
+                              return a.audibility > b.audibility;
+                          } );
+    }
+
+    for (size_t i = 0; i < voices.size(); ++i) {
+        SGSoundSample *sample = voices[i].sample;
+        sample->set_culled( i >= max_voices );
+        if ( sample->is_culled() && sample->is_valid_source() ) {
+            voices[i].group->release_voice( sample );
+        }
+    }
+}
+
 void SGSampleGroup::update( double dt ) {
 
     if ( !_active || _pause ) return;
@@ -109,8 +224,13 @@ void SGSampleGroup::update( double dt ) {
 
     cleanup_removed_samples();
 
+    // Culling only applies if collect_voices() ran for this update
+    bool collected = _voices_collected;
+    _voices_collected = false;
+    if ( collected && _culled ) return;
+
     // Update the position and orientation information for all samples.
-    if ( _changed || _smgr->has_changed() ) {
+    if ( !collected && ( _changed || _smgr->has_changed() ) ) {
         update_pos_and_orientation();
         _changed = false;
     }
@@ -118,14 +238,15 @@ void SGSampleGroup::update( double dt ) {
     for (auto current : _samples) {
         SGSoundSample *sample = current.second;
 
-        if ( !sample->is_valid_source() && sample->is_playing() && !sample->test_out_of_range()) {
+        if ( !sample->is_valid_source() && sample->is_playing() && !sample->test_out_of_range() &&
+             !(collected && sample->is_culled()) ) {
             start_playing_sample(sample);
 
         } else if ( sample->is_valid_source() ) {
             check_playing_sample(sample);
         }
-        testForMgrError("update");
     }
+    testForMgrError("update");
 
     for (const auto& refname : _refsToRemoveFromSamplesMap) {
         _samples.erase(refname);
@@ -144,6 +265,8 @@ bool SGSampleGroup::add( SGSharedPtr<SGSoundSample> sound,
     }
 
     _samples[refname] = sound;
+    _audible_radius = HUGE_VAL;     // until the sample has a position
+    _changed = true;                // which the next update computes
     return true;
 }
 
@@ -304,6 +427,7 @@ void SGSampleGroup::update_pos_and_orientation() {
 
     float speed = 0.0f;
     double mAngle = SGD_PI_2;
+    double audible_radius = 0.0;
     if (!_tied_to_listener) {
         const float Rvapor = 461.52; // Water vapor: individual gas constant
         const float Rair = 287.5;    // Air: individual gas constant
@@ -356,8 +480,13 @@ void SGSampleGroup::update_pos_and_orientation() {
             } else if ((dist2 < max2) && sample->test_out_of_range()) {
                 sample->set_out_of_range(false);
             }
+
+            double radius = length(sample->get_position() - base_position);
+            audible_radius = std::max(audible_radius, radius + sample->get_max_dist());
         }
     }
+
+    _audible_radius = _tied_to_listener ? HUGE_VAL : audible_radius;
 }
 
 void SGSampleGroup::update_sample_config( SGSoundSample *sample )
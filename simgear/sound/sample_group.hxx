@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <cmath>
 #include <string>
 #include <vector>
 #include <map>
@@ -28,6 +29,16 @@
 using sample_map = std::map< std::string, SGSharedPtr<SGSoundSample> >;
 
 class SGSoundMgr;
+class SGSampleGroup;
+
+/**
+ * A playing sample competing for one of the voices of the sound manager
+ */
+struct SGSoundVoice {
+    SGSampleGroup *group;
+    SGSoundSample *sample;
+    float audibility;   ///< estimated gain at the listener, times the priority
+};
 
 class SGSampleGroup : public SGWeakReferenced
 {
@@ -66,6 +77,22 @@ public:
      */
     virtual void update (double dt);
 
+    /**
+     * Add the playing samples which are audible at the listener position
+     * to @a voices, and take the voice from the inaudible ones. The whole
+     * group is skipped, at the cost of a single distance test, while the
+     * listener is farther away than any of its samples can be heard.
+     * The sound manager calls this for all groups before update().
+     */
+    void collect_voices( std::vector<SGSoundVoice>& voices );
+
+    /**
+     * Give voices to the @a max_voices most audible samples, and take
+     * them from the others. Reorders @a voices.
+     */
+    static void assign_voices( std::vector<SGSoundVoice>& voices,
+                               size_t max_voices );
+
     /**
      * Register an audio sample to this group.
      * @param sound Pointer to a pre-initialized audio sample
@@ -212,6 +239,8 @@ private:
     void cleanup_removed_samples();
     void start_playing_sample(SGSoundSample *sample);
     void check_playing_sample(SGSoundSample *sample);
+    void release_voice(SGSoundSample *sample);
+    float get_audibility(SGSoundSample *sample, const SGVec3d& listener);
 
     bool _changed = false;
     bool _pause = false;
@@ -222,6 +251,12 @@ private:
 
     bool _tied_to_listener = false;
 
+    // Distance from the base position beyond which no sample is audible,
+    // recomputed with the sample positions
+    double _audible_radius = HUGE_VAL;
+    bool _culled = false;
+    bool _voices_collected = false;
+
     SGVec3d _velocity = SGVec3d::zeros();
     SGQuatd _orientation = SGQuatd::zeros();
     SGGeod _base_pos;
@@ -0,0 +1,325 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Test culling and voice allocation of sample groups on a null backend
+ */
+
+#include <simgear_config.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <simgear/misc/test_macros.hxx>
+
+#include "sample.hxx"
+#include "sample_group.hxx"
+#include "soundmgr.hxx"
+
+using std::cout;
+using std::endl;
+
+/**
+ * A sound manager which plays nothing, and only keeps track of the
+ * sources it hands out.
+ */
+class NullSoundMgr : public SGSoundMgr
+{
+public:
+    explicit NullSoundMgr(unsigned int sources)
+    {
+        for (unsigned int i = sources; i > 0; --i)
+            _free.push_back(i);
+    }
+
+    ~NullSoundMgr()
+    {
+        // destroy the groups while the overrides still exist
+        for (auto& group : _groups)
+            remove(group.first);
+        _groups.clear();
+    }
+
+    SGSampleGroup* add_group(const std::string& name)
+    {
+        SGSampleGroup* group = new SGSampleGroup(this, name);
+        group->activate();
+        _groups[name] = group;
+        return group;
+    }
+
+    /// What update() does for the sample groups of a working backend
+    void frame(double dt = 0.1)
+    {
+        size_t max_voices = _num_sources;
+        if (get_max_voices() > 0)
+            max_voices = std::min(max_voices, get_max_voices());
+
+        _voices.clear();
+        for (auto& group : _groups)
+            group.second->collect_voices(_voices);
+        SGSampleGroup::assign_voices(_voices, max_voices);
+
+        for (auto& group : _groups)
+            group.second->update(dt);
+    }
+
+    void set_listener(const SGGeod& pos) { _listener = SGVec3d::fromGeod(pos); }
+    const SGVec3d& get_position() const override { return _listener; }
+
+    void sample_init(SGSoundSample* sample) override
+    {
+        if (!_free.empty()) {
+            sample->set_source(_free.back());
+            _free.pop_back();
+        }
+    }
+
+    void sample_play(SGSoundSample* sample) override
+    {
+        if (sample->is_valid_source()) {
+            _playing[sample->get_source()] = sample;
+            ++plays;
+        }
+    }
+
+    void sample_stop(SGSoundSample* sample) override
+    {
+        if (sample->is_valid_source()) {
+            sample->no_valid_source();
+            release_source(sample->get_source());
+        }
+    }
+
+    void sample_destroy(SGSoundSample* sample) override
+    {
+        sample_stop(sample);
+        sample->no_valid_buffer();
+    }
+
+    bool is_sample_stopped(SGSoundSample* sample) override
+    {
+        return !sample->is_valid_source() || !_playing.count(sample->get_source());
+    }
+
+    void release_source(unsigned int source) override
+    {
+        if (_playing.erase(source) > 0)
+            _free.push_back(source);
+    }
+
+    void release_buffer(SGSoundSample* sample) override { sample->no_valid_buffer(); }
+    void sample_suspend(SGSoundSample*) override {}
+    void sample_resume(SGSoundSample*) override {}
+    bool testForError(std::string, std::string) override { return false; }
+
+    void update_sample_config(SGSoundSample* sample, SGVec3d&, SGVec3f&, SGVec3f&) override
+    {
+        if (sample->is_valid_source())
+            ++config_updates;
+    }
+
+    bool has_voice(SGSoundSample* sample) const
+    {
+        return sample->is_valid_source() && _playing.count(sample->get_source());
+    }
+
+    size_t voices_in_use() const { return _playing.size(); }
+
+    int plays = 0;
+    int config_updates = 0;
+
+private:
+    const size_t _num_sources = 16;
+    std::vector<unsigned int> _free;
+    std::map<unsigned int, SGSoundSample*> _playing;
+    std::map<std::string, SGSharedPtr<SGSampleGroup>> _groups;
+    std::vector<SGSoundVoice> _voices;
+    SGVec3d _listener = SGVec3d::zeros();
+};
+
+static SGSoundSample* add_sample(SGSampleGroup* group, const std::string& name,
+                                 float volume, bool looping = true)
+{
+    SGSharedPtr<SGSoundSample> sample = new SGSoundSample();
+    sample->set_volume(volume);
+    sample->set_reference_dist(50);
+    sample->set_max_dist(1000);
+    group->add(sample, name);
+    sample->play(looping);
+    return sample;
+}
+
+static const SGGeod listener = SGGeod::fromDegM(10.0, 50.0, 100.0);
+
+static SGGeod north_of_listener(double meters)
+{
+    return SGGeod::fromDegM(10.0, 50.0 + meters / 111000.0, 100.0);
+}
+
+void test_culling()
+{
+    cout << "Testing culling of distant sample groups" << endl;
+
+    NullSoundMgr smgr(16);
+    smgr.set_listener(listener);
+
+    // a crowded multiplayer session: most aircraft are far away
+    std::vector<SGSampleGroup*> near, far;
+    std::vector<SGSoundSample*> near_samples, far_samples;
+    for (int i = 0; i < 200; ++i) {
+        const bool is_near = (i % 50 == 0);
+        SGSampleGroup* group = smgr.add_group("aircraft" + std::to_string(i));
+        group->set_position_geod(north_of_listener(is_near ? 100.0 + i : 20000.0 + 100.0 * i));
+        group->set_orientation(SGQuatd::unit());
+        (is_near ? near : far).push_back(group);
+        for (int s = 0; s < 3; ++s) {
+            SGSoundSample* sample = add_sample(group, "engine" + std::to_string(s), 1.0f);
+            (is_near ? near_samples : far_samples).push_back(sample);
+        }
+    }
+
+    smgr.frame();
+    SG_CHECK_EQUAL(smgr.voices_in_use(), near_samples.size());
+    SG_CHECK_EQUAL(smgr.plays, (int)near_samples.size());
+    for (SGSoundSample* sample : near_samples)
+        SG_VERIFY(smgr.has_voice(sample) && !sample->is_culled());
+    for (SGSoundSample* sample : far_samples)
+        SG_VERIFY(!sample->is_valid_source() && sample->is_playing());
+
+    // moving groups out of hearing range cost nothing per sample:
+    // their sample positions aren't even updated any more
+    const SGVec3d far_position = far_samples.front()->get_position();
+    for (int f = 0; f < 10; ++f) {
+        for (size_t i = 0; i < far.size(); ++i)
+            far[i]->set_position_geod(north_of_listener(20000.0 + 100.0 * i + 10.0 * f));
+        smgr.config_updates = 0;
+        smgr.frame();
+        SG_VERIFY(smgr.config_updates <= (int)near_samples.size());
+    }
+    SG_VERIFY(far_samples.front()->get_position() == far_position);
+    SG_CHECK_EQUAL(smgr.plays, (int)near_samples.size());
+
+    // a group flying away loses its voices, and gets them back on return
+    near.front()->set_position_geod(north_of_listener(5000.0));
+    smgr.frame();
+    SG_CHECK_EQUAL(smgr.voices_in_use(), near_samples.size() - 3);
+    for (int s = 0; s < 3; ++s) {
+        SG_VERIFY(!near_samples[s]->is_valid_source());
+        SG_VERIFY(near_samples[s]->is_playing());
+    }
+
+    near.front()->set_position_geod(north_of_listener(100.0));
+    smgr.frame();
+    SG_CHECK_EQUAL(smgr.voices_in_use(), near_samples.size());
+    SG_CHECK_EQUAL(smgr.plays, (int)near_samples.size() + 3);
+}
+
+void test_voice_limit()
+{
+    cout << "Testing the voice limit" << endl;
+
+    NullSoundMgr smgr(16);
+    smgr.set_listener(listener);
+    smgr.set_max_voices(4);
+
+    SGSampleGroup* group = smgr.add_group("cockpit");
+    group->tie_to_listener();
+
+    std::vector<SGSoundSample*> samples;
+    for (int i = 0; i < 10; ++i)
+        samples.push_back(add_sample(group, "sample" + std::to_string(i), 0.1f * (i + 1)));
+
+    // the four loudest play
+    smgr.frame();
+    SG_CHECK_EQUAL(smgr.voices_in_use(), 4);
+    for (int i = 0; i < 10; ++i)
+        SG_CHECK_EQUAL(smgr.has_voice(samples[i]), i >= 6);
+
+    // a louder one takes the voice of the quietest, which keeps playing
+    samples[0]->set_volume(1.0f);
+    smgr.frame();
+    SG_CHECK_EQUAL(smgr.voices_in_use(), 4);
+    SG_VERIFY(smgr.has_voice(samples[0]));
+    SG_VERIFY(!smgr.has_voice(samples[6]));
+    SG_VERIFY(samples[6]->is_playing() && samples[6]->is_culled());
+
+    // about as loud as one playing already isn't enough to take its voice
+    samples[6]->set_volume(0.75f);
+    smgr.frame();
+    SG_VERIFY(!smgr.has_voice(samples[6]));
+
+    // but priority is
+    samples[1]->set_priority(100.0f);
+    smgr.frame();
+    SG_VERIFY(smgr.has_voice(samples[1]));
+    SG_CHECK_EQUAL(smgr.voices_in_use(), 4);
+
+    // samples played once are stopped when they lose their voice
+    SGSoundSample* once = add_sample(group, "once", 1.0f, false);
+    once->set_priority(10.0f);
+    smgr.set_max_voices(5);
+    smgr.frame();
+    SG_VERIFY(smgr.has_voice(once));
+    once->set_volume(0.0f);
+    smgr.frame();
+    SG_VERIFY(!once->is_valid_source());
+    SG_VERIFY(!once->is_playing());
+
+    // silent looped samples give their voice up, and get it back later
+    samples[9]->set_volume(0.0f);
+    smgr.frame();
+    SG_VERIFY(!smgr.has_voice(samples[9]));
+    SG_VERIFY(samples[9]->is_playing());
+    samples[9]->set_volume(1.0f);
+    smgr.frame();
+    SG_VERIFY(smgr.has_voice(samples[9]));
+}
+
+void test_distance()
+{
+    cout << "Testing distance attenuation" << endl;
+
+    NullSoundMgr smgr(16);
+    smgr.set_listener(listener);
+    smgr.set_max_voices(1);
+
+    // the nearer of two equally loud groups gets the voice
+    SGSampleGroup* a = smgr.add_group("a");
+    SGSampleGroup* b = smgr.add_group("b");
+    a->set_orientation(SGQuatd::unit());
+    b->set_orientation(SGQuatd::unit());
+    a->set_position_geod(north_of_listener(600.0));
+    b->set_position_geod(north_of_listener(200.0));
+    SGSoundSample* sa = add_sample(a, "engine", 1.0f);
+    SGSoundSample* sb = add_sample(b, "engine", 1.0f);
+
+    smgr.frame();
+    SG_VERIFY(smgr.has_voice(sb));
+    SG_VERIFY(!smgr.has_voice(sa));
+
+    a->set_position_geod(north_of_listener(60.0));
+    smgr.frame();
+    SG_VERIFY(smgr.has_voice(sa));
+    SG_VERIFY(!smgr.has_voice(sb));
+
+    // beyond the maximum distance nothing plays, whatever the limit
+    smgr.set_max_voices(0);
+    a->set_position_geod(north_of_listener(1500.0));
+    smgr.frame();
+    SG_VERIFY(!smgr.has_voice(sa));
+    SG_VERIFY(smgr.has_voice(sb));
+}
+
+int main(int argc, char* argv[])
+{
+    test_culling();
+    test_voice_limit();
+    test_distance();
+
+    return EXIT_SUCCESS;
+}
@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 #include <vector>
 #include <map>
@@ -32,6 +33,9 @@ class SGSoundSample;
 
 /**
  * Manage a collection of SGSampleGroup instances
+ *
+ * The methods sample groups use to drive the audio backend are virtual, so
+ * that tests can run sample groups on a null backend without audio device.
  */
 class SGSoundMgr : public SGSubsystem
 {
@@ -118,7 +122,7 @@ public:
      *
      * @return OpenAL listener position
      */
-    const SGVec3d& get_position() const;
+    virtual const SGVec3d& get_position() const;
 
     /**
      * Set the velocity vector (in meters per second) of the sound manager
@@ -199,7 +203,7 @@ public:
      *
      * @param source OpenAL source-id to free
      */
-    void release_source( unsigned int source );
+    virtual void release_source( unsigned int source );
 
     /**
      * Get a free OpenAL buffer-id
@@ -215,49 +219,49 @@ public:
      *
      * @param sample Pointer to an audio sample for which to free the buffer
      */
-    void release_buffer( SGSoundSample *sample );
+    virtual void release_buffer( SGSoundSample *sample );
 
     /**
      * Initialize sample for playback.
      *
      * @param sample Pointer to an audio sample to initialize.
      */
-    void sample_init( SGSoundSample *sample );
+    virtual void sample_init( SGSoundSample *sample );
 
     /**
      * Stop and destroy a sample
      *
      * @param sample Pointer to an audio sample to destroy.
      */
-    void sample_destroy( SGSoundSample *sample );
+    virtual void sample_destroy( SGSoundSample *sample );
 
     /**
      * Start playback of a sample
      *
      * @param sample Pointer to an audio sample to start playing.
      */
-    void sample_play( SGSoundSample *sample );
+    virtual void sample_play( SGSoundSample *sample );
 
     /**
      * Stop a sample
      *
      * @param sample Pointer to an audio sample to stop.
      */
-    void sample_stop( SGSoundSample *sample );
+    virtual void sample_stop( SGSoundSample *sample );
 
     /**
      * Suspend playback of a sample
      *
      * @param sample Pointer to an audio sample to suspend.
      */
-    void sample_suspend( SGSoundSample *sample );
+    virtual void sample_suspend( SGSoundSample *sample );
 
     /**
      * Resume playback of a sample
      *
      * @param sample Pointer to an audio sample to resume.
      */
-    void sample_resume( SGSoundSample *sample );
+    virtual void sample_resume( SGSoundSample *sample );
 
     /**
      * Check if a sample is stopped, or still playing
@@ -265,14 +269,14 @@ public:
      * @param sample Pointer to an audio sample to test.
      * @return true if the sample is stopped.
      */
-    bool is_sample_stopped( SGSoundSample *sample );
+    virtual bool is_sample_stopped( SGSoundSample *sample );
 
     /**
      * Update all status and 3d parameters of a sample.
      *
      * @param sample Pointer to an audio sample to update.
      */
-    void update_sample_config( SGSoundSample *sample, SGVec3d& position, SGVec3f& orientation, SGVec3f& velocity );
+    virtual void update_sample_config( SGSoundSample *sample, SGVec3d& position, SGVec3f& orientation, SGVec3f& velocity );
 
     /**
      * Test if the position of the sound manager has changed.
@@ -299,6 +303,37 @@ public:
                        int *freq,
                        int *block );
 
+    /**
+     * Decode a sample file in the background, so starting to play it later
+     * doesn't stall. Decoded files are shared by all sample groups, and
+     * kept for a while after they are no longer used.
+     *
+     * @param samplepath Path to the file to load
+     * @param ready Called from update() once loaded, with false on error
+     */
+    void preload( const std::string &samplepath,
+                  std::function<void(bool)> ready = std::function<void(bool)>() );
+
+    /**
+     * Set the decoded size above which sample files are streamed: decoded
+     * a chunk at a time while they play, instead of kept in memory whole.
+     *
+     * @param bytes Size in bytes, 0 to never stream
+     */
+    inline void set_stream_threshold( size_t bytes ) { _stream_threshold = bytes; }
+    inline size_t get_stream_threshold() const { return _stream_threshold; }
+
+    /**
+     * Limit the number of samples playing at the same time. When more are
+     * playing, only the most audible ones, estimated from their volume,
+     * distance to the listener and priority, get a voice.
+     *
+     * @param voices Maximum number of voices, 0 for as many as the
+     *               backend has sources
+     */
+    inline void set_max_voices( size_t voices ) { _max_voices = voices; }
+    inline size_t get_max_voices() const { return _max_voices; }
+
     /**
      * Get a list of available playback devices.
      */
@@ -310,7 +345,7 @@ public:
     const std::string& get_vendor() { return _vendor; }
     const std::string& get_renderer() { return _renderer; }
 
-    bool testForError(std::string s, std::string name = "sound manager");
+    virtual bool testForError(std::string s, std::string name = "sound manager");
 
 private:
     class SoundManagerPrivate;
@@ -324,6 +359,11 @@ private:
 
     double _sound_velocity = SPEED_OF_SOUND;
 
+    // About 24 seconds of 16 bit mono at 44.1 kHz
+    size_t _stream_threshold = 2 * 1024 * 1024;
+
+    size_t _max_voices = 0;
+
     // Position of the listener.
     SGGeod _geod_pos;
 
@@ -101,6 +101,7 @@ public:
     }
 
     sample_group_map _sample_groups;
+    std::vector<SGSoundVoice> _voices;
 };
 
 
@@ -266,6 +267,15 @@ void SGSoundMgr::update( double dt )
             d->update_pos_and_orientation();
         }
 
+        // AeonWave has no fixed number of emitters, so only the configured
+        // limit applies
+        size_t max_voices = (_max_voices > 0) ? _max_voices : d->_voices.max_size();
+        d->_voices.clear();
+        for ( auto current : d->_sample_groups ) {
+            current.second->collect_voices(d->_voices);
+        }
+        SGSampleGroup::assign_voices(d->_voices, max_voices);
+
         for ( auto current : d->_sample_groups ) {
             current.second->update(dt);
         }
@@ -729,3 +739,10 @@ bool SGSoundMgr::load( const std::string &samplepath,
 {
     return true;
 }
+
+void SGSoundMgr::preload( const std::string &samplepath,
+                          std::function<void(bool)> ready )
+{
+    // AeonWave decodes files itself, when their buffer is requested
+    if (ready) ready( SGPath::fromUtf8(samplepath).exists() );
+}
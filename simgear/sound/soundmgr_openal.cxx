@@ -22,6 +22,7 @@
 
 #include "soundmgr.hxx"
 #include "readwav.hxx"
+#include "sample_cache.hxx"
 #include "sample_group.hxx"
 
 #include <simgear/debug/ErrorReportingCallback.hxx>
@@ -39,6 +40,10 @@ using std::vector;
 
 #define MAX_SOURCES	128
 
+// buffers queued per streamed sample, and the size of each
+#define STREAM_BUFFERS		3
+#define STREAM_CHUNK_SIZE	(64*1024)
+
 #ifndef ALC_ALL_DEVICES_SPECIFIER
 # define ALC_ALL_DEVICES_SPECIFIER	0x1013
 #endif
@@ -66,13 +71,70 @@ struct refUint {
     ~refUint() {};
 };
 
+// A sample file decoded a chunk at a time while it plays
+struct SampleStream {
+    simgear::WavStream wav;
+    ALuint buffers[STREAM_BUFFERS];
+    ALenum format = AL_NONE;
+    ALsizei frequency = 0;
+    ALsizei samples_block = 0;
+    bool looping = false;
+    bool finished = false;
+    std::vector<unsigned char> chunk;
+
+    // Decode the next chunk into buffer, false at the end of the sample
+    bool fill( ALuint buffer )
+    {
+        size_t size = wav.read( chunk.data(), chunk.size() );
+        if ( size == 0 && looping && wav.rewind() ) {
+            size = wav.read( chunk.data(), chunk.size() );
+        }
+        if ( size == 0 ) {
+            finished = true;
+            return false;
+        }
+
+        if ( samples_block ) {
+            alBufferi( buffer, AL_UNPACK_BLOCK_ALIGNMENT_SOFT, samples_block );
+        }
+        alBufferData( buffer, format, chunk.data(), size, frequency );
+        return true;
+    }
+};
+
 using buffer_map = std::map < std::string, refUint >;
 using sample_group_map = std::map < std::string, SGSharedPtr<SGSampleGroup> >;
+using stream_map = std::map < ALuint, std::unique_ptr<SampleStream> >;
 
 inline bool isNaN(float *v) {
    return (SGMisc<float>::isNaN(v[0]) || SGMisc<float>::isNaN(v[1]) || SGMisc<float>::isNaN(v[2]));
 }
 
+static ALenum get_al_format( unsigned int format, const std::string& name )
+{
+    switch( format )
+    {
+    case SG_SAMPLE_MONO16:
+        return AL_FORMAT_MONO16;
+    case SG_SAMPLE_MONO8:
+        return AL_FORMAT_MONO8;
+    case SG_SAMPLE_MULAW:
+        return AL_FORMAT_MONO_MULAW_EXT;
+    case SG_SAMPLE_ADPCM:
+        return AL_FORMAT_MONO_IMA4;
+
+    case SG_SAMPLE_STEREO16:
+        SG_LOG(SG_SOUND, SG_POPUP, "Stereo sound detected:\n" << name << "\nUse two separate mono files instead if required.");
+        return AL_FORMAT_STEREO16;
+    case SG_SAMPLE_STEREO8:
+        SG_LOG(SG_SOUND, SG_POPUP, "Stereo sound detected:\n" << name << "\nUse two separate mono files instead if required.");
+        return AL_FORMAT_STEREO8;
+    default:
+        SG_LOG(SG_SOUND, SG_ALERT, "unsupported audio format");
+        return AL_NONE;
+    }
+}
+
 
 class SGSoundMgr::SoundManagerPrivate
 {
@@ -111,7 +173,106 @@ public:
 
         _absolute_pos = _base_pos;
     }
-        
+
+    /**
+     * Queue the first chunks of a sample file on source, if it is large
+     * enough to be streamed instead of loaded into a single buffer.
+     */
+    bool start_stream( SGSoundSample *sample, ALuint source, size_t threshold, bool block_support )
+    {
+        if ( !sample->is_file() || threshold == 0 || sample->is_valid_buffer() ||
+             _buffers.find( sample->get_sample_name() ) != _buffers.end() ) {
+            return false;
+        }
+
+        auto stream = std::make_unique<SampleStream>();
+        if ( !stream->wav.open( sample->file_path() ) ) {
+            // already reported, don't try to load it again
+            sample->set_buffer( SGSoundMgr::FAILED_BUFFER );
+            return false;
+        }
+        if ( stream->wav.get_decoded_size() <= threshold ) {
+            return false;
+        }
+
+        stream->format = get_al_format( stream->wav.get_format(), sample->get_sample_name() );
+        if ( stream->format == AL_NONE ) {
+            sample->set_buffer( SGSoundMgr::FAILED_BUFFER );
+            return false;
+        }
+        if ( stream->format == AL_FORMAT_MONO_IMA4 && block_support ) {
+            stream->samples_block = BLOCKSIZE_TO_SMP( stream->wav.get_block_align() );
+        }
+        stream->frequency = (ALsizei)stream->wav.get_frequency();
+        stream->looping = sample->is_looping();
+        stream->chunk.resize( STREAM_CHUNK_SIZE );
+
+        sample->set_block_align( stream->wav.get_block_align() );
+        sample->set_frequency( stream->frequency );
+        sample->set_format( stream->wav.get_format() );
+        sample->set_size( stream->wav.get_decoded_size() );
+
+        alGetError();
+        alGenBuffers( STREAM_BUFFERS, stream->buffers );
+        if ( alGetError() != AL_NO_ERROR ) {
+            return false;
+        }
+
+        ALsizei queued = 0;
+        while ( queued < STREAM_BUFFERS && stream->fill( stream->buffers[queued] ) ) {
+            queued++;
+        }
+        alSourcei( source, AL_BUFFER, 0 );
+        alSourceQueueBuffers( source, queued, stream->buffers );
+
+        _streams[source] = std::move( stream );
+        return true;
+    }
+
+    // Refill the buffers which finished playing
+    void update_streams()
+    {
+        for ( auto& current : _streams ) {
+            ALuint source = current.first;
+            SampleStream& stream = *current.second;
+
+            ALint processed = 0;
+            alGetSourcei( source, AL_BUFFERS_PROCESSED, &processed );
+            while ( processed-- > 0 ) {
+                ALuint buffer;
+                alSourceUnqueueBuffers( source, 1, &buffer );
+                if ( stream.fill( buffer ) ) {
+                    alSourceQueueBuffers( source, 1, &buffer );
+                }
+            }
+
+            // restart after running out of data in between updates
+            ALint state, queued;
+            alGetSourcei( source, AL_SOURCE_STATE, &state );
+            alGetSourcei( source, AL_BUFFERS_QUEUED, &queued );
+            if ( state == AL_STOPPED && queued > 0 && !stream.finished ) {
+                alSourcePlay( source );
+            }
+        }
+    }
+
+    void stop_stream( ALuint source )
+    {
+        auto stream_it = _streams.find( source );
+        if ( stream_it != _streams.end() ) {
+            alSourceStop( source );
+            alSourcei( source, AL_BUFFER, 0 );   // unqueues all buffers
+            alDeleteBuffers( STREAM_BUFFERS, stream_it->second->buffers );
+            _streams.erase( stream_it );
+        }
+    }
+
+    bool is_stream_playing( ALuint source ) const
+    {
+        auto stream_it = _streams.find( source );
+        return stream_it != _streams.end() && !stream_it->second->finished;
+    }
+
     ALCdevice *_device = nullptr;
     ALCcontext *_context = nullptr;
     
@@ -130,6 +291,11 @@ public:
     
     sample_group_map _sample_groups;
     buffer_map _buffers;
+    stream_map _streams;
+    std::vector<SGSoundVoice> _voices;
+
+    // decoded sample files, shared between buffers and kept a while after
+    std::unique_ptr<SGSampleCache> _cache;
 };
 
 
@@ -141,12 +307,24 @@ public:
 SGSoundMgr::SGSoundMgr() {
     d.reset(new SoundManagerPrivate);
     d->_base_pos = SGVec3d::fromGeod(_geod_pos);
+    d->_cache.reset(new SGSampleCache([this](const std::string& path) {
+        void *data = nullptr;
+        int format, freq, block;
+        size_t size;
+        if ( !load(path, &data, &format, &size, &freq, &block) ) {
+            return SGDecodedSampleRef();
+        }
+        return SGDecodedSampleRef(new SGDecodedSample(data, size, format, freq, block));
+    }));
 }
 
 // destructor
 
 SGSoundMgr::~SGSoundMgr() {
 
+    // wait for a background load, which calls load()
+    d->_cache.reset();
+
     if (is_working())
         stop();
     d->_sample_groups.clear();
@@ -314,6 +492,10 @@ void SGSoundMgr::stop()
     }
     d->_free_sources.clear();
 
+    while ( !d->_streams.empty() ) {
+        d->stop_stream( d->_streams.begin()->first );
+    }
+
     // clear any OpenAL buffers before shutting down
     for ( auto current : d->_buffers ) {
         refUint ref = current.second;
@@ -365,14 +547,29 @@ void SGSoundMgr::resume()
 // run the audio scheduler
 void SGSoundMgr::update( double dt )
 {
+    d->_cache->process_ready();
+
 #ifdef ENABLE_SOUND
     if (_active) {
         alcSuspendContext(d->_context);
 
+        d->update_streams();
+
         if (_changed) {
             d->update_pos_and_orientation();
         }
 
+        // hand out the sources to the most audible samples of all groups
+        size_t max_voices = d->_free_sources.size() + d->_sources_in_use.size();
+        if (_max_voices > 0) {
+            max_voices = std::min(max_voices, _max_voices);
+        }
+        d->_voices.clear();
+        for ( auto current : d->_sample_groups ) {
+            current.second->collect_voices(d->_voices);
+        }
+        SGSampleGroup::assign_voices(d->_voices, max_voices);
+
         for ( auto current : d->_sample_groups ) {
             current.second->update(dt);
         }
@@ -509,6 +706,8 @@ void SGSoundMgr::release_source( unsigned int source )
     auto it = std::find(d->_sources_in_use.begin(), d->_sources_in_use.end(), source);
     if ( it != d->_sources_in_use.end() ) {
   #ifdef ENABLE_SOUND
+        d->stop_stream( source );
+
         ALint result;
 
         alGetSourcei( source, AL_SOURCE_STATE, &result );
@@ -531,7 +730,8 @@ unsigned int SGSoundMgr::request_buffer(SGSoundSample *sample)
     if ( !sample->is_valid_buffer() ) {
         // sample was not yet loaded or removed again
         std::string sample_name = sample->get_sample_name();
-        void* sample_data = nullptr;
+        const void* sample_data = nullptr;
+        SGDecodedSampleRef decoded;
 
         // see if the sample name is already cached
         auto buffer_it = d->_buffers.find( sample_name );
@@ -544,12 +744,9 @@ unsigned int SGSoundMgr::request_buffer(SGSoundSample *sample)
 
         // sample name was not found in the buffer cache.
         if ( sample->is_file() ) {
-            int freq, format, block;
-            size_t size;
-
             try {
-              bool res = load(sample_name, &sample_data, &format, &size, &freq, &block);
-              if (res == false) return NO_BUFFER;
+              decoded = d->_cache->get(sample_name);
+              if (!decoded) return NO_BUFFER;
             } catch (sg_exception& e) {
               SG_LOG(SG_SOUND, SG_ALERT,
                     "failed to load sound buffer:\n" << e.getFormattedMessage());
@@ -557,41 +754,18 @@ unsigned int SGSoundMgr::request_buffer(SGSoundSample *sample)
               return FAILED_BUFFER;
             }
             
-            sample->set_block_align( block );
-            sample->set_frequency( freq );
-            sample->set_format( format );
-            sample->set_size( size );
+            sample->set_block_align( decoded->get_block_align() );
+            sample->set_frequency( decoded->get_frequency() );
+            sample->set_format( decoded->get_format() );
+            sample->set_size( decoded->get_size() );
+            sample_data = decoded->get_data();
 
         } else {
             sample_data = sample->get_data();
         }
 
-        ALenum format = AL_NONE;
-        switch( sample->get_format() )
-        {
-        case SG_SAMPLE_MONO16:
-            format = AL_FORMAT_MONO16;
-            break;
-        case SG_SAMPLE_MONO8:
-            format = AL_FORMAT_MONO8;
-            break;
-        case SG_SAMPLE_MULAW:
-            format = AL_FORMAT_MONO_MULAW_EXT;
-            break;
-        case SG_SAMPLE_ADPCM:
-            format = AL_FORMAT_MONO_IMA4;
-            break;
-
-        case SG_SAMPLE_STEREO16:
-            SG_LOG(SG_SOUND, SG_POPUP, "Stereo sound detected:\n" << sample->get_sample_name() << "\nUse two separate mono files instead if required.");
-            format = AL_FORMAT_STEREO16;
-            break;
-        case SG_SAMPLE_STEREO8:
-            SG_LOG(SG_SOUND, SG_POPUP, "Stereo sound detected:\n" << sample->get_sample_name() << "\nUse two separate mono files instead if required.");
-            format = AL_FORMAT_STEREO8;
-            break;
-        default:
-            SG_LOG(SG_SOUND, SG_ALERT, "unsupported audio format");
+        ALenum format = get_al_format( sample->get_format(), sample_name );
+        if ( format == AL_NONE ) {
             return buffer;
         }
 
@@ -614,8 +788,6 @@ unsigned int SGSoundMgr::request_buffer(SGSoundSample *sample)
                 d->_buffers[sample_name] = refUint(buffer);
             }
         }
-
-        if ( sample->is_file() ) free(sample_data);
     }
     else {
         buffer = sample->get_buffer();
@@ -626,7 +798,7 @@ unsigned int SGSoundMgr::request_buffer(SGSoundSample *sample)
 
 void SGSoundMgr::release_buffer(SGSoundSample *sample)
 {
-    if ( !sample->is_queue() )
+    if ( !sample->is_queue() && sample->is_valid_buffer() )
     {
         std::string sample_name = sample->get_sample_name();
         auto buffer_it = d->_buffers.find( sample_name );
@@ -683,7 +855,12 @@ void SGSoundMgr::sample_play( SGSoundSample *sample )
     ALboolean looping = sample->is_looping() ? AL_TRUE : AL_FALSE;
     ALint source = sample->get_source();
 
-    if ( !sample->is_queue() )
+    if ( !sample->is_queue() &&
+         d->start_stream(sample, source, _stream_threshold, _block_support) )
+    {
+        looping = AL_FALSE;     // the stream rewinds by itself
+    }
+    else if ( !sample->is_queue() )
     {
         ALuint buffer = request_buffer(sample);
         if (buffer == SGSoundMgr::FAILED_BUFFER ||
@@ -720,6 +897,7 @@ void SGSoundMgr::sample_stop( SGSoundSample *sample )
         if ( sample->is_looping() && !stopped) {
 #ifdef ENABLE_SOUND
             alSourceStop( source );
+            d->stop_stream( source );
 #endif          
             stopped = is_sample_stopped(sample);
         }
@@ -758,7 +936,8 @@ bool SGSoundMgr::is_sample_stopped(SGSoundSample *sample)
         ALint source = sample->get_source();
         ALint result;
         alGetSourcei( source, AL_SOURCE_STATE, &result );
-        return (result == AL_STOPPED);
+        // a stream may run dry until the next update() refills it
+        return (result == AL_STOPPED && !d->is_stream_playing(source));
     }
 #endif
     return true;
@@ -833,6 +1012,14 @@ bool SGSoundMgr::load( const std::string &samplepath,
     return true;
 }
 
+void SGSoundMgr::preload( const std::string &samplepath,
+                          std::function<void(bool)> ready )
+{
+    d->_cache->load_async(samplepath, [ready](const std::string&, SGDecodedSampleRef sample) {
+        if (ready) ready(sample.valid());
+    });
+}
+
 vector<std::string> SGSoundMgr::get_available_devices()
 {
     vector<std::string> devices;
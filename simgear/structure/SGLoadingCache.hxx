@@ -0,0 +1,244 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Least recently used cache of values loaded once on demand
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+
+namespace simgear {
+
+/**
+ * Least recently used cache of values which are expensive to load, such as
+ * decoded files or loaded models, and are referred to by a smart pointer.
+ *
+ * get() loads a missing value on the calling thread. A value requested by
+ * several threads at the same time is only loaded once, the other threads
+ * wait for it. Failed loads, which throw or return a null value, are not
+ * cached, so the waiting threads then try to load the value themselves.
+ *
+ * A value which is in use, according to the InUse function, is never
+ * evicted and doesn't count against the budget. Beyond that, the least
+ * recently used values are evicted once the total cost of the unused ones
+ * exceeds the budget. By default every value costs one, and no value is
+ * considered in use.
+ *
+ * All methods may be called from several threads.
+ */
+template<typename Key, typename Value>
+class SGLoadingCache final
+{
+public:
+    /// Load a value, returning null (or throwing) on failure
+    using Loader = std::function<Value()>;
+    using Cost = std::function<size_t(const Value&)>;
+    using InUse = std::function<bool(const Value&)>;
+
+    struct Stats {
+        uint64_t hits = 0;      ///< found loaded, or waited for another thread
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t cost = 0;        ///< of all cached values
+    };
+
+    explicit SGLoadingCache(size_t budget, Cost cost = Cost(), InUse inUse = InUse()) :
+        _budget(budget),
+        _cost(std::move(cost)),
+        _inUse(std::move(inUse))
+    {}
+
+    SGLoadingCache(const SGLoadingCache&) = delete;
+    SGLoadingCache& operator=(const SGLoadingCache&) = delete;
+
+    /**
+     * The value for @a key, calling @a load if it is neither cached nor
+     * being loaded by another thread. Exceptions thrown by @a load are
+     * passed on.
+     */
+    Value get(const Key& key, const Loader& load)
+    {
+        return getOrLoad(key, load, true);
+    }
+
+    /**
+     * As get(), for a key already looked up with find(): neither a hit nor
+     * a miss is counted again.
+     */
+    Value load(const Key& key, const Loader& load)
+    {
+        return getOrLoad(key, load, false);
+    }
+
+    /// The value for @a key if it is loaded already, or null
+    Value find(const Key& key)
+    {
+        std::lock_guard<std::mutex> g(_lock);
+        auto it = _entries.find(key);
+        if (it == _entries.end() || it->second.loading) {
+            ++_stats.misses;
+            return Value();
+        }
+
+        ++_stats.hits;
+        _lru.splice(_lru.begin(), _lru, it->second.lru);
+        return it->second.value;
+    }
+
+    /// Evict unused values until they fit in the budget again
+    void trim()
+    {
+        std::lock_guard<std::mutex> g(_lock);
+        evict(_budget);
+    }
+
+    /// Evict all unused values
+    void flush()
+    {
+        std::lock_guard<std::mutex> g(_lock);
+        evict(0);
+    }
+
+    void setBudget(size_t budget)
+    {
+        std::lock_guard<std::mutex> g(_lock);
+        _budget = budget;
+        evict(_budget);
+    }
+
+    size_t getBudget() const
+    {
+        std::lock_guard<std::mutex> g(_lock);
+        return _budget;
+    }
+
+    /// Number of loaded values
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> g(_lock);
+        return _lru.size();
+    }
+
+    /// Total cost of the loaded values which are not in use
+    size_t unusedCost() const
+    {
+        std::lock_guard<std::mutex> g(_lock);
+        return computeUnusedCost();
+    }
+
+    Stats getStats() const
+    {
+        std::lock_guard<std::mutex> g(_lock);
+        return _stats;
+    }
+
+private:
+    struct Entry {
+        Value value{};
+        bool loading = true;
+        typename std::list<Key>::iterator lru;
+    };
+
+    size_t costOf(const Value& value) const { return _cost ? _cost(value) : 1; }
+    bool inUse(const Value& value) const { return _inUse && _inUse(value); }
+
+    Value getOrLoad(const Key& key, const Loader& load, bool count)
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        auto it = _entries.find(key);
+        if (it != _entries.end()) {
+            _loaded.wait(lock, [&] {
+                it = _entries.find(key);
+                return it == _entries.end() || !it->second.loading;
+            });
+            if (it != _entries.end()) {
+                if (count)
+                    ++_stats.hits;
+                _lru.splice(_lru.begin(), _lru, it->second.lru);
+                return it->second.value;
+            }
+            // The loading thread failed, try again here
+        }
+
+        if (count)
+            ++_stats.misses;
+        _entries.emplace(key, Entry());
+        lock.unlock();
+
+        Value value{};
+        try {
+            value = load();
+        } catch (...) {
+            lock.lock();
+            _entries.erase(key);
+            _loaded.notify_all();
+            throw;
+        }
+
+        lock.lock();
+        it = _entries.find(key);
+        if (!value) {
+            _entries.erase(it);
+        } else {
+            it->second.value = value;
+            it->second.loading = false;
+            _lru.push_front(key);
+            it->second.lru = _lru.begin();
+            _stats.cost += costOf(value);
+            evict(_budget);
+        }
+        _loaded.notify_all();
+        return value;
+    }
+
+    size_t computeUnusedCost() const
+    {
+        size_t unused = 0;
+        for (const Key& key : _lru) {
+            const Value& value = _entries.find(key)->second.value;
+            if (!inUse(value))
+                unused += costOf(value);
+        }
+        return unused;
+    }
+
+    // Called with the lock held
+    void evict(size_t budget)
+    {
+        size_t unused = computeUnusedCost();
+        auto it = _lru.end();
+        while (unused > budget && it != _lru.begin()) {
+            --it;
+            auto entry = _entries.find(*it);
+            if (inUse(entry->second.value))
+                continue;
+
+            const size_t cost = costOf(entry->second.value);
+            unused -= cost;
+            _stats.cost -= cost;
+            ++_stats.evictions;
+            _entries.erase(entry);
+            it = _lru.erase(it);
+        }
+    }
+
+    size_t _budget;
+    const Cost _cost;
+    const InUse _inUse;
+
+    mutable std::mutex _lock;
+    std::condition_variable _loaded;
+    std::map<Key, Entry> _entries;
+    std::list<Key> _lru;    ///< loaded values, most recently used first
+    Stats _stats;
+};
+
+} // namespace simgear
@@ -2,14 +2,138 @@
 
 #include "StringTable.hxx"
 
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
 namespace simgear
 {
-using namespace std;
 
-const string* StringTable::insert(const string& str)
+namespace
+{
+const unsigned int shardBits = 4;
+const size_t numShards = size_t(1) << shardBits;
+const size_t initialSlots = 64;
+} // namespace
+
+struct StringTable::Shard {
+    struct Entry {
+        size_t hash;
+        std::string str;
+    };
+
+    // Open addressing table of entries. Readers may be probing it at any
+    // time, so it is only ever changed by filling empty slots; growing
+    // replaces it.
+    struct Slots {
+        explicit Slots(size_t count) : mask(count - 1),
+                                       entries(new std::atomic<const Entry*>[count])
+        {
+            for (size_t i = 0; i < count; ++i) {
+                entries[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        void place(const Entry* entry)
+        {
+            size_t i = (entry->hash >> shardBits) & mask;
+            while (entries[i].load(std::memory_order_relaxed)) {
+                i = (i + 1) & mask;
+            }
+            entries[i].store(entry, std::memory_order_release);
+        }
+
+        const size_t mask;
+        std::unique_ptr<std::atomic<const Entry*>[]> entries;
+    };
+
+    Shard()
+    {
+        tables.emplace_back(new Slots(initialSlots));
+        slots.store(tables.back().get(), std::memory_order_release);
+    }
+
+    const Entry* find(std::string_view str, size_t hash) const
+    {
+        const Slots* s = slots.load(std::memory_order_acquire);
+        for (size_t i = (hash >> shardBits) & s->mask;; i = (i + 1) & s->mask) {
+            const Entry* entry = s->entries[i].load(std::memory_order_acquire);
+            if (!entry) {
+                return nullptr;
+            }
+            if (entry->hash == hash && entry->str == str) {
+                return entry;
+            }
+        }
+    }
+
+    // called with lock held
+    const Entry* add(std::string_view str, size_t hash)
+    {
+        entries.push_back(Entry{hash, std::string(str)});
+        const Entry* entry = &entries.back();
+
+        Slots* current = slots.load(std::memory_order_relaxed);
+        if (entries.size() * 2 <= current->mask + 1) {
+            current->place(entry);
+            return entry;
+        }
+
+        // keep at most half the slots filled. The old table stays alive,
+        // readers may still be probing it.
+        tables.emplace_back(new Slots((current->mask + 1) * 2));
+        for (const Entry& e : entries) {
+            tables.back()->place(&e);
+        }
+        slots.store(tables.back().get(), std::memory_order_release);
+        return entry;
+    }
+
+    std::atomic<Slots*> slots;
+    mutable std::mutex lock;                   ///< held while adding
+    std::deque<Entry> entries;                 ///< stable addresses
+    std::vector<std::unique_ptr<Slots>> tables; ///< current and replaced
+};
+
+StringTable::StringTable() : _shards(new Shard[numShards])
+{
+}
+
+StringTable::~StringTable() = default;
+
+const std::string* StringTable::insert(std::string_view str)
+{
+    const size_t hash = std::hash<std::string_view>()(str);
+    Shard& shard = _shards[hash & (numShards - 1)];
+
+    const Shard::Entry* entry = shard.find(str, hash);
+    if (!entry) {
+        std::lock_guard<std::mutex> lock(shard.lock);
+        entry = shard.find(str, hash); // it may have been added meanwhile
+        if (!entry) {
+            entry = shard.add(str, hash);
+        }
+    }
+    return &entry->str;
+}
+
+const std::string* StringTable::find(std::string_view str) const
 {
-    std::lock_guard<std::mutex> lock(_mutex);
-    StringContainer::iterator it = _strings.insert(str).first;
-    return &*it;
+    const size_t hash = std::hash<std::string_view>()(str);
+    const Shard::Entry* entry = _shards[hash & (numShards - 1)].find(str, hash);
+    return entry ? &entry->str : nullptr;
 }
+
+size_t StringTable::size() const
+{
+    size_t count = 0;
+    for (size_t i = 0; i < numShards; ++i) {
+        std::lock_guard<std::mutex> lock(_shards[i].lock);
+        count += _shards[i].entries.size();
+    }
+    return count;
 }
+
+} // namespace simgear
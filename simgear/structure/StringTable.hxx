@@ -2,27 +2,42 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
-#include <mutex>
-
-#include <boost/multi_index_container.hpp>
-#include <boost/multi_index/hashed_index.hpp>
-#include <boost/multi_index/identity.hpp>
+#include <string_view>
 
 namespace simgear
 {
-typedef boost::multi_index_container<
-    std::string,
-    boost::multi_index::indexed_by<
-        boost::multi_index::hashed_unique<
-            boost::multi_index::identity<std::string> > > >
-StringContainer;
 
+/**
+ * A set of strings which hands out one stable copy of each, so that equal
+ * strings from the table can be compared by address.
+ *
+ * The table is split into shards by hash. Lookups are lock free; inserting
+ * a new string locks its shard. Strings are never removed.
+ */
 class StringTable
 {
-    const std::string* insert(const std::string& str);
+public:
+    StringTable();
+    ~StringTable();
+
+    StringTable(const StringTable&) = delete;
+    StringTable& operator=(const StringTable&) = delete;
+
+    /// The table's copy of @a str, which is added if needed
+    const std::string* insert(std::string_view str);
+
+    /// The table's copy of @a str, or null if it has none
+    const std::string* find(std::string_view str) const;
+
+    /// Number of strings in the table
+    size_t size() const;
+
 private:
-    std::mutex _mutex;
-    StringContainer _strings;
+    struct Shard;
+
+    std::unique_ptr<Shard[]> _shards;
 };
-}
+
+} // namespace simgear
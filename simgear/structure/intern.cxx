@@ -3,20 +3,27 @@
 #include <simgear/structure/intern.hxx>
 
 #include <simgear/structure/StringTable.hxx>
-#include <simgear/structure/Singleton.hxx>
 
 namespace
 {
-class GlobalStringTable : public StringTable,
-                          public Singleton<GlobalStringTable>
+// Kept on the heap and never deleted, so that interned strings remain
+// valid for static objects destructed late.
+simgear::StringTable& globalStringTable()
 {
-};
+    static simgear::StringTable* table = new simgear::StringTable;
+    return *table;
+}
 }
 
 namespace simgear
 {
-const std::string* intern(const std::string& str)
+const std::string* intern(std::string_view str)
+{
+    return globalStringTable().insert(str);
+}
+
+const std::string* findInterned(std::string_view str)
 {
-    return GlobalStringTable::instance()->insert(str);
+    return globalStringTable().find(str);
 }
 }
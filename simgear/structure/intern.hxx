@@ -3,6 +3,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 #include <typeinfo>
 #ifndef _MSC_VER
@@ -32,6 +33,15 @@ std::string getTypeName(void)
 
 /**
  * Return a pointer to a single string object for a given string.
+ *
+ * Interned strings are never freed, and equal strings compare equal by
+ * address.
  */
-const std::string* intern(const std::string& str);
+const std::string* intern(std::string_view str);
+
+/**
+ * Return the interned string object equal to a string, or null if the
+ * string was never interned. Does not lock.
+ */
+const std::string* findInterned(std::string_view str);
 }
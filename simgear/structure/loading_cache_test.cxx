@@ -0,0 +1,203 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Unit tests for SGLoadingCache
+ */
+
+#include <simgear_config.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <simgear/misc/test_macros.hxx>
+
+#include "SGLoadingCache.hxx"
+
+using std::cout;
+using std::endl;
+using simgear::SGLoadingCache;
+
+using Value = std::shared_ptr<const std::string>;
+using Cache = SGLoadingCache<std::string, Value>;
+
+static Cache::Loader loader(const std::string& name, std::atomic<int>& loads)
+{
+    return [name, &loads] {
+        ++loads;
+        return std::make_shared<const std::string>(name);
+    };
+}
+
+void test_hitsAndMisses()
+{
+    cout << "Testing hits and misses" << endl;
+
+    Cache cache(8);
+    std::atomic<int> loads{0};
+
+    SG_VERIFY(!cache.find("a"));
+    SG_CHECK_EQUAL(*cache.get("a", loader("a", loads)), "a");
+    SG_CHECK_EQUAL(*cache.get("a", loader("a", loads)), "a");
+    SG_CHECK_EQUAL(*cache.find("a"), "a");
+    SG_CHECK_EQUAL(loads.load(), 1);
+
+    Cache::Stats stats = cache.getStats();
+    SG_CHECK_EQUAL(stats.hits, 2u);
+    SG_CHECK_EQUAL(stats.misses, 2u);
+    SG_CHECK_EQUAL(stats.cost, 1u);
+
+    // load() is for keys already looked up with find(), and counts nothing
+    SG_VERIFY(!cache.find("b"));
+    SG_CHECK_EQUAL(*cache.load("b", loader("b", loads)), "b");
+    SG_CHECK_EQUAL(*cache.load("b", loader("b", loads)), "b");
+    SG_CHECK_EQUAL(loads.load(), 2);
+    stats = cache.getStats();
+    SG_CHECK_EQUAL(stats.hits, 2u);
+    SG_CHECK_EQUAL(stats.misses, 3u);
+    SG_CHECK_EQUAL(cache.size(), 2u);
+}
+
+void test_singleFlight()
+{
+    cout << "Testing concurrent requests for the same value" << endl;
+
+    Cache cache(8);
+    std::atomic<int> loads{0};
+    auto slowLoader = [&loads] {
+        ++loads;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        return std::make_shared<const std::string>("slow");
+    };
+
+    std::vector<Value> results(4);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < results.size(); ++i)
+        threads.emplace_back([&, i] { results[i] = cache.get("slow", slowLoader); });
+    for (auto& t : threads)
+        t.join();
+
+    SG_CHECK_EQUAL(loads.load(), 1);
+    for (const auto& r : results)
+        SG_VERIFY(r && r == results[0]);
+
+    Cache::Stats stats = cache.getStats();
+    SG_CHECK_EQUAL(stats.misses, 1u);
+    SG_CHECK_EQUAL(stats.hits, 3u);
+}
+
+void test_failedLoads()
+{
+    cout << "Testing failed loads" << endl;
+
+    Cache cache(8);
+    std::atomic<int> loads{0};
+
+    // neither exceptions nor null values are cached
+    bool thrown = false;
+    try {
+        cache.get("a", []() -> Value { throw std::runtime_error("test"); });
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    SG_VERIFY(thrown);
+    SG_VERIFY(!cache.get("b", [] { return Value(); }));
+    SG_CHECK_EQUAL(cache.size(), 0u);
+    SG_CHECK_EQUAL(*cache.get("a", loader("a", loads)), "a");
+    SG_CHECK_EQUAL(*cache.get("b", loader("b", loads)), "b");
+    SG_CHECK_EQUAL(loads.load(), 2);
+
+    // threads waiting for a failing load try again themselves
+    std::atomic<bool> started{false};
+    Value waited;
+    std::thread failing([&] {
+        SG_VERIFY(!cache.get("c", [&] {
+            started = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            return Value();
+        }));
+    });
+    while (!started)
+        std::this_thread::yield();
+    waited = cache.get("c", loader("c", loads));
+    failing.join();
+    SG_CHECK_EQUAL(*waited, "c");
+    SG_CHECK_EQUAL(loads.load(), 3);
+}
+
+void test_eviction()
+{
+    cout << "Testing eviction of unused values" << endl;
+
+    std::atomic<int> loads{0};
+    Cache cache(6,
+                [](const Value& v) { return v->size(); },
+                [](const Value& v) { return v.use_count() > 1; });
+
+    Value held = cache.get("aaa", loader("aaa", loads));
+    cache.get("bb", loader("bb", loads));
+    cache.get("cc", loader("cc", loads));
+    cache.get("dd", loader("dd", loads));
+    SG_CHECK_EQUAL(cache.size(), 4u);
+    SG_CHECK_EQUAL(cache.getStats().cost, 9u);
+    SG_CHECK_EQUAL(cache.unusedCost(), 6u);
+
+    // "aaa" is in use and doesn't count, "bb" is least recently used. The
+    // new value is still referenced while it is added.
+    cache.get("e", loader("e", loads));
+    SG_CHECK_EQUAL(cache.size(), 5u);
+    cache.trim();
+    SG_CHECK_EQUAL(cache.size(), 4u);
+    SG_VERIFY(!cache.find("bb"));
+    SG_VERIFY(cache.find("cc"));
+    SG_CHECK_EQUAL(cache.getStats().evictions, 1u);
+
+    // values in use are never evicted
+    cache.flush();
+    SG_CHECK_EQUAL(cache.size(), 1u);
+    SG_CHECK_EQUAL(*cache.find("aaa"), "aaa");
+
+    held.reset();
+    cache.setBudget(2);
+    SG_CHECK_EQUAL(cache.size(), 0u);
+    SG_CHECK_EQUAL(cache.getStats().cost, 0u);
+    SG_CHECK_EQUAL(cache.getBudget(), 2u);
+}
+
+void test_countBudget()
+{
+    cout << "Testing a budget in number of values" << endl;
+
+    Cache cache(2);
+    std::atomic<int> loads{0};
+    cache.get("a", loader("a", loads));
+    cache.get("b", loader("b", loads));
+    cache.get("a", loader("a", loads));
+    cache.get("c", loader("c", loads));
+    SG_CHECK_EQUAL(loads.load(), 3);
+
+    // "b" was the least recently used
+    cache.get("a", loader("a", loads));
+    cache.get("c", loader("c", loads));
+    SG_CHECK_EQUAL(loads.load(), 3);
+    cache.get("b", loader("b", loads));
+    SG_CHECK_EQUAL(loads.load(), 4);
+}
+
+int main(int argc, char* argv[])
+{
+    test_hitsAndMisses();
+    test_singleFlight();
+    test_failedLoads();
+    test_eviction();
+    test_countBudget();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Test StringTable and the global intern() table
+ */
+
+#include <simgear_config.h>
+
+#include <simgear/compiler.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <simgear/misc/test_macros.hxx>
+
+#include "StringTable.hxx"
+#include "intern.hxx"
+
+using namespace simgear;
+
+void testInsertFind()
+{
+    StringTable table;
+    SG_VERIFY(table.find("altitude-ft") == nullptr);
+
+    const std::string* a = table.insert("altitude-ft");
+    SG_CHECK_EQUAL(*a, "altitude-ft");
+    SG_CHECK_EQUAL(table.insert(std::string("altitude-") + "ft"), a);
+    SG_CHECK_EQUAL(table.find("altitude-ft"), a);
+    SG_VERIFY(table.find("altitude") == nullptr);
+
+    const std::string* empty = table.insert("");
+    SG_CHECK_EQUAL(*empty, "");
+    SG_CHECK_EQUAL(table.find(""), empty);
+    SG_CHECK_EQUAL(table.size(), 2);
+
+    // addresses stay valid while the table grows
+    for (int i = 0; i < 10000; ++i) {
+        table.insert("name" + std::to_string(i));
+    }
+    SG_CHECK_EQUAL(table.size(), 10002);
+    SG_CHECK_EQUAL(table.find("altitude-ft"), a);
+    SG_CHECK_EQUAL(*a, "altitude-ft");
+    for (int i = 0; i < 10000; ++i) {
+        const std::string name = "name" + std::to_string(i);
+        const std::string* found = table.find(name);
+        SG_VERIFY(found != nullptr);
+        SG_CHECK_EQUAL(*found, name);
+    }
+}
+
+void testConcurrentInserts()
+{
+    StringTable table;
+    const int numThreads = 4;
+    const int numNames = 5000;
+    std::vector<std::vector<const std::string*>> results(numThreads);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&table, &results, t] {
+            for (int i = 0; i < numNames; ++i) {
+                // every thread inserts the same names, in different orders
+                const int n = (i * (t + 1) * 7919) % numNames;
+                results[t].push_back(table.insert("model" + std::to_string(n)));
+                table.find("model" + std::to_string((n + 1) % numNames));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    SG_CHECK_EQUAL(table.size(), numNames);
+    for (int t = 0; t < numThreads; ++t) {
+        for (int i = 0; i < numNames; ++i) {
+            const int n = (i * (t + 1) * 7919) % numNames;
+            SG_CHECK_EQUAL(results[t][i], table.find("model" + std::to_string(n)));
+        }
+    }
+}
+
+void testIntern()
+{
+    const std::string* a = intern("multiplayer");
+    SG_CHECK_EQUAL(intern(std::string("multi") + "player"), a);
+    SG_CHECK_EQUAL(findInterned("multiplayer"), a);
+    SG_VERIFY(findInterned("string_table_test never interned this") == nullptr);
+}
+
+int main(int argc, char* argv[])
+{
+    testInsertFind();
+    testConcurrentInserts();
+    testIntern();
+    return 0;
+}
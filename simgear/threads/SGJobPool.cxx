@@ -0,0 +1,249 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Persistent pool of worker threads for data-parallel jobs
+ */
+
+#include <simgear_config.h>
+
+#include "SGJobPool.hxx"
+
+#include <algorithm>
+
+#include <simgear/debug/logstream.hxx>
+
+/// Pool whose task the current thread is running, if any
+static thread_local const SGJobPool* currentPool = nullptr;
+
+/// Contiguous range of task indices owned by one thread
+struct SGJobPool::Range
+{
+    std::mutex lock;
+    size_t begin = 0;
+    size_t end = 0;
+
+    /// owner side: take the next task
+    bool popFront(size_t& index)
+    {
+        std::lock_guard<std::mutex> g(lock);
+        if (begin == end)
+            return false;
+        index = begin++;
+        return true;
+    }
+
+    /// thief side: take the last task
+    bool popBack(size_t& index)
+    {
+        std::lock_guard<std::mutex> g(lock);
+        if (begin == end)
+            return false;
+        index = --end;
+        return true;
+    }
+};
+
+struct SGJobPool::Batch
+{
+    const Task* task = nullptr;
+    std::unique_ptr<Range[]> ranges;
+    unsigned int numRanges = 0;
+
+    std::mutex errorLock;
+    std::exception_ptr error;
+};
+
+//------------------------------------------------------------------------------
+SGJobPool::SGJobPool(unsigned int numWorkers)
+{
+    _workers.reserve(numWorkers);
+    for (unsigned int i = 0; i < numWorkers; ++i)
+        _workers.emplace_back(&SGJobPool::workerMain, this, i);
+}
+
+//------------------------------------------------------------------------------
+SGJobPool::~SGJobPool()
+{
+    {
+        std::lock_guard<std::mutex> g(_lock);
+        _quit = true;
+    }
+    _wakeup.notify_all();
+
+    for (auto& t : _workers)
+        t.join();
+}
+
+//------------------------------------------------------------------------------
+unsigned int SGJobPool::defaultNumWorkers()
+{
+    unsigned int n = std::thread::hardware_concurrency();
+    return n > 1 ? n - 1 : 0;
+}
+
+//------------------------------------------------------------------------------
+SGJobPool& SGJobPool::shared()
+{
+    // never destroyed, as it may still be used by other static objects
+    static SGJobPool* pool = new SGJobPool(defaultNumWorkers());
+    return *pool;
+}
+
+//------------------------------------------------------------------------------
+void SGJobPool::parallelFor(size_t count, const Task& task)
+{
+    if (count == 0)
+        return;
+
+    if (_workers.empty() || count == 1 || currentPool == this) {
+        runInline(count, task);
+        return;
+    }
+
+    std::lock_guard<std::mutex> runGuard(_runLock);
+
+    // One range per thread, the calling thread uses the last one
+    Batch batch;
+    batch.task = &task;
+    batch.numRanges = concurrency();
+    batch.ranges.reset(new Range[batch.numRanges]);
+
+    const size_t chunk = count / batch.numRanges,
+                 remainder = count % batch.numRanges;
+    size_t begin = 0;
+    for (unsigned int i = 0; i < batch.numRanges; ++i) {
+        batch.ranges[i].begin = begin;
+        begin += chunk + (i < remainder ? 1 : 0);
+        batch.ranges[i].end = begin;
+    }
+
+    {
+        std::lock_guard<std::mutex> g(_lock);
+        _batch = &batch;
+        ++_generation;
+    }
+    _wakeup.notify_all();
+
+    runTasks(batch, batch.numRanges - 1);
+
+    // Every task has been taken once we get here. Workers still busy with a
+    // job may not join anymore, but the batch lives on our stack, so wait for
+    // the ones which did to let go of it.
+    {
+        std::unique_lock<std::mutex> g(_lock);
+        _batch = nullptr;
+        _done.wait(g, [this] { return _busyWorkers == 0; });
+    }
+
+    if (batch.error)
+        std::rethrow_exception(batch.error);
+}
+
+//------------------------------------------------------------------------------
+void SGJobPool::submit(Job job)
+{
+    if (_workers.empty()) {
+        runJob(job);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> g(_lock);
+        _jobs.push_back(std::move(job));
+    }
+    _wakeup.notify_one();
+}
+
+//------------------------------------------------------------------------------
+void SGJobPool::workerMain(unsigned int id)
+{
+    unsigned long generation = 0;
+    std::unique_lock<std::mutex> g(_lock);
+    for (;;) {
+        _wakeup.wait(g, [&] {
+            return _quit || (_batch && _generation != generation) || !_jobs.empty();
+        });
+
+        // A loop first, its caller is blocked until it completes
+        if (_batch && _generation != generation) {
+            generation = _generation;
+            Batch* batch = _batch;
+            ++_busyWorkers;
+            g.unlock();
+
+            runTasks(*batch, id);
+
+            g.lock();
+            if (--_busyWorkers == 0)
+                _done.notify_one();
+        } else if (!_jobs.empty()) {
+            Job job = std::move(_jobs.front());
+            _jobs.pop_front();
+            g.unlock();
+
+            runJob(job);
+
+            g.lock();
+        } else {
+            return; // quitting, and nothing left to do
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void SGJobPool::runTasks(Batch& batch, unsigned int id)
+{
+    size_t index;
+    for (;;) {
+        bool found = batch.ranges[id].popFront(index);
+        for (unsigned int i = 1; !found && i < batch.numRanges; ++i)
+            found = batch.ranges[(id + i) % batch.numRanges].popBack(index);
+
+        if (!found)
+            return;
+
+        const SGJobPool* outer = currentPool;
+        currentPool = this;
+        try {
+            (*batch.task)(index);
+        } catch (...) {
+            std::lock_guard<std::mutex> g(batch.errorLock);
+            if (!batch.error)
+                batch.error = std::current_exception();
+        }
+        currentPool = outer;
+    }
+}
+
+//------------------------------------------------------------------------------
+void SGJobPool::runJob(Job& job)
+{
+    const SGJobPool* outer = currentPool;
+    currentPool = this;
+    try {
+        job();
+    } catch (std::exception& e) {
+        SG_LOG(SG_GENERAL, SG_ALERT, "Exception in SGJobPool job: " << e.what());
+    } catch (...) {
+        SG_LOG(SG_GENERAL, SG_ALERT, "Unknown exception in SGJobPool job");
+    }
+    currentPool = outer;
+}
+
+//------------------------------------------------------------------------------
+void SGJobPool::runInline(size_t count, const Task& task)
+{
+    std::exception_ptr error;
+    for (size_t i = 0; i < count; ++i) {
+        try {
+            task(i);
+        } catch (...) {
+            if (!error)
+                error = std::current_exception();
+        }
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+}
@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Persistent pool of worker threads for data-parallel jobs
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/**
+ * Pool of persistent worker threads, running data-parallel loops split into
+ * independent tasks (e.g. one per depth slice or per material).
+ *
+ * Tasks of a loop are initially distributed evenly over the workers and the
+ * calling thread, which also takes part in the work. A thread which has run
+ * out of tasks steals from the end of another thread's range, so uneven task
+ * costs are balanced without any per-task synchronisation between the
+ * owners of the ranges.
+ *
+ * Calls from several threads are serialised, each waiting for the loops
+ * started before it. A call from within one of the pool's own tasks runs its
+ * tasks on the calling thread instead of waiting for the loop it is part of.
+ *
+ * Single jobs can be queued with submit(), for work a thread hands off
+ * without waiting for it, such as writing files. Idle workers take loops
+ * before queued jobs, and a loop only waits for the workers which joined it.
+ */
+class SGJobPool final
+{
+public:
+    using Task = std::function<void(size_t index)>;
+    using Job = std::function<void()>;
+
+    /**
+     * @param numWorkers  Number of threads to create in addition to the
+     *                    calling thread. Zero results in all tasks being run
+     *                    on the calling thread.
+     */
+    explicit SGJobPool(unsigned int numWorkers);
+
+    /// Runs the jobs still queued, then stops the workers
+    ~SGJobPool();
+
+    SGJobPool(const SGJobPool&) = delete;
+    SGJobPool& operator=(const SGJobPool&) = delete;
+
+    /**
+     * Run @a task for every index in [0, count) and block until all of them
+     * completed. If a task throws, the remaining tasks still run and the first
+     * exception is rethrown on the calling thread.
+     */
+    void parallelFor(size_t count, const Task& task);
+
+    /**
+     * Queue @a job for one of the workers and return without waiting for it.
+     * Jobs are started in the order they were submitted. Exceptions thrown
+     * by a job are logged and dropped. Without workers, the job is run on
+     * the calling thread before returning.
+     */
+    void submit(Job job);
+
+    /// Number of threads executing tasks (workers plus the calling thread)
+    unsigned int concurrency() const { return static_cast<unsigned int>(_workers.size()) + 1; }
+
+    /// Number of workers to use for a default sized pool on this machine
+    static unsigned int defaultNumWorkers();
+
+    /**
+     * Pool with defaultNumWorkers() workers shared by the whole process,
+     * created on first use.
+     */
+    static SGJobPool& shared();
+
+private:
+    struct Range;
+    struct Batch;
+
+    void workerMain(unsigned int id);
+    void runTasks(Batch& batch, unsigned int id);
+    void runJob(Job& job);
+    void runInline(size_t count, const Task& task);
+
+    std::vector<std::thread> _workers;
+
+    std::mutex _runLock;            ///< serialise parallelFor() callers
+
+    std::mutex _lock;
+    std::condition_variable _wakeup;
+    std::condition_variable _done;
+    Batch* _batch = nullptr;        ///< loop workers may join
+    unsigned long _generation = 0;
+    unsigned int _busyWorkers = 0;  ///< workers which joined the loop
+    std::deque<Job> _jobs;
+    bool _quit = false;
+};
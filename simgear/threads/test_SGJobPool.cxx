@@ -0,0 +1,219 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Unit tests for SGJobPool
+ */
+
+#include <simgear_config.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <simgear/misc/test_macros.hxx>
+
+#include "SGJobPool.hxx"
+
+using std::cout;
+using std::endl;
+
+void test_allTasksRunOnce()
+{
+  cout << "Testing that every task runs exactly once" << endl;
+
+  SGJobPool pool(3);
+  SG_CHECK_EQUAL(pool.concurrency(), 4u);
+
+  for (size_t count : {0, 1, 3, 4, 17, 1000}) {
+    std::vector<std::atomic<int>> runs(count);
+    pool.parallelFor(count, [&runs](size_t i) { ++runs[i]; });
+
+    for (size_t i = 0; i < count; ++i)
+      SG_CHECK_EQUAL(runs[i].load(), 1);
+  }
+}
+
+void test_unevenTasks()
+{
+  cout << "Testing work stealing with uneven task costs" << endl;
+
+  SGJobPool pool(3);
+  std::atomic<size_t> sum{0};
+
+  // All expensive tasks end up in the range of the first thread
+  pool.parallelFor(64, [&sum](size_t i) {
+    volatile size_t x = 0;
+    const size_t n = i < 16 ? 200000 : 10;
+    for (size_t k = 0; k < n; ++k)
+      x = x + k;
+    sum += i;
+  });
+
+  SG_CHECK_EQUAL(sum.load(), 64u * 63u / 2);
+}
+
+void test_exception()
+{
+  cout << "Testing exceptions thrown by tasks" << endl;
+
+  SGJobPool pool(2);
+  std::atomic<int> runs{0};
+  bool caught = false;
+
+  try {
+    pool.parallelFor(100, [&runs](size_t i) {
+      ++runs;
+      if (i == 42)
+        throw std::runtime_error("task failed");
+    });
+  } catch (std::runtime_error&) {
+    caught = true;
+  }
+
+  SG_VERIFY(caught);
+  SG_CHECK_EQUAL(runs.load(), 100);
+
+  // the pool is still usable afterwards
+  runs = 0;
+  pool.parallelFor(10, [&runs](size_t) { ++runs; });
+  SG_CHECK_EQUAL(runs.load(), 10);
+}
+
+void test_noWorkers()
+{
+  cout << "Testing a pool without worker threads" << endl;
+
+  SGJobPool pool(0);
+  SG_CHECK_EQUAL(pool.concurrency(), 1u);
+
+  std::vector<size_t> order;
+  pool.parallelFor(5, [&order](size_t i) { order.push_back(i); });
+  SG_CHECK_EQUAL(order.size(), 5u);
+  for (size_t i = 0; i < order.size(); ++i)
+    SG_CHECK_EQUAL(order[i], i);
+}
+
+void test_nested()
+{
+  cout << "Testing parallelFor() called from within a task" << endl;
+
+  SGJobPool pool(3);
+  std::vector<std::atomic<int>> runs(8 * 8);
+  pool.parallelFor(8, [&](size_t i) {
+    pool.parallelFor(8, [&](size_t j) { ++runs[i * 8 + j]; });
+  });
+
+  for (auto& r : runs)
+    SG_CHECK_EQUAL(r.load(), 1);
+}
+
+void test_busyPool()
+{
+  cout << "Testing parallelFor() from several threads at once" << endl;
+
+  SGJobPool pool(2);
+  std::atomic<bool> started{false}, release{false};
+  std::atomic<int> runs{0};
+
+  // Keep the workers busy from another thread
+  std::thread other([&] {
+    pool.parallelFor(3, [&](size_t) {
+      started = true;
+      while (!release)
+        std::this_thread::yield();
+    });
+  });
+  while (!started)
+    std::this_thread::yield();
+
+  // Waits for the other loop, then runs on the workers
+  std::thread third([&] {
+    pool.parallelFor(10, [&runs](size_t) { ++runs; });
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  SG_CHECK_EQUAL(runs.load(), 0);
+
+  release = true;
+  other.join();
+  third.join();
+  SG_CHECK_EQUAL(runs.load(), 10);
+}
+
+void test_shared()
+{
+  cout << "Testing the shared pool" << endl;
+
+  SGJobPool& pool = SGJobPool::shared();
+  SG_VERIFY(&pool == &SGJobPool::shared());
+  SG_CHECK_EQUAL(pool.concurrency(), SGJobPool::defaultNumWorkers() + 1);
+
+  std::atomic<size_t> sum{0};
+  pool.parallelFor(100, [&sum](size_t i) { sum += i; });
+  SG_CHECK_EQUAL(sum.load(), 100u * 99u / 2);
+}
+
+void test_submit()
+{
+  cout << "Testing jobs submitted without waiting" << endl;
+
+  // one worker starts jobs in order, and runs the queued ones on destruction
+  std::vector<int> order;
+  {
+    SGJobPool pool(1);
+    for (int i = 0; i < 100; ++i)
+      pool.submit([&order, i] { order.push_back(i); });
+    pool.submit([] { throw std::runtime_error("job failed"); });
+    pool.submit([&order] { order.push_back(100); });
+  }
+  SG_CHECK_EQUAL(order.size(), 101u);
+  for (size_t i = 0; i < order.size(); ++i)
+    SG_CHECK_EQUAL(order[i], static_cast<int>(i));
+
+  // without workers, jobs run before submit() returns
+  SGJobPool inlinePool(0);
+  bool ran = false;
+  inlinePool.submit([&ran] { ran = true; });
+  SG_VERIFY(ran);
+}
+
+void test_loopWithBusyWorker()
+{
+  cout << "Testing parallelFor() while a worker runs a long job" << endl;
+
+  SGJobPool pool(2);
+  std::atomic<bool> started{false}, release{false};
+  pool.submit([&] {
+    started = true;
+    while (!release)
+      std::this_thread::yield();
+  });
+  while (!started)
+    std::this_thread::yield();
+
+  // completes on the other worker and this thread
+  std::atomic<int> runs{0};
+  pool.parallelFor(50, [&runs](size_t) { ++runs; });
+  SG_CHECK_EQUAL(runs.load(), 50);
+
+  release = true;
+}
+
+int main(int argc, char* argv[])
+{
+  test_allTasksRunOnce();
+  test_unevenTasks();
+  test_exception();
+  test_noWorkers();
+  test_nested();
+  test_busyPool();
+  test_shared();
+  test_submit();
+  test_loopWithBusyWorker();
+
+  return EXIT_SUCCESS;
+}
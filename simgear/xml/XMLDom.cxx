@@ -0,0 +1,310 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Lightweight, arena allocated XML document tree
+ */
+
+#include <simgear_config.h>
+
+#include "XMLDom.hxx"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include <simgear/io/sg_mmap.hxx>
+#include <simgear/misc/sg_path.hxx>
+
+namespace simgear {
+
+namespace {
+
+// arena blocks double in size, so that small documents stay small
+const size_t minBlockSize = 4 * 1024;
+const size_t maxBlockSize = 256 * 1024;
+
+const char* noAttributes[] = {nullptr};
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////
+// Builder, the visitor filling the tree while parsing.
+////////////////////////////////////////////////////////////////////////
+
+class XMLDom::Builder : public XMLVisitor
+{
+public:
+    explicit Builder(XMLDom& dom) : _dom(dom)
+    {
+        _open.push_back(Open{nullptr, nullptr}); // the document level
+    }
+
+    void startElement(const char* name, const XMLAttributes& atts) override
+    {
+        flushText();
+        const size_t length = strlen(name);
+        Node* node = addNode(Node::ELEMENT, _dom.copyString(name, length), length);
+
+        const int count = atts.size();
+        if (count > 0) {
+            auto copy = static_cast<const char**>(
+                _dom.allocate((count * 2 + 1) * sizeof(const char*), alignof(const char*)));
+            for (int i = 0; i < count; ++i) {
+                const char* attName = atts.getName(i);
+                const char* attValue = atts.getValue(i);
+                copy[i * 2] = _dom.copyString(attName, strlen(attName));
+                copy[i * 2 + 1] = _dom.copyString(attValue, strlen(attValue));
+            }
+            copy[count * 2] = nullptr;
+            node->atts = copy;
+        } else {
+            node->atts = noAttributes;
+        }
+
+        if (!_dom._root) {
+            _dom._root = node;
+        }
+        _open.push_back(Open{node, nullptr});
+    }
+
+    void endElement(const char* name) override
+    {
+        flushText();
+        Node* node = _open.back().element;
+        node->closed = true;
+        node->endLine = getLine();
+        node->endColumn = getColumn();
+        _open.pop_back();
+    }
+
+    void data(const char* s, int length) override
+    {
+        if (!_inText) {
+            _inText = true;
+            _textLine = getLine();
+            _textColumn = getColumn();
+        }
+        _text.append(s, length);
+    }
+
+    void pi(const char* target, const char* data) override
+    {
+        flushText();
+        const size_t targetLength = strlen(target);
+        const size_t dataLength = strlen(data);
+        char* value = static_cast<char*>(_dom.allocate(targetLength + dataLength + 2, 1));
+        memcpy(value, target, targetLength + 1);
+        memcpy(value + targetLength + 1, data, dataLength + 1);
+        addNode(Node::PI, value, targetLength);
+    }
+
+    /// Add the text of the last chunks of character data
+    void flushText()
+    {
+        if (!_inText) {
+            return;
+        }
+        Node* node = addNode(Node::TEXT, _dom.copyString(_text.data(), _text.size()), _text.size());
+        node->line = _textLine;
+        node->column = _textColumn;
+        _text.clear();
+        _inText = false;
+    }
+
+private:
+    struct Open {
+        Node* element;
+        Node* lastChild;
+    };
+
+    Node* addNode(Node::Type type, const char* value, size_t length)
+    {
+        Node* node = static_cast<Node*>(_dom.allocate(sizeof(Node), alignof(Node)));
+        *node = Node{type, false, getLine(), getColumn(), -1, -1,
+                     static_cast<unsigned int>(length), value, nullptr, nullptr, nullptr};
+
+        Open& parent = _open.back();
+        if (parent.lastChild) {
+            parent.lastChild->next = node;
+        } else if (parent.element) {
+            parent.element->firstChild = node;
+        } else {
+            _dom._first = node;
+        }
+        parent.lastChild = node;
+        ++_dom._numNodes;
+        return node;
+    }
+
+    XMLDom& _dom;
+    std::vector<Open> _open;
+
+    std::string _text; ///< character data not yet added
+    bool _inText = false;
+    int _textLine = -1, _textColumn = -1;
+};
+
+////////////////////////////////////////////////////////////////////////
+// XMLDom
+////////////////////////////////////////////////////////////////////////
+
+const char* XMLDom::Node::getAttribute(const char* name) const
+{
+    if (!atts) {
+        return nullptr;
+    }
+    for (const char** att = atts; *att; att += 2) {
+        if (!strcmp(*att, name)) {
+            return att[1];
+        }
+    }
+    return nullptr;
+}
+
+XMLDom::XMLDom() = default;
+
+XMLDom::~XMLDom() = default;
+
+void XMLDom::clear()
+{
+    reset();
+    _blocks.clear();
+    _arenaSize = 0;
+}
+
+void XMLDom::reset()
+{
+    _usedBlocks = 0;
+    _next = nullptr;
+    _left = 0;
+    _blockSize = 0;
+    _first = _root = nullptr;
+    _complete = false;
+    _numNodes = 0;
+    _path.clear();
+}
+
+XMLDom::Block& XMLDom::nextBlock(size_t size)
+{
+    // reuse the blocks of the previous document in the order they were
+    // allocated, which the same sizes are requested in
+    if (_usedBlocks == _blocks.size() || _blocks[_usedBlocks].size < size) {
+        _blocks.insert(_blocks.begin() + _usedBlocks, Block{std::unique_ptr<char[]>(new char[size]), size});
+        _arenaSize += size;
+    }
+    return _blocks[_usedBlocks++];
+}
+
+void* XMLDom::allocate(size_t size, size_t align)
+{
+    // large allocations get a block of their own, leaving the current one
+    if (size > maxBlockSize / 4) {
+        return nextBlock(size).data.get();
+    }
+
+    size_t padding = (align - reinterpret_cast<uintptr_t>(_next) % align) % align;
+    if (!_next || padding + size > _left) {
+        _blockSize = std::min(std::max(_blockSize * 2, minBlockSize), maxBlockSize);
+        Block& block = nextBlock(std::max(_blockSize, size));
+        _next = block.data.get();
+        _left = block.size;
+        padding = 0; // new[] is suitably aligned
+    }
+
+    void* result = _next + padding;
+    _next += padding + size;
+    _left -= padding + size;
+    return result;
+}
+
+const char* XMLDom::copyString(const char* s, size_t length)
+{
+    char* copy = static_cast<char*>(allocate(length + 1, 1));
+    memcpy(copy, s, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+void XMLDom::read(const char* buf, size_t size, const std::string& path)
+{
+    reset();
+    _path = path;
+
+    Builder builder(*this);
+    try {
+        readXML(buf, size, builder, path);
+    } catch (...) {
+        builder.flushText();
+        throw;
+    }
+    builder.flushText();
+    _complete = true;
+}
+
+void XMLDom::read(const SGPath& path)
+{
+    SGMMapFile mapped(path);
+    if (path.isFile() && path.sizeInBytes() == 0) {
+        // mmap() refuses empty files, which are malformed documents all the same
+        read("", 0, path.utf8Str());
+    } else if (path.isFile() && mapped.open(SG_IO_IN)) {
+        read(mapped.get(), mapped.get_size(), path.utf8Str());
+    } else {
+        reset();
+        _path = path.utf8Str();
+        throw sg_io_exception("Failed to open file", sg_location(path),
+                              "SimGear XML Parser", false /* don't report */);
+    }
+}
+
+void XMLDom::visit(XMLVisitor& visitor) const
+{
+    visitor.setPath(_path);
+    visitor.startXML();
+
+    std::vector<const Node*> open; // elements being visited
+    const Node* node = _first;
+    while (node) {
+        switch (node->type) {
+        case Node::ELEMENT:
+            visitor.setPosition(node->line, node->column);
+            visitor.startElement(node->value, node->attributes());
+            break;
+        case Node::TEXT:
+            visitor.setPosition(node->line, node->column);
+            visitor.data(node->value, static_cast<int>(node->length));
+            break;
+        case Node::PI:
+            visitor.setPosition(node->line, node->column);
+            visitor.pi(node->value, node->piData());
+            break;
+        }
+
+        if (node->firstChild) {
+            open.push_back(node);
+            node = node->firstChild;
+            continue;
+        }
+
+        // leave the node, and the elements it is the last child of
+        while (true) {
+            if (node->isElement() && node->closed) {
+                visitor.setPosition(node->endLine, node->endColumn);
+                visitor.endElement(node->value);
+            }
+            if (node->next || open.empty()) {
+                node = node->next;
+                break;
+            }
+            node = open.back();
+            open.pop_back();
+        }
+    }
+
+    if (_complete) {
+        visitor.endXML();
+    }
+}
+
+} // namespace simgear
@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Lightweight, arena allocated XML document tree
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "easyxml.hxx"
+
+class SGPath;
+
+namespace simgear {
+
+/**
+ * A read-only XML document tree, built in one pass over the document.
+ *
+ * Nodes, names, attributes and text are allocated from an arena owned by
+ * the tree, so building it does not allocate per element. Adjacent chunks
+ * of character data are merged into one text node.
+ *
+ * visit() replays the document into any XMLVisitor, such as a
+ * PropsVisitor or an XMLStaticParser, with the line and column numbers of
+ * the original parse. A tree whose parse failed keeps the part before the
+ * error, and visit() replays just that part, as readXML() would have
+ * before throwing.
+ */
+class XMLDom
+{
+public:
+    struct Node {
+        enum Type : unsigned char { ELEMENT, TEXT, PI };
+
+        Type type;
+        bool closed;            ///< the end tag was parsed (elements)
+        int line, column;       ///< of the start tag, text or instruction
+        int endLine, endColumn; ///< of the end tag (elements)
+        unsigned int length;    ///< of value
+        const char* value;      ///< name, text or instruction target
+        const char** atts;      ///< attribute name/value pairs, null terminated
+
+        const Node* firstChild;
+        const Node* next;
+
+        bool isElement() const { return type == ELEMENT; }
+
+        /// Attribute @a name of an element, or null
+        const char* getAttribute(const char* name) const;
+
+        /// Attribute view for XMLVisitor::startElement()
+        ExpatAtts attributes() const { return ExpatAtts(atts); }
+
+        /// Data of a processing instruction, stored after its target
+        const char* piData() const { return value + length + 1; }
+    };
+
+    XMLDom();
+    ~XMLDom();
+
+    XMLDom(const XMLDom&) = delete;
+    XMLDom& operator=(const XMLDom&) = delete;
+
+    /**
+     * Parse a file, which is memory mapped. Replaces any previous contents,
+     * reusing their arena.
+     * @exception Throws sg_io_exception as readXML() does.
+     */
+    void read(const SGPath& path);
+
+    /**
+     * Parse a complete document held in memory, reporting errors
+     * against @a path. Replaces any previous contents, reusing their arena.
+     * @exception Throws sg_io_exception as readXML() does.
+     */
+    void read(const char* buf, size_t size, const std::string& path);
+
+    /// Remove the contents and release the arena
+    void clear();
+
+    /// The document element, null if parsing failed before it
+    const Node* root() const { return _root; }
+
+    /// Whether the whole document was parsed
+    bool complete() const { return _complete; }
+
+    const std::string& getPath() const { return _path; }
+
+    /// Pass the document to @a visitor, as readXML() would
+    void visit(XMLVisitor& visitor) const;
+
+    size_t numNodes() const { return _numNodes; }
+
+    /// Bytes allocated for the arena
+    size_t arenaSize() const { return _arenaSize; }
+
+private:
+    class Builder;
+
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    void reset();
+    void* allocate(size_t size, size_t align);
+    Block& nextBlock(size_t size);
+    const char* copyString(const char* s, size_t length);
+
+    std::vector<Block> _blocks;
+    size_t _usedBlocks = 0;
+    char* _next = nullptr;
+    size_t _left = 0;
+    size_t _blockSize = 0;
+    size_t _arenaSize = 0;
+
+    const Node* _first = nullptr; ///< first top-level node
+    const Node* _root = nullptr;
+    bool _complete = false;
+    size_t _numNodes = 0;
+    std::string _path;
+};
+
+} // namespace simgear
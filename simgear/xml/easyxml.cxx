@@ -156,13 +156,11 @@ void XMLVisitor::savePosition(void)
 // Attribute list wrapper for Expat.
 ////////////////////////////////////////////////////////////////////////
 
-int
-ExpatAtts::size () const
+ExpatAtts::ExpatAtts (const char ** atts)
+  : _atts(atts), _size(0)
 {
-  int s = 0;
   for (int i = 0; _atts[i] != 0; i += 2)
-    s++;
-  return s;
+    _size++;
 }
 
 const char *
@@ -337,4 +335,34 @@ readXML (const char *buf, const int size, XMLVisitor &visitor)
   visitor.endXML();
 }
 
+void
+readXML (const char *buf, size_t size, XMLVisitor &visitor, const string &path)
+{
+  XML_Parser parser = XML_ParserCreate(0);
+  XML_SetUserData(parser, &visitor);
+  XML_SetElementHandler(parser, start_element, end_element);
+  XML_SetCharacterDataHandler(parser, character_data);
+  XML_SetProcessingInstructionHandler(parser, processing_instruction);
+
+  visitor.setParser(parser);
+  visitor.setPath(path);
+  visitor.startXML();
+
+  if (!XML_Parse(parser, buf, static_cast<int>(size), true)) {
+      sg_io_exception ex(XML_ErrorString(XML_GetErrorCode(parser)),
+                         sg_location(path,
+                                     XML_GetCurrentLineNumber(parser),
+                                     XML_GetCurrentColumnNumber(parser)),
+                         "SimGear XML Parser",
+                         false /* don't report */);
+      visitor.setParser(0);
+      XML_ParserFree(parser);
+      throw ex;
+  }
+
+  visitor.setParser(0);
+  XML_ParserFree(parser);
+  visitor.endXML();
+}
+
 // end of easyxml.cxx
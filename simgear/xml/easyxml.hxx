@@ -226,18 +226,23 @@ private:
 // Attribute list wrapper for Expat.
 ////////////////////////////////////////////////////////////////////////
 
+/**
+ * View of a null terminated array of attribute name/value pairs, as
+ * passed by Expat, without copying the strings.
+ */
 class ExpatAtts : public XMLAttributes
 {
 public:
-  ExpatAtts (const char ** atts) : _atts(atts) {}
+  ExpatAtts (const char ** atts);
 
-  virtual int size () const;
+  virtual int size () const { return _size; }
   virtual const char * getName (int i) const;
   virtual const char * getValue (int i) const;
 
   virtual const char * getValue (const char * name) const;
 private:
   const char ** _atts;
+  int _size;                    // counted once, visitors loop over size()
 };
 
 
@@ -409,6 +414,17 @@ public:
    */
   void savePosition(void);
 
+  /** Restore a position saved earlier.
+   *
+   * This method is meant for visitors which replay recorded parsing events,
+   * so that #getLine and #getColumn report the positions of the original
+   * events.
+   *
+   * @param _line the line number
+   * @param _column the column number
+   */
+  void setPosition(int _line, int _column) { line = _line; column = _column; }
+
   /** Get the saved column number in the parsed file.
    *
    * This method will be called if the application needs to get the column
@@ -515,3 +531,24 @@ extern void readXML (const SGPath &path, XMLVisitor &visitor);
  * @see XMLVisitor
  */
 extern void readXML (const char *buf, const int size, XMLVisitor &visitor);
+
+
+/**
+ * @relates XMLVisitor
+ * Read an XML document held in memory as a whole.
+ *
+ * Unlike the overload above, this reports line and column numbers to
+ * the visitor, checks that the document is complete and reports errors
+ * against @a path, as when reading the file through a stream.
+ *
+ * @param buf The xml data buffer.
+ * @param size The size of the data buffer in bytes
+ * @param visitor An object that contains callbacks for XML parsing
+ * events.
+ * @param path A string describing the original path of the resource.
+ * @exception Throws sg_io_exception or sg_xml_exception if there
+ * is a problem reading the file.
+ * @see XMLVisitor
+ */
+extern void readXML (const char *buf, size_t size, XMLVisitor &visitor,
+                     const std::string &path);
@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Benchmark reading the testEasyXML sample, scaled up, through
+ *        visitors and into an XMLDom
+ */
+
+#include <simgear_config.h>
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/misc/sg_dir.hxx>
+#include <simgear/misc/test_timing.hxx>
+
+#include "XMLDom.hxx"
+#include "easyxml.hxx"
+
+using namespace simgear;
+
+static const int num_poems = 20000;
+static const int num_runs = 3;
+
+struct Totals {
+    size_t elements = 0;
+    size_t attributes = 0;
+    size_t text = 0;
+
+    bool operator==(const Totals& rhs) const
+    {
+        return elements == rhs.elements && attributes == rhs.attributes && text == rhs.text;
+    }
+};
+
+// What visitors commonly do: snapshot the attributes and concatenate the
+// data of each element
+class CopyingVisitor : public XMLVisitor
+{
+public:
+    Totals totals;
+
+    void startElement(const char* name, const XMLAttributes& atts) override
+    {
+        _stack.push_back(Element{name, XMLAttributesDefault(atts), std::string()});
+    }
+
+    void endElement(const char* name) override
+    {
+        const Element& e = _stack.back();
+        totals.elements++;
+        totals.attributes += e.atts.size();
+        totals.text += e.text.size();
+        _stack.pop_back();
+    }
+
+    void data(const char* s, int length) override
+    {
+        if (!_stack.empty()) {
+            _stack.back().text.append(s, length);
+        }
+    }
+
+private:
+    struct Element {
+        std::string name;
+        XMLAttributesDefault atts;
+        std::string text;
+    };
+    std::vector<Element> _stack;
+};
+
+// Uses the attribute view and the data chunks in place
+class ViewVisitor : public XMLVisitor
+{
+public:
+    Totals totals;
+
+    void startElement(const char* name, const XMLAttributes& atts) override
+    {
+        totals.elements++;
+        for (int i = 0; i < atts.size(); ++i) {
+            if (atts.getName(i) && atts.getValue(i)) {
+                totals.attributes++;
+            }
+        }
+    }
+
+    void data(const char* s, int length) override { totals.text += length; }
+};
+
+static void walk(const XMLDom::Node* node, Totals& totals)
+{
+    for (; node; node = node->next) {
+        if (node->isElement()) {
+            totals.elements++;
+            totals.attributes += node->attributes().size();
+            walk(node->firstChild, totals);
+        } else if (node->type == XMLDom::Node::TEXT) {
+            totals.text += node->length;
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Dir dir = Dir::tempDir("easyxml_bench");
+    dir.setRemoveOnDestroy();
+    const SGPath file = dir.file("anthology.xml");
+    {
+        sg_ofstream xml(file, std::ios::out | std::ios::trunc);
+        xml << "<?xml version=\"1.0\"?>\n\n<anthology>\n";
+        for (int p = 0; p < num_poems; ++p) {
+            xml << "<poem shortname=\"roses" << p << "\" version=\"1.0\" lang=\"en\">\n"
+                << "<title>Roses are Red &amp; Violets are Blue, number " << p << "</title>\n"
+                << "<l n=\"1\">Roses are red,</l>\n"
+                << "<l n=\"2\">Violets are blue;</l>\n"
+                << "<l n=\"3\">Sugar is sweet,\n  &amp; so on</l>\n"
+                << "<l n=\"4\">And I love you.</l>\n"
+                << "</poem>\n";
+        }
+        xml << "</anthology>\n";
+    }
+    const size_t bytes = file.sizeInBytes();
+
+    CopyingVisitor copying;
+    const double copying_ms = bestRun(num_runs, [&] {
+        copying = CopyingVisitor();
+        readXML(file, copying);
+    }).toMSecs();
+
+    ViewVisitor viewing;
+    const double view_ms = bestRun(num_runs, [&] {
+        viewing = ViewVisitor();
+        readXML(file, viewing);
+    }).toMSecs();
+
+    XMLDom dom;
+    Totals built;
+    const double dom_ms = bestRun(num_runs, [&] {
+        dom.read(file);
+        built = Totals();
+        walk(dom.root(), built);
+    }).toMSecs();
+
+    ViewVisitor replayed;
+    const double visit_ms = bestRun(num_runs, [&] {
+        replayed = ViewVisitor();
+        dom.visit(replayed);
+    }).toMSecs();
+
+    std::cout << num_poems << " poems, " << bytes / 1024 << " KiB, " << dom.numNodes()
+              << " DOM nodes in " << dom.arenaSize() / 1024 << " KiB of arena\n"
+              << std::fixed << std::setprecision(1)
+              << "readXML, copying visitor: " << std::setw(8) << copying_ms << " ms\n"
+              << "readXML, attribute view:  " << std::setw(8) << view_ms << " ms\n"
+              << "XMLDom::read and walk:    " << std::setw(8) << dom_ms << " ms\n"
+              << "XMLDom::visit:            " << std::setw(8) << visit_ms << " ms\n";
+
+    const bool ok = copying.totals == built && viewing.totals == built && replayed.totals == built;
+    if (!ok || built.elements == 0) {
+        std::cerr << "results differ" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,281 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/**
+ * @file
+ * @brief Unit tests for XMLDom
+ */
+
+#include <simgear_config.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <simgear/misc/test_macros.hxx>
+#include <simgear/structure/exception.hxx>
+
+#include "XMLDom.hxx"
+
+using std::cout;
+using std::endl;
+using simgear::XMLDom;
+
+/// Records the callbacks, adjacent character data merged into one
+class RecordingVisitor : public XMLVisitor
+{
+public:
+    void startXML() override { add("startXML"); }
+    void endXML() override { add("endXML"); }
+
+    void startElement(const char* name, const XMLAttributes& atts) override
+    {
+        std::ostringstream s;
+        s << "start " << name << " " << getLine() << ":" << getColumn();
+        for (int i = 0; i < atts.size(); ++i) {
+            s << " " << atts.getName(i) << "=" << atts.getValue(i);
+        }
+        add(s.str());
+    }
+
+    void endElement(const char* name) override
+    {
+        std::ostringstream s;
+        s << "end " << name << " " << getLine() << ":" << getColumn();
+        add(s.str());
+    }
+
+    void data(const char* s, int length) override
+    {
+        if (!inText) {
+            std::ostringstream pos;
+            pos << "data " << getLine() << ":" << getColumn() << " ";
+            events.push_back(pos.str());
+            inText = true;
+        }
+        events.back().append(s, length);
+    }
+
+    void pi(const char* target, const char* data) override
+    {
+        add(std::string("pi ") + target + " " + data);
+    }
+
+    std::vector<std::string> events;
+
+private:
+    void add(const std::string& event)
+    {
+        events.push_back(event);
+        inText = false;
+    }
+
+    bool inText = false;
+};
+
+static const char* document =
+    "<?xml version=\"1.0\"?>\n"
+    "<root a=\"1\" b=\"two\">\n"
+    "  <child>text &amp; more<![CDATA[ <cdata>]]></child>\n"
+    "  <?target some data?>\n"
+    "  <empty/>\n"
+    "</root>\n";
+
+static void read(XMLDom& dom, const char* doc)
+{
+    dom.read(doc, strlen(doc), "test.xml");
+}
+
+static std::vector<std::string> parse(const char* doc)
+{
+    RecordingVisitor visitor;
+    try {
+        readXML(doc, strlen(doc), visitor, "test.xml");
+    } catch (const sg_exception&) {
+    }
+    return visitor.events;
+}
+
+static std::vector<std::string> visit(const XMLDom& dom)
+{
+    RecordingVisitor visitor;
+    dom.visit(visitor);
+    return visitor.events;
+}
+
+static std::string text(const XMLDom::Node* node)
+{
+    return std::string(node->value, node->length);
+}
+
+void test_tree()
+{
+    cout << "Testing the structure of the tree" << endl;
+
+    XMLDom dom;
+    read(dom, document);
+    SG_VERIFY(dom.complete());
+    SG_CHECK_EQUAL(dom.getPath(), "test.xml");
+
+    const XMLDom::Node* root = dom.root();
+    SG_VERIFY(root && root->isElement() && root->closed);
+    SG_CHECK_EQUAL(text(root), "root");
+    SG_CHECK_EQUAL(root->line, 2);
+    SG_CHECK_EQUAL(root->endLine, 6);
+    SG_CHECK_EQUAL(std::string(root->getAttribute("b")), "two");
+    SG_CHECK_EQUAL(root->attributes().size(), 2);
+    SG_VERIFY(!root->getAttribute("c"));
+    SG_VERIFY(!root->next);
+
+    // children, with the whitespace between elements
+    std::vector<const XMLDom::Node*> children;
+    for (auto c = root->firstChild; c; c = c->next) {
+        children.push_back(c);
+    }
+    SG_CHECK_EQUAL(children.size(), 7u);
+    SG_CHECK_EQUAL(children[0]->type, XMLDom::Node::TEXT);
+    SG_CHECK_EQUAL(text(children[0]), "\n  ");
+
+    const XMLDom::Node* child = children[1];
+    SG_CHECK_EQUAL(text(child), "child");
+    SG_CHECK_EQUAL(child->line, 3);
+    SG_CHECK_EQUAL(child->attributes().size(), 0);
+    SG_VERIFY(child->firstChild && !child->firstChild->next);
+
+    const XMLDom::Node* empty = children[5];
+    SG_VERIFY(empty->isElement() && empty->closed);
+    SG_CHECK_EQUAL(text(empty), "empty");
+    SG_VERIFY(!empty->firstChild);
+
+    // root, its children, and the text of child
+    SG_CHECK_EQUAL(dom.numNodes(), 9u);
+}
+
+void test_text()
+{
+    cout << "Testing merged text nodes" << endl;
+
+    XMLDom dom;
+    read(dom, document);
+
+    // expat reports the text, the entity and the CDATA section separately
+    const XMLDom::Node* t = dom.root()->firstChild->next->firstChild;
+    SG_CHECK_EQUAL(t->type, XMLDom::Node::TEXT);
+    SG_CHECK_EQUAL(text(t), "text & more <cdata>");
+    SG_CHECK_EQUAL(strlen(t->value), t->length);
+    SG_CHECK_EQUAL(t->line, 3);
+    SG_VERIFY(!t->isElement() && !t->firstChild);
+}
+
+void test_pi()
+{
+    cout << "Testing processing instructions" << endl;
+
+    XMLDom dom;
+    read(dom, document);
+
+    const XMLDom::Node* pi = dom.root()->firstChild->next->next->next;
+    SG_CHECK_EQUAL(pi->type, XMLDom::Node::PI);
+    SG_CHECK_EQUAL(text(pi), "target");
+    SG_CHECK_EQUAL(std::string(pi->value), "target");
+    SG_CHECK_EQUAL(std::string(pi->piData()), "some data");
+    SG_CHECK_EQUAL(pi->line, 4);
+}
+
+void test_visit()
+{
+    cout << "Testing visiting complete and partial trees" << endl;
+
+    XMLDom dom;
+    read(dom, document);
+    const auto events = visit(dom);
+    SG_VERIFY(events == parse(document));
+    SG_CHECK_EQUAL(events.front(), "startXML");
+    SG_CHECK_EQUAL(events.back(), "endXML");
+
+    // the part before a parse error, as readXML() passes it on
+    const char* broken = "<root>\n <a x=\"y\">1</a>\n <b>unterminated</root>";
+    bool thrown = false;
+    try {
+        read(dom, broken);
+    } catch (const sg_io_exception&) {
+        thrown = true;
+    }
+    SG_VERIFY(thrown);
+    SG_VERIFY(!dom.complete());
+    SG_VERIFY(dom.root() && !dom.root()->closed);
+
+    const auto partial = visit(dom);
+    SG_VERIFY(partial == parse(broken));
+    SG_CHECK_EQUAL(partial.size(), 9u);
+    SG_CHECK_EQUAL(partial.at(1), "start root 1:0");
+    SG_CHECK_EQUAL(partial.at(3), "start a 2:1 x=y");
+    SG_CHECK_EQUAL(partial.back().substr(partial.back().size() - 12), "unterminated");
+
+    // nothing before the error
+    thrown = false;
+    try {
+        read(dom, "not xml");
+    } catch (const sg_io_exception&) {
+        thrown = true;
+    }
+    SG_VERIFY(thrown);
+    SG_VERIFY(!dom.root());
+    SG_CHECK_EQUAL(dom.numNodes(), 0u);
+    SG_VERIFY(visit(dom) == std::vector<std::string>{"startXML"});
+}
+
+void test_arenaReuse()
+{
+    cout << "Testing reuse of the arena" << endl;
+
+    // enough elements for several arena blocks
+    std::string large = "<root>";
+    for (int i = 0; i < 2000; ++i) {
+        large += "<item index=\"" + std::to_string(i) + "\">value</item>";
+    }
+    large += "</root>";
+
+    XMLDom dom;
+    read(dom, large.c_str());
+    SG_CHECK_EQUAL(dom.numNodes(), 4001u);
+    const size_t arenaSize = dom.arenaSize();
+    SG_VERIFY(arenaSize > 0);
+
+    // the same or a smaller document fit in the blocks there are
+    read(dom, large.c_str());
+    SG_CHECK_EQUAL(dom.arenaSize(), arenaSize);
+    SG_CHECK_EQUAL(dom.numNodes(), 4001u);
+
+    read(dom, document);
+    SG_CHECK_EQUAL(dom.arenaSize(), arenaSize);
+    SG_CHECK_EQUAL(text(dom.root()), "root");
+    SG_VERIFY(visit(dom) == parse(document));
+
+    read(dom, large.c_str());
+    SG_CHECK_EQUAL(dom.arenaSize(), arenaSize);
+    const XMLDom::Node* last = dom.root()->firstChild;
+    while (last->next) {
+        last = last->next;
+    }
+    SG_CHECK_EQUAL(std::string(last->getAttribute("index")), "1999");
+    SG_CHECK_EQUAL(text(last->firstChild), "value");
+
+    dom.clear();
+    SG_CHECK_EQUAL(dom.arenaSize(), 0u);
+    SG_VERIFY(!dom.root());
+    SG_CHECK_EQUAL(dom.numNodes(), 0u);
+}
+
+int main(int argc, char* argv[])
+{
+    test_tree();
+    test_text();
+    test_pi();
+    test_visit();
+    test_arenaReuse();
+
+    return EXIT_SUCCESS;
+}